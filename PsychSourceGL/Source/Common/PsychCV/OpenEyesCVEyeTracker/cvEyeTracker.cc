@@ -1442,6 +1442,7 @@ psych_bool cvEyeTrackerInitialize(const char* logfilename, int eyewidth, int eye
 	start_point.y = -1;
 	lost_frame_num = 1000;
 	trackedframes = 0;
+	pupil_fit_residual = -1;
 
 	// Done.
 	return(TRUE);
@@ -1461,10 +1462,19 @@ psych_bool cvEyeTrackerShutdown(void)
 	free(avg_intensity_hori);
 	avg_intensity_hori = NULL;
 
+	// Stop RANSAC worker threads:
+	ransac_pool_shutdown();
+
 	// Done.
 	return(TRUE);	
 }
 
+// Release all threads, at module exit:
+void cvEyeTrackerExit(void)
+{
+	ransac_pool_shutdown();
+}
+
 // Perform one single tracking cycle and return results:
 //
 // eyeResult  - Pointer to struct for return of all relevant tracking results.
@@ -1546,6 +1556,7 @@ psych_bool cvEyeTrackerExecuteTrackingCycle(PsychCVEyeResult* eyeResult, psych_b
 	eyeResult->cornea_x = corneal_reflection.x;
 	eyeResult->cornea_y = corneal_reflection.y;
 	eyeResult->validresult = (lost_frame_num > 0) ? FALSE : TRUE;
+	eyeResult->fit_residual = (lost_frame_num > 0) ? -1 : pupil_fit_residual;
 	eyeResult->trackcount = trackedframes++;
 	eyeResult->timestamp = Time_Elapsed();
 
@@ -1619,6 +1630,16 @@ void cvEyeTrackerSetRansacConstraints(double minDist, double maxDist, double min
 	return;
 }
 
+// Set the parallelization and termination parameters of RANSAC ellipse fitting:
+void cvEyeTrackerSetRansacParameters(int nrThreads, double confidence, int maxIterations)
+{
+	ransac_threads = nrThreads;
+	ransac_confidence = confidence;
+	ransac_max_iterations = maxIterations;
+
+	return;
+}
+
 void cvEyeTrackerSetOverrideReferencePoint(int rx, int ry)
 {
 	corneal_reflection.x = rx;
@@ -50,6 +50,19 @@ double pupil_param[5] = {0, 0, 0, 0, 0};
 vector <stuDPoint*> edge_point;
 vector <int> edge_intensity_diff;
 
+// MK: RANSAC tuning: Number of threads for parallel evaluation of ellipse hypotheses,
+// confidence of having drawn at least one outlier-free sample for adaptive termination,
+// and hard upper limit for the number of evaluated hypotheses:
+int ransac_threads = 1;
+double ransac_confidence = 0.99;
+int ransac_max_iterations = 1501;
+
+// MK: RMS distance in pixels of the inliers of the last fit from the fitted ellipse, -1 if fit failed:
+double pupil_fit_residual = -1;
+
+// MK: Upper limit for the number of RANSAC worker threads:
+#define RANSAC_MAX_THREADS 16
+
 
 //------------ Starburst pupil edge detection -----------//
 
@@ -143,15 +156,27 @@ void locate_edge_points(UINT8* image, int width, int height, double cx, double c
   int pixel_value1, pixel_value2;
   int features_added_for_this_ray;
   double distance;
+  double ray_cos, ray_sin, step_cos, step_sin, tmp;
   
   // Transform distance constraint to squared distance, to save sqrt() computations:
   min_feature_dist = min_feature_dist * min_feature_dist;
   max_feature_dist = max_feature_dist * max_feature_dist;
   
-  for (angle = angle_normal-angle_spread/2+0.0001; angle < angle_normal+angle_spread/2; angle += angle_step) {
+  // MK: Ray directions are advanced by a rotation with angle_step, instead of evaluating cos()
+  // and sin() for each ray, which dominated the cost of short rays:
+  angle = angle_normal-angle_spread/2+0.0001;
+  ray_cos = cos(angle);
+  ray_sin = sin(angle);
+  step_cos = cos(angle_step);
+  step_sin = sin(angle_step);
+
+  for (; angle < angle_normal+angle_spread/2; angle += angle_step) {
 	//printf("Thresh = %i Beamnormal: %lf -- Scanning %lf ... ", edge_thresh, angle_normal/2.0/PI*360.0, angle/2.0/PI*360.0);
-    dis_cos = dis * cos(angle);
-    dis_sin = dis * -1 * sin(angle); // MK Changed sign!!
+    dis_cos = dis * ray_cos;
+    dis_sin = dis * -1 * ray_sin; // MK Changed sign!!
+    tmp = ray_cos * step_cos - ray_sin * step_sin;
+    ray_sin = ray_sin * step_cos + ray_cos * step_sin;
+    ray_cos = tmp;
     p.x = cx + dis_cos;
     p.y = cy + dis_sin;	
 	
@@ -258,6 +283,43 @@ void get_5_random_num(int max_num, int* rand_num)
 }
 
 
+// MK: Thread-safe variant of get_5_random_num(), drawing from a private random
+// number generator with state *seed, for use by parallel RANSAC worker threads:
+void get_5_random_num_r(int max_num, int* rand_num, unsigned int* seed)
+{
+  int rand_index = 0;
+  int r;
+  int i;
+  bool is_new = 1;
+
+  if (max_num == 4) {
+    for (i = 0; i < 5; i++) {
+      rand_num[i] = i;
+    }
+    return;
+  }
+
+  while (rand_index < 5) {
+    is_new = 1;
+    // Xorshift32 generator:
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+    r = (int)((*seed * 1.0 / 0xffffffffU) * max_num);
+    for (i = 0; i < rand_index; i++) {
+      if (r == rand_num[i]) {
+        is_new = 0;
+        break;
+      }
+    }
+    if (is_new) {
+      rand_num[rand_index] = r;
+      rand_index++;
+    }
+  }
+}
+
+
 // solve_ellipse
 // conic_param[6] is the parameters of a conic {a, b, c, d, e, f}; conic equation: ax^2 + bxy + cy^2 + dx + ey + f = 0;
 // ellipse_param[5] is the parameters of an ellipse {ellipse_a, ellipse_b, cx, cy, theta}; a & b is the major or minor axis; 
@@ -360,72 +422,137 @@ void denormalize_ellipse_param(double* par, double* normailized_par, double dis_
     par[3] = normailized_par[3] / dis_scale + nor_center.y;
 }
 
-int* pupil_fitting_inliers(UINT8* pupil_image, int width, int height,  int &return_max_inliers_num, double maxeccentricity, double min_ellipse_area, double max_ellipse_area)
+// MK: Number of RANSAC samples needed to draw at least one outlier-free sample of 5 points
+// with probability 'confidence', given an inlier ratio of ninliers / ep_num:
+static int ransac_required_samples(int ninliers, int ep_num, double confidence, int max_samples)
 {
-  int i;
-  int ep_num = edge_point.size();   //ep stands for edge point
-  stuDPoint nor_center;
-  double dis_scale;
+  double w5 = pow(ninliers * 1.0 / ep_num, 5);
+  double n;
 
-  int ellipse_point_num = 5;	//number of point that needed to fit an ellipse
-  if (ep_num < ellipse_point_num) {
-    printf("Error! %d points are not enough to fit ellipse\n", ep_num);
-    memset(pupil_param, 0, sizeof(pupil_param));
-    return_max_inliers_num = 0;
-    return NULL;
+  if (w5 >= 1.0) return 0;
+  if (w5 <= 0.0) return max_samples;
+
+  n = ceil(log(1.0 - confidence) / log(1.0 - w5));
+  return (n < max_samples) ? (int) n : max_samples;
+}
+
+// MK: Shared state of one RANSAC ellipse fit, evaluated by one or more worker threads:
+typedef struct ransac_job
+{
+  // Normalized edge points, and their quadratic terms, as separate arrays:
+  double *x, *y, *xx, *xy, *yy;
+  int ep_num;
+  int width, height;
+  double dis_scale, dis_threshold;
+  stuDPoint nor_center;
+  double maxeccentricity, min_ellipse_area, max_ellipse_area;
+
+  // Protected by mutex:
+  psych_mutex mutex;
+  int ransac_count;         // Number of hypotheses evaluated or in flight.
+  int sample_num;           // Adaptive number of hypotheses to evaluate.
+  int max_inliers;          // Inlier count of best hypothesis so far.
+  int *max_inliers_index;   // Inlier indices of best hypothesis so far.
+  double best_ellipse_par[5];
+} ransac_job;
+
+typedef struct ransac_worker
+{
+  ransac_job *job;          // Job to work on. For pool threads NULL while idle, protected by ransac_pool_mutex.
+  unsigned int seed;
+  psych_thread thread;
+  psych_condition wakeup;   // Signalled when a pool thread gets a job or should exit.
+} ransac_worker;
+
+// MK: Persistent pool of RANSAC worker threads, so fits don't pay for thread creation and
+// destruction each time. Pool thread i uses ransac_pool[i], for i = 1 to ransac_pool_size,
+// the calling thread of a fit uses a worker on its stack:
+static ransac_worker ransac_pool[RANSAC_MAX_THREADS];
+static int ransac_pool_size = 0;
+static int ransac_pool_busy = 0;
+static bool ransac_pool_initialized = false;
+static bool ransac_pool_exit = false;
+static psych_mutex ransac_pool_mutex;
+static psych_condition ransac_pool_done;
+
+// Count the edge points within the algebraic distance threshold of the conic conic_par,
+// storing their indices in inliers_index if that is non-NULL:
+static int ransac_conic_inliers(ransac_job *job, const double *conic_par, int *inliers_index)
+{
+  const double *x = job->x, *y = job->y, *xx = job->xx, *xy = job->xy, *yy = job->yy;
+  double dis_error;
+  int i, ninliers = 0;
+
+  if (inliers_index == NULL) {
+    // Fast path for evaluation of hypotheses: Branch free, so it vectorizes.
+    for (i = 0; i < job->ep_num; i++) {
+      dis_error = conic_par[0]*xx[i] + conic_par[1]*xy[i] + conic_par[2]*yy[i] +
+                  conic_par[3]*x[i] + conic_par[4]*y[i] + conic_par[5];
+      ninliers += (fabs(dis_error) < job->dis_threshold) ? 1 : 0;
+    }
+  } else {
+    for (i = 0; i < job->ep_num; i++) {
+      dis_error = conic_par[0]*xx[i] + conic_par[1]*xy[i] + conic_par[2]*yy[i] +
+                  conic_par[3]*x[i] + conic_par[4]*y[i] + conic_par[5];
+      if (fabs(dis_error) < job->dis_threshold) {
+        inliers_index[ninliers] = i;
+        ninliers++;
+      }
+    }
   }
 
-  //Normalization
-  stuDPoint *edge_point_nor = normalize_edge_point(dis_scale, nor_center, ep_num);
+  return ninliers;
+}
 
-  //Ransac
+// RANSAC worker: Evaluates random hypotheses until the shared, adaptively updated, number
+// of required samples is reached:
+static void* ransac_worker_main(void* arg)
+{
+  ransac_worker *worker = (ransac_worker*) arg;
+  ransac_job *job = worker->job;
+  int i;
+  int ep_num = job->ep_num;
   int *inliers_index = (int*)malloc(sizeof(int)*ep_num);
-  int *max_inliers_index = (int*)malloc(sizeof(int)*ep_num);
-  int ninliers = 0;
-  int max_inliers = 0;
-  int sample_num = 1000;	//number of sample
-  int ransac_count = 0;
-  double dis_threshold = sqrt(3.84)*dis_scale;
-//  double dis_threshold = 0.5 * sqrt(3.84)*dis_scale;
-  double dis_error;
-  
-  memset(inliers_index, int(0), sizeof(int)*ep_num);
-  memset(max_inliers_index, int(0), sizeof(int)*ep_num);
+  int ninliers, max_inliers;
   int rand_index[5];
-  double A[6][6];
+  double A[6][6], U[6][6], V[6][6];
+  double *ppa[6], *ppu[6], *ppv[6];
   int M = 6, N = 6; //M is row; N is column
-  for (i = 0; i < N; i++) {
-    A[i][5] = 1;
-    A[5][i] = 0;
-  }
-  double **ppa = (double**)malloc(sizeof(double*)*M);
-  double **ppu = (double**)malloc(sizeof(double*)*M);
-  double **ppv = (double**)malloc(sizeof(double*)*N);
-  for (i = 0; i < M; i++) {
-    ppa[i] = A[i];
-    ppu[i] = (double*)malloc(sizeof(double)*N);
-  }
-  for (i = 0; i < N; i++) {
-    ppv[i] = (double*)malloc(sizeof(double)*N);
-  }
-  double pd[6]; 
+  double pd[6];
   int min_d_index;
   double conic_par[6] = {0};
   double ellipse_par[5] = {0};
-  double best_ellipse_par[5] = {0};
   double ratio;
   double maxaxis;
-  
-  while (sample_num > ransac_count) {
-    get_5_random_num((ep_num-1), rand_index);
-	
+
+  for (i = 0; i < N; i++) {
+    A[i][5] = 1;
+    A[5][i] = 0;
+    ppa[i] = A[i];
+    ppu[i] = U[i];
+    ppv[i] = V[i];
+  }
+
+  while (1) {
+    // Claim next hypothesis, unless enough have been evaluated:
+    PsychLockMutex(&job->mutex);
+    if (job->ransac_count >= job->sample_num || job->ransac_count >= ransac_max_iterations) {
+      PsychUnlockMutex(&job->mutex);
+      break;
+    }
+    job->ransac_count++;
+    max_inliers = job->max_inliers;
+    PsychUnlockMutex(&job->mutex);
+
+    get_5_random_num_r((ep_num-1), rand_index, &worker->seed);
+
     //svd decomposition to solve the ellipse parameter
     for (i = 0; i < 5; i++) {
-      A[i][0] = edge_point_nor[rand_index[i]].x * edge_point_nor[rand_index[i]].x;
-      A[i][1] = edge_point_nor[rand_index[i]].x * edge_point_nor[rand_index[i]].y;
-      A[i][2] = edge_point_nor[rand_index[i]].y * edge_point_nor[rand_index[i]].y;
-      A[i][3] = edge_point_nor[rand_index[i]].x;
-      A[i][4] = edge_point_nor[rand_index[i]].y;
+      A[i][0] = job->xx[rand_index[i]];
+      A[i][1] = job->xy[rand_index[i]];
+      A[i][2] = job->yy[rand_index[i]];
+      A[i][3] = job->x[rand_index[i]];
+      A[i][4] = job->y[rand_index[i]];
     }
 
     svd(M, N, ppa, ppu, pd, ppv);
@@ -436,65 +563,264 @@ int* pupil_fitting_inliers(UINT8* pupil_image, int width, int height,  int &retu
     }
 
     for (i = 0; i < N; i++)
-      conic_par[i] = ppv[i][min_d_index];	//the column of v that corresponds to the smallest singular value, 
-                                                //which is the solution of the equations
-    ninliers = 0;
-    memset(inliers_index, 0, sizeof(int)*ep_num);
-    for (i = 0; i < ep_num; i++) {
-      dis_error = conic_par[0]*edge_point_nor[i].x*edge_point_nor[i].x + 
-                  conic_par[1]*edge_point_nor[i].x*edge_point_nor[i].y +
-                  conic_par[2]*edge_point_nor[i].y*edge_point_nor[i].y + 
-                  conic_par[3]*edge_point_nor[i].x + conic_par[4]*edge_point_nor[i].y + conic_par[5];
-      if (fabs(dis_error) < dis_threshold) {
-        inliers_index[ninliers] = i;
-        ninliers++;
-      }
-    }
+      conic_par[i] = V[i][min_d_index];	//the column of v that corresponds to the smallest singular value,
+                                        //which is the solution of the equations
+    ninliers = ransac_conic_inliers(job, conic_par, NULL);
 
     if (ninliers > max_inliers) {
       if (solve_ellipse(conic_par, ellipse_par)) {
-        denormalize_ellipse_param(ellipse_par, ellipse_par, dis_scale, nor_center);
+        denormalize_ellipse_param(ellipse_par, ellipse_par, job->dis_scale, job->nor_center);
         ratio = ellipse_par[0] / ellipse_par[1];
-		maxaxis = (ellipse_par[0] > ellipse_par[1]) ? ellipse_par[0] : ellipse_par[1];
-        if (ellipse_par[2] > 0 && ellipse_par[2] <= width-1 && ellipse_par[3] > 0 && ellipse_par[3] <= height-1 &&
-            ratio > (1/maxeccentricity) && ratio < maxeccentricity && maxaxis >= min_ellipse_area && maxaxis <= max_ellipse_area) {
-          memcpy(max_inliers_index, inliers_index, sizeof(int)*ep_num);
-          for (i = 0; i < 5; i++) {
-            best_ellipse_par[i] = ellipse_par[i];
+        maxaxis = (ellipse_par[0] > ellipse_par[1]) ? ellipse_par[0] : ellipse_par[1];
+        if (ellipse_par[2] > 0 && ellipse_par[2] <= job->width-1 && ellipse_par[3] > 0 && ellipse_par[3] <= job->height-1 &&
+            ratio > (1/job->maxeccentricity) && ratio < job->maxeccentricity && maxaxis >= job->min_ellipse_area && maxaxis <= job->max_ellipse_area) {
+          ransac_conic_inliers(job, conic_par, inliers_index);
+
+          // Commit as new best hypothesis if no other thread found a better one meanwhile, and
+          // reduce the number of required samples according to the new inlier ratio:
+          PsychLockMutex(&job->mutex);
+          if (ninliers > job->max_inliers) {
+            memcpy(job->max_inliers_index, inliers_index, sizeof(int)*ninliers);
+            for (i = 0; i < 5; i++) {
+              job->best_ellipse_par[i] = ellipse_par[i];
+            }
+            job->max_inliers = ninliers;
+            job->sample_num = ransac_required_samples(ninliers, ep_num, ransac_confidence, ransac_max_iterations);
           }
-          max_inliers = ninliers;
-          sample_num = (int)(log((double)(1-0.99))/log(1.0-pow(ninliers*1.0/ep_num, 5)));
+          PsychUnlockMutex(&job->mutex);
         }
       }
     }
-    ransac_count++;
-    if (ransac_count > 1500) {
-      printf("Error! ransac_count exceed! ransac break! sample_num=%d, ransac_count=%d\n", sample_num, ransac_count);
+  }
+
+  free(inliers_index);
+  return NULL;
+}
+
+// Main loop of a pool thread: Sleep until a job is assigned, evaluate hypotheses for it, report done:
+static void* ransac_pool_thread_main(void* arg)
+{
+  ransac_worker *worker = (ransac_worker*) arg;
+
+  PsychLockMutex(&ransac_pool_mutex);
+  while (1) {
+    while (worker->job == NULL && !ransac_pool_exit)
+      PsychWaitCondition(&worker->wakeup, &ransac_pool_mutex);
+
+    if (ransac_pool_exit)
+      break;
+
+    PsychUnlockMutex(&ransac_pool_mutex);
+    ransac_worker_main((void*) worker);
+    PsychLockMutex(&ransac_pool_mutex);
+
+    worker->job = NULL;
+    if (--ransac_pool_busy == 0)
+      PsychSignalCondition(&ransac_pool_done);
+  }
+  PsychUnlockMutex(&ransac_pool_mutex);
+
+  return NULL;
+}
+
+// Grow the pool to nthreads - 1 pool threads, if possible. Returns the number of threads available
+// for a fit, including the calling thread:
+static int ransac_pool_grow(int nthreads)
+{
+  if (!ransac_pool_initialized) {
+    PsychInitMutex(&ransac_pool_mutex);
+    PsychInitCondition(&ransac_pool_done, NULL);
+    ransac_pool_size = 0;
+    ransac_pool_busy = 0;
+    ransac_pool_exit = false;
+    ransac_pool_initialized = true;
+  }
+
+  while (ransac_pool_size < nthreads - 1) {
+    ransac_worker *worker = &ransac_pool[ransac_pool_size + 1];
+
+    worker->job = NULL;
+    PsychInitCondition(&worker->wakeup, NULL);
+    if (PsychCreateThread(&worker->thread, NULL, ransac_pool_thread_main, (void*) worker)) {
+      // Thread creation failed: Continue with the threads we have.
+      PsychDestroyCondition(&worker->wakeup);
       break;
     }
+    ransac_pool_size++;
+  }
+
+  return (ransac_pool_size + 1 < nthreads) ? ransac_pool_size + 1 : nthreads;
+}
+
+// Stop and join all pool threads, e.g., at tracker shutdown or before unloading the module:
+void ransac_pool_shutdown(void)
+{
+  int i;
+
+  if (!ransac_pool_initialized)
+    return;
+
+  PsychLockMutex(&ransac_pool_mutex);
+  ransac_pool_exit = true;
+  for (i = 1; i <= ransac_pool_size; i++)
+    PsychSignalCondition(&ransac_pool[i].wakeup);
+  PsychUnlockMutex(&ransac_pool_mutex);
+
+  for (i = 1; i <= ransac_pool_size; i++) {
+    PsychDeleteThread(&ransac_pool[i].thread);
+    PsychDestroyCondition(&ransac_pool[i].wakeup);
   }
+
+  PsychDestroyCondition(&ransac_pool_done);
+  PsychDestroyMutex(&ransac_pool_mutex);
+  ransac_pool_size = 0;
+  ransac_pool_initialized = false;
+}
+
+// RMS distance of the inlier edge points from the ellipse par, measured along the line through
+// the ellipse center:
+static double ellipse_fit_residual(double* par, int* inliers_index, int ninliers)
+{
+  stuDPoint *edge;
+  double ct = cos(par[4]);
+  double st = sin(par[4]);
+  double dx, dy, u, v, r, d, sum = 0;
+  int i;
+
+  if (ninliers <= 0)
+    return -1;
+
+  for (i = 0; i < ninliers; i++) {
+    edge = edge_point.at(inliers_index[i]);
+    dx = edge->x - par[2];
+    dy = edge->y - par[3];
+    u = dx*ct + dy*st;
+    v = -dx*st + dy*ct;
+    r = sqrt(u*u + v*v);
+    d = sqrt(u*u / (par[0]*par[0]) + v*v / (par[1]*par[1]));
+    if (d > 0)
+      sum += r*r * (1 - 1/d) * (1 - 1/d);
+  }
+
+  return sqrt(sum / ninliers);
+}
+
+int* pupil_fitting_inliers(UINT8* pupil_image, int width, int height,  int &return_max_inliers_num, double maxeccentricity, double min_ellipse_area, double max_ellipse_area)
+{
+  int i;
+  int ep_num = edge_point.size();   //ep stands for edge point
+  ransac_job job;
+  ransac_worker self;
+  unsigned int seed;
+  int nthreads;
+
+  int ellipse_point_num = 5;	//number of point that needed to fit an ellipse
+  if (ep_num < ellipse_point_num) {
+    printf("Error! %d points are not enough to fit ellipse\n", ep_num);
+    memset(pupil_param, 0, sizeof(pupil_param));
+    pupil_fit_residual = -1;
+    return_max_inliers_num = 0;
+    return NULL;
+  }
+
+  //Normalization
+  stuDPoint *edge_point_nor = normalize_edge_point(job.dis_scale, job.nor_center, ep_num);
+
+  // MK: Store normalized points and their quadratic terms in separate arrays for fast
+  // evaluation of hypotheses:
+  job.x = (double*)malloc(sizeof(double)*ep_num*5);
+  job.y = job.x + ep_num;
+  job.xx = job.y + ep_num;
+  job.xy = job.xx + ep_num;
+  job.yy = job.xy + ep_num;
+  for (i = 0; i < ep_num; i++) {
+    job.x[i] = edge_point_nor[i].x;
+    job.y[i] = edge_point_nor[i].y;
+    job.xx[i] = job.x[i] * job.x[i];
+    job.xy[i] = job.x[i] * job.y[i];
+    job.yy[i] = job.y[i] * job.y[i];
+  }
+  free(edge_point_nor);
+
+  //Ransac
+  job.ep_num = ep_num;
+  job.width = width;
+  job.height = height;
+  job.dis_threshold = sqrt(3.84)*job.dis_scale;
+//  job.dis_threshold = 0.5 * sqrt(3.84)*job.dis_scale;
+  job.maxeccentricity = maxeccentricity;
+  job.min_ellipse_area = min_ellipse_area;
+  job.max_ellipse_area = max_ellipse_area;
+  job.ransac_count = 0;
+  job.sample_num = 1000;	//number of sample
+  job.max_inliers = 0;
+  job.max_inliers_index = (int*)malloc(sizeof(int)*ep_num);
+  memset(job.max_inliers_index, int(0), sizeof(int)*ep_num);
+  memset(job.best_ellipse_par, 0, sizeof(job.best_ellipse_par));
+  PsychInitMutex(&job.mutex);
+
+  // MK: Evaluate hypotheses on the calling thread, plus up to ransac_threads - 1 threads of the
+  // persistent worker pool. Each worker draws from its own random generator, seeded from the global one:
+  nthreads = (ransac_threads < RANSAC_MAX_THREADS) ? ransac_threads : RANSAC_MAX_THREADS;
+  if (nthreads < 1) nthreads = 1;
+  if (nthreads > 1) nthreads = ransac_pool_grow(nthreads);
+
+  self.job = &job;
+  for (i = 0; i < nthreads; i++) {
+    seed = ((unsigned int) rand() << 16) ^ (unsigned int) rand() ^ (unsigned int) (i + 1);
+    if (seed == 0) seed = 0x9e3779b9U;
+
+    if (i == 0) {
+      self.seed = seed;
+    } else {
+      ransac_pool[i].seed = seed;
+    }
+  }
+
+  // Hand the job to the pool threads, then work on it ourselves:
+  if (nthreads > 1) {
+    PsychLockMutex(&ransac_pool_mutex);
+    ransac_pool_busy = nthreads - 1;
+    for (i = 1; i < nthreads; i++) {
+      ransac_pool[i].job = &job;
+      PsychSignalCondition(&ransac_pool[i].wakeup);
+    }
+    PsychUnlockMutex(&ransac_pool_mutex);
+  }
+
+  ransac_worker_main((void*) &self);
+
+  // Wait for the pool threads to finish their last hypotheses:
+  if (nthreads > 1) {
+    PsychLockMutex(&ransac_pool_mutex);
+    while (ransac_pool_busy > 0)
+      PsychWaitCondition(&ransac_pool_done, &ransac_pool_mutex);
+    PsychUnlockMutex(&ransac_pool_mutex);
+  }
+
+  PsychDestroyMutex(&job.mutex);
+
+  if (job.ransac_count >= ransac_max_iterations && job.sample_num > job.ransac_count) {
+    printf("Error! ransac_count exceed! ransac break! sample_num=%d, ransac_count=%d\n", job.sample_num, job.ransac_count);
+  }
+
   //INFO("ransc end\n");
-  if (best_ellipse_par[0] > 0 && best_ellipse_par[1] > 0) {
+  int max_inliers = job.max_inliers;
+  int *max_inliers_index = job.max_inliers_index;
+  if (job.best_ellipse_par[0] > 0 && job.best_ellipse_par[1] > 0) {
     for (i = 0; i < 5; i++) {
-      pupil_param[i] = best_ellipse_par[i];
+      pupil_param[i] = job.best_ellipse_par[i];
     }
+    pupil_fit_residual = ellipse_fit_residual(pupil_param, max_inliers_index, max_inliers);
   } else {
     memset(pupil_param, 0, sizeof(pupil_param));
+    pupil_fit_residual = -1;
     max_inliers = 0;
     free(max_inliers_index);
     max_inliers_index = NULL;
   }
 
-  for (i = 0; i < M; i++) {
-    free(ppu[i]);
-    free(ppv[i]);
-  }
-  free(ppu);
-  free(ppv);
-  free(ppa);
-
-  free(edge_point_nor);
-  free(inliers_index);
+  free(job.x);
   return_max_inliers_num = max_inliers;
   return max_inliers_index;
 }
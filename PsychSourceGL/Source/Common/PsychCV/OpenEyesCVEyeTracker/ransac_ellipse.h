@@ -54,13 +54,19 @@ extern int angle_step;
 extern int pupil_edge_thres;
 extern double pupil_param[5];
 extern vector <stuDPoint*> edge_point;
+extern int ransac_threads;
+extern double ransac_confidence;
+extern int ransac_max_iterations;
+extern double pupil_fit_residual;
 
 void get_5_random_num(int max_num, int* rand_num);
+void get_5_random_num_r(int max_num, int* rand_num, unsigned int* seed);
 bool solve_ellipse(double* conic_param, double* ellipse_param);
 int* pupil_fitting_inliers(UINT8* pupil_image, int, int, int &return_max_inliers, double maxeccentricity, double min_ellipse_area, double max_ellipse_area);
 stuDPoint* normalize_edge_point(double &dis_scale, stuDPoint &nor_center, int ep_num);
 void denormalize_ellipse_param(double* par, double* normailized_par, double dis_scale, stuDPoint nor_center);
 void destroy_edge_point();
+void ransac_pool_shutdown(void);
 
 
 void starburst_pupil_contour_detection(UINT8* pupil_image, int width, int height, int edge_thresh, int N, int minimum_cadidate_features, double initial_angle_spread, double fanoutangle1, double fanoutangle2, int bouncerays, int features_per_ray, double min_feature_dist, double max_feature_dist);
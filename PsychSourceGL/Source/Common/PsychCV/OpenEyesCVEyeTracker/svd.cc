@@ -66,7 +66,10 @@ void svd(int m, int n, double **a, double **p, double *d, double **q)
         double          c, f, h, s, x, y, z;
         double          anorm = 0, g = 0, scale = 0;
         //double         *r = tvector_alloc(0, n, double);
-		double			*r = (double*)malloc(sizeof(double)*n);
+		// MK: Small decompositions, like the 6x6 ones of RANSAC ellipse fitting, use the
+		// stack instead of malloc(), as this gets called from multiple threads at high rate:
+		double			r_small[8];
+		double			*r = (n <= 8) ? r_small : (double*)malloc(sizeof(double)*n);
 
         for (i = 0; i < m; i++)
                 for (j = 0; j < n; j++)
@@ -257,7 +260,7 @@ void svd(int m, int n, double **a, double **p, double *d, double **q)
                         if (its == 30)
                         {
                                 //error("svd: No convergence in 30 svd iterations", non_fatal);
-                                free(r);
+                                if (r != r_small) free(r);
                                 return;
                         }
                         x = d[l];       /* shift from bottom 2-by-2 minor */
@@ -316,7 +319,7 @@ void svd(int m, int n, double **a, double **p, double *d, double **q)
                         d[k] = x;
                 }
         }
-        free(r);
+        if (r != r_small) free(r);
 
 		// dhli add: the original code does not sort the eigen value
 		// should do that and change the eigen vector accordingly
@@ -107,8 +107,8 @@ void InitializeSynopsis()
     synopsis[i++] = "\nSupport for the OpenEyes computer vision based eye tracker:\n";
     synopsis[i++] = "[EyeImageMemBuffer, EyeColorImageMemBuffer, SceneImageMemBuffer, ThresholdImageMemBuffer, EllipseImageMemBuffer] = PsychCV('OpenEyesInitialize', handle [, eyeChannels] [, eyeWidth][, eyeHeight][, sceneWidth][, sceneHeight][, logfilename]);";
     synopsis[i++] = "PsychCV('OpenEyesShutdown', handle);";
-    synopsis[i++] = "[oldSettings, ...] = PsychCV('OpenEyesParameters', handle [, pupilEdgeThreshold][, starburstRays][, minFeatureCandidates][, corneaWindowSize][, edgeThreshold][, gaussWidth][, maxPupilEccentricity] [, initialAngleSpread] [, fanoutAngle1] [, fanoutAngle2] [, featuresPerRay] [, specialFlags]);";
-    synopsis[i++] = "EyeResult = PsychCV('OpenEyesTrackEyePosition', handle [, mode] [, px], [, py]);";
+    synopsis[i++] = "[oldSettings, ...] = PsychCV('OpenEyesParameters', handle [, pupilEdgeThreshold][, starburstRays][, minFeatureCandidates][, corneaWindowSize][, edgeThreshold][, gaussWidth][, maxPupilEccentricity] [, initialAngleSpread] [, fanoutAngle1] [, fanoutAngle2] [, featuresPerRay] [, specialFlags] [, ransacThreads] [, ransacConfidence] [, ransacMaxIterations]);";
+    synopsis[i++] = "[EyeResult, benchResult] = PsychCV('OpenEyesTrackEyePosition', handle [, mode] [, px], [, py]);";
     #endif
     #ifdef PSYCHCV_USE_ARTOOLKIT
     synopsis[i++] = "\nSupport for the ARToolkit computer vision based 3D marker tracking library:\n";
@@ -123,7 +123,7 @@ void InitializeSynopsis()
     #ifdef PSYCHCV_USE_APRILTAGS
     synopsis[i++] = "\nSupport for the apriltag 2D/3D april tag marker tracking library:\n";
     synopsis[i++] = "[inputImageMemBuffer] = PsychCV('AprilInitialize', tagFamilyName, imgWidth, imgHeight, imgChannels [, imgFormat][, maxNrTags]);";
-    synopsis[i++] = "[detectedMarkers] = PsychCV('AprilDetectMarkers'[, markerSubset=all][, infoType=all]);";
+    synopsis[i++] = "[detectedMarkers, timing] = PsychCV('AprilDetectMarkers'[, markerSubset=all][, infoType=all][, trackMode=0][, outputFormat=0]);";
     synopsis[i++] = "PsychCV('AprilShutdown');";
     synopsis[i++] = "[nrThreads, imageDecimation, quadSigma, refineEdges, decodeSharpening, criticalRadAngle, deglitch, maxLineFitMse, minWhiteBlackDiff, minClusterPixels, maxNMaxima] = PsychCV('AprilSettings' [, nrThreads][, imageDecimation][, quadSigma][, refineEdges][, decodeSharpening][, criticalRadAngle][, deglitch][, maxLineFitMse][, minWhiteBlackDiff][, minClusterPixels][, maxNMaxima]);";
     synopsis[i++] = "[glProjectionMatrix, camCalib, tagSize, minD, maxD] = PsychCV('April3DSettings' [, camCalib][, tagSize][, minD][, maxD]);";
@@ -151,6 +151,11 @@ PsychError PsychCVExit(void)
 {
     // Shutdown only if we are online:
     if (psychCVInitialized) {
+        #ifdef PSYCHCV_USE_OPENCV
+        // Stop worker threads of the OpenEyes tracker, if any:
+        cvEyeTrackerExit();
+        #endif
+
         #ifdef PSYCHCV_USE_ARTOOLKIT
         // Perform AR toolkit shutdown, if needed:
         PsychCVARExit();
@@ -224,6 +229,12 @@ static int pupilEdgeThreshold, starburstRays, minFeatureCandidates, corneaWindow
 static double maxPupilEccentricity, initialAngleSpread;
 static double fanoutAngle1, fanoutAngle2;
 static int featuresPerRay, specialFlags;
+static int ransacThreads, ransacMaxIterations;
+static double ransacConfidence;
+
+// Size in bytes and location of the eye image input buffer, for benchmarking on recorded frames:
+static size_t eyeImageBytes;
+static void* eyeImageInput;
 
 #ifdef PSYCHCV_USE_OPENCV
 
@@ -313,6 +324,10 @@ PsychError PSYCHCVOpenEyesInitialize(void)
     // Return double-encoded void* memory pointer to eye image input/output buffer:
     PsychCopyOutDoubleArg(5, kPsychArgOptional, PsychPtrToDouble(ellipseImage));
 
+    // Remember input buffer for the benchmark mode of PsychCV('OpenEyesTrackEyePosition'):
+    eyeImageBytes = (size_t) eyewidth * (size_t) eyeheight * (size_t) eyechannels;
+    eyeImageInput = eyeColorImage;
+
     // Setup default parameters for OpenEyes:
     pupilEdgeThreshold = 20;
     starburstRays = 18;
@@ -326,11 +341,15 @@ PsychError PSYCHCVOpenEyesInitialize(void)
     fanoutAngle2 = 180.0;
     featuresPerRay = 1;
     specialFlags = 0x0;
+    ransacThreads = 1;
+    ransacConfidence = 0.99;
+    ransacMaxIterations = 1501;
 
     // Commit default parameters to tracker:
     cvEyeTrackerSetParameters(pupilEdgeThreshold, starburstRays, minFeatureCandidates, corneaWindowSize, edgeThreshold,
                               gaussWidth, maxPupilEccentricity, initialAngleSpread * PI/180, fanoutAngle1 * PI/180,
                               fanoutAngle2 * PI/180, featuresPerRay, specialFlags);
+    cvEyeTrackerSetRansacParameters(ransacThreads, ransacConfidence, ransacMaxIterations);
 
     return(PsychError_none);
 }
@@ -373,21 +392,35 @@ PsychError PSYCHCVOpenEyesShutdown(void)
  */
 PsychError PSYCHCVOpenEyesTrackEyePosition(void)
 {
-    static char useString[] = "EyeResult = PsychCV('OpenEyesTrackEyePosition', handle [, mode][, px][, py][, c1][, c2]);";
+    static char useString[] = "[EyeResult, benchResult] = PsychCV('OpenEyesTrackEyePosition', handle [, mode][, px][, py][, c1][, c2]);";
     static char synopsisString[] =
-        "Set level of verbosity for error/warning/status messages. 'level' optional, new level "
-        "of verbosity. 'oldlevel' is the old level of verbosity. The following levels are "
-        "supported: 0 = Shut up. 1 = Print errors, 2 = Print also warnings, 3 = Print also some info, "
-        "4 = Print more useful info (default), >5 = Be very verbose (mostly for debugging the driver itself). ";
+        "Perform an eye tracking cycle with OpenEyes, or change tracker state, depending on 'mode':\n"
+        "0 = Track the current content of the eye image input buffer and return the result in 'EyeResult' (default).\n"
+        "1 = Activate scene calibration. 2 = Reset scene calibration.\n"
+        "3 = Set approximate pupil center (px, py) as start point for Starburst, then track.\n"
+        "4 = Add (px, py) as eye to scene calibration point.\n"
+        "5 = Set min/max feature distance px, py and min/max ellipse half-axis c1, c2 as RANSAC constraints.\n"
+        "6 = Set (px, py) as override reference point instead of the detected corneal reflection, (-1,-1) to re-enable detection.\n"
+        "7 = Benchmark on recorded frames: 'px' is a uint8 matrix of consecutive eye images, each in the memory layout "
+        "of the eye input buffer, as it would be copied into it by PsychCV('CopyMatrixToMemBuffer'). Each frame is "
+        "tracked, 'EyeResult' is a struct array with the results of all frames, and 'benchResult' a struct with the "
+        "number of frames and of valid frames, total tracking duration, FramesPerSecond, MaxFrameDuration, and the "
+        "mean and maximum fit residual of all valid frames.\n"
+        "'FitResidual' in 'EyeResult' is the RMS distance in pixels of the inlier features from the fitted pupil ellipse, "
+        "or -1 if tracking failed.";
     static char seeAlsoString[] = "";
 
-    PsychGenericScriptType *eyeStruct;
-    const char *FieldNames[] = { "GazeX", "GazeY", "PupilX", "PupilY", "CorneaX", "CorneaY", "Valid", "Count", "Timestamp" };
-    const int FieldCount = 9;
+    PsychGenericScriptType *eyeStruct, *benchStruct;
+    const char *FieldNames[] = { "GazeX", "GazeY", "PupilX", "PupilY", "CorneaX", "CorneaY", "Valid", "Count", "Timestamp", "FitResidual" };
+    const int FieldCount = 10;
+    const char *BenchFieldNames[] = { "Frames", "ValidFrames", "Duration", "FramesPerSecond", "MaxFrameDuration", "MeanResidual", "MaxResidual" };
+    const int BenchFieldCount = 7;
 
     int handle = -1;
-    int mode;
+    int mode, m, n, p, i, nrFrames, nrValid;
+    unsigned char *frames;
     double px, py, minArea, maxArea;
+    double tStart, tEnd, tTotal, tMax, residualSum, residualMax;
     psych_bool useGUI = FALSE;
     PsychCVEyeResult eyeResult;
 
@@ -397,7 +430,7 @@ PsychError PSYCHCVOpenEyesTrackEyePosition(void)
 
     PsychErrorExit(PsychCapNumInputArgs(6));        // The maximum number of inputs
     PsychErrorExit(PsychRequireNumInputArgs(1));    // The required number of inputs
-    PsychErrorExit(PsychCapNumOutputArgs(1));       // The maximum number of outputs
+    PsychErrorExit(PsychCapNumOutputArgs(2));       // The maximum number of outputs
 
     // Get tracker handle: This is not used yet, just here for future extensions:
     PsychCopyInIntegerArg(1, kPsychArgRequired, &handle);
@@ -406,8 +439,67 @@ PsychError PSYCHCVOpenEyesTrackEyePosition(void)
 
     mode = 0;
     PsychCopyInIntegerArg(2, kPsychArgOptional, &mode);
-    if (mode < 0 || mode > 6)
-        PsychErrorExitMsg(PsychError_user, "Invalid mode provided. Valid modes between 0 and 4.");
+    if (mode < 0 || mode > 7)
+        PsychErrorExitMsg(PsychError_user, "Invalid mode provided. Valid modes between 0 and 7.");
+
+    if (mode == 7) {
+        // Benchmark on recorded frames: 'px' is a uint8 matrix with consecutive eye images, each in the memory
+        // layout of the eye input buffer, as it would be copied into it via PsychCV('CopyMatrixToMemBuffer').
+        // Track each frame with a standard tracking cycle, return one EyeResult per frame, and statistics about
+        // tracking speed and fit residuals in benchResult:
+        PsychAllocInUnsignedByteMatArg(3, kPsychArgRequired, &m, &n, &p, &frames);
+        if ((eyeImageBytes == 0) || ((size_t) m * n * p) % eyeImageBytes)
+            PsychErrorExitMsg(PsychError_user, "Invalid recorded frames provided. Size of uint8 matrix must be a multiple of eyeChannels * eyeWidth * eyeHeight bytes.");
+
+        nrFrames = (int) (((size_t) m * n * p) / eyeImageBytes);
+        PsychAllocOutStructArray(1, kPsychArgOptional, nrFrames, FieldCount, FieldNames, &eyeStruct);
+
+        nrValid = 0;
+        tTotal = tMax = 0;
+        residualSum = residualMax = 0;
+
+        for (i = 0; i < nrFrames; i++) {
+            memcpy(eyeImageInput, frames + (size_t) i * eyeImageBytes, eyeImageBytes);
+
+            PsychGetAdjustedPrecisionTimerSeconds(&tStart);
+            if (!cvEyeTrackerExecuteTrackingCycle(&eyeResult, useGUI)) {
+                // Failed!
+                PsychErrorExitMsg(PsychError_system, "OpenEyes tracking cycle failed.");
+            }
+            PsychGetAdjustedPrecisionTimerSeconds(&tEnd);
+
+            tTotal += tEnd - tStart;
+            if (tEnd - tStart > tMax) tMax = tEnd - tStart;
+
+            if (eyeResult.validresult && eyeResult.fit_residual >= 0) {
+                nrValid++;
+                residualSum += eyeResult.fit_residual;
+                if (eyeResult.fit_residual > residualMax) residualMax = eyeResult.fit_residual;
+            }
+
+            PsychSetStructArrayDoubleElement("GazeX", i, eyeResult.gaze_x, eyeStruct);
+            PsychSetStructArrayDoubleElement("GazeY", i, eyeResult.gaze_y, eyeStruct);
+            PsychSetStructArrayDoubleElement("PupilX", i, eyeResult.pupil_x, eyeStruct);
+            PsychSetStructArrayDoubleElement("PupilY", i, eyeResult.pupil_y, eyeStruct);
+            PsychSetStructArrayDoubleElement("CorneaX", i, eyeResult.cornea_x, eyeStruct);
+            PsychSetStructArrayDoubleElement("CorneaY", i, eyeResult.cornea_y, eyeStruct);
+            PsychSetStructArrayBooleanElement("Valid", i, eyeResult.validresult, eyeStruct);
+            PsychSetStructArrayDoubleElement("Count", i, eyeResult.trackcount, eyeStruct);
+            PsychSetStructArrayDoubleElement("Timestamp", i, eyeResult.timestamp, eyeStruct);
+            PsychSetStructArrayDoubleElement("FitResidual", i, eyeResult.fit_residual, eyeStruct);
+        }
+
+        PsychAllocOutStructArray(2, kPsychArgOptional, -1, BenchFieldCount, BenchFieldNames, &benchStruct);
+        PsychSetStructArrayDoubleElement("Frames", 0, nrFrames, benchStruct);
+        PsychSetStructArrayDoubleElement("ValidFrames", 0, nrValid, benchStruct);
+        PsychSetStructArrayDoubleElement("Duration", 0, tTotal, benchStruct);
+        PsychSetStructArrayDoubleElement("FramesPerSecond", 0, (tTotal > 0) ? nrFrames / tTotal : 0, benchStruct);
+        PsychSetStructArrayDoubleElement("MaxFrameDuration", 0, tMax, benchStruct);
+        PsychSetStructArrayDoubleElement("MeanResidual", 0, (nrValid > 0) ? residualSum / nrValid : -1, benchStruct);
+        PsychSetStructArrayDoubleElement("MaxResidual", 0, (nrValid > 0) ? residualMax : -1, benchStruct);
+
+        return(PsychError_none);
+    }
 
     if (mode == 0 || mode == 3) {
         // Call standard tracker processing cycle:
@@ -456,6 +548,7 @@ PsychError PSYCHCVOpenEyesTrackEyePosition(void)
     PsychSetStructArrayBooleanElement("Valid", 0, eyeResult.validresult, eyeStruct);
     PsychSetStructArrayDoubleElement("Count", 0, eyeResult.trackcount, eyeStruct);
     PsychSetStructArrayDoubleElement("Timestamp", 0, eyeResult.timestamp, eyeStruct);
+    PsychSetStructArrayDoubleElement("FitResidual", 0, eyeResult.fit_residual, eyeStruct);
 
     return(PsychError_none);
 }
@@ -465,7 +558,7 @@ PsychError PSYCHCVOpenEyesTrackEyePosition(void)
 PsychError PSYCHCVOpenEyesParameters(void)
 {
 
-    static char useString[] = "[oldSettings, ...] = PsychCV('OpenEyesParameters', handle [, pupilEdgeThreshold][, starburstRays][, minFeatureCandidates][, corneaWindowSize][, edgeThreshold][, gaussWidth][, maxPupilEccentricity] [, initialAngleSpread] [, fanoutAngle1] [, fanoutAngle2] [, featuresPerRay] [, specialFlags]);";
+    static char useString[] = "[oldSettings, ...] = PsychCV('OpenEyesParameters', handle [, pupilEdgeThreshold][, starburstRays][, minFeatureCandidates][, corneaWindowSize][, edgeThreshold][, gaussWidth][, maxPupilEccentricity] [, initialAngleSpread] [, fanoutAngle1] [, fanoutAngle2] [, featuresPerRay] [, specialFlags] [, ransacThreads] [, ransacConfidence] [, ransacMaxIterations]);";
     static char synopsisString[] =
         "Set level of verbosity for error/warning/status messages. 'level' optional, new level "
         "of verbosity. 'oldlevel' is the old level of verbosity. The following levels are "
@@ -479,9 +572,9 @@ PsychError PSYCHCVOpenEyesParameters(void)
     PsychPushHelp(useString, synopsisString, seeAlsoString);
     if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
 
-    PsychErrorExit(PsychCapNumInputArgs(13));       // The maximum number of inputs
+    PsychErrorExit(PsychCapNumInputArgs(16));       // The maximum number of inputs
     PsychErrorExit(PsychRequireNumInputArgs(1));    // The required number of inputs
-    PsychErrorExit(PsychCapNumOutputArgs(12));      // The maximum number of outputs
+    PsychErrorExit(PsychCapNumOutputArgs(15));      // The maximum number of outputs
 
     // Get tracker handle: This is not used yet, just here for future extensions:
     PsychCopyInIntegerArg(1, kPsychArgRequired, &handle);
@@ -501,6 +594,9 @@ PsychError PSYCHCVOpenEyesParameters(void)
     PsychCopyOutDoubleArg(10, kPsychArgOptional, fanoutAngle2);
     PsychCopyOutDoubleArg(11, kPsychArgOptional, featuresPerRay);
     PsychCopyOutDoubleArg(12, kPsychArgOptional, specialFlags);
+    PsychCopyOutDoubleArg(13, kPsychArgOptional, ransacThreads);
+    PsychCopyOutDoubleArg(14, kPsychArgOptional, ransacConfidence);
+    PsychCopyOutDoubleArg(15, kPsychArgOptional, ransacMaxIterations);
 
     // Get optional parameters. The defaults are the original settings of OpenEyes, set in the initialization call...
     PsychCopyInIntegerArg(2, kPsychArgOptional, &pupilEdgeThreshold);
@@ -546,10 +642,22 @@ PsychError PSYCHCVOpenEyesParameters(void)
     PsychCopyInIntegerArg(13, kPsychArgOptional, &specialFlags);
     if (specialFlags < 0) PsychErrorExitMsg(PsychError_user, "Invalid specialFlags provided. Must be at least 0!");
 
+    // Number of threads for parallel evaluation of RANSAC ellipse hypotheses:
+    PsychCopyInIntegerArg(14, kPsychArgOptional, &ransacThreads);
+    if (ransacThreads < 1 || ransacThreads > 16) PsychErrorExitMsg(PsychError_user, "Invalid ransacThreads provided. Must be between 1 and 16!");
+
+    // Confidence for adaptive early termination of RANSAC:
+    PsychCopyInDoubleArg(15, kPsychArgOptional, &ransacConfidence);
+    if (ransacConfidence <= 0.0 || ransacConfidence >= 1.0) PsychErrorExitMsg(PsychError_user, "Invalid ransacConfidence provided. Must be greater than 0 and smaller than 1!");
+
+    PsychCopyInIntegerArg(16, kPsychArgOptional, &ransacMaxIterations);
+    if (ransacMaxIterations < 1) PsychErrorExitMsg(PsychError_user, "Invalid ransacMaxIterations provided. Must be at least 1!");
+
     // Commit new parameters to tracker:
     cvEyeTrackerSetParameters(pupilEdgeThreshold, starburstRays, minFeatureCandidates, corneaWindowSize, edgeThreshold,
                               gaussWidth, maxPupilEccentricity, initialAngleSpread * PI/180, fanoutAngle1 * PI/180,
                               fanoutAngle2 * PI/180, featuresPerRay, specialFlags);
+    cvEyeTrackerSetRansacParameters(ransacThreads, ransacConfidence, ransacMaxIterations);
 
     return(PsychError_none);
 }
@@ -35,6 +35,7 @@ typedef struct PsychCVEyeResult {
     double cornea_x;
     double cornea_y;
     psych_bool validresult;
+    double fit_residual;
     double timestamp;
     unsigned int trackcount;
 } PsychCVEyeResult;
@@ -68,6 +69,7 @@ psych_bool cvEyeTrackerInitialize(const char* logfilename, int eyewidth, int eye
                                   void** eyeInputImageColor, int scenewidth, int sceneheight, void** sceneInputImageRGB8,
                                   void** ellipseOutputImageRGB8, void** thresholdOutputImageMono8);
 psych_bool cvEyeTrackerShutdown(void);
+void cvEyeTrackerExit(void);
 psych_bool cvEyeTrackerExecuteTrackingCycle(PsychCVEyeResult* eyeResult, psych_bool useHighGUI);
 void cvEyeTrackerSetPupilLocation(int px, int py);
 void cvEyeTrackerAddCalibrationPoint(int px, int py);
@@ -77,6 +79,7 @@ void cvEyeTrackerSetParameters(int pupilEdgeThreshold, int starburstRays, int mi
                                int featuresPerRay, int specialFlags);
 void cvEyeTrackerSetRansacConstraints(double minDist, double maxDist, double minArea, double maxArea);
 void cvEyeTrackerSetOverrideReferencePoint(int rx, int ry);
+void cvEyeTrackerSetRansacParameters(int nrThreads, double confidence, int maxIterations);
 
 PsychError PSYCHCVOpenEyesInitialize(void);
 PsychError PSYCHCVOpenEyesShutdown(void);
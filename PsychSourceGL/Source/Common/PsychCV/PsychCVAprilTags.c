@@ -6,10 +6,12 @@
     AUTHORS:
 
     Mario Kleiner     mk  mario.kleiner.de@gmail.com
+    agent             ag  agent@local
 
     HISTORY:
 
     12.03.2024        mk  Wrote it.
+    19.10.2026        ag  SIMD color to gray conversion, ROI tracking mode, timing and matrix output.
 
     DESCRIPTION:
 
@@ -37,6 +39,14 @@
 #include "tagStandard52h13.h"
 #include "tagCustom48h12.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PSYCHCV_APRIL_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PSYCHCV_APRIL_NEON 1
+#endif
+
 #define April_PIX_SIZE_DEFAULT  1
 
 #define April_PIXEL_FORMAT_MONO 6
@@ -47,6 +57,15 @@
 
 #define April_DEFAULT_PIXEL_FORMAT April_PIXEL_FORMAT_MONO
 
+// Tracking mode: Maximum number of search regions, margin around the predicted
+// tag bounding box as fraction of its size plus a minimum in pixels:
+#define April_MAX_ROIS          64
+#define April_ROI_MARGIN        0.5
+#define April_ROI_MIN_MARGIN    8
+
+// Number of columns of the matrix returned by 'AprilDetectMarkers' for outputFormat 1:
+#define April_MATRIX_COLUMNS    26
+
 // Declare variables local to this file.
 
 // Level of verbosity: Defined in PsychCV.c, read-only accessed here:
@@ -79,12 +98,85 @@ static double view_distance_max = 1000.0;
 static double cam_cx = 1, cam_cy = 1, cam_fx = 1, cam_fy = 1;
 static double tagSize = 1;
 
+// Last known location of each tag of the family for ROI tracking mode:
+typedef struct PsychCVAprilTrackType {
+    psych_bool  valid;
+    double      corners[8];
+    double      dx, dy;             // Motion of the tag center between the last two detections.
+} PsychCVAprilTrackType;
+
+static PsychCVAprilTrackType *trackState = NULL;
+static int trackCallsSinceFullFrame = 0;
+
+// Internal helper: Convert count pixels with a stride of 3 or 4 bytes to gray, using bytes offset to
+// offset + 2 of each pixel as (b0 + 2 * b1 + b2) / 4, ie. the middle green component weighted double:
+static void PsychCVAprilColorToGray(const psych_uint8* src, psych_uint8* dst, int count, int stride, int offset)
+{
+    int i = 0;
+    int gray;
+
+    src += offset;
+
+    #if defined(PSYCHCV_APRIL_SSE2)
+    {
+        const __m128i mask = _mm_set1_epi32(0xff);
+        __m128i v, sum[4];
+        psych_uint32 px[4];
+        int j, k;
+
+        // 16 pixels per iteration. Leave at least one pixel for the scalar loop, so the
+        // 4 byte loads of 3 byte pixels never read beyond the end of the image:
+        for (; i + 16 < count; i += 16) {
+            for (j = 0; j < 4; j++) {
+                for (k = 0; k < 4; k++)
+                    memcpy(&px[k], src + (size_t) (i + j * 4 + k) * stride, sizeof(psych_uint32));
+
+                v = _mm_loadu_si128((const __m128i*) px);
+                sum[j] = _mm_add_epi32(_mm_and_si128(v, mask), _mm_and_si128(_mm_srli_epi32(v, 16), mask));
+                sum[j] = _mm_add_epi32(sum[j], _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(v, 8), mask), 1));
+                sum[j] = _mm_srli_epi32(sum[j], 2);
+            }
+
+            v = _mm_packus_epi16(_mm_packs_epi32(sum[0], sum[1]), _mm_packs_epi32(sum[2], sum[3]));
+            _mm_storeu_si128((__m128i*) (dst + i), v);
+        }
+    }
+    #elif defined(PSYCHCV_APRIL_NEON)
+    {
+        uint8x16_t c0, c1, c2;
+        uint16x8_t lo, hi;
+
+        for (; i + 16 <= count; i += 16) {
+            if (stride == 3) {
+                uint8x16x3_t v = vld3q_u8(src + (size_t) i * 3);
+                c0 = v.val[0]; c1 = v.val[1]; c2 = v.val[2];
+            }
+            else {
+                // Offset of 1 would make the last load read beyond the image, so load from pixel start:
+                uint8x16x4_t v = vld4q_u8(src - offset + (size_t) i * 4);
+                c0 = v.val[offset]; c1 = v.val[offset + 1]; c2 = v.val[offset + 2];
+            }
+
+            lo = vaddq_u16(vaddl_u8(vget_low_u8(c0), vget_low_u8(c2)), vshll_n_u8(vget_low_u8(c1), 1));
+            hi = vaddq_u16(vaddl_u8(vget_high_u8(c0), vget_high_u8(c2)), vshll_n_u8(vget_high_u8(c1), 1));
+            vst1q_u8(dst + i, vcombine_u8(vshrn_n_u16(lo, 2), vshrn_n_u16(hi, 2)));
+        }
+    }
+    #endif
+
+    // Remaining pixels, or all of them without SIMD:
+    for (src += (size_t) i * stride; i < count; i++, src += stride) {
+        gray = src[0] + 2 * src[1] + src[2];
+        dst[i] = (psych_uint8) (gray >> 2);
+    }
+}
+
 // Internal helper: Perform image data conversion if required:
 void PsychCVAprilConvertInputImage(void)
 {
     psych_uint8* src = arImagebuffer->buf;
     psych_uint8* dst = arTrackBuffer->buf;
-    int i, count, gray;
+    int count;
 
     // Conversion needed at all? If input matches requested channelcount and image format
     // of apriltags, then there ain't nothing to do and we can return immediately:
@@ -99,58 +191,20 @@ void PsychCVAprilConvertInputImage(void)
 
     if (imgChannels == 3) {
         // RGB --> MONO: All our video capture engines deliver RGB if 3 channel data is requested:
-        for (i = 0; i < count; i++) {
-            // Sum first 3 bytes (RGB part), use G twice to weight it higher:
-            gray = *(src++);                            // B
-            gray+= *(src);                              // G
-            gray+= *(src++);                            // G
-            gray+= *(src++);                            // R
-
-            // Write out "weighted sum" with gray value:
-            *(dst++) = gray >> 2;
-        }
-
-        // Done:
+        PsychCVAprilColorToGray(src, dst, count, 3, 0);
         return;
     }
 
     if (imgChannels == 4) {
-        // ARGB or BGRA --> MONO: Source depends on input image format
+        // ARGB or BGRA --> MONO: Source depends on input image format. Skip the last
+        // byte for ARGB, the first one for BGRA:
         if (imgFormat == April_PIXEL_FORMAT_ARGB) {
-            for (i = 0; i < count; i++) {
-                // Sum first 3 bytes (RGB part), use G twice to weight it higher:
-                gray = *(src++);                            // B
-                gray+= *(src);                              // G
-                gray+= *(src++);                            // G
-                gray+= *(src++);                            // R
-
-                // Skip last byte (the A part of ARGB):
-                src++;
-
-                // Write out "weighted sum" with gray value:
-                *(dst++) = gray >> 2;
-            }
-
-            // Done:
+            PsychCVAprilColorToGray(src, dst, count, 4, 0);
             return;
         }
 
         if (imgFormat == April_PIXEL_FORMAT_BGRA) {
-            for (i = 0; i < count; i++) {
-                // Skip first byte (the A part of BGRA):
-                src++;
-
-                // Sum first 3 bytes (RGB part), use G twice to weight it higher:
-                gray = *(src++);                            // R
-                gray+= *(src);                              // G
-                gray+= *(src++);                            // G
-                gray+= *(src++);                            // B
-
-                // Write out "weighted sum" with gray value:
-                *(dst++) = gray >> 2;
-            }
-
-            // Done:
+            PsychCVAprilColorToGray(src, dst, count, 4, 1);
             return;
         }
     }
@@ -162,6 +216,123 @@ void PsychCVAprilConvertInputImage(void)
     return;
 }
 
+// Internal helper: Compute search regions [x0, y0, x1, y1) in rois around the predicted locations
+// of all tracked tags in markerSubset. Returns number of regions, or -1 if full frame detection is
+// needed, because no tag is tracked or there are too many or too big regions:
+static int PsychCVAprilPredictROIs(const double* markerSubset, int n, int* rois)
+{
+    PsychCVAprilTrackType *track;
+    double x0, y0, x1, y1, margin;
+    int i, j, k, nrois, area;
+
+    nrois = 0;
+    for (i = 0; i < n; i++) {
+        track = &trackState[(int) markerSubset[i]];
+        if (!track->valid)
+            continue;
+
+        if (nrois >= April_MAX_ROIS)
+            return(-1);
+
+        // Bounding box of last known corners, moved by last motion:
+        x0 = x1 = track->corners[0];
+        y0 = y1 = track->corners[1];
+        for (j = 1; j < 4; j++) {
+            x0 = (track->corners[j * 2] < x0) ? track->corners[j * 2] : x0;
+            x1 = (track->corners[j * 2] > x1) ? track->corners[j * 2] : x1;
+            y0 = (track->corners[j * 2 + 1] < y0) ? track->corners[j * 2 + 1] : y0;
+            y1 = (track->corners[j * 2 + 1] > y1) ? track->corners[j * 2 + 1] : y1;
+        }
+
+        margin = April_ROI_MARGIN * (((x1 - x0) > (y1 - y0)) ? (x1 - x0) : (y1 - y0)) + April_ROI_MIN_MARGIN +
+                 fabs(track->dx) + fabs(track->dy);
+
+        x0 = floor(x0 + track->dx - margin);
+        y0 = floor(y0 + track->dy - margin);
+        x1 = ceil(x1 + track->dx + margin);
+        y1 = ceil(y1 + track->dy + margin);
+
+        rois[nrois * 4 + 0] = (x0 > 0) ? (int) x0 : 0;
+        rois[nrois * 4 + 1] = (y0 > 0) ? (int) y0 : 0;
+        rois[nrois * 4 + 2] = (x1 < imgWidth) ? (int) x1 : imgWidth;
+        rois[nrois * 4 + 3] = (y1 < imgHeight) ? (int) y1 : imgHeight;
+
+        // Predicted outside the image? Tag is lost then:
+        if ((rois[nrois * 4 + 2] <= rois[nrois * 4 + 0]) || (rois[nrois * 4 + 3] <= rois[nrois * 4 + 1]))
+            return(-1);
+
+        nrois++;
+    }
+
+    if (nrois == 0)
+        return(-1);
+
+    // Merge overlapping regions, so no tag is searched for twice:
+    for (i = 0; i < nrois; i++) {
+        for (j = i + 1; j < nrois; j++) {
+            if ((rois[i * 4 + 0] < rois[j * 4 + 2]) && (rois[j * 4 + 0] < rois[i * 4 + 2]) &&
+                (rois[i * 4 + 1] < rois[j * 4 + 3]) && (rois[j * 4 + 1] < rois[i * 4 + 3])) {
+                for (k = 0; k < 2; k++) {
+                    if (rois[j * 4 + k] < rois[i * 4 + k]) rois[i * 4 + k] = rois[j * 4 + k];
+                    if (rois[j * 4 + k + 2] > rois[i * 4 + k + 2]) rois[i * 4 + k + 2] = rois[j * 4 + k + 2];
+                }
+
+                // Remove region j and restart with the grown region i:
+                for (k = 0; k < 4; k++)
+                    rois[j * 4 + k] = rois[(nrois - 1) * 4 + k];
+
+                nrois--;
+                j = i;
+            }
+        }
+    }
+
+    // Searching most of the image in pieces is slower than one full frame detection:
+    area = 0;
+    for (i = 0; i < nrois; i++)
+        area += (rois[i * 4 + 2] - rois[i * 4 + 0]) * (rois[i * 4 + 3] - rois[i * 4 + 1]);
+
+    if (area > imgWidth * imgHeight / 2)
+        return(-1);
+
+    return(nrois);
+}
+
+// Internal helper: Detect tags in region roi of the tracking image, add the detections to
+// detections, with their coordinates translated from region to full image coordinates:
+static void PsychCVAprilDetectInROI(const int* roi, zarray_t* detections)
+{
+    image_u8_t view = { .width = roi[2] - roi[0], .height = roi[3] - roi[1], .stride = arTrackBuffer->stride,
+                        .buf = arTrackBuffer->buf + (size_t) roi[1] * arTrackBuffer->stride + roi[0] };
+    apriltag_detection_t *det;
+    zarray_t *roiDetections;
+    int i, j;
+
+    roiDetections = apriltag_detector_detect(tagDetector, &view);
+
+    for (i = 0; i < zarray_size(roiDetections); i++) {
+        zarray_get(roiDetections, i, &det);
+
+        det->c[0] += roi[0];
+        det->c[1] += roi[1];
+        for (j = 0; j < 4; j++) {
+            det->p[j][0] += roi[0];
+            det->p[j][1] += roi[1];
+        }
+
+        // Homography maps tag to image coordinates, so prepend the translation, as pose estimation uses it:
+        for (j = 0; j < 3; j++) {
+            MATD_EL(det->H, 0, j) += roi[0] * MATD_EL(det->H, 2, j);
+            MATD_EL(det->H, 1, j) += roi[1] * MATD_EL(det->H, 2, j);
+        }
+
+        zarray_add(detections, &det);
+    }
+
+    // Only destroy the array, the detections now belong to detections:
+    zarray_destroy(roiDetections);
+}
+
 void PsychCVAprilExit(void)
 {
     // Perform Shutdown operation, if needed. Called from PsychCVExit routine
@@ -191,6 +362,9 @@ void PsychCVAprilExit(void)
 
         arImagebuffer = NULL;
 
+        free(trackState);
+        trackState = NULL;
+
         // Destroy our detector instance:
         if (tagDetector)
             apriltag_detector_destroy(tagDetector);
@@ -365,6 +539,10 @@ PsychError PSYCHCVAprilInitialize(void)
     // Attach tagFamily to detector:
     apriltag_detector_add_family(tagDetector, tagFamily);
 
+    // Tracking state for all tags, with no tag tracked yet:
+    trackState = (PsychCVAprilTrackType*) calloc(tagFamily->ncodes, sizeof(PsychCVAprilTrackType));
+    trackCallsSinceFullFrame = 0;
+
     // Allocate internal memory buffer of sufficient size:
     switch(imgChannels) {
         case 1:
@@ -380,7 +558,7 @@ PsychError PSYCHCVAprilInitialize(void)
             break;
     }
 
-    if (NULL == arImagebuffer) {
+    if ((NULL == arImagebuffer) || (NULL == trackState)) {
         psychCVAprilInitialized = TRUE;
         PsychCVAprilExit();
         PsychErrorExitMsg(PsychError_outofMemory, "Out of memory when trying to initialize apriltags subsystem!");
@@ -436,8 +614,8 @@ PsychError PSYCHCVAprilShutdown(void)
 
 PsychError PSYCHCVAprilDetectMarkers(void)
 {
-    static char useString[] = "[detectedMarkers] = PsychCV('AprilDetectMarkers'[, markerSubset=all][, infoType=all]);";
-    //                          1                                                 1                   2
+    static char useString[] = "[detectedMarkers, timing] = PsychCV('AprilDetectMarkers'[, markerSubset=all][, infoType=all][, trackMode=0][, outputFormat=0]);";
+    //                          1                2                                        1                   2               3              4
     static char synopsisString[] =
         "Detect apriltags in the current video image, return information about them.\n\n"
         "Analyzes the current video image, stored in the internal input image buffer, and "
@@ -493,28 +671,54 @@ PsychError PSYCHCVAprilDetectMarkers(void)
         "is a rotated version of 'TransformMatrix', rotated 180 degrees around the x-axis for OpenGL "
         "compatibility, as apriltag has x-axis to the right, y-axis down, z-axis along optical looking "
         "direction axis, whereas OpenGL has its x-axis to the right, y-axis up, and the negative z-axis "
-        "along optical looking direction axis / viewing direction, ie. 180 degrees rotated.\n";
+        "along optical looking direction axis / viewing direction, ie. 180 degrees rotated.\n\n"
+        "'trackMode' selects the tracking mode for fast tracking of moving tags, e.g., from head mounted cameras. "
+        "0 = Search all of the image for tags in every call (default). 1 = Search only small regions around the "
+        "predicted locations of the tags found in the previous call first, and only search the full image if a tag "
+        "got lost, or if no tag is tracked. The prediction is the last known location, moved by the last motion. "
+        "This is much faster, but tags which were not found in the previous call will only be found by the next full "
+        "image search. A value n > 1 is like 1, but also forces a full image search at least every n'th call, to find "
+        "new tags. Use PsychCV('AprilSettings') to set the number of processing threads and the image decimation, "
+        "which also apply to searches of regions.\n"
+        "'outputFormat' 0 = Return 'detectedMarkers' as array of structs, as described above (default). 1 = Return "
+        "a numeric matrix instead, which is faster to create and process. It has one row per candidate tag, and the "
+        "following 26 columns: Id, MatchQuality, HammingErrorBits, PoseError, Center2D (2 columns x, y), "
+        "Corners2D (8 columns x1, y1, ..., x4, y4), T (3 columns), R (9 columns, in column-major order). "
+        "'TransformMatrix' and 'ModelViewMatrix' are not returned, but can be built from T and R as described above.\n"
+        "The optional 'timing' is a vector with the duration of the processing stages of this call in seconds, and "
+        "information about the tracking: [tConvert, tDetect, tPose, tTotal, fullFrame, nrRegions]. 'tConvert' is "
+        "the time for color to grayscale conversion of the input image, 'tDetect' for tag detection, 'tPose' for 3D "
+        "pose estimation and assembly of the results, 'tTotal' the total time of this call. 'fullFrame' is 1 if the "
+        "full image was searched, 0 if only regions around tracked tags were searched. 'nrRegions' is the number of "
+        "regions searched in tracking mode before a possible full image search, 0 if no regions were searched.\n";
 
     static char seeAlsoString[] = "AprilInitialize AprilSettings April3DSettings";
     double* markerSubset = NULL;
     int i, j, m, n, p;
-    int infoType;
+    int infoType, trackMode, outputFormat;
     int candHandle;
     int marker_num;
+    int nrois, fullFrame;
+    int rois[April_MAX_ROIS * 4];
     zarray_t *marker_info;
     apriltag_detection_t *detcand;
     apriltag_detection_t *detected;
     apriltag_detection_info_t detinfo;
     apriltag_pose_t pose;
+    PsychCVAprilTrackType *track;
     double matchQuality;
     double poseError;
     int hammingErrorBits;
-    double* xformMatrix;
-    double* modelViewMatrixGL;
-    double* R;
-    double* T;
-    double* center2D;
-    double* corners2D;
+    double xformMatrix[16];
+    double modelViewMatrixGL[16];
+    double R[9];
+    double T[3];
+    double center2D[2];
+    double corners2D[8];
+    double* outMatrix;
+    double* outMat;
+    double* timing;
+    double tStart, tConverted, tDetected, tDone;
 
     PsychGenericScriptType *detectedMarkers, *myMatrix;
     const char *FieldNames[] = { "Id", "MatchQuality", "HammingErrorBits", "PoseError", "Center2D", "Corners2D", "R", "T",
@@ -524,9 +728,9 @@ PsychError PSYCHCVAprilDetectMarkers(void)
     PsychPushHelp(useString, synopsisString, seeAlsoString);
     if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
 
-    PsychErrorExit(PsychCapNumInputArgs(2));        // The maximum number of inputs
+    PsychErrorExit(PsychCapNumInputArgs(4));        // The maximum number of inputs
     PsychErrorExit(PsychRequireNumInputArgs(0));    // The required number of inputs
-    PsychErrorExit(PsychCapNumOutputArgs(1));       // The maximum number of outputs
+    PsychErrorExit(PsychCapNumOutputArgs(2));       // The maximum number of outputs
 
     if (!psychCVAprilInitialized)
         PsychErrorExitMsg(PsychError_user, "apriltags not yet initialized! Call PsychCV('AprilInitialize') first and retry!");
@@ -534,9 +738,13 @@ PsychError PSYCHCVAprilDetectMarkers(void)
     if (tagFamily->ncodes < 1)
         PsychErrorExitMsg(PsychError_user, "No markers from tag family loaded for detection!");
 
+    PsychGetAdjustedPrecisionTimerSeconds(&tStart);
+
     // Perform image data conversion if required:
     PsychCVAprilConvertInputImage();
 
+    PsychGetAdjustedPrecisionTimerSeconds(&tConverted);
+
     // Get optional markerSubset list:
     if (PsychAllocInDoubleMatArg(1, FALSE, &m, &n, &p, &markerSubset)) {
         // List provided: Sanity check!
@@ -567,13 +775,71 @@ PsychError PSYCHCVAprilDetectMarkers(void)
     if (infoType < 0 || infoType > 1)
         PsychErrorExitMsg(PsychError_user, "Invalid 'infoType' provided. Must be positive integer <= 1!");
 
+    // Get optional trackMode:
+    trackMode = 0;
+    PsychCopyInIntegerArg(3, FALSE, &trackMode);
+    if (trackMode < 0)
+        PsychErrorExitMsg(PsychError_user, "Invalid 'trackMode' provided. Must be 0, 1 or greater than 1!");
+
+    // Get optional outputFormat:
+    outputFormat = 0;
+    PsychCopyInIntegerArg(4, FALSE, &outputFormat);
+    if (outputFormat < 0 || outputFormat > 1)
+        PsychErrorExitMsg(PsychError_user, "Invalid 'outputFormat' provided. Must be 0 or 1!");
+
     // Ok, we got the user arguments. Let's do the actual detection:
     tagDetector->debug = (verbosity > 5) ? 1 : 0;
-    marker_info = apriltag_detector_detect(tagDetector, arTrackBuffer);
+
+    // In tracking mode, search the predicted regions of tracked tags first:
+    nrois = 0;
+    marker_info = NULL;
+    if (trackMode > 0) {
+        nrois = PsychCVAprilPredictROIs(markerSubset, n, rois);
+        if ((trackMode > 1) && (trackCallsSinceFullFrame >= trackMode - 1))
+            nrois = -1;
+    }
+
+    if (nrois > 0) {
+        marker_info = zarray_create(sizeof(apriltag_detection_t*));
+        for (i = 0; i < nrois; i++)
+            PsychCVAprilDetectInROI(&rois[i * 4], marker_info);
+
+        // Any tracked tag lost? Then fall back to full frame detection:
+        for (i = 0; (i < n) && marker_info; i++) {
+            if (!trackState[(int) markerSubset[i]].valid)
+                continue;
+
+            for (j = 0; j < zarray_size(marker_info); j++) {
+                zarray_get(marker_info, j, &detcand);
+                if (detcand->id == (int) markerSubset[i])
+                    break;
+            }
+
+            if (j == zarray_size(marker_info)) {
+                if (verbosity > 4)
+                    printf("PsychCV-INFO: AprilDetectMarkers: Lost tracked marker %i. Searching full image.\n", (int) markerSubset[i]);
+
+                apriltag_detections_destroy(marker_info);
+                marker_info = NULL;
+            }
+        }
+    }
+
+    fullFrame = (marker_info) ? 0 : 1;
+    if (fullFrame) {
+        marker_info = apriltag_detector_detect(tagDetector, arTrackBuffer);
+        trackCallsSinceFullFrame = 0;
+    }
+    else {
+        trackCallsSinceFullFrame++;
+    }
+
     marker_num = zarray_size(marker_info);
 
+    PsychGetAdjustedPrecisionTimerSeconds(&tDetected);
+
     if (verbosity > 4) {
-        printf("PsychCV-INFO: AprilDetectMarkers: Detected %i markers in image.\n", marker_num);
+        printf("PsychCV-INFO: AprilDetectMarkers: Detected %i markers in %s.\n", marker_num, (fullFrame) ? "image" : "tracked regions");
 
         for (i = 0; i < marker_num; i++) {
             apriltag_detection_t *det;
@@ -586,50 +852,26 @@ PsychError PSYCHCVAprilDetectMarkers(void)
         printf("PsychCV-INFO: AprilDetectMarkers: -----------------------------\n");
     }
 
-    // Create our fixed size return array with one slot per requested candidate marker:
-    PsychAllocOutStructArray(1, TRUE, n, 10, FieldNames, &detectedMarkers);
+    // Create our fixed size return array or matrix with one slot per requested candidate marker:
+    detectedMarkers = NULL;
+    outMatrix = NULL;
+    if (outputFormat == 0)
+        PsychAllocOutStructArray(1, TRUE, n, 10, FieldNames, &detectedMarkers);
+    else
+        PsychAllocOutDoubleMatArg(1, TRUE, n, April_MATRIX_COLUMNS, 1, &outMatrix);
 
     // Process all our 'n' candidate markers against detected markers:
     for (i = 0; i < n; i++) {
         // Retrieve handle of i'th candidate:
         candHandle = (int) markerSubset[i];
 
-        // Assign marker id to output slot:
-        PsychSetStructArrayDoubleElement("Id", i, candHandle, detectedMarkers);
-
-        R = NULL;
-        PsychAllocateNativeDoubleMat(3, 3, 1, &R, &myMatrix);
-        PsychSetStructArrayNativeElement("R", i, myMatrix, detectedMarkers);
-        memset(R, 0, sizeof(double) * 3 * 3);
-
-        T = NULL;
-        PsychAllocateNativeDoubleMat(3, 1, 1, &T, &myMatrix);
-        PsychSetStructArrayNativeElement("T", i, myMatrix, detectedMarkers);
-        memset(T, 0, sizeof(double) * 3 * 1);
-
-        // Allocate and assign 4x4 xform matrix: xformmatrix must be filled with the 16 values
-        // of the actual matrix later on, we init it with all-zeros:
-        xformMatrix = NULL;
-        PsychAllocateNativeDoubleMat(4, 4, 1, &xformMatrix, &myMatrix);
-        PsychSetStructArrayNativeElement("TransformMatrix", i, myMatrix, detectedMarkers);
-        memset(xformMatrix, 0, sizeof(double) * 4 * 4);
-
-        // Allocate and assign 4x4 modelViewMatrixGL matrix: modelViewMatrixGL must be filled with
-        // the 16 values of the actual matrix later on, we init it with all-zeros:
-        modelViewMatrixGL = NULL;
-        PsychAllocateNativeDoubleMat(4, 4, 1, &modelViewMatrixGL, &myMatrix);
-        PsychSetStructArrayNativeElement("ModelViewMatrix", i, myMatrix, detectedMarkers);
-        memset(modelViewMatrixGL, 0, sizeof(double) * 4 * 4);
-
-        center2D = NULL;
-        PsychAllocateNativeDoubleMat(2, 1, 1, &center2D, &myMatrix);
-        PsychSetStructArrayNativeElement("Center2D", i, myMatrix, detectedMarkers);
-        memset(center2D, 0, sizeof(double) * 2);
-
-        corners2D = NULL;
-        PsychAllocateNativeDoubleMat(2, 4, 1, &corners2D, &myMatrix);
-        PsychSetStructArrayNativeElement("Corners2D", i, myMatrix, detectedMarkers);
-        memset(corners2D, 0, sizeof(double) * 2 * 4);
+        // Init all results to zero:
+        memset(R, 0, sizeof(R));
+        memset(T, 0, sizeof(T));
+        memset(xformMatrix, 0, sizeof(xformMatrix));
+        memset(modelViewMatrixGL, 0, sizeof(modelViewMatrixGL));
+        memset(center2D, 0, sizeof(center2D));
+        memset(corners2D, 0, sizeof(corners2D));
 
         // Search for best matching pattern:
         detected = NULL;
@@ -658,6 +900,8 @@ PsychError PSYCHCVAprilDetectMarkers(void)
 
         matchQuality = 0;
         hammingErrorBits = 1000;
+        poseError = 0;
+        track = &trackState[candHandle];
         if (detected) {
             matchQuality = detected->decision_margin;
             hammingErrorBits = detected->hamming;
@@ -677,7 +921,18 @@ PsychError PSYCHCVAprilDetectMarkers(void)
             corners2D[6] = detected->p[3][0];
             corners2D[7] = detected->p[3][1];
 
-            poseError = 0;
+            // Update tracking state with motion of the tag center and new location:
+            if (track->valid) {
+                track->dx = center2D[0] - 0.25 * (track->corners[0] + track->corners[2] + track->corners[4] + track->corners[6]);
+                track->dy = center2D[1] - 0.25 * (track->corners[1] + track->corners[3] + track->corners[5] + track->corners[7]);
+            }
+            else {
+                track->dx = track->dy = 0;
+            }
+
+            memcpy(track->corners, corners2D, sizeof(corners2D));
+            track->valid = TRUE;
+
             if (infoType & 0x1) {
                 // Compute pose:
                 detinfo.det = detected;
@@ -704,7 +959,6 @@ PsychError PSYCHCVAprilDetectMarkers(void)
                 T[0] = MATD_EL(pose.t, 0, 0);
                 T[1] = MATD_EL(pose.t, 1, 0);
                 T[2] = MATD_EL(pose.t, 2, 0);
-
                 // Return 3x3 rotation matrix:
                 j=0;
                 R[j++] = MATD_EL(pose.R, 0, 0);
@@ -788,16 +1042,76 @@ PsychError PSYCHCVAprilDetectMarkers(void)
                 printf("PsychCV-INFO: AprilDetectMarkers: Marker %i has match quality %f. Hamming error %i. Pose error %f.\n",
                        candHandle, matchQuality, hammingErrorBits, poseError);
         }
+        else {
+            // Not found: Tag is lost for tracking:
+            track->valid = FALSE;
+        }
+
+        if (outputFormat == 0) {
+            // Assign marker id to output slot:
+            PsychSetStructArrayDoubleElement("Id", i, candHandle, detectedMarkers);
+
+            // Assign final matchQuality:
+            PsychSetStructArrayDoubleElement("MatchQuality", i, matchQuality, detectedMarkers);
+            PsychSetStructArrayDoubleElement("HammingErrorBits", i, hammingErrorBits, detectedMarkers);
+            PsychSetStructArrayDoubleElement("PoseError", i, poseError, detectedMarkers);
+
+            PsychAllocateNativeDoubleMat(3, 3, 1, &outMat, &myMatrix);
+            memcpy(outMat, R, sizeof(R));
+            PsychSetStructArrayNativeElement("R", i, myMatrix, detectedMarkers);
+
+            PsychAllocateNativeDoubleMat(3, 1, 1, &outMat, &myMatrix);
+            memcpy(outMat, T, sizeof(T));
+            PsychSetStructArrayNativeElement("T", i, myMatrix, detectedMarkers);
+
+            PsychAllocateNativeDoubleMat(4, 4, 1, &outMat, &myMatrix);
+            memcpy(outMat, xformMatrix, sizeof(xformMatrix));
+            PsychSetStructArrayNativeElement("TransformMatrix", i, myMatrix, detectedMarkers);
 
-        // Assign final matchQuality:
-        PsychSetStructArrayDoubleElement("MatchQuality", i, matchQuality, detectedMarkers);
-        PsychSetStructArrayDoubleElement("HammingErrorBits", i, hammingErrorBits, detectedMarkers);
-        PsychSetStructArrayDoubleElement("PoseError", i, poseError, detectedMarkers);
+            PsychAllocateNativeDoubleMat(4, 4, 1, &outMat, &myMatrix);
+            memcpy(outMat, modelViewMatrixGL, sizeof(modelViewMatrixGL));
+            PsychSetStructArrayNativeElement("ModelViewMatrix", i, myMatrix, detectedMarkers);
+
+            PsychAllocateNativeDoubleMat(2, 1, 1, &outMat, &myMatrix);
+            memcpy(outMat, center2D, sizeof(center2D));
+            PsychSetStructArrayNativeElement("Center2D", i, myMatrix, detectedMarkers);
+
+            PsychAllocateNativeDoubleMat(2, 4, 1, &outMat, &myMatrix);
+            memcpy(outMat, corners2D, sizeof(corners2D));
+            PsychSetStructArrayNativeElement("Corners2D", i, myMatrix, detectedMarkers);
+        }
+        else {
+            // Assign row i of column-major n x April_MATRIX_COLUMNS matrix:
+            j = 0;
+            outMatrix[i + n * j++] = candHandle;
+            outMatrix[i + n * j++] = matchQuality;
+            outMatrix[i + n * j++] = hammingErrorBits;
+            outMatrix[i + n * j++] = poseError;
+            for (m = 0; m < 2; m++)
+                outMatrix[i + n * j++] = center2D[m];
+            for (m = 0; m < 8; m++)
+                outMatrix[i + n * j++] = corners2D[m];
+            for (m = 0; m < 3; m++)
+                outMatrix[i + n * j++] = T[m];
+            for (m = 0; m < 9; m++)
+                outMatrix[i + n * j++] = R[m];
+        }
     }
 
     // Release array of detected markers and all single marker elements:
     apriltag_detections_destroy(marker_info);
 
+    PsychGetAdjustedPrecisionTimerSeconds(&tDone);
+
+    // Return optional timing of processing stages and tracking info:
+    PsychAllocOutDoubleMatArg(2, FALSE, 1, 6, 1, &timing);
+    timing[0] = tConverted - tStart;
+    timing[1] = tDetected - tConverted;
+    timing[2] = tDone - tDetected;
+    timing[3] = tDone - tStart;
+    timing[4] = fullFrame;
+    timing[5] = (nrois > 0) ? nrois : 0;
+
     return(PsychError_none);
 }
 
@@ -9,6 +9,7 @@
  *
  * Allen.Ingling@nyu.edu               awi
  * mario.kleiner.de@gmail.com          mk
+ * agent@local                         ag
  *
  * HISTORY:
  *
@@ -18,6 +19,9 @@
  * 4/3/05   dgp        Added prototype for PsychHIDReceiveReportsCleanup.
  * 8/23/07  rpw        Added prototypes for PsychHIDKbTriggerWait and PsychHIDKbQueue suite.
  * 12/17/09 rpw        Added prototype for PsychHIDGetDeviceListByUsages.
+ * 10/19/26 ag         Added prototypes for KbQueue aggregate event buffer.
+ * 10/19/26 ag         Added PsychUSBStreamRecord and prototypes for generic USB report streaming.
+ * 10/19/26 ag         Added PsychHIDGamePadSamplerRecord and prototypes for the gamepad sampler.
  *
  */
 
@@ -39,6 +43,7 @@
 #define PSYCH_HID_MAX_DEVICE_ELEMENTS                       1024
 #define PSYCH_HID_MAX_GENERIC_USB_DEVICES                   64
 #define PSYCH_HID_MAX_VALUATORS                             20
+#define PSYCH_HID_MAX_GAMEPAD_ELEMENTS                      256
 
 // OS/X specific includes:
 #if PSYCH_SYSTEM == PSYCH_OSX
@@ -157,15 +162,69 @@ struct PsychUSBSetupSpec_Struct {
 
 typedef struct PsychUSBSetupSpec_Struct PsychUSBSetupSpec;
 
+// Structure to keep track of the report ringbuffer of a streaming in-endpoint of a generic USB device.
+// Filled by the OS specific transport via PsychHIDUSBStreamAddReport(), emptied by 'USBGetStreamedReports':
+struct PsychUSBStreamRecord_Struct {
+    psych_mutex     mutex;              // Protects all fields below, except the constant setup parameters.
+    psych_condition condition;          // Signalled whenever a new report is added.
+    psych_uint8*    data;               // Payload of 'capacity' reports of 'reportSize' bytes each.
+    double*         timestamps;         // GetSecs() completion timestamps of the reports.
+    int*            lengths;            // Number of actually received bytes of the reports.
+    unsigned int    capacity;           // Maximum number of buffered reports.
+    unsigned int    readPos;            // Index of the oldest not yet fetched report.
+    unsigned int    writePos;           // Index of the next report to add.
+    unsigned int    lostCount;          // Number of reports discarded due to a full buffer since last fetch.
+    int             reportSize;         // Maximum size of a single report / transfer in bytes.
+    int             endPoint;           // USB in-endpoint address.
+    int             transferType;       // 0 = Interrupt transfers, 1 = Bulk transfers.
+    int             numTransfers;       // Number of transfers kept in flight.
+    unsigned int    timeOutMSecs;       // Timeout of the individual transfers, 0 = None.
+    int             running;            // 1 = Transfers get resubmitted on completion, 0 = Stopped.
+    int             error;              // Negative OS error code of the transfer which stopped streaming, 0 = none.
+    void*           os;                 // OS specific transport state, NULL if transport is stopped.
+};
+
+typedef struct PsychUSBStreamRecord_Struct PsychUSBStreamRecord;
+
 // Structure to keep track of a generic USB device:
 struct PsychUSBDeviceRecord_Struct {
     int valid;                          // 0 = Unused/Free device record, 1 = Active device record.
     int firstClaimedInterface;          // -1 = No interface claimed yet. Otherwise number of 1st claimed interface.
     void* device;                       // libusb device handle.
+    PsychUSBStreamRecord* stream;       // Report streaming state, NULL if streaming was never started.
+    double simulatedReportRate;         // > 0 = Test-only simulated device, streaming this many reports per second. 0 = Real device.
 };
 
 typedef struct PsychUSBDeviceRecord_Struct PsychUSBDeviceRecord;
 
+// Structure to keep track of a gamepad sampler, which samples the state of all axes, hats and buttons of
+// a game controller at a fixed rate on a background thread. A sample is a vector of its GetSecs() sampling
+// time, followed by the values of all axes, all hats and all buttons, in that order:
+struct PsychHIDGamePadSamplerRecord_Struct {
+    psych_mutex     mutex;              // Protects all fields below, except the constant setup parameters.
+    psych_condition condition;          // Signalled to wake up the sampling thread for termination.
+    psych_thread    thread;             // Sampling thread.
+    psych_bool      threadRunning;      // Sampling thread created and not yet joined?
+    psych_bool      terminate;          // Request to sampling thread to terminate.
+    int             deviceIndex;        // Index of the sampled input device.
+    int             numAxes;            // Number of axes, excluding hats.
+    int             numHats;            // Number of hat axes, ie. two per hat switch.
+    int             numButtons;         // Number of buttons.
+    int             sampleSize;         // Number of values per sample, ie. 1 + numAxes + numHats + numButtons.
+    double          axisMin[PSYCH_HID_MAX_GAMEPAD_ELEMENTS];    // Minimum values of axes and hats.
+    double          axisMax[PSYCH_HID_MAX_GAMEPAD_ELEMENTS];    // Maximum values of axes and hats.
+    double          interval;           // Sampling interval in seconds.
+    double*         latest;             // Most recent sample.
+    double*         history;            // Ringbuffer with 'capacity' samples.
+    unsigned int    capacity;           // Maximum number of samples in history.
+    unsigned int    readPos;            // Index of the oldest not yet fetched sample.
+    unsigned int    writePos;           // Index of the next sample to add.
+    unsigned int    lostCount;          // Number of samples discarded due to a full history since last fetch.
+    void*           os;                 // OS specific device state.
+};
+
+typedef struct PsychHIDGamePadSamplerRecord_Struct PsychHIDGamePadSamplerRecord;
+
 // Function prototypes for module subfunctions.
 PsychError MODULEVersion(void);                         // MODULEVersion.c
 PsychError PSYCHHIDGetNumDevices(void);                 // PSYCHHIDGetNumDevices.c
@@ -191,6 +250,8 @@ PsychError PSYCHHIDKbQueueFlush(void);                  // PsychHIDKbQueueFlush.
 PsychError PSYCHHIDKbQueueRelease(void);                // PsychHIDKbQueueRelease.c
 PsychError PSYCHHIDKbCheck(void);                       // PsychHIDKbCheck.c
 PsychError PSYCHHIDKbQueueGetEvent(void);               // PsychHIDKbCheck.c
+PsychError PSYCHHIDKbQueueAggregate(void);              // PsychHIDKbQueueAggregate.c
+PsychError PSYCHHIDKbQueueAggregateGetEvents(void);     // PsychHIDKbQueueAggregate.c
 
 PsychError PSYCHHIDGetReport(void);                     // PsychHIDGetReport.c
 PsychError PSYCHHIDSetReport(void);                     // PsychHIDSetReport.c
@@ -203,6 +264,14 @@ PsychError PSYCHHIDUSBControlTransfer(void);            // PSYCHHIDUSBControlTra
 PsychError PSYCHHIDUSBBulkTransfer(void);               // PSYCHHIDUSBControlTransfer.c
 PsychError PSYCHHIDUSBInterruptTransfer(void);          // PSYCHHIDUSBControlTransfer.c
 PsychError PSYCHHIDUSBClaimInterface(void);             // PSYCHHIDUSBControlTransfer.c
+PsychError PSYCHHIDUSBStartStreaming(void);             // PsychHIDUSBStreaming.c
+PsychError PSYCHHIDUSBStopStreaming(void);              // PsychHIDUSBStreaming.c
+PsychError PSYCHHIDUSBGetStreamedReports(void);         // PsychHIDUSBStreaming.c
+
+PsychError PSYCHHIDGamePadSamplerStart(void);           // PsychHIDGamePadSampler.c
+PsychError PSYCHHIDGamePadSamplerStop(void);            // PsychHIDGamePadSampler.c
+PsychError PSYCHHIDGamePadSamplerGetState(void);        // PsychHIDGamePadSampler.c
+PsychError PSYCHHIDGamePadSamplerGetHistory(void);      // PsychHIDGamePadSampler.c
 
 PsychError PSYCHHIDKeyboardHelper(void);                // PSYCHHIDKeyboardHelper.c
 
@@ -243,6 +312,15 @@ void                    PsychHIDCloseAllUSBDevices(void);
 PsychUSBDeviceRecord*   PsychHIDGetFreeUSBDeviceSlot(int* usbHandle);
 PsychUSBDeviceRecord*   PsychHIDGetUSBDevice(int usbHandle);
 
+// Helpers inside PsychHIDUSBStreaming.c:
+void PsychHIDUSBStreamAddReport(PsychUSBStreamRecord* stream, const psych_uint8* data, int length, double timestamp);
+void PsychHIDUSBStreamRelease(PsychUSBDeviceRecord* devRecord);
+psych_bool PsychHIDUSBOpenSimulatedDevice(PsychUSBDeviceRecord* devRecord);
+void PsychHIDUSBCloseDevice(PsychUSBDeviceRecord* devRecord);
+
+// Helpers inside PsychHIDGamePadSampler.c:
+void PsychHIDGamePadSamplerReleaseAll(void);
+
 // Helpers inside PsychHIDReceiveReports.c:
 void PsychHIDReleaseAllReportMemory(void);
 void PsychHIDAllocateReports(int deviceIndex);
@@ -255,6 +333,8 @@ int         PsychHIDOSControlTransfer(PsychUSBDeviceRecord* devRecord, psych_uin
 int         PsychHIDOSBulkTransfer(PsychUSBDeviceRecord* devRecord, psych_uint8 endPoint, int length, psych_uint8* buffer, int* count, unsigned int timeOutMSecs);
 int         PsychHIDOSInterruptTransfer(PsychUSBDeviceRecord* devRecord, psych_uint8 endPoint, int length, psych_uint8* buffer, int* count, unsigned int timeOutMSecs);
 int         PsychHIDOSClaimInterface(PsychUSBDeviceRecord* devRecord, int interfaceId);
+int         PsychHIDOSStartStreaming(PsychUSBDeviceRecord* devRecord);
+void        PsychHIDOSStopStreaming(PsychUSBDeviceRecord* devRecord);
 
 // These must be defined for each OS in their own PsychHIDStandardInterfaces.c:
 #ifdef __cplusplus
@@ -266,6 +346,9 @@ void        PsychHIDShutdownHIDStandardInterfaces(void);
 PsychError  PsychHIDEnumerateHIDInputDevices(int deviceClass);
 PsychError  PsychHIDOSKbCheck(int deviceIndex, double* scanList);
 PsychError  PsychHIDOSGamePadAxisQuery(int deviceIndex, int axisId, double* min, double* max, double* val, char* axisLabel);
+psych_bool  PsychHIDOSGamePadSamplerOpen(PsychHIDGamePadSamplerRecord* sampler);
+psych_bool  PsychHIDOSGamePadSamplerRead(PsychHIDGamePadSamplerRecord* sampler, double* values);
+void        PsychHIDOSGamePadSamplerClose(PsychHIDGamePadSamplerRecord* sampler);
 int         PsychHIDGetDefaultKbQueueDevice(void);
 
 PsychError  PsychHIDOSKbQueueCreate(int deviceIndex, int numScankeys, int* scanKeys, int numValuators, int numSlots, unsigned int flags, psych_uint64 windowHandle);
@@ -282,8 +365,10 @@ psych_bool  PsychHIDDeleteEventBuffer(int deviceIndex);
 psych_bool  PsychHIDFlushEventBuffer(int deviceIndex);
 unsigned int PsychHIDAvailEventBuffer(int deviceIndex, unsigned int flags);
 int         PsychHIDReturnEventFromEventBuffer(int deviceIndex, int outArgIndex, double maxWaitTimeSecs);
-PsychHIDEventRecord* PsychHIDLastTouchEventFromEventBuffer(int deviceIndex, int touchID);
+psych_bool  PsychHIDLastTouchEventFromEventBuffer(int deviceIndex, int touchID, unsigned int setStatus, PsychHIDEventRecord* lastevt);
 int         PsychHIDAddEventToEventBuffer(int deviceIndex, PsychHIDEventRecord* evt);
+psych_bool  PsychHIDCreateAggregateEventBuffer(int numDevices, int* deviceIndices, unsigned int* typeMasks, int numSlots);
+int         PsychHIDReturnEventsFromAggregateBuffer(int outArgIndex, int maxEvents, double maxWaitTimeSecs);
 
 #ifdef __cplusplus
 }
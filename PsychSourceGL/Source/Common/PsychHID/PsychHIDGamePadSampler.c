@@ -0,0 +1,385 @@
+/*
+ * PsychSourceGL/Source/Common/PsychHID/PsychHIDGamePadSampler.c
+ *
+ * PROJECTS: PsychHID
+ *
+ * PLATFORMS:   All, but only implemented on Linux.
+ *
+ * AUTHORS:
+ *
+ * agent@local                  ag
+ *
+ * HISTORY:
+ *
+ * 19.10.2026   Created.
+ *
+ * DESCRIPTION:
+ *
+ * Gamepad sampler: A background thread samples all axes, hats and buttons of a game controller
+ * at a fixed rate, via the OS specific PsychHIDOSGamePadSamplerRead(), and stores the samples
+ * in a most recent state snapshot and a timestamped history ringbuffer. This allows to track
+ * a joystick continuously, with one call per frame instead of one query per axis or button.
+ */
+
+#include "PsychHID.h"
+
+// Gamepad samplers of all input devices, NULL if none:
+static PsychHIDGamePadSamplerRecord* gamePadSamplers[PSYCH_HID_MAX_DEVICES];
+
+static PsychHIDGamePadSamplerRecord* PsychHIDGetGamePadSampler(int deviceIndex)
+{
+    if ((deviceIndex < 0) || (deviceIndex >= PSYCH_HID_MAX_DEVICES))
+        PsychErrorExitMsg(PsychError_user, "Invalid deviceIndex specified. No such device!");
+
+    if (!gamePadSamplers[deviceIndex])
+        PsychErrorExitMsg(PsychError_user, "No gamepad sampler for this deviceIndex. Call PsychHID('GamePadSamplerStart') first.");
+
+    return(gamePadSamplers[deviceIndex]);
+}
+
+static void* PsychHIDGamePadSamplerThreadMain(void* arg)
+{
+    PsychHIDGamePadSamplerRecord* sampler = (PsychHIDGamePadSamplerRecord*) arg;
+    double *sample;
+    double tnow, tnext;
+    int rc;
+
+    // Assign a name to ourselves, for debugging:
+    PsychSetThreadName("PsychHIDGamePad");
+
+    // Try to raise our priority, for a stable sampling rate:
+    if ((rc = PsychSetThreadPriority(NULL, 2, 1)) > 0) {
+        printf("PsychHID: GamePadSamplerStart: Failed to switch sampling thread to realtime priority [%s].\n", strerror(rc));
+    }
+
+    sample = (double*) malloc(sampler->sampleSize * sizeof(double));
+    if (!sample) {
+        printf("PsychHID-ERROR: GamePadSampler: Out of memory! Sampling of device %i stopped.\n", sampler->deviceIndex);
+        return(NULL);
+    }
+
+    PsychGetAdjustedPrecisionTimerSeconds(&tnext);
+
+    PsychLockMutex(&sampler->mutex);
+
+    while (!sampler->terminate) {
+        PsychUnlockMutex(&sampler->mutex);
+
+        // Take sample outside of the lock, timestamped at start of sampling:
+        PsychGetAdjustedPrecisionTimerSeconds(&sample[0]);
+        if (!PsychHIDOSGamePadSamplerRead(sampler, &sample[1])) {
+            printf("PsychHID-ERROR: GamePadSampler: Sampling device %i failed, e.g., because it got disconnected. Sampling stopped.\n", sampler->deviceIndex);
+            PsychLockMutex(&sampler->mutex);
+            break;
+        }
+
+        PsychLockMutex(&sampler->mutex);
+
+        memcpy(sampler->latest, sample, sampler->sampleSize * sizeof(double));
+
+        if (sampler->writePos - sampler->readPos < sampler->capacity) {
+            memcpy(&(sampler->history[(size_t) (sampler->writePos % sampler->capacity) * sampler->sampleSize]), sample, sampler->sampleSize * sizeof(double));
+            sampler->writePos++;
+        }
+        else {
+            sampler->lostCount++;
+        }
+
+        // Sleep until next sampling tick or termination request. Skip ticks we are already late
+        // for, instead of catching up with a burst of samples:
+        tnext += sampler->interval;
+        PsychGetAdjustedPrecisionTimerSeconds(&tnow);
+        if (tnext < tnow)
+            tnext = tnow;
+
+        while (!sampler->terminate && (tnow < tnext)) {
+            PsychTimedWaitCondition(&sampler->condition, &sampler->mutex, tnext - tnow);
+            PsychGetAdjustedPrecisionTimerSeconds(&tnow);
+        }
+    }
+
+    PsychUnlockMutex(&sampler->mutex);
+
+    free(sample);
+
+    return(NULL);
+}
+
+// Stop sampling thread of 'sampler', if it is running:
+static void PsychHIDGamePadSamplerStopThread(PsychHIDGamePadSamplerRecord* sampler)
+{
+    if (!sampler->threadRunning)
+        return;
+
+    PsychLockMutex(&sampler->mutex);
+    sampler->terminate = TRUE;
+    PsychSignalCondition(&sampler->condition);
+    PsychUnlockMutex(&sampler->mutex);
+
+    PsychDeleteThread(&sampler->thread);
+    sampler->threadRunning = FALSE;
+}
+
+static void PsychHIDGamePadSamplerRelease(int deviceIndex)
+{
+    PsychHIDGamePadSamplerRecord* sampler = gamePadSamplers[deviceIndex];
+
+    if (!sampler)
+        return;
+
+    PsychHIDGamePadSamplerStopThread(sampler);
+    PsychHIDOSGamePadSamplerClose(sampler);
+    gamePadSamplers[deviceIndex] = NULL;
+
+    PsychDestroyMutex(&sampler->mutex);
+    PsychDestroyCondition(&sampler->condition);
+    free(sampler->latest);
+    free(sampler->history);
+    free(sampler);
+}
+
+void PsychHIDGamePadSamplerReleaseAll(void)
+{
+    int i;
+
+    for (i = 0; i < PSYCH_HID_MAX_DEVICES; i++)
+        PsychHIDGamePadSamplerRelease(i);
+}
+
+PsychError PSYCHHIDGamePadSamplerStart(void)
+{
+    static char useString[] = "[numAxes, numHats, numButtons, axisRanges] = PsychHID('GamePadSamplerStart', deviceIndex [, samplingRate=500][, numSlots=10000])";
+    //                          1        2        3           4                                             1               2                    3
+    static char synopsisString[] =  "Start sampling the state of all axes, hats and buttons of a game controller at a fixed rate.\n"
+                                    "A background thread samples the complete state of the game controller 'deviceIndex' at a rate of "
+                                    "'samplingRate' Hz, between 1 and 2000 Hz, by default 500 Hz. Each sample is timestamped with the "
+                                    "GetSecs() time of sampling. The most recent sample can be retrieved via PsychHID('GamePadSamplerGetState'), "
+                                    "all samples taken since the last retrieval via PsychHID('GamePadSamplerGetHistory'). The history keeps "
+                                    "up to 'numSlots' samples, by default 10000. If the history is full, new samples are discarded and counted "
+                                    "as lost, but the most recent sample is still updated.\n"
+                                    "Calling this function again discards all samples of a previous sampling session of the device.\n"
+                                    "The function returns the layout of a sample: 'numAxes' is the number of axes, 'numHats' the number "
+                                    "of hat axes, ie. two axes (horizontal and vertical) per hat switch, and 'numButtons' the number of buttons. "
+                                    "'axisRanges' is a 2-by-(numAxes + numHats) matrix with the minimum value of each axis in the first row, "
+                                    "and the maximum value in the second row.\n"
+                                    "On Linux, the device is accessed via its evdev device node, so you need read access to it, e.g., by "
+                                    "membership in the 'input' group. The environment variable PSYCHHID_EVDEV_NODE_<deviceIndex> can be "
+                                    "used to select a different device node. This function is not yet implemented on other operating systems.\n";
+    static char seeAlsoString[] =   "GamePadSamplerStop GamePadSamplerGetState GamePadSamplerGetHistory";
+
+    PsychHIDGamePadSamplerRecord probe;
+    PsychHIDGamePadSamplerRecord *sampler;
+    double *axisRanges;
+    double samplingRate = 500;
+    int deviceIndex, i;
+    int numSlots = 10000;
+
+    // Setup the help features.
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return PsychError_none; }
+
+    // Make sure the correct number of input arguments is supplied:
+    PsychErrorExit(PsychRequireNumInputArgs(1));
+    PsychErrorExit(PsychCapNumInputArgs(3));
+    PsychErrorExit(PsychCapNumOutputArgs(4));
+
+    PsychCopyInIntegerArg(1, TRUE, &deviceIndex);
+    if ((deviceIndex < 0) || (deviceIndex >= PSYCH_HID_MAX_DEVICES))
+        PsychErrorExitMsg(PsychError_user, "Invalid deviceIndex specified. No such device!");
+
+    if (PsychCopyInDoubleArg(2, FALSE, &samplingRate) && ((samplingRate < 1) || (samplingRate > 2000)))
+        PsychErrorExitMsg(PsychError_user, "Argument samplingRate must be between 1 and 2000 Hz!");
+
+    if (PsychCopyInIntegerArg(3, FALSE, &numSlots) && (numSlots < 1))
+        PsychErrorExitMsg(PsychError_user, "Argument numSlots must be at least 1!");
+
+    // Discard previous sampler of this device, if any:
+    PsychHIDGamePadSamplerRelease(deviceIndex);
+
+    // Open device and query its layout:
+    memset(&probe, 0, sizeof(probe));
+    probe.deviceIndex = deviceIndex;
+    if (!PsychHIDOSGamePadSamplerOpen(&probe))
+        PsychErrorExitMsg(PsychError_user, "Could not open input device for gamepad sampling. See error messages above for reason.");
+
+    probe.sampleSize = 1 + probe.numAxes + probe.numHats + probe.numButtons;
+    probe.interval = 1.0 / samplingRate;
+    probe.capacity = (unsigned int) numSlots;
+
+    sampler = (PsychHIDGamePadSamplerRecord*) malloc(sizeof(PsychHIDGamePadSamplerRecord));
+    if (sampler) {
+        memcpy(sampler, &probe, sizeof(probe));
+        sampler->latest = (double*) calloc(sampler->sampleSize, sizeof(double));
+        sampler->history = (double*) malloc((size_t) numSlots * sampler->sampleSize * sizeof(double));
+    }
+
+    if (!sampler || !sampler->latest || !sampler->history) {
+        if (sampler) {
+            free(sampler->latest);
+            free(sampler->history);
+            free(sampler);
+        }
+        PsychHIDOSGamePadSamplerClose(&probe);
+        PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while allocating gamepad sampler history.");
+    }
+
+    PsychInitMutex(&sampler->mutex);
+    PsychInitCondition(&sampler->condition, NULL);
+    gamePadSamplers[deviceIndex] = sampler;
+
+    // Take initial sample, so 'GamePadSamplerGetState' always has a valid state to return:
+    PsychGetAdjustedPrecisionTimerSeconds(&sampler->latest[0]);
+    if (!PsychHIDOSGamePadSamplerRead(sampler, &sampler->latest[1])) {
+        PsychHIDGamePadSamplerRelease(deviceIndex);
+        PsychErrorExitMsg(PsychError_system, "Could not sample state of input device for gamepad sampling.");
+    }
+
+    if (PsychCreateThread(&sampler->thread, NULL, PsychHIDGamePadSamplerThreadMain, (void*) sampler)) {
+        PsychHIDGamePadSamplerRelease(deviceIndex);
+        PsychErrorExitMsg(PsychError_system, "Creation of gamepad sampling thread failed!");
+    }
+
+    sampler->threadRunning = TRUE;
+
+    PsychCopyOutDoubleArg(1, FALSE, (double) sampler->numAxes);
+    PsychCopyOutDoubleArg(2, FALSE, (double) sampler->numHats);
+    PsychCopyOutDoubleArg(3, FALSE, (double) sampler->numButtons);
+
+    PsychAllocOutDoubleMatArg(4, FALSE, 2, sampler->numAxes + sampler->numHats, 1, &axisRanges);
+    for (i = 0; i < sampler->numAxes + sampler->numHats; i++) {
+        *(axisRanges++) = sampler->axisMin[i];
+        *(axisRanges++) = sampler->axisMax[i];
+    }
+
+    return(PsychError_none);
+}
+
+PsychError PSYCHHIDGamePadSamplerStop(void)
+{
+    static char useString[] = "PsychHID('GamePadSamplerStop', deviceIndex)";
+    //                                                        1
+    static char synopsisString[] =  "Stop sampling game controller 'deviceIndex'.\n"
+                                    "The most recent sample and all not yet retrieved samples of the history can still be "
+                                    "retrieved after stopping.\n";
+    static char seeAlsoString[] =   "GamePadSamplerStart GamePadSamplerGetState GamePadSamplerGetHistory";
+
+    int deviceIndex;
+
+    // Setup the help features.
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return PsychError_none; }
+
+    // Make sure the correct number of input arguments is supplied:
+    PsychErrorExit(PsychRequireNumInputArgs(1));
+    PsychErrorExit(PsychCapNumInputArgs(1));
+    PsychErrorExit(PsychCapNumOutputArgs(0));
+
+    PsychCopyInIntegerArg(1, TRUE, &deviceIndex);
+
+    PsychHIDGamePadSamplerStopThread(PsychHIDGetGamePadSampler(deviceIndex));
+
+    return(PsychError_none);
+}
+
+PsychError PSYCHHIDGamePadSamplerGetState(void)
+{
+    static char useString[] = "[state, timestamp] = PsychHID('GamePadSamplerGetState', deviceIndex)";
+    //                          1      2                                               1
+    static char synopsisString[] =  "Return the most recent sample of game controller 'deviceIndex'.\n"
+                                    "'state' is a row vector with the values of all axes, followed by all hat axes, followed "
+                                    "by all buttons, as described in PsychHID('GamePadSamplerStart'). Buttons are 1 if pressed, 0 "
+                                    "otherwise. 'timestamp' is the GetSecs() time of the sample.\n";
+    static char seeAlsoString[] =   "GamePadSamplerStart GamePadSamplerStop GamePadSamplerGetHistory";
+
+    PsychHIDGamePadSamplerRecord *sampler;
+    double *state;
+    double timestamp;
+    int deviceIndex;
+
+    // Setup the help features.
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return PsychError_none; }
+
+    // Make sure the correct number of input arguments is supplied:
+    PsychErrorExit(PsychRequireNumInputArgs(1));
+    PsychErrorExit(PsychCapNumInputArgs(1));
+    PsychErrorExit(PsychCapNumOutputArgs(2));
+
+    PsychCopyInIntegerArg(1, TRUE, &deviceIndex);
+    sampler = PsychHIDGetGamePadSampler(deviceIndex);
+
+    PsychAllocOutDoubleMatArg(1, FALSE, 1, sampler->sampleSize - 1, 1, &state);
+
+    PsychLockMutex(&sampler->mutex);
+    timestamp = sampler->latest[0];
+    memcpy(state, &sampler->latest[1], (sampler->sampleSize - 1) * sizeof(double));
+    PsychUnlockMutex(&sampler->mutex);
+
+    PsychCopyOutDoubleArg(2, FALSE, timestamp);
+
+    return(PsychError_none);
+}
+
+PsychError PSYCHHIDGamePadSamplerGetHistory(void)
+{
+    static char useString[] = "[samples, navail, lostCount] = PsychHID('GamePadSamplerGetHistory', deviceIndex [, maxSamples=inf])";
+    //                          1        2       3                                                  1               2
+    static char synopsisString[] =  "Return all samples of game controller 'deviceIndex' taken since the last call.\n"
+                                    "Returns up to 'maxSamples' of the oldest not yet retrieved samples, all by default, as matrix 'samples', "
+                                    "with one column per sample. Row 1 contains the GetSecs() time of the sample, the following rows contain "
+                                    "the sampled state, in the same layout as returned by PsychHID('GamePadSamplerGetState').\n"
+                                    "'navail' is the number of samples which remain in the history after this call.\n"
+                                    "'lostCount' is the number of samples discarded since the last call, because the history was full.\n";
+    static char seeAlsoString[] =   "GamePadSamplerStart GamePadSamplerStop GamePadSamplerGetState";
+
+    PsychHIDGamePadSamplerRecord *sampler;
+    double *samples;
+    double maxSamples = INT_MAX;
+    unsigned int navail, n, i, lost;
+    int deviceIndex;
+
+    // Setup the help features.
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return PsychError_none; }
+
+    // Make sure the correct number of input arguments is supplied:
+    PsychErrorExit(PsychRequireNumInputArgs(1));
+    PsychErrorExit(PsychCapNumInputArgs(2));
+    PsychErrorExit(PsychCapNumOutputArgs(3));
+
+    PsychCopyInIntegerArg(1, TRUE, &deviceIndex);
+
+    if (PsychCopyInDoubleArg(2, FALSE, &maxSamples) && (maxSamples < 0))
+        PsychErrorExitMsg(PsychError_user, "Argument maxSamples must be at least zero!");
+
+    if (maxSamples > INT_MAX)
+        maxSamples = INT_MAX;
+
+    sampler = PsychHIDGetGamePadSampler(deviceIndex);
+
+    PsychLockMutex(&sampler->mutex);
+    navail = sampler->writePos - sampler->readPos;
+    PsychUnlockMutex(&sampler->mutex);
+
+    // Only we consume samples, so at least n samples will still be available after allocating the output:
+    n = (navail < (unsigned int) maxSamples) ? navail : (unsigned int) maxSamples;
+    PsychAllocOutDoubleMatArg(1, FALSE, sampler->sampleSize, (int) n, 1, &samples);
+
+    PsychLockMutex(&sampler->mutex);
+
+    for (i = 0; i < n; i++)
+        memcpy(&samples[(size_t) i * sampler->sampleSize], &(sampler->history[(size_t) ((sampler->readPos + i) % sampler->capacity) * sampler->sampleSize]),
+               sampler->sampleSize * sizeof(double));
+
+    sampler->readPos += n;
+    navail = sampler->writePos - sampler->readPos;
+    lost = sampler->lostCount;
+    sampler->lostCount = 0;
+
+    PsychUnlockMutex(&sampler->mutex);
+
+    PsychCopyOutDoubleArg(2, FALSE, (double) navail);
+    PsychCopyOutDoubleArg(3, FALSE, (double) lost);
+
+    return(PsychError_none);
+}
@@ -13,6 +13,7 @@
  *
  *  22.07.2011  Created.
  *  25.10.2022  Extended to support macOS.
+ *  19.10.2026  Added streaming of in-endpoints via asynchronous transfers.
  *
  *  DESCRIPTION:
  *
@@ -51,6 +52,14 @@ extern int libusb_init(libusb_context **ctx) __attribute__((weak_import));
 static int ctx_refcount = 0;
 static libusb_context *ctx = NULL;
 
+// Transport state of a streaming in-endpoint, referenced by PsychUSBStreamRecord->os:
+typedef struct PsychUSBStreamTransport {
+    struct libusb_transfer**    transfers;      // Array of numTransfers async transfers.
+    int                         inFlight;       // Number of currently submitted transfers, protected by stream->mutex.
+    psych_bool                  threadRunning;  // Event handling thread created?
+    psych_thread                thread;         // Event handling thread.
+} PsychUSBStreamTransport;
+
 // Function Declarations
 int ConfigureDevice(libusb_device_handle* dev, int configIdx);
 
@@ -76,6 +85,9 @@ int PsychHIDOSControlTransfer(PsychUSBDeviceRecord* devRecord, psych_uint8 bmReq
 // Close USB device, mark device record as "free/invalid":
 void PsychHIDOSCloseUSBDevice(PsychUSBDeviceRecord* devRecord)
 {
+    // Stop streaming and release stream buffer, if any:
+    PsychHIDUSBStreamRelease(devRecord);
+
     libusb_close((libusb_device_handle*) devRecord->device);
     devRecord->device = NULL;
     devRecord->valid = 0;
@@ -159,6 +171,7 @@ psych_bool PsychHIDOSOpenUSBDevice(PsychUSBDeviceRecord* devRecord, int* errorco
         devRecord->device = (void*) dev;
         devRecord->valid = 1;
         devRecord->firstClaimedInterface = -1;
+        devRecord->stream = NULL;
 
         // Configure device
         rc = ConfigureDevice(dev, spec->configurationID);
@@ -447,3 +460,212 @@ int PsychHIDOSClaimInterface(PsychUSBDeviceRecord* devRecord, int interfaceId)
     return (rc);
 }
 
+
+// Completion callback for streaming transfers. Called from within libusb event handling, usually on
+// our streaming thread, but possibly also on the thread of a concurrent synchronous transfer:
+static void LIBUSB_CALL PsychHIDOSStreamTransferCallback(struct libusb_transfer *transfer)
+{
+    PsychUSBStreamRecord* stream = (PsychUSBStreamRecord*) transfer->user_data;
+    PsychUSBStreamTransport* transport = (PsychUSBStreamTransport*) stream->os;
+    double tnow;
+    int rc = 0;
+
+    // Timestamp completion as early as possible:
+    PsychGetAdjustedPrecisionTimerSeconds(&tnow);
+
+    switch (transfer->status) {
+        case LIBUSB_TRANSFER_COMPLETED:
+        case LIBUSB_TRANSFER_TIMED_OUT:
+            // Timed out bulk transfers may carry partial data:
+            if ((transfer->status == LIBUSB_TRANSFER_COMPLETED) || (transfer->actual_length > 0))
+                PsychHIDUSBStreamAddReport(stream, transfer->buffer, transfer->actual_length, tnow);
+        break;
+
+        case LIBUSB_TRANSFER_CANCELLED:
+        break;
+
+        case LIBUSB_TRANSFER_STALL:
+            rc = LIBUSB_ERROR_PIPE;
+        break;
+
+        case LIBUSB_TRANSFER_NO_DEVICE:
+            rc = LIBUSB_ERROR_NO_DEVICE;
+        break;
+
+        case LIBUSB_TRANSFER_OVERFLOW:
+            rc = LIBUSB_ERROR_OVERFLOW;
+        break;
+
+        default:
+            rc = LIBUSB_ERROR_IO;
+    }
+
+    PsychLockMutex(&stream->mutex);
+
+    // Resubmit immediately, unless streaming is stopped or failed. This is done under the lock,
+    // so PsychHIDOSStopStreaming() can't miss a resubmitted transfer when cancelling:
+    if (stream->running && (rc == 0) && ((rc = libusb_submit_transfer(transfer)) == 0)) {
+        PsychUnlockMutex(&stream->mutex);
+        return;
+    }
+
+    if (stream->running) {
+        // Failure: Stop streaming, so the remaining transfers retire as well:
+        stream->running = 0;
+        stream->error = rc;
+        printf("PsychHID-ERROR: USB streaming transfer on endpoint 0x%x failed, streaming stopped: %s - %s.\n",
+               stream->endPoint, libusb_error_name(rc), libusb_strerror(rc));
+    }
+
+    transport->inFlight--;
+    PsychUnlockMutex(&stream->mutex);
+}
+
+// Event handling thread for streaming: Runs until all transfers of the stream are retired:
+static void* PsychHIDOSStreamThreadMain(void* arg)
+{
+    PsychUSBStreamRecord* stream = (PsychUSBStreamRecord*) arg;
+    PsychUSBStreamTransport* transport = (PsychUSBStreamTransport*) stream->os;
+    struct timeval tv;
+    int rc, inFlight;
+
+    // Assign a name to ourselves, for debugging:
+    PsychSetThreadName("PsychHIDUSBStrm");
+
+    // Try to raise our priority, for precise completion timestamps:
+    if ((rc = PsychSetThreadPriority(NULL, 2, 1)) > 0) {
+        printf("PsychHID: USBStartStreaming: Failed to switch streaming thread to realtime priority [%s].\n", strerror(rc));
+    }
+
+    while (TRUE) {
+        PsychLockMutex(&stream->mutex);
+        inFlight = transport->inFlight;
+        PsychUnlockMutex(&stream->mutex);
+
+        if (inFlight == 0)
+            break;
+
+        // Wait for and dispatch completions, with a timeout to recheck inFlight regularly:
+        tv.tv_sec = 0;
+        tv.tv_usec = 100000;
+        libusb_handle_events_timeout_completed(ctx, &tv, NULL);
+    }
+
+    return(NULL);
+}
+
+int PsychHIDOSStartStreaming(PsychUSBDeviceRecord* devRecord)
+{
+    PsychUSBStreamRecord* stream = devRecord->stream;
+    PsychUSBStreamTransport* transport;
+    libusb_device_handle* dev = (libusb_device_handle*) devRecord->device;
+    unsigned char* buffer;
+    int i, rc = 0;
+
+    if (dev == NULL)
+        PsychErrorExitMsg(PsychError_internal, "libusb_device_handle* device points to NULL device!");
+
+    // If no interface was claimed by user script yet, try to claim interface #0 to enable the transfers:
+    if ((devRecord->firstClaimedInterface < 0) && ((rc = PsychHIDOSClaimInterface(devRecord, 0)) < 0))
+        return (rc);
+
+    transport = (PsychUSBStreamTransport*) calloc(1, sizeof(PsychUSBStreamTransport));
+    if (transport)
+        transport->transfers = (struct libusb_transfer**) calloc(stream->numTransfers, sizeof(struct libusb_transfer*));
+
+    if (!transport || !transport->transfers) {
+        free(transport);
+        printf("PsychHID-ERROR: Out of memory while setting up USB streaming transfers.\n");
+        return (LIBUSB_ERROR_NO_MEM);
+    }
+
+    stream->os = (void*) transport;
+
+    // Allocate and submit all transfers:
+    for (i = 0; i < stream->numTransfers; i++) {
+        transport->transfers[i] = libusb_alloc_transfer(0);
+        buffer = (unsigned char*) malloc(stream->reportSize);
+        if (!transport->transfers[i] || !buffer) {
+            free(buffer);
+            rc = LIBUSB_ERROR_NO_MEM;
+            break;
+        }
+
+        if (stream->transferType == 1)
+            libusb_fill_bulk_transfer(transport->transfers[i], dev, (unsigned char) stream->endPoint, buffer, stream->reportSize,
+                                      PsychHIDOSStreamTransferCallback, (void*) stream, stream->timeOutMSecs);
+        else
+            libusb_fill_interrupt_transfer(transport->transfers[i], dev, (unsigned char) stream->endPoint, buffer, stream->reportSize,
+                                           PsychHIDOSStreamTransferCallback, (void*) stream, stream->timeOutMSecs);
+
+        transport->transfers[i]->flags = LIBUSB_TRANSFER_FREE_BUFFER;
+
+        PsychLockMutex(&stream->mutex);
+        rc = libusb_submit_transfer(transport->transfers[i]);
+        if (rc == 0)
+            transport->inFlight++;
+        PsychUnlockMutex(&stream->mutex);
+
+        if (rc < 0)
+            break;
+    }
+
+    if (rc < 0)
+        printf("PsychHID-ERROR: Submitting USB streaming transfers failed: %s - %s.\n", libusb_error_name(rc), libusb_strerror(rc));
+
+    // Start event handling thread, which also retires transfers already submitted in case of failure:
+    if ((transport->inFlight > 0) && PsychCreateThread(&transport->thread, NULL, PsychHIDOSStreamThreadMain, (void*) stream)) {
+        printf("PsychHID-ERROR: Creation of USB streaming thread failed!\n");
+        rc = LIBUSB_ERROR_OTHER;
+    }
+    else {
+        transport->threadRunning = (transport->inFlight > 0) ? TRUE : FALSE;
+    }
+
+    if (rc < 0) {
+        PsychHIDOSStopStreaming(devRecord);
+        return (rc);
+    }
+
+    return (LIBUSB_SUCCESS);
+}
+
+void PsychHIDOSStopStreaming(PsychUSBDeviceRecord* devRecord)
+{
+    PsychUSBStreamRecord* stream = devRecord->stream;
+    PsychUSBStreamTransport* transport = (PsychUSBStreamTransport*) stream->os;
+    int i;
+
+    if (transport == NULL)
+        return;
+
+    // Prevent resubmission, then cancel all transfers still in flight:
+    PsychLockMutex(&stream->mutex);
+    stream->running = 0;
+    PsychUnlockMutex(&stream->mutex);
+
+    for (i = 0; i < stream->numTransfers; i++) {
+        if (transport->transfers[i])
+            libusb_cancel_transfer(transport->transfers[i]);
+    }
+
+    if (transport->threadRunning) {
+        // Wait for the thread to retire all cancelled transfers and exit:
+        PsychDeleteThread(&transport->thread);
+    }
+    else if (transport->inFlight > 0) {
+        // No thread to retire the submitted transfers, so do it ourselves:
+        while (transport->inFlight > 0)
+            libusb_handle_events_completed(ctx, NULL);
+    }
+
+    // All transfers retired, safe to free them and their buffers:
+    for (i = 0; i < stream->numTransfers; i++) {
+        if (transport->transfers[i])
+            libusb_free_transfer(transport->transfers[i]);
+    }
+
+    free(transport->transfers);
+    free(transport);
+    stream->os = NULL;
+}
@@ -8,12 +8,14 @@
   AUTHORS:
   Allen.Ingling@nyu.edu             awi
   mario.kleiner@tuebingen.mpg.de    mk
+  agent@local                       ag
 
   HISTORY:
   5/05/03  awi        Created.
   4/19/05  dgp      cosmetic.
   8/23/07  rpw      added PsychHIDKbQueueRelease() to PsychHIDCleanup()
   4/04/09  mk        added support routines for generic USB devices and usbDeviceRecordBank.
+  10/19/26 ag       added aggregate event buffer, which merges events of multiple devices ordered by time.
 
   TO DO:
 
@@ -50,6 +52,18 @@ unsigned int    hidEventBufferWritePos[PSYCH_HID_MAX_DEVICES];
 psych_mutex     hidEventBufferMutex[PSYCH_HID_MAX_DEVICES];
 psych_condition hidEventBufferCondition[PSYCH_HID_MAX_DEVICES];
 
+// Aggregate event buffer, which merges the events of multiple devices, ordered by timestamp.
+// hidAggregateTypeMask[i] is the mask of accepted event types of member device i, zero for non-members:
+PsychHIDEventRecord* hidAggregateBuffer = NULL;
+int*            hidAggregateSource = NULL;
+unsigned int    hidAggregateCapacity = 0;
+unsigned int    hidAggregateReadPos = 0;
+unsigned int    hidAggregateWritePos = 0;
+unsigned int    hidAggregateDropped = 0;
+psych_mutex     hidAggregateMutex;
+psych_condition hidAggregateCondition;
+volatile unsigned int hidAggregateTypeMask[PSYCH_HID_MAX_DEVICES];
+
 /* PsychInitializePsychHID()
  *
  * Master init routine - Called at module load time / first time init.
@@ -62,6 +76,7 @@ void PsychInitializePsychHID(void)
     // Initialize the generic USB tracker to "all off" state:
     for (i = 0; i < PSYCH_HID_MAX_GENERIC_USB_DEVICES; i++) {
         usbDeviceRecordBank[i].valid = 0;
+        usbDeviceRecordBank[i].stream = NULL;
     }
 
     // Setup event ringbuffers:
@@ -70,8 +85,19 @@ void PsychInitializePsychHID(void)
         hidEventBufferCapacity[i] = 10000; // Initial capacity of event buffer.
         hidEventBufferReadPos[i] = 0;
         hidEventBufferWritePos[i] = 0;
+        hidAggregateTypeMask[i] = 0;
     }
 
+    // Setup aggregate event buffer:
+    hidAggregateBuffer = NULL;
+    hidAggregateSource = NULL;
+    hidAggregateCapacity = 0;
+    hidAggregateReadPos = 0;
+    hidAggregateWritePos = 0;
+    hidAggregateDropped = 0;
+    PsychInitMutex(&hidAggregateMutex);
+    PsychInitCondition(&hidAggregateCondition, NULL);
+
 #if PSYCH_SYSTEM == PSYCH_OSX
     for (i = 0; i < MAXDEVICEINDEXS; i++) deviceInterfaces[i] = NULL;
 
@@ -152,7 +178,7 @@ void PsychHIDCloseAllUSBDevices(void)
     int i;
     for (i = 0; i < PSYCH_HID_MAX_GENERIC_USB_DEVICES; i++) {
         if (usbDeviceRecordBank[i].valid) {
-            PsychHIDOSCloseUSBDevice(PsychHIDGetUSBDevice(i));
+            PsychHIDUSBCloseDevice(PsychHIDGetUSBDevice(i));
         }
     }
 }
@@ -176,9 +202,17 @@ PsychError PsychHIDCleanup(void)
     // Shutdown USB-HID report low-level functions, e.g., for DAQ toolbox on OS/X:
     PsychHIDReceiveReportsCleanup(); // PsychHIDReceiveReport.c
 
+    // Stop and release all gamepad samplers, before their devices go away:
+    PsychHIDGamePadSamplerReleaseAll();
+
     // Shutdown os specific interfaces and routines:
     PsychHIDShutdownHIDStandardInterfaces();
 
+    // Release aggregate event buffer:
+    PsychHIDCreateAggregateEventBuffer(0, NULL, NULL, 0);
+    PsychDestroyMutex(&hidAggregateMutex);
+    PsychDestroyCondition(&hidAggregateCondition);
+
     // Release all other HID device data structures:
 #if PSYCH_SYSTEM == PSYCH_OSX
     // Via Apple HIDUtils:
@@ -368,14 +402,39 @@ unsigned int PsychHIDAvailEventBuffer(int deviceIndex, unsigned int flags)
     return(navail);
 }
 
+// Assign content of event 'evt' to the index'th element of event struct array 'retevent':
+static void PsychHIDSetEventStructElement(int index, PsychHIDEventRecord* evt, PsychGenericScriptType* retevent)
+{
+    PsychGenericScriptType *outMat;
+    double *v;
+    int j;
+
+    PsychSetStructArrayDoubleElement("Type",         index, (double) evt->type,                        retevent);
+    PsychSetStructArrayDoubleElement("Time",         index, evt->timestamp,                            retevent);
+    PsychSetStructArrayDoubleElement("Pressed",      index, (double) (evt->status & (1 << 0)) ? 1 : 0, retevent);
+    PsychSetStructArrayDoubleElement("Keycode",      index, (double) evt->rawEventCode,                retevent);
+    PsychSetStructArrayDoubleElement("CookedKey",    index, (double) evt->cookedEventCode,             retevent);
+    PsychSetStructArrayDoubleElement("ButtonStates", index, (double) evt->buttonStates,                retevent);
+    PsychSetStructArrayDoubleElement("Motion",       index, (double) (evt->status & (1 << 1)) ? 1 : 0, retevent);
+    PsychSetStructArrayDoubleElement("X",            index, (double) evt->X,                           retevent);
+    PsychSetStructArrayDoubleElement("Y",            index, (double) evt->Y,                           retevent);
+    PsychSetStructArrayDoubleElement("NormX",        index, (double) evt->normX,                       retevent);
+    PsychSetStructArrayDoubleElement("NormY",        index, (double) evt->normY,                       retevent);
+
+    // Copy out all valuators (including redundant (X,Y) again:
+    v = NULL;
+    PsychAllocateNativeDoubleMat(1, evt->numValuators, 1, &v, &outMat);
+    for (j = 0; j < evt->numValuators; j++)
+        *(v++) = (double) evt->valuators[j];
+    PsychSetStructArrayNativeElement("Valuators", index, outMat, retevent);
+}
+
 int PsychHIDReturnEventFromEventBuffer(int deviceIndex, int outArgIndex, double maxWaitTimeSecs)
 {
-    unsigned int navail, j;
+    unsigned int navail;
     PsychHIDEventRecord evt;
     PsychGenericScriptType *retevent;
     double* foo = NULL;
-    PsychGenericScriptType *outMat;
-    double *v;
     const char *FieldNames[] = { "Type", "Time", "Pressed", "Keycode", "CookedKey", "ButtonStates", "Motion", "X", "Y", "NormX", "NormY", "Valuators" };
 
     if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
@@ -422,24 +481,7 @@ int PsychHIDReturnEventFromEventBuffer(int deviceIndex, int outArgIndex, double
                 PsychErrorExitMsg(PsychError_internal, "Unhandled keyboard queue event type!");
         }
 
-        PsychSetStructArrayDoubleElement("Type",         0, (double) evt.type,                        retevent);
-        PsychSetStructArrayDoubleElement("Time",         0, evt.timestamp,                            retevent);
-        PsychSetStructArrayDoubleElement("Pressed",      0, (double) (evt.status & (1 << 0)) ? 1 : 0, retevent);
-        PsychSetStructArrayDoubleElement("Keycode",      0, (double) evt.rawEventCode,                retevent);
-        PsychSetStructArrayDoubleElement("CookedKey",    0, (double) evt.cookedEventCode,             retevent);
-        PsychSetStructArrayDoubleElement("ButtonStates", 0, (double) evt.buttonStates,                retevent);
-        PsychSetStructArrayDoubleElement("Motion",       0, (double) (evt.status & (1 << 1)) ? 1 : 0, retevent);
-        PsychSetStructArrayDoubleElement("X",            0, (double) evt.X,                           retevent);
-        PsychSetStructArrayDoubleElement("Y",            0, (double) evt.Y,                           retevent);
-        PsychSetStructArrayDoubleElement("NormX",        0, (double) evt.normX,                       retevent);
-        PsychSetStructArrayDoubleElement("NormY",        0, (double) evt.normY,                       retevent);
-
-        // Copy out all valuators (including redundant (X,Y) again:
-        v = NULL;
-        PsychAllocateNativeDoubleMat(1, evt.numValuators, 1, &v, &outMat);
-        for (j = 0; j < evt.numValuators; j++)
-            *(v++) = (double) evt.valuators[j];
-        PsychSetStructArrayNativeElement("Valuators", 0, outMat, retevent);
+        PsychHIDSetEventStructElement(0, &evt, retevent);
 
         return(navail - 1);
     }
@@ -450,12 +492,43 @@ int PsychHIDReturnEventFromEventBuffer(int deviceIndex, int outArgIndex, double
     }
 }
 
-PsychHIDEventRecord* PsychHIDLastTouchEventFromEventBuffer(int deviceIndex, int touchID)
+/* PsychHIDLastTouchEventFromEventBuffer()
+ *
+ * Find the most recent touch event for touch point 'touchID' of device 'deviceIndex', OR the
+ * bits 'setStatus' into its stored status, and copy the event into 'lastevt', unless that is
+ * NULL. All of this happens under the lock of the buffer, as other threads can overwrite or
+ * release the buffer as soon as it is unlocked. Returns TRUE if such an event exists.
+ */
+psych_bool PsychHIDLastTouchEventFromEventBuffer(int deviceIndex, int touchID, unsigned int setStatus, PsychHIDEventRecord* lastevt)
 {
     int nend, current;
+    unsigned int i, n;
     PsychHIDEventRecord *evt;
 
-    if (!hidEventBuffer[deviceIndex]) return(0);
+    // Events of members of the aggregate event buffer are stored there, so search it instead:
+    if (hidAggregateTypeMask[deviceIndex]) {
+        evt = NULL;
+        PsychLockMutex(&hidAggregateMutex);
+
+        n = (hidAggregateWritePos < hidAggregateCapacity) ? hidAggregateWritePos : hidAggregateCapacity;
+        for (i = 0; hidAggregateBuffer && (i < n); i++) {
+            current = (hidAggregateWritePos - 1 - i) % hidAggregateCapacity;
+            if ((hidAggregateSource[current] == deviceIndex) &&
+                (hidAggregateBuffer[current].type >= 2) &&
+                (hidAggregateBuffer[current].type <= 4) &&
+                (hidAggregateBuffer[current].rawEventCode == touchID)) {
+                evt = &(hidAggregateBuffer[current]);
+                evt->status |= setStatus;
+                if (lastevt) memcpy(lastevt, evt, sizeof(PsychHIDEventRecord));
+                break;
+            }
+        }
+
+        PsychUnlockMutex(&hidAggregateMutex);
+        return((evt) ? TRUE : FALSE);
+    }
+
+    if (!hidEventBuffer[deviceIndex]) return(FALSE);
 
     PsychLockMutex(&hidEventBufferMutex[deviceIndex]);
     nend = (hidEventBufferWritePos[deviceIndex] - 1) % hidEventBufferCapacity[deviceIndex];
@@ -471,14 +544,62 @@ PsychHIDEventRecord* PsychHIDLastTouchEventFromEventBuffer(int deviceIndex, int
         current = (current - 1) % hidEventBufferCapacity[deviceIndex];
     } while ((current != nend) && (current >= 0));
 
-    if (hidEventBuffer[deviceIndex][current].rawEventCode == touchID)
+    if (hidEventBuffer[deviceIndex][current].rawEventCode == touchID) {
         evt = &(hidEventBuffer[deviceIndex][current]);
+        evt->status |= setStatus;
+        if (lastevt) memcpy(lastevt, evt, sizeof(PsychHIDEventRecord));
+    }
     else
         evt = NULL;
 
     PsychUnlockMutex(&hidEventBufferMutex[deviceIndex]);
 
-    return (evt);
+    return((evt) ? TRUE : FALSE);
+}
+
+static int PsychHIDAddEventToAggregateBuffer(int deviceIndex, PsychHIDEventRecord* evt)
+{
+    unsigned int navail, pos, cur, prev;
+
+    PsychLockMutex(&hidAggregateMutex);
+
+    // Still a member, and this type of event accepted from this device?
+    if (!hidAggregateBuffer || (evt->type > 31) || !(hidAggregateTypeMask[deviceIndex] & (1 << evt->type))) {
+        PsychUnlockMutex(&hidAggregateMutex);
+        return(0);
+    }
+
+    navail = hidAggregateWritePos - hidAggregateReadPos;
+    if (navail < hidAggregateCapacity) {
+        // Events of different devices can arrive slightly out of order, e.g., if they come from different
+        // processing threads. Insert the new event behind all not yet fetched events with an earlier or
+        // equal timestamp, so the buffer is always ordered by time:
+        pos = hidAggregateWritePos;
+        while ((pos != hidAggregateReadPos) && (hidAggregateBuffer[(pos - 1) % hidAggregateCapacity].timestamp > evt->timestamp)) {
+            cur = pos % hidAggregateCapacity;
+            prev = (pos - 1) % hidAggregateCapacity;
+            memcpy(&(hidAggregateBuffer[cur]), &(hidAggregateBuffer[prev]), sizeof(PsychHIDEventRecord));
+            hidAggregateSource[cur] = hidAggregateSource[prev];
+            pos--;
+        }
+
+        memcpy(&(hidAggregateBuffer[pos % hidAggregateCapacity]), evt, sizeof(PsychHIDEventRecord));
+        hidAggregateSource[pos % hidAggregateCapacity] = deviceIndex;
+        hidAggregateWritePos++;
+
+        // Announce new event to potential waiters:
+        PsychSignalCondition(&hidAggregateCondition);
+    }
+    else {
+        // Only warn at the start of an overflow episode, and count the dropped events, to be reported when
+        // the events get fetched or the buffer gets released:
+        if (hidAggregateDropped++ == 0)
+            printf("PsychHID: WARNING: KbQueue aggregate event buffer is full! Maximum capacity of %i elements reached, will discard future events.\n", hidAggregateCapacity);
+    }
+
+    PsychUnlockMutex(&hidAggregateMutex);
+
+    return(navail);
 }
 
 int PsychHIDAddEventToEventBuffer(int deviceIndex, PsychHIDEventRecord* evt)
@@ -487,6 +608,10 @@ int PsychHIDAddEventToEventBuffer(int deviceIndex, PsychHIDEventRecord* evt)
 
     if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
 
+    // Device is a member of the aggregate event buffer? Then its events go there instead:
+    if (hidAggregateTypeMask[deviceIndex])
+        return(PsychHIDAddEventToAggregateBuffer(deviceIndex, evt));
+
     if (!hidEventBuffer[deviceIndex]) return 0;
 
     PsychLockMutex(&hidEventBufferMutex[deviceIndex]);
@@ -508,6 +633,134 @@ int PsychHIDAddEventToEventBuffer(int deviceIndex, PsychHIDEventRecord* evt)
     return navail - 1;
 }
 
+// Report and reset the count of events dropped due to an overflow of the aggregate event buffer.
+// Must be called with the hidAggregateMutex locked:
+static void PsychHIDReportAggregateDroppedEvents(void)
+{
+    if (hidAggregateDropped == 0) return;
+
+    printf("PsychHID: WARNING: %i events were discarded, because the KbQueue aggregate event buffer was full.\n", hidAggregateDropped);
+    hidAggregateDropped = 0;
+}
+
+/* PsychHIDCreateAggregateEventBuffer()
+ *
+ * Create aggregate event buffer with capacity 'numSlots' for the 'numDevices' devices in 'deviceIndices',
+ * accepting only events whose type t is set as bit (1 << t) in the corresponding 'typeMasks' element.
+ * Replaces any previous aggregate event buffer, discarding all its events. numDevices == 0 only releases
+ * the current aggregate event buffer. Returns FALSE on out of memory.
+ */
+psych_bool PsychHIDCreateAggregateEventBuffer(int numDevices, int* deviceIndices, unsigned int* typeMasks, int numSlots)
+{
+    PsychHIDEventRecord* buffer = NULL;
+    int* source = NULL;
+    int i;
+
+    if (numDevices > 0) {
+        buffer = (PsychHIDEventRecord*) calloc(sizeof(PsychHIDEventRecord), numSlots);
+        source = (int*) calloc(sizeof(int), numSlots);
+        if (!buffer || !source) {
+            free(buffer);
+            free(source);
+            return(FALSE);
+        }
+    }
+
+    PsychLockMutex(&hidAggregateMutex);
+
+    PsychHIDReportAggregateDroppedEvents();
+
+    free(hidAggregateBuffer);
+    free(hidAggregateSource);
+
+    for (i = 0; i < PSYCH_HID_MAX_DEVICES; i++)
+        hidAggregateTypeMask[i] = 0;
+
+    for (i = 0; i < numDevices; i++)
+        hidAggregateTypeMask[deviceIndices[i]] = typeMasks[i];
+
+    hidAggregateBuffer = buffer;
+    hidAggregateSource = source;
+    hidAggregateCapacity = (numDevices > 0) ? numSlots : 0;
+    hidAggregateReadPos = 0;
+    hidAggregateWritePos = 0;
+
+    PsychUnlockMutex(&hidAggregateMutex);
+
+    return(TRUE);
+}
+
+/* PsychHIDReturnEventsFromAggregateBuffer()
+ *
+ * Fetch up to 'maxEvents' oldest events from the aggregate event buffer, waiting up to 'maxWaitTimeSecs'
+ * for at least one event if none is available, and return them as struct array in 'outArgIndex'. Returns
+ * the number of events remaining in the buffer, or -1 if there isn't any aggregate event buffer.
+ */
+int PsychHIDReturnEventsFromAggregateBuffer(int outArgIndex, int maxEvents, double maxWaitTimeSecs)
+{
+    unsigned int navail, n, i;
+    PsychHIDEventRecord* evts;
+    int* sources;
+    PsychGenericScriptType *retevent;
+    double* foo = NULL;
+    const char *FieldNames[] = { "Type", "Time", "Pressed", "Keycode", "CookedKey", "ButtonStates", "Motion", "X", "Y", "NormX", "NormY", "Valuators", "Device" };
+
+    PsychLockMutex(&hidAggregateMutex);
+
+    if (!hidAggregateBuffer) {
+        PsychUnlockMutex(&hidAggregateMutex);
+        return(-1);
+    }
+
+    navail = hidAggregateWritePos - hidAggregateReadPos;
+
+    // If nothing available and we're asked to wait for something, then wait:
+    if ((navail == 0) && (maxWaitTimeSecs > 0)) {
+        PsychTimedWaitCondition(&hidAggregateCondition, &hidAggregateMutex, maxWaitTimeSecs);
+        navail = hidAggregateWritePos - hidAggregateReadPos;
+    }
+
+    n = (navail < (unsigned int) maxEvents) ? navail : (unsigned int) maxEvents;
+
+    // Copy out the n oldest events, so we can build the return struct array without holding the lock:
+    evts = (n > 0) ? (PsychHIDEventRecord*) malloc(n * sizeof(PsychHIDEventRecord)) : NULL;
+    sources = (n > 0) ? (int*) malloc(n * sizeof(int)) : NULL;
+    if ((n > 0) && (!evts || !sources)) {
+        PsychUnlockMutex(&hidAggregateMutex);
+        free(evts);
+        free(sources);
+        PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while fetching events from KbQueue aggregate event buffer.");
+    }
+
+    for (i = 0; i < n; i++) {
+        memcpy(&evts[i], &(hidAggregateBuffer[(hidAggregateReadPos + i) % hidAggregateCapacity]), sizeof(PsychHIDEventRecord));
+        sources[i] = hidAggregateSource[(hidAggregateReadPos + i) % hidAggregateCapacity];
+    }
+
+    hidAggregateReadPos += n;
+
+    PsychHIDReportAggregateDroppedEvents();
+
+    PsychUnlockMutex(&hidAggregateMutex);
+
+    if (n > 0) {
+        PsychAllocOutStructArray(outArgIndex, kPsychArgOptional, (int) n, 13, FieldNames, &retevent);
+        for (i = 0; i < n; i++) {
+            PsychHIDSetEventStructElement((int) i, &evts[i], retevent);
+            PsychSetStructArrayDoubleElement("Device", (int) i, (double) sources[i], retevent);
+        }
+    }
+    else {
+        // Return empty matrix:
+        PsychCopyOutDoubleMatArg(outArgIndex, kPsychArgOptional, 0, 0, 0, foo);
+    }
+
+    free(evts);
+    free(sources);
+
+    return((int) (navail - n));
+}
+
 // Platform specific code starts here:
 // ===================================
 
@@ -9,11 +9,13 @@
 
   Allen.Ingling@nyu.edu             awi
   mario.kleiner.de@gmail.com        mk
+  agent@local                       ag
 
   HISTORY:
   5/12/03  awi      Created.
   12/17/09 rpw      Added keypad support
   07/28/11 mk       Refactored for multi-os support.
+  10/19/26 ag       Document KbCheck answered from running keyboard queues on Linux.
 
   TO DO:
 
@@ -33,6 +35,8 @@ static char synopsisString[] =
         "the 256 keys by providing the optional 'scanList' parameter: 'scanList' must be a vector of 256 "
         "doubles, where the i'th element corresponds to the i'th key and a zero value means: Ignore this "
         "key during scan, whereas a positive non-zero value means: Scan this key.\n"
+        "On Linux, if a keyboard queue is running for the specified 'deviceNumber', the key state is taken "
+        "from the state maintained by the queue, which is much faster than querying the X-Server.\n"
         "The PsychHID('KbCheck') implements the KbCheck command as provided by the  OS 9 Psychtoolbox. "
         "KbCheck is defined in Psychtoolbox-3 and invokes PsychHID('KbCheck'). "
         "Always use KbCheck instead of directly calling PsychHID('KbCheck'), unless you have very good "
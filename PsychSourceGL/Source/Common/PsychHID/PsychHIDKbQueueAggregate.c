@@ -0,0 +1,139 @@
+/*
+    PsychtoolboxGL/Source/Common/PsychHID/PsychHIDKbQueueAggregate.c
+
+    PROJECTS:
+
+        PsychHID only.
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent@local                     ag
+
+    HISTORY:
+        10/19/26 ag         Created.
+
+*/
+
+#include "PsychHID.h"
+
+PsychError PSYCHHIDKbQueueAggregate(void)
+{
+    static char useString[] = "PsychHID('KbQueueAggregate', deviceIndices [, numSlots=10000][, typeMasks])";
+    //                                                      1                2                   3
+    static char synopsisString[] =
+        "Merge the events of the keyboard queues of multiple input devices into one aggregate event buffer.\n"
+        "This is useful for experiments with multiple participants or response devices, to fetch the events of "
+        "all devices with one call of PsychHID('KbQueueAggregateGetEvents'), in the order in which they happened.\n"
+        "'deviceIndices' is a vector with the indices of all devices whose events should go into the aggregate "
+        "event buffer. An empty vector releases the aggregate event buffer, so events go to the event buffers "
+        "of the individual keyboard queues again. Each call replaces the current aggregate event buffer, "
+        "discarding all events not yet fetched from it.\n"
+        "'numSlots' is the maximum capacity of the aggregate event buffer, defaulting to 10000 events.\n"
+        "'typeMasks' is an optional vector with one element per device in 'deviceIndices', defining which types of "
+        "events of that device are accepted. Events of 'Type' t, as explained in 'help KbQueueGetEvent', are accepted "
+        "if bit 2^t is set in the mask of their device. By default, all events are accepted. E.g., a mask of 1 only "
+        "accepts key and button presses and releases.\n"
+        "The keyboard queues of the devices still need to be created and started via PsychHID('KbQueueCreate') and "
+        "PsychHID('KbQueueStart'). Their 'keyFlags' settings select the keys and buttons reported by each device. "
+        "While a device is a member of the aggregate event buffer, its events are only available via "
+        "PsychHID('KbQueueAggregateGetEvents'), not via PsychHID('KbQueueGetEvent'), CharAvail, GetChar et al. "
+        "for that device. PsychHID('KbQueueCheck') is not affected.\n";
+    static char seeAlsoString[] = "KbQueueAggregateGetEvents, KbQueueCreate, KbQueueStart, KbQueueGetEvent";
+
+    int i, j, numDevices, numMasks, numSlots;
+    int *deviceIndices = NULL;
+    int *masks = NULL;
+    unsigned int typeMasks[PSYCH_HID_MAX_DEVICES];
+
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none);};
+
+    PsychErrorExit(PsychCapNumOutputArgs(0));
+    PsychErrorExit(PsychCapNumInputArgs(3));
+
+    numDevices = 0;
+    PsychAllocInIntegerListArg(1, kPsychArgRequired, &numDevices, &deviceIndices);
+    if (numDevices > PSYCH_HID_MAX_DEVICES)
+        PsychErrorExitMsg(PsychError_user, "Too many 'deviceIndices' provided.");
+
+    numSlots = 10000;
+    PsychCopyInIntegerArg(2, kPsychArgOptional, &numSlots);
+    if (numSlots < 1)
+        PsychErrorExitMsg(PsychError_user, "Invalid number of 'numSlots' provided. Must be at least 1.");
+
+    numMasks = 0;
+    if (PsychAllocInIntegerListArg(3, kPsychArgOptional, &numMasks, &masks) && (numMasks != numDevices))
+        PsychErrorExitMsg(PsychError_user, "'typeMasks' must have one element for each element of 'deviceIndices'.");
+
+    for (i = 0; i < numDevices; i++) {
+        // Map default device, just as the other KbQueue functions:
+        if (deviceIndices[i] < 0) deviceIndices[i] = PsychHIDGetDefaultKbQueueDevice();
+
+        if (deviceIndices[i] >= PSYCH_HID_MAX_DEVICES)
+            PsychErrorExitMsg(PsychError_user, "Invalid device index in 'deviceIndices'. No such device!");
+
+        for (j = 0; j < i; j++)
+            if (deviceIndices[j] == deviceIndices[i])
+                PsychErrorExitMsg(PsychError_user, "Duplicate device index in 'deviceIndices'.");
+
+        typeMasks[i] = (masks) ? (unsigned int) masks[i] : 0xffffffff;
+        if (typeMasks[i] == 0)
+            PsychErrorExitMsg(PsychError_user, "Invalid zero element in 'typeMasks'. Each device must accept at least one type of events.");
+    }
+
+    if (!PsychHIDCreateAggregateEventBuffer(numDevices, deviceIndices, typeMasks, numSlots))
+        PsychErrorExitMsg(PsychError_outofMemory, "Failed to create aggregate event buffer due to out of memory condition.");
+
+    return(PsychError_none);
+}
+
+PsychError PSYCHHIDKbQueueAggregateGetEvents(void)
+{
+    static char useString[] = "[events, navail] = PsychHID('KbQueueAggregateGetEvents' [, maxEvents=inf][, maxWaitTimeSecs=0])";
+    //                          1       2                                               1                 2
+    static char synopsisString[] =
+        "Fetch events from the aggregate event buffer, set up via PsychHID('KbQueueAggregate').\n"
+        "Returns up to 'maxEvents' of the oldest events in the buffer, by default all, as struct array 'events', "
+        "ordered by their 'Time', or an empty matrix if there aren't any events.\n"
+        "'maxWaitTimeSecs' is an optional maximum wait time for a new event in seconds, if no event is available. "
+        "It defaults to zero, which means to just poll for pending events.\n"
+        "The number of events remaining in the buffer after fetching is returned in 'navail'.\n"
+        "Each element of 'events' has the same fields as the 'event' struct returned by PsychHID('KbQueueGetEvent'), "
+        "see 'help KbQueueGetEvent', and an additional field 'Device' with the device index of the device which "
+        "generated the event. Events of different devices are merged in order of their 'Time', as long as they "
+        "arrive before any later event got fetched.\n";
+    static char seeAlsoString[] = "KbQueueAggregate, KbQueueGetEvent";
+
+    double maxEvents, maxWaitTimeSecs;
+    int navail;
+
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none);};
+
+    PsychErrorExit(PsychCapNumOutputArgs(2));
+    PsychErrorExit(PsychCapNumInputArgs(2));
+
+    maxEvents = INT_MAX;
+    PsychCopyInDoubleArg(1, kPsychArgOptional, &maxEvents);
+    if (maxEvents < 0)
+        PsychErrorExitMsg(PsychError_user, "Invalid 'maxEvents' provided. Must be at least 0.");
+
+    if (maxEvents > INT_MAX)
+        maxEvents = INT_MAX;
+
+    maxWaitTimeSecs = 0;
+    PsychCopyInDoubleArg(2, kPsychArgOptional, &maxWaitTimeSecs);
+
+    // Get up to maxEvents events from aggregate buffer, return them as 1st return argument:
+    navail = PsychHIDReturnEventsFromAggregateBuffer(1, (int) maxEvents, maxWaitTimeSecs);
+    if (navail < 0)
+        PsychErrorExitMsg(PsychError_user, "There isn't any aggregate event buffer. Call PsychHID('KbQueueAggregate') first.");
+
+    PsychCopyOutDoubleArg(2, kPsychArgOptional, (double) navail);
+
+    return(PsychError_none);
+}
@@ -13,12 +13,14 @@
  *
  *                rwoods@ucla.edu               rpw
  *                mario.kleiner.de@gmail.com    mk
+ *                agent@local                   ag
  *
  *        HISTORY:
  *
  *                8/19/07  rpw        Created.
  *                8/23/07  rpw        Added PsychHIDQueueFlush to documentation
  *                12/17/09 rpw        Added support for keypads
+ *                10/19/26 ag         Added flag +8 for the Linux evdev input backend.
  *
  *        NOTES:
  *
@@ -103,6 +105,17 @@ static char synopsisString[] =
 "     Linux and Windows only.\n"
 "     For mouse and touchpad devices, this usually reports relative motion, ie.\n"
 "     movement deltas, instead of absolute position values.\n"
+"+8 = Use the kernel evdev input backend instead of X11 XInput. Linux only.\n"
+"     Events are read directly from the /dev/input/event* device node of the input\n"
+"     device, and timestamped by the kernel, without X-Server scheduling latency.\n"
+"     This needs read access to the device node, e.g., by membership in the 'input'\n"
+"     group. Keys are reported with the same key codes as without this flag, but key\n"
+"     presses don't have a cooked character code, so GetChar() et al. won't work.\n"
+"     Valuators are indexed by evdev axis code, e.g., 0 = x-axis, 1 = y-axis. Multi-\n"
+"     touch is not supported. The environment variable PSYCHHID_EVDEV_NODE_i can\n"
+"     assign a different device node to the queue for deviceNumber i. If it names a\n"
+"     regular file, e.g., a recording made via 'cat /dev/input/eventX > file', then\n"
+"     the recorded events are replayed with their original timing from KbQueueStart.\n"
 "\n\n"
 "'windowHandle' Optional windowing system specific handle for an associated onscreen window.\n"
 "\n";
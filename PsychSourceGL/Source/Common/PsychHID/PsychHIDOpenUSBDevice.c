@@ -29,7 +29,13 @@ static char synopsisString[] =  "Tries to open and initialize a generic USB devi
                                 "possible if the device isn't in use already, and not under control of an operating "
                                 "system device driver. A value of -1 would skip changing the configuration.\n"
                                 "A call with supported = PsychHID('OpenUSBDevice', -1, -1); returns USB low-level "
-                                "support status: 1 = Supported, 0 = Not supported, e.g., due to missing libusb-1 library.\n";
+                                "support status: 1 = Supported, 0 = Not supported, e.g., due to missing libusb-1 library.\n"
+                                "For testing only: If the environment variable PSYCHHID_SIMULATED_USB_REPORTRATE is set to a "
+                                "number of reports per second, then a call with 'vendorID' and 'deviceID' both zero opens a "
+                                "simulated device instead, whose in-endpoints can be streamed via PsychHID('USBStartStreaming') "
+                                "without any USB hardware. Report n of a stream carries n as little-endian 32 bit integer in its "
+                                "first bytes, followed by bytes with the value of their index, and every odd report is only half "
+                                "as long as the requested report size.\n";
 static char seeAlsoString[] =   "CloseUSBDevice USBControlTransfer USBBulkTransfer USBInterruptTransfer";
 
 PsychError PSYCHHIDOpenUSBDevice(void) 
@@ -62,6 +68,12 @@ PsychError PSYCHHIDOpenUSBDevice(void)
     // Try to get free slot in internal device bank: This will error-exit if no capacity left.
     usbDev = PsychHIDGetFreeUSBDeviceSlot(&usbHandle);
 
+    // Simulated device for testing requested?
+    if ((vendorID == 0) && (deviceID == 0) && PsychHIDUSBOpenSimulatedDevice(usbDev)) {
+        PsychCopyOutDoubleArg(1, FALSE, (double) usbHandle);
+        return(PsychError_none);
+    }
+
     // Setup specification of wanted device:
     // So far we only match against vendorID and deviceID, but may want to extend this
     // to more options in the future. That's why its passed via a PsychUSBSetupSpec struct.
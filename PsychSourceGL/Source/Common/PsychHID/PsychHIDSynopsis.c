@@ -58,6 +58,14 @@ const char** InitializeSynopsis(void)
     synopsis[i++] = "[keyIsDown, firstKeyPressTimes, firstKeyReleaseTimes, lastKeyPressTimes, lastKeyReleaseTimes]=PsychHID('KbQueueCheck' [, deviceIndex])";
     synopsis[i++] = "secs=PsychHID('KbTriggerWait', KeysUsage, [deviceNumber])";
     synopsis[i++] = "[event, navail] = PsychHID('KbQueueGetEvent' [, deviceIndex][, maxWaitTimeSecs=0])";
+    synopsis[i++] = "PsychHID('KbQueueAggregate', deviceIndices [, numSlots=10000][, typeMasks])";
+    synopsis[i++] = "[events, navail] = PsychHID('KbQueueAggregateGetEvents' [, maxEvents=inf][, maxWaitTimeSecs=0])";
+
+    synopsis[i++] = "\n\nContinuous sampling of game controllers:\n\n";
+    synopsis[i++] = "[numAxes, numHats, numButtons, axisRanges] = PsychHID('GamePadSamplerStart', deviceIndex [, samplingRate=500][, numSlots=10000])";
+    synopsis[i++] = "PsychHID('GamePadSamplerStop', deviceIndex)";
+    synopsis[i++] = "[state, timestamp] = PsychHID('GamePadSamplerGetState', deviceIndex)";
+    synopsis[i++] = "[samples, navail, lostCount] = PsychHID('GamePadSamplerGetHistory', deviceIndex [, maxSamples=inf])";
 
     synopsis[i++] = "\n\nSupport for access to generic USB devices: See 'help ColorCal2' for one usage example:\n\n";
     synopsis[i++] = "usbHandle = PsychHID('OpenUSBDevice', vendorID, deviceID [, configurationId=0])";
@@ -66,6 +74,9 @@ const char** InitializeSynopsis(void)
     synopsis[i++] = "[recData, count] = PsychHID('USBControlTransfer', usbHandle, bmRequestType, bRequest, wValue, wIndex, wLength [, outData][, timeOutMSecs=10000])";
     synopsis[i++] = "[countOrRecData] = PsychHID('USBBulkTransfer', usbHandle, endPoint, length [, outData][, timeOutMSecs=10000])";
     synopsis[i++] = "[countOrRecData] = PsychHID('USBInterruptTransfer', usbHandle, endPoint, length [, outData][, timeOutMSecs=10000])";
+    synopsis[i++] = "PsychHID('USBStartStreaming', usbHandle, endPoint, reportSize [, transferType=0][, numTransfers=4][, numSlots=10000][, timeOutMSecs=0])";
+    synopsis[i++] = "PsychHID('USBStopStreaming', usbHandle)";
+    synopsis[i++] = "[reports, timestamps, lengths, navail, lostCount] = PsychHID('USBGetStreamedReports', usbHandle [, maxReports=inf][, maxWaitTimeSecs=0])";
 
     synopsis[i++] = NULL;  // this tells PsychDisplayPsychHIDSynopsis where to stop
     if (i > MAX_SYNOPSIS_STRINGS) {
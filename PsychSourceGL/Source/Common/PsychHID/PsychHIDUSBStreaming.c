@@ -0,0 +1,481 @@
+/*
+ * PsychSourceGL/Source/Common/PsychHID/PsychHIDUSBStreaming.c
+ *
+ * PROJECTS: PsychHID
+ *
+ * PLATFORMS:   All.
+ *
+ * AUTHORS:
+ *
+ * agent@local                  ag
+ *
+ * HISTORY:
+ *
+ * 19.10.2026   Created.
+ *
+ * DESCRIPTION:
+ *
+ * Streaming reception of reports from an interrupt or bulk in-endpoint of a generic USB device.
+ * The OS specific transport keeps multiple transfers in flight, timestamps each completed
+ * transfer and appends its payload via PsychHIDUSBStreamAddReport() to a preallocated ringbuffer,
+ * from which 'USBGetStreamedReports' fetches all pending reports at once.
+ *
+ * For testing, a simulated device without USB transport can be opened, whose simulated transfers
+ * feed the ringbuffer directly, see PsychHIDUSBOpenSimulatedDevice().
+ */
+
+#include "PsychHID.h"
+
+// Transport state of a streaming simulated device, referenced by PsychUSBStreamRecord->os:
+typedef struct PsychUSBStreamSimTransport {
+    psych_thread        thread;         // Thread which completes the simulated transfers.
+    psych_condition     wakeup;         // Signalled to stop the thread early.
+    double              interval;       // Time between two completions in seconds.
+    int                 inFlight;       // Number of submitted simulated transfers, protected by stream->mutex.
+    unsigned int        sequence;       // Sequence number of next report.
+} PsychUSBStreamSimTransport;
+
+/* PsychHIDUSBOpenSimulatedDevice()
+ *
+ * Open a test-only simulated device in device record 'devRecord', if the environment variable
+ * PSYCHHID_SIMULATED_USB_REPORTRATE is set to the rate of reports per second to simulate.
+ * Returns TRUE on success, FALSE if simulation is not enabled.
+ */
+psych_bool PsychHIDUSBOpenSimulatedDevice(PsychUSBDeviceRecord* devRecord)
+{
+    double rate;
+
+    if (!getenv("PSYCHHID_SIMULATED_USB_REPORTRATE") || ((rate = atof(getenv("PSYCHHID_SIMULATED_USB_REPORTRATE"))) <= 0))
+        return(FALSE);
+
+    devRecord->device = NULL;
+    devRecord->stream = NULL;
+    devRecord->firstClaimedInterface = 0;
+    devRecord->simulatedReportRate = rate;
+    devRecord->valid = 1;
+
+    return(TRUE);
+}
+
+/* PsychHIDUSBCloseDevice()
+ *
+ * Close a generic USB device, or a simulated device, and mark its device record as free.
+ */
+void PsychHIDUSBCloseDevice(PsychUSBDeviceRecord* devRecord)
+{
+    if (devRecord->simulatedReportRate > 0) {
+        PsychHIDUSBStreamRelease(devRecord);
+        devRecord->simulatedReportRate = 0;
+        devRecord->valid = 0;
+        return;
+    }
+
+    PsychHIDOSCloseUSBDevice(devRecord);
+}
+
+// Thread of a simulated device: Completes one of the simulated transfers in flight every
+// interval, feeds its report into the ringbuffer and resubmits it, until streaming stops:
+static void* PsychHIDUSBStreamSimThreadMain(void* arg)
+{
+    PsychUSBStreamRecord* stream = (PsychUSBStreamRecord*) arg;
+    PsychUSBStreamSimTransport* transport = (PsychUSBStreamSimTransport*) stream->os;
+    psych_uint8* report;
+    double tnow, tnext;
+    int i, length;
+
+    PsychSetThreadName("PsychHIDUSBSim");
+
+    report = (psych_uint8*) malloc(stream->reportSize);
+    PsychGetAdjustedPrecisionTimerSeconds(&tnext);
+    tnext += transport->interval;
+
+    PsychLockMutex(&stream->mutex);
+
+    while (transport->inFlight > 0) {
+        // Stopped? Then all transfers in flight get cancelled and retire without data:
+        if (!stream->running || !report) {
+            transport->inFlight = 0;
+            break;
+        }
+
+        PsychGetAdjustedPrecisionTimerSeconds(&tnow);
+        if (tnow < tnext) {
+            PsychTimedWaitCondition(&transport->wakeup, &stream->mutex, tnext - tnow);
+            continue;
+        }
+
+        PsychUnlockMutex(&stream->mutex);
+
+        // Completion: Report carries its sequence number, every odd report is a short one:
+        length = (transport->sequence & 1) ? (stream->reportSize + 1) / 2 : stream->reportSize;
+        for (i = 0; i < stream->reportSize; i++)
+            report[i] = (i < 4) ? (psych_uint8) (transport->sequence >> (8 * i)) : (psych_uint8) i;
+
+        transport->sequence++;
+        tnext += transport->interval;
+
+        PsychHIDUSBStreamAddReport(stream, report, length, tnow);
+
+        // Resubmit, unless streaming got stopped in the meantime:
+        PsychLockMutex(&stream->mutex);
+        if (!stream->running)
+            transport->inFlight--;
+    }
+
+    PsychUnlockMutex(&stream->mutex);
+
+    free(report);
+
+    return(NULL);
+}
+
+// Start streaming on 'devRecord' via its real or simulated transport. Returns 0 on success, a negative error code otherwise:
+static int PsychHIDUSBStreamStartTransport(PsychUSBDeviceRecord* devRecord)
+{
+    PsychUSBStreamRecord* stream = devRecord->stream;
+    PsychUSBStreamSimTransport* transport;
+
+    if (devRecord->simulatedReportRate <= 0)
+        return(PsychHIDOSStartStreaming(devRecord));
+
+    transport = (PsychUSBStreamSimTransport*) calloc(1, sizeof(PsychUSBStreamSimTransport));
+    if (!transport)
+        return(-1);
+
+    PsychInitCondition(&transport->wakeup, NULL);
+    transport->interval = 1.0 / devRecord->simulatedReportRate;
+    transport->inFlight = stream->numTransfers;
+    stream->os = (void*) transport;
+
+    if (PsychCreateThread(&transport->thread, NULL, PsychHIDUSBStreamSimThreadMain, (void*) stream)) {
+        PsychDestroyCondition(&transport->wakeup);
+        free(transport);
+        stream->os = NULL;
+        return(-1);
+    }
+
+    return(0);
+}
+
+// Stop streaming on 'devRecord' via its real or simulated transport:
+static void PsychHIDUSBStreamStopTransport(PsychUSBDeviceRecord* devRecord)
+{
+    PsychUSBStreamRecord* stream = devRecord->stream;
+    PsychUSBStreamSimTransport* transport = (PsychUSBStreamSimTransport*) stream->os;
+
+    if (devRecord->simulatedReportRate <= 0) {
+        PsychHIDOSStopStreaming(devRecord);
+        return;
+    }
+
+    if (transport == NULL)
+        return;
+
+    // Prevent resubmission and wake the thread, so it cancels all transfers still in flight and exits:
+    PsychLockMutex(&stream->mutex);
+    stream->running = 0;
+    PsychSignalCondition(&transport->wakeup);
+    PsychUnlockMutex(&stream->mutex);
+
+    PsychDeleteThread(&transport->thread);
+    PsychDestroyCondition(&transport->wakeup);
+    free(transport);
+    stream->os = NULL;
+}
+
+/* PsychHIDUSBStreamAddReport()
+ *
+ * Append a received report of 'length' bytes with completion time 'timestamp' to the
+ * report ringbuffer of 'stream'. Called by the OS specific transport, possibly from a
+ * background thread. Discards the report and counts it as lost if the buffer is full.
+ */
+void PsychHIDUSBStreamAddReport(PsychUSBStreamRecord* stream, const psych_uint8* data, int length, double timestamp)
+{
+    psych_uint8* slot;
+    unsigned int pos;
+
+    if (length > stream->reportSize)
+        length = stream->reportSize;
+
+    PsychLockMutex(&stream->mutex);
+
+    if (stream->writePos - stream->readPos < stream->capacity) {
+        pos = stream->writePos % stream->capacity;
+        slot = &(stream->data[(size_t) pos * stream->reportSize]);
+
+        // Store payload, zero-padded to full report size, so the returned matrix is well defined:
+        memcpy(slot, data, length);
+        if (length < stream->reportSize)
+            memset(slot + length, 0, stream->reportSize - length);
+
+        stream->timestamps[pos] = timestamp;
+        stream->lengths[pos] = length;
+        stream->writePos++;
+
+        // Announce new report to potential waiters:
+        PsychSignalCondition(&stream->condition);
+    }
+    else {
+        stream->lostCount++;
+    }
+
+    PsychUnlockMutex(&stream->mutex);
+}
+
+/* PsychHIDUSBStreamRelease()
+ *
+ * Stop streaming on 'devRecord', if active, and release its report ringbuffer.
+ */
+void PsychHIDUSBStreamRelease(PsychUSBDeviceRecord* devRecord)
+{
+    PsychUSBStreamRecord* stream = devRecord->stream;
+
+    if (stream == NULL)
+        return;
+
+    PsychHIDUSBStreamStopTransport(devRecord);
+    devRecord->stream = NULL;
+
+    PsychDestroyMutex(&stream->mutex);
+    PsychDestroyCondition(&stream->condition);
+    free(stream->data);
+    free(stream->timestamps);
+    free(stream->lengths);
+    free(stream);
+}
+
+PsychError PSYCHHIDUSBStartStreaming(void)
+{
+    static char useString[] = "PsychHID('USBStartStreaming', usbHandle, endPoint, reportSize [, transferType=0][, numTransfers=4][, numSlots=10000][, timeOutMSecs=0])";
+    //                                                       1          2         3             4                   5                   6                  7
+    static char synopsisString[] =  "Start streaming reception of reports from an in-endpoint of a generic USB device.\n"
+                                    "Instead of one synchronous transfer per call of PsychHID('USBInterruptTransfer') or "
+                                    "PsychHID('USBBulkTransfer'), multiple transfers are kept in flight in the background. "
+                                    "Each completed transfer is timestamped with the GetSecs() time of its completion, its "
+                                    "payload is stored in a preallocated buffer, and the transfer is immediately resubmitted. "
+                                    "This allows to receive reports at the full rate of the device without gaps between transfers. "
+                                    "Use PsychHID('USBGetStreamedReports') to fetch all buffered reports at once.\n"
+                                    "The function will automatically claim interface #0 to enable the transfers, unless "
+                                    "you call PsychHID('USBClaimInterface', usbHandle, interfaceId) first to claim a "
+                                    "different interface 'interfaceId' for accessing the wanted endPoint.\n"
+                                    "'usbHandle' is the handle of the USB device to stream from.\n"
+                                    "'endPoint' is the USB end-point address. Its bit 7 must be set, as only in-endpoints can be streamed.\n"
+                                    "'reportSize' is the maximum size of a single report, ie. the length of each transfer, in bytes.\n"
+                                    "'transferType' selects interrupt transfers if 0 (the default), or bulk transfers if 1.\n"
+                                    "'numTransfers' is the number of transfers to keep in flight, between 1 and 32, 4 by default.\n"
+                                    "'numSlots' is the capacity of the buffer in reports, 10000 by default. If the buffer is full, "
+                                    "newly received reports are discarded and counted as lost.\n"
+                                    "'timeOutMSecs' is an optional timeout for the individual transfers, in milliseconds. Default is "
+                                    "zero, which means to never time out. Timed out transfers are resubmitted.\n"
+                                    "Calling this function again after PsychHID('USBStopStreaming') discards all not yet fetched reports. "
+                                    "Closing the device stops streaming and releases the buffer.\n";
+    static char seeAlsoString[] =   "USBStopStreaming USBGetStreamedReports USBInterruptTransfer USBBulkTransfer USBClaimInterface";
+
+    PsychUSBDeviceRecord *dev;
+    PsychUSBStreamRecord *stream;
+    int usbHandle, endPoint, reportSize;
+    int transferType = 0;
+    int numTransfers = 4;
+    int numSlots = 10000;
+    int timeOutMSecs = 0;
+
+    // Setup the help features.
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return PsychError_none; }
+
+    // Make sure the correct number of input arguments is supplied:
+    PsychErrorExit(PsychRequireNumInputArgs(3));
+    PsychErrorExit(PsychCapNumInputArgs(7));
+    PsychErrorExit(PsychCapNumOutputArgs(0));
+
+    PsychCopyInIntegerArg(1, TRUE, &usbHandle);
+    PsychCopyInIntegerArg(2, TRUE, &endPoint);
+    PsychCopyInIntegerArg(3, TRUE, &reportSize);
+
+    // Get 'dev'icerecord for handle: This will error-out if no such device open:
+    dev = PsychHIDGetUSBDevice(usbHandle);
+
+    if (!(endPoint & 0x80) || (endPoint < 0) || (endPoint > 255))
+        PsychErrorExitMsg(PsychError_user, "Argument endPoint must be an in-endpoint address, ie. with bit 7 set!");
+
+    if ((reportSize <= 0) || (reportSize > 65536))
+        PsychErrorExitMsg(PsychError_user, "Argument reportSize must be between 1 and 65536 bytes!");
+
+    if (PsychCopyInIntegerArg(4, FALSE, &transferType) && (transferType != 0) && (transferType != 1))
+        PsychErrorExitMsg(PsychError_user, "Argument transferType must be 0 for interrupt transfers, or 1 for bulk transfers!");
+
+    if (PsychCopyInIntegerArg(5, FALSE, &numTransfers) && ((numTransfers < 1) || (numTransfers > 32)))
+        PsychErrorExitMsg(PsychError_user, "Argument numTransfers must be between 1 and 32!");
+
+    if (PsychCopyInIntegerArg(6, FALSE, &numSlots) && (numSlots < 1))
+        PsychErrorExitMsg(PsychError_user, "Argument numSlots must be at least 1!");
+
+    if (PsychCopyInIntegerArg(7, FALSE, &timeOutMSecs) && (timeOutMSecs < 0))
+        PsychErrorExitMsg(PsychError_user, "Argument timeOutMSecs is negative, but must be at least 0 milliseconds!");
+
+    if (dev->stream && dev->stream->os && dev->stream->running)
+        PsychErrorExitMsg(PsychError_user, "Streaming is already active on this USB device! Stop it first via PsychHID('USBStopStreaming').");
+
+    // Stop a previous streaming session aborted by a transfer error, and release its ringbuffer, if any:
+    PsychHIDUSBStreamRelease(dev);
+
+    // Allocate and setup new ringbuffer:
+    stream = (PsychUSBStreamRecord*) calloc(1, sizeof(PsychUSBStreamRecord));
+    if (stream) {
+        stream->data = (psych_uint8*) malloc((size_t) numSlots * reportSize);
+        stream->timestamps = (double*) calloc(numSlots, sizeof(double));
+        stream->lengths = (int*) calloc(numSlots, sizeof(int));
+    }
+
+    if (!stream || !stream->data || !stream->timestamps || !stream->lengths) {
+        if (stream) {
+            free(stream->data);
+            free(stream->timestamps);
+            free(stream->lengths);
+            free(stream);
+        }
+        PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while allocating USB report streaming buffer.");
+    }
+
+    PsychInitMutex(&stream->mutex);
+    PsychInitCondition(&stream->condition, NULL);
+    stream->capacity = (unsigned int) numSlots;
+    stream->reportSize = reportSize;
+    stream->endPoint = endPoint;
+    stream->transferType = transferType;
+    stream->numTransfers = numTransfers;
+    stream->timeOutMSecs = (unsigned int) timeOutMSecs;
+    stream->running = 1;
+    dev->stream = stream;
+
+    // Start the transfers:
+    if (PsychHIDUSBStreamStartTransport(dev) < 0) {
+        PsychHIDUSBStreamRelease(dev);
+        PsychErrorExitMsg(PsychError_system, "Starting USB report streaming failed.");
+    }
+
+    return(PsychError_none);
+}
+
+PsychError PSYCHHIDUSBStopStreaming(void)
+{
+    static char useString[] = "PsychHID('USBStopStreaming', usbHandle)";
+    //                                                      1
+    static char synopsisString[] =  "Stop streaming reception of reports from a generic USB device.\n"
+                                    "Cancels all transfers in flight and waits for their completion. Reports received so far stay "
+                                    "buffered and can still be fetched via PsychHID('USBGetStreamedReports').\n"
+                                    "'usbHandle' is the handle of the USB device to stop streaming on.\n";
+    static char seeAlsoString[] =   "USBStartStreaming USBGetStreamedReports";
+
+    PsychUSBDeviceRecord *dev;
+    int usbHandle;
+
+    // Setup the help features.
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return PsychError_none; }
+
+    // Make sure the correct number of input arguments is supplied:
+    PsychErrorExit(PsychRequireNumInputArgs(1));
+    PsychErrorExit(PsychCapNumInputArgs(1));
+    PsychErrorExit(PsychCapNumOutputArgs(0));
+
+    PsychCopyInIntegerArg(1, TRUE, &usbHandle);
+
+    // Get 'dev'icerecord for handle: This will error-out if no such device open:
+    dev = PsychHIDGetUSBDevice(usbHandle);
+
+    if (dev->stream)
+        PsychHIDUSBStreamStopTransport(dev);
+
+    return(PsychError_none);
+}
+
+PsychError PSYCHHIDUSBGetStreamedReports(void)
+{
+    static char useString[] = "[reports, timestamps, lengths, navail, lostCount] = PsychHID('USBGetStreamedReports', usbHandle [, maxReports=inf][, maxWaitTimeSecs=0])";
+    //                          1        2           3        4       5                                               1            2                  3
+    static char synopsisString[] =  "Fetch reports received by streaming from a generic USB device.\n"
+                                    "Returns up to 'maxReports' of the oldest buffered reports in one call, all of them by default. "
+                                    "If no report is buffered, waits up to 'maxWaitTimeSecs' seconds for one to arrive, by default "
+                                    "it doesn't wait.\n"
+                                    "'reports' is a uint8() matrix with one column per report, and as many rows as the 'reportSize' "
+                                    "specified in PsychHID('USBStartStreaming'). Reports shorter than 'reportSize' are padded with zeros.\n"
+                                    "'timestamps' is a row vector with the GetSecs() completion time of each report.\n"
+                                    "'lengths' is a row vector with the number of actually received bytes of each report.\n"
+                                    "'navail' is the number of reports which remain buffered after this call.\n"
+                                    "'lostCount' is the number of reports discarded since the last call, because the buffer was full.\n";
+    static char seeAlsoString[] =   "USBStartStreaming USBStopStreaming";
+
+    PsychUSBDeviceRecord *dev;
+    PsychUSBStreamRecord *stream;
+    psych_uint8 *reports;
+    double *timestamps, *lengths;
+    double maxWaitTimeSecs = 0;
+    double maxReports = INT_MAX;
+    unsigned int navail, n, i, pos, lost;
+    int usbHandle;
+
+    // Setup the help features.
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return PsychError_none; }
+
+    // Make sure the correct number of input arguments is supplied:
+    PsychErrorExit(PsychRequireNumInputArgs(1));
+    PsychErrorExit(PsychCapNumInputArgs(3));
+    PsychErrorExit(PsychCapNumOutputArgs(5));
+
+    PsychCopyInIntegerArg(1, TRUE, &usbHandle);
+
+    if (PsychCopyInDoubleArg(2, FALSE, &maxReports) && (maxReports < 0))
+        PsychErrorExitMsg(PsychError_user, "Argument maxReports must be at least zero!");
+
+    if (maxReports > INT_MAX)
+        maxReports = INT_MAX;
+
+    PsychCopyInDoubleArg(3, FALSE, &maxWaitTimeSecs);
+
+    // Get 'dev'icerecord for handle: This will error-out if no such device open:
+    dev = PsychHIDGetUSBDevice(usbHandle);
+    if (!(stream = dev->stream))
+        PsychErrorExitMsg(PsychError_user, "Streaming was never started on this USB device! Call PsychHID('USBStartStreaming') first.");
+
+    PsychLockMutex(&stream->mutex);
+
+    navail = stream->writePos - stream->readPos;
+
+    // If nothing available and we're asked to wait for something, then wait:
+    if ((navail == 0) && (maxWaitTimeSecs > 0) && stream->os) {
+        PsychTimedWaitCondition(&stream->condition, &stream->mutex, maxWaitTimeSecs);
+        navail = stream->writePos - stream->readPos;
+    }
+
+    PsychUnlockMutex(&stream->mutex);
+
+    // Only we consume reports, so at least n reports will still be available after allocating the outputs:
+    n = (navail < (unsigned int) maxReports) ? navail : (unsigned int) maxReports;
+
+    PsychAllocOutUnsignedByteMatArg(1, FALSE, stream->reportSize, (int) n, 1, &reports);
+    PsychAllocOutDoubleMatArg(2, FALSE, 1, (int) n, 1, &timestamps);
+    PsychAllocOutDoubleMatArg(3, FALSE, 1, (int) n, 1, &lengths);
+
+    PsychLockMutex(&stream->mutex);
+
+    for (i = 0; i < n; i++) {
+        pos = (stream->readPos + i) % stream->capacity;
+        memcpy(&reports[(size_t) i * stream->reportSize], &(stream->data[(size_t) pos * stream->reportSize]), stream->reportSize);
+        timestamps[i] = stream->timestamps[pos];
+        lengths[i] = (double) stream->lengths[pos];
+    }
+
+    stream->readPos += n;
+    navail = stream->writePos - stream->readPos;
+    lost = stream->lostCount;
+    stream->lostCount = 0;
+
+    PsychUnlockMutex(&stream->mutex);
+
+    PsychCopyOutDoubleArg(4, FALSE, (double) navail);
+    PsychCopyOutDoubleArg(5, FALSE, (double) lost);
+
+    return(PsychError_none);
+}
@@ -9,11 +9,15 @@
 
   Allen.Ingling@nyu.edu             awi
   mario.kleiner.de@gmail.com        mk
+  agent@local                       ag
 
   HISTORY:
   4/16/03  awi      Created.
   4/15/05  dgp      Added Get/SetReport.
   8/23/07  rpw      Added PsychHIDKbQueue suite and PsychHIDKbTriggerWait
+  10/19/26 ag       Added KbQueueAggregate and KbQueueAggregateGetEvents.
+  10/19/26 ag       Added USBStartStreaming, USBStopStreaming and USBGetStreamedReports.
+  10/19/26 ag       Added GamePadSamplerStart, GamePadSamplerStop, GamePadSamplerGetState and GamePadSamplerGetHistory.
 */
 
 #include "Psych.h"
@@ -57,10 +61,17 @@ PsychError PsychModuleInit(void)
     PsychErrorExit(PsychRegister("KbQueueFlush", &PSYCHHIDKbQueueFlush));
     PsychErrorExit(PsychRegister("KbQueueRelease", &PSYCHHIDKbQueueRelease));
     PsychErrorExit(PsychRegister("KbQueueGetEvent", &PSYCHHIDKbQueueGetEvent));
+    PsychErrorExit(PsychRegister("KbQueueAggregate", &PSYCHHIDKbQueueAggregate));
+    PsychErrorExit(PsychRegister("KbQueueAggregateGetEvents", &PSYCHHIDKbQueueAggregateGetEvents));
 
     PsychErrorExit(PsychRegister("RawState",  &PSYCHHIDGetRawState));
     PsychErrorExit(PsychRegister("KbCheck",  &PSYCHHIDKbCheck));
 
+    PsychErrorExit(PsychRegister("GamePadSamplerStart", &PSYCHHIDGamePadSamplerStart));
+    PsychErrorExit(PsychRegister("GamePadSamplerStop", &PSYCHHIDGamePadSamplerStop));
+    PsychErrorExit(PsychRegister("GamePadSamplerGetState", &PSYCHHIDGamePadSamplerGetState));
+    PsychErrorExit(PsychRegister("GamePadSamplerGetHistory", &PSYCHHIDGamePadSamplerGetHistory));
+
     PsychErrorExit(PsychRegister("KeyboardHelper", &PSYCHHIDKeyboardHelper));
 
     PsychErrorExit(PsychRegister("GetReport",  &PSYCHHIDGetReport));
@@ -75,6 +86,9 @@ PsychError PsychModuleInit(void)
     PsychErrorExit(PsychRegister("USBBulkTransfer", &PSYCHHIDUSBBulkTransfer));
     PsychErrorExit(PsychRegister("USBInterruptTransfer", &PSYCHHIDUSBInterruptTransfer));
     PsychErrorExit(PsychRegister("USBClaimInterface", &PSYCHHIDUSBClaimInterface));
+    PsychErrorExit(PsychRegister("USBStartStreaming", &PSYCHHIDUSBStartStreaming));
+    PsychErrorExit(PsychRegister("USBStopStreaming", &PSYCHHIDUSBStopStreaming));
+    PsychErrorExit(PsychRegister("USBGetStreamedReports", &PSYCHHIDUSBGetStreamedReports));
 
     PsychSetModuleAuthorByInitials("awi");
     PsychSetModuleAuthorByInitials("dgp");
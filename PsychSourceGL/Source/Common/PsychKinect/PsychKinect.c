@@ -6,6 +6,7 @@
 	AUTHORS:
  
 	mario.kleiner@tuebingen.mpg.de	mk
+	agent@local				ag
  
 	PLATFORMS:	All.
  
@@ -14,6 +15,7 @@
 	24.11.2010  mk		Created.
 	03.04.2011  mk		Make 64-bit clean.
 	14.02.2012  mk		Make Linux & OS/X version compatible to libfreenect 0.1.2
+	19.10.2026  ag		Table driven, multi-threaded SSE2 depth reconstruction in 'GetDepthImage'.
 
 	DESCRIPTION:
  
@@ -29,6 +31,11 @@
 #include <math.h>
 #include <errno.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PSYCH_KINECT_SSE2 1
+#endif
+
 // Include header of libfreeenect:
 #include "libfreenect.h"
 
@@ -63,6 +70,20 @@ double          depthBaseAndOffset[2];
 typedef double (*CALCPROC)(int); 
 CALCPROC calcz = NULL;
 
+// Lookup table for conversion of 11 bit raw disparity values into z distance, and the
+// conversion function and parameters it was built for:
+static double   zlut[2048];
+static CALCPROC zlutcalcz = NULL;
+static double   zlutBaseAndOffset[2];
+
+// Per column and per row ray direction tables, ie. ((x - cx_d) / fx_d) and ((y - cy_d) / fy_d),
+// and the depth camera intrinsics they were built for:
+static double   xray[640], yray[480];
+static double   rayIntrinsics[4] = { 0, 0, 0, 0 };
+
+// Maximum number of threads for the 3D reconstruction in 'GetDepthImage':
+#define MAX_PSYCH_KINECT_DEPTH_THREADS 4
+
 freenect_context	*f_ctx = NULL;
 freenect_device		*f_dev;
 
@@ -1177,6 +1198,173 @@ static double calctanhz(int raw_depth)
 }
 
 
+// Rebuild the disparity -> z lookup table if the conversion method or its parameters changed:
+static void PsychKNUpdateDepthLUT(void)
+{
+	int i;
+
+	if ((zlutcalcz == calcz) && (zlutBaseAndOffset[0] == depthBaseAndOffset[0]) && (zlutBaseAndOffset[1] == depthBaseAndOffset[1])) return;
+
+	for (i = 0; i < 2048; i++) zlut[i] = calcz(i);
+
+	zlutcalcz = calcz;
+	zlutBaseAndOffset[0] = depthBaseAndOffset[0];
+	zlutBaseAndOffset[1] = depthBaseAndOffset[1];
+}
+
+// Rebuild the ray direction tables if the depth camera intrinsics changed:
+static void PsychKNUpdateRayTables(double fx_d, double fy_d, double cx_d, double cy_d)
+{
+	int i;
+
+	if ((rayIntrinsics[0] == fx_d) && (rayIntrinsics[1] == fy_d) && (rayIntrinsics[2] == cx_d) && (rayIntrinsics[3] == cy_d)) return;
+
+	for (i = 0; i < 640; i++) xray[i] = ((double) i - cx_d) / fx_d;
+	for (i = 0; i < 480; i++) yray[i] = ((double) i - cy_d) / fy_d;
+
+	rayIntrinsics[0] = fx_d;
+	rayIntrinsics[1] = fy_d;
+	rayIntrinsics[2] = cx_d;
+	rayIntrinsics[3] = cy_d;
+}
+
+// Lookup z distance for raw disparity value d. Values >= 2047 are invalid, as in calcz():
+static double PsychKNLookupZ(unsigned short d)
+{
+	return((d < 2047) ? zlut[d] : 0);
+}
+
+// Work item for the conversion of a range of depth image columns into a vertex buffer:
+typedef struct PsychKNMeshJob {
+	PsychKNBuffer*	buffer;
+	double*		zmap;
+	int		x0, x1;				// Range [x0, x1) of depth image columns to convert.
+	int		texcoords;			// 1 = Output texture coordinates, 0 = Output RGB colors.
+	double		R[3][3];
+	double		T[3];
+	double		fx_rgb, fy_rgb, cx_rgb, cy_rgb;
+	psych_thread	thread;
+	psych_bool	threaded;			// Processed by thread 'thread'?
+} PsychKNMeshJob;
+
+// Convert columns [x0, x1) of the depth image into (x,y,z) vertices plus (r,g,b) colors or (tx,ty) texcoords.
+// Mapping equations from http://nicolas.burrus.name/index.php/Research/KinectCalibration
+//
+// The rotated ray R.(xray, yray, 1) of each pixel is a[m] + b[m] * yray with per-column constants a and b,
+// so the projection into the color cameras reference frame P3D' = R.P3D + T reduces to z * (a + b * yray) + T.
+static void* PsychKNDepthToMesh(void* arg)
+{
+	PsychKNMeshJob* job = (PsychKNMeshJob*) arg;
+	const unsigned short* depth = job->buffer->depth;
+	const unsigned char* color = job->buffer->color;
+	const int texcoords = job->texcoords;
+	const int components = 3 + ((texcoords) ? 2 : 3);
+	const double w = 640;
+	const double h = 480;
+	double* out;
+	double a[3], b[3], zp, Pr[3], Pt[2];
+	int x, y, m, ci;
+
+	#ifdef PSYCH_KINECT_SSE2
+	__m128d va[3], vb[3], vT[3], vz, vry, vPr[3], vPt[2];
+	const __m128d vfx = _mm_set1_pd(job->fx_rgb), vfy = _mm_set1_pd(job->fy_rgb);
+	const __m128d vcx = _mm_set1_pd(job->cx_rgb), vcy = _mm_set1_pd(job->cy_rgb);
+	const __m128d vzero = _mm_setzero_pd(), vwmax = _mm_set1_pd(w - 1), vhmax = _mm_set1_pd(h - 1);
+	double px[2], py[2], pz[2], tx[2], ty[2];
+	int j;
+
+	for (m = 0; m < 3; m++) {
+		vb[m] = _mm_set1_pd(job->R[m][1]);
+		vT[m] = _mm_set1_pd(job->T[m]);
+	}
+	#endif
+
+	for (x = job->x0; x < job->x1; x++) {
+		out = job->zmap + (size_t) x * 480 * components;
+
+		for (m = 0; m < 3; m++) {
+			a[m] = job->R[m][0] * xray[x] + job->R[m][2];
+			b[m] = job->R[m][1];
+		}
+
+		y = 0;
+
+		#ifdef PSYCH_KINECT_SSE2
+		for (m = 0; m < 3; m++) va[m] = _mm_set1_pd(a[m]);
+
+		// Two vertices at a time:
+		for (; y < 480 - 1; y += 2) {
+			vz = _mm_set_pd(PsychKNLookupZ(depth[(y + 1) * 640 + x]), PsychKNLookupZ(depth[y * 640 + x]));
+			vry = _mm_loadu_pd(&yray[y]);
+
+			// Cartesian 3D vertex coordinates in depth cameras reference frame:
+			_mm_storeu_pd(px, _mm_mul_pd(_mm_set1_pd(xray[x]), vz));
+			_mm_storeu_pd(py, _mm_mul_pd(vry, vz));
+			_mm_storeu_pd(pz, vz);
+
+			// Transform into color cameras reference frame and project into its sensor plane:
+			for (m = 0; m < 3; m++) vPr[m] = _mm_add_pd(_mm_mul_pd(vz, _mm_add_pd(va[m], _mm_mul_pd(vb[m], vry))), vT[m]);
+			vPt[0] = _mm_add_pd(_mm_div_pd(_mm_mul_pd(vPr[0], vfx), vPr[2]), vcx);
+			vPt[1] = _mm_add_pd(_mm_div_pd(_mm_mul_pd(vPr[1], vfy), vPr[2]), vcy);
+
+			if (!texcoords) {
+				// Clamp for the nearest neighbour texture lookup. Invalid (NaN) coordinates map to zero:
+				vPt[0] = _mm_min_pd(_mm_max_pd(vPt[0], vzero), vwmax);
+				vPt[1] = _mm_min_pd(_mm_max_pd(vPt[1], vzero), vhmax);
+			}
+
+			_mm_storeu_pd(tx, vPt[0]);
+			_mm_storeu_pd(ty, vPt[1]);
+
+			for (j = 0; j < 2; j++) {
+				*(out++) = px[j];
+				*(out++) = py[j];
+				*(out++) = pz[j];
+
+				if (!texcoords) {
+					ci = 3 * (((int) ty[j]) * 640 + ((int) tx[j]));
+					*(out++) = ((double) color[ci + 0]) / 255.0; // R
+					*(out++) = ((double) color[ci + 1]) / 255.0; // G
+					*(out++) = ((double) color[ci + 2]) / 255.0; // B
+				} else {
+					*(out++) = tx[j];
+					*(out++) = ty[j];
+				}
+			}
+		}
+		#endif
+
+		// Scalar path for remaining vertices, or all of them on non-SSE2 builds:
+		for (; y < 480; y++) {
+			zp = PsychKNLookupZ(depth[y * 640 + x]);
+			*(out++) = xray[x] * zp;
+			*(out++) = yray[y] * zp;
+			*(out++) = zp;
+
+			for (m = 0; m < 3; m++) Pr[m] = zp * (a[m] + b[m] * yray[y]) + job->T[m];
+			Pt[0] = (Pr[0] * job->fx_rgb / Pr[2]) + job->cx_rgb;
+			Pt[1] = (Pr[1] * job->fy_rgb / Pr[2]) + job->cy_rgb;
+
+			if (!texcoords) {
+				if (!(Pt[0] >= 0)) Pt[0] = 0;
+				if (!(Pt[1] >= 0)) Pt[1] = 0;
+				if (Pt[0] >= w) Pt[0] = w-1;
+				if (Pt[1] >= h) Pt[1] = h-1;
+
+				ci = 3 * (((int) Pt[1]) * 640 + ((int) Pt[0]));
+				*(out++) = ((double) color[ci + 0]) / 255.0; // R
+				*(out++) = ((double) color[ci + 1]) / 255.0; // G
+				*(out++) = ((double) color[ci + 2]) / 255.0; // B
+			} else {
+				*(out++) = Pt[0];
+				*(out++) = Pt[1];
+			}
+		}
+	}
+
+	return(NULL);
+}
+
 PsychError PSYCHKINECTGetDepthImage(void)
 {
 	static char useString[] = "[imageOrPtr, width, height, components, extFormat] = PsychKinect('GetDepthImage', kinectPtr [, format=0][, returnTexturePtr=0]);";
@@ -1217,9 +1405,8 @@ PsychError PSYCHKINECTGetDepthImage(void)
 	short* inbufs;
 
 	int returnTexturePtr, format, texcoords;
-	int i, x, y, m, n, components;
-	double P[3], Pr[3], Pt[2];
-	double s, zp;
+	int i, x, y, components, nthreads;
+	PsychKNMeshJob jobs[MAX_PSYCH_KINECT_DEPTH_THREADS];
 	double fx_d;
 	double fy_d;
 	double cx_d;
@@ -1231,9 +1418,6 @@ PsychError PSYCHKINECTGetDepthImage(void)
 	double R[3][3];
 	double T[3];
 
-	const double w = 640;
-	const double h = 480;
-
 	// All sub functions should have these two lines
 	PsychPushHelp(useString, synopsisString,seeAlsoString);
 	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
@@ -1277,6 +1461,10 @@ PsychError PSYCHKINECTGetDepthImage(void)
 		}
 	}
 
+	// Update lookup tables for disparity -> z conversion and for per-pixel ray directions:
+	PsychKNUpdateDepthLUT();
+	PsychKNUpdateRayTables(fx_d, fy_d, cx_d, cy_d);
+
 	format = 0;
 	texcoords = 0;
 	PsychCopyInIntegerArg(2, FALSE, &format);	
@@ -1314,7 +1502,7 @@ PsychError PSYCHKINECTGetDepthImage(void)
 			for (x=0; x < 640; x++)
 				for (y=0; y < 480; y++) {
 					// Calc z distance in meters:
-					zmap[i++] = calcz(getz(buffer->depth, x, y));
+					zmap[i++] = PsychKNLookupZ(getz(buffer->depth, x, y));
 				}
 					
 			// Return image data:
@@ -1337,65 +1525,38 @@ PsychError PSYCHKINECTGetDepthImage(void)
 			// Format 3 = Generate texture coords instead of vertex colors:
 			if (format == 3) texcoords = 1;
 
-			i=0;
-			for (x=0; x < 640; x++) {
-				for (y=0; y < 480; y++) {
-					// Compute cartesian 3D (x,y,z) vertex coordinates,
-					// one vertex per 3D point aka depth camera pixel:
-					zp = calcz(getz(buffer->depth, x, y));
-					P[0] = ((double) x - cx_d) * zp / fx_d;
-					P[1] = ((double) y - cy_d) * zp / fy_d;
-					P[2] = zp;
-
-					// Write out vertex 3D (x,y,z):
-					zmap[i++] = P[0];
-					zmap[i++] = P[1];
-					zmap[i++] = P[2];
-	
-					// Compute 2D texture coordinates for each 3D
-					// point, aka (x,y) image coordinates in color image:
-
-					// P3D' = R.P3D + T  --> Project from depth cams
-					// reference frame to color cams reference frame,
-					// aka apply extrinsic rotation/translation parameters
-					// of color cam wrt. depths cam:
-					for (m = 0; m < 3; m++) {
-						s = 0.0;
-						for (n = 0; n < 3; n++) s += R[m][n] * P[n];
-						Pr[m] = s + T[m];
-					}
+			// Split the columns of the depth image across worker threads, the
+			// last range gets processed on this thread:
+			nthreads = MAX_PSYCH_KINECT_DEPTH_THREADS;
+			for (i = 0; i < nthreads; i++) {
+				jobs[i].buffer = buffer;
+				jobs[i].zmap = zmap;
+				jobs[i].x0 = 640 * i / nthreads;
+				jobs[i].x1 = 640 * (i + 1) / nthreads;
+				jobs[i].texcoords = texcoords;
+				memcpy(jobs[i].R, R, sizeof(R));
+				memcpy(jobs[i].T, T, sizeof(T));
+				jobs[i].fx_rgb = fx_rgb;
+				jobs[i].fy_rgb = fy_rgb;
+				jobs[i].cx_rgb = cx_rgb;
+				jobs[i].cy_rgb = cy_rgb;
+			}
 
-					// Apply intrinsic parameters of color cam to project
-					// into color cams 2D sensor plane, aka color image
-					// coordinates, aka texture coordinates:
-					Pt[0] = (Pr[0] * fx_rgb / Pr[2]) + cx_rgb;
-					Pt[1] = (Pr[1] * fy_rgb / Pr[2]) + cy_rgb;
-
-					// Return 3-component RGB8 vertex colors, or 2D texture
-					// coordinates?
-					if (!texcoords) {
-						// Perform "manual" texture lookup and return RGB
-						// pixel:
-
-						// Clamp:
-						if (Pt[0] < 0) Pt[0] = 0;
-						if (Pt[1] < 0) Pt[1] = 0;
-						if (Pt[0] >= w) Pt[0] = w-1;
-						if (Pt[1] >= h) Pt[1] = h-1;
-
-						// "Nearest neighbour texture lookup":
-						zmap[i++] = ((double) buffer->color[(int) (3 * ((((int) Pt[1]) * w + ((int) Pt[0]))) + 0)]) / 255.0; // R
-						zmap[i++] = ((double) buffer->color[(int) (3 * ((((int) Pt[1]) * w + ((int) Pt[0]))) + 1)]) / 255.0; // G
-						zmap[i++] = ((double) buffer->color[(int) (3 * ((((int) Pt[1]) * w + ((int) Pt[0]))) + 2)]) / 255.0; // B
-					} else {
-						// Output direct texture coordinates into a
-						// GL_TEXTURE_RECTANGLE texture:
-						zmap[i++] = Pt[0];
-						zmap[i++] = Pt[1];
-					}
+			for (i = 0; i < nthreads - 1; i++) {
+				jobs[i].threaded = (PsychCreateThread(&jobs[i].thread, NULL, PsychKNDepthToMesh, (void*) &jobs[i])) ? FALSE : TRUE;
+				if (!jobs[i].threaded) {
+					// Thread creation failed: Process this range on our thread, after the others are done:
+					if (verbosity > 1) printf("PsychKinect-WARNING: Failed to create depth conversion thread. Falling back to slower processing.\n");
 				}
 			}
 
+			PsychKNDepthToMesh((void*) &jobs[nthreads - 1]);
+
+			for (i = 0; i < nthreads - 1; i++) {
+				if (jobs[i].threaded) PsychDeleteThread(&jobs[i].thread);
+				else PsychKNDepthToMesh((void*) &jobs[i]);
+			}
+
 			// Return image data:
 			components = 3 + ((texcoords) ? 2 : 3);
 
@@ -1419,7 +1580,7 @@ PsychError PSYCHKINECTGetDepthImage(void)
 						// Calc z distance in meters:
 						zmap[i++] = (double) x;
 						zmap[i++] = (double) y;
-						zmap[i++] = calcz(getz(buffer->depth, x, y));
+						zmap[i++] = PsychKNLookupZ(getz(buffer->depth, x, y));
 					}
 				}
 			} else {
@@ -1427,7 +1588,7 @@ PsychError PSYCHKINECTGetDepthImage(void)
 				for (y=0; y < 480; y++) {
 					for (x=0; x < 640; x++) {
 						// Calc z distance in meters:
-						zmap[i] = calcz(getz(buffer->depth, x, y));
+						zmap[i] = PsychKNLookupZ(getz(buffer->depth, x, y));
 						i+=3;
 					}
 				}
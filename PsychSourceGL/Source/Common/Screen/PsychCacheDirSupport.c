@@ -0,0 +1,108 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychCacheDirSupport.c
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent   agent@local
+
+    HISTORY:
+
+        19.10.2026  agent   Wrote it.
+
+    DESCRIPTION:
+
+        Location and creation of the per-user cache directories of Screen's persistent caches.
+
+        The cache directory for a cache with subdirectory name 'subDirName' is:
+
+        - $envVarName if that environment variable is set and non-empty.
+        - Otherwise on Linux $XDG_CACHE_HOME/Psychtoolbox/subDirName/ or ~/.cache/Psychtoolbox/subDirName/
+        - on macOS ~/Library/Caches/Psychtoolbox/subDirName/
+        - on MS-Windows %LOCALAPPDATA%\Psychtoolbox\subDirName\
+*/
+
+#include "Screen.h"
+
+#include <sys/stat.h>
+#include <errno.h>
+
+#if PSYCH_SYSTEM == PSYCH_WINDOWS
+#include <direct.h>
+#endif
+
+/* PsychMakeCacheDirs()
+ *
+ * Create all missing directories along 'path', like 'mkdir -p'.
+ */
+psych_bool PsychMakeCacheDirs(char* path)
+{
+    char *p, c;
+    int rc;
+
+    for (p = path + 1; ; p++) {
+        if (*p == '/' || *p == '\\' || *p == 0) {
+            c = *p;
+            *p = 0;
+            #if PSYCH_SYSTEM == PSYCH_WINDOWS
+                rc = _mkdir(path);
+            #else
+                rc = mkdir(path, 0700);
+            #endif
+            *p = c;
+
+            if ((rc != 0) && (errno != EEXIST) && (c == 0)) return(FALSE);
+            if (c == 0) break;
+        }
+    }
+
+    return(TRUE);
+}
+
+/* PsychSetupCacheDir()
+ *
+ * Store the path of the cache directory for 'envVarName' and 'subDirName', with a trailing
+ * path separator, in 'cachedir' of size 'maxlen', and create the directory if it doesn't exist.
+ * Returns FALSE and an empty 'cachedir' if no cache directory could be determined or created.
+ */
+psych_bool PsychSetupCacheDir(char* cachedir, size_t maxlen, const char* envVarName, const char* subDirName)
+{
+    const char *base;
+
+    cachedir[0] = 0;
+
+    if ((base = getenv(envVarName)) && (strlen(base) > 0)) {
+        snprintf(cachedir, maxlen, "%s/", base);
+    }
+    else {
+        #if PSYCH_SYSTEM == PSYCH_WINDOWS
+            if ((base = getenv("LOCALAPPDATA")) && (strlen(base) > 0)) snprintf(cachedir, maxlen, "%s\\Psychtoolbox\\%s\\", base, subDirName);
+        #elif PSYCH_SYSTEM == PSYCH_OSX
+            if ((base = getenv("HOME")) && (strlen(base) > 0)) snprintf(cachedir, maxlen, "%s/Library/Caches/Psychtoolbox/%s/", base, subDirName);
+        #else
+            if ((base = getenv("XDG_CACHE_HOME")) && (strlen(base) > 0)) snprintf(cachedir, maxlen, "%s/Psychtoolbox/%s/", base, subDirName);
+            else if ((base = getenv("HOME")) && (strlen(base) > 0)) snprintf(cachedir, maxlen, "%s/.cache/Psychtoolbox/%s/", base, subDirName);
+        #endif
+    }
+
+    if (strlen(cachedir) <= 1) {
+        cachedir[0] = 0;
+        return(FALSE);
+    }
+
+    // Strip trailing separator for directory creation, then make sure it exists:
+    cachedir[strlen(cachedir) - 1] = 0;
+    if (!PsychMakeCacheDirs(cachedir)) {
+        if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Could not create cache directory %s. Cache disabled.\n", cachedir);
+        cachedir[0] = 0;
+        return(FALSE);
+    }
+
+    strcat(cachedir, "/");
+    if (PsychPrefStateGet_Verbosity() > 4) printf("PTB-DEBUG: Using cache directory %s\n", cachedir);
+
+    return(TRUE);
+}
@@ -0,0 +1,32 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychCacheDirSupport.h
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent   agent@local
+
+    HISTORY:
+
+        19.10.2026  agent   Wrote it.
+
+    DESCRIPTION:
+
+        Location and creation of the per-user cache directories of Screen's persistent caches,
+        e.g., the GLSL shader cache and the refresh calibration cache.
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychCacheDirSupport
+#define PSYCH_IS_INCLUDED_PsychCacheDirSupport
+
+#include "Screen.h"
+
+psych_bool PsychMakeCacheDirs(char* path);
+psych_bool PsychSetupCacheDir(char* cachedir, size_t maxlen, const char* envVarName, const char* subDirName);
+
+//end include once
+#endif
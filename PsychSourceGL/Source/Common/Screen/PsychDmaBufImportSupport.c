@@ -0,0 +1,328 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychDmaBufImportSupport.c
+
+    PLATFORMS:
+
+        Linux with GStreamer and EGL based OpenGL contexts, i.e., Waffle builds. A no-op elsewhere.
+
+    AUTHORS:
+
+        agent           ag      agent@local
+
+    HISTORY:
+
+        19.10.2026  ag      Wrote it.
+
+    DESCRIPTION:
+
+        Zero-copy import of GStreamer video frames in DMA-BUF memory as OpenGL textures.
+
+        If a video decoder or capture device delivers frames in DMA-BUF memory, e.g., hardware
+        decoders or V4L2 devices, the frames can be wrapped into an EGLImage and bound to an OpenGL
+        texture directly, instead of mapping them into system memory and uploading them again via
+        PsychCreateTexture(). This requires an EGL display, the EGL_EXT_image_dma_buf_import extension
+        and single-plane RGBA frames in linear layout. The texture keeps a reference to the GStreamer
+        buffer until it gets deleted, so the buffer does not get reused while the texture is alive.
+
+        All EGL and GStreamer DMA-BUF functions are looked up at runtime, so Screen does not need to
+        link against libEGL or libgstallocators: If they aren't loaded, then there isn't any EGL context
+        or DMA-BUF memory to import either, and callers use their regular upload path.
+*/
+
+#include "Screen.h"
+#include "PsychDmaBufImportSupport.h"
+
+#if (PSYCH_SYSTEM == PSYCH_LINUX) && defined(PTB_USE_GSTREAMER) && defined(PTB_USE_WAFFLE)
+
+#include <dlfcn.h>
+#include <gst/video/video.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+// Caps feature of DMA-BUF memory, as GST_CAPS_FEATURE_MEMORY_DMABUF in gst/allocators/gstdmabuf.h:
+#define PSYCH_CAPS_FEATURE_MEMORY_DMABUF "memory:DMABuf"
+
+// DRM fourcc codes for packed 32 bpp RGB formats, as in drm_fourcc.h:
+#define PSYCH_FOURCC(a, b, c, d) ((unsigned int) (a) | ((unsigned int) (b) << 8) | ((unsigned int) (c) << 16) | ((unsigned int) (d) << 24))
+#define PSYCH_DRM_FORMAT_ARGB8888 PSYCH_FOURCC('A', 'R', '2', '4')
+#define PSYCH_DRM_FORMAT_XRGB8888 PSYCH_FOURCC('X', 'R', '2', '4')
+#define PSYCH_DRM_FORMAT_ABGR8888 PSYCH_FOURCC('A', 'B', '2', '4')
+#define PSYCH_DRM_FORMAT_XBGR8888 PSYCH_FOURCC('X', 'B', '2', '4')
+
+typedef EGLDisplay (*PsychEGLGetCurrentDisplayProc)(void);
+typedef const char* (*PsychEGLQueryStringProc)(EGLDisplay dpy, EGLint name);
+typedef void* (*PsychEGLGetProcAddressProc)(const char *procname);
+typedef void (*PsychGLEGLImageTargetTexture2DOESProc)(GLenum target, void* image);
+
+// Import support state: -1 = Not yet probed, 0 = Unsupported, 1 = Supported:
+static int dmaBufImportSupported = -1;
+static EGLDisplay dmaBufDisplay = EGL_NO_DISPLAY;
+static PFNEGLCREATEIMAGEKHRPROC psych_eglCreateImageKHR = NULL;
+static PFNEGLDESTROYIMAGEKHRPROC psych_eglDestroyImageKHR = NULL;
+static PsychGLEGLImageTargetTexture2DOESProc psych_glEGLImageTargetTexture2DOES = NULL;
+
+// DMA-BUF memory functions of libgstallocators, resolved once a plugin has loaded that library:
+static gboolean (*psych_gst_is_dmabuf_memory)(GstMemory *mem) = NULL;
+static gint (*psych_gst_dmabuf_memory_get_fd)(GstMemory *mem) = NULL;
+
+// Map GStreamer video format name to DRM fourcc of the same memory layout, or zero if unsupported:
+static unsigned int PsychDmaBufFourccForFormat(const char* format)
+{
+    if (!strcmp(format, "BGRA")) return(PSYCH_DRM_FORMAT_ARGB8888);
+    if (!strcmp(format, "BGRx")) return(PSYCH_DRM_FORMAT_XRGB8888);
+    if (!strcmp(format, "RGBA")) return(PSYCH_DRM_FORMAT_ABGR8888);
+    if (!strcmp(format, "RGBx")) return(PSYCH_DRM_FORMAT_XBGR8888);
+
+    return(0);
+}
+
+// Return DRM fourcc of the frames described by caps, or zero if they can't be imported:
+static unsigned int PsychDmaBufFourccForCaps(GstCaps* caps)
+{
+    GstStructure*   s;
+    const char*     format;
+    const char*     drmformat;
+    unsigned int    fourcc;
+
+    if (!caps || (gst_caps_get_size(caps) < 1)) return(0);
+
+    s = gst_caps_get_structure(caps, 0);
+    if (!(format = gst_structure_get_string(s, "format"))) return(0);
+
+    // Classic caps with a GStreamer video format:
+    if (strcmp(format, "DMA_DRM")) return(PsychDmaBufFourccForFormat(format));
+
+    // GStreamer 1.24+ DMA-BUF caps with DRM fourcc, optionally followed by a modifier. Only the
+    // linear layout can be imported without explicit modifier support:
+    drmformat = gst_structure_get_string(s, "drm-format");
+    if (!drmformat || (strlen(drmformat) < 4) || ((strlen(drmformat) > 4) && strcmp(drmformat + 4, ":0x0000000000000000")))
+        return(0);
+
+    fourcc = PSYCH_FOURCC(drmformat[0], drmformat[1], drmformat[2], drmformat[3]);
+    if ((fourcc != PSYCH_DRM_FORMAT_ARGB8888) && (fourcc != PSYCH_DRM_FORMAT_XRGB8888) &&
+        (fourcc != PSYCH_DRM_FORMAT_ABGR8888) && (fourcc != PSYCH_DRM_FORMAT_XBGR8888))
+        return(0);
+
+    return(fourcc);
+}
+
+// Release the video buffer backing an imported texture, called on texture deletion:
+static void PsychDmaBufReleaseBuffer(void* handle)
+{
+    gst_buffer_unref((GstBuffer*) handle);
+}
+
+/* PsychDmaBufAddImportCaps() - Extend caps for an appsink with DMA-BUF variants.
+ *
+ * Returns new caps which prefer DMA-BUF memory for all importable formats in 'caps', both in
+ * classic and in GStreamer 1.24+ DRM fourcc notation, followed by the original system memory
+ * caps as fallback. Takes ownership of 'caps'.
+ */
+GstCaps* PsychDmaBufAddImportCaps(GstCaps* caps)
+{
+    GstCaps*        dmacaps = gst_caps_new_empty();
+    GstStructure*   s;
+    const char*     format;
+    char            drmformat[5];
+    unsigned int    i, fourcc;
+
+    for (i = 0; i < gst_caps_get_size(caps); i++) {
+        format = gst_structure_get_string(gst_caps_get_structure(caps, i), "format");
+        if (!format || !(fourcc = PsychDmaBufFourccForFormat(format))) continue;
+
+        s = gst_structure_copy(gst_caps_get_structure(caps, i));
+        gst_caps_append_structure_full(dmacaps, s, gst_caps_features_new(PSYCH_CAPS_FEATURE_MEMORY_DMABUF, NULL));
+
+        drmformat[0] = (char) (fourcc & 0xff);
+        drmformat[1] = (char) ((fourcc >> 8) & 0xff);
+        drmformat[2] = (char) ((fourcc >> 16) & 0xff);
+        drmformat[3] = (char) ((fourcc >> 24) & 0xff);
+        drmformat[4] = 0;
+        s = gst_structure_new("video/x-raw", "format", G_TYPE_STRING, "DMA_DRM", "drm-format", G_TYPE_STRING, drmformat, NULL);
+        gst_caps_append_structure_full(dmacaps, s, gst_caps_features_new(PSYCH_CAPS_FEATURE_MEMORY_DMABUF, NULL));
+    }
+
+    gst_caps_append(dmacaps, caps);
+
+    return(dmacaps);
+}
+
+/* PsychDmaBufImportAvailable() - Can textures for onscreen window 'win' be imported from DMA-BUF's?
+ *
+ * Probes the current EGL display for the needed extensions, the OpenGL context of 'win' must be bound.
+ * The result is cached until a different EGL display becomes current, e.g., after windows got reopened.
+ */
+psych_bool PsychDmaBufImportAvailable(PsychWindowRecordType *win)
+{
+    static PsychEGLGetCurrentDisplayProc    getCurrentDisplay = NULL;
+    PsychEGLQueryStringProc                 queryString;
+    PsychEGLGetProcAddressProc              getProcAddress;
+    const char*                             extensions;
+    EGLDisplay                              dpy;
+
+    if (!(win->gfxcaps & kPsychGfxCapNPOTTex)) return(FALSE);
+
+    // No libEGL loaded means no EGL context, so nothing to import into:
+    if (!getCurrentDisplay && !(getCurrentDisplay = (PsychEGLGetCurrentDisplayProc) dlsym(RTLD_DEFAULT, "eglGetCurrentDisplay")))
+        return(FALSE);
+
+    dpy = getCurrentDisplay();
+    if (dpy == EGL_NO_DISPLAY) return(FALSE);
+
+    if ((dmaBufImportSupported < 0) || (dpy != dmaBufDisplay)) {
+        dmaBufImportSupported = 0;
+        dmaBufDisplay = dpy;
+
+        queryString = (PsychEGLQueryStringProc) dlsym(RTLD_DEFAULT, "eglQueryString");
+        getProcAddress = (PsychEGLGetProcAddressProc) dlsym(RTLD_DEFAULT, "eglGetProcAddress");
+
+        if (queryString && getProcAddress && (extensions = queryString(dpy, EGL_EXTENSIONS)) &&
+            strstr(extensions, "EGL_EXT_image_dma_buf_import") && strstr(extensions, "EGL_KHR_image_base")) {
+            psych_eglCreateImageKHR = (PFNEGLCREATEIMAGEKHRPROC) getProcAddress("eglCreateImageKHR");
+            psych_eglDestroyImageKHR = (PFNEGLDESTROYIMAGEKHRPROC) getProcAddress("eglDestroyImageKHR");
+            psych_glEGLImageTargetTexture2DOES = (PsychGLEGLImageTargetTexture2DOESProc) getProcAddress("glEGLImageTargetTexture2DOES");
+
+            if (psych_eglCreateImageKHR && psych_eglDestroyImageKHR && psych_glEGLImageTargetTexture2DOES)
+                dmaBufImportSupported = 1;
+        }
+
+        if (PsychPrefStateGet_Verbosity() > 3)
+            printf("PTB-INFO: Zero-copy import of DMA-BUF video frames is %s.\n", (dmaBufImportSupported) ? "supported" : "not supported, using regular texture upload");
+    }
+
+    return((dmaBufImportSupported > 0) ? TRUE : FALSE);
+}
+
+/* PsychDmaBufImportTexture() - Import video frame as texture without copy, if possible.
+ *
+ * If the frame in 'sample' is in DMA-BUF memory and an importable format, then create an OpenGL texture
+ * for 'out_texture' which directly uses the frame, and return TRUE. Otherwise return FALSE and leave
+ * 'out_texture' untouched, so the caller can use its regular upload path. The OpenGL context of onscreen
+ * window 'win' must be bound.
+ */
+psych_bool PsychDmaBufImportTexture(PsychWindowRecordType *win, GstSample *sample, PsychWindowRecordType *out_texture)
+{
+    GstBuffer*      buffer = gst_sample_get_buffer(sample);
+    GstCaps*        caps = gst_sample_get_caps(sample);
+    GstMemory*      mem;
+    GstVideoMeta*   meta;
+    GstStructure*   s;
+    EGLImageKHR     image;
+    EGLint          attribs[13];
+    gsize           memOffset;
+    gint            width, height;
+    unsigned int    fourcc;
+    GLuint          texid;
+
+    if (!buffer || !PsychDmaBufImportAvailable(win)) return(FALSE);
+
+    // Need a single DMA-BUF memory block, which only exists if a plugin loaded libgstallocators:
+    if (!psych_gst_is_dmabuf_memory || !psych_gst_dmabuf_memory_get_fd) {
+        psych_gst_is_dmabuf_memory = dlsym(RTLD_DEFAULT, "gst_is_dmabuf_memory");
+        psych_gst_dmabuf_memory_get_fd = dlsym(RTLD_DEFAULT, "gst_dmabuf_memory_get_fd");
+        if (!psych_gst_is_dmabuf_memory || !psych_gst_dmabuf_memory_get_fd) return(FALSE);
+    }
+
+    if (gst_buffer_n_memory(buffer) != 1) return(FALSE);
+    mem = gst_buffer_peek_memory(buffer, 0);
+    if (!psych_gst_is_dmabuf_memory(mem)) return(FALSE);
+
+    // Importable single-plane format and size?
+    if (!(fourcc = PsychDmaBufFourccForCaps(caps))) return(FALSE);
+    s = gst_caps_get_structure(caps, 0);
+    if (!gst_structure_get_int(s, "width", &width) || !gst_structure_get_int(s, "height", &height)) return(FALSE);
+
+    // Plane layout from video meta if any, otherwise tightly packed:
+    meta = gst_buffer_get_video_meta(buffer);
+    gst_memory_get_sizes(mem, &memOffset, NULL);
+
+    attribs[0] = EGL_WIDTH;
+    attribs[1] = width;
+    attribs[2] = EGL_HEIGHT;
+    attribs[3] = height;
+    attribs[4] = EGL_LINUX_DRM_FOURCC_EXT;
+    attribs[5] = (EGLint) fourcc;
+    attribs[6] = EGL_DMA_BUF_PLANE0_FD_EXT;
+    attribs[7] = psych_gst_dmabuf_memory_get_fd(mem);
+    attribs[8] = EGL_DMA_BUF_PLANE0_OFFSET_EXT;
+    attribs[9] = (EGLint) (memOffset + ((meta) ? meta->offset[0] : 0));
+    attribs[10] = EGL_DMA_BUF_PLANE0_PITCH_EXT;
+    attribs[11] = (meta) ? meta->stride[0] : width * 4;
+    attribs[12] = EGL_NONE;
+
+    image = psych_eglCreateImageKHR(dmaBufDisplay, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, (EGLClientBuffer) NULL, attribs);
+    if (image == EGL_NO_IMAGE_KHR) {
+        if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Creating EGLImage from DMA-BUF video frame failed. Using regular texture upload.\n");
+        return(FALSE);
+    }
+
+    PsychTrace(kPsychTraceTextureCreateBegin, out_texture->windowIndex);
+
+    // Bind image to a new texture. The texture keeps the image storage alive, so the image
+    // handle itself is no longer needed afterwards:
+    while (glGetError());
+    glGenTextures(1, &texid);
+    glBindTexture(GL_TEXTURE_2D, texid);
+    psych_glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, image);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    psych_eglDestroyImageKHR(dmaBufDisplay, image);
+
+    if (glGetError() != GL_NO_ERROR) {
+        if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Binding DMA-BUF video frame to texture failed. Using regular texture upload.\n");
+        glDeleteTextures(1, &texid);
+        PsychTrace(kPsychTraceTextureCreateEnd, out_texture->windowIndex);
+        return(FALSE);
+    }
+
+    // Setup texture record for the imported RGBA8 texture, upside-down like all video textures:
+    out_texture->textureNumber = texid;
+    out_texture->texturetarget = GL_TEXTURE_2D;
+    out_texture->textureOrientation = 3;
+    out_texture->depth = 32;
+    out_texture->nrchannels = 4;
+    out_texture->bpc = 8;
+    out_texture->textureMemory = NULL;
+    out_texture->textureMemorySizeBytes = 0;
+    out_texture->surfaceSizeBytes = (size_t) width * (size_t) height * 4;
+    PsychMakeRect(out_texture->rect, 0, 0, width, height);
+    PsychCopyRect(out_texture->clientrect, out_texture->rect);
+
+    // Imported textures can't be recycled for uploads, as that would overwrite the video buffer:
+    out_texture->texturecache_slot = -1;
+
+    // Keep the video buffer alive until the texture gets deleted:
+    out_texture->textureImportHandle = (void*) gst_buffer_ref(buffer);
+    out_texture->textureImportRelease = PsychDmaBufReleaseBuffer;
+
+    PsychTrace(kPsychTraceTextureCreateEnd, out_texture->windowIndex);
+
+    return(TRUE);
+}
+
+#elif defined(PTB_USE_GSTREAMER)
+
+// Stubs for systems without EGL DMA-BUF import: Callers always use their regular upload path.
+GstCaps* PsychDmaBufAddImportCaps(GstCaps* caps)
+{
+    return(caps);
+}
+
+psych_bool PsychDmaBufImportAvailable(PsychWindowRecordType *win)
+{
+    (void) win;
+    return(FALSE);
+}
+
+psych_bool PsychDmaBufImportTexture(PsychWindowRecordType *win, GstSample *sample, PsychWindowRecordType *out_texture)
+{
+    (void) win;
+    (void) sample;
+    (void) out_texture;
+    return(FALSE);
+}
+
+#endif
@@ -0,0 +1,37 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychDmaBufImportSupport.h
+
+    PLATFORMS:
+
+        Linux with GStreamer and EGL based OpenGL contexts, i.e., Waffle builds. A no-op elsewhere.
+
+    AUTHORS:
+
+        agent           ag      agent@local
+
+    HISTORY:
+
+        19.10.2026  ag      Wrote it.
+
+    DESCRIPTION:
+
+        Zero-copy import of GStreamer video frames in DMA-BUF memory as OpenGL textures via EGLImage,
+        shared by the GStreamer movie playback and video capture engines.
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychDmaBufImportSupport
+#define PSYCH_IS_INCLUDED_PsychDmaBufImportSupport
+
+#include "Screen.h"
+
+#ifdef PTB_USE_GSTREAMER
+#include <gst/gst.h>
+
+GstCaps*    PsychDmaBufAddImportCaps(GstCaps* caps);
+psych_bool  PsychDmaBufImportAvailable(PsychWindowRecordType *win);
+psych_bool  PsychDmaBufImportTexture(PsychWindowRecordType *win, GstSample *sample, PsychWindowRecordType *out_texture);
+#endif
+
+//end include once
+#endif
@@ -6,9 +6,13 @@
     AUTHORS:
     Allen Ingling   awi     Allen.Ingling@nyu.edu
     Mario Kleiner   mk      mario.kleiner.de@gmail.com
+    agent           ag      agent@local
 
     HISTORY:
     09/09/02        awi     wrote it.
+    10/19/26        ag      Cached unit circle tables and batching of discs for PsychDrawDisc().
+    10/19/26        ag      Instanced drawing of disc batches from a shared unit circle VBO, if supported.
+    10/19/26        ag      SIMD color conversion and per-window scratch buffer for PsychPrepareRenderBatch().
 
     DESCRIPTION:
 
@@ -17,6 +21,14 @@
 
 #include "Screen.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PSYCH_COLORCONV_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PSYCH_COLORCONV_NEON 1
+#endif
+
 // Cached global glApiType value for cases where no windowRecord is available:
 static int global_glApiType = 0;
 
@@ -99,13 +111,15 @@ void PsychSetGLColor(PsychColorType *color, PsychWindowRecordType *windowRecord)
 /* PsychSetupVertexColorArrays()
  * Helper routine, called from the different batch drawing functions of Screen():
  */
-void PsychSetupVertexColorArrays(PsychWindowRecordType *windowRecord, psych_bool enable, int mc, double* colors, unsigned char *bytecolors)
+void PsychSetupVertexColorArrays(PsychWindowRecordType *windowRecord, psych_bool enable, int mc, double* colors, unsigned char *bytecolors, psych_bool floatcolors)
 {
+    GLenum colortype = (floatcolors) ? GL_FLOAT : PSYCHGLFLOAT;
+
     if (enable) {
         // Enable and setup whatever's used:
         if (windowRecord->defaultDrawShader) {
             // Shader based unclamped path:
-            if (colors) glTexCoordPointer(mc, PSYCHGLFLOAT, 0, colors);
+            if (colors) glTexCoordPointer(mc, colortype, 0, colors);
 
             // Can't support uint8 datatype for this vertex attribute :-(
             if (bytecolors) PsychErrorExitMsg(PsychError_user, "Sorry, this function can't accept matrices of uint8 type for colors\nif color clamping is disabled or high precision mode active.\n Use the double() operator to convert to double matrix.");
@@ -115,7 +129,7 @@ void PsychSetupVertexColorArrays(PsychWindowRecordType *windowRecord, psych_bool
         }
         else {
             // Standard path:
-            if (colors)     glColorPointer(mc, PSYCHGLFLOAT, 0, colors);
+            if (colors)     glColorPointer(mc, colortype, 0, colors);
             if (bytecolors) glColorPointer(mc, GL_UNSIGNED_BYTE, 0, bytecolors);
 
             glEnableClientState(GL_COLOR_ARRAY);
@@ -140,50 +154,54 @@ void PsychSetupVertexColorArrays(PsychWindowRecordType *windowRecord, psych_bool
 
 /* PsychSetArrayColor()
  * Helper routine, called from the different batch drawing functions of Screen():
+ *
+ * The color is also kept as normalized RGBA in currentColor, for immediate mode emulation
+ * and instanced disc batches, which pass it along with their vertices or per disc attributes.
  */
 static GLdouble currentColor[4];
 void PsychSetArrayColor(PsychWindowRecordType *windowRecord, int i, int mc, double* colors, unsigned char *bytecolors)
 {
     psych_bool isgles = !PsychIsGLClassic(windowRecord);
-
-    if ((windowRecord->defaultDrawShader) || isgles) {
-        // Draw shader assigned or OpenGL-ES in use. Need to feed color values into high-precision
-        // alternative channel for unclamped, high-precision color handling:
-        if (mc==3) {
-            i = i * 3;
-            if (colors) {
-                // RGB double:
-                currentColor[0]=colors[i++];
-                currentColor[1]=colors[i++];
-                currentColor[2]=colors[i++];
-                currentColor[3]=1.0;
-            }
-            else {
-                // RGB uint8:
-                currentColor[0]=((double) bytecolors[i++] / 255.0);
-                currentColor[1]=((double) bytecolors[i++] / 255.0);
-                currentColor[2]=((double) bytecolors[i++] / 255.0);
-                currentColor[3]=1.0;
-            }
+    int j = i;
+
+    if (mc==3) {
+        j = j * 3;
+        if (colors) {
+            // RGB double:
+            currentColor[0]=colors[j++];
+            currentColor[1]=colors[j++];
+            currentColor[2]=colors[j++];
+            currentColor[3]=1.0;
         }
         else {
-            i = i * 4;
-            if (colors) {
-                // RGBA double:
-                currentColor[0]=colors[i++];
-                currentColor[1]=colors[i++];
-                currentColor[2]=colors[i++];
-                currentColor[3]=colors[i++];
-            }
-            else {
-                // RGBA uint8:
-                currentColor[0]=((double) bytecolors[i++] / 255.0);
-                currentColor[1]=((double) bytecolors[i++] / 255.0);
-                currentColor[2]=((double) bytecolors[i++] / 255.0);
-                currentColor[3]=((double) bytecolors[i++] / 255.0);
-            }
+            // RGB uint8:
+            currentColor[0]=((double) bytecolors[j++] / 255.0);
+            currentColor[1]=((double) bytecolors[j++] / 255.0);
+            currentColor[2]=((double) bytecolors[j++] / 255.0);
+            currentColor[3]=1.0;
+        }
+    }
+    else {
+        j = j * 4;
+        if (colors) {
+            // RGBA double:
+            currentColor[0]=colors[j++];
+            currentColor[1]=colors[j++];
+            currentColor[2]=colors[j++];
+            currentColor[3]=colors[j++];
+        }
+        else {
+            // RGBA uint8:
+            currentColor[0]=((double) bytecolors[j++] / 255.0);
+            currentColor[1]=((double) bytecolors[j++] / 255.0);
+            currentColor[2]=((double) bytecolors[j++] / 255.0);
+            currentColor[3]=((double) bytecolors[j++] / 255.0);
         }
+    }
 
+    if ((windowRecord->defaultDrawShader) || isgles) {
+        // Draw shader assigned or OpenGL-ES in use. Need to feed color values into high-precision
+        // alternative channel for unclamped, high-precision color handling:
         if (isgles) {
             // GLES can only do glColor4f(), nothing else:
             glColor4f((float) currentColor[0], (float) currentColor[1], (float) currentColor[2], (float) currentColor[3]);
@@ -393,6 +411,151 @@ GLdouble *PsychExtractQuadVertexFromRect(double *rect, int vertexNumber, GLdoubl
     return(vertex);
 }
 
+/* Color conversion kernels for PsychPrepareRenderBatch(): Scaling of double or float color vectors
+ * by a normalization factor, and padding of RGB color vectors to RGBA with an opaque alpha channel.
+ * They use SSE2 on x86 and NEON on ARM, and plain C elsewhere and for the tails of the vectors.
+ */
+static void PsychScaleColorsDouble(const double* in, double* out, size_t count, double factor)
+{
+    size_t i = 0;
+
+    #if defined(PSYCH_COLORCONV_SSE2)
+    const __m128d f = _mm_set1_pd(factor);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_pd(out + i,     _mm_mul_pd(_mm_loadu_pd(in + i),     f));
+        _mm_storeu_pd(out + i + 2, _mm_mul_pd(_mm_loadu_pd(in + i + 2), f));
+    }
+    #elif defined(PSYCH_COLORCONV_NEON) && defined(__aarch64__)
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f64(out + i,     vmulq_n_f64(vld1q_f64(in + i),     factor));
+        vst1q_f64(out + i + 2, vmulq_n_f64(vld1q_f64(in + i + 2), factor));
+    }
+    #endif
+
+    for (; i < count; i++) out[i] = in[i] * factor;
+}
+
+static void PsychScaleColorsFloat(const float* in, float* out, size_t count, float factor)
+{
+    size_t i = 0;
+
+    #if defined(PSYCH_COLORCONV_SSE2)
+    const __m128 f = _mm_set1_ps(factor);
+    for (; i + 8 <= count; i += 8) {
+        _mm_storeu_ps(out + i,     _mm_mul_ps(_mm_loadu_ps(in + i),     f));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_loadu_ps(in + i + 4), f));
+    }
+    #elif defined(PSYCH_COLORCONV_NEON)
+    for (; i + 8 <= count; i += 8) {
+        vst1q_f32(out + i,     vmulq_n_f32(vld1q_f32(in + i),     factor));
+        vst1q_f32(out + i + 4, vmulq_n_f32(vld1q_f32(in + i + 4), factor));
+    }
+    #endif
+
+    for (; i < count; i++) out[i] = in[i] * factor;
+}
+
+// Scale 'nc' RGB float colors by 'factor' and store them as RGBA with alpha 1.0:
+static void PsychPadColorsFloat(const float* in, float* out, size_t nc, float factor)
+{
+    size_t i = 0;
+
+    #if defined(PSYCH_COLORCONV_SSE2)
+    // Four RGB colors per iteration, from three vectors a = r0g0b0r1, b = g1b1r2g2, c = b2r3g3b3:
+    const __m128 f = _mm_set1_ps(factor);
+    const __m128 rgbmask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    const __m128 alpha = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+    __m128 a, b, c, t;
+
+    for (; i + 4 <= nc; i += 4, in += 12, out += 16) {
+        a = _mm_mul_ps(_mm_loadu_ps(in), f);
+        b = _mm_mul_ps(_mm_loadu_ps(in + 4), f);
+        c = _mm_mul_ps(_mm_loadu_ps(in + 8), f);
+
+        _mm_storeu_ps(out, _mm_or_ps(_mm_and_ps(a, rgbmask), alpha));
+        t = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 3, 3));
+        t = _mm_shuffle_ps(t, t, _MM_SHUFFLE(3, 3, 2, 0));
+        _mm_storeu_ps(out + 4, _mm_or_ps(_mm_and_ps(t, rgbmask), alpha));
+        t = _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 0, 3, 2));
+        _mm_storeu_ps(out + 8, _mm_or_ps(_mm_and_ps(t, rgbmask), alpha));
+        t = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 2, 1));
+        _mm_storeu_ps(out + 12, _mm_or_ps(_mm_and_ps(t, rgbmask), alpha));
+    }
+    #elif defined(PSYCH_COLORCONV_NEON)
+    float32x4x3_t rgb;
+    float32x4x4_t rgba;
+
+    rgba.val[3] = vdupq_n_f32(1.0f);
+    for (; i + 4 <= nc; i += 4, in += 12, out += 16) {
+        rgb = vld3q_f32(in);
+        rgba.val[0] = vmulq_n_f32(rgb.val[0], factor);
+        rgba.val[1] = vmulq_n_f32(rgb.val[1], factor);
+        rgba.val[2] = vmulq_n_f32(rgb.val[2], factor);
+        vst4q_f32(out, rgba);
+    }
+    #endif
+
+    for (; i < nc; i++) {
+        *(out++) = *(in++) * factor;
+        *(out++) = *(in++) * factor;
+        *(out++) = *(in++) * factor;
+        *(out++) = 1.0;
+    }
+}
+
+// Store 'nc' RGB uint8 colors as RGBA with alpha 255:
+static void PsychPadColorsByte(const unsigned char* in, unsigned char* out, size_t nc)
+{
+    size_t i = 0;
+
+    #if defined(PSYCH_COLORCONV_NEON)
+    uint8x16x3_t rgb;
+    uint8x16x4_t rgba;
+
+    rgba.val[3] = vdupq_n_u8(255);
+    for (; i + 16 <= nc; i += 16, in += 48, out += 64) {
+        rgb = vld3q_u8(in);
+        rgba.val[0] = rgb.val[0];
+        rgba.val[1] = rgb.val[1];
+        rgba.val[2] = rgb.val[2];
+        vst4q_u8(out, rgba);
+    }
+    #endif
+
+    for (; i < nc; i++) {
+        *(out++) = *(in++);
+        *(out++) = *(in++);
+        *(out++) = *(in++);
+        *(out++) = 255;
+    }
+}
+
+/* PsychGetRenderBatchScratchBuffer()
+ *
+ * Return the scratch buffer of windowRecord for converted color vectors, with room for at
+ * least 'size' bytes. The buffer is kept until the window gets closed, and grows at least
+ * by a factor of two whenever it is too small, so batch drawing commands which get large
+ * color matrices every frame don't need to allocate and convert into fresh memory each time.
+ * Its content is only valid until the next batch drawing command on the same window.
+ */
+static void* PsychGetRenderBatchScratchBuffer(PsychWindowRecordType *windowRecord, size_t size)
+{
+    size_t newsize;
+
+    if (size > windowRecord->renderBatchScratchSize) {
+        newsize = 2 * windowRecord->renderBatchScratchSize;
+        if (newsize < size) newsize = size;
+
+        free(windowRecord->renderBatchScratch);
+        windowRecord->renderBatchScratchSize = 0;
+        windowRecord->renderBatchScratch = malloc(newsize);
+        if (NULL == windowRecord->renderBatchScratch) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while allocating color conversion buffer for batch drawing!");
+        windowRecord->renderBatchScratchSize = newsize;
+    }
+
+    return(windowRecord->renderBatchScratch);
+}
+
 /* PsychPrepareRenderBatch()
  *
  * Perform setup for a batch of render requests for a specific primitive. Some 2D Screen
@@ -402,18 +565,22 @@ GLdouble *PsychExtractQuadVertexFromRect(double *rect, int vertexNumber, GLdoubl
  * are provided and if it's a single one or multiple ones. It sets up the rendering pipe accordingly,
  * performing required conversion steps. The actual drawing routine just needs to perform primitive
  * specific code.
+ *
+ * Routines which can consume single precision float color vectors pass a non-NULL 'floatcolors'.
+ * These accept single() color matrices also on desktop OpenGL, and *floatcolors tells if *colors
+ * points to float instead of double values. Color matrices of uint8 type, or single() or double()
+ * matrices with a color range of 1, are passed through without any conversion. Other color vectors
+ * get converted into a scratch buffer of the window.
  */
-void PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos, int* coords_count, double** xy, int colors_pos, int* colors_count, int* colorcomponent_count, double** colors, unsigned char** bytecolors, int sizes_pos, int* sizes_count, double** size, psych_bool usefloat)
+void PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos, int* coords_count, double** xy, int colors_pos, int* colors_count, int* colorcomponent_count, double** colors, unsigned char** bytecolors, int sizes_pos, int* sizes_count, double** size, psych_bool usefloat, psych_bool* floatcolors)
 {
     PsychColorType      color;
     int                 m,n,p,mc,nc,pc;
     int                 i, nrpoints, nrsize;
     psych_bool          isArgThere, isdoublecolors, isuint8colors, usecolorvector, needxy;
-    double              *tmpcolors, *pcolors, *tcolors;
-    double              convfactor, whiteValue;
-    float               *pcolorsf, *tcolorsf;
-    float               convfactorf;
-    unsigned char       *pcolorsb, *tcolorsb;
+    psych_bool          isfloatcolors = FALSE;
+    double              *tmpcolors;
+    double              whiteValue;
 
     needxy = (coords_pos > 0) ? TRUE: FALSE;
     coords_pos = abs(coords_pos);
@@ -491,9 +658,15 @@ void PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos
     }
     else {
         // Some color argument provided. Check first, if it's a valid color vector:
+        isfloatcolors = usefloat;
         if (usefloat) {
             isdoublecolors = PsychAllocInFloatMatArg(colors_pos, kPsychArgAnything, &mc, &nc, &pc, (float**) colors);
         }
+        else if (floatcolors && (PsychGetArgType(colors_pos) == PsychArgType_single)) {
+            // Desktop OpenGL, but caller can handle single precision float colors: Take them as they are:
+            isdoublecolors = PsychAllocInFloatMatArg(colors_pos, kPsychArgAnything, &mc, &nc, &pc, (float**) colors);
+            isfloatcolors = TRUE;
+        }
         else {
             isdoublecolors = PsychAllocInDoubleMatArg(colors_pos, kPsychArgAnything, &mc, &nc, &pc, colors);
         }
@@ -509,87 +682,35 @@ void PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos
             usecolorvector=true;
 
             if (isdoublecolors) {
-                if (fabs(windowRecord->colorRange)!=1) {
-                    // We have to loop through the vector and divide all values by windowRecord->colorRange, so the input values
-                    // 0-colorRange get mapped to the range 0.0-1.0, as OpenGL expects values in range 0-1 when
-                    // a color vector is passed in Double- or Float format.
-                    // This is inefficient, as it burns some cpu-cycles, but necessary to keep color
-                    // specifications consistent in the PTB - API.
-                    if (usefloat) {
-                        // OpenGL-ES 1 code path: Color arrays must have 4 component RGBA spec in
-                        // single precision float format. Make it so:
-                        convfactorf = (float) (1.0 / fabs(windowRecord->colorRange));
-                        tmpcolors = PsychMallocTemp(sizeof(float) * nc * 4);
-                        pcolorsf = (float*) *colors;
-                        tcolorsf = (float*) tmpcolors;
-                        if (mc == 4) {
-                            // 4 channel RGBA input: Normalize.
-                            for (i=0; i<(nc*mc); i++) {
-                                *(tcolorsf++) = *(pcolorsf++) * convfactorf;
-                            }
-                        }
-                        else {
-                            // 3 channel RGB input: Normalize RGB, add a 1.0 alpha channel:
-                            for (i=0; i < nc; i++) {
-                                *(tcolorsf++) = *(pcolorsf++) * convfactorf;
-                                *(tcolorsf++) = *(pcolorsf++) * convfactorf;
-                                *(tcolorsf++) = *(pcolorsf++) * convfactorf;
-                                *(tcolorsf++) = 1.0;
-                            }
-                        }
-                    }
-                    else {
-                        // Desktop OpenGL:
-                        convfactor = 1.0 / fabs(windowRecord->colorRange);
-                        tmpcolors=PsychMallocTemp(sizeof(double) * nc * mc);
-                        pcolors = *colors;
-                        tcolors = tmpcolors;
-                        for (i=0; i<(nc*mc); i++) {
-                            *(tcolors++)=(*pcolors++) * convfactor;
-                        }
-                    }
-                }
-                else {
-                    // colorRange is == 1 --> No remapping needed as colors are already in proper range.
+                // We have to divide all values by windowRecord->colorRange, so the input values 0-colorRange
+                // get mapped to the range 0.0-1.0, as OpenGL expects values in range 0-1 when a color vector
+                // is passed in Double- or Float format. OpenGL-ES 1 color arrays must have 4 component RGBA
+                // spec in single precision float format, so RGB input needs an added 1.0 alpha channel there.
+                // Otherwise, with a colorRange of 1, colors are already in proper range and get used as is:
+                if (isfloatcolors && ((usefloat && (mc == 3)) || (fabs(windowRecord->colorRange) != 1))) {
+                    tmpcolors = (double*) PsychGetRenderBatchScratchBuffer(windowRecord, sizeof(float) * (size_t) nc * ((usefloat) ? 4 : mc));
                     if (usefloat && (mc == 3)) {
-                        // OpenGL-ES 1 and only 3 channel RGB input: Extend to RGBA:
-                        tmpcolors = PsychMallocTemp(sizeof(float) * nc * 4);
-                        pcolorsf = (float*) *colors;
-                        tcolorsf = (float*) tmpcolors;
-
-                        // 3 channel RGB input: Add a 1.0 alpha channel:
-                        for (i = 0; i < nc; i++) {
-                            *(tcolorsf++) = *(pcolorsf++);
-                            *(tcolorsf++) = *(pcolorsf++);
-                            *(tcolorsf++) = *(pcolorsf++);
-                            *(tcolorsf++) = 1.0;
-                        }
+                        PsychPadColorsFloat((float*) *colors, (float*) tmpcolors, (size_t) nc, (float) (1.0 / fabs(windowRecord->colorRange)));
                     }
                     else {
-                        // Desktop OpenGL: Just setup pointer to our unaltered input color vector:
-                        tmpcolors=*colors;
+                        PsychScaleColorsFloat((float*) *colors, (float*) tmpcolors, (size_t) nc * mc, (float) (1.0 / fabs(windowRecord->colorRange)));
                     }
+                    *colors = tmpcolors;
+                }
+                else if (!isfloatcolors && (fabs(windowRecord->colorRange) != 1)) {
+                    tmpcolors = (double*) PsychGetRenderBatchScratchBuffer(windowRecord, sizeof(double) * (size_t) nc * mc);
+                    PsychScaleColorsDouble(*colors, tmpcolors, (size_t) nc * mc, 1.0 / fabs(windowRecord->colorRange));
+                    *colors = tmpcolors;
                 }
-
-                *colors = tmpcolors;
             }
             else {
                 // Color vector in uint8 format. Nothing to do, unless this is OpenGL-ES 1 and
                 // input is only RGB instead of required RGBA:
+                isfloatcolors = FALSE;
                 if (usefloat && (mc == 3)) {
-                    // OpenGL-ES 1 and only 3 channel RGB input: Extend to RGBA:
-                    tmpcolors = PsychMallocTemp(nc * 4);
-                    pcolorsb = *bytecolors;
-                    tcolorsb = (unsigned char*) tmpcolors;
-
-                    // 3 channel RGB input: Add a 1.0 aka 255 alpha channel:
-                    for (i = 0; i < nc; i++) {
-                        *(tcolorsb++) = *(pcolorsb++);
-                        *(tcolorsb++) = *(pcolorsb++);
-                        *(tcolorsb++) = *(pcolorsb++);
-                        *(tcolorsb++) = 255;
-                    }
-
+                    // OpenGL-ES 1 and only 3 channel RGB input: Extend to RGBA with a 1.0 aka 255 alpha channel:
+                    tmpcolors = (double*) PsychGetRenderBatchScratchBuffer(windowRecord, (size_t) nc * 4);
+                    PsychPadColorsByte(*bytecolors, (unsigned char*) tmpcolors, (size_t) nc);
                     *bytecolors = (unsigned char*) tmpcolors;
                 }
             }
@@ -624,6 +745,8 @@ void PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos
     }
     *colorcomponent_count = mc;
 
+    if (floatcolors) *floatcolors = (usecolorvector && isfloatcolors) ? TRUE : FALSE;
+
     return;
 }
 
@@ -834,41 +957,462 @@ void PsychGLRectd(PsychWindowRecordType *windowRecord, double x1, double y1, dou
     GLEND();
 }
 
-/* A rather lame implementation of gluDisc() - OpenGL-ES compatible, but as inefficient as
-* it gets. Good enough for a start though...
+#ifndef M_PI
+#define M_PI 3.141592654
+#endif
+
+/* PsychGetUnitCircleTable() - Return table of numSlices + 1 (cos, sin) pairs for a full
+* clock-wise sweep over the unit circle in 'numSlices' steps, starting upward.
 *
-* Thinking about this was avoided by adapting freely available sample code from Thomas Visser:
-* http://www.cocos2d-iphone.org/forum/topic/2207
+* Tables are computed once per window and slice count and then cached in the windowRecord,
+* recycling the least recently computed table if more than kPsychMaxUnitCircleTables different
+* slice counts are in use. Returns NULL if out of memory.
+*/
+static const float* PsychGetUnitCircleTable(PsychWindowRecordType *windowRecord, int numSlices)
+{
+    float *table;
+    double rads;
+    int i, slot;
+
+    for (slot = 0; slot < kPsychMaxUnitCircleTables; slot++) {
+        if (windowRecord->unitCircleTable[slot] && (windowRecord->unitCircleSlices[slot] == numSlices))
+            return(windowRecord->unitCircleTable[slot]);
+    }
+
+    // Not yet cached: Compute the table and store it in the next slot:
+    table = (float*) malloc((numSlices + 1) * 2 * sizeof(float));
+    if (NULL == table) return(NULL);
+
+    for (i = 0; i <= numSlices; i++) {
+        rads = M_PI / 2 - (double) i * 2 * M_PI / (double) numSlices;
+        table[2 * i]     = (float) cos(rads);
+        table[2 * i + 1] = (float) sin(rads);
+    }
+
+    slot = windowRecord->unitCircleNextSlot;
+    free(windowRecord->unitCircleTable[slot]);
+    windowRecord->unitCircleTable[slot] = table;
+    windowRecord->unitCircleSlices[slot] = numSlices;
+    windowRecord->unitCircleNextSlot = (slot + 1) % kPsychMaxUnitCircleTables;
+
+    return(table);
+}
+
+/* Shaders for instanced drawing of disc batches: Each instance is one disc, drawn as triangle strip
+* from a shared unit circle vertex buffer. Per vertex attribute circleVertex is the (cos, sin) pair
+* of a slice on the unit circle for 'tableSlices' slices, the slice index, and 1 for the outer or 0
+* for the inner radius. Per disc attributes are the center and x/y scale, the inner and outer radius,
+* start and arc angle, slice count and color. Discs which don't use the unit circle of the buffer, ie.
+* arcs or discs with a different slice count, get their vertex directions computed in the shader.
+* Slice indices beyond the discs slice count collapse into degenerate triangles at the end of the arc.
+* Colors are passed as is in unclamped color mode, and clamped like fixed function colors otherwise.
+*/
+static char DiscInstanceVertexShaderSrc[] =
+"attribute vec4 circleVertex;\n"
+"attribute vec4 discCenterScale;\n"
+"attribute vec4 discShape;\n"
+"attribute float discSlices;\n"
+"attribute vec4 discColor;\n"
+"uniform int useUnclampedFragColor;\n"
+"uniform float tableSlices;\n"
+"varying vec4 unclampedFragColor;\n"
+"\n"
+"void main()\n"
+"{\n"
+"    vec2 dir;\n"
+"\n"
+"    if ((discSlices == tableSlices) && (discShape.z == 0.0) && (discShape.w == 360.0)) {\n"
+"        dir = circleVertex.xy;\n"
+"    }\n"
+"    else {\n"
+"        float rads = radians(90.0 - discShape.z - discShape.w * min(circleVertex.z, discSlices) / discSlices);\n"
+"        dir = vec2(cos(rads), sin(rads));\n"
+"    }\n"
+"\n"
+"    float radius = (circleVertex.w > 0.0) ? discShape.y : discShape.x;\n"
+"    gl_Position = gl_ModelViewProjectionMatrix * vec4(discCenterScale.xy + discCenterScale.zw * radius * dir, 0.0, 1.0);\n"
+"    unclampedFragColor = (useUnclampedFragColor > 0) ? discColor : clamp(discColor, 0.0, 1.0);\n"
+"}\n\0";
+
+static char DiscInstanceFragmentShaderSrc[] =
+"varying vec4 unclampedFragColor;\n"
+"\n"
+"void main()\n"
+"{\n"
+"    gl_FragColor = unclampedFragColor;\n"
+"}\n\0";
+
+/* OpenGL-ES 3 variants: No fixed function matrices, so the modelview-projection matrix is a uniform: */
+static char DiscInstanceVertexShaderSrcES[] =
+"#version 300 es\n"
+"in vec4 circleVertex;\n"
+"in vec4 discCenterScale;\n"
+"in vec4 discShape;\n"
+"in float discSlices;\n"
+"in vec4 discColor;\n"
+"uniform mat4 modelViewProjectionMatrix;\n"
+"uniform int useUnclampedFragColor;\n"
+"uniform float tableSlices;\n"
+"out vec4 unclampedFragColor;\n"
+"\n"
+"void main()\n"
+"{\n"
+"    vec2 dir;\n"
+"\n"
+"    if ((discSlices == tableSlices) && (discShape.z == 0.0) && (discShape.w == 360.0)) {\n"
+"        dir = circleVertex.xy;\n"
+"    }\n"
+"    else {\n"
+"        float rads = radians(90.0 - discShape.z - discShape.w * min(circleVertex.z, discSlices) / discSlices);\n"
+"        dir = vec2(cos(rads), sin(rads));\n"
+"    }\n"
+"\n"
+"    float radius = (circleVertex.w > 0.0) ? discShape.y : discShape.x;\n"
+"    gl_Position = modelViewProjectionMatrix * vec4(discCenterScale.xy + discCenterScale.zw * radius * dir, 0.0, 1.0);\n"
+"    unclampedFragColor = (useUnclampedFragColor > 0) ? discColor : clamp(discColor, 0.0, 1.0);\n"
+"}\n\0";
+
+static char DiscInstanceFragmentShaderSrcES[] =
+"#version 300 es\n"
+"precision highp float;\n"
+"in vec4 unclampedFragColor;\n"
+"out vec4 fragColor;\n"
+"\n"
+"void main()\n"
+"{\n"
+"    fragColor = unclampedFragColor;\n"
+"}\n\0";
+
+// Number of floats per disc in the instance buffer: Center x, y, scale x, y, inner and outer radius,
+// start and arc angle, slice count, RGBA color:
+#define kPsychDiscInstanceFloats 13
+
+/* PsychSetupDiscInstancing() - Check if disc batches can be drawn instanced, and set it up on first use.
 *
+* Needs instanced draw calls (OpenGL 3.1, GL_ARB_draw_instanced or OpenGL-ES 3) and per instance vertex
+* attributes (OpenGL 3.3, GL_ARB_instanced_arrays or OpenGL-ES 3), and a working shader. The shader and
+* buffers live on the parent window, like the point smooth shader of Screen('DrawDots'). If setup fails
+* once, it is not retried, and all disc batches get drawn as triangle strips instead.
 */
-void PsychDrawDisc(PsychWindowRecordType *windowRecord, float xc, float yc, float innerRadius, float outerRadius, int numSlices, float xScale, float yScale, float startAngle, float arcAngle)
+static psych_bool PsychSetupDiscInstancing(PsychWindowRecordType *windowRecord)
 {
-    float Rads, outerX, outerY, innerX, innerY;
-        int i;
-        #ifndef M_PI
-        #define M_PI 3.141592654
-        #endif
+    static psych_bool nocando = FALSE;
+    PsychWindowRecordType *parentWindowRecord;
+    psych_bool isgles;
+    GLuint shader;
+    GLint status;
+    int oldverbosity;
+
+    parentWindowRecord = PsychGetParentWindow(windowRecord);
+    if (parentWindowRecord->discInstanceShader) return(TRUE);
+    if (nocando) return(FALSE);
+
+    // Instanced draw calls and per instance attributes supported?
+    isgles = PsychIsGLES(windowRecord);
+    if ((isgles && (windowRecord->glApiType < 30)) ||
+        (!isgles && !((GLEW_VERSION_3_1 || GLEW_ARB_draw_instanced) && (GLEW_VERSION_3_3 || GLEW_ARB_instanced_arrays)))) {
+        nocando = TRUE;
+        return(FALSE);
+    }
+
+    // Build the shader, but allow this to silently fail:
+    oldverbosity = PsychPrefStateGet_Verbosity();
+    PsychPrefStateSet_Verbosity(0);
+    shader = PsychCreateGLSLProgram((isgles) ? DiscInstanceFragmentShaderSrcES : DiscInstanceFragmentShaderSrc,
+                                    (isgles) ? DiscInstanceVertexShaderSrcES : DiscInstanceVertexShaderSrc, NULL);
+    PsychPrefStateSet_Verbosity(oldverbosity);
+
+    if (shader) {
+        // Bind the per vertex attribute to location 0, as compatibility profiles only draw anything if attribute 0 is enabled:
+        glBindAttribLocation(shader, 0, "circleVertex");
+        glLinkProgram(shader);
+        glGetProgramiv(shader, GL_LINK_STATUS, &status);
+        if (status != GL_TRUE) {
+            glDeleteProgram(shader);
+            shader = 0;
+        }
+    }
+
+    if (!shader) {
+        // Failed. Record this failure so we can avoid retrying at the next disc batch:
+        if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Instanced drawing of ovals unsupported. Using slower fallback path.\n");
+        nocando = TRUE;
+        return(FALSE);
+    }
+
+    glGenBuffers(1, &parentWindowRecord->discVertexBuffer);
+    glGenBuffers(1, &parentWindowRecord->discInstanceBuffer);
+    parentWindowRecord->discVertexBufferSlices = 0;
+    parentWindowRecord->discInstanceShader = shader;
+
+    return(TRUE);
+}
+
+/* PsychDrawDiscInstances() - Draw all discs of an instanced batch in one instanced draw call. */
+static void PsychDrawDiscInstances(PsychWindowRecordType *windowRecord, PsychDiscBatchType *batch)
+{
+    PsychWindowRecordType *parentWindowRecord = PsychGetParentWindow(windowRecord);
+    GLuint shader = parentWindowRecord->discInstanceShader;
+    GLint centerScaleAttrib, shapeAttrib, slicesAttrib, colorAttrib;
+    GLfloat proj[16], modelview[16], mvp[16];
+    const float *table;
+    float *vertices;
+    int i, j, numVertices;
+
+    if (batch->numInstances == 0) return;
+
+    // Build unit circle vertex buffer for this batch's maximum slice count, unless it is already there:
+    numVertices = 2 * (batch->maxSlices + 1);
+    glBindBuffer(GL_ARRAY_BUFFER, parentWindowRecord->discVertexBuffer);
+    if (parentWindowRecord->discVertexBufferSlices != batch->maxSlices) {
+        table = PsychGetUnitCircleTable(windowRecord, batch->maxSlices);
+        if (NULL == table) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while drawing ovals!");
+
+        vertices = (float*) PsychMallocTemp(numVertices * 4 * sizeof(float));
+        for (i = 0; i <= batch->maxSlices; i++) {
+            for (j = 0; j < 2; j++) {
+                vertices[8 * i + 4 * j + 0] = table[2 * i];
+                vertices[8 * i + 4 * j + 1] = table[2 * i + 1];
+                vertices[8 * i + 4 * j + 2] = (float) i;
+                vertices[8 * i + 4 * j + 3] = (j == 0) ? 1.0f : 0.0f;
+            }
+        }
+
+        glBufferData(GL_ARRAY_BUFFER, numVertices * 4 * sizeof(float), vertices, GL_STATIC_DRAW);
+        parentWindowRecord->discVertexBufferSlices = batch->maxSlices;
+    }
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, NULL);
+    glEnableVertexAttribArray(0);
+
+    // Upload per disc attributes and set them up to advance once per instance:
+    centerScaleAttrib = glGetAttribLocation(shader, "discCenterScale");
+    shapeAttrib = glGetAttribLocation(shader, "discShape");
+    slicesAttrib = glGetAttribLocation(shader, "discSlices");
+    colorAttrib = glGetAttribLocation(shader, "discColor");
+
+    glBindBuffer(GL_ARRAY_BUFFER, parentWindowRecord->discInstanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, batch->numInstances * kPsychDiscInstanceFloats * sizeof(float), batch->instances, GL_STREAM_DRAW);
+    glVertexAttribPointer(centerScaleAttrib, 4, GL_FLOAT, GL_FALSE, kPsychDiscInstanceFloats * sizeof(float), (const GLvoid*) (0 * sizeof(float)));
+    glVertexAttribPointer(shapeAttrib, 4, GL_FLOAT, GL_FALSE, kPsychDiscInstanceFloats * sizeof(float), (const GLvoid*) (4 * sizeof(float)));
+    glVertexAttribPointer(slicesAttrib, 1, GL_FLOAT, GL_FALSE, kPsychDiscInstanceFloats * sizeof(float), (const GLvoid*) (8 * sizeof(float)));
+    glVertexAttribPointer(colorAttrib, 4, GL_FLOAT, GL_FALSE, kPsychDiscInstanceFloats * sizeof(float), (const GLvoid*) (9 * sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glEnableVertexAttribArray(centerScaleAttrib);
+    glEnableVertexAttribArray(shapeAttrib);
+    glEnableVertexAttribArray(slicesAttrib);
+    glEnableVertexAttribArray(colorAttrib);
+
+    if (glVertexAttribDivisor) {
+        glVertexAttribDivisor(centerScaleAttrib, 1);
+        glVertexAttribDivisor(shapeAttrib, 1);
+        glVertexAttribDivisor(slicesAttrib, 1);
+        glVertexAttribDivisor(colorAttrib, 1);
+    }
+    else {
+        glVertexAttribDivisorARB(centerScaleAttrib, 1);
+        glVertexAttribDivisorARB(shapeAttrib, 1);
+        glVertexAttribDivisorARB(slicesAttrib, 1);
+        glVertexAttribDivisorARB(colorAttrib, 1);
+    }
+
+    PsychSetShader(windowRecord, shader);
+    glUniform1i(glGetUniformLocation(shader, "useUnclampedFragColor"), (windowRecord->defaultDrawShader) ? 1 : 0);
+    glUniform1f(glGetUniformLocation(shader, "tableSlices"), (float) batch->maxSlices);
+
+    if (PsychIsGLES(windowRecord)) {
+        // mvp = proj * modelview, all column-major:
+        glGetFloatv(GL_PROJECTION_MATRIX, proj);
+        glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+        for (i = 0; i < 4; i++) {
+            for (j = 0; j < 4; j++) {
+                mvp[4 * j + i] = proj[i] * modelview[4 * j] + proj[4 + i] * modelview[4 * j + 1] +
+                                 proj[8 + i] * modelview[4 * j + 2] + proj[12 + i] * modelview[4 * j + 3];
+            }
+        }
+        glUniformMatrix4fv(glGetUniformLocation(shader, "modelViewProjectionMatrix"), 1, GL_FALSE, mvp);
+    }
+
+    if (glDrawArraysInstanced) {
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, numVertices, batch->numInstances);
+    }
+    else {
+        glDrawArraysInstancedARB(GL_TRIANGLE_STRIP, 0, numVertices, batch->numInstances);
+    }
+
+    // Back to the default draw shader, as set up by PsychPrepareRenderBatch(), and default attribute state:
+    PsychSetShader(windowRecord, -1);
+
+    if (glVertexAttribDivisor) {
+        glVertexAttribDivisor(centerScaleAttrib, 0);
+        glVertexAttribDivisor(shapeAttrib, 0);
+        glVertexAttribDivisor(slicesAttrib, 0);
+        glVertexAttribDivisor(colorAttrib, 0);
+    }
+    else {
+        glVertexAttribDivisorARB(centerScaleAttrib, 0);
+        glVertexAttribDivisorARB(shapeAttrib, 0);
+        glVertexAttribDivisorARB(slicesAttrib, 0);
+        glVertexAttribDivisorARB(colorAttrib, 0);
+    }
 
-    // Sweep clock-wise over arcAngle degrees, split up into 'numSlices' steps:
-    float step = (float) ((arcAngle * 2 * M_PI / 360) / (float) numSlices);
+    glDisableVertexAttribArray(0);
+    glDisableVertexAttribArray(centerScaleAttrib);
+    glDisableVertexAttribArray(shapeAttrib);
+    glDisableVertexAttribArray(slicesAttrib);
+    glDisableVertexAttribArray(colorAttrib);
 
-    // Start at startAngle degrees, where 0 deg. = Upward, 90 deg. = Rightward.
-    startAngle = (float) (M_PI/2 - startAngle * 2 * M_PI / 360);
+    batch->numInstances = 0;
+    batch->maxSlices = 0;
+}
+
+/* PsychDrawDiscBatchBegin() - Start a batch of up to 'maxDiscs' discs.
+*
+* All PsychDrawDisc() calls until the matching PsychDrawDiscBatchEnd() are drawn in one draw call.
+* If supported, discs only get their parameters recorded, and get drawn with one instanced draw
+* call of a shared unit circle, with vertices computed by a shader. Otherwise they are appended to
+* one single triangle strip, with consecutive discs joined by degenerate triangles.
+* Only color changes via PsychSetArrayColor() and no other OpenGL calls are allowed inside
+* a batch. The batch state lives in the callers 'batch' struct, so no batch state survives
+* the calling Screen function, even if it aborts with an error.
+*/
+void PsychDrawDiscBatchBegin(PsychWindowRecordType *windowRecord, PsychDiscBatchType *batch, int maxDiscs)
+{
+    batch->vertices = 0;
+    batch->instances = NULL;
+    batch->numInstances = 0;
+    batch->maxInstances = 0;
+    batch->maxSlices = 0;
+
+    if ((maxDiscs > 0) && PsychSetupDiscInstancing(windowRecord)) {
+        batch->instances = (float*) PsychMallocTemp(maxDiscs * kPsychDiscInstanceFloats * sizeof(float));
+        batch->maxInstances = maxDiscs;
+
+        // Start with the common color for all discs, as set up by PsychPrepareRenderBatch():
+        memcpy(currentColor, windowRecord->currentColor, sizeof(currentColor));
+        return;
+    }
 
     GLBEGIN(GL_TRIANGLE_STRIP);
-        for (i = 0; i <= numSlices; i++) {
-            // calculating the current vertice on the outer side of the segment
-            Rads = startAngle - i * step;
-            outerX = xScale * outerRadius * (float) cos( Rads );
-            outerY = yScale * outerRadius * (float) sin( Rads );
-            GLVERTEX2f(xc + outerX, yc + outerY);
+}
 
-            // calculating the current vertice on the inner side of the segment
-            innerX = xScale * innerRadius * (float) cos( Rads );
-            innerY = yScale * innerRadius * (float) sin( Rads );
-            GLVERTEX2f(xc + innerX, yc + innerY);
+void PsychDrawDiscBatchEnd(PsychWindowRecordType *windowRecord, PsychDiscBatchType *batch)
+{
+    if (batch->instances) {
+        PsychDrawDiscInstances(windowRecord, batch);
+    }
+    else {
+        GLEND();
+    }
+
+    batch->vertices = 0;
+}
+
+/* A rather lame implementation of gluDisc() - OpenGL-ES compatible. Originally adapted from
+* freely available sample code from Thomas Visser:
+* http://www.cocos2d-iphone.org/forum/topic/2207
+*
+* Full discs and rings use the cached unit circle table for 'numSlices', arcs of other angles
+* get their vertices via an incremental rotation, so no trigonometry is needed per slice.
+* 'batch' is the batch to append the disc to, or NULL to draw the disc on its own. In an
+* instanced batch, only the disc parameters and current color get recorded.
+*/
+void PsychDrawDisc(PsychWindowRecordType *windowRecord, PsychDiscBatchType *batch, float xc, float yc, float innerRadius, float outerRadius, int numSlices, float xScale, float yScale, float startAngle, float arcAngle)
+{
+    const float *table = NULL;
+    double c, s, dc, ds, t, rads, step;
+    float outerX, outerY, innerX, innerY;
+    float *instance;
+    int i;
+
+    if (numSlices < 1) return;
+
+    if (batch && batch->instances) {
+        // Instanced batch full? Draw what we have so far:
+        if (batch->numInstances == batch->maxInstances) PsychDrawDiscInstances(windowRecord, batch);
+
+        instance = &batch->instances[batch->numInstances * kPsychDiscInstanceFloats];
+        instance[0] = xc;
+        instance[1] = yc;
+        instance[2] = xScale;
+        instance[3] = yScale;
+        instance[4] = innerRadius;
+        instance[5] = outerRadius;
+        instance[6] = startAngle;
+        instance[7] = arcAngle;
+        instance[8] = (float) numSlices;
+        for (i = 0; i < 4; i++) instance[9 + i] = (float) currentColor[i];
+
+        batch->numInstances++;
+        if (numSlices > batch->maxSlices) batch->maxSlices = numSlices;
+        return;
+    }
+
+    // Full circle starting upward? Use the precomputed unit circle table:
+    if ((arcAngle == 360) && (startAngle == 0))
+        table = PsychGetUnitCircleTable(windowRecord, numSlices);
+
+    // Sweep clock-wise over arcAngle degrees, split up into 'numSlices' steps,
+    // starting at startAngle degrees, where 0 deg. = Upward, 90 deg. = Rightward.
+    // Setup the incremental rotation for the table-less case:
+    step = (arcAngle * 2 * M_PI / 360) / (double) numSlices;
+    rads = M_PI / 2 - startAngle * 2 * M_PI / 360;
+    c = cos(rads);
+    s = sin(rads);
+    dc = cos(step);
+    ds = sin(step);
+
+    if (batch) {
+        // Not enough room left in the immediate mode emulation buffer for this disc? Submit the batch so far:
+        if (!PsychIsGLClassic(windowRecord) && (batch->vertices > 0) &&
+            (gl_buffer_index + (unsigned int) (2 * numSlices + 4) * 4 * 3 > PSYCH_MAX_IMMSIM_VERTEX_COMPONENTS)) {
+            GLEND();
+            GLBEGIN(GL_TRIANGLE_STRIP);
+            batch->vertices = 0;
         }
-    GLEND();
+    }
+    else {
+        GLBEGIN(GL_TRIANGLE_STRIP);
+    }
+
+    for (i = 0; i <= numSlices; i++) {
+        if (table) {
+            c = table[2 * i];
+            s = table[2 * i + 1];
+        }
+        else if (i > 0) {
+            // Rotate clock-wise by one step:
+            t = c * dc + s * ds;
+            s = s * dc - c * ds;
+            c = t;
+        }
+
+        // calculating the current vertice on the outer side of the segment
+        outerX = xScale * outerRadius * (float) c;
+        outerY = yScale * outerRadius * (float) s;
+
+        // Join to previous disc in the batch via degenerate triangles: Repeat its last vertex and our first:
+        if ((i == 0) && batch && (batch->vertices > 0)) {
+            GLVERTEX2f(batch->lastx, batch->lasty);
+            GLVERTEX2f(xc + outerX, yc + outerY);
+        }
+
+        GLVERTEX2f(xc + outerX, yc + outerY);
+
+        // calculating the current vertice on the inner side of the segment
+        innerX = xScale * innerRadius * (float) c;
+        innerY = yScale * innerRadius * (float) s;
+        GLVERTEX2f(xc + innerX, yc + innerY);
+    }
+
+    if (batch) {
+        batch->vertices += 2 * (numSlices + 1);
+        batch->lastx = xc + innerX;
+        batch->lasty = yc + innerY;
+    }
+    else {
+        GLEND();
+    }
 
     return;
 }
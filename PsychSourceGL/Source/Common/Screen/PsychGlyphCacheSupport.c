@@ -0,0 +1,842 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychGlyphCacheSupport.c
+
+    AUTHORS:
+
+    agent               ag      agent@local
+
+    PLATFORMS:
+
+    All. Glyph atlases need the external text renderer plugin, classic desktop OpenGL and
+    framebuffer object support. Otherwise prepared texts get drawn by the regular text renderer.
+
+    HISTORY:
+
+    19.10.2026  ag      Wrote it.
+
+    DESCRIPTION:
+
+    Psychtoolbox functions for prepared text objects, as created by Screen('PrepareText') and
+    drawn by Screen('DrawPreparedText').
+
+    Preparing a text converts it once into a Unicode vector, measures its bounding box, cursor
+    advance and line height, and computes the pen position of each glyph, including kerning.
+    The glyphs themselves get rasterized by the text renderer plugin into a glyph atlas, a
+    texture shared by all prepared texts with the same font, size, style and anti-aliasing
+    setting of the same onscreen window. Drawing then only needs to emit one textured quad per
+    glyph, and Screen('DrawPreparedText') draws all glyphs of all given texts which live in the
+    same atlas in one batched draw call.
+
+    Glyph atlases are packed by a simple shelf packer. If an atlas gets full, it gets cleared
+    and all prepared texts using it will re-rasterize their glyphs on their next draw. The number
+    of atlases is limited, with the least recently used atlas being evicted if a new one is needed.
+
+    Prepared texts which can't use an atlas, e.g., due to lack of the plugin renderer, underlined
+    text, non-identity text transforms, or glyphs too big for an atlas, get drawn by the regular
+    text renderer with their cached Unicode text and font settings instead.
+*/
+
+#include "Screen.h"
+
+// Hard limit and default for number of simultaneously existing glyph atlases:
+#define PSYCH_MAX_GLYPH_ATLASES         64
+#define PSYCH_DEFAULT_GLYPH_ATLASES     8
+
+// Width and height of a glyph atlas in texels, if the GPU supports it:
+#define PSYCH_GLYPH_ATLAS_SIZE          1024
+
+// Empty border in texels around each glyph in an atlas:
+#define PSYCH_GLYPH_PADDING             1
+
+// Maximum number of glyphs per atlas, and size of the glyph hash table, which must be a power of two:
+#define PSYCH_MAX_GLYPHS_PER_ATLAS      4096
+#define PSYCH_GLYPH_HASH_SIZE           8192
+
+typedef struct {
+    unsigned int            codepoint;      // Unicode code point of glyph.
+    int                     x;              // Left texel column of the glyphs cell in the atlas.
+    int                     y;              // Top texel row of the glyphs cell in the atlas, counting from the top.
+    int                     w;              // Width of the cell, zero for glyphs without ink, e.g., spaces.
+    int                     h;              // Height of the cell.
+    int                     xoff;           // Offset of the cells top-left corner from the pen position on
+    int                     yoff;           // the baseline, in pixels, with y-axis pointing downwards.
+    float                   advance;        // Horizontal cursor advance of the glyph when drawn alone.
+} PsychGlyphType;
+
+typedef struct {
+    PsychWindowIndexType    parentIndex;    // Window handle of the onscreen window of the atlas, or 0 if this record is unused.
+    unsigned int            serial;         // Unique id of the current atlas contents. Changes whenever the atlas gets cleared.
+    unsigned int            lastUse;        // Timestamp of last use for LRU eviction.
+    char                    fontName[256];  // Font family, size, style and anti-aliasing mode of all glyphs in this atlas.
+    int                     fontSize;
+    int                     fontStyle;
+    int                     antiAliasing;
+    PsychFBO                *fbo;           // Atlas texture and framebuffer for rasterizing glyphs into it.
+    int                     shelfX;         // Shelf packer state: First free column of the current shelf,
+    int                     shelfY;         // first row of the current shelf,
+    int                     shelfHeight;    // and height of the current shelf.
+    int                     glyphCount;
+    PsychGlyphType          *glyphs;
+    int                     *hash;          // Hash table of glyph index + 1 by code point. 0 = Empty.
+} PsychGlyphAtlasType;
+
+typedef struct {
+    PsychWindowIndexType    parentIndex;    // Window handle of the onscreen window for which the text was prepared.
+    char                    fontName[256];  // Font settings at time of preparation.
+    int                     fontSize;
+    int                     fontStyle;
+    int                     antiAliasing;
+    int                     length;         // Number of characters.
+    double                  *text;          // Unicode text in drawing order.
+    float                   *penX;          // Pen position of each glyph relative to the start of the text.
+    int                     *glyphIndex;    // Index of each glyph in the atlas, valid while atlasSerial matches.
+    int                     atlasSlot;      // Atlas which stores the glyphs, or -1 if none.
+    unsigned int            atlasSerial;
+    float                   bounds[4];      // Bounding box xmin, ymin, xmax, ymax relative to pen position on baseline, y-axis up.
+    float                   xAdvance;
+    double                  textHeight;
+    psych_bool              useFallback;    // Draw via regular text renderer, not via glyph atlas.
+} PsychPreparedTextType;
+
+static PsychGlyphAtlasType glyphAtlasBANK[PSYCH_MAX_GLYPH_ATLASES];
+static int maxGlyphAtlases = PSYCH_DEFAULT_GLYPH_ATLASES;
+static unsigned int glyphAtlasClock = 0;
+static unsigned int glyphAtlasSerial = 0;
+
+static PsychPreparedTextType **preparedTexts = NULL;
+static int preparedTextsCapacity = 0;
+
+// Statistics:
+static psych_uint64 atlasHits = 0;
+static psych_uint64 atlasMisses = 0;
+static psych_uint64 atlasEvictions = 0;
+static psych_uint64 atlasResets = 0;
+static psych_uint64 glyphHits = 0;
+static psych_uint64 glyphMisses = 0;
+static psych_uint64 drawHits = 0;
+static psych_uint64 drawMisses = 0;
+static psych_uint64 fallbackDraws = 0;
+static psych_uint64 batchDraws = 0;
+
+static PsychPreparedTextType* PsychGetPreparedText(int textId)
+{
+    if ((textId < 1) || (textId > preparedTextsCapacity) || (NULL == preparedTexts[textId - 1]))
+        PsychErrorExitMsg(PsychError_user, "Invalid 'textId' provided. No such prepared text!");
+
+    return(preparedTexts[textId - 1]);
+}
+
+/* Assign the font settings of prepared text 'pt' to the text attributes of 'winRec': */
+static void PsychApplyPreparedTextFont(PsychWindowRecordType *winRec, PsychPreparedTextType *pt)
+{
+    snprintf((char*) &(winRec->textAttributes.textFontName[0]), sizeof(winRec->textAttributes.textFontName), "%s", pt->fontName);
+    winRec->textAttributes.textSize = pt->fontSize;
+    winRec->textAttributes.textStyle = pt->fontStyle;
+}
+
+static psych_bool PsychIsIdentityTextTransform(PsychWindowRecordType *winRec)
+{
+    return((winRec->text2DMatrix[0][0] == 1) && (winRec->text2DMatrix[0][1] == 0) && (winRec->text2DMatrix[0][2] == 0) &&
+           (winRec->text2DMatrix[1][0] == 0) && (winRec->text2DMatrix[1][1] == 1) && (winRec->text2DMatrix[1][2] == 0));
+}
+
+static int PsychLookupGlyph(PsychGlyphAtlasType *atlas, unsigned int codepoint)
+{
+    unsigned int i = (codepoint * 2654435761U) & (PSYCH_GLYPH_HASH_SIZE - 1);
+
+    while (atlas->hash[i]) {
+        if (atlas->glyphs[atlas->hash[i] - 1].codepoint == codepoint) return(atlas->hash[i] - 1);
+        i = (i + 1) & (PSYCH_GLYPH_HASH_SIZE - 1);
+    }
+
+    return(-1);
+}
+
+static void PsychInsertGlyph(PsychGlyphAtlasType *atlas, int glyphIndex)
+{
+    unsigned int i = (atlas->glyphs[glyphIndex].codepoint * 2654435761U) & (PSYCH_GLYPH_HASH_SIZE - 1);
+
+    while (atlas->hash[i]) i = (i + 1) & (PSYCH_GLYPH_HASH_SIZE - 1);
+    atlas->hash[i] = glyphIndex + 1;
+}
+
+/* Bind the atlas framebuffer as rendertarget with a pixel-exact projection, bypassing Screen's drawing target management: */
+static void PsychBindGlyphAtlas(PsychWindowRecordType *winRec, PsychGlyphAtlasType *atlas)
+{
+    // Safe-reset the drawing engine, as we use our own framebuffer:
+    PsychSetDrawingTarget((PsychWindowRecordType*) 0x1);
+    PsychSetGLContext(winRec);
+
+    glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, atlas->fbo->fboid);
+    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    PsychSetShader(winRec, 0);
+    glViewport(0, 0, atlas->fbo->width, atlas->fbo->height);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_BLEND);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+}
+
+static void PsychUnbindGlyphAtlas(void)
+{
+    glMatrixMode(GL_MODELVIEW);
+    glPopMatrix();
+    glPopAttrib();
+    glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
+}
+
+/* Remove all glyphs from an atlas, assigning a new serial, so prepared texts notice their glyphs are gone: */
+static void PsychClearGlyphAtlas(PsychWindowRecordType *winRec, PsychGlyphAtlasType *atlas)
+{
+    atlas->serial = ++glyphAtlasSerial;
+    atlas->glyphCount = 0;
+    atlas->shelfX = 0;
+    atlas->shelfY = 0;
+    atlas->shelfHeight = 0;
+    memset(atlas->hash, 0, PSYCH_GLYPH_HASH_SIZE * sizeof(int));
+
+    // Clear to transparent white, so glyph ink is (1,1,1,alpha) everywhere:
+    PsychBindGlyphAtlas(winRec, atlas);
+    glClearColor(1, 1, 1, 0);
+    glClear(GL_COLOR_BUFFER_BIT);
+    PsychUnbindGlyphAtlas();
+}
+
+/* Release an atlas and all its resources. The OpenGL context of its onscreen window must be bound if 'contextBound': */
+static void PsychReleaseGlyphAtlas(PsychGlyphAtlasType *atlas, psych_bool contextBound)
+{
+    PsychWindowRecordType *parent = NULL;
+
+    if (atlas->parentIndex == 0) return;
+
+    if (!contextBound && (FindWindowRecord(atlas->parentIndex, &parent) == PsychError_none)) {
+        PsychSetDrawingTarget((PsychWindowRecordType*) 0x1);
+        PsychSetGLContext(parent);
+        contextBound = TRUE;
+    }
+
+    if (contextBound) PsychDeleteFBO(atlas->fbo);
+    free(atlas->glyphs);
+    free(atlas->hash);
+    memset(atlas, 0, sizeof(PsychGlyphAtlasType));
+}
+
+/* Find the atlas for the font settings of 'pt', or create it, evicting the least recently used atlas if needed: */
+static PsychGlyphAtlasType* PsychGetGlyphAtlas(PsychWindowRecordType *winRec, PsychPreparedTextType *pt)
+{
+    PsychWindowRecordType *parent = PsychGetParentWindow(winRec);
+    PsychGlyphAtlasType *atlas = NULL;
+    int i, size, used = 0, lru = -1;
+
+    for (i = 0; i < PSYCH_MAX_GLYPH_ATLASES; i++) {
+        atlas = &glyphAtlasBANK[i];
+        if (atlas->parentIndex == 0) continue;
+
+        if ((atlas->parentIndex == pt->parentIndex) && (atlas->fontSize == pt->fontSize) && (atlas->fontStyle == pt->fontStyle) &&
+            (atlas->antiAliasing == pt->antiAliasing) && !strcmp(atlas->fontName, pt->fontName)) {
+            atlasHits++;
+            atlas->lastUse = ++glyphAtlasClock;
+            return(atlas);
+        }
+
+        used++;
+        if ((lru < 0) || (atlas->lastUse < glyphAtlasBANK[lru].lastUse)) lru = i;
+    }
+
+    atlasMisses++;
+
+    // Evict least recently used atlas if the limit is reached:
+    if ((used >= maxGlyphAtlases) && (lru >= 0)) {
+        if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Evicting glyph atlas for font '%s' size %i.\n", glyphAtlasBANK[lru].fontName, glyphAtlasBANK[lru].fontSize);
+        PsychReleaseGlyphAtlas(&glyphAtlasBANK[lru], FALSE);
+        atlasEvictions++;
+    }
+
+    for (i = 0; i < PSYCH_MAX_GLYPH_ATLASES; i++) if (glyphAtlasBANK[i].parentIndex == 0) break;
+    if (i >= PSYCH_MAX_GLYPH_ATLASES) return(NULL);
+    atlas = &glyphAtlasBANK[i];
+
+    atlas->glyphs = (PsychGlyphType*) malloc(PSYCH_MAX_GLYPHS_PER_ATLAS * sizeof(PsychGlyphType));
+    atlas->hash = (int*) malloc(PSYCH_GLYPH_HASH_SIZE * sizeof(int));
+    if ((NULL == atlas->glyphs) || (NULL == atlas->hash)) {
+        free(atlas->glyphs);
+        free(atlas->hash);
+        memset(atlas, 0, sizeof(PsychGlyphAtlasType));
+        PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while creating glyph atlas!");
+    }
+
+    // Create atlas texture with framebuffer as GL_TEXTURE_2D:
+    size = (parent->maxTextureSize > 0 && parent->maxTextureSize < PSYCH_GLYPH_ATLAS_SIZE) ? parent->maxTextureSize : PSYCH_GLYPH_ATLAS_SIZE;
+    PsychSetDrawingTarget((PsychWindowRecordType*) 0x1);
+    PsychSetGLContext(winRec);
+    atlas->fbo = NULL;
+    if (!PsychCreateFBO(&atlas->fbo, GL_RGBA8, FALSE, size, size, 0, 1)) {
+        if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: Failed to create glyph atlas texture. Prepared text will be drawn without glyph atlas.\n");
+        if (atlas->fbo) PsychDeleteFBO(atlas->fbo);
+        free(atlas->glyphs);
+        free(atlas->hash);
+        memset(atlas, 0, sizeof(PsychGlyphAtlasType));
+        return(NULL);
+    }
+
+    // Glyphs are drawn texel-exact:
+    glBindTexture(GL_TEXTURE_2D, atlas->fbo->coltexid);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    atlas->parentIndex = pt->parentIndex;
+    snprintf(atlas->fontName, sizeof(atlas->fontName), "%s", pt->fontName);
+    atlas->fontSize = pt->fontSize;
+    atlas->fontStyle = pt->fontStyle;
+    atlas->antiAliasing = pt->antiAliasing;
+    atlas->lastUse = ++glyphAtlasClock;
+    PsychClearGlyphAtlas(winRec, atlas);
+
+    if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Created %i x %i glyph atlas for font '%s' size %i style %i.\n", size, size, atlas->fontName, atlas->fontSize, atlas->fontStyle);
+
+    return(atlas);
+}
+
+/* Find a place for a width x height glyph cell in the atlas. Returns FALSE if it doesn't fit: */
+static psych_bool PsychAllocateGlyphCell(PsychGlyphAtlasType *atlas, int width, int height, int *x, int *y)
+{
+    // Start a new shelf if the glyph doesn't fit onto the current one:
+    if ((atlas->shelfX + width > atlas->fbo->width) || (height > atlas->shelfHeight && atlas->shelfX > 0)) {
+        atlas->shelfY += atlas->shelfHeight;
+        atlas->shelfX = 0;
+        atlas->shelfHeight = 0;
+    }
+
+    if ((width > atlas->fbo->width) || (atlas->shelfY + height > atlas->fbo->height)) return(FALSE);
+
+    *x = atlas->shelfX;
+    *y = atlas->shelfY;
+    atlas->shelfX += width;
+    if (height > atlas->shelfHeight) atlas->shelfHeight = height;
+
+    return(TRUE);
+}
+
+/* Make sure all glyphs of 'pt' are in 'atlas', rasterizing missing ones via plugin context 'ctx'. Returns FALSE if they don't fit: */
+static psych_bool PsychAddGlyphsToAtlas(PsychWindowRecordType *winRec, int ctx, PsychGlyphAtlasType *atlas, PsychPreparedTextType *pt)
+{
+    PsychGlyphType *glyph;
+    int i, idx, newCount = 0;
+    int *newGlyphs = (int*) PsychMallocTemp(pt->length * sizeof(int) + 1);
+    float bounds[4];
+    double codepoint;
+
+    for (i = 0; i < pt->length; i++) {
+        idx = PsychLookupGlyph(atlas, (unsigned int) pt->text[i]);
+        if (idx >= 0) {
+            glyphHits++;
+            pt->glyphIndex[i] = idx;
+            continue;
+        }
+
+        glyphMisses++;
+        if (atlas->glyphCount >= PSYCH_MAX_GLYPHS_PER_ATLAS) return(FALSE);
+
+        idx = atlas->glyphCount;
+        glyph = &atlas->glyphs[idx];
+        memset(glyph, 0, sizeof(PsychGlyphType));
+        glyph->codepoint = (unsigned int) pt->text[i];
+
+        codepoint = pt->text[i];
+        if (PsychMeasureTextWithPlugin(ctx, 1, &codepoint, bounds, &glyph->advance, NULL)) return(FALSE);
+
+        // Glyph with ink? Allocate a cell covering its pixel bounding box plus padding:
+        if ((bounds[2] > bounds[0]) && (bounds[3] > bounds[1])) {
+            glyph->xoff = (int) floor(bounds[0]) - PSYCH_GLYPH_PADDING;
+            glyph->yoff = -((int) ceil(bounds[3])) - PSYCH_GLYPH_PADDING;
+            glyph->w = (int) ceil(bounds[2]) - (int) floor(bounds[0]) + 2 * PSYCH_GLYPH_PADDING;
+            glyph->h = (int) ceil(bounds[3]) - (int) floor(bounds[1]) + 2 * PSYCH_GLYPH_PADDING;
+            if (!PsychAllocateGlyphCell(atlas, glyph->w, glyph->h, &glyph->x, &glyph->y)) return(FALSE);
+            newGlyphs[newCount++] = idx;
+        }
+
+        atlas->glyphCount++;
+        PsychInsertGlyph(atlas, idx);
+        pt->glyphIndex[i] = idx;
+    }
+
+    // Rasterize all new glyphs into the atlas in one go:
+    if (newCount > 0) {
+        PsychBindGlyphAtlas(winRec, atlas);
+        for (i = 0; i < newCount; i++) {
+            glyph = &atlas->glyphs[newGlyphs[i]];
+            codepoint = (double) glyph->codepoint;
+            if (PsychDrawTextWithPluginForAtlas(ctx, atlas->fbo->width, atlas->fbo->height, (double) (glyph->x - glyph->xoff),
+                                                (double) (glyph->y - glyph->yoff), 1, &codepoint)) {
+                PsychUnbindGlyphAtlas();
+                return(FALSE);
+            }
+        }
+        PsychUnbindGlyphAtlas();
+    }
+
+    return(TRUE);
+}
+
+/* Make sure the glyphs of 'pt' are in a glyph atlas. Returns the atlas, or NULL if the text must be drawn without atlas: */
+static PsychGlyphAtlasType* PsychResolvePreparedText(PsychWindowRecordType *winRec, PsychPreparedTextType *pt)
+{
+    PsychTextAttributes savedAttributes;
+    PsychGlyphAtlasType *atlas = NULL;
+    psych_bool ok = FALSE;
+    int ctx;
+
+    if (pt->useFallback) return(NULL);
+
+    // Glyphs still cached in their atlas?
+    if ((pt->atlasSlot >= 0) && (glyphAtlasBANK[pt->atlasSlot].parentIndex != 0) && (glyphAtlasBANK[pt->atlasSlot].serial == pt->atlasSerial)) {
+        glyphAtlasBANK[pt->atlasSlot].lastUse = ++glyphAtlasClock;
+        return(&glyphAtlasBANK[pt->atlasSlot]);
+    }
+
+    // No. (Re-)Rasterize them with the font settings of the prepared text:
+    savedAttributes = winRec->textAttributes;
+    PsychApplyPreparedTextFont(winRec, pt);
+    PsychSetDrawingTarget(winRec);
+    if ((ctx = PsychSetupTextRendererPlugin(winRec)) >= 0) atlas = PsychGetGlyphAtlas(winRec, pt);
+
+    if (atlas) {
+        ok = PsychAddGlyphsToAtlas(winRec, ctx, atlas, pt);
+        if (!ok) {
+            // Atlas full. Clear it and retry once, then give up if the text alone doesn't fit:
+            atlasResets++;
+            PsychClearGlyphAtlas(winRec, atlas);
+            ok = PsychAddGlyphsToAtlas(winRec, ctx, atlas, pt);
+            if (!ok) PsychClearGlyphAtlas(winRec, atlas);
+        }
+    }
+
+    winRec->textAttributes = savedAttributes;
+
+    if (!ok) {
+        if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Prepared text can not use a glyph atlas. Using regular text renderer for it.\n");
+        pt->useFallback = TRUE;
+        pt->atlasSlot = -1;
+        return(NULL);
+    }
+
+    pt->atlasSlot = (int) (atlas - glyphAtlasBANK);
+    pt->atlasSerial = atlas->serial;
+
+    return(atlas);
+}
+
+/* PsychPrepareText()
+ *
+ * Create a prepared text object for the 'stringLengthChars' characters Unicode text 'textUniDoubleString',
+ * using the current font settings of window 'winRec'. Returns the textId handle of the prepared text.
+ */
+int PsychPrepareText(PsychWindowRecordType *winRec, int stringLengthChars, double *textUniDoubleString, int swapTextDirection)
+{
+    PsychPreparedTextType *pt;
+    PsychGlyphAtlasType *atlas;
+    PsychRectType bbox;
+    double xp, yp, theight, xAdvance;
+    float pairBounds[4], pairAdvance, pen;
+    int i, textId, ctx;
+
+    // Find free handle, growing the table if needed:
+    for (textId = 1; textId <= preparedTextsCapacity; textId++) if (NULL == preparedTexts[textId - 1]) break;
+    if (textId > preparedTextsCapacity) {
+        i = (preparedTextsCapacity > 0) ? preparedTextsCapacity * 2 : 256;
+        preparedTexts = (PsychPreparedTextType**) realloc(preparedTexts, i * sizeof(PsychPreparedTextType*));
+        if (NULL == preparedTexts) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while preparing text!");
+        memset(&preparedTexts[preparedTextsCapacity], 0, (i - preparedTextsCapacity) * sizeof(PsychPreparedTextType*));
+        preparedTextsCapacity = i;
+    }
+
+    pt = (PsychPreparedTextType*) calloc(1, sizeof(PsychPreparedTextType));
+    if (pt) {
+        pt->text = (double*) malloc(stringLengthChars * sizeof(double));
+        pt->penX = (float*) malloc(stringLengthChars * sizeof(float));
+        pt->glyphIndex = (int*) malloc(stringLengthChars * sizeof(int));
+    }
+
+    if ((NULL == pt) || (NULL == pt->text) || (NULL == pt->penX) || (NULL == pt->glyphIndex)) {
+        if (pt) { free(pt->text); free(pt->penX); free(pt->glyphIndex); free(pt); }
+        PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while preparing text!");
+    }
+
+    preparedTexts[textId - 1] = pt;
+    pt->parentIndex = PsychGetParentWindow(winRec)->windowIndex;
+    pt->length = stringLengthChars;
+    pt->atlasSlot = -1;
+
+    // Store text in drawing order:
+    for (i = 0; i < stringLengthChars; i++) pt->text[i] = textUniDoubleString[(swapTextDirection) ? stringLengthChars - i - 1 : i];
+
+    // Setup plugin, which also resolves the true font name, then store font settings:
+    PsychSetDrawingTarget(winRec);
+    ctx = PsychSetupTextRendererPlugin(winRec);
+    snprintf(pt->fontName, sizeof(pt->fontName), "%s", (const char*) winRec->textAttributes.textFontName);
+    pt->fontSize = winRec->textAttributes.textSize;
+    pt->fontStyle = winRec->textAttributes.textStyle;
+    pt->antiAliasing = PsychPrefStateGet_TextAntiAliasing();
+
+    // Glyph atlases need the plugin, classic OpenGL and framebuffer objects. Underlines would get broken up at glyph boundaries:
+    if ((ctx < 0) || PsychIsGLES(winRec) || !PsychIsGLClassic(winRec) || !(winRec->gfxcaps & kPsychGfxCapFBO) || (pt->fontStyle & 4))
+        pt->useFallback = TRUE;
+
+    // Measure the whole text once:
+    if (ctx >= 0) {
+        if (PsychMeasureTextWithPlugin(ctx, stringLengthChars, pt->text, pt->bounds, &pt->xAdvance, &pt->textHeight)) {
+            PsychClosePreparedText(textId);
+            PsychErrorExitMsg(PsychError_user, "The external text renderer plugin failed to measure the text string for some reason!");
+        }
+    }
+    else {
+        xp = yp = theight = xAdvance = 0;
+        PsychDrawUnicodeText(winRec, &bbox, stringLengthChars, pt->text, &xp, &yp, &theight, &xAdvance, 1,
+                             &(winRec->textAttributes.textColor), &(winRec->textAttributes.textBackgroundColor), 0);
+        pt->bounds[0] = (float) bbox[kPsychLeft];
+        pt->bounds[1] = (float) -bbox[kPsychBottom];
+        pt->bounds[2] = (float) bbox[kPsychRight];
+        pt->bounds[3] = (float) -bbox[kPsychTop];
+        pt->xAdvance = (float) xAdvance;
+        pt->textHeight = theight;
+    }
+
+    // Rasterize glyphs and compute pen position of each glyph: The advance from glyph i to glyph i+1 is the advance
+    // of the pair, minus the advance of glyph i+1 alone, which includes kerning between both glyphs:
+    if ((atlas = PsychResolvePreparedText(winRec, pt)) != NULL) {
+        ctx = PsychSetupTextRendererPlugin(winRec);
+        pen = 0;
+        for (i = 0; i < stringLengthChars; i++) {
+            pt->penX[i] = pen;
+            if (i < stringLengthChars - 1) {
+                if (PsychMeasureTextWithPlugin(ctx, 2, &pt->text[i], pairBounds, &pairAdvance, NULL))
+                    pairAdvance = atlas->glyphs[pt->glyphIndex[i]].advance + atlas->glyphs[pt->glyphIndex[i + 1]].advance;
+                pen += pairAdvance - atlas->glyphs[pt->glyphIndex[i + 1]].advance;
+            }
+        }
+    }
+
+    return(textId);
+}
+
+/* Return bounding box xmin, ymin, xmax, ymax relative to pen position on baseline, y-axis up, advance and line height of a prepared text: */
+void PsychGetPreparedTextMetrics(int textId, double *bounds, double *xAdvance, double *textHeight)
+{
+    PsychPreparedTextType *pt = PsychGetPreparedText(textId);
+    int i;
+
+    for (i = 0; i < 4; i++) bounds[i] = (double) pt->bounds[i];
+    *xAdvance = (double) pt->xAdvance;
+    *textHeight = pt->textHeight;
+}
+
+/* Draw all batched background rectangles and glyph quads of one atlas: */
+static void PsychFlushGlyphBatch(PsychWindowRecordType *winRec, PsychGlyphAtlasType *atlas, int quadCount, GLfloat *vertices, GLfloat *texcoords,
+                                 int bgCount, GLfloat *bgVertices, GLdouble *colorVector, GLdouble *bgColorVector)
+{
+    GLenum normalSourceBlendFactor, normalDestinationBlendFactor;
+
+    if ((quadCount == 0) && (bgCount == 0)) return;
+
+    PsychSetDrawingTarget(winRec);
+    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+    PsychSetShader(winRec, 0);
+
+    // Same alpha-blending override as for regular text drawing:
+    if (!PsychPrefStateGet_TextAlphaBlending()) {
+        PsychGetAlphaBlendingFactorsFromWindow(winRec, &normalSourceBlendFactor, &normalDestinationBlendFactor);
+        PsychStoreAlphaBlendingFactorsForWindow(winRec, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    PsychUpdateAlphaBlendingFactorLazily(winRec);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+
+    if (bgCount > 0) {
+        glColor4dv(bgColorVector);
+        glVertexPointer(2, GL_FLOAT, 0, bgVertices);
+        glDrawArrays(GL_QUADS, 0, 4 * bgCount);
+    }
+
+    if (quadCount > 0) {
+        // Atlas texels are (1,1,1,coverage), so modulation with the text color gives the same result as the plugin renderer:
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, atlas->fbo->coltexid);
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+        glEnable(GL_ALPHA_TEST);
+        glAlphaFunc(GL_GREATER, 0);
+
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glTexCoordPointer(2, GL_FLOAT, 0, texcoords);
+        glVertexPointer(2, GL_FLOAT, 0, vertices);
+        glColor4dv(colorVector);
+        glDrawArrays(GL_QUADS, 0, 4 * quadCount);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    glPopClientAttrib();
+    glPopAttrib();
+
+    if (!PsychPrefStateGet_TextAlphaBlending()) PsychStoreAlphaBlendingFactorsForWindow(winRec, normalSourceBlendFactor, normalDestinationBlendFactor);
+
+    // Mark end of drawing op. This is needed for single buffered drawing:
+    PsychFlushGL(winRec);
+
+    batchDraws++;
+}
+
+/* PsychDrawPreparedTexts()
+ *
+ * Draw the 'count' prepared texts 'textIds' into window 'winRec'. Text i gets drawn at position x[i], y[i], or x[0], y[0]
+ * if 'nx' or 'ny' is 1. If 'x' or 'y' is NULL, texts get drawn one after another, starting at the current text cursor.
+ * Returns the final text cursor position in 'newX' and 'newY'.
+ */
+void PsychDrawPreparedTexts(PsychWindowRecordType *winRec, int count, int *textIds, double *x, int nx, double *y, int ny,
+                            int yPositionIsBaseline, PsychColorType *textColor, PsychColorType *backgroundColor,
+                            double *newX, double *newY)
+{
+    PsychPreparedTextType *pt;
+    PsychGlyphAtlasType *atlas, *batchAtlas = NULL;
+    PsychGlyphType *glyph;
+    PsychTextAttributes savedAttributes;
+    GLdouble colorVector[4], bgColorVector[4];
+    GLfloat *vertices, *texcoords, *bgVertices, *v, *t;
+    double xp, yp, baseline, theight, xAdvance, u0, v0, u1, v1, gx, gy;
+    int i, j, totalGlyphs, quadCount, bgCount;
+    psych_bool identityTransform;
+    PsychWindowIndexType parentIndex = PsychGetParentWindow(winRec)->windowIndex;
+
+    // Validate all texts first and size the batch buffers:
+    totalGlyphs = 0;
+    for (i = 0; i < count; i++) {
+        pt = PsychGetPreparedText(textIds[i]);
+        if (pt->parentIndex != parentIndex) PsychErrorExitMsg(PsychError_user, "A prepared text can only be drawn into windows which belong to the onscreen window it was prepared for!");
+        totalGlyphs += pt->length;
+    }
+
+    PsychCoerceColorMode(textColor);
+    PsychConvertColorToDoubleVector(textColor, winRec, colorVector);
+    PsychCoerceColorMode(backgroundColor);
+    PsychConvertColorToDoubleVector(backgroundColor, winRec, bgColorVector);
+
+    vertices = (GLfloat*) PsychMallocTemp(totalGlyphs * 8 * sizeof(GLfloat) + 1);
+    texcoords = (GLfloat*) PsychMallocTemp(totalGlyphs * 8 * sizeof(GLfloat) + 1);
+    bgVertices = (GLfloat*) PsychMallocTemp(count * 8 * sizeof(GLfloat) + 1);
+    quadCount = bgCount = 0;
+
+    // Glyph atlases are rasterized untransformed, so transformed text has to go through the regular renderer:
+    identityTransform = PsychIsIdentityTextTransform(winRec);
+
+    xp = winRec->textAttributes.textPositionX;
+    yp = winRec->textAttributes.textPositionY;
+
+    for (i = 0; i < count; i++) {
+        pt = PsychGetPreparedText(textIds[i]);
+        if (x) xp = x[(nx > 1) ? i : 0];
+        if (y) yp = y[(ny > 1) ? i : 0];
+
+        // Glyphs of this text need (re-)rasterization, or live in a different atlas than the current batch? Draw batch first,
+        // as rasterization may clear or evict the atlas of the current batch:
+        atlas = NULL;
+        if (!pt->useFallback && identityTransform) {
+            if ((pt->atlasSlot < 0) || (glyphAtlasBANK[pt->atlasSlot].parentIndex == 0) || (glyphAtlasBANK[pt->atlasSlot].serial != pt->atlasSerial) ||
+                (batchAtlas && (batchAtlas != &glyphAtlasBANK[pt->atlasSlot]))) {
+                PsychFlushGlyphBatch(winRec, batchAtlas, quadCount, vertices, texcoords, bgCount, bgVertices, colorVector, bgColorVector);
+                quadCount = bgCount = 0;
+                batchAtlas = NULL;
+            }
+
+            if ((pt->atlasSlot >= 0) && (glyphAtlasBANK[pt->atlasSlot].parentIndex != 0) && (glyphAtlasBANK[pt->atlasSlot].serial == pt->atlasSerial)) {
+                drawHits++;
+            }
+            else {
+                drawMisses++;
+            }
+
+            atlas = PsychResolvePreparedText(winRec, pt);
+        }
+
+        if (NULL == atlas) {
+            // Regular text renderer, in order with the batched texts:
+            PsychFlushGlyphBatch(winRec, batchAtlas, quadCount, vertices, texcoords, bgCount, bgVertices, colorVector, bgColorVector);
+            quadCount = bgCount = 0;
+            batchAtlas = NULL;
+
+            savedAttributes = winRec->textAttributes;
+            PsychApplyPreparedTextFont(winRec, pt);
+            theight = xAdvance = 0;
+            PsychDrawUnicodeText(winRec, NULL, pt->length, pt->text, &xp, &yp, &theight, &xAdvance, yPositionIsBaseline, textColor, backgroundColor, 0);
+            winRec->textAttributes = savedAttributes;
+            fallbackDraws++;
+            continue;
+        }
+
+        batchAtlas = atlas;
+        baseline = (yPositionIsBaseline) ? yp : yp + pt->bounds[3];
+
+        // Background rectangle, drawn by the plugin renderer if the background color is not fully transparent:
+        if (bgColorVector[3] > 0) {
+            v = &bgVertices[bgCount * 8];
+            v[0] = v[6] = (GLfloat) (xp + pt->bounds[0]);
+            v[2] = v[4] = (GLfloat) (xp + pt->bounds[2]);
+            v[1] = v[3] = (GLfloat) (baseline - pt->bounds[3]);
+            v[5] = v[7] = (GLfloat) (baseline - pt->bounds[1]);
+            bgCount++;
+        }
+
+        // One quad per inked glyph, snapped to whole pixels like the atlas rasterization:
+        gy = floor(baseline + 0.5);
+        for (j = 0; j < pt->length; j++) {
+            glyph = &atlas->glyphs[pt->glyphIndex[j]];
+            if (glyph->w == 0) continue;
+
+            gx = floor(xp + pt->penX[j] + 0.5) + glyph->xoff;
+            u0 = (double) glyph->x / (double) atlas->fbo->width;
+            u1 = (double) (glyph->x + glyph->w) / (double) atlas->fbo->width;
+            v0 = 1.0 - (double) glyph->y / (double) atlas->fbo->height;
+            v1 = 1.0 - (double) (glyph->y + glyph->h) / (double) atlas->fbo->height;
+
+            v = &vertices[quadCount * 8];
+            t = &texcoords[quadCount * 8];
+            v[0] = v[6] = (GLfloat) gx;
+            v[2] = v[4] = (GLfloat) (gx + glyph->w);
+            v[1] = v[3] = (GLfloat) (gy + glyph->yoff);
+            v[5] = v[7] = (GLfloat) (gy + glyph->yoff + glyph->h);
+            t[0] = t[6] = (GLfloat) u0;
+            t[2] = t[4] = (GLfloat) u1;
+            t[1] = t[3] = (GLfloat) v0;
+            t[5] = t[7] = (GLfloat) v1;
+            quadCount++;
+        }
+
+        // Advance text cursor:
+        xp += pt->xAdvance;
+    }
+
+    PsychFlushGlyphBatch(winRec, batchAtlas, quadCount, vertices, texcoords, bgCount, bgVertices, colorVector, bgColorVector);
+
+    *newX = xp;
+    *newY = yp;
+}
+
+/* Close prepared text 'textId', or all prepared texts if 'textId' is zero: */
+void PsychClosePreparedText(int textId)
+{
+    PsychPreparedTextType *pt;
+    int i;
+
+    if (textId == 0) {
+        for (i = 1; i <= preparedTextsCapacity; i++) if (preparedTexts[i - 1]) PsychClosePreparedText(i);
+        return;
+    }
+
+    pt = PsychGetPreparedText(textId);
+    free(pt->text);
+    free(pt->penX);
+    free(pt->glyphIndex);
+    free(pt);
+    preparedTexts[textId - 1] = NULL;
+}
+
+/* Release all glyph atlases. Prepared texts re-rasterize their glyphs on their next draw: */
+void PsychFlushGlyphAtlases(void)
+{
+    int i;
+
+    for (i = 0; i < PSYCH_MAX_GLYPH_ATLASES; i++) PsychReleaseGlyphAtlas(&glyphAtlasBANK[i], FALSE);
+}
+
+/* Set maximum number of glyph atlases to keep if 'maxAtlases' > 0. Returns the old maximum: */
+int PsychSetMaxGlyphAtlases(int maxAtlases)
+{
+    int i, used, lru, oldMax = maxGlyphAtlases;
+
+    if (maxAtlases <= 0) return(oldMax);
+
+    if (maxAtlases > PSYCH_MAX_GLYPH_ATLASES) maxAtlases = PSYCH_MAX_GLYPH_ATLASES;
+    maxGlyphAtlases = maxAtlases;
+
+    // Evict least recently used atlases in excess of the new maximum:
+    while (TRUE) {
+        used = 0;
+        lru = -1;
+        for (i = 0; i < PSYCH_MAX_GLYPH_ATLASES; i++) {
+            if (glyphAtlasBANK[i].parentIndex == 0) continue;
+            used++;
+            if ((lru < 0) || (glyphAtlasBANK[i].lastUse < glyphAtlasBANK[lru].lastUse)) lru = i;
+        }
+
+        if (used <= maxGlyphAtlases) break;
+
+        PsychReleaseGlyphAtlas(&glyphAtlasBANK[lru], FALSE);
+        atlasEvictions++;
+    }
+
+    return(oldMax);
+}
+
+/* Release all glyph atlases and prepared texts of an onscreen window. Called at window close with its OpenGL context bound: */
+void PsychReleaseGlyphCacheForWindow(PsychWindowRecordType *windowRecord)
+{
+    int i;
+
+    for (i = 0; i < PSYCH_MAX_GLYPH_ATLASES; i++) {
+        if (glyphAtlasBANK[i].parentIndex == windowRecord->windowIndex) PsychReleaseGlyphAtlas(&glyphAtlasBANK[i], TRUE);
+    }
+
+    for (i = 1; i <= preparedTextsCapacity; i++) {
+        if (preparedTexts[i - 1] && (preparedTexts[i - 1]->parentIndex == windowRecord->windowIndex)) PsychClosePreparedText(i);
+    }
+
+    // Last prepared text gone? Release handle table:
+    for (i = 0; i < preparedTextsCapacity; i++) if (preparedTexts[i]) break;
+    if (i == preparedTextsCapacity) {
+        free(preparedTexts);
+        preparedTexts = NULL;
+        preparedTextsCapacity = 0;
+    }
+}
+
+/* Return a struct with glyph cache statistics to the scripting environment, optionally resetting counters: */
+void PsychCopyOutGlyphCacheStatistics(int argPosition, psych_bool reset)
+{
+    PsychGenericScriptType *s;
+    const char *fieldNames[] = { "Atlases", "MaxAtlases", "Glyphs", "PreparedTexts", "AtlasHits", "AtlasMisses", "AtlasEvictions", "AtlasResets",
+                                 "GlyphHits", "GlyphMisses", "DrawHits", "DrawMisses", "FallbackDraws", "BatchDraws" };
+    const int fieldCount = 14;
+    int i, atlases = 0, glyphs = 0, texts = 0;
+
+    for (i = 0; i < PSYCH_MAX_GLYPH_ATLASES; i++) {
+        if (glyphAtlasBANK[i].parentIndex == 0) continue;
+        atlases++;
+        glyphs += glyphAtlasBANK[i].glyphCount;
+    }
+
+    for (i = 0; i < preparedTextsCapacity; i++) if (preparedTexts[i]) texts++;
+
+    if (PsychIsArgPresent(PsychArgOut, argPosition)) {
+        PsychAllocOutStructArray(argPosition, kPsychArgOptional, -1, fieldCount, fieldNames, &s);
+        PsychSetStructArrayDoubleElement("Atlases", 0, (double) atlases, s);
+        PsychSetStructArrayDoubleElement("MaxAtlases", 0, (double) maxGlyphAtlases, s);
+        PsychSetStructArrayDoubleElement("Glyphs", 0, (double) glyphs, s);
+        PsychSetStructArrayDoubleElement("PreparedTexts", 0, (double) texts, s);
+        PsychSetStructArrayDoubleElement("AtlasHits", 0, (double) atlasHits, s);
+        PsychSetStructArrayDoubleElement("AtlasMisses", 0, (double) atlasMisses, s);
+        PsychSetStructArrayDoubleElement("AtlasEvictions", 0, (double) atlasEvictions, s);
+        PsychSetStructArrayDoubleElement("AtlasResets", 0, (double) atlasResets, s);
+        PsychSetStructArrayDoubleElement("GlyphHits", 0, (double) glyphHits, s);
+        PsychSetStructArrayDoubleElement("GlyphMisses", 0, (double) glyphMisses, s);
+        PsychSetStructArrayDoubleElement("DrawHits", 0, (double) drawHits, s);
+        PsychSetStructArrayDoubleElement("DrawMisses", 0, (double) drawMisses, s);
+        PsychSetStructArrayDoubleElement("FallbackDraws", 0, (double) fallbackDraws, s);
+        PsychSetStructArrayDoubleElement("BatchDraws", 0, (double) batchDraws, s);
+    }
+
+    if (reset) {
+        atlasHits = atlasMisses = atlasEvictions = atlasResets = 0;
+        glyphHits = glyphMisses = drawHits = drawMisses = fallbackDraws = batchDraws = 0;
+    }
+}
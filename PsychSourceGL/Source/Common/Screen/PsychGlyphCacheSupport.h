@@ -0,0 +1,36 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychGlyphCacheSupport.h
+
+    AUTHORS:
+
+    agent               ag      agent@local
+
+    HISTORY:
+
+    19.10.2026  ag      Wrote it.
+
+    DESCRIPTION:
+
+    Psychtoolbox functions for prepared text objects, whose glyphs get drawn
+    from shared per-font glyph atlas textures in one batched draw call.
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychGlyphCacheSupport
+#define PSYCH_IS_INCLUDED_PsychGlyphCacheSupport
+
+#include "Screen.h"
+
+int         PsychPrepareText(PsychWindowRecordType *winRec, int stringLengthChars, double *textUniDoubleString, int swapTextDirection);
+void        PsychGetPreparedTextMetrics(int textId, double *bounds, double *xAdvance, double *textHeight);
+void        PsychDrawPreparedTexts(PsychWindowRecordType *winRec, int count, int *textIds, double *x, int nx, double *y, int ny,
+                                   int yPositionIsBaseline, PsychColorType *textColor, PsychColorType *backgroundColor,
+                                   double *newX, double *newY);
+void        PsychClosePreparedText(int textId);
+void        PsychFlushGlyphAtlases(void);
+int         PsychSetMaxGlyphAtlases(int maxAtlases);
+void        PsychReleaseGlyphCacheForWindow(PsychWindowRecordType *windowRecord);
+void        PsychCopyOutGlyphCacheStatistics(int argPosition, psych_bool reset);
+
+//end include once
+#endif
@@ -0,0 +1,483 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychImageStatisticsSupport.c
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           ag      agent@local
+
+    HISTORY:
+
+        19.10.2026  ag      Wrote it.
+
+    DESCRIPTION:
+
+        Fast single pass intensity statistics of 8 bpc and 16 bpc images with interleaved channels,
+        e.g., for average intensity and min/max/histogram of captured video frames.
+
+        Per channel sums, minima and maxima are computed with SSE2 on x86 and NEON on ARM, and with
+        plain C elsewhere. Samples are accumulated per position inside a period of 16 Bytes, or 48 Bytes
+        for 3 channel images, so each accumulator lane always sees the same channel and per channel results
+        fall out of one pass without any shuffling. Narrow lane sums are flushed into 64 bit totals before
+        they could overflow. A requested histogram is computed in a scalar pass, together with all other
+        statistics, so the image is still only read once.
+*/
+
+#include "Screen.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PSYCH_IMAGESTATS_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PSYCH_IMAGESTATS_NEON 1
+#endif
+
+// Maximum period in samples for position based accumulation: 48 Bytes of 8 bpc RGB.
+#define PSYCH_IMAGESTATS_MAXPERIOD 48
+
+// Per channel sums, and optionally minima and maxima, of 'rows' rows of 'rowSamples' 8 bit samples each:
+static void PsychImageStatsU8(const unsigned char* base, size_t stride, int rows, int rowSamples, int channels, psych_bool minmax,
+                              psych_uint64* chanSum, unsigned int* chanMin, unsigned int* chanMax)
+{
+    const int               period = (channels == 3) ? 48 : 16;
+    const unsigned char*    row;
+    psych_uint64            posSum[PSYCH_IMAGESTATS_MAXPERIOD];
+    unsigned char           posMin[PSYCH_IMAGESTATS_MAXPERIOD];
+    unsigned char           posMax[PSYCH_IMAGESTATS_MAXPERIOD];
+    int                     x, y, p;
+    #if defined(PSYCH_IMAGESTATS_SSE2) || defined(PSYCH_IMAGESTATS_NEON)
+    const int               nvec = period / 16;
+    psych_uint16            lanes[16];
+    unsigned char           bytes[16];
+    int                     k, n, chunk;
+    #endif
+    #if defined(PSYCH_IMAGESTATS_SSE2)
+    const __m128i           zero = _mm_setzero_si128();
+    __m128i                 v, acclo[3], acchi[3], vmin[3], vmax[3];
+    #elif defined(PSYCH_IMAGESTATS_NEON)
+    uint8x16_t              v, vmin[3], vmax[3];
+    uint16x8_t              acclo[3], acchi[3];
+    #endif
+
+    memset(posSum, 0, sizeof(posSum));
+    memset(posMin, 0xff, sizeof(posMin));
+    memset(posMax, 0, sizeof(posMax));
+
+    #if defined(PSYCH_IMAGESTATS_SSE2)
+    for (k = 0; k < nvec; k++) {
+        vmin[k] = _mm_set1_epi8((char) 0xff);
+        vmax[k] = zero;
+    }
+    #elif defined(PSYCH_IMAGESTATS_NEON)
+    for (k = 0; k < nvec; k++) {
+        vmin[k] = vdupq_n_u8(0xff);
+        vmax[k] = vdupq_n_u8(0);
+    }
+    #endif
+
+    for (y = 0; y < rows; y++) {
+        row = base + (size_t) y * stride;
+        x = 0;
+
+        #if defined(PSYCH_IMAGESTATS_SSE2) || defined(PSYCH_IMAGESTATS_NEON)
+        while (x + period <= rowSamples) {
+            // 16 bit lane sums of at most 256 samples of 255 each can't overflow:
+            chunk = (rowSamples - x) / period;
+            if (chunk > 256) chunk = 256;
+
+            for (k = 0; k < nvec; k++) {
+                #if defined(PSYCH_IMAGESTATS_SSE2)
+                acclo[k] = acchi[k] = zero;
+                #else
+                acclo[k] = acchi[k] = vdupq_n_u16(0);
+                #endif
+            }
+
+            for (n = 0; n < chunk; n++, x += period) {
+                for (k = 0; k < nvec; k++) {
+                    #if defined(PSYCH_IMAGESTATS_SSE2)
+                    v = _mm_loadu_si128((const __m128i*) (row + x + 16 * k));
+                    acclo[k] = _mm_add_epi16(acclo[k], _mm_unpacklo_epi8(v, zero));
+                    acchi[k] = _mm_add_epi16(acchi[k], _mm_unpackhi_epi8(v, zero));
+                    if (minmax) {
+                        vmin[k] = _mm_min_epu8(vmin[k], v);
+                        vmax[k] = _mm_max_epu8(vmax[k], v);
+                    }
+                    #else
+                    v = vld1q_u8(row + x + 16 * k);
+                    acclo[k] = vaddw_u8(acclo[k], vget_low_u8(v));
+                    acchi[k] = vaddw_u8(acchi[k], vget_high_u8(v));
+                    if (minmax) {
+                        vmin[k] = vminq_u8(vmin[k], v);
+                        vmax[k] = vmaxq_u8(vmax[k], v);
+                    }
+                    #endif
+                }
+            }
+
+            for (k = 0; k < nvec; k++) {
+                #if defined(PSYCH_IMAGESTATS_SSE2)
+                _mm_storeu_si128((__m128i*) &lanes[0], acclo[k]);
+                _mm_storeu_si128((__m128i*) &lanes[8], acchi[k]);
+                #else
+                vst1q_u16(&lanes[0], acclo[k]);
+                vst1q_u16(&lanes[8], acchi[k]);
+                #endif
+                for (p = 0; p < 16; p++) posSum[16 * k + p] += lanes[p];
+            }
+        }
+        #endif
+
+        // Remaining samples of the row, or all samples without SIMD:
+        for (p = x % period; x < rowSamples; x++) {
+            posSum[p] += row[x];
+            if (minmax) {
+                if (row[x] < posMin[p]) posMin[p] = row[x];
+                if (row[x] > posMax[p]) posMax[p] = row[x];
+            }
+            if (++p == period) p = 0;
+        }
+    }
+
+    #if defined(PSYCH_IMAGESTATS_SSE2) || defined(PSYCH_IMAGESTATS_NEON)
+    if (minmax) {
+        for (k = 0; k < nvec; k++) {
+            #if defined(PSYCH_IMAGESTATS_SSE2)
+            _mm_storeu_si128((__m128i*) bytes, vmin[k]);
+            #else
+            vst1q_u8(bytes, vmin[k]);
+            #endif
+            for (p = 0; p < 16; p++) if (bytes[p] < posMin[16 * k + p]) posMin[16 * k + p] = bytes[p];
+
+            #if defined(PSYCH_IMAGESTATS_SSE2)
+            _mm_storeu_si128((__m128i*) bytes, vmax[k]);
+            #else
+            vst1q_u8(bytes, vmax[k]);
+            #endif
+            for (p = 0; p < 16; p++) if (bytes[p] > posMax[16 * k + p]) posMax[16 * k + p] = bytes[p];
+        }
+    }
+    #endif
+
+    // Position p within the period always holds channel p % channels:
+    for (p = 0; p < period; p++) {
+        chanSum[p % channels] += posSum[p];
+        if (posMin[p] < chanMin[p % channels]) chanMin[p % channels] = posMin[p];
+        if (posMax[p] > chanMax[p % channels]) chanMax[p % channels] = posMax[p];
+    }
+}
+
+// Per channel sums, and optionally minima and maxima, of 'rows' rows of 'rowSamples' 16 bit samples each:
+static void PsychImageStatsU16(const unsigned char* base, size_t stride, int rows, int rowSamples, int channels, psych_bool minmax,
+                               psych_uint64* chanSum, unsigned int* chanMin, unsigned int* chanMax)
+{
+    const int               period = (channels == 3) ? 24 : 8;
+    const psych_uint16*     row;
+    psych_uint64            posSum[PSYCH_IMAGESTATS_MAXPERIOD];
+    psych_uint16            posMin[PSYCH_IMAGESTATS_MAXPERIOD];
+    psych_uint16            posMax[PSYCH_IMAGESTATS_MAXPERIOD];
+    int                     x, y, p;
+    #if defined(PSYCH_IMAGESTATS_SSE2) || defined(PSYCH_IMAGESTATS_NEON)
+    const int               nvec = period / 8;
+    unsigned int            lanes[8];
+    psych_uint16            words[8];
+    int                     k, n, chunk;
+    #endif
+    #if defined(PSYCH_IMAGESTATS_SSE2)
+    // SSE2 only has signed 16 bit min/max, so compare with the sign bit flipped:
+    const __m128i           zero = _mm_setzero_si128();
+    const __m128i           bias = _mm_set1_epi16((short) 0x8000);
+    __m128i                 v, vb, acclo[3], acchi[3], vmin[3], vmax[3];
+    #elif defined(PSYCH_IMAGESTATS_NEON)
+    uint16x8_t              v, vmin[3], vmax[3];
+    uint32x4_t              acclo[3], acchi[3];
+    #endif
+
+    memset(posSum, 0, sizeof(posSum));
+    for (p = 0; p < PSYCH_IMAGESTATS_MAXPERIOD; p++) {
+        posMin[p] = 0xffff;
+        posMax[p] = 0;
+    }
+
+    #if defined(PSYCH_IMAGESTATS_SSE2)
+    for (k = 0; k < nvec; k++) {
+        vmin[k] = _mm_set1_epi16(0x7fff);
+        vmax[k] = _mm_set1_epi16((short) 0x8000);
+    }
+    #elif defined(PSYCH_IMAGESTATS_NEON)
+    for (k = 0; k < nvec; k++) {
+        vmin[k] = vdupq_n_u16(0xffff);
+        vmax[k] = vdupq_n_u16(0);
+    }
+    #endif
+
+    for (y = 0; y < rows; y++) {
+        row = (const psych_uint16*) (base + (size_t) y * stride);
+        x = 0;
+
+        #if defined(PSYCH_IMAGESTATS_SSE2) || defined(PSYCH_IMAGESTATS_NEON)
+        while (x + period <= rowSamples) {
+            // 32 bit lane sums of at most 65536 samples of 65535 each can't overflow:
+            chunk = (rowSamples - x) / period;
+            if (chunk > 65536) chunk = 65536;
+
+            for (k = 0; k < nvec; k++) {
+                #if defined(PSYCH_IMAGESTATS_SSE2)
+                acclo[k] = acchi[k] = zero;
+                #else
+                acclo[k] = acchi[k] = vdupq_n_u32(0);
+                #endif
+            }
+
+            for (n = 0; n < chunk; n++, x += period) {
+                for (k = 0; k < nvec; k++) {
+                    #if defined(PSYCH_IMAGESTATS_SSE2)
+                    v = _mm_loadu_si128((const __m128i*) (row + x + 8 * k));
+                    acclo[k] = _mm_add_epi32(acclo[k], _mm_unpacklo_epi16(v, zero));
+                    acchi[k] = _mm_add_epi32(acchi[k], _mm_unpackhi_epi16(v, zero));
+                    if (minmax) {
+                        vb = _mm_xor_si128(v, bias);
+                        vmin[k] = _mm_min_epi16(vmin[k], vb);
+                        vmax[k] = _mm_max_epi16(vmax[k], vb);
+                    }
+                    #else
+                    v = vld1q_u16(row + x + 8 * k);
+                    acclo[k] = vaddw_u16(acclo[k], vget_low_u16(v));
+                    acchi[k] = vaddw_u16(acchi[k], vget_high_u16(v));
+                    if (minmax) {
+                        vmin[k] = vminq_u16(vmin[k], v);
+                        vmax[k] = vmaxq_u16(vmax[k], v);
+                    }
+                    #endif
+                }
+            }
+
+            for (k = 0; k < nvec; k++) {
+                #if defined(PSYCH_IMAGESTATS_SSE2)
+                _mm_storeu_si128((__m128i*) &lanes[0], acclo[k]);
+                _mm_storeu_si128((__m128i*) &lanes[4], acchi[k]);
+                #else
+                vst1q_u32(&lanes[0], acclo[k]);
+                vst1q_u32(&lanes[4], acchi[k]);
+                #endif
+                for (p = 0; p < 8; p++) posSum[8 * k + p] += lanes[p];
+            }
+        }
+        #endif
+
+        // Remaining samples of the row, or all samples without SIMD:
+        for (p = x % period; x < rowSamples; x++) {
+            posSum[p] += row[x];
+            if (minmax) {
+                if (row[x] < posMin[p]) posMin[p] = row[x];
+                if (row[x] > posMax[p]) posMax[p] = row[x];
+            }
+            if (++p == period) p = 0;
+        }
+    }
+
+    #if defined(PSYCH_IMAGESTATS_SSE2) || defined(PSYCH_IMAGESTATS_NEON)
+    if (minmax) {
+        for (k = 0; k < nvec; k++) {
+            #if defined(PSYCH_IMAGESTATS_SSE2)
+            _mm_storeu_si128((__m128i*) words, _mm_xor_si128(vmin[k], bias));
+            #else
+            vst1q_u16(words, vmin[k]);
+            #endif
+            for (p = 0; p < 8; p++) if (words[p] < posMin[8 * k + p]) posMin[8 * k + p] = words[p];
+
+            #if defined(PSYCH_IMAGESTATS_SSE2)
+            _mm_storeu_si128((__m128i*) words, _mm_xor_si128(vmax[k], bias));
+            #else
+            vst1q_u16(words, vmax[k]);
+            #endif
+            for (p = 0; p < 8; p++) if (words[p] > posMax[8 * k + p]) posMax[8 * k + p] = words[p];
+        }
+    }
+    #endif
+
+    // Position p within the period always holds channel p % channels:
+    for (p = 0; p < period; p++) {
+        chanSum[p % channels] += posSum[p];
+        if (posMin[p] < chanMin[p % channels]) chanMin[p % channels] = posMin[p];
+        if (posMax[p] > chanMax[p % channels]) chanMax[p % channels] = posMax[p];
+    }
+}
+
+// Scalar pass for per channel sums, minima and maxima, and a histogram of channel 'channel', or of all channels if -1:
+static void PsychImageStatsHistogram(const unsigned char* base, size_t stride, int rows, int rowSamples, int channels, int bitdepth, int channel,
+                                     psych_uint64* chanSum, unsigned int* chanMin, unsigned int* chanMax, double* histogram)
+{
+    unsigned int    counts[kPsychImageStatsHistogramBins];
+    unsigned int    value;
+    int             x, y, c, shift;
+
+    memset(counts, 0, sizeof(counts));
+    shift = (bitdepth > 8) ? bitdepth - 8 : 0;
+
+    for (y = 0; y < rows; y++) {
+        for (x = 0, c = 0; x < rowSamples; x++) {
+            value = (bitdepth > 8) ? ((const psych_uint16*) (base + (size_t) y * stride))[x] : (base + (size_t) y * stride)[x];
+
+            chanSum[c] += value;
+            if (value < chanMin[c]) chanMin[c] = value;
+            if (value > chanMax[c]) chanMax[c] = value;
+            if ((channel < 0) || (channel == c)) counts[((value >> shift) > 255) ? 255 : (value >> shift)]++;
+
+            if (++c == channels) c = 0;
+        }
+
+        // Move counts into double histogram regularly, so 32 bit counts can't overflow:
+        if (((y + 1) % 1024) == 0) {
+            for (x = 0; x < kPsychImageStatsHistogramBins; x++) histogram[x] += counts[x];
+            memset(counts, 0, sizeof(counts));
+        }
+    }
+
+    for (x = 0; x < kPsychImageStatsHistogramBins; x++) histogram[x] += counts[x];
+}
+
+/* PsychComputeImageStatistics() - Compute intensity statistics of an image in one pass.
+ *
+ * image            = Pointer to first pixel of the image with interleaved channels.
+ * width, height    = Size of the image in pixels.
+ * rowStrideBytes   = Distance between starts of rows in Bytes, 0 = Tightly packed.
+ * channels         = Number of interleaved channels, 1 to 4.
+ * bitdepth         = Bits per sample. Samples are 8 bit for bitdepth <= 8, 16 bit otherwise.
+ * roi              = Optional [left, top, right, bottom] region of interest in pixels, or NULL for the full image.
+ * channel          = Channel for mean, min, max and histogram, or -1 for all channels pooled.
+ * flags            = kPsychImageStatsMinMax and/or kPsychImageStatsHistogram for the optional statistics.
+ * stats            = Receives the results. Intensities are normalized to the 0.0 - 1.0 range.
+ *
+ * Returns FALSE if the region of interest does not contain any pixels, TRUE otherwise.
+ */
+psych_bool PsychComputeImageStatistics(const void* image, int width, int height, size_t rowStrideBytes, int channels, int bitdepth,
+                                       const int* roi, int channel, int flags, PsychImageStatisticsType* stats)
+{
+    psych_uint64            chanSum[kPsychImageStatsMaxChannels];
+    unsigned int            chanMin[kPsychImageStatsMaxChannels];
+    unsigned int            chanMax[kPsychImageStatsMaxChannels];
+    psych_uint64            sum;
+    const unsigned char*    base;
+    double                  maxValue;
+    int                     left, top, right, bottom, bytesPerSample, c;
+
+    memset(stats, 0, sizeof(PsychImageStatisticsType));
+    if ((channels < 1) || (channels > kPsychImageStatsMaxChannels)) return(FALSE);
+    if (channel >= channels) channel = -1;
+
+    stats->flags = flags;
+    stats->channels = channels;
+    stats->channel = channel;
+
+    // Clip region of interest against image:
+    left = 0; top = 0; right = width; bottom = height;
+    if (roi) {
+        if (roi[0] > left) left = roi[0];
+        if (roi[1] > top) top = roi[1];
+        if (roi[2] < right) right = roi[2];
+        if (roi[3] < bottom) bottom = roi[3];
+    }
+
+    if ((right <= left) || (bottom <= top)) return(FALSE);
+
+    bytesPerSample = (bitdepth > 8) ? 2 : 1;
+    if (rowStrideBytes == 0) rowStrideBytes = (size_t) width * channels * bytesPerSample;
+    base = (const unsigned char*) image + (size_t) top * rowStrideBytes + (size_t) left * channels * bytesPerSample;
+
+    for (c = 0; c < kPsychImageStatsMaxChannels; c++) {
+        chanSum[c] = 0;
+        chanMin[c] = 0xffffffff;
+        chanMax[c] = 0;
+    }
+
+    if (flags & kPsychImageStatsHistogram) {
+        PsychImageStatsHistogram(base, rowStrideBytes, bottom - top, (right - left) * channels, channels, bitdepth, channel,
+                                 chanSum, chanMin, chanMax, stats->histogram);
+    }
+    else if (bytesPerSample == 1) {
+        PsychImageStatsU8(base, rowStrideBytes, bottom - top, (right - left) * channels, channels, (flags & kPsychImageStatsMinMax) ? TRUE : FALSE,
+                          chanSum, chanMin, chanMax);
+    }
+    else {
+        PsychImageStatsU16(base, rowStrideBytes, bottom - top, (right - left) * channels, channels, (flags & kPsychImageStatsMinMax) ? TRUE : FALSE,
+                           chanSum, chanMin, chanMax);
+    }
+
+    // Normalize to 0.0 - 1.0 range:
+    maxValue = (double) ((bitdepth > 8) ? ((1 << bitdepth) - 1) : 255);
+    stats->pixelCount = (double) (right - left) * (double) (bottom - top);
+
+    sum = 0;
+    for (c = 0; c < channels; c++) {
+        sum += chanSum[c];
+        stats->channelMean[c] = (double) chanSum[c] / stats->pixelCount / maxValue;
+        if (flags & (kPsychImageStatsMinMax | kPsychImageStatsHistogram)) {
+            stats->channelMin[c] = (double) chanMin[c] / maxValue;
+            stats->channelMax[c] = (double) chanMax[c] / maxValue;
+        }
+    }
+
+    if (channel < 0) {
+        stats->mean = (double) sum / stats->pixelCount / channels / maxValue;
+        stats->min = stats->channelMin[0];
+        stats->max = stats->channelMax[0];
+        for (c = 1; c < channels; c++) {
+            if (stats->channelMin[c] < stats->min) stats->min = stats->channelMin[c];
+            if (stats->channelMax[c] > stats->max) stats->max = stats->channelMax[c];
+        }
+    }
+    else {
+        stats->mean = stats->channelMean[channel];
+        stats->min = stats->channelMin[channel];
+        stats->max = stats->channelMax[channel];
+    }
+
+    return(TRUE);
+}
+
+/* PsychCopyOutImageStatistics() - Return statistics as struct to the scripting environment.
+ *
+ * 'timestamp' is the capture time of the evaluated frame, or -1 if statistics are not available yet,
+ * in which case all other fields are zero.
+ */
+void PsychCopyOutImageStatistics(int argPosition, const PsychImageStatisticsType* stats, double timestamp)
+{
+    PsychGenericScriptType  *s, *outMat;
+    const char *fieldNames[] = { "Timestamp", "PixelCount", "Channel", "Mean", "Min", "Max", "ChannelMean", "ChannelMin", "ChannelMax", "Histogram" };
+    const int fieldCount = 10;
+    double *v;
+    int channels = (stats->channels > 0) ? stats->channels : 1;
+    int c;
+
+    PsychAllocOutStructArray(argPosition, kPsychArgOptional, -1, fieldCount, fieldNames, &s);
+
+    PsychSetStructArrayDoubleElement("Timestamp", 0, timestamp, s);
+    PsychSetStructArrayDoubleElement("PixelCount", 0, stats->pixelCount, s);
+    PsychSetStructArrayDoubleElement("Channel", 0, (double) stats->channel, s);
+    PsychSetStructArrayDoubleElement("Mean", 0, stats->mean, s);
+    PsychSetStructArrayDoubleElement("Min", 0, stats->min, s);
+    PsychSetStructArrayDoubleElement("Max", 0, stats->max, s);
+
+    // Per channel results as row vectors:
+    PsychAllocateNativeDoubleMat(1, channels, 1, &v, &outMat);
+    for (c = 0; c < channels; c++) v[c] = stats->channelMean[c];
+    PsychSetStructArrayNativeElement("ChannelMean", 0, outMat, s);
+
+    PsychAllocateNativeDoubleMat(1, channels, 1, &v, &outMat);
+    for (c = 0; c < channels; c++) v[c] = stats->channelMin[c];
+    PsychSetStructArrayNativeElement("ChannelMin", 0, outMat, s);
+
+    PsychAllocateNativeDoubleMat(1, channels, 1, &v, &outMat);
+    for (c = 0; c < channels; c++) v[c] = stats->channelMax[c];
+    PsychSetStructArrayNativeElement("ChannelMax", 0, outMat, s);
+
+    // Histogram only if it was computed, empty otherwise:
+    PsychAllocateNativeDoubleMat(1, (stats->flags & kPsychImageStatsHistogram) ? kPsychImageStatsHistogramBins : 0, 1, &v, &outMat);
+    if (stats->flags & kPsychImageStatsHistogram) memcpy(v, stats->histogram, sizeof(stats->histogram));
+    PsychSetStructArrayNativeElement("Histogram", 0, outMat, s);
+}
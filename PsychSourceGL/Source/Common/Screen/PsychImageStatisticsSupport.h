@@ -0,0 +1,54 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychImageStatisticsSupport.h
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           ag      agent@local
+
+    HISTORY:
+
+        19.10.2026  ag      Wrote it.
+
+    DESCRIPTION:
+
+        Fast single pass intensity statistics of 8 bpc and 16 bpc images with interleaved channels,
+        e.g., for average intensity and min/max/histogram of captured video frames.
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychImageStatisticsSupport
+#define PSYCH_IS_INCLUDED_PsychImageStatisticsSupport
+
+#include "Screen.h"
+
+// Optional statistics to compute in addition to per channel means:
+#define kPsychImageStatsMinMax          1
+#define kPsychImageStatsHistogram       2
+
+#define kPsychImageStatsMaxChannels     4
+#define kPsychImageStatsHistogramBins   256
+
+typedef struct PsychImageStatisticsType {
+    int     flags;                                          // kPsychImageStats* flags of what was computed.
+    int     channels;                                       // Number of channels in the image.
+    int     channel;                                        // Selected channel for mean, min, max and histogram, -1 = all.
+    double  pixelCount;                                     // Number of pixels in the evaluated region.
+    double  mean;                                           // Mean of selected channel(s), normalized to 0.0 - 1.0 range.
+    double  min;                                            // Minimum of selected channel(s), normalized.
+    double  max;                                            // Maximum of selected channel(s), normalized.
+    double  channelMean[kPsychImageStatsMaxChannels];       // Normalized mean of each channel.
+    double  channelMin[kPsychImageStatsMaxChannels];        // Normalized minimum of each channel.
+    double  channelMax[kPsychImageStatsMaxChannels];        // Normalized maximum of each channel.
+    double  histogram[kPsychImageStatsHistogramBins];       // Sample counts of selected channel(s), binned by the 8 most significant bits.
+} PsychImageStatisticsType;
+
+psych_bool PsychComputeImageStatistics(const void* image, int width, int height, size_t rowStrideBytes, int channels, int bitdepth,
+                                       const int* roi, int channel, int flags, PsychImageStatisticsType* stats);
+void PsychCopyOutImageStatistics(int argPosition, const PsychImageStatisticsType* stats, double timestamp);
+
+//end include once
+#endif
@@ -410,6 +410,7 @@ void PsychInitImagingPipelineDefaultsForWindowRecord(PsychWindowRecordType *wind
     for (i=0; i<MAX_SCREEN_HOOKS; i++) {
         windowRecord->HookChainEnabled[i]=FALSE;
         windowRecord->HookChain[i]=NULL;
+        memset(&(windowRecord->HookChainStats[i]), 0, sizeof(PsychHookChainStats));
     }
 
     // Disable all special framebuffer objects by default:
@@ -1610,12 +1611,16 @@ void PsychInitializeImagingPipeline(PsychWindowRecordType *windowRecord, int ima
  *  vertexsrc    - Source string for vertex shader. NULL if none needed.
  *  primitivesrc - Source string for primitive shader. NULL if none needed.
  *
+ *  Linked programs are stored in, and on later calls loaded from, the on-disk
+ *  GLSL program binary cache, if the OpenGL implementation supports it.
+ *
  */
 GLuint PsychCreateGLSLProgram(const char* fragmentsrc, const char* vertexsrc, const char* primitivesrc)
 {
     GLuint glsl = 0;
     GLuint shader;
     GLint status;
+    psych_uint64 cachekey;
     char errtxt[10000];
 
     (void) primitivesrc;
@@ -1629,6 +1634,9 @@ GLuint PsychCreateGLSLProgram(const char* fragmentsrc, const char* vertexsrc, co
         return(0);
     }
 
+    // Program binary for these shaders already in the shader cache? Then use it and skip compile and link:
+    if ((glsl = PsychShaderCacheLoadProgram(fragmentsrc, vertexsrc, &cachekey)) > 0) return(glsl);
+
     // Create GLSL program object:
     glsl = glCreateProgram();
 
@@ -1711,6 +1719,7 @@ GLuint PsychCreateGLSLProgram(const char* fragmentsrc, const char* vertexsrc, co
     }
 
     // Link into final program object:
+    PsychShaderCachePrepareProgram(glsl, cachekey);
     glLinkProgram(glsl);
 
     // Check link status:
@@ -1732,6 +1741,9 @@ GLuint PsychCreateGLSLProgram(const char* fragmentsrc, const char* vertexsrc, co
 
     while (glGetError());
 
+    // Store program binary in the shader cache for faster setup next time:
+    PsychShaderCacheStoreProgram(glsl, cachekey);
+
     // Return new GLSL program object handle:
     return(glsl);
 }
@@ -3108,6 +3120,9 @@ void PsychCreateShadowFBOForTexture(PsychWindowRecordType *textureRecord, psych_
 {
     GLenum fboInternalFormat;
 
+    // Textures packed into a texture atlas need their own texture before they can be a rendertarget:
+    PsychEvictTextureFromAtlas(textureRecord);
+
     // Do we already have a framebuffer object for this texture? All textures start off without one,
     // because most textures are just used for drawing them, not drawing *into* them. Therefore we
     // only create a full blown FBO on demand here.
@@ -3188,6 +3203,9 @@ void PsychNormalizeTextureOrientation(PsychWindowRecordType *sourceRecord)
     psych_bool needzbuffer, isplanar;
     int width, height;
 
+    // Textures packed into a texture atlas need their own texture before they can be converted:
+    PsychEvictTextureFromAtlas(sourceRecord);
+
     // Is this a planar encoding texture?
     isplanar = (PsychIsTexture(sourceRecord) && (sourceRecord->specialflags & kPsychPlanarTexture)) ? TRUE : FALSE;
 
@@ -3442,6 +3460,9 @@ void PsychShutdownImagingPipeline(PsychWindowRecordType *windowRecord, psych_boo
 
     // Do OpenGL specific cleanup:
     if (openglpart) {
+        // Release fused shaders and gpu timer queries of the hook chains:
+        PsychPipelineReleaseHookChainResources(windowRecord);
+
         // Yes. Mode specific cleanup:
         for (i = 0; i < windowRecord->fboCount; i++) {
             // Delete i'th FBO, if any:
@@ -3524,6 +3545,723 @@ int PsychGetHookByName(const char* hookName)
     return((i>=MAX_SCREEN_HOOKS) ? -1 : i);
 }
 
+/* Hook chain optimizer:
+ *
+ * Each hook chain is executed as a sequence of render passes, separated by "Builtin:FlipFBOs"
+ * slots, with each pass ping-ponging between srcfbo, dstfbo and the bounce buffers. The optimizer
+ * runs whenever a hook chain gets modified and computes an optimized execution plan for the chain,
+ * stored in the optSkip and fused* fields of the hook slots:
+ *
+ * 1. Passes which only consist of a plain "Builtin:IdentityBlit" are redundant copies if the chain
+ *    has other passes, as the following pass can read the source directly, or the preceding pass
+ *    can write to the target directly. These passes and one adjacent FlipFBOs get skipped.
+ *
+ * 2. Consecutive passes which only consist of a single GLSL shader slot which declares itself as
+ *    fusable by the keyword "Fusable" in its blitter config string are merged into one pass, which
+ *    executes a generated shader. The first fused shader can be any fragment shader. All following
+ *    shaders must be pure per-pixel operations and define a function
+ *    vec4 PsychFusableStage(vec4 incolor) that maps the input color of a pixel to its output color.
+ *    The generated shader runs the main() routine of the first shader, then pipes the resulting
+ *    gl_FragColor through the PsychFusableStage() functions of the following shaders. Uniforms of
+ *    the original shaders are mirrored into the generated shader at each execution. The fused pass
+ *    binds the lookup texture 'luttexid1' of the first shader slot only, so following slots with
+ *    their own lookup texture are not fused, but start a new run.
+ *
+ * Chains with "Builtin:RestrictToScissorROI" slots are not optimized, and the optimized plan is
+ * only used for invocations without override blitters or blit parameters, and without aliasing
+ * between input and output framebuffers. Setting the environment variable
+ * PSYCH_DISABLE_HOOKCHAIN_OPTIMIZER to a non-empty value disables the optimizer.
+ */
+
+// Mapping of one uniform of an original shader to the corresponding uniform of a fused shader:
+typedef struct PsychFusedUniform {
+    GLuint  srcProgram;
+    GLint   srcLocation;
+    GLint   dstLocation;
+    GLenum  type;
+} PsychFusedUniform;
+
+static psych_bool PsychPipelineIsFlipFBOsSlot(PsychHookFunction* hookfunc)
+{
+    return((hookfunc->hookfunctype == kPsychBuiltinFunc && strcmp(hookfunc->idString, "Builtin:FlipFBOs") == 0) ? TRUE : FALSE);
+}
+
+/* Does this blitter config string request only a plain one-to-one identity blit? */
+static psych_bool PsychPipelineIsPlainBlitString(const char* pString1)
+{
+    if (pString1 == NULL) return(TRUE);
+
+    if ((strstr(pString1, "Blitter:") && !strstr(pString1, "Blitter:IdentityBlit")) || strstr(pString1, "TEXTURE") ||
+        strstr(pString1, "OvrSize:") || strstr(pString1, "Bilinear") || strstr(pString1, "Offset:") ||
+        strstr(pString1, "Scaling:") || strstr(pString1, "Rotation:"))
+        return(FALSE);
+
+    return(TRUE);
+}
+
+static psych_bool PsychPipelineIsRedundantIdentityBlitSlot(PsychHookFunction* hookfunc)
+{
+    return((hookfunc->hookfunctype == kPsychBuiltinFunc && strstr(hookfunc->idString, "Builtin:IdentityBlit") &&
+            PsychPipelineIsPlainBlitString(hookfunc->pString1)) ? TRUE : FALSE);
+}
+
+static psych_bool PsychPipelineIsFusableSlot(PsychHookFunction* hookfunc)
+{
+    return((hookfunc->hookfunctype == kPsychShaderFunc && hookfunc->shaderid > 0 && hookfunc->pString1 &&
+            strstr(hookfunc->pString1, "Fusable") && PsychPipelineIsPlainBlitString(hookfunc->pString1)) ? TRUE : FALSE);
+}
+
+/* Release the generated fused shader of a hook slot, if any. */
+static void PsychPipelineReleaseFusedShader(PsychWindowRecordType *windowRecord, PsychHookFunction* hookfunc)
+{
+    if (hookfunc->fusedShader) {
+        // Only onscreen windows get fused shaders, so we have a OpenGL context for deletion:
+        PsychSetGLContext(windowRecord);
+        if (glDeleteProgram) glDeleteProgram(hookfunc->fusedShader);
+        hookfunc->fusedShader = 0;
+    }
+
+    free(hookfunc->fusedUniforms);
+    hookfunc->fusedUniforms = NULL;
+    hookfunc->fusedUniformCount = 0;
+    hookfunc->fusedStages = 0;
+    hookfunc->fusedFailed = FALSE;
+
+    return;
+}
+
+/* Undo fusion of a group of slots, starting with its first slot 'hookfunc', e.g., after failure to create its shader: */
+static void PsychPipelineUnfuseSlots(PsychWindowRecordType *windowRecord, int hookidx, PsychHookFunction* hookfunc)
+{
+    PsychHookChainStats *stats = &(windowRecord->HookChainStats[hookidx]);
+    int stagesLeft = hookfunc->fusedStages - 1;
+    PtrPsychHookFunction iter;
+
+    for (iter = hookfunc->next; iter && (stagesLeft > 0); iter = iter->next) {
+        if (iter->optSkip == 2) {
+            iter->optSkip = 0;
+            if (!PsychPipelineIsFlipFBOsSlot(iter)) stagesLeft--;
+        }
+    }
+
+    stats->optimizedPassCount += hookfunc->fusedStages - 1;
+    stats->fusedSlots -= hookfunc->fusedStages;
+    hookfunc->fusedStages = 0;
+
+    return;
+}
+
+/* PsychPipelineOptimizeHookChain()
+ * Compute the optimized execution plan and pass statistics for hook chain 'hookidx' of
+ * window 'windowRecord'. Called after each modification of the chain. See above for details.
+ */
+void PsychPipelineOptimizeHookChain(PsychWindowRecordType *windowRecord, int hookidx)
+{
+    PsychHookChainStats *stats = &(windowRecord->HookChainStats[hookidx]);
+    PtrPsychHookFunction hookfunc;
+    PtrPsychHookFunction *passFirst, *passFlip;
+    int *passSlots;
+    int nslots, npasses, livepasses, p, q, firstlive, runlen;
+    psych_bool optimize = TRUE;
+
+    // Release old plan:
+    nslots = 0;
+    for (hookfunc = windowRecord->HookChain[hookidx]; hookfunc; hookfunc = hookfunc->next) {
+        PsychPipelineReleaseFusedShader(windowRecord, hookfunc);
+        hookfunc->optSkip = 0;
+        if (hookfunc->hookfunctype == kPsychBuiltinFunc && strstr(hookfunc->idString, "Builtin:RestrictToScissorROI")) optimize = FALSE;
+        nslots++;
+    }
+
+    stats->passCount = 0;
+    stats->optimizedPassCount = 0;
+    stats->eliminatedBlits = 0;
+    stats->fusedSlots = 0;
+    if (nslots == 0) return;
+
+    if (getenv("PSYCH_DISABLE_HOOKCHAIN_OPTIMIZER") && getenv("PSYCH_DISABLE_HOOKCHAIN_OPTIMIZER")[0]) optimize = FALSE;
+
+    // Split chain into passes: passFirst[p] is the first slot of pass p, passFlip[p] the FlipFBOs slot
+    // which starts pass p (NULL for the 1st pass), passSlots[p] the number of slots in pass p, excluding
+    // the FlipFBOs slot:
+    passFirst = (PtrPsychHookFunction*) calloc(nslots + 1, sizeof(PtrPsychHookFunction));
+    passFlip = (PtrPsychHookFunction*) calloc(nslots + 1, sizeof(PtrPsychHookFunction));
+    passSlots = (int*) calloc(nslots + 1, sizeof(int));
+    if (!passFirst || !passFlip || !passSlots) {
+        free(passFirst); free(passFlip); free(passSlots);
+        PsychErrorExitMsg(PsychError_outofMemory, "Failed to allocate memory for hook chain optimization.");
+    }
+
+    npasses = 1;
+    for (hookfunc = windowRecord->HookChain[hookidx]; hookfunc; hookfunc = hookfunc->next) {
+        if (PsychPipelineIsFlipFBOsSlot(hookfunc)) {
+            passFlip[npasses++] = hookfunc;
+        }
+        else {
+            if (passSlots[npasses - 1]++ == 0) passFirst[npasses - 1] = hookfunc;
+        }
+    }
+
+    stats->passCount = npasses;
+    livepasses = npasses;
+
+    if (optimize) {
+        // Eliminate redundant identity blit passes, as long as at least one pass remains:
+        firstlive = 0;
+        for (p = 0; (p < npasses) && (livepasses > 1); p++) {
+            if ((passSlots[p] == 1) && PsychPipelineIsRedundantIdentityBlitSlot(passFirst[p])) {
+                passFirst[p]->optSkip = 1;
+                if (p == firstlive) {
+                    // First live pass: Skip the flip to the next pass, which now reads from the source:
+                    passFlip[p + 1]->optSkip = 1;
+                    firstlive = p + 1;
+                }
+                else {
+                    // Later pass: Skip our own flip, so the preceding pass writes to our target:
+                    passFlip[p]->optSkip = 1;
+                }
+
+                livepasses--;
+                stats->eliminatedBlits++;
+            }
+        }
+
+        // Fuse runs of consecutive single-slot passes with fusable shaders. Only onscreen windows have
+        // the OpenGL context needed to create and manage the generated shaders:
+        if (PsychIsOnscreenWindow(windowRecord)) {
+            for (p = 0; p < npasses; p = q) {
+                q = p + 1;
+                if ((passSlots[p] != 1) || passFirst[p]->optSkip || !PsychPipelineIsFusableSlot(passFirst[p])) continue;
+
+                runlen = 1;
+                for (q = p + 1; q < npasses; q++) {
+                    // Skip eliminated passes:
+                    if ((passSlots[q] == 1) && (passFirst[q]->optSkip == 1)) continue;
+
+                    // Following stages must not need their own lookup texture on unit 1:
+                    if ((passSlots[q] != 1) || !PsychPipelineIsFusableSlot(passFirst[q]) || (passFirst[q]->luttexid1 > 0)) break;
+
+                    passFirst[q]->optSkip = 2;
+                    if (passFlip[q]->optSkip == 0) passFlip[q]->optSkip = 2;
+                    runlen++;
+                }
+
+                if (runlen > 1) {
+                    passFirst[p]->fusedStages = runlen;
+                    livepasses -= runlen - 1;
+                    stats->fusedSlots += runlen;
+                }
+            }
+        }
+    }
+
+    stats->optimizedPassCount = livepasses;
+
+    free(passFirst);
+    free(passFlip);
+    free(passSlots);
+
+    if ((PsychPrefStateGet_Verbosity() > 4) && (livepasses < npasses)) {
+        printf("PTB-DEBUG: Hook chain '%s' optimized from %i to %i passes: %i identity blits eliminated, %i shader slots fused.\n",
+               PsychHookPointNames[hookidx], npasses, livepasses, stats->eliminatedBlits, stats->fusedSlots);
+    }
+
+    return;
+}
+
+/* Return the concatenated source code of all shaders of type 'shaderType' attached to GLSL program 'glsl',
+ * or NULL if there are none. The caller must free() the returned string. Sets *otherShaders to TRUE if
+ * the program has shaders attached which are neither vertex nor fragment shaders.
+ */
+static char* PsychPipelineGetProgramSource(GLuint glsl, GLenum shaderType, psych_bool *otherShaders)
+{
+    GLuint shaders[16];
+    GLsizei count = 0, i;
+    GLint type, len, totallen = 0;
+    char *src = NULL;
+
+    glGetAttachedShaders(glsl, 16, &count, shaders);
+    for (i = 0; i < count; i++) {
+        glGetShaderiv(shaders[i], GL_SHADER_TYPE, &type);
+        if ((type != GL_VERTEX_SHADER) && (type != GL_FRAGMENT_SHADER)) *otherShaders = TRUE;
+        if ((GLenum) type != shaderType) continue;
+
+        glGetShaderiv(shaders[i], GL_SHADER_SOURCE_LENGTH, &len);
+        if (len <= 0) continue;
+
+        src = (char*) realloc(src, totallen + len + 2);
+        if (src == NULL) return(NULL);
+
+        glGetShaderSource(shaders[i], len, NULL, src + totallen);
+        totallen += (GLint) strlen(src + totallen);
+        src[totallen++] = '\n';
+        src[totallen] = 0;
+    }
+
+    return(src);
+}
+
+/* Append 'str' to the growable string *dst of current capacity *dstsize: */
+static void PsychPipelineAppendSource(char** dst, size_t* dstsize, const char* str)
+{
+    size_t len = (*dst) ? strlen(*dst) : 0;
+
+    if (len + strlen(str) + 1 > *dstsize) {
+        *dstsize = 2 * (*dstsize) + strlen(str) + 1;
+        *dst = (char*) realloc(*dst, *dstsize);
+        if (*dst == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Failed to allocate memory for fused hook chain shader.");
+        (*dst)[len] = 0;
+    }
+
+    strcat(*dst, str);
+}
+
+/* Move all #version and #extension directives from shader source 'src' into 'header', as they must
+ * precede all other code. Returns the highest #version found, or zero if none.
+ */
+static int PsychPipelineHoistDirectives(char* src, char** header, size_t* headersize)
+{
+    char *line, *p, *eol;
+    int version, maxversion = 0;
+
+    for (line = src; line && *line; line = (eol) ? eol + 1 : NULL) {
+        eol = strchr(line, '\n');
+        for (p = line; *p == ' ' || *p == '\t'; p++);
+
+        if (strncmp(p, "#version", 8) == 0) {
+            if ((sscanf(p, "#version %i", &version) == 1) && (version > maxversion)) maxversion = version;
+        }
+        else if (strncmp(p, "#extension", 10) == 0) {
+            if (eol) *eol = 0;
+            PsychPipelineAppendSource(header, headersize, p);
+            PsychPipelineAppendSource(header, headersize, "\n");
+            if (eol) *eol = '\n';
+        }
+        else {
+            continue;
+        }
+
+        // Blank out the directive in the original source:
+        while (*p && *p != '\n') *(p++) = ' ';
+    }
+
+    return(maxversion);
+}
+
+/* Return number of components of supported uniform types for fusion, negative for integer types, 0 if unsupported: */
+static int PsychPipelineFusableUniformComponents(GLenum type)
+{
+    switch (type) {
+        case GL_FLOAT:              return(1);
+        case GL_FLOAT_VEC2:         return(2);
+        case GL_FLOAT_VEC3:         return(3);
+        case GL_FLOAT_VEC4:         return(4);
+        case GL_FLOAT_MAT2:         return(4);
+        case GL_FLOAT_MAT3:         return(9);
+        case GL_FLOAT_MAT4:         return(16);
+        case GL_INT:
+        case GL_BOOL:
+        case GL_SAMPLER_1D:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_2D_RECT_ARB:
+        case GL_SAMPLER_2D_MULTISAMPLE:
+                                    return(-1);
+        case GL_INT_VEC2:
+        case GL_BOOL_VEC2:          return(-2);
+        case GL_INT_VEC3:
+        case GL_BOOL_VEC3:          return(-3);
+        case GL_INT_VEC4:
+        case GL_BOOL_VEC4:          return(-4);
+    }
+
+    return(0);
+}
+
+/* Copy current values of all uniforms of the original shaders of a fused slot into its fused shader: */
+static void PsychPipelineSyncFusedUniforms(PsychHookFunction* hookfunc)
+{
+    PsychFusedUniform *u = (PsychFusedUniform*) hookfunc->fusedUniforms;
+    GLfloat fv[16];
+    GLint iv[4];
+    int i;
+
+    glUseProgram(hookfunc->fusedShader);
+
+    for (i = 0; i < hookfunc->fusedUniformCount; i++, u++) {
+        if (PsychPipelineFusableUniformComponents(u->type) > 0) {
+            glGetUniformfv(u->srcProgram, u->srcLocation, fv);
+        }
+        else {
+            glGetUniformiv(u->srcProgram, u->srcLocation, iv);
+        }
+
+        switch (u->type) {
+            case GL_FLOAT:          glUniform1fv(u->dstLocation, 1, fv); break;
+            case GL_FLOAT_VEC2:     glUniform2fv(u->dstLocation, 1, fv); break;
+            case GL_FLOAT_VEC3:     glUniform3fv(u->dstLocation, 1, fv); break;
+            case GL_FLOAT_VEC4:     glUniform4fv(u->dstLocation, 1, fv); break;
+            case GL_FLOAT_MAT2:     glUniformMatrix2fv(u->dstLocation, 1, GL_FALSE, fv); break;
+            case GL_FLOAT_MAT3:     glUniformMatrix3fv(u->dstLocation, 1, GL_FALSE, fv); break;
+            case GL_FLOAT_MAT4:     glUniformMatrix4fv(u->dstLocation, 1, GL_FALSE, fv); break;
+            case GL_INT_VEC2:
+            case GL_BOOL_VEC2:      glUniform2iv(u->dstLocation, 1, iv); break;
+            case GL_INT_VEC3:
+            case GL_BOOL_VEC3:      glUniform3iv(u->dstLocation, 1, iv); break;
+            case GL_INT_VEC4:
+            case GL_BOOL_VEC4:      glUniform4iv(u->dstLocation, 1, iv); break;
+            default:                glUniform1iv(u->dstLocation, 1, iv); break;
+        }
+    }
+
+    glUseProgram(0);
+
+    return;
+}
+
+/* Compile and link a fused shader from the given sources, without error output, as failure just means
+ * that the slots are executed separately:
+ */
+static GLuint PsychPipelineLinkFusedShader(const char* fragmentsrc, const char* vertexsrc)
+{
+    GLuint glsl, shader;
+    GLint status;
+    char errtxt[4096];
+    int i;
+
+    glsl = glCreateProgram();
+    for (i = 0; i < 2; i++) {
+        const char* src = (i == 0) ? fragmentsrc : vertexsrc;
+        if (src == NULL) continue;
+
+        shader = glCreateShader((i == 0) ? GL_FRAGMENT_SHADER : GL_VERTEX_SHADER);
+        glShaderSource(shader, 1, (const char**) &src, NULL);
+        glCompileShader(shader);
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (status != GL_TRUE) {
+            if (PsychPrefStateGet_Verbosity() > 4) {
+                glGetShaderInfoLog(shader, sizeof(errtxt) - 1, NULL, (GLchar*) &errtxt);
+                printf("PTB-DEBUG: Compile of fused hook chain shader failed:\n%s\n%s\n", errtxt, src);
+            }
+
+            glDeleteShader(shader);
+            glDeleteProgram(glsl);
+            while (glGetError());
+            return(0);
+        }
+
+        glAttachShader(glsl, shader);
+
+        // Flag shader for deletion with the program:
+        glDeleteShader(shader);
+    }
+
+    glLinkProgram(glsl);
+    glGetProgramiv(glsl, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        if (PsychPrefStateGet_Verbosity() > 4) {
+            glGetProgramInfoLog(glsl, sizeof(errtxt) - 1, NULL, (GLchar*) &errtxt);
+            printf("PTB-DEBUG: Link of fused hook chain shader failed:\n%s\n", errtxt);
+        }
+
+        glDeleteProgram(glsl);
+        while (glGetError());
+        return(0);
+    }
+
+    while (glGetError());
+
+    return(glsl);
+}
+
+/* Create the fused shader for the group of fused slots starting with 'hookfunc'. Returns TRUE on success. */
+static psych_bool PsychPipelineCreateFusedShader(PsychHookFunction* hookfunc)
+{
+    PtrPsychHookFunction iter;
+    PsychFusedUniform *uniforms = NULL;
+    GLuint *programs;
+    char *header = NULL, *body = NULL, *src = NULL, *vertexsrc = NULL, *vs;
+    size_t headersize = 0, bodysize = 0;
+    char name[256], elemname[300], line[700];
+    char *bracket;
+    GLint nuniforms, size, e;
+    GLenum type;
+    int s, u, maxversion = 0, version, nentries = 0, maxentries = 0;
+    psych_bool otherShaders = FALSE, ok = TRUE;
+
+    // Collect the programs of all stages, in execution order:
+    programs = (GLuint*) calloc(hookfunc->fusedStages, sizeof(GLuint));
+    if (programs == NULL) return(FALSE);
+
+    programs[0] = hookfunc->shaderid;
+    for (iter = hookfunc->next, s = 1; iter && (s < hookfunc->fusedStages); iter = iter->next) {
+        if ((iter->optSkip == 2) && !PsychPipelineIsFlipFBOsSlot(iter)) programs[s++] = iter->shaderid;
+    }
+
+    // Only the first stage may have its own vertex shader, which is used unmodified for the fused shader:
+    vertexsrc = PsychPipelineGetProgramSource(programs[0], GL_VERTEX_SHADER, &otherShaders);
+
+    PsychPipelineAppendSource(&header, &headersize, "");
+    PsychPipelineAppendSource(&body, &bodysize, "");
+    for (s = 0; ok && (s < hookfunc->fusedStages); s++) {
+        src = PsychPipelineGetProgramSource(programs[s], GL_FRAGMENT_SHADER, &otherShaders);
+        if (s > 0) {
+            if ((vs = PsychPipelineGetProgramSource(programs[s], GL_VERTEX_SHADER, &otherShaders))) {
+                free(vs);
+                ok = FALSE;
+            }
+
+            if (src && !strstr(src, "PsychFusableStage")) ok = FALSE;
+        }
+
+        if ((src == NULL) || otherShaders || !ok) {
+            // Unsuitable stage: Missing per-pixel stage function, or unsupported types of shaders attached:
+            ok = FALSE;
+            break;
+        }
+
+        version = PsychPipelineHoistDirectives(src, &header, &headersize);
+        if (version > maxversion) maxversion = version;
+
+        // Rename main(), stage function and all uniforms of this stage to unique names:
+        sprintf(line, "\n#define main PsychFusedMain%i\n#define PsychFusableStage PsychFusableStage%i\n", s, s);
+        PsychPipelineAppendSource(&body, &bodysize, line);
+
+        glGetProgramiv(programs[s], GL_ACTIVE_UNIFORMS, &nuniforms);
+        for (u = 0; u < nuniforms; u++) {
+            glGetActiveUniform(programs[s], u, sizeof(name) - 1, NULL, &size, &type, (GLchar*) name);
+            if (strncmp(name, "gl_", 3) == 0) continue;
+            if ((bracket = strchr(name, '['))) *bracket = 0;
+
+            if (strchr(name, '.') || (PsychPipelineFusableUniformComponents(type) == 0)) {
+                // Uniform structs or unsupported types:
+                ok = FALSE;
+                break;
+            }
+
+            sprintf(line, "#define %s %s_PsychFused%i\n", name, name, s);
+            PsychPipelineAppendSource(&body, &bodysize, line);
+        }
+
+        PsychPipelineAppendSource(&body, &bodysize, src);
+        PsychPipelineAppendSource(&body, &bodysize, "\n#undef main\n#undef PsychFusableStage\n");
+
+        for (u = 0; u < nuniforms; u++) {
+            glGetActiveUniform(programs[s], u, sizeof(name) - 1, NULL, &size, &type, (GLchar*) name);
+            if (strncmp(name, "gl_", 3) == 0) continue;
+            if ((bracket = strchr(name, '['))) *bracket = 0;
+            sprintf(line, "#undef %s\n", name);
+            PsychPipelineAppendSource(&body, &bodysize, line);
+        }
+
+        free(src);
+        src = NULL;
+    }
+
+    if (ok) {
+        // Generated main(): Run the complete first stage, then pipe its result through all per-pixel stages:
+        PsychPipelineAppendSource(&body, &bodysize, "\nvoid main()\n{\n    PsychFusedMain0();\n");
+        for (s = 1; s < hookfunc->fusedStages; s++) {
+            sprintf(line, "    gl_FragColor = PsychFusableStage%i(gl_FragColor);\n", s);
+            PsychPipelineAppendSource(&body, &bodysize, line);
+        }
+        PsychPipelineAppendSource(&body, &bodysize, "}\n");
+
+        // Prepend #version and hoisted #extension directives:
+        src = NULL;
+        bodysize = 0;
+        if (maxversion > 0) {
+            sprintf(line, "#version %i\n", maxversion);
+            PsychPipelineAppendSource(&src, &bodysize, line);
+        }
+        else {
+            PsychPipelineAppendSource(&src, &bodysize, "");
+        }
+        PsychPipelineAppendSource(&src, &bodysize, header);
+        PsychPipelineAppendSource(&src, &bodysize, body);
+
+        hookfunc->fusedShader = PsychPipelineLinkFusedShader(src, vertexsrc);
+        ok = (hookfunc->fusedShader > 0) ? TRUE : FALSE;
+    }
+
+    // Build mapping of uniforms from the original programs to the fused program:
+    for (s = 0; ok && (s < hookfunc->fusedStages); s++) {
+        glGetProgramiv(programs[s], GL_ACTIVE_UNIFORMS, &nuniforms);
+        for (u = 0; u < nuniforms; u++) {
+            glGetActiveUniform(programs[s], u, sizeof(name) - 1, NULL, &size, &type, (GLchar*) name);
+            if (strncmp(name, "gl_", 3) == 0) continue;
+            if ((bracket = strchr(name, '['))) *bracket = 0;
+
+            for (e = 0; e < size; e++) {
+                if (nentries >= maxentries) {
+                    maxentries = 2 * maxentries + 16;
+                    uniforms = (PsychFusedUniform*) realloc(uniforms, maxentries * sizeof(PsychFusedUniform));
+                    if (uniforms == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Failed to allocate memory for fused hook chain shader.");
+                }
+
+                if (size > 1) sprintf(elemname, "%s[%i]", name, (int) e); else sprintf(elemname, "%s", name);
+                uniforms[nentries].srcProgram = programs[s];
+                uniforms[nentries].srcLocation = glGetUniformLocation(programs[s], elemname);
+
+                if (size > 1) sprintf(elemname, "%s_PsychFused%i[%i]", name, s, (int) e); else sprintf(elemname, "%s_PsychFused%i", name, s);
+                uniforms[nentries].dstLocation = glGetUniformLocation(hookfunc->fusedShader, elemname);
+                uniforms[nentries].type = type;
+
+                if ((uniforms[nentries].srcLocation != -1) && (uniforms[nentries].dstLocation != -1)) nentries++;
+            }
+        }
+    }
+
+    if (ok) {
+        hookfunc->fusedUniforms = (void*) uniforms;
+        hookfunc->fusedUniformCount = nentries;
+    }
+    else {
+        free(uniforms);
+    }
+
+    free(src);
+    free(vertexsrc);
+    free(header);
+    free(body);
+    free(programs);
+
+    while (glGetError());
+
+    return(ok);
+}
+
+/* Decide if the optimized execution plan of a hook chain can be used for this invocation, and create any
+ * not yet existing fused shaders. Returns TRUE if the optimized plan should be used.
+ */
+static psych_bool PsychPipelineUseOptimizedHookChain(PsychWindowRecordType *windowRecord, int hookId, void* hookUserData, void* hookBlitterFunction,
+                                                     PsychFBO** srcfbo1, PsychFBO** srcfbo2, PsychFBO** dstfbo, PsychFBO** bouncefbo)
+{
+    PsychHookChainStats *stats = &(windowRecord->HookChainStats[hookId]);
+    PtrPsychHookFunction hookfunc;
+    PsychFBO *src1 = (srcfbo1) ? *srcfbo1 : NULL;
+    PsychFBO *src2 = (srcfbo2) ? *srcfbo2 : NULL;
+    PsychFBO *dst = (dstfbo) ? *dstfbo : NULL;
+    PsychFBO *bounce = (bouncefbo) ? *bouncefbo : NULL;
+
+    // Anything optimized at all?
+    if ((stats->eliminatedBlits == 0) && (stats->fusedSlots == 0)) return(FALSE);
+
+    // Override blitters or override blit parameters would change the meaning of the skipped slots:
+    if (hookUserData || (hookBlitterFunction && (hookBlitterFunction != (void*) &PsychBlitterIdentity))) return(FALSE);
+
+    // Reading from the source directly or writing to the target directly is only safe without aliasing:
+    if (src1 && ((src1 == dst) || (src1 == bounce))) return(FALSE);
+    if (src2 && ((src2 == dst) || (src2 == bounce))) return(FALSE);
+
+    // Create fused shaders on first use:
+    for (hookfunc = windowRecord->HookChain[hookId]; hookfunc; hookfunc = hookfunc->next) {
+        if ((hookfunc->fusedStages > 0) && (hookfunc->fusedShader == 0) && !hookfunc->fusedFailed) {
+            // Only on the masterthread, not from async flipper threads with their own OpenGL contexts:
+            if (!PsychIsMasterThread()) return(FALSE);
+
+            PsychSetGLContext(windowRecord);
+            if (!PsychPipelineCreateFusedShader(hookfunc)) {
+                if (PsychPrefStateGet_Verbosity() > 3)
+                    printf("PTB-INFO: Could not fuse %i shader slots of hook chain '%s' into one shader. Executing them separately.\n",
+                           hookfunc->fusedStages, PsychHookPointNames[hookId]);
+
+                PsychPipelineUnfuseSlots(windowRecord, hookId, hookfunc);
+                hookfunc->fusedFailed = TRUE;
+            }
+        }
+    }
+
+    return(TRUE);
+}
+
+/* Setup the fused slot 'fusedfunc' for execution of the fused shader of 'hookfunc', and return a pointer to it: */
+static PsychHookFunction* PsychPipelinePrepareFusedSlot(PsychHookFunction* hookfunc, PsychHookFunction* fusedfunc)
+{
+    *fusedfunc = *hookfunc;
+    fusedfunc->shaderid = hookfunc->fusedShader;
+    PsychPipelineSyncFusedUniforms(hookfunc);
+
+    return(fusedfunc);
+}
+
+/* Per-pass gpu timing of hook chains, via GL_TIMESTAMP queries at pass boundaries. Timestamp queries don't
+ * interfere with a potentially active GL_TIME_ELAPSED query for Screen('GetWindowInfo') gpu render time
+ * measurement. Results are collected without blocking at the next execution of the chain.
+ */
+static psych_bool PsychPipelineBeginHookTiming(PsychWindowRecordType *windowRecord, int hookId)
+{
+    PsychHookChainStats *stats = &(windowRecord->HookChainStats[hookId]);
+    GLuint64 t0, t1;
+    GLint available = 0;
+    int i;
+
+    if (!stats->timingEnabled || !glQueryCounter || !glGetQueryObjectui64v || !PsychIsMasterThread()) return(FALSE);
+
+    if (stats->timingPending) {
+        // Results of last timed execution available? Otherwise skip timing of this execution:
+        glGetQueryObjectiv(stats->timerQueries[stats->timedPasses], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return(FALSE);
+
+        for (i = 0; i < stats->timedPasses; i++) {
+            glGetQueryObjectui64v(stats->timerQueries[i], GL_QUERY_RESULT, &t0);
+            glGetQueryObjectui64v(stats->timerQueries[i + 1], GL_QUERY_RESULT, &t1);
+            stats->gpuPassTime[i] = (double) (t1 - t0) / 1e9;
+        }
+
+        stats->measuredPasses = stats->timedPasses;
+        stats->timingPending = FALSE;
+    }
+
+    if (stats->timerQueries[0] == 0) glGenQueries(kPsychMaxTimedHookPasses + 1, &(stats->timerQueries[0]));
+
+    stats->timedPasses = 0;
+    glQueryCounter(stats->timerQueries[0], GL_TIMESTAMP);
+
+    return(TRUE);
+}
+
+static void PsychPipelineMarkHookTiming(PsychWindowRecordType *windowRecord, int hookId, psych_bool endOfChain)
+{
+    PsychHookChainStats *stats = &(windowRecord->HookChainStats[hookId]);
+
+    // More passes than timer queries? Then the last timed pass covers all remaining passes:
+    if (!endOfChain && (stats->timedPasses + 1 >= kPsychMaxTimedHookPasses)) return;
+
+    stats->timedPasses++;
+    glQueryCounter(stats->timerQueries[stats->timedPasses], GL_TIMESTAMP);
+    if (endOfChain) stats->timingPending = TRUE;
+
+    return;
+}
+
+/* Release all OpenGL resources of the optimizer and gpu timing of all hook chains of a window. */
+void PsychPipelineReleaseHookChainResources(PsychWindowRecordType *windowRecord)
+{
+    PtrPsychHookFunction hookfunc;
+    int i;
+
+    for (i = 0; i < MAX_SCREEN_HOOKS; i++) {
+        for (hookfunc = windowRecord->HookChain[i]; hookfunc; hookfunc = hookfunc->next) {
+            if (hookfunc->fusedShader) {
+                if (glDeleteProgram) glDeleteProgram(hookfunc->fusedShader);
+                hookfunc->fusedShader = 0;
+                hookfunc->fusedFailed = TRUE;
+            }
+        }
+
+        if (windowRecord->HookChainStats[i].timerQueries[0]) {
+            glDeleteQueries(kPsychMaxTimedHookPasses + 1, &(windowRecord->HookChainStats[i].timerQueries[0]));
+            memset(&(windowRecord->HookChainStats[i].timerQueries[0]), 0, sizeof(windowRecord->HookChainStats[i].timerQueries));
+        }
+
+        windowRecord->HookChainStats[i].timingPending = FALSE;
+    }
+
+    return;
+}
+
 /* Internal: PsychAddNewHookFunction()  - Add a new hook callback function to a hook-chain.
  * This helper function allocates a hook func struct, enqueues it into a hook chain and sets
  * all common struct fields to their proper values. Then it returns a pointer to the struct, so
@@ -3622,6 +4360,7 @@ void PsychPipelineResetHook(PsychWindowRecordType *windowRecord, const char* hoo
         hookfunc = hookiter;
         hookiter = hookiter->next;
         // Delete all referenced memory:
+        PsychPipelineReleaseFusedShader(windowRecord, hookfunc);
         free(hookfunc->idString);
         free(hookfunc->pString1);
         // Delete hookfunc struct itself:
@@ -3630,6 +4369,10 @@ void PsychPipelineResetHook(PsychWindowRecordType *windowRecord, const char* hoo
 
     // Null-out hook chain:
     windowRecord->HookChain[hookidx]=NULL;
+
+    // Reset optimizer statistics:
+    PsychPipelineOptimizeHookChain(windowRecord, hookidx);
+
     return;
 }
 
@@ -3654,6 +4397,9 @@ void PsychPipelineAddShaderToHook(PsychWindowRecordType *windowRecord, const cha
     hookfunc->shaderid =  shaderid;
     hookfunc->pString1 =  (blitterString) ? strdup(blitterString) : strdup("");
     hookfunc->luttexid1 = luttexid1;
+
+    // Update optimized execution plan of modified chain:
+    PsychPipelineOptimizeHookChain(windowRecord, PsychGetHookByName(hookString));
     return;
 }
 
@@ -3675,6 +4421,9 @@ void PsychPipelineAddCFunctionToHook(PsychWindowRecordType *windowRecord, const
     PtrPsychHookFunction hookfunc = PsychAddNewHookFunction(windowRecord, hookString, idString, where, kPsychCFunc);
     // Init remaining fields:
     hookfunc->cprocfunc =  procPtr;
+
+    // Update optimized execution plan of modified chain:
+    PsychPipelineOptimizeHookChain(windowRecord, PsychGetHookByName(hookString));
     return;
 }
 
@@ -3699,6 +4448,9 @@ void PsychPipelineAddRuntimeFunctionToHook(PsychWindowRecordType *windowRecord,
     PtrPsychHookFunction hookfunc = PsychAddNewHookFunction(windowRecord, hookString, idString, where, kPsychMFunc);
     // Init remaining fields:
     hookfunc->pString1 =  (evalString) ? strdup(evalString) : strdup("");
+
+    // Update optimized execution plan of modified chain:
+    PsychPipelineOptimizeHookChain(windowRecord, PsychGetHookByName(hookString));
     return;
 }
 
@@ -3719,6 +4471,9 @@ void PsychPipelineAddBuiltinFunctionToHook(PsychWindowRecordType *windowRecord,
     PtrPsychHookFunction hookfunc = PsychAddNewHookFunction(windowRecord, hookString, idString, where, kPsychBuiltinFunc);
     // Init remaining fields:
     hookfunc->pString1 =  (configString) ? strdup(configString) : strdup("");
+
+    // Update optimized execution plan of modified chain:
+    PsychPipelineOptimizeHookChain(windowRecord, PsychGetHookByName(hookString));
     return;
 }
 
@@ -3752,11 +4507,15 @@ void PsychPipelineDeleteHookSlot(PsychWindowRecordType *windowRecord, const char
     *prehookfunc = hookfunc->next;
 
     // Detached. Delete hookfunc:
+    PsychPipelineReleaseFusedShader(windowRecord, hookfunc);
     free(hookfunc->pString1);
     free(hookfunc->idString);
     free(hookfunc);
     hookfunc = NULL;
 
+    // Update optimized execution plan of modified chain:
+    PsychPipelineOptimizeHookChain(windowRecord, hookidx);
+
     // Done.
     return;
 }
@@ -3850,6 +4609,7 @@ int PsychPipelineQueryHookSlot(PsychWindowRecordType *windowRecord, const char*
 void PsychPipelineDumpHook(PsychWindowRecordType *windowRecord, const char* hookString)
 {
     PtrPsychHookFunction hookfunc;
+    PsychHookChainStats *stats;
     int i=0;
     int hookidx=PsychGetHookByName(hookString);
     if (hookidx==-1) PsychErrorExitMsg(PsychError_user, "DumpHook: Unknown (non-existent) hook name provided.");
@@ -3889,6 +4649,14 @@ void PsychPipelineDumpHook(PsychWindowRecordType *windowRecord, const char* hook
         hookfunc = hookfunc->next;
     }
 
+    if (windowRecord->HookChain[hookidx]) {
+        stats = &(windowRecord->HookChainStats[hookidx]);
+        printf("=====================================================\n");
+        printf("Passes: %i as specified, %i after optimization (%i identity blits eliminated, %i shader slots fused).\n",
+               stats->passCount, stats->optimizedPassCount, stats->eliminatedBlits, stats->fusedSlots);
+        for (i = 0; i < stats->measuredPasses; i++) printf("Pass %i: Last gpu execution time %f msecs.\n", i, stats->gpuPassTime[i] * 1000.0);
+    }
+
     printf("=====================================================\n\n");
     fflush(NULL);
     return;
@@ -3930,7 +4698,10 @@ psych_bool PsychIsHookChainOperational(PsychWindowRecordType *windowRecord, int
  */
 psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hookId, void* hookUserData, void* hookBlitterFunction, psych_bool srcIsReadonly, psych_bool allowFBOSwizzle, PsychFBO** srcfbo1, PsychFBO** srcfbo2, PsychFBO** dstfbo, PsychFBO** bouncefbo)
 {
-    PtrPsychHookFunction hookfunc;
+    PtrPsychHookFunction hookfunc, slotfunc;
+    PsychHookFunction fusedfunc;
+    psych_bool optimized = FALSE;
+    psych_bool timed = FALSE;
     int i=0;
     int pendingFBOpingpongs = 0;
     PsychFBO *mysrcfbo1, *mysrcfbo2, *mydstfbo, *mynxtfbo;
@@ -3950,16 +4721,21 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
         return(TRUE);
     }
 
+    PsychTrace(kPsychTraceHookBegin, hookId);
+
     // Is this an image processing hook?
     gfxprocessing = (dstfbo!=NULL) ? TRUE : FALSE;
 
+    // Use optimized execution plan of the chain, if any, and if possible for this invocation:
+    if (gfxprocessing) optimized = PsychPipelineUseOptimizedHookChain(windowRecord, hookId, hookUserData, hookBlitterFunction, srcfbo1, srcfbo2, dstfbo, bouncefbo);
+
     // Get start of enabled chain:
     hookfunc = windowRecord->HookChain[hookId];
 
     // Count number of needed ping-pong FBO switches inside this chain:
     while(hookfunc) {
-        // Pingpong command?
-        if (hookfunc->hookfunctype == kPsychBuiltinFunc && strcmp(hookfunc->idString, "Builtin:FlipFBOs")==0) pendingFBOpingpongs++;
+        // Pingpong command, not skipped by optimized plan?
+        if (hookfunc->hookfunctype == kPsychBuiltinFunc && strcmp(hookfunc->idString, "Builtin:FlipFBOs")==0 && !(optimized && hookfunc->optSkip)) pendingFBOpingpongs++;
         // Process next hookfunc slot in chain, if any:
         hookfunc = hookfunc->next;
     }
@@ -4030,6 +4806,9 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
 
         // Setup initial source -> target binding:
         PsychPipelineSetupRenderFlow(mysrcfbo1, mysrcfbo2, mydstfbo, scissor_ignore);
+
+        // Start per-pass gpu timing if requested:
+        timed = PsychPipelineBeginHookTiming(windowRecord, hookId);
     }
 
     // Reget start of enabled chain:
@@ -4037,6 +4816,13 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
 
     // Iterate over all slots:
     while(hookfunc) {
+        // Skip slots which are redundant or fused into a preceding slot in the optimized plan:
+        if (optimized && hookfunc->optSkip) {
+            i++;
+            hookfunc = hookfunc->next;
+            continue;
+        }
+
         // Debug output, if requested:
         if (PsychPrefStateGet_Verbosity()>4) {
             printf("Hookchain '%s' : Slot %i: Id='%s' : ", PsychHookPointNames[hookId], i, hookfunc->idString);
@@ -4082,6 +4868,9 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
 
             // Set new src -> dst binding:
             PsychPipelineSetupRenderFlow(mysrcfbo1, mysrcfbo2, mydstfbo, scissor_ignore);
+
+            // Timestamp for start of next pass:
+            if (timed) PsychPipelineMarkHookTiming(windowRecord, hookId, FALSE);
         }
         else {
             // Restricted area processing?
@@ -4091,6 +4880,7 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
                 // ROI (-1,-1,-1,-1) means: Disable scissor testing -> Unrestrict.
                 if (4!=sscanf(hookfunc->pString1, "%i:%i:%i:%i", &sciss_x, &sciss_y, &sciss_w, &sciss_h)) {
                     if (PsychPrefStateGet_Verbosity()>0) printf("PTB-ERROR: In PsychPipelineExecuteHook: Builtin:RestrictToScissorROI - Parameter parse error in string %s\n", hookfunc->idString);
+                    PsychTrace(kPsychTraceHookEnd, hookId);
                     return(FALSE);
                 }
 
@@ -4112,12 +4902,14 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
                 PsychSetGLContext(windowRecord);
             }
             else {
-                // Normal hook function - Process this hook function:
-                if (!PsychPipelineExecuteHookSlot(windowRecord, hookId, hookfunc, hookUserData, hookBlitterFunction, srcIsReadonly, allowFBOSwizzle, &mysrcfbo1, &mysrcfbo2, &mydstfbo, &mynxtfbo)) {
+                // Normal hook function - Process this hook function, or the generated shader of a group of fused slots:
+                slotfunc = (optimized && hookfunc->fusedShader) ? PsychPipelinePrepareFusedSlot(hookfunc, &fusedfunc) : hookfunc;
+                if (!PsychPipelineExecuteHookSlot(windowRecord, hookId, slotfunc, hookUserData, hookBlitterFunction, srcIsReadonly, allowFBOSwizzle, &mysrcfbo1, &mysrcfbo2, &mydstfbo, &mynxtfbo)) {
                     // Failed!
                     if (PsychPrefStateGet_Verbosity()>0) {
                         printf("PTB-ERROR: Failed in processing of Hookchain '%s' : Slot %i: Id='%s'  --> Aborting chain processing. Set verbosity to 5 for extended debug output.\n", PsychHookPointNames[hookId], i, hookfunc->idString);
                     }
+                    PsychTrace(kPsychTraceHookEnd, hookId);
                     return(FALSE);
                 }
             }
@@ -4129,6 +4921,9 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
     }
 
     if (gfxprocessing) {
+        // Timestamp for end of last pass:
+        if (timed) PsychPipelineMarkHookTiming(windowRecord, hookId, TRUE);
+
         // Disable renderflow:
         PsychPipelineSetupRenderFlow(NULL, NULL, NULL, scissor_ignore);
 
@@ -4152,6 +4947,8 @@ psych_bool PsychPipelineExecuteHook(PsychWindowRecordType *windowRecord, int hoo
         }
     }
 
+    PsychTrace(kPsychTraceHookEnd, hookId);
+
     // Done.
     return(TRUE);
 }
@@ -178,7 +178,13 @@ void PsychDeleteAllMovies(void)
 int PsychGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int checkForImage, double timeindex, PsychWindowRecordType *out_texture, double *presentation_timestamp)
 {
     #ifdef PTB_USE_GSTREAMER
-    return(PsychGSGetTextureFromMovie(win, moviehandle, checkForImage, timeindex, out_texture, presentation_timestamp));
+    int rc;
+
+    PsychTrace(kPsychTraceMovieFetchBegin, moviehandle);
+    rc = PsychGSGetTextureFromMovie(win, moviehandle, checkForImage, timeindex, out_texture, presentation_timestamp);
+    PsychTrace(kPsychTraceMovieFetchEnd, moviehandle);
+
+    return(rc);
     #endif
 
     PsychErrorExitMsg(PsychError_unimplemented, "Sorry, Movie playback support not supported on your configuration.");
@@ -275,3 +281,16 @@ void PsychCopyOutMovieHDRMetaData(int moviehandle, int argPosition)
 
     PsychErrorExitMsg(PsychError_unimplemented, "Sorry, Movie playback support not supported on your configuration.");
 }
+
+/*
+ *  PsychCopyOutMovieStatistics() -- Return a struct with decode-ahead and frame fetch statistics of this movie to scripting environment.
+ */
+void PsychCopyOutMovieStatistics(int moviehandle, int argPosition, psych_bool reset)
+{
+    #ifdef PTB_USE_GSTREAMER
+    PsychGSCopyOutMovieStatistics(moviehandle, argPosition, reset);
+    return;
+    #endif
+
+    PsychErrorExitMsg(PsychError_unimplemented, "Sorry, Movie playback support not supported on your configuration.");
+}
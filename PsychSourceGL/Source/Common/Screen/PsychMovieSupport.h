@@ -48,5 +48,6 @@ void PsychExitMovies(void);
 double PsychGetMovieTimeIndex(int moviehandle);
 double PsychSetMovieTimeIndex(int moviehandle, double timeindex, psych_bool indexIsFrames);
 void PsychCopyOutMovieHDRMetaData(int moviehandle, int argPosition);
+void PsychCopyOutMovieStatistics(int moviehandle, int argPosition, psych_bool reset);
 //end include once
 #endif
@@ -6,11 +6,16 @@
     AUTHORS:
 
     mario.kleiner.de@gmail.com      mk  Mario Kleiner
+    agent@local                     ag  agent
 
     HISTORY:
 
         28.11.2010    mk      Wrote it.
         20.08.2014    mk      Ported to GStreamer-1.4.x and later.
+        19.10.2026    ag      Texture pool, PrefetchFrames option and playback statistics.
+        19.10.2026    ag      Upload decoded frames ahead of fetch on a thread with a shared OpenGL context.
+        19.10.2026    ag      Optional seek index with LRU frame cache for frame-accurate seeking.
+        19.10.2026    ag      Optional zero-copy import of DMA-BUF video frames via DmaBufImport=1.
 
     DESCRIPTION:
 
@@ -26,7 +31,9 @@
 
 #include "Screen.h"
 #include <glib.h>
+#include <glib/gstdio.h>
 #include "PsychMovieSupportGStreamer.h"
+#include "PsychDmaBufImportSupport.h"
 #include <gst/gst.h>
 
 // Include for dynamic binding of optional functions (dlsym()), only needed for Unix:
@@ -66,6 +73,33 @@ typedef enum {
 
 #define PSYCH_MAX_MOVIES 100
 
+// Maximum number of recycled textures in the texture pool of a movie:
+#define PSYCH_MAX_MOVIE_TEXTUREPOOL 16
+
+// Size of the ring of arrival times of decoded frames, for latency statistics:
+#define PSYCH_MAX_MOVIE_ARRIVALS 256
+
+// Maximum and default number of decoded frames in the LRU cache of indexed seeking:
+#define PSYCH_MAX_MOVIE_SEEKCACHE 64
+#define PSYCH_DEFAULT_MOVIE_SEEKCACHE 8
+
+// Magic tag of seek index sidecar files:
+#define PSYCH_MOVIE_SEEKINDEX_MAGIC "PTBMOVIEINDEX1"
+
+// One entry per video frame in the seek index, in presentation order:
+typedef struct {
+    gint64  pts;            // Presentation timestamp of the frame in nanoseconds.
+    int     keyframe;       // Index of the nearest keyframe at or before this frame.
+} PsychMovieIndexEntry;
+
+// One decoded frame uploaded into a texture by the upload thread of a movie, ahead of its fetch:
+typedef struct {
+    GstSample*  sample;     // The decoded frame, kept for fetches which can not use the uploaded texture.
+    GLuint      texture;    // Texture object with the uploaded frame.
+    GLsync      fence;      // Fence behind the upload, to wait for before the texture is used in another context.
+    double      tArrival;   // Arrival time of the decoded frame in the videosink, or zero if unknown.
+} PsychMovieUploadedFrame;
+
 typedef struct {
     psych_bool valid;
     int type;
@@ -109,7 +143,47 @@ typedef struct {
     int                 nrVideoTracks;
     char                movieLocation[FILENAME_MAX];
     char                movieName[FILENAME_MAX];
-    GLuint              cached_texture;
+    GLuint              texturePool[PSYCH_MAX_MOVIE_TEXTUREPOOL];   // Pool of texture objects for recycling in fetched frames.
+    GLsync              texturePoolFence[PSYCH_MAX_MOVIE_TEXTUREPOOL];  // Fence behind last use of each pooled texture in another OpenGL context, or NULL.
+    int                 texturePoolCount;                           // Number of textures currently in texturePool.
+    int                 texturePoolCapacity;                        // Maximum number of textures to keep in texturePool.
+    int                 prefetchFrames;                             // Decode-ahead depth from 'PrefetchFrames=' movieOptions, or 0 for default.
+    int                 queueCapacity;                              // Capacity of the videosinks queue of decoded frames, 0 = unlimited.
+    double              arrivalTimes[PSYCH_MAX_MOVIE_ARRIVALS];     // Ring of arrival times of queued decoded frames in playback mode.
+    int                 arrivalHead;                                // Index of oldest entry in arrivalTimes.
+    int                 arrivalCount;                               // Number of entries in arrivalTimes.
+    int                 maxQueueDepth;                              // Statistics: Maximum number of queued decoded frames.
+    int                 framesFetched;                              // Statistics: Number of frames fetched in playback mode.
+    int                 lateFrames;                                 // Statistics: Frames fetched more than one frame duration after decode.
+    int                 skippedFrames;                              // Statistics: Frames skipped to reach a requested timeindex.
+    int                 recycledTextures;                           // Statistics: Number of fetches which recycled a pooled texture.
+    double              latencySum;                                 // Statistics: Sum of decode to fetch latencies.
+    double              maxLatency;                                 // Statistics: Maximum decode to fetch latency.
+    PsychMovieIndexEntry* seekIndex;                                // Optional seek index of all video frames, or NULL.
+    int                 seekIndexCount;                             // Number of frames in seekIndex.
+    int                 seekIndexPosition;                          // Frame index of last frame decoded by indexed seeking, -1 if unknown.
+    psych_bool          seekIndexRequested;                         // Seek index requested via 'SeekIndex=' movieOptions.
+    psych_bool          seekIndexStale;                             // Seek index needs to be rebuilt for a newly queued movie.
+    GstSample*          seekCache[PSYCH_MAX_MOVIE_SEEKCACHE];       // LRU cache of recently decoded frames of indexed seeking.
+    int                 seekCacheFrame[PSYCH_MAX_MOVIE_SEEKCACHE];  // Frame index of each seekCache slot.
+    unsigned int        seekCacheUse[PSYCH_MAX_MOVIE_SEEKCACHE];    // Last use of each seekCache slot, for LRU replacement.
+    unsigned int        seekCacheClock;                             // Counter for seekCacheUse.
+    int                 seekCacheCapacity;                          // Number of seekCache slots in use.
+    GstSample*          pendingSample;                              // Frame to return by next fetch in manual mode instead of preroll, or NULL.
+    int                 dmaBufImport;                               // 1 = Try zero-copy import of DMA-BUF video frames, from 'DmaBufImport=1' movieOptions.
+    int                 zeroCopyFrames;                             // Statistics: Number of frames imported as textures without copy.
+    int                 copiedFrames;                               // Statistics: Number of frames uploaded into textures by copy.
+    int                 uploadState;                                // Upload thread: 0 = None yet, 1 = Starting, 2 = Running, 3 = Unsupported, upload on fetch.
+    int                 uploadEnabled;                              // Upload thread shall pull and upload decoded frames, ie., playback is active.
+    int                 uploadStop;                                 // Upload thread shall exit.
+    int                 uploadPending;                              // Upload thread is uploading a frame pulled from the videosink.
+    psych_thread        uploadThread;                               // Thread which uploads decoded frames into textures ahead of fetch.
+    void*               uploadContext;                              // Shared OpenGL context of the upload thread.
+    GLenum              uploadTarget;                               // Texture target of uploaded textures.
+    PsychMovieUploadedFrame uploadedFrames[PSYCH_MAX_MOVIE_TEXTUREPOOL];  // Ring of frames uploaded ahead of fetch.
+    int                 uploadedHead;                               // Index of oldest entry in uploadedFrames.
+    int                 uploadedCount;                              // Number of entries in uploadedFrames.
+    int                 preUploadedFrames;                          // Statistics: Number of fetched frames uploaded ahead of fetch by the upload thread.
     PsychMovieHDRMetaData hdrMetaData;
     GstVideoInfo        codecVideoInfo;
     GstVideoInfo        sinkVideoInfo;
@@ -1388,6 +1462,22 @@ static void PsychEOSCallback(GstAppSink *sink, gpointer user_data)
     return;
 }
 
+/* Remove and return the arrival time of the oldest queued decoded frame, or zero if unknown.
+ * Must be called with movie->mutex held.
+ */
+static double PsychPopMovieFrameArrival(PsychMovieRecordType* movie)
+{
+    double tArrival;
+
+    if (movie->arrivalCount == 0) return(0);
+
+    tArrival = movie->arrivalTimes[movie->arrivalHead];
+    movie->arrivalHead = (movie->arrivalHead + 1) % PSYCH_MAX_MOVIE_ARRIVALS;
+    movie->arrivalCount--;
+
+    return(tArrival);
+}
+
 /* Called whenever an active seek has completed or pipeline goes into pause.
  * Signals/handles arrival of preroll buffers. Used to detect/signal when
  * new videobuffers are available in non-playback mode.
@@ -1400,7 +1490,7 @@ static GstFlowReturn PsychNewPrerollCallback(GstAppSink *sink, gpointer user_dat
     PsychLockMutex(&movie->mutex);
     //printf("PTB-DEBUG: New PrerollBuffer received.\n");
     movie->preRollAvail++;
-    PsychSignalCondition(&movie->condition);
+    PsychBroadcastCondition(&movie->condition);
     PsychUnlockMutex(&movie->mutex);
 
     return(GST_FLOW_OK);
@@ -1412,12 +1502,27 @@ static GstFlowReturn PsychNewPrerollCallback(GstAppSink *sink, gpointer user_dat
 static GstFlowReturn PsychNewBufferCallback(GstAppSink *sink, gpointer user_data)
 {
     PsychMovieRecordType* movie = (PsychMovieRecordType*) user_data;
+    double tNow;
     (void) sink;
 
+    PsychGetAdjustedPrecisionTimerSeconds(&tNow);
+
     PsychLockMutex(&movie->mutex);
     //printf("PTB-DEBUG: New Buffer received.\n");
     movie->frameAvail++;
-    PsychSignalCondition(&movie->condition);
+
+    // Track arrival time of this frame for latency statistics. Mirror the videosinks dropping of
+    // the oldest queued frame if its queue is full:
+    if ((movie->arrivalCount == PSYCH_MAX_MOVIE_ARRIVALS) || ((movie->queueCapacity > 0) && (movie->arrivalCount >= movie->queueCapacity))) {
+        movie->arrivalHead = (movie->arrivalHead + 1) % PSYCH_MAX_MOVIE_ARRIVALS;
+        movie->arrivalCount--;
+    }
+    movie->arrivalTimes[(movie->arrivalHead + movie->arrivalCount) % PSYCH_MAX_MOVIE_ARRIVALS] = tNow;
+    movie->arrivalCount++;
+    if (movie->arrivalCount > movie->maxQueueDepth) movie->maxQueueDepth = movie->arrivalCount;
+
+    // Wake up both a fetch waiting in Screen('GetMovieImage') and the upload thread, if any:
+    PsychBroadcastCondition(&movie->condition);
     PsychUnlockMutex(&movie->mutex);
 
     return(GST_FLOW_OK);
@@ -1604,6 +1709,698 @@ hwPluginEnableOut:
     return(rc);
 }
 
+/* Link the video stream found by the seek index builder to its appsink, discard all other streams. */
+static void PsychMovieIndexPadAddedCallback(GstElement *parser, GstPad *pad, gpointer user_data)
+{
+    GstElement* pipeline = (GstElement*) user_data;
+    GstElement* indexsink;
+    GstPad*     sinkpad;
+    GstCaps*    caps;
+    psych_bool  isVideo = FALSE;
+    (void) parser;
+
+    caps = gst_pad_get_current_caps(pad);
+    if (!caps) caps = gst_pad_query_caps(pad, NULL);
+    if (caps && (gst_caps_get_size(caps) > 0))
+        isVideo = g_str_has_prefix(gst_structure_get_name(gst_caps_get_structure(caps, 0)), "video/");
+    if (caps) gst_caps_unref(caps);
+
+    indexsink = gst_bin_get_by_name(GST_BIN(pipeline), "ptbindexsink");
+    sinkpad = gst_element_get_static_pad(indexsink, "sink");
+
+    if (!isVideo || gst_pad_is_linked(sinkpad)) {
+        // Not the first video stream: Link to a fakesink, so its data doesn't stall the demuxer:
+        gst_object_unref(sinkpad);
+        gst_object_unref(indexsink);
+        indexsink = gst_element_factory_make("fakesink", NULL);
+        gst_object_ref(indexsink);
+        gst_bin_add(GST_BIN(pipeline), indexsink);
+        gst_element_sync_state_with_parent(indexsink);
+        sinkpad = gst_element_get_static_pad(indexsink, "sink");
+    }
+
+    if ((GST_PAD_LINK_OK != gst_pad_link(pad, sinkpad)) && (PsychPrefStateGet_Verbosity() > 1))
+        printf("PTB-WARNING: Failed to link stream of movie to seek index builder.\n");
+
+    gst_object_unref(sinkpad);
+    gst_object_unref(indexsink);
+
+    return;
+}
+
+/* Order seek index entries by presentation timestamp. */
+static int PsychMovieIndexCompare(const void* a, const void* b)
+{
+    gint64 ptsA = ((const PsychMovieIndexEntry*) a)->pts;
+    gint64 ptsB = ((const PsychMovieIndexEntry*) b)->pts;
+
+    return((ptsA < ptsB) ? -1 : ((ptsA > ptsB) ? 1 : 0));
+}
+
+/* Get size and modification time of the movie file, to validate seek index sidecar files. Zero for non-file URI's. */
+static void PsychGSGetMovieSourceStamp(PsychMovieRecordType* movie, gint64* size, gint64* mtime)
+{
+    GStatBuf    st;
+    gchar*      filename = g_filename_from_uri(movie->movieLocation, NULL, NULL);
+
+    *size = *mtime = 0;
+    if (filename && (g_stat(filename, &st) == 0)) {
+        *size = (gint64) st.st_size;
+        *mtime = (gint64) st.st_mtime;
+    }
+
+    g_free(filename);
+}
+
+/* Build the seek index of a movie, by demuxing and parsing, but not decoding, its first video stream.
+ * Returns TRUE on success, FALSE if the movie does not provide the needed timestamps or keyframe flags.
+ */
+static psych_bool PsychGSBuildSeekIndex(PsychMovieRecordType* movie)
+{
+    GstElement*             pipeline;
+    GstElement*             parser;
+    GstElement*             indexsink;
+    GstSample*              sample;
+    GstBuffer*              buffer;
+    GError*                 error = NULL;
+    PsychMovieIndexEntry*   entries = NULL;
+    PsychMovieIndexEntry*   newEntries;
+    char                    pipelineSpec[FILENAME_MAX + 64];
+    int                     count = 0, capacity = 0, keyframe, i;
+    psych_bool              rc = TRUE;
+
+    snprintf(pipelineSpec, sizeof(pipelineSpec), "urisourcebin uri=\"%s\" ! parsebin name=ptbindexparser", movie->movieLocation);
+    pipeline = gst_parse_launch((const gchar*) pipelineSpec, &error);
+    if (error) g_error_free(error);
+    if (!pipeline) {
+        if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: Failed to create seek index builder for movie [%s].\n", movie->movieName);
+        return(FALSE);
+    }
+
+    indexsink = gst_element_factory_make("appsink", "ptbindexsink");
+    g_object_set(G_OBJECT(indexsink), "sync", FALSE, NULL);
+    gst_bin_add(GST_BIN(pipeline), indexsink);
+
+    parser = gst_bin_get_by_name(GST_BIN(pipeline), "ptbindexparser");
+    g_signal_connect(G_OBJECT(parser), "pad-added", G_CALLBACK(PsychMovieIndexPadAddedCallback), pipeline);
+    gst_object_unref(parser);
+
+    gst_element_set_state(pipeline, GST_STATE_PLAYING);
+
+    // Collect timestamp and keyframe flag of each compressed video frame, in decode order. Give up if
+    // nothing arrives for 10 seconds, e.g., because the movie has no video stream:
+    while ((sample = gst_app_sink_try_pull_sample(GST_APP_SINK(indexsink), 10 * GST_SECOND))) {
+        buffer = gst_sample_get_buffer(sample);
+        if (!GST_BUFFER_PTS_IS_VALID(buffer)) {
+            gst_sample_unref(sample);
+            rc = FALSE;
+            break;
+        }
+
+        if (count == capacity) {
+            capacity = (capacity > 0) ? 2 * capacity : 4096;
+            newEntries = (PsychMovieIndexEntry*) realloc(entries, capacity * sizeof(PsychMovieIndexEntry));
+            if (!newEntries) {
+                gst_sample_unref(sample);
+                rc = FALSE;
+                break;
+            }
+            entries = newEntries;
+        }
+
+        entries[count].pts = (gint64) GST_BUFFER_PTS(buffer);
+        entries[count].keyframe = (GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT)) ? 0 : 1;
+        count++;
+
+        gst_sample_unref(sample);
+    }
+
+    if (rc && !gst_app_sink_is_eos(GST_APP_SINK(indexsink))) rc = FALSE;
+
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(pipeline);
+
+    if (!rc || (count == 0)) {
+        if (PsychPrefStateGet_Verbosity() > 1)
+            printf("PTB-WARNING: Could not build seek index for movie [%s]: Movie lacks a video stream with timestamps. Using regular seeking.\n", movie->movieName);
+        free(entries);
+        return(FALSE);
+    }
+
+    // Sort into presentation order and assign nearest preceding keyframe to each frame:
+    qsort(entries, count, sizeof(PsychMovieIndexEntry), PsychMovieIndexCompare);
+    for (i = 0, keyframe = 0; i < count; i++) {
+        if (entries[i].keyframe) keyframe = i;
+        entries[i].keyframe = keyframe;
+    }
+
+    movie->seekIndex = entries;
+    movie->seekIndexCount = count;
+
+    return(TRUE);
+}
+
+/* Load seek index from sidecar file, if it exists and matches the movie file. */
+static psych_bool PsychGSLoadSeekIndex(PsychMovieRecordType* movie, const char* filename)
+{
+    FILE*                   fd;
+    char                    magic[16];
+    gint64                  size, mtime, fileSize, fileMtime;
+    gint32                  count, i, keyframe;
+    PsychMovieIndexEntry*   entries;
+
+    if (!(fd = fopen(filename, "rb"))) return(FALSE);
+
+    PsychGSGetMovieSourceStamp(movie, &size, &mtime);
+    if ((fread(magic, sizeof(magic), 1, fd) != 1) || strncmp(magic, PSYCH_MOVIE_SEEKINDEX_MAGIC, sizeof(magic)) ||
+        (fread(&fileSize, sizeof(fileSize), 1, fd) != 1) || (fread(&fileMtime, sizeof(fileMtime), 1, fd) != 1) ||
+        (fread(&count, sizeof(count), 1, fd) != 1) || (fileSize != size) || (fileMtime != mtime) || (count <= 0) ||
+        !(entries = (PsychMovieIndexEntry*) malloc(count * sizeof(PsychMovieIndexEntry)))) {
+        fclose(fd);
+        return(FALSE);
+    }
+
+    for (i = 0; i < count; i++) {
+        if ((fread(&entries[i].pts, sizeof(gint64), 1, fd) != 1) || (fread(&keyframe, sizeof(keyframe), 1, fd) != 1) ||
+            (keyframe < 0) || (keyframe > i)) {
+            free(entries);
+            fclose(fd);
+            return(FALSE);
+        }
+        entries[i].keyframe = (int) keyframe;
+    }
+
+    fclose(fd);
+
+    movie->seekIndex = entries;
+    movie->seekIndexCount = count;
+
+    return(TRUE);
+}
+
+/* Store seek index of a movie in sidecar file, for fast reuse on next open. */
+static void PsychGSSaveSeekIndex(PsychMovieRecordType* movie, const char* filename)
+{
+    FILE*   fd;
+    char    magic[16];
+    gint64  size, mtime;
+    gint32  count, i, keyframe;
+    int     rc = 1;
+
+    if (!(fd = fopen(filename, "wb"))) {
+        if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: Could not write movie seek index file [%s].\n", filename);
+        return;
+    }
+
+    memset(magic, 0, sizeof(magic));
+    strncpy(magic, PSYCH_MOVIE_SEEKINDEX_MAGIC, sizeof(magic) - 1);
+    PsychGSGetMovieSourceStamp(movie, &size, &mtime);
+    count = (gint32) movie->seekIndexCount;
+
+    rc &= (fwrite(magic, sizeof(magic), 1, fd) == 1);
+    rc &= (fwrite(&size, sizeof(size), 1, fd) == 1);
+    rc &= (fwrite(&mtime, sizeof(mtime), 1, fd) == 1);
+    rc &= (fwrite(&count, sizeof(count), 1, fd) == 1);
+    for (i = 0; i < count; i++) {
+        keyframe = (gint32) movie->seekIndex[i].keyframe;
+        rc &= (fwrite(&movie->seekIndex[i].pts, sizeof(gint64), 1, fd) == 1);
+        rc &= (fwrite(&keyframe, sizeof(keyframe), 1, fd) == 1);
+    }
+
+    fclose(fd);
+
+    if (!rc) {
+        if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: Failed to write movie seek index file [%s].\n", filename);
+        remove(filename);
+    }
+}
+
+/* Drop the pending frame and all cached frames of indexed seeking. */
+static void PsychGSFlushSeekCache(PsychMovieRecordType* movie)
+{
+    int i;
+
+    for (i = 0; i < PSYCH_MAX_MOVIE_SEEKCACHE; i++) {
+        if (movie->seekCache[i]) gst_sample_unref(movie->seekCache[i]);
+        movie->seekCache[i] = NULL;
+    }
+
+    PsychLockMutex(&movie->mutex);
+    if (movie->pendingSample) gst_sample_unref(movie->pendingSample);
+    movie->pendingSample = NULL;
+    PsychUnlockMutex(&movie->mutex);
+
+    movie->seekIndexPosition = -1;
+}
+
+/* Release seek index and cached frames of a movie. */
+static void PsychGSReleaseSeekIndex(PsychMovieRecordType* movie)
+{
+    PsychGSFlushSeekCache(movie);
+    free(movie->seekIndex);
+    movie->seekIndex = NULL;
+    movie->seekIndexCount = 0;
+}
+
+/* Rebuild the seek index after a new movie got queued for gapless playback, once the pipeline
+ * actually plays the new movie. Until then, seeks operate on the old movie without index.
+ */
+static void PsychGSUpdateSeekIndex(PsychMovieRecordType* movie)
+{
+    gchar* currentUri = NULL;
+
+    if (!movie->seekIndexStale)
+        return;
+
+    g_object_get(G_OBJECT(movie->theMovie), "current-uri", &currentUri, NULL);
+    if (currentUri && !strcmp(currentUri, movie->movieLocation)) {
+        // Only try once, so a movie without usable index doesn't cause a rebuild on each seek:
+        movie->seekIndexStale = FALSE;
+        if (PsychGSBuildSeekIndex(movie)) {
+            movie->nrframes = movie->seekIndexCount;
+            if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Rebuilt seek index of queued movie [%s] with %i frames.\n", movie->movieName, movie->seekIndexCount);
+        }
+    }
+
+    g_free(currentUri);
+}
+
+/* Return index of the last frame with a presentation timestamp at or before pts. */
+static int PsychGSSeekIndexFrameForPts(PsychMovieRecordType* movie, gint64 pts)
+{
+    int lo = 0, hi = movie->seekIndexCount - 1, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo + 1) / 2;
+        if (movie->seekIndex[mid].pts <= pts)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    return(lo);
+}
+
+/* Return cached decoded frame with given index, or NULL. Marks the frame as recently used. */
+static GstSample* PsychGSSeekCacheLookup(PsychMovieRecordType* movie, int frame)
+{
+    int i;
+
+    for (i = 0; i < movie->seekCacheCapacity; i++) {
+        if (movie->seekCache[i] && (movie->seekCacheFrame[i] == frame)) {
+            movie->seekCacheUse[i] = ++movie->seekCacheClock;
+            return(movie->seekCache[i]);
+        }
+    }
+
+    return(NULL);
+}
+
+/* Store a copy of a decoded frame in the LRU cache, replacing the least recently used frame if the cache is full.
+ * The frame data is copied, so the cache doesn't hold on to the decoders buffers. Returns the cached copy.
+ */
+static GstSample* PsychGSSeekCacheInsert(PsychMovieRecordType* movie, int frame, GstSample* sample)
+{
+    GstSample*  cached;
+    GstBuffer*  buffer;
+    int         i, slot = 0;
+
+    if ((cached = PsychGSSeekCacheLookup(movie, frame))) return(cached);
+
+    for (i = 0; i < movie->seekCacheCapacity; i++) {
+        if (!movie->seekCache[i]) {
+            slot = i;
+            break;
+        }
+
+        if (movie->seekCacheUse[i] < movie->seekCacheUse[slot]) slot = i;
+    }
+
+    if (movie->seekCache[slot]) gst_sample_unref(movie->seekCache[slot]);
+
+    buffer = gst_buffer_copy_deep(gst_sample_get_buffer(sample));
+    movie->seekCache[slot] = gst_sample_new(buffer, gst_sample_get_caps(sample), gst_sample_get_segment(sample), NULL);
+    gst_buffer_unref(buffer);
+    movie->seekCacheFrame[slot] = frame;
+    movie->seekCacheUse[slot] = ++movie->seekCacheClock;
+
+    return(movie->seekCache[slot]);
+}
+
+/* Frame-accurate seek to targetFrame in manual fetch mode, via the movies seek index: Seek to the nearest
+ * preceding keyframe, or continue from the current position if that is within the same group of pictures
+ * before the target, then step forward frame by frame to the target. All decoded frames go into the LRU
+ * cache, so seeking to recently visited frames, e.g., stepping back by one frame, needs no decoding at all.
+ * The target frame gets delivered by the next Screen('GetMovieImage'). Returns FALSE on failure.
+ */
+static psych_bool PsychGSIndexedSeek(PsychMovieRecordType* movie, int targetFrame)
+{
+    GstSample*  sample;
+    GstSample*  cached;
+    int         keyframe, frame;
+
+    // Recently decoded frame? Then no seek or decode needed:
+    cached = PsychGSSeekCacheLookup(movie, targetFrame);
+    if (!cached) {
+        keyframe = movie->seekIndex[targetFrame].keyframe;
+        frame = movie->seekIndexPosition;
+
+        // Need to seek to keyframe, unless already positioned between keyframe and target:
+        if ((frame < keyframe) || (frame >= targetFrame)) {
+            if (!gst_element_seek_simple(movie->theMovie, GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE, movie->seekIndex[keyframe].pts))
+                return(FALSE);
+
+            gst_element_get_state(movie->theMovie, NULL, NULL, (GstClockTime) (30 * 1e9));
+
+            sample = gst_app_sink_try_pull_preroll(GST_APP_SINK(movie->videosink), 5 * GST_SECOND);
+            if (!sample) return(FALSE);
+
+            frame = PsychGSSeekIndexFrameForPts(movie, (gint64) GST_BUFFER_PTS(gst_sample_get_buffer(sample)));
+            cached = PsychGSSeekCacheInsert(movie, frame, sample);
+            gst_sample_unref(sample);
+            movie->seekIndexPosition = frame;
+        }
+
+        // Decode forward until target frame:
+        while (frame < targetFrame) {
+            if (!gst_element_send_event(movie->theMovie, gst_event_new_step(GST_FORMAT_BUFFERS, 1, 1.0, TRUE, FALSE)))
+                break;
+
+            sample = gst_app_sink_try_pull_preroll(GST_APP_SINK(movie->videosink), 5 * GST_SECOND);
+            if (!sample) break;
+
+            frame = PsychGSSeekIndexFrameForPts(movie, (gint64) GST_BUFFER_PTS(gst_sample_get_buffer(sample)));
+            cached = PsychGSSeekCacheInsert(movie, frame, sample);
+            gst_sample_unref(sample);
+            movie->seekIndexPosition = frame;
+        }
+
+        if (!cached) return(FALSE);
+
+        if ((frame != targetFrame) && (PsychPrefStateGet_Verbosity() > 1))
+            printf("PTB-WARNING: Indexed seek in movie [%s] reached frame %i instead of target frame %i.\n", movie->movieName, frame, targetFrame);
+    }
+
+    // Hand target frame to next fetch:
+    PsychLockMutex(&movie->mutex);
+    if (movie->pendingSample) gst_sample_unref(movie->pendingSample);
+    movie->pendingSample = gst_sample_ref(cached);
+    movie->preRollAvail = 1;
+    PsychUnlockMutex(&movie->mutex);
+
+    return(TRUE);
+}
+
+/* Put a texture into the texture pool of a movie for recycling, or delete it if the pool is full.
+ * 'fence' is a fence behind the last use of the texture in the current OpenGL context, to wait for
+ * before the texture gets reused in another context, or NULL. Must be called with movie->mutex held
+ * and an OpenGL context bound which shares the texture.
+ */
+static void PsychGSRecycleMovieTexture(PsychMovieRecordType* movie, GLuint texture, GLsync fence)
+{
+    if (movie->texturePoolCount < movie->texturePoolCapacity) {
+        movie->texturePool[movie->texturePoolCount] = texture;
+        movie->texturePoolFence[movie->texturePoolCount] = fence;
+        movie->texturePoolCount++;
+    }
+    else {
+        glDeleteTextures(1, &texture);
+        if (fence) glDeleteSync(fence);
+    }
+}
+
+/* Take a texture from the texture pool of a movie, or return zero if the pool is empty. Waits on the
+ * GPU for completion of the last use of the texture in another OpenGL context. Must be called with
+ * movie->mutex held and an OpenGL context bound which shares the texture.
+ */
+static GLuint PsychGSTakePooledMovieTexture(PsychMovieRecordType* movie)
+{
+    GLsync fence;
+
+    if (movie->texturePoolCount == 0) return(0);
+
+    movie->texturePoolCount--;
+    fence = movie->texturePoolFence[movie->texturePoolCount];
+    if (fence) {
+        glWaitSync(fence, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(fence);
+    }
+
+    movie->recycledTextures++;
+
+    return(movie->texturePool[movie->texturePoolCount]);
+}
+
+/* Remove the oldest frame uploaded ahead of fetch into 'frame'. Must be called with movie->mutex held
+ * and at least one uploaded frame available.
+ */
+static void PsychGSPopUploadedFrame(PsychMovieRecordType* movie, PsychMovieUploadedFrame* frame)
+{
+    *frame = movie->uploadedFrames[movie->uploadedHead];
+    movie->uploadedHead = (movie->uploadedHead + 1) % PSYCH_MAX_MOVIE_TEXTUREPOOL;
+    movie->uploadedCount--;
+
+    // A slot for the next frame is free now, wake the upload thread:
+    PsychBroadcastCondition(&movie->condition);
+}
+
+/* Number of frames ready for fetch at playback 'rate'. Must be called with movie->mutex held. */
+static int PsychGSFramesReady(PsychMovieRecordType* movie, double rate)
+{
+    if (rate == 0) return(movie->preRollAvail);
+
+    return((movie->uploadState == 2) ? movie->uploadedCount : movie->frameAvail);
+}
+
+/* Upload a decoded 8 bpc luminance or BGRA frame into 'texture' on the upload thread, creating the
+ * texture if 'texture' is zero. Returns a fence behind the upload, or NULL on failure.
+ */
+static GLsync PsychGSUploadMovieFrame(PsychMovieRecordType* movie, GstSample* sample, GLuint* texture)
+{
+    GstBuffer       *videoBuffer = gst_sample_get_buffer(sample);
+    GstVideoMeta    *videoMetaData = (GstVideoMeta *) gst_buffer_get_meta(videoBuffer, GST_VIDEO_META_API_TYPE);
+    int             bpp = (movie->pixelFormat == 4) ? 4 : 1;
+    GLenum          format = (bpp == 4) ? GL_BGRA : GL_LUMINANCE;
+    GLenum          type = ((bpp == 4) && !(movie->parentRecord->gfxcaps & kPsychGfxCapNeedsUnsignedByteRGBATextureUpload)) ? GL_UNSIGNED_INT_8_8_8_8_REV : GL_UNSIGNED_BYTE;
+    size_t          strideBytes;
+    GLsync          fence;
+#if PSYCH_SYSTEM == PSYCH_WINDOWS
+    #pragma warning( disable : 4068 )
+#endif
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+    GstMapInfo      mapinfo = GST_MAP_INFO_INIT;
+    #pragma GCC diagnostic pop
+
+    // Rows of decoded frames are aligned to 4 Bytes, unless the frames video meta data tells otherwise:
+    strideBytes = (videoMetaData && videoMetaData->stride[0] && (videoMetaData->stride[0] % bpp == 0)) ? (size_t) videoMetaData->stride[0] : (size_t) ((movie->width * bpp + 3) & ~3);
+
+    if (!gst_buffer_map(videoBuffer, &mapinfo, GST_MAP_READ)) return(NULL);
+
+    // Frame smaller than expected, e.g., of a queued movie of different size? Then leave it to the upload on fetch:
+    if (mapinfo.size < strideBytes * (movie->height - 1) + (size_t) (movie->width * bpp)) {
+        gst_buffer_unmap(videoBuffer, &mapinfo);
+        return(NULL);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint) (strideBytes / bpp));
+
+    if (*texture == 0) {
+        glGenTextures(1, texture);
+        glBindTexture(movie->uploadTarget, *texture);
+        glTexImage2D(movie->uploadTarget, 0, (bpp == 4) ? GL_RGBA8 : GL_LUMINANCE8, movie->width, movie->height, 0, format, type, mapinfo.data);
+    }
+    else {
+        glBindTexture(movie->uploadTarget, *texture);
+        glTexSubImage2D(movie->uploadTarget, 0, 0, 0, movie->width, movie->height, format, type, mapinfo.data);
+    }
+
+    glBindTexture(movie->uploadTarget, 0);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    // The fence must be flushed, so the main context can't wait forever for it:
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+
+    gst_buffer_unmap(videoBuffer, &mapinfo);
+
+    return(fence);
+}
+
+/* Main routine of the upload thread of a movie: Pulls decoded frames from the videosink during playback
+ * and uploads them into textures, via an OpenGL context which shares textures with the main context, so
+ * Screen('GetMovieImage') only needs to hand over an already uploaded texture.
+ */
+static void* PsychGSMovieUploadThreadMain(void* moviePtr)
+{
+    PsychMovieRecordType* movie = (PsychMovieRecordType*) moviePtr;
+    PsychMovieUploadedFrame frame;
+    psych_bool attached;
+    int maxBuffers;
+
+    PsychSetThreadName("PsychMovieUpload");
+
+    // Attach to our own OpenGL context for the lifetime of the thread and report success or failure:
+    attached = PsychOSSetSharedGLContext(movie->parentRecord, movie->uploadContext);
+
+    PsychLockMutex(&movie->mutex);
+    movie->uploadState = (attached) ? 2 : 3;
+    PsychBroadcastCondition(&movie->condition);
+
+    while (attached && !movie->uploadStop) {
+        // Wait for a decoded frame and a free slot in the ring of uploaded frames while playback is active:
+        if (!movie->uploadEnabled || (movie->frameAvail <= 0) || (movie->uploadedCount >= movie->texturePoolCapacity)) {
+            PsychTimedWaitCondition(&movie->condition, &movie->mutex, 0.1);
+            continue;
+        }
+
+        // Clamp frameAvail to the videosinks queue capacity, as the sink drops the oldest frames if it is full:
+        maxBuffers = (int) gst_app_sink_get_max_buffers(GST_APP_SINK(movie->videosink));
+        if ((maxBuffers > 0) && (movie->frameAvail > maxBuffers)) movie->frameAvail = maxBuffers;
+
+        movie->frameAvail--;
+        movie->uploadPending = 1;
+        frame.tArrival = PsychPopMovieFrameArrival(movie);
+        frame.texture = PsychGSTakePooledMovieTexture(movie);
+        PsychUnlockMutex(&movie->mutex);
+
+        // Pull and upload the frame. Don't block for long if a seek flushed the videosink meanwhile:
+        frame.fence = NULL;
+        frame.sample = gst_app_sink_try_pull_sample(GST_APP_SINK(movie->videosink), GST_SECOND / 10);
+        if (frame.sample) frame.fence = PsychGSUploadMovieFrame(movie, frame.sample, &frame.texture);
+
+        PsychLockMutex(&movie->mutex);
+        movie->uploadPending = 0;
+        if (frame.fence) {
+            movie->uploadedFrames[(movie->uploadedHead + movie->uploadedCount) % PSYCH_MAX_MOVIE_TEXTUREPOOL] = frame;
+            movie->uploadedCount++;
+        }
+        else {
+            // Failed: Drop the frame, keep the texture:
+            if (frame.sample) gst_sample_unref(frame.sample);
+            if (frame.texture) PsychGSRecycleMovieTexture(movie, frame.texture, NULL);
+        }
+        PsychBroadcastCondition(&movie->condition);
+    }
+
+    PsychUnlockMutex(&movie->mutex);
+
+    if (attached) PsychOSSetSharedGLContext(movie->parentRecord, NULL);
+
+    return(NULL);
+}
+
+/* Start or stop pulling and uploading of frames by the upload thread of a movie, if any. Stopping
+ * waits for a frame in flight and discards all frames uploaded ahead of fetch, e.g., before a seek
+ * or at stop of playback.
+ */
+static void PsychGSEnableMovieUploads(PsychMovieRecordType* movie, psych_bool enable)
+{
+    PsychMovieUploadedFrame frame;
+
+    if (movie->uploadState != 2) return;
+
+    if (!enable) PsychSetGLContext(movie->parentRecord);
+
+    PsychLockMutex(&movie->mutex);
+    movie->uploadEnabled = (enable) ? 1 : 0;
+
+    if (!enable) {
+        while (movie->uploadPending) PsychWaitCondition(&movie->condition, &movie->mutex);
+
+        while (movie->uploadedCount > 0) {
+            PsychGSPopUploadedFrame(movie, &frame);
+            PsychGSRecycleMovieTexture(movie, frame.texture, frame.fence);
+            gst_sample_unref(frame.sample);
+        }
+    }
+
+    PsychBroadcastCondition(&movie->condition);
+    PsychUnlockMutex(&movie->mutex);
+}
+
+/* Start the upload thread of a movie in decode-ahead playback, to upload decoded frames into textures
+ * of 'target' ahead of their fetch. Called at the first texture fetch during playback, with the main
+ * context bound. If this movie or system can't do this, frames keep getting uploaded on fetch.
+ */
+static void PsychGSStartMovieUploadThread(PsychMovieRecordType* movie, PsychWindowRecordType* win, GLenum target)
+{
+    int i, rc;
+
+    movie->uploadState = 3;
+
+    // Only for plain 8 bpc luminance or BGRA frames on desktop OpenGL with fences. Other formats need
+    // conversion on fetch, e.g., debayering or 16 bpc swizzling, or special texture formats:
+    if ((movie->prefetchFrames < 1) || ((movie->pixelFormat != 1) && (movie->pixelFormat != 4)) || (movie->bitdepth != 8) ||
+        (movie->specialFlags1 & (512 | 1024)) || movie->dmaBufImport || !movie->width || !movie->height ||
+        PsychIsGLES(win) || !glewIsSupported("GL_ARB_sync") || ((target == GL_TEXTURE_2D) && !(win->gfxcaps & kPsychGfxCapNPOTTex)))
+        return;
+
+    movie->uploadContext = PsychOSCreateSharedGLContext(win);
+    if (movie->uploadContext == NULL) {
+        if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: No shared OpenGL context for texture upload thread of movie [%s]. Uploading frames on fetch.\n", movie->movieName);
+        return;
+    }
+
+    movie->uploadTarget = target;
+    movie->uploadStop = 0;
+    movie->uploadEnabled = 1;
+    movie->uploadPending = 0;
+    movie->uploadedHead = 0;
+    movie->uploadedCount = 0;
+
+    // Textures in the pool may still be in use by pending drawing in our context, so fence them before the thread recycles them:
+    PsychLockMutex(&movie->mutex);
+    for (i = 0; i < movie->texturePoolCount; i++) {
+        if (!movie->texturePoolFence[i]) movie->texturePoolFence[i] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    movie->uploadState = 1;
+    PsychUnlockMutex(&movie->mutex);
+    glFlush();
+
+    if ((rc = PsychCreateThread(&movie->uploadThread, NULL, PsychGSMovieUploadThreadMain, (void*) movie))) {
+        if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: Could not create texture upload thread for movie [%s] (%s). Uploading frames on fetch.\n", movie->movieName, strerror(rc));
+        movie->uploadState = 3;
+    }
+    else {
+        // Wait for the thread to attach to its OpenGL context:
+        PsychLockMutex(&movie->mutex);
+        while (movie->uploadState == 1) PsychWaitCondition(&movie->condition, &movie->mutex);
+        PsychUnlockMutex(&movie->mutex);
+
+        if (movie->uploadState == 2) {
+            if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Movie [%s] uploads up to %i decoded frames into textures ahead of fetch.\n", movie->movieName, movie->texturePoolCapacity);
+            return;
+        }
+
+        // Thread failed to attach and exited:
+        PsychDeleteThread(&movie->uploadThread);
+        if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Texture upload thread of movie [%s] could not attach to its OpenGL context. Uploading frames on fetch.\n", movie->movieName);
+    }
+
+    PsychOSDestroySharedGLContext(win, movie->uploadContext);
+    movie->uploadContext = NULL;
+}
+
+/* Stop and join the upload thread of a movie, if any, and release its frames and OpenGL context. */
+static void PsychGSStopMovieUploadThread(PsychMovieRecordType* movie)
+{
+    if (movie->uploadState != 2) return;
+
+    PsychGSEnableMovieUploads(movie, FALSE);
+
+    PsychLockMutex(&movie->mutex);
+    movie->uploadStop = 1;
+    PsychBroadcastCondition(&movie->condition);
+    PsychUnlockMutex(&movie->mutex);
+    PsychDeleteThread(&movie->uploadThread);
+
+    PsychOSDestroySharedGLContext(movie->parentRecord, movie->uploadContext);
+    movie->uploadContext = NULL;
+    movie->uploadState = 0;
+}
+
 /*
  *      PsychGSCreateMovie() -- Create a movie object.
  *
@@ -1635,7 +2432,7 @@ void PsychGSCreateMovie(PsychWindowRecordType *win, const char* moviename, doubl
     GstStructure    *str;
     gint            width,height;
     gint            rate1, rate2;
-    int             i, slotid;
+    int             i, slotid, keyframeCount;
     int             max_video_threads;
     char            movieLocation[FILENAME_MAX];
     psych_bool      printErrors;
@@ -1681,6 +2478,12 @@ void PsychGSCreateMovie(PsychWindowRecordType *win, const char* moviename, doubl
         strncpy(movieRecordBANK[*moviehandle].movieLocation, movieLocation, FILENAME_MAX);
         strncpy(movieRecordBANK[*moviehandle].movieName, moviename, FILENAME_MAX);
 
+        // Seek index of the old movie does not apply to the new one. If an index was
+        // requested, rebuild it at the first seek after the switch to the new movie. A
+        // sidecar file of 'SeekIndex=filename' belongs to the old movie and is not used:
+        PsychGSReleaseSeekIndex(&movieRecordBANK[*moviehandle]);
+        movieRecordBANK[*moviehandle].seekIndexStale = movieRecordBANK[*moviehandle].seekIndexRequested;
+
         // Assign name of movie to play to pipeline. If the pipeline is not in playing
         // state, this will switch to the specified movieLocation immediately. If it
         // is playing, it will switch to it at the end of the current playback iteration:
@@ -1745,6 +2548,54 @@ void PsychGSCreateMovie(PsychWindowRecordType *win, const char* moviename, doubl
     // Zero-out new record in moviebank:
     memset(&movieRecordBANK[slotid], 0, sizeof(PsychMovieRecordType));
 
+    // Optional 'movieOptions' parameter 'PrefetchFrames=n' specified to decode up to n frames ahead of
+    // consumption, and to keep up to n textures for recycling?
+    movieRecordBANK[slotid].texturePoolCapacity = 1;
+    if ((pstring = strstr(movieOptions, "PrefetchFrames="))) {
+        if ((1 != sscanf(pstring, "PrefetchFrames=%i", &movieRecordBANK[slotid].prefetchFrames)) || (movieRecordBANK[slotid].prefetchFrames < 1)) {
+            if (PsychPrefStateGet_Verbosity() > 0)
+                printf("PTB-ERROR: Invalid PrefetchFrames parameter specified in 'movieOptions' [= '%s']: Must be a number of at least 1!\n", pstring);
+
+            if (printErrors)
+                PsychErrorExitMsg(PsychError_user, "Invalid PrefetchFrames parameter specified in 'movieOptions' parameter.");
+            else
+                return;
+        }
+
+        movieRecordBANK[slotid].texturePoolCapacity = (movieRecordBANK[slotid].prefetchFrames < PSYCH_MAX_MOVIE_TEXTUREPOOL) ? movieRecordBANK[slotid].prefetchFrames : PSYCH_MAX_MOVIE_TEXTUREPOOL;
+    }
+
+    // Optional 'movieOptions' parameter 'SeekCacheFrames=n' specified to cache up to n decoded frames for indexed seeking?
+    movieRecordBANK[slotid].seekCacheCapacity = PSYCH_DEFAULT_MOVIE_SEEKCACHE;
+    movieRecordBANK[slotid].seekIndexPosition = -1;
+    if ((pstring = strstr(movieOptions, "SeekCacheFrames="))) {
+        if ((1 != sscanf(pstring, "SeekCacheFrames=%i", &movieRecordBANK[slotid].seekCacheCapacity)) ||
+            (movieRecordBANK[slotid].seekCacheCapacity < 1) || (movieRecordBANK[slotid].seekCacheCapacity > PSYCH_MAX_MOVIE_SEEKCACHE)) {
+            if (PsychPrefStateGet_Verbosity() > 0)
+                printf("PTB-ERROR: Invalid SeekCacheFrames parameter specified in 'movieOptions' [= '%s']: Must be a number between 1 and %i!\n", pstring, PSYCH_MAX_MOVIE_SEEKCACHE);
+
+            if (printErrors)
+                PsychErrorExitMsg(PsychError_user, "Invalid SeekCacheFrames parameter specified in 'movieOptions' parameter.");
+            else
+                return;
+        }
+    }
+
+    // Optional 'movieOptions' parameter 'DmaBufImport=1' specified to import video frames in DMA-BUF memory
+    // as textures without copy, where supported?
+    if ((pstring = strstr(movieOptions, "DmaBufImport="))) {
+        if ((1 != sscanf(pstring, "DmaBufImport=%i", &movieRecordBANK[slotid].dmaBufImport)) ||
+            (movieRecordBANK[slotid].dmaBufImport < 0) || (movieRecordBANK[slotid].dmaBufImport > 1)) {
+            if (PsychPrefStateGet_Verbosity() > 0)
+                printf("PTB-ERROR: Invalid DmaBufImport parameter specified in 'movieOptions' [= '%s']: Must be 0 or 1!\n", pstring);
+
+            if (printErrors)
+                PsychErrorExitMsg(PsychError_user, "Invalid DmaBufImport parameter specified in 'movieOptions' parameter.");
+            else
+                return;
+        }
+    }
+
     // Store specialFlags1 from open call:
     movieRecordBANK[slotid].specialFlags1 = specialFlags1;
 
@@ -2086,6 +2937,19 @@ void PsychGSCreateMovie(PsychWindowRecordType *win, const char* moviename, doubl
             if ((PsychPrefStateGet_Verbosity() > 1) && (pixelFormat == 11)) printf("PTB-WARNING: Movie playback for movie %i will use RGBA8 textures for HDR playback due to lack of YUV-I420 HDR support on GPU. Results may be wrong!\n", slotid);
 
             if ((PsychPrefStateGet_Verbosity() > 3) && !(pixelFormat < 5)) printf("PTB-INFO: Movie playback for movie %i will use RGBA8 textures.\n", slotid);
+
+            // Zero-copy import of frames requested? Then prefer DMA-BUF memory if the decoder and the
+            // window support it, falling back to regular system memory frames otherwise:
+            if (movieRecordBANK[slotid].dmaBufImport) {
+                if (win && PsychDmaBufImportAvailable(win)) {
+                    colorcaps = PsychDmaBufAddImportCaps(colorcaps);
+                }
+                else {
+                    movieRecordBANK[slotid].dmaBufImport = 0;
+                    if (PsychPrefStateGet_Verbosity() > 3)
+                        printf("PTB-INFO: Zero-copy DMA-BUF frame import unsupported for movie %i. Using regular texture upload.\n", slotid);
+                }
+            }
         }
 
         if ((movieRecordBANK[slotid].pixelFormat == 1) && !(specialFlags1 & 512)) {
@@ -2132,6 +2996,10 @@ void PsychGSCreateMovie(PsychWindowRecordType *win, const char* moviename, doubl
         }
     }
 
+    // Zero-copy import is only supported for RGBA8 frames:
+    if ((movieRecordBANK[slotid].pixelFormat != 4) || (movieRecordBANK[slotid].bitdepth > 8) || (specialFlags1 & 1024))
+        movieRecordBANK[slotid].dmaBufImport = 0;
+
     // Assign 'colorcaps' as caps to our videosink. This marks the videosink so
     // that it can only receive video image data in the format defined by colorcaps,
     // i.e., a format that is easy to consume for OpenGL's texture creation on std.
@@ -2433,6 +3301,8 @@ void PsychGSCreateMovie(PsychWindowRecordType *win, const char* moviename, doubl
     movieRecordBANK[slotid].theMovie = theMovie;
     movieRecordBANK[slotid].loopflag = 0;
     movieRecordBANK[slotid].frameAvail = 0;
+    movieRecordBANK[slotid].arrivalHead = 0;
+    movieRecordBANK[slotid].arrivalCount = 0;
     movieRecordBANK[slotid].imageBuffer = NULL;
     movieRecordBANK[slotid].startPending = 0;
     movieRecordBANK[slotid].endOfFetch = 0;
@@ -2477,10 +3347,51 @@ void PsychGSCreateMovie(PsychWindowRecordType *win, const char* moviename, doubl
         gst_app_sink_set_max_buffers(GST_APP_SINK(videosink), 1);
     }
 
+    // Explicit decode-ahead depth requested? This overrides the queue capacity from above, so the
+    // decoder can run up to prefetchFrames frames ahead of consumption:
+    if (movieRecordBANK[slotid].prefetchFrames > 0) {
+        gst_app_sink_set_max_buffers(GST_APP_SINK(videosink), movieRecordBANK[slotid].prefetchFrames);
+        if (PsychPrefStateGet_Verbosity() > 3)
+            printf("PTB-INFO: Movie %i decodes up to %i frames ahead, with a texture pool of %i textures.\n", slotid,
+                   movieRecordBANK[slotid].prefetchFrames, movieRecordBANK[slotid].texturePoolCapacity);
+    }
+
+    movieRecordBANK[slotid].queueCapacity = (int) gst_app_sink_get_max_buffers(GST_APP_SINK(videosink));
+
     // Compute framecount from fps and duration:
     movieRecordBANK[slotid].nrframes = (int)(movieRecordBANK[slotid].fps * movieRecordBANK[slotid].movieduration + 0.5);
     //printf("PTB-DEBUG: Number of frames in movie %i [%s] is %i.\n", slotid, moviename, movieRecordBANK[slotid].nrframes);
 
+    // Optional 'movieOptions' parameter 'SeekIndex=1' or 'SeekIndex=filename' specified to build a seek index for
+    // frame-accurate seeking, optionally cached in sidecar file filename?
+    if ((pstring = strstr(movieOptions, "SeekIndex="))) {
+        pstring += strlen("SeekIndex=");
+        pstring = strdup(pstring);
+        movieRecordBANK[slotid].seekIndexRequested = TRUE;
+        if (strstr(pstring, ":::") != NULL) *(strstr(pstring, ":::")) = 0;
+
+        if (!strcmp(pstring, "1")) {
+            PsychGSBuildSeekIndex(&movieRecordBANK[slotid]);
+        }
+        else if (!PsychGSLoadSeekIndex(&movieRecordBANK[slotid], pstring) && PsychGSBuildSeekIndex(&movieRecordBANK[slotid])) {
+            PsychGSSaveSeekIndex(&movieRecordBANK[slotid], pstring);
+        }
+
+        free(pstring); pstring = NULL;
+
+        if (movieRecordBANK[slotid].seekIndex) {
+            // The index provides the exact frame count:
+            movieRecordBANK[slotid].nrframes = movieRecordBANK[slotid].seekIndexCount;
+
+            if (PsychPrefStateGet_Verbosity() > 3) {
+                for (i = 0, keyframeCount = 0; i < movieRecordBANK[slotid].seekIndexCount; i++)
+                    if (movieRecordBANK[slotid].seekIndex[i].keyframe == i) keyframeCount++;
+
+                printf("PTB-INFO: Seek index of movie %i has %i frames, %i of them keyframes.\n", slotid, movieRecordBANK[slotid].seekIndexCount, keyframeCount);
+            }
+        }
+    }
+
     // Is this movie supposed to be encoded in Psychtoolbox special proprietary "16 bpc stuffed into 8 bpc" format?
     if (specialFlags1 & 512) {
         // Yes. Invert the hacks applied during encoding/writing of movie:
@@ -2592,7 +3503,8 @@ void PsychGSDeleteMovie(int moviehandle)
         PsychErrorExitMsg(PsychError_user, "Invalid moviehandle provided. No movie associated with this handle !!!");
     }
 
-    // Stop movie playback immediately:
+    // Stop texture upload thread, if any, then movie playback immediately:
+    PsychGSStopMovieUploadThread(&movieRecordBANK[moviehandle]);
     PsychMoviePipelineSetState(movieRecordBANK[moviehandle].theMovie, GST_STATE_NULL, 20.0);
 
     // Delete movieobject for this handle:
@@ -2602,6 +3514,9 @@ void PsychGSDeleteMovie(int moviehandle)
     // Delete visual context for this movie:
     movieRecordBANK[moviehandle].MovieContext = NULL;
 
+    // Release seek index and cached frames:
+    PsychGSReleaseSeekIndex(&movieRecordBANK[moviehandle]);
+
     PsychDestroyMutex(&movieRecordBANK[moviehandle].mutex);
     PsychDestroyCondition(&movieRecordBANK[moviehandle].condition);
 
@@ -2609,12 +3524,16 @@ void PsychGSDeleteMovie(int moviehandle)
     movieRecordBANK[moviehandle].imageBuffer = NULL;
     movieRecordBANK[moviehandle].videosink = NULL;
 
-    // Recycled texture in texture cache?
-    if ((movieRecordBANK[moviehandle].parentRecord) && (movieRecordBANK[moviehandle].cached_texture > 0)) {
-        // Yes. Release it.
+    // Recycled textures in texture pool?
+    if ((movieRecordBANK[moviehandle].parentRecord) && (movieRecordBANK[moviehandle].texturePoolCount > 0)) {
+        // Yes. Release them.
         PsychSetGLContext(movieRecordBANK[moviehandle].parentRecord);
-        glDeleteTextures(1, &(movieRecordBANK[moviehandle].cached_texture));
-        movieRecordBANK[moviehandle].cached_texture = 0;
+        glDeleteTextures(movieRecordBANK[moviehandle].texturePoolCount, movieRecordBANK[moviehandle].texturePool);
+        for (i = 0; i < movieRecordBANK[moviehandle].texturePoolCount; i++) {
+            if (movieRecordBANK[moviehandle].texturePoolFence[i]) glDeleteSync(movieRecordBANK[moviehandle].texturePoolFence[i]);
+            movieRecordBANK[moviehandle].texturePoolFence[i] = NULL;
+        }
+        movieRecordBANK[moviehandle].texturePoolCount = 0;
     }
 
     if (movieRecordBANK[moviehandle].texturePlanarHDRDecodeShader)
@@ -2688,8 +3607,14 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
     static double   tStart = 0;
     double          tNow;
     double          preT, postT;
+    double          tArrival = 0;
     unsigned char*  releaseMemPtr = NULL;
     unsigned int    strideBytes = 0;
+    psych_bool      dmaBufImported = FALSE;
+    psych_bool      preUploaded = FALSE;
+    psych_bool      useUploaded = FALSE;
+    PsychMovieUploadedFrame uploadedFrame = { NULL, 0, NULL, 0 };
+    double          tDeadline;
 #if PSYCH_SYSTEM == PSYCH_WINDOWS
     #pragma warning( disable : 4068 )
 #endif
@@ -2772,8 +3697,9 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
         if (tStart == 0) PsychGetAdjustedPrecisionTimerSeconds(&tStart);
         PsychLockMutex(&movieRecordBANK[moviehandle].mutex);
 
-        if ((((0 != rate) && movieRecordBANK[moviehandle].frameAvail) || ((0 == rate) && movieRecordBANK[moviehandle].preRollAvail)) &&
-            !gst_app_sink_is_eos(GST_APP_SINK(movieRecordBANK[moviehandle].videosink))) {
+        // Frames uploaded ahead of fetch by the upload thread stay available after eos:
+        if (PsychGSFramesReady(&movieRecordBANK[moviehandle], rate) &&
+            (((0 != rate) && (movieRecordBANK[moviehandle].uploadState == 2)) || !gst_app_sink_is_eos(GST_APP_SINK(movieRecordBANK[moviehandle].videosink)))) {
             // New frame available. Unlock and report success:
             //printf("PTB-DEBUG: NEW FRAME %d\n", movieRecordBANK[moviehandle].frameAvail);
             PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
@@ -2781,7 +3707,8 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
         }
 
         // None available. Any chance there will be one in the future?
-        if (((rate != 0) && gst_app_sink_is_eos(GST_APP_SINK(movieRecordBANK[moviehandle].videosink)) && (movieRecordBANK[moviehandle].loopflag == 0)) ||
+        if (((rate != 0) && gst_app_sink_is_eos(GST_APP_SINK(movieRecordBANK[moviehandle].videosink)) && (movieRecordBANK[moviehandle].loopflag == 0) &&
+             !movieRecordBANK[moviehandle].uploadPending) ||
             ((rate == 0) && (movieRecordBANK[moviehandle].endOfFetch))) {
             // No new frame available and there won't be any in the future, because this is a non-looping
             // movie that has reached its end.
@@ -2806,17 +3733,21 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
     PsychLockMutex(&movieRecordBANK[moviehandle].mutex);
     // printf("PTB-DEBUG: Blocking fetch start %d\n", movieRecordBANK[moviehandle].frameAvail);
 
-    if (((0 != rate) && !movieRecordBANK[moviehandle].frameAvail) ||
-        ((0 == rate) && !movieRecordBANK[moviehandle].preRollAvail)) {
-        // No new frame available. Perform a blocking wait with timeout of 0.5 seconds:
-        PsychTimedWaitCondition(&movieRecordBANK[moviehandle].condition, &movieRecordBANK[moviehandle].mutex, 0.5);
+    if (!PsychGSFramesReady(&movieRecordBANK[moviehandle], rate)) {
+        // No new frame available. Perform a blocking wait with timeout of 0.5 seconds. The condition also
+        // gets signalled for decoded frames not yet uploaded by the upload thread, so keep waiting then:
+        PsychGetAdjustedPrecisionTimerSeconds(&tNow);
+        tDeadline = tNow + 0.5;
+        do {
+            PsychTimedWaitCondition(&movieRecordBANK[moviehandle].condition, &movieRecordBANK[moviehandle].mutex, tDeadline - tNow);
+            PsychGetAdjustedPrecisionTimerSeconds(&tNow);
+        } while (!PsychGSFramesReady(&movieRecordBANK[moviehandle], rate) && (tNow < tDeadline));
 
         // Allow context task to do its internal bookkeeping and cleanup work:
         PsychGSProcessMovieContext(&(movieRecordBANK[moviehandle]), FALSE);
 
         // Recheck:
-        if (((0 != rate) && !movieRecordBANK[moviehandle].frameAvail) ||
-            ((0 == rate) && !movieRecordBANK[moviehandle].preRollAvail)) {
+        if (!PsychGSFramesReady(&movieRecordBANK[moviehandle], rate)) {
             // Wait timed out after 0.5 secs.
             PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
             if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: No frame received after timed blocking wait of 0.5 seconds.\n");
@@ -2847,7 +3778,15 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
 
     // Perform texture fetch & creation:
     // Active playback mode?
-    if (0 != rate) {
+    preUploaded = (0 != rate) && (movieRecordBANK[moviehandle].uploadState == 2);
+    if (preUploaded) {
+        // Active playback mode with upload thread: Take the oldest frame it already uploaded into a texture:
+        PsychGSPopUploadedFrame(&movieRecordBANK[moviehandle], &uploadedFrame);
+        PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
+        tArrival = uploadedFrame.tArrival;
+        videoSample = uploadedFrame.sample;
+    }
+    else if (0 != rate) {
         // Active playback mode:
         if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Pulling buffer from videosink, %d buffers decoded and queued.\n", movieRecordBANK[moviehandle].frameAvail);
 
@@ -2859,6 +3798,7 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
 
         // One less frame available after our fetch:
         movieRecordBANK[moviehandle].frameAvail--;
+        tArrival = PsychPopMovieFrameArrival(&movieRecordBANK[moviehandle]);
 
         // We can unlock early, thanks to videosink's internal buffering: XXX FIXME: Perfectly race-free to do this before the pull?
         PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
@@ -2871,9 +3811,17 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
         // Passive fetch mode: Use prerolled buffers after seek:
         // These are available even after eos...
 
-        // We can unlock early, thanks to videosink's internal buffering: XXX FIXME: Perfectly race-free to do this before the pull?
-        PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
-        videoSample = gst_app_sink_pull_preroll(GST_APP_SINK(movieRecordBANK[moviehandle].videosink));
+        // Target frame of an indexed seek pending? Then return that instead of the preroll buffer:
+        if (movieRecordBANK[moviehandle].pendingSample) {
+            videoSample = movieRecordBANK[moviehandle].pendingSample;
+            movieRecordBANK[moviehandle].pendingSample = NULL;
+            PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
+        }
+        else {
+            // We can unlock early, thanks to videosink's internal buffering: XXX FIXME: Perfectly race-free to do this before the pull?
+            PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
+            videoSample = gst_app_sink_pull_preroll(GST_APP_SINK(movieRecordBANK[moviehandle].videosink));
+        }
     }
 
     // Sample received?
@@ -2887,16 +3835,36 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
         // Iff forward playback is active and a target timeindex was specified and this buffer is not at least of
         // that timeindex and at least one more buffer is queued, then skip this buffer, pull the next one and check
         // if that one meets the required pts:
-        while ((rate > 0) && (timeindex >= 0) && (movieRecordBANK[moviehandle].pts < timeindex) && (movieRecordBANK[moviehandle].frameAvail > 0)) {
+        while ((rate > 0) && (timeindex >= 0) && (movieRecordBANK[moviehandle].pts < timeindex) &&
+               (((preUploaded) ? movieRecordBANK[moviehandle].uploadedCount : movieRecordBANK[moviehandle].frameAvail) > 0)) {
             // Tell user about reason for rejecting this buffer:
             if (PsychPrefStateGet_Verbosity() > 5) {
                 printf("PTB-DEBUG: Fast-Skipped buffer id %i with pts %f secs < targetpts %f secs.\n", (int) GST_BUFFER_OFFSET(videoBuffer), movieRecordBANK[moviehandle].pts, timeindex);
             }
 
+            if (preUploaded) {
+                // Return texture of the skipped frame to the pool, take the next frame uploaded ahead of fetch:
+                PsychSetGLContext(win);
+                PsychLockMutex(&movieRecordBANK[moviehandle].mutex);
+                PsychGSRecycleMovieTexture(&movieRecordBANK[moviehandle], uploadedFrame.texture, uploadedFrame.fence);
+                PsychGSPopUploadedFrame(&movieRecordBANK[moviehandle], &uploadedFrame);
+                PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
+                movieRecordBANK[moviehandle].skippedFrames++;
+                tArrival = uploadedFrame.tArrival;
+
+                gst_sample_unref(videoSample);
+                videoSample = uploadedFrame.sample;
+                videoBuffer = gst_sample_get_buffer(videoSample);
+                movieRecordBANK[moviehandle].pts = (double) GST_BUFFER_PTS(videoBuffer) / (double) 1e9;
+                continue;
+            }
+
             // Decrement available frame counter:
             PsychLockMutex(&movieRecordBANK[moviehandle].mutex);
             movieRecordBANK[moviehandle].frameAvail--;
+            tArrival = PsychPopMovieFrameArrival(&movieRecordBANK[moviehandle]);
             PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
+            movieRecordBANK[moviehandle].skippedFrames++;
 
             // Return the unused sample to queue:
             gst_sample_unref(videoSample);
@@ -2926,16 +3894,32 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
 
         if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: pts %f secs, dT %f secs, bufferId %i.\n", movieRecordBANK[moviehandle].pts, deltaT, (int) bufferIndex);
 
+        // Frame already uploaded by the upload thread into a texture of the target requested for this fetch?
+        useUploaded = (out_texture && uploadedFrame.texture && (PsychGetTextureTarget(out_texture) == movieRecordBANK[moviehandle].uploadTarget));
+        if (uploadedFrame.texture && !useUploaded) {
+            // No. Return the texture to the pool and upload the frame on fetch instead:
+            PsychSetGLContext(win);
+            PsychLockMutex(&movieRecordBANK[moviehandle].mutex);
+            PsychGSRecycleMovieTexture(&movieRecordBANK[moviehandle], uploadedFrame.texture, uploadedFrame.fence);
+            PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
+        }
+
         // Assign pointer to videoBuffer's data directly:
-        if (out_texture) {
+        if (out_texture && !useUploaded) {
+            // Try zero-copy import of a DMA-BUF frame as texture first, if enabled. No mapping needed then:
+            if (movieRecordBANK[moviehandle].dmaBufImport) {
+                PsychSetGLContext(win);
+                dmaBufImported = PsychDmaBufImportTexture(win, videoSample, out_texture);
+            }
+
             // Map the buffers memory for reading:
-            if (!gst_buffer_map(videoBuffer, &mapinfo, GST_MAP_READ)) {
+            if (!dmaBufImported && !gst_buffer_map(videoBuffer, &mapinfo, GST_MAP_READ)) {
                 printf("PTB-ERROR: Failed to map video data of movie frame! Something's wrong. Aborting fetch.\n");
                 gst_sample_unref(videoSample);
                 videoBuffer = NULL;
                 return(FALSE);
             }
-            out_texture->textureMemory = (GLuint*) mapinfo.data;
+            out_texture->textureMemory = (dmaBufImported) ? NULL : (GLuint*) mapinfo.data;
         }
     } else {
         printf("PTB-ERROR: No new video frame received in gst_app_sink_pull_sample! Something's wrong. Aborting fetch.\n");
@@ -2952,9 +3936,47 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
 
     // Only create actual OpenGL texture if out_texture is non-NULL. Otherwise we're
     // just skipping this. Useful for benchmarks, fast forward seeking, etc.
-    if (out_texture) {
+    if (useUploaded) {
+        // Frame already uploaded into a texture by the upload thread. Make our context wait on
+        // the GPU for completion of the upload, then hand over the texture:
+        PsychSetGLContext(win);
+        glWaitSync(uploadedFrame.fence, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(uploadedFrame.fence);
+
+        PsychMakeRect(out_texture->rect, 0, 0, movieRecordBANK[moviehandle].width, movieRecordBANK[moviehandle].height);
+        PsychCopyRect(out_texture->clientrect, out_texture->rect);
+        out_texture->textureNumber = uploadedFrame.texture;
+        out_texture->textureOrientation = 3;
+        out_texture->textureStridePixels = 0;
+        out_texture->textureMemory = NULL;
+        out_texture->textureMemorySizeBytes = 0;
+        out_texture->nrchannels = movieRecordBANK[moviehandle].pixelFormat;
+        out_texture->depth = out_texture->nrchannels * 8;
+        out_texture->bpc = 8;
+        out_texture->textureByteAligned = (out_texture->nrchannels < 4) ? 1 : ((movieRecordBANK[moviehandle].width % 2) ? 4 : 8);
+        out_texture->texturecache_slot = moviehandle;
+
+        movieRecordBANK[moviehandle].copiedFrames++;
+        movieRecordBANK[moviehandle].preUploadedFrames++;
+
+        if (movieRecordBANK[moviehandle].specialFlags1 & 16) {
+            PsychSetShader(win, 0);
+            PsychNormalizeTextureOrientation(out_texture);
+        }
+    }
+    else if (out_texture && dmaBufImported) {
+        // Frame already imported as texture without copy. Only conversion into upright RGBA8
+        // for use as render-target is left to do, if requested:
+        movieRecordBANK[moviehandle].zeroCopyFrames++;
+        if (movieRecordBANK[moviehandle].specialFlags1 & 16) {
+            PsychSetShader(win, 0);
+            PsychNormalizeTextureOrientation(out_texture);
+        }
+    }
+    else if (out_texture) {
         // Activate OpenGL context of target window:
         PsychSetGLContext(win);
+        movieRecordBANK[moviehandle].copiedFrames++;
 
         #if PSYCH_SYSTEM == PSYCH_OSX
         // Explicitely disable Apple's Client storage extensions. For now they are not really useful to us.
@@ -3043,8 +4065,10 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
             out_texture->textureByteAligned = (movieRecordBANK[moviehandle].width % 2) ? 4 : 8;
         }
 
-        // Assign texturehandle of our cached texture, if any, so it gets recycled now:
-        out_texture->textureNumber = movieRecordBANK[moviehandle].cached_texture;
+        // Assign texturehandle of a texture from our pool, if any, so it gets recycled now:
+        PsychLockMutex(&movieRecordBANK[moviehandle].mutex);
+        out_texture->textureNumber = PsychGSTakePooledMovieTexture(&movieRecordBANK[moviehandle]);
+        PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
 
         // Mark this texture as originating from us, ie., our moviehandle, so texture recycling
         // actually gets used:
@@ -3401,11 +4425,13 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
         // video memory buffer anymore, which is owned and only memory-managed by GStreamer:
         out_texture->textureMemory = NULL;
 
-        // After PsychCreateTexture() the cached texture object from our cache is used
-        // and no longer available for recycling. We mark the cache as empty:
-        // It will be filled with a new textureid for recycling if a texture gets
-        // deleted in PsychMovieDeleteTexture()....
-        movieRecordBANK[moviehandle].cached_texture = 0;
+        // After PsychCreateTexture() the texture object from our pool is used and no
+        // longer available for recycling. It will return to the pool for recycling if
+        // the texture gets deleted in PsychGSFreeMovieTexture()....
+
+        // First texture fetched in playback? Then try to upload the following frames on a thread ahead of their fetch:
+        if (rate && (movieRecordBANK[moviehandle].uploadState == 0))
+            PsychGSStartMovieUploadThread(&movieRecordBANK[moviehandle], win, PsychGetTextureTarget(out_texture));
 
         // Does usercode want immediate conversion of texture into standard RGBA8 packed pixel
         // upright format for use as a render-target? If so, do it:
@@ -3423,6 +4449,18 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
         // End of texture creation code.
     }
 
+    // Update latency statistics for frames fetched in playback mode: Time from arrival of the
+    // decoded frame in the videosink until the frame is fetched and resident in its texture.
+    // A frame is late if this took longer than the duration of one frame at the current rate:
+    if (rate && (tArrival > 0)) {
+        PsychGetAdjustedPrecisionTimerSeconds(&tNow);
+        movieRecordBANK[moviehandle].framesFetched++;
+        movieRecordBANK[moviehandle].latencySum += tNow - tArrival;
+        if (tNow - tArrival > movieRecordBANK[moviehandle].maxLatency) movieRecordBANK[moviehandle].maxLatency = tNow - tArrival;
+        if ((movieRecordBANK[moviehandle].fps > 0) && (tNow - tArrival > 1.0 / (movieRecordBANK[moviehandle].fps * fabs(rate))))
+            movieRecordBANK[moviehandle].lateFrames++;
+    }
+
     // Detection of dropped frames: This is a heuristic. We'll see how well it works out...
     // TODO: GstBuffer videoBuffer provides special flags that should allow to do a more
     // robust job, although nothing's wrong with the current approach per se...
@@ -3499,23 +4537,40 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
  */
 void PsychGSFreeMovieTexture(PsychWindowRecordType *win)
 {
+    PsychMovieRecordType *movie;
+    GLsync fence = NULL;
+
     // Is this a GStreamer movietexture? If not, just skip this routine.
     if (win->windowType!=kPsychTexture || win->textureOrientation != 3 || win->texturecache_slot < 0) return;
 
-    // Movie texture: Check if we can move it into our recycler cache
+    movie = &movieRecordBANK[win->texturecache_slot];
+
+    // The upload thread, if any, can only recycle textures of the target it uploads into:
+    if ((movie->uploadState == 2) && (PsychGetTextureTarget(win) != movie->uploadTarget)) return;
+
+    // Movie texture: Check if we can move it into our recycler pool
     // for later reuse...
-    if (movieRecordBANK[win->texturecache_slot].cached_texture == 0) {
-        // Cache free. Put this texture object into it for later reuse:
-        movieRecordBANK[win->texturecache_slot].cached_texture = win->textureNumber;
+    PsychLockMutex(&movie->mutex);
+    if (movie->texturePoolCount < movie->texturePoolCapacity) {
+        // Pool not full. Put this texture object into it for later reuse. If the upload thread
+        // may reuse it, fence it, so the thread waits for completion of drawing with it first:
+        if (movie->uploadState == 2) fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        movie->texturePool[movie->texturePoolCount] = win->textureNumber;
+        movie->texturePoolFence[movie->texturePoolCount] = fence;
+        movie->texturePoolCount++;
 
         // 0-out the textureNumber so our standard cleanup routine (glDeleteTextures) gets
         // skipped - if we wouldn't do this, our caching scheme would screw up.
         win->textureNumber = 0;
     }
     else {
-        // Cache already occupied. We don't do anything but leave the cleanup work for
+        // Pool already full. We don't do anything but leave the cleanup work for
         // this texture to the standard PsychDeleteTexture() routine...
     }
+    PsychUnlockMutex(&movie->mutex);
+
+    // The fence must be flushed, so the upload thread can't wait forever for it:
+    if (fence) glFlush();
 
     return;
 }
@@ -3569,6 +4624,9 @@ int PsychGSPlaybackRate(int moviehandle, double playbackrate, int loop, double s
         g_object_set(G_OBJECT(theMovie), "mute", (soundvolume <= 0) ? TRUE : FALSE, NULL);
         g_object_set(G_OBJECT(theMovie), "volume", soundvolume, NULL);
 
+        // Frames uploaded ahead of fetch by the upload thread, if any, are stale after the seek below:
+        PsychGSEnableMovieUploads(&movieRecordBANK[moviehandle], FALSE);
+
         // Set playback rate: An explicit seek to the position we are already (supposed to be)
         // is needed to avoid jumps in movies with bad encoding or keyframe placement:
         timeindex = PsychGSGetMovieTimeIndex(moviehandle);
@@ -3608,12 +4666,20 @@ int PsychGSPlaybackRate(int moviehandle, double playbackrate, int loop, double s
                              0, GST_SEEK_TYPE_SET, (gint64) (timeindex * (double) 1e9));
         }
 
+        // Playback moves the pipeline away from the position of the last indexed seek:
+        PsychGSFlushSeekCache(&movieRecordBANK[moviehandle]);
+
         movieRecordBANK[moviehandle].loopflag = loop;
         movieRecordBANK[moviehandle].last_pts = -1.0;
         movieRecordBANK[moviehandle].nr_droppedframes = 0;
         movieRecordBANK[moviehandle].rate = playbackrate;
         movieRecordBANK[moviehandle].frameAvail = 0;
         movieRecordBANK[moviehandle].preRollAvail = 0;
+        PsychLockMutex(&movieRecordBANK[moviehandle].mutex);
+        movieRecordBANK[moviehandle].arrivalHead = 0;
+        movieRecordBANK[moviehandle].arrivalCount = 0;
+        PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
+        PsychGSEnableMovieUploads(&movieRecordBANK[moviehandle], TRUE);
 
         // Is this a movie with actual videotracks and frame-dropping on videosink full enabled?
         if ((movieRecordBANK[moviehandle].nrVideoTracks > 0) && gst_app_sink_get_drop(GST_APP_SINK(movieRecordBANK[moviehandle].videosink))) {
@@ -3631,6 +4697,7 @@ int PsychGSPlaybackRate(int moviehandle, double playbackrate, int loop, double s
     }
     else {
         // Stop playback of movie:
+        PsychGSEnableMovieUploads(&movieRecordBANK[moviehandle], FALSE);
         movieRecordBANK[moviehandle].rate = 0;
         movieRecordBANK[moviehandle].startPending = 0;
         movieRecordBANK[moviehandle].loopflag = 0;
@@ -3749,6 +4816,7 @@ double PsychGSSetMovieTimeIndex(int moviehandle, double timeindex, psych_bool in
     double          oldtime;
     gint64          targetIndex;
     GstSeekFlags    flags;
+    int             targetFrame;
 
     if (moviehandle < 0 || moviehandle >= PSYCH_MAX_MOVIES) {
         PsychErrorExitMsg(PsychError_user, "Invalid moviehandle provided!");
@@ -3763,6 +4831,33 @@ double PsychGSSetMovieTimeIndex(int moviehandle, double timeindex, psych_bool in
     // Retrieve current timeindex:
     oldtime = PsychGSGetMovieTimeIndex(moviehandle);
 
+    // Seek index available? Then map the target to an exact frame index:
+    PsychGSUpdateSeekIndex(&movieRecordBANK[moviehandle]);
+    if (movieRecordBANK[moviehandle].seekIndex) {
+        if (indexIsFrames)
+            targetFrame = (int) (timeindex + 0.5);
+        else
+            targetFrame = PsychGSSeekIndexFrameForPts(&movieRecordBANK[moviehandle], (gint64) (timeindex * (double) 1e9) + 1000);
+
+        if (targetFrame < 0) targetFrame = 0;
+        if (targetFrame >= movieRecordBANK[moviehandle].seekIndexCount) targetFrame = movieRecordBANK[moviehandle].seekIndexCount - 1;
+
+        // In manual fetch mode, do a frame-accurate indexed seek with caching of decoded frames:
+        if ((movieRecordBANK[moviehandle].rate == 0) && PsychGSIndexedSeek(&movieRecordBANK[moviehandle], targetFrame)) {
+            if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-INFO: Indexed seek to frame %i in movie %i.\n", targetFrame, moviehandle);
+            movieRecordBANK[moviehandle].endOfFetch = 0;
+            return(oldtime);
+        }
+
+        // Otherwise do a regular accurate seek to the exact timestamp of the target frame:
+        PsychGSFlushSeekCache(&movieRecordBANK[moviehandle]);
+        timeindex = (double) movieRecordBANK[moviehandle].seekIndex[targetFrame].pts / (double) 1e9;
+        indexIsFrames = FALSE;
+    }
+
+    // Frames uploaded ahead of fetch during playback, if any, are stale after the seek:
+    PsychGSEnableMovieUploads(&movieRecordBANK[moviehandle], FALSE);
+
     // NOTE: We could use GST_SEEK_FLAG_SKIP to allow framedropping on fast forward/reverse playback...
     flags = GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE;
 
@@ -3819,6 +4914,8 @@ double PsychGSSetMovieTimeIndex(int moviehandle, double timeindex, psych_bool in
     // Reset fetch flag:
     movieRecordBANK[moviehandle].endOfFetch = 0;
 
+    if (movieRecordBANK[moviehandle].rate != 0) PsychGSEnableMovieUploads(&movieRecordBANK[moviehandle], TRUE);
+
     // Return old time value of previous position:
     return(oldtime);
 }
@@ -3886,6 +4983,78 @@ void PsychGSCopyOutMovieHDRMetaData(int moviehandle, int argPosition)
     }
 }
 
+/*
+ *  PsychGSCopyOutMovieStatistics() -- Return a struct with decode-ahead and frame fetch statistics of this movie to scripting environment.
+ */
+void PsychGSCopyOutMovieStatistics(int moviehandle, int argPosition, psych_bool reset)
+{
+    PsychGenericScriptType *s;
+    PsychMovieRecordType *movie;
+    const char *fieldNames[] = { "PrefetchFrames", "QueueCapacity", "QueueDepth", "MaxQueueDepth", "FramesFetched", "MeanDecodeLatency", "MaxDecodeLatency",
+                                 "LateFrames", "SkippedFrames", "DroppedFrames", "TexturePoolSize", "TexturePoolCapacity", "RecycledTextures",
+                                 "ZeroCopyFrames", "CopiedFrames", "PreUploadedFrames", "SeekIndexFrames" };
+    const int fieldCount = 17;
+
+    if (moviehandle < 0 || moviehandle >= PSYCH_MAX_MOVIES) {
+        PsychErrorExitMsg(PsychError_user, "Invalid moviehandle provided!");
+    }
+
+    movie = &movieRecordBANK[moviehandle];
+    if (movie->theMovie == NULL) {
+        PsychErrorExitMsg(PsychError_user, "Invalid moviehandle provided. No movie associated with this handle !!!");
+    }
+
+    // Userscript wants this info?
+    if (PsychIsArgPresent(PsychArgOut, argPosition)) {
+        PsychAllocOutStructArray(argPosition, kPsychArgOptional, -1, fieldCount, fieldNames, &s);
+
+        // Decode-ahead configuration and current / maximum number of decoded frames waiting for fetch,
+        // including frames already uploaded into textures by the upload thread:
+        PsychLockMutex(&movie->mutex);
+        PsychSetStructArrayDoubleElement("PrefetchFrames", 0, (double) movie->prefetchFrames, s);
+        PsychSetStructArrayDoubleElement("QueueCapacity", 0, (double) movie->queueCapacity, s);
+        PsychSetStructArrayDoubleElement("QueueDepth", 0, (double) (movie->frameAvail + movie->uploadedCount), s);
+        PsychSetStructArrayDoubleElement("MaxQueueDepth", 0, (double) movie->maxQueueDepth, s);
+        PsychSetStructArrayDoubleElement("RecycledTextures", 0, (double) movie->recycledTextures, s);
+        PsychUnlockMutex(&movie->mutex);
+
+        // Latency between decoded frame arriving in the queue and being fetched into a texture:
+        PsychSetStructArrayDoubleElement("FramesFetched", 0, (double) movie->framesFetched, s);
+        PsychSetStructArrayDoubleElement("MeanDecodeLatency", 0, (movie->framesFetched > 0) ? movie->latencySum / movie->framesFetched : 0, s);
+        PsychSetStructArrayDoubleElement("MaxDecodeLatency", 0, movie->maxLatency, s);
+        PsychSetStructArrayDoubleElement("LateFrames", 0, (double) movie->lateFrames, s);
+        PsychSetStructArrayDoubleElement("SkippedFrames", 0, (double) movie->skippedFrames, s);
+        PsychSetStructArrayDoubleElement("DroppedFrames", 0, (double) movie->nr_droppedframes, s);
+
+        // Texture recycling:
+        PsychSetStructArrayDoubleElement("TexturePoolSize", 0, (double) movie->texturePoolCount, s);
+        PsychSetStructArrayDoubleElement("TexturePoolCapacity", 0, (double) movie->texturePoolCapacity, s);
+
+        // Frames imported without copy vs. frames uploaded by copy, and how many of those ahead of fetch:
+        PsychSetStructArrayDoubleElement("ZeroCopyFrames", 0, (double) movie->zeroCopyFrames, s);
+        PsychSetStructArrayDoubleElement("CopiedFrames", 0, (double) movie->copiedFrames, s);
+        PsychSetStructArrayDoubleElement("PreUploadedFrames", 0, (double) movie->preUploadedFrames, s);
+
+        // Size of seek index:
+        PsychSetStructArrayDoubleElement("SeekIndexFrames", 0, (double) movie->seekIndexCount, s);
+    }
+
+    if (reset) {
+        PsychLockMutex(&movie->mutex);
+        movie->maxQueueDepth = movie->frameAvail;
+        movie->recycledTextures = 0;
+        PsychUnlockMutex(&movie->mutex);
+        movie->framesFetched = 0;
+        movie->latencySum = 0;
+        movie->maxLatency = 0;
+        movie->lateFrames = 0;
+        movie->skippedFrames = 0;
+        movie->zeroCopyFrames = 0;
+        movie->copiedFrames = 0;
+        movie->preUploadedFrames = 0;
+    }
+}
+
 // #if GST_CHECK_VERSION(1,0,0)
 #endif
 // #ifdef PTB_USE_GSTREAMER
@@ -37,6 +37,7 @@ void PsychGSExitMovies(void);
 double PsychGSGetMovieTimeIndex(int moviehandle);
 double PsychGSSetMovieTimeIndex(int moviehandle, double timeindex, psych_bool indexIsFrames);
 void PsychGSCopyOutMovieHDRMetaData(int moviehandle, int argPosition);
+void PsychGSCopyOutMovieStatistics(int moviehandle, int argPosition, psych_bool reset);
 //end include once
 #endif
 
@@ -49,6 +49,13 @@ int PsychAddVideoFrameToMovie(int moviehandle, int frameDurationUnits, psych_boo
 unsigned char*	PsychGetVideoFrameForMoviePtr(int moviehandle, unsigned int* twidth, unsigned int* theight, unsigned int* numChannels, unsigned int* bitdepth);
 psych_bool PsychAddAudioBufferToMovie(int moviehandle, unsigned int nrChannels, unsigned int nrSamples, double* buffer);
 unsigned char* PsychMovieCopyPulledPipelineBuffer(int moviehandle, unsigned int* twidth, unsigned int* theight, unsigned int* numChannels, unsigned int* bitdepth, double* timestamp);
+void PsychMovieWritingBindWindow(int moviehandle, PsychWindowRecordType *windowRecord);
+psych_bool PsychIsAsyncMovieWriter(int moviehandle);
+PsychWindowRecordType* PsychGetMovieWriterWindow(int moviehandle, int* width, int* height);
+int PsychAddAsyncVideoFrameToMovie(int moviehandle, int x, int top, int frameDurationUnits);
+void PsychMovieWritingCaptureFlip(PsychWindowRecordType *windowRecord);
+void PsychMovieWritingDetachWindow(PsychWindowRecordType *windowRecord);
+void PsychGetMovieWriterFrameCounts(int moviehandle, int* framesAdded, int* droppedFrames, int* lateFrames);
 
 //end include once
 #endif
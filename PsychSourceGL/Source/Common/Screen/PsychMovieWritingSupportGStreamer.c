@@ -8,11 +8,14 @@
     AUTHORS:
 
         Mario Kleiner   mk      mario.kleiner.de@gmail.com
+        agent           ag      agent@local
 
     HISTORY:
 
         06-Jun-2011     mk      Wrote it.
         23-Aug-2014     mk      Ported from 0.10 to 1.0+ GStreamer.
+        19-Oct-2026     ag      Asynchronous frame readback via a ring of PBO's and a writer thread.
+                                Read back from the finalized FBO if the present queue is enabled.
 
     DESCRIPTION:
 
@@ -35,6 +38,30 @@
 
 // GStreamer implementation of movie writing support:
 
+// Default and maximum number of pixel buffer objects in the ring for asynchronous frame readback:
+#define kPsychDefaultMovieReadbackSlots 4
+#define kPsychMaxMovieReadbackSlots 16
+
+// States of a readback slot. Transitions between the last three states happen on other threads and
+// are protected by the asyncMutex of the movie writer:
+#define kPsychMovieSlotFree     0   // PBO idle and unmapped.
+#define kPsychMovieSlotReadback 1   // glReadPixels() into PBO submitted, fence pending.
+#define kPsychMovieSlotQueued   2   // Readback complete, PBO mapped, waiting for the writer thread.
+#define kPsychMovieSlotEncoding 3   // Mapped memory wrapped into a GstBuffer and owned by the encoding pipeline.
+#define kPsychMovieSlotReleased 4   // Pipeline is done with the frame, PBO needs to be unmapped for reuse.
+
+// One slot of the ring of pixel buffer objects for asynchronous frame readback:
+typedef struct {
+    int                                             moviehandle;
+    volatile int                                    state;
+    GLuint                                          pbo;
+    GLsync                                          fence;
+    unsigned char*                                  data;
+    int                                             frameDurationUnits;
+    psych_uint64                                    serial;
+    psych_bool                                      late;
+} PsychMovieReadbackSlotType;
+
 // Record which defines all state for a capture device:
 typedef struct {
     volatile psych_bool                             eos;
@@ -57,6 +84,19 @@ typedef struct {
     double                                          frameTime;
     double                                          frameTimeDelta;
     GstClockTime                                    audioTime;
+    PsychWindowRecordType*                          window;
+    psych_bool                                      recordFlips;
+    int                                             asyncSlotCount;
+    PsychMovieReadbackSlotType*                     asyncSlots;
+    psych_uint64                                    asyncSerial;
+    psych_mutex                                     asyncMutex;
+    psych_condition                                 asyncCondition;
+    psych_thread                                    asyncThread;
+    psych_bool                                      asyncShutdown;
+    GstFlowReturn                                   asyncFlowError;
+    int                                             framesAdded;
+    int                                             droppedFrames;
+    int                                             lateFrames;
 } PsychMovieWriterRecordType;
 
 static PsychMovieWriterRecordType moviewriterRecordBANK[PSYCH_MAX_MOVIEWRITERDEVICES];
@@ -230,19 +270,58 @@ unsigned char* PsychGetVideoFrameForMoviePtr(int moviehandle, unsigned int* twid
     return((unsigned char*) pwriterRec->mapinfo.data);
 }
 
-int PsychAddVideoFrameToMovie(int moviehandle, int frameDurationUnits, psych_bool isUpsideDown, double frameTimestamp)
+// Flip image of movie frame size in 'pixptr' vertically, in place:
+static void PsychMovieFlipImageVertically(PsychMovieWriterRecordType* pwriterRec, unsigned char* pixptr)
 {
-    PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
-    GstBuffer*          refBuffer = NULL;
-    GstBuffer*          curBuffer = NULL;
-    GstFlowReturn       ret;
     int                 x, y, w, h;
-    unsigned char*      pixptr;
     unsigned int*       wordptr;
     unsigned int        *wordptr2, *wordptr1;
     unsigned char       *byteptr2, *byteptr1;
     unsigned int        dummy;
     unsigned char       dummyb;
+
+    // RGBA8 format?
+    if ((pwriterRec->numChannels == 4) && (pwriterRec->bitdepth == 8)) {
+        // Yes. Can use optimized copy of uint32 units:
+        wordptr  = (unsigned int*) pixptr;
+        h = pwriterRec->height;
+        w = pwriterRec->width;
+        wordptr1 = wordptr;
+        for (y = 0; y < h/2; y++) {
+            wordptr2 = wordptr;
+            wordptr2 += ((h - 1 - y) * w);
+            for (x = 0; x < w; x++) {
+                dummy = *wordptr1;
+                *(wordptr1++) = *wordptr2;
+                *(wordptr2++) = dummy;
+            }
+        }
+    }
+    else {
+        // No. Could be 1, 2, 3, 6 or 8 bytes per pixel. Just use a
+        // robust but slightly less efficient byte-wise copy:
+        h = pwriterRec->height;
+        w = pwriterRec->width;
+        w = w * pwriterRec->numChannels * pwriterRec->bitdepth / 8;
+        byteptr1 = pixptr;
+        for (y = 0; y < h/2; y++) {
+            byteptr2 = pixptr;
+            byteptr2 += ((h - 1 - y) * w);
+            for (x = 0; x < w; x++) {
+                dummyb = *byteptr1;
+                *(byteptr1++) = *byteptr2;
+                *(byteptr2++) = dummyb;
+            }
+        }
+    }
+}
+
+int PsychAddVideoFrameToMovie(int moviehandle, int frameDurationUnits, psych_bool isUpsideDown, double frameTimestamp)
+{
+    PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
+    GstBuffer*          refBuffer = NULL;
+    GstBuffer*          curBuffer = NULL;
+    GstFlowReturn       ret;
     int                 bframeDurationUnits = frameDurationUnits;
 
     if (NULL == pwriterRec->ptbvideoappsrc) return(0);
@@ -264,43 +343,7 @@ int PsychAddVideoFrameToMovie(int moviehandle, int frameDurationUnits, psych_boo
     }
     
     // Is Imagebuffer upside-down? If so, need to flip it vertically:
-    if (isUpsideDown) {
-        // RGBA8 format?
-        if ((pwriterRec->numChannels == 4) && (pwriterRec->bitdepth == 8)) {
-            // Yes. Can use optimized copy of uint32 units:
-            wordptr  = (unsigned int*)  pwriterRec->mapinfo.data;
-            h = pwriterRec->height;
-            w = pwriterRec->width;
-            wordptr1 = wordptr;
-            for (y = 0; y < h/2; y++) {
-                wordptr2 = wordptr;
-                wordptr2 += ((h - 1 - y) * w);
-                for (x = 0; x < w; x++) {
-                    dummy = *wordptr1;
-                    *(wordptr1++) = *wordptr2;
-                    *(wordptr2++) = dummy;
-                }
-            }
-        }
-        else {
-            // No. Could be 1, 2, 3, 6 or 8 bytes per pixel. Just use a
-            // robust but slightly less efficient byte-wise copy:
-            pixptr = (unsigned char*) pwriterRec->mapinfo.data;
-            h = pwriterRec->height;
-            w = pwriterRec->width;
-            w = w * pwriterRec->numChannels * pwriterRec->bitdepth / 8;
-            byteptr1 = pixptr;
-            for (y = 0; y < h/2; y++) {
-                byteptr2 = pixptr;
-                byteptr2 += ((h - 1 - y) * w);
-                for (x = 0; x < w; x++) {
-                    dummyb = *byteptr1;
-                    *(byteptr1++) = *byteptr2;
-                    *(byteptr2++) = dummyb;
-                }
-            }
-        }
-    }
+    if (isUpsideDown) PsychMovieFlipImageVertically(pwriterRec, (unsigned char*) pwriterRec->mapinfo.data);
 
     // Done writing to this buffer:
     gst_buffer_unmap(pwriterRec->PixMap, &(pwriterRec->mapinfo));
@@ -356,6 +399,8 @@ int PsychAddVideoFrameToMovie(int moviehandle, int frameDurationUnits, psych_boo
         return((int) ret);
     }
 
+    pwriterRec->framesAdded++;
+
     PsychGSProcessMovieContext(pwriterRec, FALSE);
 
     if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG:In AddFrameToMovie: Added new videoframe with %i units duration and upsidedown = %i to moviehandle %i.\n", bframeDurationUnits, (int) isUpsideDown, moviehandle);
@@ -364,6 +409,465 @@ int PsychAddVideoFrameToMovie(int moviehandle, int frameDurationUnits, psych_boo
     return((int) ret);
 }
 
+// Destroy notify for the memory of GstBuffers which wrap a mapped readback PBO. Called from
+// GStreamer streaming threads, once the encoding pipeline is done with the video frame:
+static void PsychMovieReadbackSlotReleased(gpointer data)
+{
+    PsychMovieReadbackSlotType* slot = (PsychMovieReadbackSlotType*) data;
+    PsychMovieWriterRecordType* pwriterRec = &(moviewriterRecordBANK[slot->moviehandle]);
+
+    PsychLockMutex(&pwriterRec->asyncMutex);
+    slot->state = kPsychMovieSlotReleased;
+    PsychUnlockMutex(&pwriterRec->asyncMutex);
+}
+
+// Return oldest readback slot in state 'state', or NULL if none:
+static PsychMovieReadbackSlotType* PsychMovieOldestReadbackSlot(PsychMovieWriterRecordType* pwriterRec, int state)
+{
+    PsychMovieReadbackSlotType* slot = NULL;
+    int i;
+
+    for (i = 0; i < pwriterRec->asyncSlotCount; i++) {
+        if ((pwriterRec->asyncSlots[i].state == state) && (!slot || (pwriterRec->asyncSlots[i].serial < slot->serial)))
+            slot = &(pwriterRec->asyncSlots[i]);
+    }
+
+    return(slot);
+}
+
+// Main routine of the writer thread: Pushes completed readbacks, in order of capture, as
+// GstBuffers which wrap the mapped PBO memory into the encoding pipeline:
+static void* PsychMovieWriterThreadMain(void* pwriterRecToCast)
+{
+    PsychMovieWriterRecordType* pwriterRec = (PsychMovieWriterRecordType*) pwriterRecToCast;
+    PsychMovieReadbackSlotType* slot;
+    GstBuffer*                  videoBuffer;
+    GstBuffer*                  curBuffer;
+    GstFlowReturn               ret;
+    size_t                      size = (size_t) pwriterRec->width * pwriterRec->height * pwriterRec->numChannels * (pwriterRec->bitdepth / 8);
+    int                         units;
+
+    // Assign a name to ourselves, for debugging:
+    PsychSetThreadName("ScreenMovieWrt");
+
+    PsychLockMutex(&pwriterRec->asyncMutex);
+    while (TRUE) {
+        slot = PsychMovieOldestReadbackSlot(pwriterRec, kPsychMovieSlotQueued);
+        if (NULL == slot) {
+            // Nothing to do. Exit if all work is done and shutdown is requested, otherwise wait for new frames:
+            if (pwriterRec->asyncShutdown) break;
+            PsychWaitCondition(&pwriterRec->asyncCondition, &pwriterRec->asyncMutex);
+            continue;
+        }
+
+        slot->state = kPsychMovieSlotEncoding;
+        PsychUnlockMutex(&pwriterRec->asyncMutex);
+
+        // Readback delivers the image upside-down, so flip it in place:
+        PsychMovieFlipImageVertically(pwriterRec, slot->data);
+
+        // Wrap the mapped PBO memory into a GstBuffer without copying it. Frames which last for more than
+        // one unit of duration get replicated as shallow copies which reference the same memory. Once the
+        // pipeline releases the memory, PsychMovieReadbackSlotReleased() hands the PBO back for reuse:
+        videoBuffer = gst_buffer_new_wrapped_full(0, (gpointer) slot->data, size, 0, size, (gpointer) slot, PsychMovieReadbackSlotReleased);
+
+        ret = GST_FLOW_OK;
+        for (units = slot->frameDurationUnits; (units > 0) && (ret == GST_FLOW_OK); units--) {
+            curBuffer = (units > 1) ? gst_buffer_copy(videoBuffer) : videoBuffer;
+            GST_BUFFER_PTS(curBuffer) = (psych_uint64) (pwriterRec->frameTime * 1e9);
+            pwriterRec->frameTime += pwriterRec->frameTimeDelta;
+
+            // The function takes our reference, so we *must not unref the buffer*
+            ret = gst_app_src_push_buffer(GST_APP_SRC(pwriterRec->ptbvideoappsrc), curBuffer);
+        }
+
+        // Original buffer not pushed due to error? Release it, which also releases the slot:
+        if (units > 0) gst_buffer_unref(videoBuffer);
+
+        PsychLockMutex(&pwriterRec->asyncMutex);
+        if (ret != GST_FLOW_OK) pwriterRec->asyncFlowError = ret;
+    }
+    PsychUnlockMutex(&pwriterRec->asyncMutex);
+
+    return(NULL);
+}
+
+// Hand completed readbacks to the writer thread, in order of capture, and unmap the PBO's of
+// frames which the pipeline is done with, so they can be reused. Must be called with the GL
+// context of the movies window bound. If 'flush' is set, waits for all pending readbacks:
+static void PsychMovieHarvestReadbacks(PsychMovieWriterRecordType* pwriterRec, psych_bool flush)
+{
+    PsychMovieReadbackSlotType* slot;
+    psych_bool queued = FALSE;
+    int i;
+
+    while ((slot = PsychMovieOldestReadbackSlot(pwriterRec, kPsychMovieSlotReadback))) {
+        if (glClientWaitSync(slot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, (flush) ? 5000000000ULL : 0) == GL_TIMEOUT_EXPIRED) {
+            // Not yet complete: Any readback which is still pending when the next frame gets captured is late:
+            for (i = 0; i < pwriterRec->asyncSlotCount; i++) {
+                slot = &(pwriterRec->asyncSlots[i]);
+                if ((slot->state == kPsychMovieSlotReadback) && !slot->late) {
+                    slot->late = TRUE;
+                    pwriterRec->lateFrames++;
+                }
+            }
+
+            if (!flush) break;
+            slot = PsychMovieOldestReadbackSlot(pwriterRec, kPsychMovieSlotReadback);
+        }
+
+        glDeleteSync(slot->fence);
+        slot->fence = NULL;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+        slot->data = (unsigned char*) glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_WRITE);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        if (NULL == slot->data) {
+            if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: In AddFrameToMovie: Failed to map readback buffer for moviehandle %i. Frame dropped.\n", slot->moviehandle);
+            slot->state = kPsychMovieSlotFree;
+
+            // Count the frame only once, as dropped instead of added:
+            pwriterRec->framesAdded--;
+            pwriterRec->droppedFrames++;
+            continue;
+        }
+
+        PsychLockMutex(&pwriterRec->asyncMutex);
+        slot->state = kPsychMovieSlotQueued;
+        PsychUnlockMutex(&pwriterRec->asyncMutex);
+        queued = TRUE;
+    }
+
+    // Wake up writer thread if there is new work:
+    if (queued) {
+        PsychLockMutex(&pwriterRec->asyncMutex);
+        PsychSignalCondition(&pwriterRec->asyncCondition);
+        PsychUnlockMutex(&pwriterRec->asyncMutex);
+    }
+
+    // Reclaim PBO's released by the pipeline:
+    for (i = 0; i < pwriterRec->asyncSlotCount; i++) {
+        slot = &(pwriterRec->asyncSlots[i]);
+        if (slot->state != kPsychMovieSlotReleased) continue;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        slot->data = NULL;
+
+        PsychLockMutex(&pwriterRec->asyncMutex);
+        slot->state = kPsychMovieSlotFree;
+        PsychUnlockMutex(&pwriterRec->asyncMutex);
+    }
+}
+
+// OpenGL-ES version of PsychMovieReadPixels() for 8 bpc movies and readback into 'framepixels':
+// OpenGL-ES only guarantees GL_RGBA + GL_UNSIGNED_BYTE readback, so read that and swizzle into the
+// same pixel layout the desktop OpenGL readback produces:
+static void PsychMovieReadPixelsGLES(PsychMovieWriterRecordType* pwriterRec, int x, int y, unsigned char* framepixels)
+{
+    unsigned char *rgba, *src, *dst;
+    size_t i, n = (size_t) pwriterRec->width * pwriterRec->height;
+
+    rgba = (unsigned char*) malloc(n * 4);
+    if (NULL == rgba) {
+        if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: Out of memory while reading back movie frame. Frame will be garbage.\n");
+        return;
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(x, y, pwriterRec->width, pwriterRec->height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+
+    for (i = 0, src = rgba, dst = framepixels; i < n; i++, src += 4) {
+        switch (pwriterRec->numChannels) {
+            case 4:
+                // Byte order of GL_BGRA + GL_UNSIGNED_INT_8_8_8_8 on little-endian machines: A, R, G, B.
+                *(dst++) = src[3];
+                *(dst++) = src[0];
+                *(dst++) = src[1];
+                *(dst++) = src[2];
+                break;
+
+            case 3:
+                *(dst++) = src[0];
+                *(dst++) = src[1];
+                *(dst++) = src[2];
+                break;
+
+            default:
+                *(dst++) = src[0];
+                break;
+        }
+    }
+
+    free(rgba);
+}
+
+// Read back a movie frame sized image with bottom-left corner (x,y) from the current read buffer
+// into 'framepixels', or into the bound pixel pack buffer at offset 'framepixels':
+static void PsychMovieReadPixels(PsychMovieWriterRecordType* pwriterRec, int x, int y, unsigned char* framepixels)
+{
+    GLenum type = (pwriterRec->bitdepth <= 8) ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT;
+
+    // OpenGL-ES doesn't support our desktop readback formats. Asynchronous readback into pixel buffers
+    // is disabled on OpenGL-ES, so this is always a synchronous 8 bpc readback into 'framepixels':
+    if (PsychIsGLES(pwriterRec->window)) {
+        PsychMovieReadPixelsGLES(pwriterRec, x, y, framepixels);
+        return;
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    switch (pwriterRec->numChannels) {
+        case 4:
+            glReadPixels(x, y, pwriterRec->width, pwriterRec->height, GL_BGRA, (pwriterRec->bitdepth <= 8) ? GL_UNSIGNED_INT_8_8_8_8 : GL_UNSIGNED_SHORT, framepixels);
+            break;
+
+        case 3:
+            glReadPixels(x, y, pwriterRec->width, pwriterRec->height, GL_RGB, type, framepixels);
+            break;
+
+        default:
+            glReadPixels(x, y, pwriterRec->width, pwriterRec->height, GL_RED, type, framepixels);
+            break;
+    }
+}
+
+// Drain the readback ring and stop the writer thread. All readbacks are pushed into the pipeline afterwards:
+static void PsychMovieStopAsyncReadback(PsychMovieWriterRecordType* pwriterRec)
+{
+    PsychSetGLContext(pwriterRec->window);
+    PsychMovieHarvestReadbacks(pwriterRec, TRUE);
+
+    PsychLockMutex(&pwriterRec->asyncMutex);
+    pwriterRec->asyncShutdown = TRUE;
+    PsychSignalCondition(&pwriterRec->asyncCondition);
+    PsychUnlockMutex(&pwriterRec->asyncMutex);
+
+    PsychDeleteThread(&(pwriterRec->asyncThread));
+    pwriterRec->asyncThread = (psych_thread) NULL;
+}
+
+// Release the readback ring. Must only be called after the pipeline was shut down and released all frames:
+static void PsychMovieReleaseAsyncReadback(PsychMovieWriterRecordType* pwriterRec)
+{
+    PsychMovieReadbackSlotType* slot;
+    int i;
+
+    PsychSetGLContext(pwriterRec->window);
+    for (i = 0; i < pwriterRec->asyncSlotCount; i++) {
+        slot = &(pwriterRec->asyncSlots[i]);
+        if ((slot->state != kPsychMovieSlotFree) && (slot->state != kPsychMovieSlotReleased) && (PsychPrefStateGet_Verbosity() > 1))
+            printf("PTB-WARNING: Readback buffer %i of moviehandle %i still in use at movie close time!\n", i, slot->moviehandle);
+
+        if (slot->fence) glDeleteSync(slot->fence);
+        glDeleteBuffers(1, &(slot->pbo));
+    }
+
+    free(pwriterRec->asyncSlots);
+    pwriterRec->asyncSlots = NULL;
+    pwriterRec->asyncSlotCount = 0;
+
+    PsychDestroyMutex(&pwriterRec->asyncMutex);
+    PsychDestroyCondition(&pwriterRec->asyncCondition);
+}
+
+// Bind movie to the onscreen window whose images are recorded. Sets up asynchronous readback if requested:
+void PsychMovieWritingBindWindow(int moviehandle, PsychWindowRecordType *windowRecord)
+{
+    PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
+    size_t size = (size_t) pwriterRec->width * pwriterRec->height * pwriterRec->numChannels * (pwriterRec->bitdepth / 8);
+    int i;
+
+    pwriterRec->window = windowRecord;
+    if (pwriterRec->asyncSlotCount == 0) return;
+
+    // Asynchronous readback needs pixel buffer objects, fences and mappable buffers:
+    PsychSetGLContext(windowRecord);
+    if (PsychIsGLES(windowRecord) || !glewIsSupported("GL_ARB_pixel_buffer_object") || !glewIsSupported("GL_ARB_sync")) {
+        if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: In CreateMovie: Asynchronous frame readback for moviehandle %i unsupported by your graphics driver. Using synchronous readback.\n", moviehandle);
+        pwriterRec->asyncSlotCount = 0;
+        return;
+    }
+
+    pwriterRec->asyncSlots = (PsychMovieReadbackSlotType*) calloc(pwriterRec->asyncSlotCount, sizeof(PsychMovieReadbackSlotType));
+    if (NULL == pwriterRec->asyncSlots) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory when trying to setup asynchronous frame readback for movie!");
+
+    while (glGetError());
+    for (i = 0; i < pwriterRec->asyncSlotCount; i++) {
+        pwriterRec->asyncSlots[i].moviehandle = moviehandle;
+        pwriterRec->asyncSlots[i].state = kPsychMovieSlotFree;
+        glGenBuffers(1, &(pwriterRec->asyncSlots[i].pbo));
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pwriterRec->asyncSlots[i].pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr) size, NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    PsychInitMutex(&pwriterRec->asyncMutex);
+    PsychInitCondition(&pwriterRec->asyncCondition, NULL);
+    pwriterRec->asyncShutdown = FALSE;
+    pwriterRec->asyncFlowError = GST_FLOW_OK;
+
+    if ((glGetError() != GL_NO_ERROR) || PsychCreateThread(&(pwriterRec->asyncThread), NULL, PsychMovieWriterThreadMain, (void*) pwriterRec)) {
+        if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: In CreateMovie: Failed to setup asynchronous frame readback for moviehandle %i. Using synchronous readback.\n", moviehandle);
+        pwriterRec->asyncThread = (psych_thread) NULL;
+        PsychMovieReleaseAsyncReadback(pwriterRec);
+        return;
+    }
+
+    if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Moviehandle %i uses asynchronous frame readback with %i buffers.\n", moviehandle, pwriterRec->asyncSlotCount);
+}
+
+psych_bool PsychIsAsyncMovieWriter(int moviehandle)
+{
+    return(PsychGetMovieWriter(moviehandle, FALSE)->asyncSlots != NULL);
+}
+
+// Return the window the movie is bound to, or NULL if unbound, and the size of its video frames:
+PsychWindowRecordType* PsychGetMovieWriterWindow(int moviehandle, int* width, int* height)
+{
+    PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
+
+    *width = pwriterRec->width;
+    *height = pwriterRec->height;
+
+    return(pwriterRec->window);
+}
+
+// Start asynchronous readback of a movie frame sized image with top-left corner (x,top) in OpenGL
+// coordinates from the current read buffer into the next free PBO of the readback ring. Returns
+// immediately. The frame gets dropped if the ring is full, because the encoding pipeline can't keep up:
+int PsychAddAsyncVideoFrameToMovie(int moviehandle, int x, int top, int frameDurationUnits)
+{
+    PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
+    PsychMovieReadbackSlotType* slot;
+    int i;
+
+    // Report any failure of the writer thread:
+    if (pwriterRec->asyncFlowError != GST_FLOW_OK) {
+        if (PsychPrefStateGet_Verbosity() > 0) printf("PTB-ERROR:In AddFrameToMovie: Adding frame to moviehandle %i failed [push-buffer returned error code %i]!\n", moviehandle, (int) pwriterRec->asyncFlowError);
+        return((int) pwriterRec->asyncFlowError);
+    }
+
+    PsychMovieHarvestReadbacks(pwriterRec, FALSE);
+
+    for (i = 0; i < pwriterRec->asyncSlotCount; i++) {
+        if (pwriterRec->asyncSlots[i].state == kPsychMovieSlotFree) break;
+    }
+
+    if (i == pwriterRec->asyncSlotCount) {
+        pwriterRec->droppedFrames++;
+        if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG:In AddFrameToMovie: All %i readback buffers of moviehandle %i busy. Frame dropped.\n", pwriterRec->asyncSlotCount, moviehandle);
+        return(0);
+    }
+
+    slot = &(pwriterRec->asyncSlots[i]);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    PsychMovieReadPixels(pwriterRec, x, top - pwriterRec->height, NULL);
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot->frameDurationUnits = frameDurationUnits;
+    slot->serial = pwriterRec->asyncSerial++;
+    slot->late = FALSE;
+    slot->state = kPsychMovieSlotReadback;
+    pwriterRec->framesAdded++;
+
+    PsychGSProcessMovieContext(pwriterRec, FALSE);
+
+    return(0);
+}
+
+// Add the final image of the current flip of 'windowRecord' to all movies which record its flips.
+// Called at the end of the preflip operations, with the GL context of the window bound:
+void PsychMovieWritingCaptureFlip(PsychWindowRecordType *windowRecord)
+{
+    PsychMovieWriterRecordType* pwriterRec;
+    PsychFBO* fbo;
+    GLint oldfbo, oldreadbuffer;
+    unsigned char* framepixels;
+    unsigned int twidth, theight, numChannels, bitdepth;
+    int i, top;
+
+    for (i = 0; i < PSYCH_MAX_MOVIEWRITERDEVICES; i++) {
+        pwriterRec = &(moviewriterRecordBANK[i]);
+        if (!pwriterRec->Movie || !pwriterRec->recordFlips || (pwriterRec->window != windowRecord)) continue;
+
+        if (PsychIsGLES(windowRecord) && (pwriterRec->bitdepth > 8)) {
+            if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: Can not record flips of window %i into moviehandle %i with more than 8 bpc on OpenGL-ES. Recording disabled.\n", windowRecord->windowIndex, i);
+            pwriterRec->recordFlips = FALSE;
+            continue;
+        }
+
+        oldreadbuffer = GL_BACK;
+        PSYCHEXECNONGLES(glGetIntegerv(GL_READ_BUFFER, &oldreadbuffer));
+        oldfbo = 0;
+        if (glBindFramebufferEXT) glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &oldfbo);
+
+        // Final image is in the finalizedFBO if an external sink, our own VRR scheduler or a present queue slot
+        // consumes it, otherwise in the system backbuffer:
+        if ((windowRecord->imagingMode & kPsychNeedFinalizedFBOSinks) || (windowRecord->vrrMode == kPsychVRROwnScheduled) ||
+            (windowRecord->flipInfo && (windowRecord->flipInfo->queueCapacity > 0))) {
+            fbo = windowRecord->fboTable[windowRecord->finalizedFBO[0]];
+            if (fbo->multisample > 0) {
+                if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: Can not record flips of window %i into moviehandle %i from a multisampled framebuffer. Recording disabled.\n", windowRecord->windowIndex, i);
+                pwriterRec->recordFlips = FALSE;
+                continue;
+            }
+
+            glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, fbo->fboid);
+            PSYCHEXECNONGLES(glReadBuffer(GL_COLOR_ATTACHMENT0_EXT));
+            top = fbo->height;
+        }
+        else {
+            if (glBindFramebufferEXT) glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
+            PSYCHEXECNONGLES(glReadBuffer(GL_BACK));
+            top = (int) PsychGetHeightFromRect(windowRecord->rect);
+        }
+
+        // Record image of movie frame size at top-left corner of the window:
+        if (pwriterRec->asyncSlots) {
+            PsychAddAsyncVideoFrameToMovie(i, 0, top, 1);
+        }
+        else if ((framepixels = PsychGetVideoFrameForMoviePtr(i, &twidth, &theight, &numChannels, &bitdepth))) {
+            PsychMovieReadPixels(pwriterRec, 0, top - pwriterRec->height, framepixels);
+            PsychAddVideoFrameToMovie(i, 1, TRUE, -1);
+        }
+
+        if (glBindFramebufferEXT) glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, oldfbo);
+        PSYCHEXECNONGLES(glReadBuffer(oldreadbuffer));
+    }
+}
+
+// Onscreen window 'windowRecord' is about to close: Stop recording its flips, and finalize
+// movies which still use asynchronous readback from it, as that needs the windows GL context:
+void PsychMovieWritingDetachWindow(PsychWindowRecordType *windowRecord)
+{
+    int i;
+
+    for (i = 0; i < PSYCH_MAX_MOVIEWRITERDEVICES; i++) {
+        if (!moviewriterRecordBANK[i].Movie || (moviewriterRecordBANK[i].window != windowRecord)) continue;
+
+        if (moviewriterRecordBANK[i].asyncSlots) {
+            if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: Window %i closed while moviehandle %i still uses asynchronous readback from it. Finalizing movie now.\n", windowRecord->windowIndex, i);
+            PsychFinalizeNewMovieFile(i);
+        }
+
+        moviewriterRecordBANK[i].window = NULL;
+        moviewriterRecordBANK[i].recordFlips = FALSE;
+    }
+}
+
+// Return the frame counts of movie 'moviehandle'. Also valid after the movie was finalized, until the handle gets reused:
+void PsychGetMovieWriterFrameCounts(int moviehandle, int* framesAdded, int* droppedFrames, int* lateFrames)
+{
+    PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, TRUE);
+
+    *framesAdded = pwriterRec->framesAdded;
+    *droppedFrames = pwriterRec->droppedFrames;
+    *lateFrames = pwriterRec->lateFrames;
+}
+
 psych_bool PsychAddAudioBufferToMovie(int moviehandle, unsigned int nrChannels, unsigned int nrSamples, double* buffer)
 {
     PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
@@ -609,6 +1113,14 @@ int PsychCreateNewMovieFile(char* moviefile, int width, int height, double frame
     pwriterRec->frameTime = 0.0;
     pwriterRec->frameTimeDelta = (framerate > 0.0) ? (1.0 / framerate) : 0.0;
     pwriterRec->audioTime = 0;
+    pwriterRec->window = NULL;
+    pwriterRec->recordFlips = FALSE;
+    pwriterRec->asyncSlotCount = 0;
+    pwriterRec->asyncSlots = NULL;
+    pwriterRec->asyncSerial = 0;
+    pwriterRec->framesAdded = 0;
+    pwriterRec->droppedFrames = 0;
+    pwriterRec->lateFrames = 0;
 
     // If no movieoptions specified, create default string for default
     // codec selection and configuration:
@@ -699,6 +1211,19 @@ int PsychCreateNewMovieFile(char* moviefile, int width, int height, double frame
         pwriterRec->useVariableFramerate = FALSE;
     }
 
+    // Asynchronous readback of video frames via a ring of PBO's requested? The ring gets
+    // set up later, when the movie is bound to its window via PsychMovieWritingBindWindow():
+    if ((poption = strstr(movieoptions, "AsyncReadback"))) {
+        pwriterRec->asyncSlotCount = kPsychDefaultMovieReadbackSlots;
+        if (sscanf(poption, "AsyncReadback=%i", &dummyInt) == 1) {
+            if ((dummyInt < 2) || (dummyInt > kPsychMaxMovieReadbackSlots)) PsychErrorExitMsg(PsychError_user, "Invalid AsyncReadback= parameter provided in movieoptions parameter. Must be between 2 and 16 buffers!");
+            pwriterRec->asyncSlotCount = dummyInt;
+        }
+    }
+
+    // Add the final image of each flip of the window as a new video frame?
+    if (strstr(movieoptions, "RecordFlips")) pwriterRec->recordFlips = TRUE;
+
     // Full GStreamer launch line a la gst-launch command provided?
     if (strstr(movieoptions, "gst-launch")) {
         // Yes: We use movieoptions directly as launch line:
@@ -1028,6 +1553,9 @@ int PsychFinalizeNewMovieFile(int movieHandle)
 
     PsychGSProcessMovieContext(pwriterRec, FALSE);
 
+    // Push all frames of an asynchronous readback into the pipeline before end of stream:
+    if (pwriterRec->asyncSlots) PsychMovieStopAsyncReadback(pwriterRec);
+
     // Send EOS signal downstream:
     ret = gst_app_src_end_of_stream(GST_APP_SRC(pwriterRec->ptbvideoappsrc));
     if (ret != GST_FLOW_OK) myErr |= 1;
@@ -1088,6 +1616,9 @@ int PsychFinalizeNewMovieFile(int movieHandle)
     gst_object_unref(GST_OBJECT(pwriterRec->Movie));
     pwriterRec->Movie = NULL;
 
+    // Pipeline has released all frames, so the readback ring can go:
+    if (pwriterRec->asyncSlots) PsychMovieReleaseAsyncReadback(pwriterRec);
+
     if (pwriterRec->ptbvideoappsrc) gst_object_unref(GST_OBJECT(pwriterRec->ptbvideoappsrc));
     pwriterRec->ptbvideoappsrc = NULL;
 
@@ -1101,9 +1632,23 @@ int PsychFinalizeNewMovieFile(int movieHandle)
     if (pwriterRec->Context) g_main_loop_unref(pwriterRec->Context);
     pwriterRec->Context = NULL;
 
+    pwriterRec->window = NULL;
+    pwriterRec->recordFlips = FALSE;
+
     // Decrement count of active writers:
     moviewritercount--;
 
+    // Report frames lost due to back-pressure from the encoding pipeline:
+    if ((pwriterRec->droppedFrames > 0) || (pwriterRec->lateFrames > 0)) {
+        if (PsychPrefStateGet_Verbosity() > 1) {
+            printf("PTB-WARNING: Moviehandle %i: %i of %i added frames were dropped, because all readback buffers were busy, and %i\n", movieHandle, pwriterRec->droppedFrames, pwriterRec->framesAdded + pwriterRec->droppedFrames, pwriterRec->lateFrames);
+            printf("PTB-WARNING: frame readbacks were late. Consider more buffers via AsyncReadback=n, or a faster video codec.\n");
+        }
+    }
+    else if (PsychPrefStateGet_Verbosity() > 3) {
+        printf("PTB-INFO: Moviehandle %i: All %i added frames written.\n", movieHandle, pwriterRec->framesAdded);
+    }
+
     // Return success/fail status:
     if (myErr == 0) {
         if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Moviehandle %i successfully closed and movie written to filesystem.\n", movieHandle);
@@ -1159,5 +1704,31 @@ psych_bool PsychAddAudioBufferToMovie(int moviehandle, unsigned int nrChannels,
     return FALSE;
 }
 
+void PsychMovieWritingBindWindow(int moviehandle, PsychWindowRecordType *windowRecord) { return; }
+void PsychMovieWritingCaptureFlip(PsychWindowRecordType *windowRecord) { return; }
+void PsychMovieWritingDetachWindow(PsychWindowRecordType *windowRecord) { return; }
+
+psych_bool PsychIsAsyncMovieWriter(int moviehandle)
+{
+    return(FALSE);
+}
+
+PsychWindowRecordType* PsychGetMovieWriterWindow(int moviehandle, int* width, int* height)
+{
+    PsychErrorExitMsg(PsychError_unimplemented, "Sorry, movie writing not supported on this operating system");
+    return(NULL);
+}
+
+int PsychAddAsyncVideoFrameToMovie(int moviehandle, int x, int top, int frameDurationUnits)
+{
+    PsychErrorExitMsg(PsychError_unimplemented, "Sorry, movie writing not supported on this operating system");
+    return(1);
+}
+
+void PsychGetMovieWriterFrameCounts(int moviehandle, int* framesAdded, int* droppedFrames, int* lateFrames)
+{
+    PsychErrorExitMsg(PsychError_unimplemented, "Sorry, movie writing not supported on this operating system");
+}
+
 // End of surrogate routines.
 #endif
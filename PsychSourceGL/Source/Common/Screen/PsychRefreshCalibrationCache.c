@@ -0,0 +1,351 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychRefreshCalibrationCache.c
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           ag      agent@local
+
+    HISTORY:
+
+        19.10.2026  ag      Wrote it.
+
+    DESCRIPTION:
+
+        Persistent on-disk cache of per-display refresh calibration results.
+
+        At each Screen('OpenWindow'), PsychOpenOnscreenWindow() measures the VBL endline via
+        beamposition queries over 50 video refresh cycles, then calibrates the video refresh
+        interval via VBL synced bufferswaps until the standard deviation of the samples falls
+        below the threshold of the sync tests. This takes at least one, often multiple seconds.
+
+        If enabled via Screen('Preference', 'RefreshCalibrationCache', 1), the results and
+        verdicts of a successful full calibration are stored, keyed by a 64 bit hash over the
+        gpu and driver identity (GL vendor, renderer and version strings), the display output
+        and its video mode, and all settings which influence the calibration procedure. At the
+        next window opening with the same key, the cached results are only verified by a short
+        run of a few VBL synced flips and beamposition samples. Only on a mismatch, the cache
+        entry is deleted and the full calibration is performed.
+
+        The cache directory is:
+
+        - $PSYCH_CALIBRATION_CACHE_DIR if that environment variable is set and non-empty.
+        - Otherwise on Linux $XDG_CACHE_HOME/Psychtoolbox/CalibrationCache/ or ~/.cache/Psychtoolbox/CalibrationCache/
+        - on macOS ~/Library/Caches/Psychtoolbox/CalibrationCache/
+        - on MS-Windows %LOCALAPPDATA%\Psychtoolbox\CalibrationCache\
+*/
+
+#include "Screen.h"
+
+// Magic tag and version of the cache file format. Bump the version on any incompatible change:
+#define PSYCH_CALIBCACHE_MAGIC          0x42494c4143425450ULL   // "PTBCALIB" in little-endian ascii.
+#define PSYCH_CALIBCACHE_VERSION        2
+
+// Number of valid VBL synced flip intervals to measure for verification of a cached calibration:
+#define PSYCH_CALIBCACHE_VERIFYSAMPLES  10
+
+// Number of video refresh cycles to sample for verification of cached beamposition results:
+#define PSYCH_CALIBCACHE_VERIFYCYCLES   3
+
+// Content of each cache file:
+typedef struct {
+    psych_uint64                magic;
+    psych_uint64                cachekey;
+    unsigned int                version;
+    unsigned int                pad;
+    PsychRefreshCalibrationType calib;
+    psych_uint64                checksum;
+} PsychRefreshCalibrationFileType;
+
+static psych_uint64 PsychRefreshCalibrationCacheHash(psych_uint64 hash, const char* str)
+{
+    // 64 bit FNV-1a hash, with a terminating zero byte included, so "ab" + "c" != "a" + "bc":
+    if (str) {
+        while (*str) {
+            hash ^= (psych_uint64) (unsigned char) *(str++);
+            hash *= 0x100000001b3ULL;
+        }
+    }
+
+    hash *= 0x100000001b3ULL;
+
+    return(hash);
+}
+
+static psych_uint64 PsychRefreshCalibrationCacheChecksum(const unsigned char* data, size_t length)
+{
+    psych_uint64 hash = 0xcbf29ce484222325ULL;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash ^= (psych_uint64) data[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return(hash);
+}
+
+static const char* PsychRefreshCalibrationCacheGetDir(void)
+{
+    static psych_bool   firstTime = TRUE;
+    static char         cachedir[FILENAME_MAX + 1];
+
+    if (firstTime) {
+        firstTime = FALSE;
+        cachedir[0] = 0;
+
+        PsychSetupCacheDir(cachedir, sizeof(cachedir), "PSYCH_CALIBRATION_CACHE_DIR", "CalibrationCache");
+    }
+
+    return(cachedir);
+}
+
+static void PsychRefreshCalibrationCacheFilename(char* filename, size_t maxlen, psych_uint64 cachekey)
+{
+    snprintf(filename, maxlen, "%s%016llx.calib", PsychRefreshCalibrationCacheGetDir(), (unsigned long long) cachekey);
+}
+
+/* PsychRefreshCalibrationCacheKey()
+ *
+ * Compute the cache key for the refresh calibration of onscreen window 'windowRecord', whose OpenGL
+ * context must be bound. 'ifi_nominal' is the refresh interval reported by the operating system.
+ * Returns 0 if caching is not possible.
+ */
+psych_uint64 PsychRefreshCalibrationCacheKey(PsychWindowRecordType *windowRecord, double ifi_nominal)
+{
+    char keystr[512];
+    int screenNumber = windowRecord->screenNumber;
+    long width, height;
+    int mm_width, mm_height;
+    psych_uint64 hash;
+
+    if (strlen(PsychRefreshCalibrationCacheGetDir()) == 0) return(0);
+
+    // Gpu and driver identity:
+    hash = 0xcbf29ce484222325ULL + PSYCH_CALIBCACHE_VERSION;
+    hash = PsychRefreshCalibrationCacheHash(hash, (const char*) glGetString(GL_VENDOR));
+    hash = PsychRefreshCalibrationCacheHash(hash, (const char*) glGetString(GL_RENDERER));
+    hash = PsychRefreshCalibrationCacheHash(hash, (const char*) glGetString(GL_VERSION));
+
+    // Display and video mode:
+    PsychGetScreenPixelSize(screenNumber, &width, &height);
+    PsychGetDisplaySize(screenNumber, &mm_width, &mm_height);
+    snprintf(keystr, sizeof(keystr), "%i:%ld:%ld:%i:%i:%i:%.6f", screenNumber, width, height, mm_width, mm_height,
+             PsychGetScreenDepthValue(screenNumber), ifi_nominal);
+    hash = PsychRefreshCalibrationCacheHash(hash, keystr);
+
+    #if PSYCH_SYSTEM == PSYCH_LINUX
+    {
+        // Name and exact video modeline of the primary output of the screen:
+        XRRModeInfo *mode;
+
+        PsychLockDisplay();
+        mode = PsychOSGetModeLine(screenNumber, 0, NULL);
+        if (mode)
+            snprintf(keystr, sizeof(keystr), "%lu:%lu:%lu:%lu:%lu:%lu", (unsigned long) mode->dotClock, (unsigned long) mode->width, (unsigned long) mode->height,
+                     (unsigned long) mode->hTotal, (unsigned long) mode->vTotal, (unsigned long) mode->modeFlags);
+        PsychUnlockDisplay();
+
+        // No modeline means no active output, which we can not identify, so no caching:
+        if (!mode) return(0);
+
+        hash = PsychRefreshCalibrationCacheHash(hash, keystr);
+        hash = PsychRefreshCalibrationCacheHash(hash, PsychOSGetOutputProps(screenNumber, 0, FALSE, NULL, NULL, NULL));
+    }
+    #endif
+
+    // Window and preference settings which affect calibration results or procedure:
+    snprintf(keystr, sizeof(keystr), "%i:%i:%i:%i:%i:%i:%i:%f:%i:%i:%i:%i", windowRecord->depth, windowRecord->stereomode, windowRecord->multiSample,
+             windowRecord->hybridGraphics, (int) windowRecord->vrrMode, PsychPrefStateGet_VBLTimestampingMode(), PsychPrefStateGet_VBLEndlineOverride(),
+             PsychPrefStateGet_VBLEndlineMaxFactor(), (windowRecord->specialflags & kPsychIsFullscreenWindow) ? 1 : 0,
+             (windowRecord->specialflags & kPsychOpenMLDefective) ? 1 : 0, (windowRecord->specialflags & kPsychNative10bpcFBActive) ? 1 : 0,
+             (PsychOSIsDWMEnabled(screenNumber)) ? 1 : 0);
+    hash = PsychRefreshCalibrationCacheHash(hash, keystr);
+
+    // Zero is reserved for "no caching":
+    if (hash == 0) hash = 1;
+
+    return(hash);
+}
+
+/* PsychRefreshCalibrationCacheLoad()
+ *
+ * Load cached calibration for 'cachekey' into 'calib'. Returns TRUE on success, FALSE if no valid entry exists.
+ */
+psych_bool PsychRefreshCalibrationCacheLoad(psych_uint64 cachekey, PsychRefreshCalibrationType *calib)
+{
+    char filename[FILENAME_MAX + 1];
+    PsychRefreshCalibrationFileType entry;
+    FILE *fd;
+
+    if (cachekey == 0) return(FALSE);
+
+    PsychRefreshCalibrationCacheFilename(filename, sizeof(filename), cachekey);
+    if (NULL == (fd = fopen(filename, "rb"))) return(FALSE);
+
+    if ((fread(&entry, sizeof(entry), 1, fd) != 1) || (entry.magic != PSYCH_CALIBCACHE_MAGIC) || (entry.version != PSYCH_CALIBCACHE_VERSION) ||
+        (entry.cachekey != cachekey) || (entry.checksum != PsychRefreshCalibrationCacheChecksum((const unsigned char*) &entry.calib, sizeof(entry.calib))) ||
+        (entry.calib.ifiEstimate <= 0) || (entry.calib.numSamples <= 0)) {
+        fclose(fd);
+        remove(filename);
+        return(FALSE);
+    }
+
+    fclose(fd);
+
+    *calib = entry.calib;
+
+    if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Loaded refresh calibration from cache file %s.\n", filename);
+
+    return(TRUE);
+}
+
+/* PsychRefreshCalibrationCacheStore()
+ *
+ * Store calibration 'calib' under 'cachekey' in the cache. Failures are non-fatal.
+ */
+void PsychRefreshCalibrationCacheStore(psych_uint64 cachekey, PsychRefreshCalibrationType *calib)
+{
+    char filename[FILENAME_MAX + 1];
+    char tmpname[FILENAME_MAX + 32];
+    PsychRefreshCalibrationFileType entry;
+    FILE *fd;
+    double now;
+    psych_bool ok;
+
+    if (cachekey == 0) return;
+
+    memset(&entry, 0, sizeof(entry));
+    entry.magic = PSYCH_CALIBCACHE_MAGIC;
+    entry.cachekey = cachekey;
+    entry.version = PSYCH_CALIBCACHE_VERSION;
+    entry.calib = *calib;
+    entry.checksum = PsychRefreshCalibrationCacheChecksum((const unsigned char*) &entry.calib, sizeof(entry.calib));
+
+    // Write to a temporary file, then rename it into place, so concurrent sessions never see partial files:
+    PsychRefreshCalibrationCacheFilename(filename, sizeof(filename), cachekey);
+    PsychGetAdjustedPrecisionTimerSeconds(&now);
+    snprintf(tmpname, sizeof(tmpname), "%s.%u.tmp", filename, (unsigned int) (fmod(now, 1000.0) * 1000000.0));
+
+    ok = FALSE;
+    if ((fd = fopen(tmpname, "wb"))) {
+        ok = (fwrite(&entry, sizeof(entry), 1, fd) == 1);
+        ok = (fclose(fd) == 0) && ok;
+    }
+
+    #if PSYCH_SYSTEM == PSYCH_WINDOWS
+        // rename() on Windows fails if the target exists:
+        if (ok) remove(filename);
+    #endif
+
+    if (!ok || (rename(tmpname, filename) != 0)) {
+        remove(tmpname);
+        if (PsychPrefStateGet_Verbosity() > 4) printf("PTB-DEBUG: Failed to store refresh calibration in cache file %s.\n", filename);
+        return;
+    }
+
+    if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Stored refresh calibration in cache file %s.\n", filename);
+}
+
+/* PsychRefreshCalibrationCacheInvalidate()
+ *
+ * Delete the cache entry for 'cachekey', e.g., after it failed verification.
+ */
+void PsychRefreshCalibrationCacheInvalidate(psych_uint64 cachekey)
+{
+    char filename[FILENAME_MAX + 1];
+
+    if (cachekey == 0) return;
+
+    PsychRefreshCalibrationCacheFilename(filename, sizeof(filename), cachekey);
+    remove(filename);
+}
+
+/* PsychRefreshCalibrationCacheVerify()
+ *
+ * Check if cached calibration 'calib' still matches the behaviour of the display of onscreen window
+ * 'windowRecord', by sampling beamposition over a few refresh cycles and measuring the refresh interval
+ * over a few VBL synced flips, with a required maximum standard deviation of 'maxStddev' secs.
+ * Returns TRUE if the cached calibration can be used, FALSE if a full calibration is needed.
+ */
+psych_bool PsychRefreshCalibrationCacheVerify(PsychWindowRecordType *windowRecord, PsychRefreshCalibrationType *calib, double maxStddev)
+{
+    CGDirectDisplayID cgDisplayID;
+    int i, bp, maxline, numSamples;
+    double maxsecs, stddev, ifi, tolerance;
+    psych_bool beamposSupported, did_pageflip;
+
+    PsychGetCGDisplayIDFromScreenNumber(&cgDisplayID, windowRecord->screenNumber);
+
+    // Same availability of beamposition queries as during calibration? Same logic as in PsychOpenOnscreenWindow():
+    bp = (int) PsychGetDisplayBeamPosition(cgDisplayID, windowRecord->screenNumber);
+    beamposSupported = (bp != -1) ? TRUE : FALSE;
+    if (beamposSupported && (bp == 0) && (PSYCH_SYSTEM == PSYCH_OSX)) {
+        PsychWaitIntervalSeconds(0.002);
+        if ((int) PsychGetDisplayBeamPosition(cgDisplayID, windowRecord->screenNumber) == 0) beamposSupported = FALSE;
+    }
+
+    if (beamposSupported != ((calib->flags & kPsychCalibBeamposSupported) ? TRUE : FALSE)) {
+        if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Cached refresh calibration mismatch: Availability of beamposition queries changed.\n");
+        return(FALSE);
+    }
+
+    // Working beamposition queries during calibration? Then verify they still work and stay within the cached VBL endline:
+    if (beamposSupported && (calib->vblEndline >= 0)) {
+        PsychRealtimePriority(true);
+
+        bp = (int) PsychGetDisplayBeamPosition(cgDisplayID, windowRecord->screenNumber);
+        PsychWaitIntervalSeconds(0.002);
+        if ((bp < -1) || ((int) PsychGetDisplayBeamPosition(cgDisplayID, windowRecord->screenNumber) == bp)) {
+            PsychRealtimePriority(false);
+            if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Cached refresh calibration mismatch: Beamposition queries no longer work.\n");
+            return(FALSE);
+        }
+
+        for (i = 0; i < PSYCH_CALIBCACHE_VERIFYCYCLES; i++) {
+            // Spin-wait until retrace and record highest measurement:
+            maxline = -1;
+            while ((bp = (int) PsychGetDisplayBeamPosition(cgDisplayID, windowRecord->screenNumber)) >= maxline) maxline = bp;
+
+            // Measured maximum must be in the range of the cached vblank, unless usercode overrides the endline:
+            if ((maxline < calib->vblStartline - 1) || ((PsychPrefStateGet_VBLEndlineOverride() < 0) && (maxline > calib->vblEndline + 1))) {
+                PsychRealtimePriority(false);
+                if (PsychPrefStateGet_Verbosity() > 3)
+                    printf("PTB-INFO: Cached refresh calibration mismatch: Measured vblank endline %i outside cached range %i - %i.\n", maxline, calib->vblStartline - 1, calib->vblEndline);
+                return(FALSE);
+            }
+        }
+
+        PsychRealtimePriority(false);
+    }
+
+    // Short refresh interval measurement via VBL synced flips, with the cached interval as hint:
+    numSamples = PSYCH_CALIBCACHE_VERIFYSAMPLES;
+    stddev = maxStddev;
+    maxsecs = 1;
+    ifi = PsychGetMonitorRefreshInterval(windowRecord, &numSamples, &maxsecs, &stddev, calib->ifiEstimate, &did_pageflip);
+
+    // Allow for three times the standard error of the short measurement, but at least 0.05%:
+    tolerance = (numSamples > 0) ? 3 * stddev / sqrt((double) numSamples) : 0;
+    if (tolerance < 0.0005 * calib->ifiEstimate) tolerance = 0.0005 * calib->ifiEstimate;
+
+    // Same noise limits as for the full calibration:
+    if ((ifi <= 0) || (numSamples < PSYCH_CALIBCACHE_VERIFYSAMPLES) || (!did_pageflip && (stddev > maxStddev)) || (did_pageflip && (stddev > 3 * maxStddev)) ||
+        (fabs(ifi - calib->ifiEstimate) > tolerance)) {
+        if (PsychPrefStateGet_Verbosity() > 3)
+            printf("PTB-INFO: Cached refresh calibration mismatch: Measured %f msecs [%i samples, stddev %f msecs] vs. cached %f msecs.\n",
+                   ifi * 1000, numSamples, stddev * 1000, calib->ifiEstimate * 1000);
+        return(FALSE);
+    }
+
+    // Pageflipping used during calibration, but not anymore? Then something, e.g., a desktop compositor, interferes now:
+    if ((calib->flags & kPsychCalibDidPageflip) && !did_pageflip) {
+        if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Cached refresh calibration mismatch: Pageflipping no longer used.\n");
+        return(FALSE);
+    }
+
+    return(TRUE);
+}
@@ -0,0 +1,53 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychRefreshCalibrationCache.h
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           ag      agent@local
+
+    HISTORY:
+
+        19.10.2026  ag      Wrote it.
+
+    DESCRIPTION:
+
+        Persistent on-disk cache of per-display refresh calibration results, to skip the
+        lengthy beamposition and VBL sync calibration of Screen('OpenWindow') on known setups.
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychRefreshCalibrationCache
+#define PSYCH_IS_INCLUDED_PsychRefreshCalibrationCache
+
+#include "Screen.h"
+
+// Flags for the verdicts of a refresh calibration:
+#define kPsychCalibBeamposSupported     1   // Beamposition queries were available for the calibration.
+#define kPsychCalibBeamposCorrection    4   // Beamposition correction for the gpu was auto-detected.
+#define kPsychCalibBeamposWorkaround    8   // kPsychUseBeampositionQueryWorkaround was enabled by the calibration.
+#define kPsychCalibBusyWaitBeforeSwap   16  // kPsychBusyWaitForVBLBeforeBufferSwapRequest was needed for a successful calibration.
+#define kPsychCalibDidPageflip          32  // Pageflipping was used during the calibration.
+
+// Results of a refresh calibration:
+typedef struct PsychRefreshCalibrationType {
+    double  ifiEstimate;        // Refresh interval measured via VBL sync, before any correction for flip-frame stereo et al.
+    double  ifiBeamEstimate;    // Refresh interval measured via beamposition queries, 0 if unavailable.
+    double  stddev;             // Standard deviation of ifiEstimate samples.
+    int     numSamples;         // Number of valid samples for ifiEstimate.
+    int     vblStartline;       // VBL startline, possibly corrected for double-scan modes.
+    int     vblEndline;         // VBL endline, -1 if unknown.
+    int     flags;              // Verdicts, a combination of the kPsychCalib... flags.
+} PsychRefreshCalibrationType;
+
+psych_uint64 PsychRefreshCalibrationCacheKey(PsychWindowRecordType *windowRecord, double ifi_nominal);
+psych_bool PsychRefreshCalibrationCacheLoad(psych_uint64 cachekey, PsychRefreshCalibrationType *calib);
+void PsychRefreshCalibrationCacheStore(psych_uint64 cachekey, PsychRefreshCalibrationType *calib);
+void PsychRefreshCalibrationCacheInvalidate(psych_uint64 cachekey);
+psych_bool PsychRefreshCalibrationCacheVerify(PsychWindowRecordType *windowRecord, PsychRefreshCalibrationType *calib, double maxStddev);
+
+//end include once
+#endif
@@ -0,0 +1,302 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychShaderCacheSupport.c
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           ag      agent@local
+
+    HISTORY:
+
+        19.10.2026  ag      Wrote it.
+
+    DESCRIPTION:
+
+        Persistent on-disk cache of linked GLSL program binaries.
+
+        PsychCreateGLSLProgram() compiles and links all builtin shaders of the imaging pipeline,
+        texture filtering, planar textures, movie playback etc. from source whenever they are
+        needed, mostly at Screen('OpenWindow') time. With complex imaging pipeline setups this
+        can take multiple seconds, mostly spent in the drivers shader compiler.
+
+        If the OpenGL implementation supports GL_ARB_get_program_binary, we store the binary
+        of each successfully linked program in a cache directory, and on later requests for
+        the same shader sources we load that binary via glProgramBinary() instead of compiling.
+        The cache key is a 64 bit hash over the shader sources and the GL vendor, renderer and
+        version strings, so driver or gpu changes automatically cause cache misses. Drivers may
+        still reject a stored binary, e.g., after a driver update without version string change.
+        Such stale binaries are detected by a failed link status, deleted from the cache, and
+        we fall back to compiling from source, which then stores a fresh binary.
+
+        Programs loaded from a binary have no shaders attached, but code like the fusion of
+        hook chain shader slots retrieves program sources via glGetAttachedShaders(). Therefore
+        we attach shader objects with the original sources to programs loaded from the cache.
+        These are never compiled, so this is cheap, and they get deleted with their program.
+
+        The cache directory is:
+
+        - $PSYCH_SHADER_CACHE_DIR if that environment variable is set and non-empty.
+        - Otherwise on Linux $XDG_CACHE_HOME/Psychtoolbox/ShaderCache/ or ~/.cache/Psychtoolbox/ShaderCache/
+        - on macOS ~/Library/Caches/Psychtoolbox/ShaderCache/
+        - on MS-Windows %LOCALAPPDATA%\Psychtoolbox\ShaderCache\
+
+        Setting the environment variable PSYCH_DISABLE_SHADER_CACHE disables the cache.
+*/
+
+#include "Screen.h"
+
+// Magic tag and version of the cache file format. Bump the version on any incompatible change:
+#define PSYCH_SHADERCACHE_MAGIC     0x4c534c47425450ULL     // "PTBGLSL" in little-endian ascii.
+#define PSYCH_SHADERCACHE_VERSION   1
+
+// Header of each cache file, followed by 'length' bytes of program binary:
+typedef struct {
+    psych_uint64    magic;
+    psych_uint64    cachekey;
+    unsigned int    version;
+    unsigned int    binaryFormat;
+    unsigned int    length;
+    unsigned int    checksum;
+} PsychShaderCacheHeaderType;
+
+static psych_uint64 PsychShaderCacheHash(psych_uint64 hash, const char* str)
+{
+    // 64 bit FNV-1a hash, with a terminating zero byte included, so "ab" + "c" != "a" + "bc":
+    if (str) {
+        while (*str) {
+            hash ^= (psych_uint64) (unsigned char) *(str++);
+            hash *= 0x100000001b3ULL;
+        }
+    }
+
+    hash *= 0x100000001b3ULL;
+
+    return(hash);
+}
+
+static unsigned int PsychShaderCacheChecksum(const unsigned char* data, unsigned int length)
+{
+    unsigned int i, a = 1, b = 0;
+
+    // Adler-32 checksum to detect truncated or corrupted cache files:
+    for (i = 0; i < length; i++) {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+
+    return((b << 16) | a);
+}
+
+static const char* PsychShaderCacheGetDir(void)
+{
+    static psych_bool   firstTime = TRUE;
+    static char         cachedir[FILENAME_MAX + 1];
+
+    if (firstTime) {
+        firstTime = FALSE;
+        cachedir[0] = 0;
+
+        // Cache disabled by usercode?
+        if (getenv("PSYCH_DISABLE_SHADER_CACHE")) return(cachedir);
+
+        PsychSetupCacheDir(cachedir, sizeof(cachedir), "PSYCH_SHADER_CACHE_DIR", "ShaderCache");
+    }
+
+    return(cachedir);
+}
+
+static psych_bool PsychShaderCacheUsable(void)
+{
+    GLint numFormats = 0;
+
+    // Need program binary support and at least one binary format supported by the driver:
+    if (!glewIsSupported("GL_ARB_get_program_binary") || !glGetProgramBinary || !glProgramBinary) return(FALSE);
+
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    if (numFormats < 1) return(FALSE);
+
+    return((strlen(PsychShaderCacheGetDir()) > 0) ? TRUE : FALSE);
+}
+
+/* Attach a never compiled shader object of type 'shaderType' with source 'src' to the linked program 'glsl',
+ * so the source can be retrieved via glGetAttachedShaders() and glGetShaderSource(). The already linked
+ * executable of the program is not affected by attaching shaders.
+ */
+static void PsychShaderCacheAttachSource(GLuint glsl, GLenum shaderType, const char* src)
+{
+    GLuint shader;
+
+    if (src == NULL) return;
+
+    shader = glCreateShader(shaderType);
+    glShaderSource(shader, 1, (const GLchar**) &src, NULL);
+    glAttachShader(glsl, shader);
+
+    // Only flag for deletion, so it gets deleted together with the program:
+    glDeleteShader(shader);
+}
+
+static void PsychShaderCacheFilename(char* filename, size_t maxlen, psych_uint64 cachekey)
+{
+    snprintf(filename, maxlen, "%s%016llx.glslbin", PsychShaderCacheGetDir(), (unsigned long long) cachekey);
+}
+
+/* PsychShaderCacheLoadProgram()
+ *
+ * Compute the cache key for the given shader sources in the current OpenGL context and return it in
+ * *cachekey, or 0 if caching is not possible. If a valid cached program binary exists, load it into a
+ * new program object and return its handle, otherwise return 0 for compile and link from source.
+ */
+GLuint PsychShaderCacheLoadProgram(const char* fragmentsrc, const char* vertexsrc, psych_uint64* cachekey)
+{
+    char filename[FILENAME_MAX + 1];
+    PsychShaderCacheHeaderType header;
+    unsigned char *binary;
+    FILE *fd;
+    GLuint glsl;
+    GLint status;
+    psych_uint64 hash;
+
+    *cachekey = 0;
+
+    if (!PsychShaderCacheUsable()) return(0);
+
+    // Key is the hash over format version, GL implementation and shader sources:
+    hash = 0xcbf29ce484222325ULL + PSYCH_SHADERCACHE_VERSION;
+    hash = PsychShaderCacheHash(hash, (const char*) glGetString(GL_VENDOR));
+    hash = PsychShaderCacheHash(hash, (const char*) glGetString(GL_RENDERER));
+    hash = PsychShaderCacheHash(hash, (const char*) glGetString(GL_VERSION));
+    hash = PsychShaderCacheHash(hash, fragmentsrc);
+    hash = PsychShaderCacheHash(hash, vertexsrc);
+
+    // Zero is reserved for "no caching":
+    if (hash == 0) hash = 1;
+    *cachekey = hash;
+
+    PsychShaderCacheFilename(filename, sizeof(filename), hash);
+    if (NULL == (fd = fopen(filename, "rb"))) return(0);
+
+    if ((fread(&header, sizeof(header), 1, fd) != 1) || (header.magic != PSYCH_SHADERCACHE_MAGIC) || (header.version != PSYCH_SHADERCACHE_VERSION) ||
+        (header.cachekey != hash) || (header.length == 0) || (NULL == (binary = (unsigned char*) malloc(header.length)))) {
+        fclose(fd);
+        remove(filename);
+        return(0);
+    }
+
+    if ((fread(binary, header.length, 1, fd) != 1) || (PsychShaderCacheChecksum(binary, header.length) != header.checksum)) {
+        fclose(fd);
+        free(binary);
+        remove(filename);
+        return(0);
+    }
+
+    fclose(fd);
+
+    // Try to load it. Drivers may reject binaries from other driver versions:
+    while (glGetError());
+    glsl = glCreateProgram();
+    glProgramBinary(glsl, (GLenum) header.binaryFormat, binary, (GLsizei) header.length);
+    free(binary);
+
+    status = GL_FALSE;
+    glGetProgramiv(glsl, GL_LINK_STATUS, &status);
+    if ((status != GL_TRUE) || (glGetError() != GL_NO_ERROR)) {
+        // Stale binary: Delete it, so it gets replaced by a freshly compiled one.
+        if (PsychPrefStateGet_Verbosity() > 4) printf("PTB-DEBUG: Driver rejected cached GLSL program binary %s. Recompiling from source.\n", filename);
+        glDeleteProgram(glsl);
+        while (glGetError());
+        remove(filename);
+        return(0);
+    }
+
+    // Make the sources retrievable like for programs compiled from source:
+    PsychShaderCacheAttachSource(glsl, GL_FRAGMENT_SHADER, fragmentsrc);
+    PsychShaderCacheAttachSource(glsl, GL_VERTEX_SHADER, vertexsrc);
+    while (glGetError());
+
+    if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Loaded GLSL program %i from shader cache file %s.\n", glsl, filename);
+
+    return(glsl);
+}
+
+/* PsychShaderCachePrepareProgram()
+ *
+ * Called before linking a program which should get stored in the cache, to tell the driver we want to
+ * retrieve its binary later.
+ */
+void PsychShaderCachePrepareProgram(GLuint glsl, psych_uint64 cachekey)
+{
+    if ((cachekey == 0) || !glProgramParameteri) return;
+
+    glProgramParameteri(glsl, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+/* PsychShaderCacheStoreProgram()
+ *
+ * Store binary of successfully linked program 'glsl' under 'cachekey' in the cache. Failures are non-fatal.
+ */
+void PsychShaderCacheStoreProgram(GLuint glsl, psych_uint64 cachekey)
+{
+    char filename[FILENAME_MAX + 1];
+    char tmpname[FILENAME_MAX + 32];
+    PsychShaderCacheHeaderType header;
+    unsigned char *binary;
+    GLint length = 0;
+    GLenum binaryFormat = 0;
+    GLsizei written = 0;
+    FILE *fd;
+    double now;
+    psych_bool ok;
+
+    if (cachekey == 0) return;
+
+    glGetProgramiv(glsl, GL_PROGRAM_BINARY_LENGTH, &length);
+    if ((length <= 0) || (NULL == (binary = (unsigned char*) malloc((size_t) length)))) {
+        while (glGetError());
+        return;
+    }
+
+    glGetProgramBinary(glsl, (GLsizei) length, &written, &binaryFormat, binary);
+    if ((glGetError() != GL_NO_ERROR) || (written <= 0)) {
+        while (glGetError());
+        free(binary);
+        return;
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.magic = PSYCH_SHADERCACHE_MAGIC;
+    header.cachekey = cachekey;
+    header.version = PSYCH_SHADERCACHE_VERSION;
+    header.binaryFormat = (unsigned int) binaryFormat;
+    header.length = (unsigned int) written;
+    header.checksum = PsychShaderCacheChecksum(binary, header.length);
+
+    // Write to a temporary file, then rename it into place, so concurrent sessions never see partial files:
+    PsychShaderCacheFilename(filename, sizeof(filename), cachekey);
+    PsychGetAdjustedPrecisionTimerSeconds(&now);
+    snprintf(tmpname, sizeof(tmpname), "%s.%u.tmp", filename, (unsigned int) (fmod(now, 1000.0) * 1000000.0));
+
+    ok = FALSE;
+    if ((fd = fopen(tmpname, "wb"))) {
+        ok = (fwrite(&header, sizeof(header), 1, fd) == 1) && (fwrite(binary, header.length, 1, fd) == 1);
+        ok = (fclose(fd) == 0) && ok;
+    }
+
+    free(binary);
+
+    #if PSYCH_SYSTEM == PSYCH_WINDOWS
+        // rename() on Windows fails if the target exists:
+        if (ok) remove(filename);
+    #endif
+
+    if (!ok || (rename(tmpname, filename) != 0)) {
+        remove(tmpname);
+        if (PsychPrefStateGet_Verbosity() > 4) printf("PTB-DEBUG: Failed to store GLSL program binary in shader cache file %s.\n", filename);
+        return;
+    }
+
+    if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Stored GLSL program %i in shader cache file %s.\n", glsl, filename);
+}
@@ -0,0 +1,33 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychShaderCacheSupport.h
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           ag      agent@local
+
+    HISTORY:
+
+        19.10.2026  ag      Wrote it.
+
+    DESCRIPTION:
+
+        Persistent on-disk cache of linked GLSL program binaries, to avoid recompiling
+        the builtin shaders of the imaging pipeline at each Screen('OpenWindow').
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychShaderCacheSupport
+#define PSYCH_IS_INCLUDED_PsychShaderCacheSupport
+
+#include "Screen.h"
+
+GLuint PsychShaderCacheLoadProgram(const char* fragmentsrc, const char* vertexsrc, psych_uint64* cachekey);
+void PsychShaderCacheStoreProgram(GLuint glsl, psych_uint64 cachekey);
+void PsychShaderCachePrepareProgram(GLuint glsl, psych_uint64 cachekey);
+
+//end include once
+#endif
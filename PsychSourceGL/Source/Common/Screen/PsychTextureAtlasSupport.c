@@ -0,0 +1,644 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychTextureAtlasSupport.c
+
+    AUTHORS:
+
+    agent               ag      agent@local
+
+    PLATFORMS:
+
+    All. Texture atlases are only supported on classic desktop OpenGL, not on OpenGL-ES.
+
+    HISTORY:
+
+    19.10.2026  ag      Wrote it.
+    19.10.2026  ag      Limit mip-mapped drawing of packed textures to the levels covered by the padding.
+
+    DESCRIPTION:
+
+    Psychtoolbox functions for packing many small textures into shared texture atlases.
+
+    A texture atlas is a large OpenGL texture which stores the texels of many small textures,
+    e.g., letters, icons, or small image stimuli. Each packed texture keeps its own texture
+    handle and windowRecord, so all Screen functions continue to work with it, but its
+    textureNumber refers to the OpenGL texture of the atlas, and its textureAtlasOffset defines
+    where its texels are stored inside the atlas. The texture blitters add this offset to the
+    texture coordinates, and Screen('DrawTextures') can draw all textures of one atlas in one
+    batch, as they all share one OpenGL texture binding.
+
+    Packing uses a simple shelf packer: Textures are sorted by decreasing height and then placed
+    from left to right onto horizontal shelves, choosing the shelf with the least wasted height.
+    Closing a packed texture only releases it from the atlas, its area inside the atlas stays
+    unused until the next repack. If new textures do not fit into the free space of an atlas
+    anymore, the whole atlas gets repacked into new storage, reclaiming unused space and growing
+    the atlas as needed.
+
+    Textures get evicted from their atlas into their own standalone OpenGL texture as soon as
+    they are used for anything else than drawing, e.g., as a drawing target, as input to
+    Screen('TransformTexture'), or when queried via Screen('GetOpenGLTexture'), or when their
+    atlas gets closed.
+*/
+
+#include "Screen.h"
+
+// Maximum number of simultaneously open texture atlases:
+#define PSYCH_MAX_TEXTURE_ATLASES 100
+
+// One horizontal shelf inside an atlas:
+typedef struct {
+    int y;          // First texel row of the shelf.
+    int height;     // Height of the shelf in texels.
+    int xfree;      // First unused texel column of the shelf.
+} PsychAtlasShelfType;
+
+typedef struct {
+    PsychWindowIndexType    atlasIndex;     // Window handle of the atlas texture, or 0 if this record is unused.
+    int                     width;          // Width of the atlas in texels.
+    int                     height;         // Height of the atlas in texels.
+    int                     padding;        // Number of unused border texels around each packed texture.
+    int                     mipAlign;       // Packed textures start at multiples of this power of two, at most 'padding'.
+    int                     maxMipLevel;    // Highest mip-map level without bleeding between packed textures, log2(mipAlign).
+    int                     maxSize;        // Maximum width or height in texels the atlas may grow to.
+    int                     nextShelfY;     // First texel row not yet covered by any shelf.
+    int                     shelfCount;
+    int                     shelfCapacity;
+    PsychAtlasShelfType     *shelves;
+    int                     memberCount;
+    int                     memberCapacity;
+    PsychWindowIndexType    *members;       // Window handles of all textures currently packed into this atlas.
+} PsychAtlasRecordType;
+
+// One texture to pack during a packing operation:
+typedef struct {
+    PsychWindowRecordType   *tex;
+    int                     width;
+    int                     height;
+    int                     x;
+    int                     y;
+} PsychAtlasItemType;
+
+static PsychAtlasRecordType atlasRecordBANK[PSYCH_MAX_TEXTURE_ATLASES];
+
+static PsychAtlasRecordType* PsychGetAtlasRecord(PsychWindowRecordType *atlas)
+{
+    int i;
+
+    if (NULL == atlas) return(NULL);
+
+    for (i = 0; i < PSYCH_MAX_TEXTURE_ATLASES; i++) {
+        if (atlasRecordBANK[i].atlasIndex == atlas->windowIndex) return(&atlasRecordBANK[i]);
+    }
+
+    return(NULL);
+}
+
+psych_bool PsychIsTextureAtlas(PsychWindowRecordType *win)
+{
+    return((PsychIsTexture(win) && PsychGetAtlasRecord(win)) ? TRUE : FALSE);
+}
+
+PsychWindowRecordType* PsychGetTextureAtlas(PsychWindowRecordType *textureRecord)
+{
+    PsychWindowRecordType *atlas = NULL;
+
+    if (textureRecord->textureAtlasIndex == 0) return(NULL);
+
+    if (FindWindowRecord(textureRecord->textureAtlasIndex, &atlas) != PsychError_none) return(NULL);
+
+    return(atlas);
+}
+
+/* Return the highest mip-map level which may be sampled when drawing a texture. For textures packed into
+ * an atlas, this is limited by the atlas padding, as coarser levels would blend in neighbouring textures.
+ * Unlimited for all other textures:
+ */
+int PsychGetTextureMaxMipLevel(PsychWindowRecordType *textureRecord)
+{
+    PsychAtlasRecordType *rec;
+
+    if ((textureRecord->textureAtlasIndex == 0) || ((rec = PsychGetAtlasRecord(PsychGetTextureAtlas(textureRecord))) == NULL)) return(1000);
+
+    return(rec->maxMipLevel);
+}
+
+/* Return size of a texture in texels of its OpenGL texture, ie., taking transposed storage into account: */
+void PsychGetTextureTexelSize(PsychWindowRecordType *textureRecord, int *width, int *height)
+{
+    if (textureRecord->textureOrientation == 0 || textureRecord->textureOrientation == 1) {
+        // Transposed texture from Matlab/Octave:
+        *width  = (int) PsychGetHeightFromRect(textureRecord->rect);
+        *height = (int) PsychGetWidthFromRect(textureRecord->rect);
+    }
+    else {
+        *width  = (int) PsychGetWidthFromRect(textureRecord->rect);
+        *height = (int) PsychGetHeightFromRect(textureRecord->rect);
+    }
+}
+
+static void PsychAtlasSetSize(PsychWindowRecordType *atlas, int width, int height)
+{
+    // The atlas texture uses the same orientation as its members, so its rect is transposed
+    // for transposed textures:
+    if (atlas->textureOrientation == 0 || atlas->textureOrientation == 1) {
+        PsychMakeRect(atlas->rect, 0, 0, height, width);
+    }
+    else {
+        PsychMakeRect(atlas->rect, 0, 0, width, height);
+    }
+
+    PsychCopyRect(atlas->clientrect, atlas->rect);
+}
+
+static void PsychAtlasResetShelves(PsychAtlasRecordType *rec, int width, int height)
+{
+    rec->width = width;
+    rec->height = height;
+    rec->nextShelfY = 0;
+    rec->shelfCount = 0;
+}
+
+/* Find a place for a width x height texture inside the atlas. Returns FALSE if it doesn't fit: */
+static psych_bool PsychAtlasAllocate(PsychAtlasRecordType *rec, int width, int height, int *x, int *y)
+{
+    int i, best = -1;
+    int a = rec->mipAlign;
+    // Texture starts and padded sizes are multiples of mipAlign, so texels of mip-map levels up to
+    // maxMipLevel never mix texels of neighbouring textures, as at least 'padding' texels separate them:
+    int lead = (rec->padding + a - 1) / a * a;
+    int w = (lead + width + rec->padding + a - 1) / a * a;
+    int h = (lead + height + rec->padding + a - 1) / a * a;
+
+    // Find shelf with the least wasted height which still has room for the texture:
+    for (i = 0; i < rec->shelfCount; i++) {
+        if ((rec->shelves[i].height >= h) && (rec->shelves[i].xfree + w <= rec->width) &&
+            ((best < 0) || (rec->shelves[i].height < rec->shelves[best].height))) best = i;
+    }
+
+    // None found? Open a new shelf below the last one, if there is room left:
+    if (best < 0) {
+        if ((w > rec->width) || (rec->nextShelfY + h > rec->height)) return(FALSE);
+
+        if (rec->shelfCount == rec->shelfCapacity) {
+            rec->shelfCapacity = (rec->shelfCapacity > 0) ? rec->shelfCapacity * 2 : 16;
+            rec->shelves = (PsychAtlasShelfType*) realloc(rec->shelves, rec->shelfCapacity * sizeof(PsychAtlasShelfType));
+            if (NULL == rec->shelves) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while packing texture atlas!");
+        }
+
+        best = rec->shelfCount++;
+        rec->shelves[best].y = rec->nextShelfY;
+        rec->shelves[best].height = h;
+        rec->shelves[best].xfree = 0;
+        rec->nextShelfY += h;
+    }
+
+    *x = rec->shelves[best].xfree + lead;
+    *y = rec->shelves[best].y + lead;
+    rec->shelves[best].xfree += w;
+
+    return(TRUE);
+}
+
+static void PsychAtlasAddMember(PsychAtlasRecordType *rec, PsychWindowRecordType *tex)
+{
+    if (rec->memberCount == rec->memberCapacity) {
+        rec->memberCapacity = (rec->memberCapacity > 0) ? rec->memberCapacity * 2 : 64;
+        rec->members = (PsychWindowIndexType*) realloc(rec->members, rec->memberCapacity * sizeof(PsychWindowIndexType));
+        if (NULL == rec->members) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while packing texture atlas!");
+    }
+
+    rec->members[rec->memberCount++] = tex->windowIndex;
+}
+
+static void PsychAtlasRemoveMember(PsychAtlasRecordType *rec, PsychWindowRecordType *tex)
+{
+    int i;
+
+    for (i = 0; i < rec->memberCount; i++) {
+        if (rec->members[i] == tex->windowIndex) {
+            rec->members[i] = rec->members[--rec->memberCount];
+            return;
+        }
+    }
+}
+
+static int PsychAtlasCompareItems(const void *a, const void *b)
+{
+    const PsychAtlasItemType *ia = (const PsychAtlasItemType*) a;
+    const PsychAtlasItemType *ib = (const PsychAtlasItemType*) b;
+
+    // Sort by decreasing height, then by decreasing width:
+    if (ia->height != ib->height) return(ib->height - ia->height);
+    return(ib->width - ia->width);
+}
+
+static GLint PsychAtlasGetInternalFormat(PsychWindowRecordType *tex)
+{
+    GLint internalFormat = 0;
+    GLenum target = PsychGetTextureTarget(tex);
+
+    glBindTexture(target, tex->textureNumber);
+    glGetTexLevelParameteriv(target, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+    glBindTexture(target, 0);
+
+    return(internalFormat);
+}
+
+static GLuint PsychAtlasCreateGLTexture(GLenum target, GLint internalFormat, int width, int height)
+{
+    GLuint texid = 0;
+    void *zeros = NULL;
+
+    glGenTextures(1, &texid);
+    glBindTexture(target, texid);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Clear the whole atlas to transparent black. Only the areas of packed textures get copied
+    // into, so the padding around them would otherwise stay undefined and bleed garbage into
+    // filtered or mip-mapped sampling at the edges of packed textures:
+    if (GLEW_ARB_clear_texture && glClearTexImage) {
+        glTexImage2D(target, 0, internalFormat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glClearTexImage(texid, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+    else {
+        // No clear texture support: Upload zeros instead.
+        zeros = calloc((size_t) width * (size_t) height, 4);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glTexImage2D(target, 0, internalFormat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, zeros);
+        free(zeros);
+    }
+
+    glBindTexture(target, 0);
+
+    return(texid);
+}
+
+/* Copy a width x height block of texels from srcTex at (srcX,srcY) to dstTex at (dstX,dstY), all on the GPU: */
+static psych_bool PsychAtlasCopyTexels(GLenum target, GLuint srcTex, int srcX, int srcY, GLuint dstTex, int dstX, int dstY, int width, int height)
+{
+    GLuint fbo = 0;
+    GLint oldReadFBO = 0;
+    GLenum status;
+
+    if ((width <= 0) || (height <= 0)) return(TRUE);
+
+    // Direct texture to texture copy supported? This is the fastest path and leaves all bindings alone:
+    if (GLEW_ARB_copy_image && glCopyImageSubData) {
+        glCopyImageSubData(srcTex, target, 0, srcX, srcY, 0, dstTex, target, 0, dstX, dstY, 0, width, height, 1);
+        return(TRUE);
+    }
+
+    // No. Attach source texture to a temporary read framebuffer and copy from there:
+    if (!glBindFramebufferEXT) return(FALSE);
+
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &oldReadFBO);
+    glGenFramebuffersEXT(1, &fbo);
+    glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, fbo);
+    glFramebufferTexture2DEXT(GL_READ_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, target, srcTex, 0);
+    status = glCheckFramebufferStatusEXT(GL_READ_FRAMEBUFFER_EXT);
+
+    if (status == GL_FRAMEBUFFER_COMPLETE_EXT) {
+        glReadBuffer(GL_COLOR_ATTACHMENT0_EXT);
+        glBindTexture(target, dstTex);
+        glCopyTexSubImage2D(target, 0, dstX, dstY, srcX, srcY, width, height);
+        glBindTexture(target, 0);
+    }
+
+    glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, (GLuint) oldReadFBO);
+    glDeleteFramebuffersEXT(1, &fbo);
+
+    return((status == GL_FRAMEBUFFER_COMPLETE_EXT) ? TRUE : FALSE);
+}
+
+/* Check if texture 'tex' can be packed into an atlas whose properties are defined by 'ref': */
+static void PsychAtlasCheckCompatible(PsychWindowRecordType *windowRecord, PsychWindowRecordType *ref, GLint refFormat, PsychWindowRecordType *tex)
+{
+    if (!PsychIsTexture(tex)) PsychErrorExitMsg(PsychError_user, "One of the provided 'textureHandles' is not a texture!");
+    if (PsychIsTextureAtlas(tex)) PsychErrorExitMsg(PsychError_user, "Texture atlases can not be packed into other texture atlases!");
+    if (PsychGetParentWindow(tex) != PsychGetParentWindow(windowRecord)) PsychErrorExitMsg(PsychError_user, "All textures packed into a texture atlas must belong to the onscreen window 'windowPtr'!");
+    if (tex->textureNumber == 0) PsychErrorExitMsg(PsychError_user, "Procedural textures without texture image can not be packed into a texture atlas!");
+    if ((tex->fboCount > 0) || (tex->drawBufferFBO[0] != -1)) PsychErrorExitMsg(PsychError_user, "Textures which were used as drawing targets can not be packed into a texture atlas!");
+    if (tex->specialflags & kPsychPlanarTexture) PsychErrorExitMsg(PsychError_user, "Planar textures can not be packed into a texture atlas!");
+    if (tex->texturecache_slot >= 0) PsychErrorExitMsg(PsychError_user, "Movie or video capture textures can not be packed into a texture atlas!");
+
+    if ((PsychGetTextureTarget(tex) != PsychGetTextureTarget(ref)) || (tex->textureOrientation != ref->textureOrientation) ||
+        (tex->textureFilterShader != ref->textureFilterShader) || (tex->textureLookupShader != ref->textureLookupShader) ||
+        (PsychAtlasGetInternalFormat(tex) != refFormat)) {
+        PsychErrorExitMsg(PsychError_user, "All textures packed into one texture atlas must have the same texture type, orientation, pixel format and shaders!");
+    }
+}
+
+/* Move texture from its current storage into 'dstTex' at (x,y) and make it a member of atlas 'rec' with handle 'atlas': */
+static void PsychAtlasAssignMember(PsychAtlasRecordType *rec, PsychWindowRecordType *atlas, PsychAtlasItemType *item, GLuint dstTex)
+{
+    PsychWindowRecordType *tex = item->tex;
+    PsychAtlasRecordType *oldRec;
+
+    if (tex->textureAtlasIndex == 0) {
+        // Standalone texture: Its own OpenGL texture is no longer needed:
+        glDeleteTextures(1, &tex->textureNumber);
+    }
+    else if (tex->textureAtlasIndex != atlas->windowIndex) {
+        // Moved over from another atlas:
+        if ((oldRec = PsychGetAtlasRecord(PsychGetTextureAtlas(tex))) != NULL) PsychAtlasRemoveMember(oldRec, tex);
+    }
+
+    tex->textureNumber = dstTex;
+    tex->textureAtlasIndex = atlas->windowIndex;
+    tex->textureAtlasOffset[0] = item->x;
+    tex->textureAtlasOffset[1] = item->y;
+
+    // Mark texture as "dirty" to trigger regeneration of mip-maps if mip-mapped drawing is used:
+    tex->needsViewportSetup = TRUE;
+}
+
+/* PsychPackTexturesIntoAtlas()
+ *
+ * Pack the 'count' textures in 'textures' into the texture atlas 'atlasRecord', or into a new atlas if 'atlasRecord' is NULL.
+ * 'padding' defines the number of empty texels around each texture, 'maxSize' the maximum width or height of the atlas.
+ * Both are only used for new atlases. Returns the windowRecord of the atlas. A call with 'count' == 0 on an existing
+ * atlas repacks it compactly, releasing the space of textures which were closed or evicted in the meantime.
+ */
+PsychWindowRecordType* PsychPackTexturesIntoAtlas(PsychWindowRecordType *windowRecord, PsychWindowRecordType *atlasRecord, int count,
+                                                  PsychWindowRecordType **textures, int padding, int maxSize)
+{
+    PsychAtlasRecordType *rec = NULL;
+    PsychAtlasItemType *items;
+    PsychWindowRecordType *ref, *tex, *member;
+    GLenum target;
+    GLint internalFormat;
+    GLuint newtex;
+    int i, j, itemCount, newCount, width, height, srcX, srcY;
+    double area;
+    psych_bool fits;
+
+    if (PsychIsGLES(windowRecord) || !PsychIsGLClassic(windowRecord))
+        PsychErrorExitMsg(PsychError_user, "Sorry, texture atlases are only supported on classic desktop OpenGL.");
+
+    if (atlasRecord) {
+        rec = PsychGetAtlasRecord(atlasRecord);
+        if (NULL == rec) PsychErrorExitMsg(PsychError_user, "The provided 'atlasPtr' is not a texture atlas!");
+        ref = atlasRecord;
+    }
+    else {
+        if (count < 1) PsychErrorExitMsg(PsychError_user, "At least one texture needed to create a new texture atlas!");
+        if (padding < 0) PsychErrorExitMsg(PsychError_user, "Invalid negative 'padding' provided!");
+        if (maxSize <= 0 || maxSize > windowRecord->maxTextureSize) maxSize = windowRecord->maxTextureSize;
+        ref = textures[0];
+    }
+
+    // Safe-reset the drawing engine, as we use our own texture bindings and framebuffers:
+    PsychSetDrawingTarget((PsychWindowRecordType*) 0x1);
+    PsychSetGLContext(windowRecord);
+
+    target = PsychGetTextureTarget(ref);
+    internalFormat = PsychAtlasGetInternalFormat(ref);
+
+    // Build list of textures to pack, first the current members of the atlas, then the new ones:
+    items = (PsychAtlasItemType*) PsychMallocTemp((((rec) ? rec->memberCount : 0) + count) * sizeof(PsychAtlasItemType) + 1);
+    itemCount = 0;
+
+    if (rec) {
+        for (i = 0; i < rec->memberCount; i++) {
+            FindWindowRecord(rec->members[i], &member);
+            items[itemCount].tex = member;
+            PsychGetTextureTexelSize(member, &items[itemCount].width, &items[itemCount].height);
+            items[itemCount].x = (int) member->textureAtlasOffset[0];
+            items[itemCount].y = (int) member->textureAtlasOffset[1];
+            itemCount++;
+        }
+    }
+
+    newCount = 0;
+    for (i = 0; i < count; i++) {
+        tex = textures[i];
+        PsychAtlasCheckCompatible(windowRecord, ref, internalFormat, tex);
+
+        // Skip textures already packed into this atlas, or listed multiple times:
+        for (j = 0; j < itemCount; j++) if (items[j].tex == tex) break;
+        if (j < itemCount) continue;
+
+        items[itemCount].tex = tex;
+        PsychGetTextureTexelSize(tex, &items[itemCount].width, &items[itemCount].height);
+        itemCount++;
+        newCount++;
+    }
+
+    // Incremental update of an existing atlas? Try to place new textures into the free space of the atlas first:
+    if (rec && (newCount > 0)) {
+        fits = TRUE;
+        for (i = itemCount - newCount; fits && (i < itemCount); i++) {
+            fits = PsychAtlasAllocate(rec, items[i].width, items[i].height, &items[i].x, &items[i].y);
+        }
+
+        if (fits) {
+            for (i = itemCount - newCount; i < itemCount; i++) {
+                tex = items[i].tex;
+                srcX = (tex->textureAtlasIndex > 0) ? (int) tex->textureAtlasOffset[0] : 0;
+                srcY = (tex->textureAtlasIndex > 0) ? (int) tex->textureAtlasOffset[1] : 0;
+                if (!PsychAtlasCopyTexels(target, tex->textureNumber, srcX, srcY, atlasRecord->textureNumber, items[i].x, items[i].y, items[i].width, items[i].height))
+                    PsychErrorExitMsg(PsychError_system, "Failed to copy texture into texture atlas! Your graphics driver lacks required functionality.");
+
+                PsychAtlasAssignMember(rec, atlasRecord, &items[i], atlasRecord->textureNumber);
+                PsychAtlasAddMember(rec, tex);
+            }
+
+            // Atlas contents changed, so its mip-maps, if any, are stale:
+            for (i = 0; i < itemCount; i++) items[i].tex->needsViewportSetup = TRUE;
+
+            if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Added %i textures to texture atlas %i without repacking.\n", newCount, atlasRecord->windowIndex);
+
+            return(atlasRecord);
+        }
+    }
+
+    // Full (re)pack of all textures into new atlas storage: Find a suitable new atlas size.
+    if (NULL == rec) {
+        for (i = 0; i < PSYCH_MAX_TEXTURE_ATLASES; i++) if (atlasRecordBANK[i].atlasIndex == 0) break;
+        if (i >= PSYCH_MAX_TEXTURE_ATLASES) PsychErrorExitMsg(PsychError_user, "Maximum number of simultaneously open texture atlases exceeded! Close some atlases first.");
+        rec = &atlasRecordBANK[i];
+        rec->padding = padding;
+        rec->maxSize = maxSize;
+        rec->mipAlign = 1;
+        rec->maxMipLevel = 0;
+        while (rec->mipAlign * 2 <= padding) {
+            rec->mipAlign *= 2;
+            rec->maxMipLevel++;
+        }
+        rec->memberCount = 0;
+    }
+
+    // Start with the smallest power-of-two square which could hold all textures:
+    area = 0;
+    for (i = 0; i < itemCount; i++) area += (double) (items[i].width + 2 * rec->padding) * (double) (items[i].height + 2 * rec->padding);
+    width = 1;
+    while ((double) width * (double) width < area) width *= 2;
+    height = width;
+
+    qsort(items, itemCount, sizeof(PsychAtlasItemType), PsychAtlasCompareItems);
+
+    while (TRUE) {
+        if ((width > rec->maxSize) || (height > rec->maxSize))
+            PsychErrorExitMsg(PsychError_user, "The textures do not fit into a texture atlas of the maximum allowable size! Use less or smaller textures, or multiple atlases.");
+
+        PsychAtlasResetShelves(rec, width, height);
+        fits = TRUE;
+        for (i = 0; fits && (i < itemCount); i++) fits = PsychAtlasAllocate(rec, items[i].width, items[i].height, &items[i].x, &items[i].y);
+        if (fits) break;
+
+        // Didn't fit. Grow atlas, alternating between width and height:
+        if (width <= height) width *= 2; else height *= 2;
+    }
+
+    // Create new storage and copy all textures from their current location:
+    newtex = PsychAtlasCreateGLTexture(target, internalFormat, width, height);
+    for (i = 0; i < itemCount; i++) {
+        tex = items[i].tex;
+        srcX = (tex->textureAtlasIndex > 0) ? (int) tex->textureAtlasOffset[0] : 0;
+        srcY = (tex->textureAtlasIndex > 0) ? (int) tex->textureAtlasOffset[1] : 0;
+        if (!PsychAtlasCopyTexels(target, tex->textureNumber, srcX, srcY, newtex, items[i].x, items[i].y, items[i].width, items[i].height)) {
+            glDeleteTextures(1, &newtex);
+            PsychErrorExitMsg(PsychError_system, "Failed to copy texture into texture atlas! Your graphics driver lacks required functionality.");
+        }
+    }
+
+    if (atlasRecord) {
+        // Repack of existing atlas: Replace old storage.
+        glDeleteTextures(1, &atlasRecord->textureNumber);
+        atlasRecord->textureNumber = newtex;
+    }
+    else {
+        // New atlas: Create a texture windowRecord for it, so it can be managed and closed like any other texture:
+        PsychCreateWindowRecord(&atlasRecord);
+        atlasRecord->windowType = kPsychTexture;
+        atlasRecord->screenNumber = windowRecord->screenNumber;
+        atlasRecord->depth = ref->depth;
+        atlasRecord->nrchannels = ref->nrchannels;
+        PsychAssignParentWindow(atlasRecord, windowRecord);
+        atlasRecord->textureOrientation = ref->textureOrientation;
+        atlasRecord->texturetarget = target;
+        atlasRecord->textureFilterShader = ref->textureFilterShader;
+        atlasRecord->textureLookupShader = ref->textureLookupShader;
+        atlasRecord->textureNumber = newtex;
+        PsychSetWindowRecordValid(atlasRecord);
+        rec->atlasIndex = atlasRecord->windowIndex;
+    }
+
+    PsychAtlasSetSize(atlasRecord, width, height);
+
+    rec->memberCount = 0;
+    for (i = 0; i < itemCount; i++) {
+        PsychAtlasAssignMember(rec, atlasRecord, &items[i], newtex);
+        PsychAtlasAddMember(rec, items[i].tex);
+    }
+
+    if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Packed %i textures into %i x %i texels texture atlas %i.\n", itemCount, width, height, atlasRecord->windowIndex);
+
+    return(atlasRecord);
+}
+
+/* PsychEvictTextureFromAtlas()
+ *
+ * Move the texels of an atlas member texture into its own standalone OpenGL texture and remove it
+ * from its atlas. Called whenever a texture is used for something else than drawing it. No-Op for
+ * textures which are not packed into an atlas.
+ */
+void PsychEvictTextureFromAtlas(PsychWindowRecordType *textureRecord)
+{
+    PsychWindowRecordType *atlas;
+    PsychAtlasRecordType *rec;
+    GLenum target;
+    GLuint texid;
+    int width, height, twidth, theight;
+
+    if (textureRecord->textureAtlasIndex == 0) return;
+
+    atlas = PsychGetTextureAtlas(textureRecord);
+    rec = PsychGetAtlasRecord(atlas);
+
+    // Copy texels into a new standalone texture, if the OpenGL context is still available:
+    if (atlas && textureRecord->targetSpecific.contextObject) {
+        PsychSetGLContext(textureRecord);
+
+        target = PsychGetTextureTarget(textureRecord);
+        PsychGetTextureTexelSize(textureRecord, &width, &height);
+
+        // Standalone GL_TEXTURE_2D textures must be power-of-two sized on non-NPOT hardware:
+        twidth = width;
+        theight = height;
+        if ((target == GL_TEXTURE_2D) && !(textureRecord->gfxcaps & kPsychGfxCapNPOTTex)) {
+            twidth = 1;
+            while (twidth < width) twidth *= 2;
+            theight = 1;
+            while (theight < height) theight *= 2;
+        }
+
+        texid = PsychAtlasCreateGLTexture(target, PsychAtlasGetInternalFormat(textureRecord), twidth, theight);
+        if (!PsychAtlasCopyTexels(target, atlas->textureNumber, (int) textureRecord->textureAtlasOffset[0], (int) textureRecord->textureAtlasOffset[1], texid, 0, 0, width, height)) {
+            glDeleteTextures(1, &texid);
+            PsychErrorExitMsg(PsychError_system, "Failed to copy texture out of its texture atlas! Your graphics driver lacks required functionality.");
+        }
+
+        textureRecord->textureNumber = texid;
+        textureRecord->needsViewportSetup = TRUE;
+    }
+    else {
+        textureRecord->textureNumber = 0;
+    }
+
+    if (rec) PsychAtlasRemoveMember(rec, textureRecord);
+
+    textureRecord->textureAtlasIndex = 0;
+    textureRecord->textureAtlasOffset[0] = 0;
+    textureRecord->textureAtlasOffset[1] = 0;
+}
+
+/* PsychReleaseTextureFromAtlas()
+ *
+ * Detach an atlas member texture which is about to be closed from its atlas, without
+ * copying its texels. Its area inside the atlas gets reused after the next repack.
+ */
+void PsychReleaseTextureFromAtlas(PsychWindowRecordType *textureRecord)
+{
+    PsychAtlasRecordType *rec;
+
+    if (textureRecord->textureAtlasIndex == 0) return;
+
+    if ((rec = PsychGetAtlasRecord(PsychGetTextureAtlas(textureRecord))) != NULL) PsychAtlasRemoveMember(rec, textureRecord);
+
+    // The OpenGL texture belongs to the atlas, so don't let our caller delete it:
+    textureRecord->textureNumber = 0;
+    textureRecord->textureAtlasIndex = 0;
+    textureRecord->textureAtlasOffset[0] = 0;
+    textureRecord->textureAtlasOffset[1] = 0;
+}
+
+/* PsychDestroyTextureAtlas()
+ *
+ * Called when a texture atlas gets closed: Evicts all remaining member textures into their own
+ * standalone textures, so they stay usable, then releases the atlas bookkeeping.
+ */
+void PsychDestroyTextureAtlas(PsychWindowRecordType *atlasRecord)
+{
+    PsychAtlasRecordType *rec;
+    PsychWindowRecordType *member;
+
+    if ((rec = PsychGetAtlasRecord(atlasRecord)) == NULL) return;
+
+    while (rec->memberCount > 0) {
+        if ((FindWindowRecord(rec->members[rec->memberCount - 1], &member) == PsychError_none) &&
+            (member->textureAtlasIndex == atlasRecord->windowIndex)) {
+            PsychEvictTextureFromAtlas(member);
+        }
+        else {
+            rec->memberCount--;
+        }
+    }
+
+    free(rec->shelves);
+    free(rec->members);
+    memset(rec, 0, sizeof(PsychAtlasRecordType));
+}
@@ -0,0 +1,34 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychTextureAtlasSupport.h
+
+    AUTHORS:
+
+    agent               ag      agent@local
+
+    HISTORY:
+
+    19.10.2026  ag      Wrote it.
+
+    DESCRIPTION:
+
+    Psychtoolbox functions for packing many small textures into shared
+    texture atlases, so they can be drawn by one batched draw call.
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychTextureAtlasSupport
+#define PSYCH_IS_INCLUDED_PsychTextureAtlasSupport
+
+#include "Screen.h"
+
+PsychWindowRecordType* PsychPackTexturesIntoAtlas(PsychWindowRecordType *windowRecord, PsychWindowRecordType *atlasRecord, int count,
+                                                  PsychWindowRecordType **textures, int padding, int maxSize);
+psych_bool PsychIsTextureAtlas(PsychWindowRecordType *win);
+PsychWindowRecordType* PsychGetTextureAtlas(PsychWindowRecordType *textureRecord);
+void PsychGetTextureTexelSize(PsychWindowRecordType *textureRecord, int *width, int *height);
+int PsychGetTextureMaxMipLevel(PsychWindowRecordType *textureRecord);
+void PsychEvictTextureFromAtlas(PsychWindowRecordType *textureRecord);
+void PsychReleaseTextureFromAtlas(PsychWindowRecordType *textureRecord);
+void PsychDestroyTextureAtlas(PsychWindowRecordType *atlasRecord);
+//end include once
+#endif
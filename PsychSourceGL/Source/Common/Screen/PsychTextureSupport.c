@@ -105,9 +105,18 @@ void PsychInitWindowRecordTextureFields(PsychWindowRecordType *win)
     // the movieRecord of the movie which is associated with this texture...
     win->texturecache_slot=-1;
 
+    // Textures own their OpenGL texture by default, they are not packed into a texture atlas:
+    win->textureAtlasIndex=0;
+    win->textureAtlasOffset[0]=0;
+    win->textureAtlasOffset[1]=0;
+
     // Explicit storage of the type of texture target for this texture: Zero means - Autodetect.
     win->texturetarget=0;
 
+    // Textures are not imported from external storage by default:
+    win->textureImportHandle=NULL;
+    win->textureImportRelease=NULL;
+
     // We do not have a preset for texture representation by default:
     win->textureinternalformat=0;
     win->textureexternalformat=0;
@@ -144,6 +153,8 @@ void PsychCreateTexture(PsychWindowRecordType *win)
 
     verbosity = PsychPrefStateGet_Verbosity();
 
+    PsychTrace(kPsychTraceTextureCreateBegin, win->windowIndex);
+
     // Check if any calls that can cause a CPU<->GPU sync should be avoided at (nearly all) costs.
     // Avoiding CPU<->GPU sync is a robustness vs. performance tradeoff: Performance is potentially
     // significantly increased, but the amount of error checking and error handling is drastically
@@ -566,6 +577,8 @@ void PsychCreateTexture(PsychWindowRecordType *win)
     // Client rect of a texture is always == rect of it:
     PsychCopyRect(win->clientrect, win->rect);
 
+    PsychTrace(kPsychTraceTextureCreateEnd, win->windowIndex);
+
     // Finished!
     return;
 }
@@ -578,6 +591,12 @@ void PsychCreateTexture(PsychWindowRecordType *win)
  */
 void PsychFreeTextureForWindowRecord(PsychWindowRecordType *win)
 {
+    // Texture atlas? Evict all textures still packed into it, so they stay usable:
+    if (PsychIsTextureAtlas(win)) PsychDestroyTextureAtlas(win);
+
+    // Texture packed into an atlas? Detach it, its OpenGL texture belongs to the atlas:
+    if (win->textureAtlasIndex > 0) PsychReleaseTextureFromAtlas(win);
+
     // Destroy OpenGL texture object for windows that have one:
     if((win->windowType==kPsychSingleBufferOnscreen || win->windowType==kPsychDoubleBufferOnscreen || win->windowType==kPsychTexture) &&
         (win->targetSpecific.contextObject)) {
@@ -612,6 +631,11 @@ void PsychFreeTextureForWindowRecord(PsychWindowRecordType *win)
         if (PsychPrefStateGet_Verbosity() > 4) PsychTestForGLErrors();
     }
 
+    // Release external storage of imported textures, e.g., zero-copy video frames, now that the texture is gone:
+    if (win->textureImportHandle && win->textureImportRelease) win->textureImportRelease(win->textureImportHandle);
+    win->textureImportHandle=NULL;
+    win->textureImportRelease=NULL;
+
     // Free system RAM backing memory buffer, if any:
     if (win->textureMemory) free(win->textureMemory);
     win->textureMemory=NULL;
@@ -693,6 +717,14 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
         sourceYEnd=sourceHeight - sourceRect[kPsychTop];
     }
 
+    // Texture packed into a texture atlas? Its texels are located at textureAtlasOffset inside the atlas:
+    if (source->textureAtlasIndex > 0) {
+        sourceX+=source->textureAtlasOffset[0];
+        sourceXEnd+=source->textureAtlasOffset[0];
+        sourceY+=source->textureAtlasOffset[1];
+        sourceYEnd+=source->textureAtlasOffset[1];
+    }
+
     // Special case handling for GL_TEXTURE_2D textures. We need to map the
     // absolute texture coordinates (in pixels) to the interval 0.0 - 1.0 where
     // 1.0 == full extent of power of two texture...
@@ -712,6 +744,9 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
             tHeight = (int) sourceHeight;
         }
 
+        // Underlying texture of an atlas member is the (power of two sized) atlas:
+        if (source->textureAtlasIndex > 0) PsychGetTextureTexelSize(PsychGetTextureAtlas(source), &tWidth, &tHeight);
+
         // Remap texcoords into 0-1 subrange: We subtract 0.5 pixel-units before
         // mapping to accomodate for roundoff-error in the power-of-two gfx
         // hardware...
@@ -801,7 +836,7 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
         // decide how to implement a specific blur level on its own, unrestricted by us:
         if ((texturetarget == GL_TEXTURE_2D) && !PsychIsGLES(source)) {
             glTexParameteri(texturetarget, GL_TEXTURE_BASE_LEVEL, 0);
-            glTexParameteri(texturetarget, GL_TEXTURE_MAX_LEVEL,  1000);
+            glTexParameteri(texturetarget, GL_TEXTURE_MAX_LEVEL,  PsychGetTextureMaxMipLevel(source));
         }
     }
     else {
@@ -843,7 +878,7 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
             // Don't restrict mipmap-levels for sampling, reset to initial system defaults:
             if ((texturetarget == GL_TEXTURE_2D) && !PsychIsGLES(source)) {
                 glTexParameteri(texturetarget, GL_TEXTURE_BASE_LEVEL, 0);
-                glTexParameteri(texturetarget, GL_TEXTURE_MAX_LEVEL,  1000);
+                glTexParameteri(texturetarget, GL_TEXTURE_MAX_LEVEL,  PsychGetTextureMaxMipLevel(source));
             }
         }
         else {
@@ -855,10 +890,12 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
             // A negative filterMode means to select a specific mip-level in the
             // mipmap pyramid, according to the filterMode, starting with mip level 0, i.e,
             // full resolution for a value of -1, then level 1 aka half-resolution for a value
-            // of -2 etc.:
+            // of -2 etc. Textures in an atlas are limited to the levels which don't bleed:
             if ((texturetarget == GL_TEXTURE_2D) && !PsychIsGLES(source)) {
-                glTexParameteri(texturetarget, GL_TEXTURE_BASE_LEVEL, (-1 * filterMode) - 1);
-                glTexParameteri(texturetarget, GL_TEXTURE_MAX_LEVEL,  (-1 * filterMode) - 1);
+                int mipLevel = (-1 * filterMode) - 1;
+                if (mipLevel > PsychGetTextureMaxMipLevel(source)) mipLevel = PsychGetTextureMaxMipLevel(source);
+                glTexParameteri(texturetarget, GL_TEXTURE_BASE_LEVEL, mipLevel);
+                glTexParameteri(texturetarget, GL_TEXTURE_MAX_LEVEL,  mipLevel);
             }
         }
 
@@ -892,7 +929,7 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
     // use of power-of-two textures with a real power-of-two size. In that case we
     // enable wrapping mode to allow for scrolling effects -- useful for drifting
     // gratings.
-    if (texturetarget==GL_TEXTURE_2D && tWidth==sourceWidth && tHeight==sourceHeight) {
+    if (texturetarget==GL_TEXTURE_2D && tWidth==sourceWidth && tHeight==sourceHeight && source->textureAtlasIndex == 0) {
         // Special case: Scrollable real power-of-two textures. Enable wrapping.
         glTexParameteri(texturetarget, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(texturetarget, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -1231,6 +1268,12 @@ void PsychMapTexCoord(PsychWindowRecordType *tex, double* tx, double* ty)
         sourceY=*ty;
     }
 
+    // Texture packed into a texture atlas? Its texels are located at textureAtlasOffset inside the atlas:
+    if (tex->textureAtlasIndex > 0) {
+        sourceX+=tex->textureAtlasOffset[0];
+        sourceY+=tex->textureAtlasOffset[1];
+    }
+
     // Special case handling for GL_TEXTURE_2D textures. We need to map the
     // absolute texture coordinates (in pixels) to the interval 0.0 - 1.0 where
     // 1.0 == full extent of power of two texture...
@@ -1250,6 +1293,14 @@ void PsychMapTexCoord(PsychWindowRecordType *tex, double* tx, double* ty)
             tHeight = sourceHeight;
         }
 
+        // Underlying texture of an atlas member is the (power of two sized) atlas:
+        if (tex->textureAtlasIndex > 0) {
+            int aWidth, aHeight;
+            PsychGetTextureTexelSize(PsychGetTextureAtlas(tex), &aWidth, &aHeight);
+            tWidth = aWidth;
+            tHeight = aHeight;
+        }
+
         // Remap texcoords into 0-1 subrange: We subtract 0.5 pixel-units before
         // mapping to accomodate for roundoff-error in the power-of-two gfx
         // hardware...
@@ -1408,6 +1459,14 @@ void PsychBatchBlitTexturesToDisplay(unsigned int opMode, unsigned int count, Ps
 
     // opMode 2: Add a new texture to buffers:
 
+    // Batches of textures from one texture atlas can have different sizes per texture:
+    if ((index > 0) && (source->textureAtlasIndex > 0)) {
+        int aWidth, aHeight;
+        PsychGetTextureTexelSize(source, &aWidth, &aHeight);
+        sourceWidth = aWidth;
+        sourceHeight = aHeight;
+    }
+
     // First element to draw? Need some more setup from information derived from
     // first item:
     if (index == 0) {
@@ -1457,6 +1516,9 @@ void PsychBatchBlitTexturesToDisplay(unsigned int opMode, unsigned int count, Ps
                 tWidth = (int) sourceWidth;
                 tHeight = (int) sourceHeight;
             }
+
+            // Underlying texture of atlas members is the (power of two sized) atlas:
+            if (source->textureAtlasIndex > 0) PsychGetTextureTexelSize(PsychGetTextureAtlas(source), &tWidth, &tHeight);
         }
 
         // Only enable actual texture hardware if a real texture is provided.
@@ -1528,7 +1590,7 @@ void PsychBatchBlitTexturesToDisplay(unsigned int opMode, unsigned int count, Ps
             // decide how to implement a specific blur level on its own, unrestricted by us:
             if ((texturetarget == GL_TEXTURE_2D) && !PsychIsGLES(source)) {
                 glTexParameteri(texturetarget, GL_TEXTURE_BASE_LEVEL, 0);
-                glTexParameteri(texturetarget, GL_TEXTURE_MAX_LEVEL,  1000);
+                glTexParameteri(texturetarget, GL_TEXTURE_MAX_LEVEL,  PsychGetTextureMaxMipLevel(source));
             }
         }
         else {
@@ -1570,7 +1632,7 @@ void PsychBatchBlitTexturesToDisplay(unsigned int opMode, unsigned int count, Ps
                 // Don't restrict mipmap-levels for sampling, reset to initial system defaults:
                 if ((texturetarget == GL_TEXTURE_2D) && !PsychIsGLES(source)) {
                     glTexParameteri(texturetarget, GL_TEXTURE_BASE_LEVEL, 0);
-                    glTexParameteri(texturetarget, GL_TEXTURE_MAX_LEVEL,  1000);
+                    glTexParameteri(texturetarget, GL_TEXTURE_MAX_LEVEL,  PsychGetTextureMaxMipLevel(source));
                 }
             }
             else {
@@ -1582,10 +1644,12 @@ void PsychBatchBlitTexturesToDisplay(unsigned int opMode, unsigned int count, Ps
                 // A negative filterMode means to select a specific mip-level in the
                 // mipmap pyramid, according to the filterMode, starting with mip level 0, i.e,
                 // full resolution for a value of -1, then level 1 aka half-resolution for a value
-                // of -2 etc.:
+                // of -2 etc. Textures in an atlas are limited to the levels which don't bleed:
                 if ((texturetarget == GL_TEXTURE_2D) && !PsychIsGLES(source)) {
-                    glTexParameteri(texturetarget, GL_TEXTURE_BASE_LEVEL, (-1 * filterMode) - 1);
-                    glTexParameteri(texturetarget, GL_TEXTURE_MAX_LEVEL,  (-1 * filterMode) - 1);
+                    int mipLevel = (-1 * filterMode) - 1;
+                    if (mipLevel > PsychGetTextureMaxMipLevel(source)) mipLevel = PsychGetTextureMaxMipLevel(source);
+                    glTexParameteri(texturetarget, GL_TEXTURE_BASE_LEVEL, mipLevel);
+                    glTexParameteri(texturetarget, GL_TEXTURE_MAX_LEVEL,  mipLevel);
                 }
             }
 
@@ -1637,7 +1701,7 @@ void PsychBatchBlitTexturesToDisplay(unsigned int opMode, unsigned int count, Ps
         // use of power-of-two textures with a real power-of-two size. In that case we
         // enable wrapping mode to allow for scrolling effects -- useful for drifting
         // gratings.
-        if (texturetarget==GL_TEXTURE_2D && tWidth==sourceWidth && tHeight==sourceHeight) {
+        if (texturetarget==GL_TEXTURE_2D && tWidth==sourceWidth && tHeight==sourceHeight && source->textureAtlasIndex == 0) {
             // Special case: Scrollable real power-of-two textures. Enable wrapping.
             glTexParameteri(texturetarget, GL_TEXTURE_WRAP_S, GL_REPEAT);
             glTexParameteri(texturetarget, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -1708,6 +1772,14 @@ void PsychBatchBlitTexturesToDisplay(unsigned int opMode, unsigned int count, Ps
         sourceYEnd=sourceHeight - sourceRect[kPsychTop];
     }
 
+    // Texture packed into a texture atlas? Its texels are located at textureAtlasOffset inside the atlas:
+    if (source->textureAtlasIndex > 0) {
+        sourceX+=source->textureAtlasOffset[0];
+        sourceXEnd+=source->textureAtlasOffset[0];
+        sourceY+=source->textureAtlasOffset[1];
+        sourceYEnd+=source->textureAtlasOffset[1];
+    }
+
     // Special case handling for GL_TEXTURE_2D textures. We need to map the
     // absolute texture coordinates (in pixels) to the interval 0.0 - 1.0 where
     // 1.0 == full extent of power of two texture...
@@ -0,0 +1,509 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychTraceSupport.c
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           ag      agent@local
+
+    HISTORY:
+
+        19.10.2026  ag      Wrote it.
+
+    DESCRIPTION:
+
+        Low-overhead event tracing for Screen, e.g., to find out where a missed flip deadline spent
+        its time.
+
+        Each thread which records trace events gets its own ring buffer of (timestamp, event id, argument)
+        records. The ring is allocated once when the thread records its first event, so recording an
+        event is just a timestamp query and a store, without any locking or memory allocation. If a ring
+        is full, the oldest records get overwritten. Only the owning thread writes to its ring, and it
+        publishes each record by an atomic release store of the rings record counter. Export takes a
+        snapshot of each ring and discards the records which the owning thread overwrote while the
+        snapshot was taken. Trace points are added to the code via the
+        PsychTrace() macro, which is a no-op, apart from a test of a global flag, while tracing is
+        disabled.
+
+        The rings can be exported merged and sorted by time as arrays, or written as a JSON file in the
+        Chrome trace-event format, for viewing in chrome://tracing, Perfetto or similar tools.
+
+        Samples of the legacy TimeLists API, e.g., StoreNowTime(), are kept in their own list by
+        TimeLists.c, but also get recorded as trace events while tracing is enabled.
+*/
+
+#include "Screen.h"
+
+// Maximum number of threads with their own trace ring:
+#define kPsychTraceMaxThreads 64
+
+// Default number of records per thread ring:
+#define kPsychTraceDefaultCapacity 65536
+
+typedef struct PsychTraceRecord {
+    double              timestamp;
+    double              arg;
+    int                 eventId;
+} PsychTraceRecord;
+
+typedef struct PsychTraceRing {
+    PsychTraceRecord*   records;        // Preallocated ring of 'capacity' records.
+    unsigned int        capacity;
+    psych_uint64        written;        // Total number of records written. Only written by the owning thread, access atomically.
+    psych_uint64        cleared;        // Value of 'written' at last clear. Records before it are not exported.
+    psych_bool          owned;          // Ring currently owned by a live thread?
+    char                name[64];       // Thread name for exported traces.
+} PsychTraceRing;
+
+// Merged record for export:
+typedef struct PsychTraceExportRecord {
+    double              timestamp;
+    double              arg;
+    int                 eventId;
+    int                 threadIndex;
+} PsychTraceExportRecord;
+
+// Event names and Chrome trace-event phase types, indexed by event id:
+static const struct {
+    const char* name;
+    char        phase;
+} eventTable[kPsychTraceMaxEventId] = {
+    { "TimeListSample",     'i' },
+    { "Flip",               'B' },
+    { "Flip",               'E' },
+    { "PreFlipOperations",  'B' },
+    { "PreFlipOperations",  'E' },
+    { "SwapRequest",        'i' },
+    { "SwapComplete",       'i' },
+    { "FlipperWake",        'i' },
+    { "CreateTexture",      'B' },
+    { "CreateTexture",      'E' },
+    { "ExecuteHook",        'B' },
+    { "ExecuteHook",        'E' },
+    { "MovieFetch",         'B' },
+    { "MovieFetch",         'E' },
+    { "DrawText",           'B' },
+    { "DrawText",           'E' },
+};
+
+// Atomic access to the 'written' record counter of a ring, which the owning thread updates while other
+// threads export. 64-bit Windows has atomic aligned 64 bit loads and stores, other compilers have builtins:
+#ifdef _MSC_VER
+static psych_uint64 PsychTraceLoadCount(volatile psych_uint64* count)
+{
+    psych_uint64 value = *count;
+    MemoryBarrier();
+    return(value);
+}
+
+static void PsychTraceStoreCount(volatile psych_uint64* count, psych_uint64 value)
+{
+    MemoryBarrier();
+    *count = value;
+}
+#else
+#define PsychTraceLoadCount(count)          __atomic_load_n((count), __ATOMIC_ACQUIRE)
+#define PsychTraceStoreCount(count, value)  __atomic_store_n((count), (value), __ATOMIC_RELEASE)
+#endif
+
+psych_bool psychTraceEnabled = FALSE;
+
+static PsychTraceRing traceRings[kPsychTraceMaxThreads];
+static int traceRingCount = 0;
+static unsigned int traceCapacity = kPsychTraceDefaultCapacity;
+static psych_mutex traceMutex;
+static psych_bool traceInitialized = FALSE;
+
+// Ring and name of the calling thread need thread local storage (TLS), so declare them
+// in a compiler specific way:
+#ifdef _MSC_VER
+static __declspec(thread) PsychTraceRing* threadRing = NULL;
+static __declspec(thread) char threadName[64];
+#else
+static __thread PsychTraceRing* threadRing = NULL;
+static __thread char threadName[64];
+#endif
+
+void PsychTraceInit(void)
+{
+    if (traceInitialized) return;
+
+    memset(traceRings, 0, sizeof(traceRings));
+    traceRingCount = 0;
+    traceCapacity = kPsychTraceDefaultCapacity;
+    psychTraceEnabled = FALSE;
+    PsychInitMutex(&traceMutex);
+    traceInitialized = TRUE;
+}
+
+void PsychTraceShutdown(void)
+{
+    int i;
+
+    if (!traceInitialized) return;
+
+    psychTraceEnabled = FALSE;
+    for (i = 0; i < traceRingCount; i++) free(traceRings[i].records);
+    memset(traceRings, 0, sizeof(traceRings));
+    traceRingCount = 0;
+    threadRing = NULL;
+
+    PsychDestroyMutex(&traceMutex);
+    traceInitialized = FALSE;
+}
+
+/* Assign a ring to the calling thread, reusing the ring of an exited thread if possible: */
+static PsychTraceRing* PsychTraceAttachThread(void)
+{
+    PsychTraceRing *ring = NULL;
+    int i;
+
+    if (!traceInitialized) return(NULL);
+
+    PsychLockMutex(&traceMutex);
+
+    for (i = 0; i < traceRingCount; i++) {
+        if (!traceRings[i].owned) {
+            ring = &traceRings[i];
+            break;
+        }
+    }
+
+    if ((ring == NULL) && (traceRingCount < kPsychTraceMaxThreads)) ring = &traceRings[traceRingCount++];
+
+    if (ring) {
+        if (ring->capacity != traceCapacity) {
+            free(ring->records);
+            ring->records = (PsychTraceRecord*) calloc(traceCapacity, sizeof(PsychTraceRecord));
+            ring->capacity = (ring->records) ? traceCapacity : 0;
+        }
+
+        if (ring->records) {
+            PsychTraceStoreCount(&ring->written, 0);
+            ring->cleared = 0;
+            ring->owned = TRUE;
+            if (threadName[0]) {
+                snprintf(ring->name, sizeof(ring->name), "%s", threadName);
+            }
+            else {
+                snprintf(ring->name, sizeof(ring->name), (PsychIsMasterThread()) ? "Screen main thread" : "Screen thread %i", (int) (ring - &traceRings[0]));
+            }
+        }
+        else {
+            ring = NULL;
+        }
+    }
+
+    PsychUnlockMutex(&traceMutex);
+
+    threadRing = ring;
+
+    return(ring);
+}
+
+/* Assign a name to the calling thread for display in exported traces. Call at thread startup. */
+void PsychTraceSetThreadName(const char* name)
+{
+    snprintf(threadName, sizeof(threadName), "%s", (name) ? name : "");
+    if (threadRing && traceInitialized) {
+        PsychLockMutex(&traceMutex);
+        snprintf(threadRing->name, sizeof(threadRing->name), "%s", threadName);
+        PsychUnlockMutex(&traceMutex);
+    }
+}
+
+/* Release the ring of the calling thread for reuse by other threads. Call before thread exit.
+ * The records stay available for export until the ring gets reused.
+ */
+void PsychTraceDetachThread(void)
+{
+    if (threadRing && traceInitialized) {
+        PsychLockMutex(&traceMutex);
+        threadRing->owned = FALSE;
+        PsychUnlockMutex(&traceMutex);
+    }
+    threadRing = NULL;
+}
+
+void PsychTraceStart(int recordsPerThread)
+{
+    PsychTraceRing *ring;
+
+    if (recordsPerThread > 0) {
+        traceCapacity = (unsigned int) recordsPerThread;
+
+        // Resize the ring of the calling thread now. Other threads rings keep their size until reused:
+        if ((ring = threadRing) && (ring->capacity != traceCapacity)) PsychTraceDetachThread();
+    }
+
+    if (threadRing == NULL) PsychTraceAttachThread();
+
+    psychTraceEnabled = TRUE;
+}
+
+void PsychTraceStop(void)
+{
+    psychTraceEnabled = FALSE;
+}
+
+void PsychTraceClear(void)
+{
+    int i;
+
+    if (!traceInitialized) return;
+
+    // Only the owning threads write their 'written' counters, so just hide the records written so far:
+    PsychLockMutex(&traceMutex);
+    for (i = 0; i < traceRingCount; i++) traceRings[i].cleared = PsychTraceLoadCount(&traceRings[i].written);
+    PsychUnlockMutex(&traceMutex);
+}
+
+/* Record one trace event. Don't call directly, but use the PsychTrace() macro. */
+void PsychTraceStore(int eventId, double arg)
+{
+    PsychTraceRing *ring = threadRing;
+    PsychTraceRecord *rec;
+    psych_uint64 written;
+    double now;
+
+    if ((ring == NULL) && ((ring = PsychTraceAttachThread()) == NULL)) return;
+
+    // We are the only writer of 'written', so a plain read is fine. Publish the record by the store:
+    written = ring->written;
+    PsychGetAdjustedPrecisionTimerSeconds(&now);
+    rec = &(ring->records[written % ring->capacity]);
+    rec->timestamp = now;
+    rec->arg = arg;
+    rec->eventId = eventId;
+    PsychTraceStoreCount(&ring->written, written + 1);
+}
+
+const char* PsychTraceGetEventName(int eventId)
+{
+    return((eventId >= 0 && eventId < kPsychTraceMaxEventId) ? eventTable[eventId].name : "Unknown");
+}
+
+/* Chrome trace-event phase of event 'eventId': 'B'egin, 'E'nd or 'i'nstant: */
+char PsychTraceGetEventPhase(int eventId)
+{
+    return((eventId >= 0 && eventId < kPsychTraceMaxEventId) ? eventTable[eventId].phase : 'i');
+}
+
+/* Number of records in ring 'ring' for written record counter 'written', and index of its oldest record: */
+static unsigned int PsychTraceRingSpan(PsychTraceRing *ring, psych_uint64 written, psych_uint64 *first)
+{
+    *first = (written > ring->capacity) ? written - ring->capacity : 0;
+    if (*first < ring->cleared) *first = ring->cleared;
+    return((written > *first) ? (unsigned int) (written - *first) : 0);
+}
+
+/* Snapshot the records with event id 'eventId', or all records if -1, of ring 'i' into 'out', which must
+ * have room for the rings capacity. The owning thread may record further events while we copy, so records
+ * which got overwritten during the copy are discarded afterwards. Returns number of records in 'out'.
+ * Must be called with traceMutex locked.
+ */
+static int PsychTraceSnapshotRing(int i, int eventId, PsychTraceExportRecord *out)
+{
+    PsychTraceRing *ring = &traceRings[i];
+    PsychTraceRecord *rec;
+    psych_uint64 first, valid, j;
+    unsigned int n, k, m;
+
+    if (ring->records == NULL) return(0);
+
+    n = PsychTraceRingSpan(ring, PsychTraceLoadCount(&ring->written), &first);
+    for (j = first, k = 0; k < n; j++, k++) {
+        rec = &(ring->records[j % ring->capacity]);
+        out[k].timestamp = rec->timestamp;
+        out[k].arg = rec->arg;
+        out[k].eventId = rec->eventId;
+        out[k].threadIndex = i;
+    }
+
+    // Records older than 'valid' may have been overwritten while we copied them:
+    PsychTraceRingSpan(ring, PsychTraceLoadCount(&ring->written), &valid);
+    for (j = first, k = 0, m = 0; k < n; j++, k++) {
+        if ((j < valid) || ((eventId >= 0) && (out[k].eventId != eventId))) continue;
+        out[m++] = out[k];
+    }
+
+    return((int) m);
+}
+
+/* Return number of available records with event id 'eventId', or of all records if 'eventId' is -1.
+ * Threads may record further events at any time, so this is only a snapshot of the count:
+ */
+int PsychTraceGetRecordCount(int eventId)
+{
+    psych_uint64 first, j;
+    unsigned int n;
+    int i, count = 0;
+
+    if (!traceInitialized) return(0);
+
+    PsychLockMutex(&traceMutex);
+
+    for (i = 0; i < traceRingCount; i++) {
+        if (traceRings[i].records == NULL) continue;
+
+        n = PsychTraceRingSpan(&traceRings[i], PsychTraceLoadCount(&traceRings[i].written), &first);
+        if (eventId < 0) {
+            count += n;
+            continue;
+        }
+
+        for (j = first; j < first + n; j++)
+            if (traceRings[i].records[j % traceRings[i].capacity].eventId == eventId) count++;
+    }
+
+    PsychUnlockMutex(&traceMutex);
+
+    return(count);
+}
+
+static int PsychTraceCompareRecords(const void* a, const void* b)
+{
+    double ta = ((const PsychTraceExportRecord*) a)->timestamp;
+    double tb = ((const PsychTraceExportRecord*) b)->timestamp;
+
+    return((ta < tb) ? -1 : ((ta > tb) ? 1 : 0));
+}
+
+/* Collect the newest up to 'maxRecords' records with id 'eventId', or all records if -1, from all rings,
+ * sorted by time. Returns a malloc'ed array which the caller must free(), and its number of records in *count.
+ */
+static PsychTraceExportRecord* PsychTraceCollect(int eventId, int maxRecords, int *count)
+{
+    PsychTraceExportRecord *out;
+    size_t total = 0;
+    int i;
+
+    *count = 0;
+    if ((maxRecords <= 0) || !traceInitialized) return(NULL);
+
+    // The lock keeps rings from getting attached or reallocated while we snapshot them:
+    PsychLockMutex(&traceMutex);
+
+    // Gather all matching records, as the newest ones can be in any ring. Rings can fill up while
+    // we snapshot them, so reserve room for full rings:
+    for (i = 0; i < traceRingCount; i++) if (traceRings[i].records) total += traceRings[i].capacity;
+
+    out = (total > 0) ? (PsychTraceExportRecord*) malloc(total * sizeof(PsychTraceExportRecord)) : NULL;
+    if ((out == NULL) && (total > 0)) {
+        PsychUnlockMutex(&traceMutex);
+        PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to export trace buffer.");
+    }
+
+    for (i = 0; i < traceRingCount; i++) *count += PsychTraceSnapshotRing(i, eventId, &out[*count]);
+
+    PsychUnlockMutex(&traceMutex);
+
+    qsort(out, *count, sizeof(PsychTraceExportRecord), PsychTraceCompareRecords);
+
+    // Keep only the newest maxRecords:
+    if (*count > maxRecords) {
+        memmove(out, &out[*count - maxRecords], maxRecords * sizeof(PsychTraceExportRecord));
+        *count = maxRecords;
+    }
+
+    return(out);
+}
+
+/* Export up to 'maxRecords' records with id 'eventId', or all records if -1, sorted by time, into the
+ * given arrays. NULL arrays are skipped. Returns number of exported records.
+ */
+int PsychTraceExport(int eventId, int maxRecords, double* timestamps, double* eventIds, double* args, double* threadIndices)
+{
+    PsychTraceExportRecord *recs;
+    int i, count;
+
+    recs = PsychTraceCollect(eventId, maxRecords, &count);
+    for (i = 0; i < count; i++) {
+        if (timestamps) timestamps[i] = recs[i].timestamp;
+        if (eventIds) eventIds[i] = (double) recs[i].eventId;
+        if (args) args[i] = recs[i].arg;
+        if (threadIndices) threadIndices[i] = (double) recs[i].threadIndex;
+    }
+
+    free(recs);
+
+    return(count);
+}
+
+/* Write string 's' as a JSON string literal to 'fd', with quotes and backslashes escaped: */
+static void PsychTraceWriteJSONString(FILE *fd, const char* s)
+{
+    fputc('"', fd);
+    for (; *s; s++) {
+        if ((*s == '"') || (*s == '\\')) {
+            fputc('\\', fd);
+            fputc(*s, fd);
+        }
+        else if ((unsigned char) *s < 0x20) {
+            fprintf(fd, "\\u%04x", (unsigned int) (unsigned char) *s);
+        }
+        else {
+            fputc(*s, fd);
+        }
+    }
+    fputc('"', fd);
+}
+
+/* Write all records as Chrome trace-event format JSON file 'filename'. Returns TRUE on success. */
+psych_bool PsychTraceWriteChromeJSON(const char* filename)
+{
+    PsychTraceExportRecord *recs;
+    FILE *fd;
+    int i, count, ringCount;
+    char name[64];
+    psych_bool first = TRUE;
+
+    fd = fopen(filename, "w");
+    if (fd == NULL) {
+        if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: Could not open trace file '%s' for writing: %s\n", filename, strerror(errno));
+        return(FALSE);
+    }
+
+    fprintf(fd, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    // Thread names as metadata events. Threads can rename their rings, so copy the names under the lock:
+    ringCount = 0;
+    if (traceInitialized) {
+        PsychLockMutex(&traceMutex);
+        ringCount = traceRingCount;
+        PsychUnlockMutex(&traceMutex);
+    }
+
+    for (i = 0; i < ringCount; i++) {
+        PsychLockMutex(&traceMutex);
+        snprintf(name, sizeof(name), "%s", traceRings[i].name);
+        PsychUnlockMutex(&traceMutex);
+
+        fprintf(fd, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":", (first) ? "" : ",\n", i);
+        PsychTraceWriteJSONString(fd, name);
+        fprintf(fd, "}}");
+        first = FALSE;
+    }
+
+    recs = PsychTraceCollect(-1, INT_MAX, &count);
+    for (i = 0; i < count; i++) {
+        fprintf(fd, "%s{\"name\":\"%s\",\"cat\":\"Screen\",\"ph\":\"%c\",%s\"ts\":%.3f,\"pid\":1,\"tid\":%i,\"args\":{\"arg\":%.17g}}",
+                (first) ? "" : ",\n", PsychTraceGetEventName(recs[i].eventId),
+                PsychTraceGetEventPhase(recs[i].eventId), (PsychTraceGetEventPhase(recs[i].eventId) == 'i') ? "\"s\":\"t\"," : "",
+                recs[i].timestamp * 1e6, recs[i].threadIndex, recs[i].arg);
+        first = FALSE;
+    }
+
+    fprintf(fd, "\n]}\n");
+    free(recs);
+
+    if (fclose(fd)) {
+        if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: Failed to write trace file '%s': %s\n", filename, strerror(errno));
+        return(FALSE);
+    }
+
+    return(TRUE);
+}
@@ -0,0 +1,69 @@
+/*
+    PsychToolbox3/Source/Common/Screen/PsychTraceSupport.h
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           ag      agent@local
+
+    HISTORY:
+
+        19.10.2026  ag      Wrote it.
+
+    DESCRIPTION:
+
+        Low-overhead event tracing for Screen: Each thread records (timestamp, event id, argument)
+        tuples into its own preallocated ring buffer. The rings can be exported as arrays or as a
+        Chrome trace-event JSON file via Screen('TraceBuffer').
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychTraceSupport
+#define PSYCH_IS_INCLUDED_PsychTraceSupport
+
+#include "Screen.h"
+
+// Trace event ids. Keep in sync with the event name table in PsychTraceSupport.c:
+#define kPsychTraceTimeListSample       0   // StoreNowTime() sample of the legacy TimeLists API, arg = sample number.
+#define kPsychTraceFlipBegin            1   // PsychFlipWindowBuffers() begin, arg = window handle.
+#define kPsychTraceFlipEnd              2   // PsychFlipWindowBuffers() end, arg = window handle.
+#define kPsychTracePreFlipBegin         3   // PsychPreFlipOperations() begin, arg = window handle.
+#define kPsychTracePreFlipEnd           4   // PsychPreFlipOperations() end, arg = window handle.
+#define kPsychTraceSwapRequest          5   // Bufferswap submitted, arg = window handle.
+#define kPsychTraceSwapComplete         6   // Bufferswap completion detected, arg = window handle.
+#define kPsychTraceFlipperWake          7   // Async flipper thread picked up a flip request, arg = window handle.
+#define kPsychTraceTextureCreateBegin   8   // PsychCreateTexture() begin, arg = texture handle.
+#define kPsychTraceTextureCreateEnd     9   // PsychCreateTexture() end, arg = texture handle.
+#define kPsychTraceHookBegin            10  // PsychPipelineExecuteHook() begin, arg = hook chain id.
+#define kPsychTraceHookEnd              11  // PsychPipelineExecuteHook() end, arg = hook chain id.
+#define kPsychTraceMovieFetchBegin      12  // PsychGetTextureFromMovie() begin, arg = movie handle.
+#define kPsychTraceMovieFetchEnd        13  // PsychGetTextureFromMovie() end, arg = movie handle.
+#define kPsychTraceDrawTextBegin        14  // Screen('DrawText') begin, arg = number of characters.
+#define kPsychTraceDrawTextEnd          15  // Screen('DrawText') end, arg = number of characters.
+#define kPsychTraceMaxEventId           16
+
+// Global enable flag, only to be read via the PsychTrace() macro:
+extern psych_bool psychTraceEnabled;
+
+// Record a trace event, if tracing is enabled. This is the way to add trace points:
+#define PsychTrace(eventId, arg) { if (psychTraceEnabled) PsychTraceStore((eventId), (double) (arg)); }
+
+void            PsychTraceInit(void);
+void            PsychTraceShutdown(void);
+void            PsychTraceStart(int recordsPerThread);
+void            PsychTraceStop(void);
+void            PsychTraceClear(void);
+void            PsychTraceStore(int eventId, double arg);
+void            PsychTraceSetThreadName(const char* name);
+void            PsychTraceDetachThread(void);
+int             PsychTraceGetRecordCount(int eventId);
+int             PsychTraceExport(int eventId, int maxRecords, double* timestamps, double* eventIds, double* args, double* threadIndices);
+psych_bool      PsychTraceWriteChromeJSON(const char* filename);
+const char*     PsychTraceGetEventName(int eventId);
+char            PsychTraceGetEventPhase(int eventId);
+
+//end include once
+#endif
@@ -16,6 +16,8 @@
     5.06.2011               Make video/audio recording good enough
                             for initial release on Linux.
     20.08.2014              Ported to GStreamer-1.4 and later.
+    19.10.2026              Optional zero-copy import of DMA-BUF video frames via recordingflags 16384.
+    19.10.2026              SIMD intensity statistics with optional ROI, channel selection, min/max and histogram.
 
     DESCRIPTION:
 
@@ -63,6 +65,7 @@
 #include <locale.h>
 #include <ctype.h>
 #include "PsychVideoCaptureSupport.h"
+#include "PsychDmaBufImportSupport.h"
 
 // Include for dynamic loading of external plugin, for now only on Unix:
 #if PSYCH_SYSTEM != PSYCH_WINDOWS
@@ -134,6 +137,14 @@ typedef struct {
     double avg_decompresstime;        // Average time spent in decompressor.
     double avg_gfxtime;               // Average time spent in buffer --> OpenGL texture conversion and statistics.
     int nrgfxframes;                  // Count of fetched textures.
+    int zeroCopyFrames;               // Count of textures imported from DMA-BUF video frames without copy.
+    int copiedFrames;                 // Count of textures uploaded from video frames by copy.
+    int statsFlags;                   // Per frame statistics for 'GetFrameStatistics': 0 = Off, 1 = Means, 2 = +Min/Max, 4 = +Histogram.
+    int statsChannel;                 // Channel for average intensity and statistics, -1 = All channels.
+    int statsUseROI;                  // 1 = Restrict average intensity and statistics to statsROI.
+    int statsROI[4];                  // Region of interest [left, top, right, bottom] for statistics, in frame pixels.
+    double statsTimestamp;            // Capture timestamp of the frame of lastStats, or -1 if none.
+    PsychImageStatisticsType lastStats; // Statistics of last fetched frame, if statsFlags is non-zero.
     char* targetmoviefilename;        // Filename of a movie file to record.
     char* cameraFriendlyName;         // Camera friendly device name.
     char videosourcename[100];        // Plugin name of the videosource plugin.
@@ -3074,6 +3085,10 @@ psych_bool PsychGSOpenVideoCaptureDevice(int slotid, PsychWindowRecordType *win,
     capdev->grabber_active = 0;
     capdev->scratchbuffer = NULL;
 
+    // Intensity statistics over all channels of the full frame by default:
+    capdev->statsChannel = -1;
+    capdev->statsTimestamp = -1;
+
     // Make sure bitdepth is either 8 bpc or 16 bpc, nothing else:
     bitdepth = (bitdepth > 8) ? 16 : 8;
 
@@ -3596,6 +3611,19 @@ psych_bool PsychGSOpenVideoCaptureDevice(int slotid, PsychWindowRecordType *win,
             PsychErrorExitMsg(PsychError_internal, "Unknown reqdepth parameter received!");
     }
 
+    // Zero-copy import of RGBA8 frames requested via recordingflags & 16384? Then prefer DMA-BUF memory
+    // if the video source and the window support it, falling back to regular system memory frames otherwise:
+    if (recordingflags & 16384) {
+        if ((reqdepth == 4) && (bitdepth <= 8) && win && PsychDmaBufImportAvailable(win)) {
+            colorcaps = PsychDmaBufAddImportCaps(colorcaps);
+        }
+        else {
+            recordingflags &= ~16384;
+            if (PsychPrefStateGet_Verbosity() > 3)
+                printf("PTB-INFO: Zero-copy DMA-BUF frame import unsupported for this capture device or pixel format. Using regular texture upload.\n");
+        }
+    }
+
     // Assign 'colorcaps' as caps to our videosink. This marks the videosink so
     // that it can only receive video image data in the format defined by colorcaps,
     // i.e., a format that is easy to consume for OpenGL's texture creation on std.
@@ -4306,6 +4334,8 @@ int PsychGSVideoCaptureRate(int capturehandle, double capturerate, int dropframe
         capdev->last_pts = -1.0;
         capdev->nr_droppedframes = 0;
         capdev->lastSavedBaseTime = 0;
+        capdev->zeroCopyFrames = 0;
+        capdev->copiedFrames = 0;
 
         // Framedropping in the sense we define it is not supported by libGStreamer, so we implement it ourselves.
         // Store the 'dropframes' flag in our capdev struct, so the PsychGSGetTextureFromCapture()
@@ -4654,10 +4684,7 @@ int PsychGSGetTextureFromCapture(PsychWindowRecordType *win, int capturehandle,
 
     int waitforframe;
     int w, h;
-    psych_uint64 intensity = 0;
-    unsigned int count, i;
-    unsigned char* pixptr;
-    psych_uint16* pixptrs;
+    unsigned int count;
     double tstart, tend;
     int nrdropped = 0;
     unsigned char* input_image = NULL;
@@ -5076,12 +5103,19 @@ int PsychGSGetTextureFromCapture(PsychWindowRecordType *win, int capturehandle,
             glPixelTransferi(GL_GREEN_SCALE, 1);
             glPixelTransferi(GL_BLUE_SCALE, 1);
         }
+        else if ((capdev->recordingflags & 16384) && PsychDmaBufImportTexture(win, videoSample, out_texture)) {
+            // Zero-copy case: Frame in DMA-BUF memory got imported as texture without upload:
+            capdev->zeroCopyFrames++;
+        }
         else {
             // Simple case: Let PsychCreateTexture() do the rest of the job of creating, setting up and
             // filling an OpenGL texture with content:
             PsychCreateTexture(out_texture);
         }
 
+        // All textures not imported above got uploaded by copy:
+        if (out_texture->textureImportHandle == NULL) capdev->copiedFrames++;
+
         // This NULL-out is not strictly needed (done already in PsychCreateTexture()), just for simpler code review:
         out_texture->textureMemory = NULL;
 
@@ -5097,20 +5131,24 @@ int PsychGSGetTextureFromCapture(PsychWindowRecordType *win, int capturehandle,
         // Ready to use the texture...
     }
 
-    // Sum of pixel intensities requested? 8 bpc?
-    if (summed_intensity && (capdev->bitdepth <= 8)) {
-        pixptr = (unsigned char*) input_image;
-        count  = w * h * ((capdev->reqpixeldepth !=2) ? capdev->reqpixeldepth : 1);
-        for (i=0; i<count; i++) intensity+=(psych_uint64) pixptr[i];
-        *summed_intensity = ((double) intensity) / w / h / capdev->reqpixeldepth / 255;
-    }
+    // Average of pixel intensities or per frame statistics requested? Computed in one pass over the
+    // frame, or over the statistics ROI if any. YUV frames are evaluated as a single channel image of
+    // their first w * h samples:
+    if (summed_intensity || capdev->statsFlags) {
+        PsychImageStatisticsType stats;
+
+        PsychComputeImageStatistics(input_image, w, h, 0, (capdev->reqpixeldepth != 2) ? capdev->reqpixeldepth : 1, capdev->bitdepth,
+                                    (capdev->statsUseROI) ? capdev->statsROI : NULL, capdev->statsChannel,
+                                    ((capdev->statsFlags & 2) ? kPsychImageStatsMinMax : 0) | ((capdev->statsFlags & 4) ? kPsychImageStatsHistogram : 0),
+                                    &stats);
+
+        // Average intensity keeps its classic normalization for YUV frames:
+        if (summed_intensity) *summed_intensity = stats.mean / ((capdev->reqpixeldepth == 2) ? 2 : 1);
 
-    // Sum of pixel intensities requested? 16 bpc?
-    if (summed_intensity && (capdev->bitdepth > 8)) {
-        pixptrs = (psych_uint16*) input_image;
-        count = w * h * ((capdev->reqpixeldepth !=2) ? capdev->reqpixeldepth : 1);
-        for (i=0; i<count; i++) intensity+=(psych_uint64) pixptrs[i];
-        *summed_intensity = ((double) intensity) / w / h / capdev->reqpixeldepth / ((1 << (capdev->bitdepth)) - 1);
+        if (capdev->statsFlags) {
+            capdev->lastStats = stats;
+            capdev->statsTimestamp = capdev->current_pts;
+        }
     }
 
     // Raw data requested?
@@ -5384,6 +5422,63 @@ double PsychGSVideoCaptureSetParameter(int capturehandle, const char* pname, dou
         return(0);
     }
 
+    // Restrict average intensity and frame statistics to a region of interest 'SetStatisticsROI=left,top,right,bottom'
+    // inside the returned video frames, or to the full frame if no rectangle is given:
+    if (strstr(pname, "SetStatisticsROI=")) {
+        pname = strstr(pname, "=");
+        pname++;
+
+        if (4 == sscanf(pname, "%i%*[ ,]%i%*[ ,]%i%*[ ,]%i", &capdev->statsROI[0], &capdev->statsROI[1], &capdev->statsROI[2], &capdev->statsROI[3])) {
+            if ((capdev->statsROI[2] <= capdev->statsROI[0]) || (capdev->statsROI[3] <= capdev->statsROI[1]))
+                PsychErrorExitMsg(PsychError_user, "Invalid 'SetStatisticsROI=' rectangle provided: Must have positive width and height.");
+            capdev->statsUseROI = 1;
+        }
+        else {
+            capdev->statsUseROI = 0;
+        }
+
+        return(0);
+    }
+
+    // Channel for average intensity and frame statistics: -1 = All channels, 0 - 3 = Only that channel:
+    if (strcmp(pname, "StatisticsChannel")==0) {
+        oldvalue = capdev->statsChannel;
+        if (value != DBL_MAX) {
+            if ((value < -1) || (value > 3)) PsychErrorExitMsg(PsychError_user, "Invalid 'StatisticsChannel' provided: Must be -1 for all channels, or 0 to 3.");
+            capdev->statsChannel = (int) value;
+        }
+        return(oldvalue);
+    }
+
+    // Enable or disable per frame statistics for 'GetFrameStatistics': 1 = Means, + 2 = Min/Max, + 4 = Histogram:
+    if (strcmp(pname, "FrameStatistics")==0) {
+        oldvalue = capdev->statsFlags;
+        if (value != DBL_MAX) {
+            if ((value < 0) || (value > 7)) PsychErrorExitMsg(PsychError_user, "Invalid 'FrameStatistics' flags provided: Must be between 0 and 7.");
+            capdev->statsFlags = (int) value;
+            capdev->statsTimestamp = -1;
+        }
+        return(oldvalue);
+    }
+
+    // Return statistics of last fetched frame as struct:
+    if (strcmp(pname, "GetFrameStatistics")==0) {
+        PsychCopyOutImageStatistics(1, &capdev->lastStats, capdev->statsTimestamp);
+        return(0);
+    }
+
+    // Return count of textures imported without copy since start of capture:
+    if (strcmp(pname, "GetZeroCopyFrameCount")==0) {
+        PsychCopyOutDoubleArg(1, FALSE, capdev->zeroCopyFrames);
+        return(0);
+    }
+
+    // Return count of textures uploaded by copy since start of capture:
+    if (strcmp(pname, "GetCopiedFrameCount")==0) {
+        PsychCopyOutDoubleArg(1, FALSE, capdev->copiedFrames);
+        return(0);
+    }
+
     // Return current ROI of camera, as requested (and potentially modified during
     // PsychOpenCaptureDevice(). This is a read-only parameter, as the ROI can
     // only be set during Screen('OpenVideoCapture').
@@ -2265,10 +2265,7 @@ int PsychDCGetTextureFromCapture(PsychWindowRecordType *win, int capturehandle,
                                  PsychWindowRecordType *out_texture, double *presentation_timestamp, double* summed_intensity, rawcapimgdata* outrawbuffer)
 {
     int w, h;
-    psych_uint64 intensity = 0;
     unsigned int count, i;
-    unsigned char* pixptr;
-    psych_uint16* pixptrs;
     psych_bool frame_ready;
     double tstart, tend;
     dc1394error_t error;
@@ -2634,20 +2631,11 @@ int PsychDCGetTextureFromCapture(PsychWindowRecordType *win, int capturehandle,
         // Ready to use the texture...
     }
 
-    // Sum of pixel intensities requested? 8 bpc?
-    if (summed_intensity && (capdev->bitdepth <= 8)) {
-        pixptr = (unsigned char*) input_image;
-        count = (w*h*((capdev->actuallayers == 3) ? 3 : 1));
-        for (i=0; i<count; i++) intensity+=(psych_uint64) pixptr[i];
-        *summed_intensity = ((double) intensity) / w / h / ((capdev->actuallayers == 3) ? 3 : 1) / 255;
-    }
-
-    // Sum of pixel intensities requested? 16 bpc?
-    if (summed_intensity && (capdev->bitdepth > 8)) {
-        pixptrs = (psych_uint16*) input_image;
-        count = (w*h*((capdev->actuallayers == 3) ? 3 : 1));
-        for (i=0; i<count; i++) intensity+=(psych_uint64) pixptrs[i];
-        *summed_intensity = ((double) intensity) / w / h / ((capdev->actuallayers == 3) ? 3 : 1) / ((1 << (capdev->bitdepth)) - 1);
+    // Sum of pixel intensities requested? Average over all channels and pixels, normalized to 0.0 - 1.0 range:
+    if (summed_intensity) {
+        PsychImageStatisticsType stats;
+        PsychComputeImageStatistics(input_image, w, h, 0, (capdev->actuallayers == 3) ? 3 : 1, capdev->bitdepth, NULL, -1, 0, &stats);
+        *summed_intensity = stats.mean;
     }
 
     // Raw data requested?
@@ -126,6 +126,8 @@ static unsigned int frameSeqStereoActive = 0;
 // Count of onscreen windows which have our own threaded VRR scheduler implementation active:
 static unsigned int vrrSchedulersActive = 0;
 
+static void PsychStopPresentQueue(PsychWindowRecordType *windowRecord, psych_bool drain);
+
 // Return count of currently async-flipping onscreen windows:
 unsigned int PsychGetNrAsyncFlipsActive(void)
 {
@@ -406,6 +408,9 @@ psych_bool PsychOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Psyc
     GLint TexmemTotal=0;
     psych_bool sync_trouble = FALSE;
     psych_bool sync_disaster = FALSE;
+    PsychRefreshCalibrationType calib;
+    psych_uint64 calibCacheKey = 0;
+    psych_bool useCachedCalibration = FALSE;
     psych_bool did_pageflip = FALSE;
     int skip_synctests;
     int visual_debuglevel = PsychPrefStateGet_VisualDebugLevel();
@@ -1403,6 +1408,24 @@ psych_bool PsychOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Psyc
                    (float) maxStddev * 1000.0, (float) maxDeviation * 100.0, minSamples, (float) maxDuration);
         }
 
+        // Persistent refresh calibration cache enabled? Then try to use a cached calibration for this display setup,
+        // after verifying it with a short test. VRR, the external display backend and the 48 bpc MMIO hack are excluded:
+        memset(&calib, 0, sizeof(calib));
+        if ((PsychPrefStateGet_RefreshCalibrationCache() > 0) && !((*windowRecord)->specialflags & kPsychExternalDisplayMethod) && !PsychVRRActive(*windowRecord) &&
+            (!((*windowRecord)->specialflags & kPsychNative10bpcFBActive) || ((*windowRecord)->depth != 48))) {
+            calibCacheKey = PsychRefreshCalibrationCacheKey(*windowRecord, ifi_nominal);
+
+            if ((PsychPrefStateGet_RefreshCalibrationCache() == 1) && PsychRefreshCalibrationCacheLoad(calibCacheKey, &calib)) {
+                useCachedCalibration = PsychRefreshCalibrationCacheVerify(*windowRecord, &calib, (PsychOSIsDWMEnabled(screenSettings->screenNumber) && (PSYCH_SYSTEM != PSYCH_LINUX)) ? (5 * maxStddev) : maxStddev);
+                if (!useCachedCalibration) {
+                    // Stale: Delete it, so it gets replaced by the results of the full calibration.
+                    PsychRefreshCalibrationCacheInvalidate(calibCacheKey);
+                    memset(&calib, 0, sizeof(calib));
+                    if (PsychPrefStateGet_Verbosity() > 2) printf("PTB-INFO: Cached refresh calibration failed verification. Performing full calibration.\n");
+                }
+            }
+        }
+
         // First we try if PsychGetDisplayBeamPosition works and try to estimate monitor refresh from it:
 
         // Check if a beamposition of 0 is returned at two points in time on OS-X:
@@ -1417,9 +1440,30 @@ psych_bool PsychOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Psyc
             }
         }
 
+        if (useCachedCalibration) {
+            // Verified cached calibration: Reuse its beamposition results and verdicts.
+            VBL_Endline = calib.vblEndline;
+            ifi_beamestimate = calib.ifiBeamEstimate;
+
+            // Double-scan video mode detected during calibration?
+            if (calib.vblStartline != (int) vbl_startline) {
+                vbl_startline = calib.vblStartline;
+                (*windowRecord)->VBL_Startline = vbl_startline;
+            }
+
+            if (calib.flags & kPsychCalibBeamposCorrection)
+                PsychSetBeamposCorrection((*windowRecord)->screenNumber, (int) 0xffffffff, (int) 0xffffffff);
+
+            if (calib.flags & kPsychCalibBeamposWorkaround)
+                PsychPrefStateSet_ConserveVRAM(PsychPrefStateGet_ConserveVRAM() | kPsychUseBeampositionQueryWorkaround);
+
+            if (PsychPrefStateGet_EmulateOldPTB()) PsychGetAdjustedPrecisionTimerSeconds(&((*windowRecord)->time_at_last_vbl));
+        }
         // Check if a beamposition of -1 is returned: This would indicate that beamposition queries
         // are not available on this system:
-        if ((-1 != ((int) PsychGetDisplayBeamPosition(cgDisplayID, (*windowRecord)->screenNumber))) && (i!=12345)) {
+        else if ((-1 != ((int) PsychGetDisplayBeamPosition(cgDisplayID, (*windowRecord)->screenNumber))) && (i!=12345)) {
+            calib.flags |= kPsychCalibBeamposSupported;
+
             // Switch to RT scheduling for timing tests:
             PsychRealtimePriority(true);
 
@@ -1593,6 +1637,7 @@ psych_bool PsychOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Psyc
 
                         // We ask the function to auto-detect proper values from GPU hardware and revert to safe (0,0) on failure:
                         PsychSetBeamposCorrection((*windowRecord)->screenNumber, (int) 0xffffffff, (int) 0xffffffff);
+                        calib.flags |= kPsychCalibBeamposCorrection;
                     }
                 }
 
@@ -1602,6 +1647,7 @@ psych_bool PsychOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Psyc
                 if ((PSYCH_SYSTEM != PSYCH_WINDOWS) && (vbl_startline >= VBL_Endline)) {
                     // Yup, problem. Enable the workaround:
                     PsychPrefStateSet_ConserveVRAM(PsychPrefStateGet_ConserveVRAM() | kPsychUseBeampositionQueryWorkaround);
+                    calib.flags |= kPsychCalibBeamposWorkaround;
 
                     // Tell user:
                     if (PsychPrefStateGet_Verbosity() > 2) {
@@ -1648,7 +1694,10 @@ psych_bool PsychOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Psyc
             if (PsychPrefStateGet_EmulateOldPTB()) PsychGetAdjustedPrecisionTimerSeconds(&((*windowRecord)->time_at_last_vbl));
         }
 
-        // End of beamposition measurements and validation.
+        // End of beamposition measurements and validation. Record results for the refresh calibration cache:
+        calib.vblStartline = (int) vbl_startline;
+        calib.vblEndline = VBL_Endline;
+        calib.ifiBeamEstimate = ifi_beamestimate;
 
         // We now perform an initial calibration using VBL-Syncing of OpenGL:
         // We use minSamples samples (minSamples monitor refresh intervals) and provide the ifi_nominal
@@ -1663,7 +1712,22 @@ psych_bool PsychOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Psyc
         // fail due to a fps way lower than the video refresh rate of the display, iow. the test would show a false
         // positive, e.g., a 60 Hz display may only be able to flip at 20 fps at most, possibly even slower. On Linux
         // we have various other means to check for proper timing, so this test can be skipped with no harm.
-        if (!((*windowRecord)->specialflags & kPsychNative10bpcFBActive) || ((*windowRecord)->depth != 48)) {
+        if (useCachedCalibration) {
+            // Verified cached calibration: Reuse its refresh interval and verdicts.
+            ifi_estimate = calib.ifiEstimate;
+            numSamples = calib.numSamples;
+            stddev = calib.stddev;
+            did_pageflip = (calib.flags & kPsychCalibDidPageflip) ? TRUE : FALSE;
+            maxsecs = 0.0;
+            (*windowRecord)->nrIFISamples = numSamples;
+            (*windowRecord)->IFIRunningSum = ifi_estimate * numSamples;
+
+            if (calib.flags & kPsychCalibBusyWaitBeforeSwap)
+                (*windowRecord)->specialflags |= kPsychBusyWaitForVBLBeforeBufferSwapRequest;
+
+            if (PsychPrefStateGet_Verbosity() > 2) printf("PTB-INFO: Using cached refresh calibration for this display setup, verified by a short test.\n");
+        }
+        else if (!((*windowRecord)->specialflags & kPsychNative10bpcFBActive) || ((*windowRecord)->depth != 48)) {
             // Performance degrading hack should not be used?
             if (((getenv("R600_DEBUG") && strstr(getenv("R600_DEBUG"), "notiling")) || (getenv("AMD_DEBUG") && strstr(getenv("AMD_DEBUG"), "notiling"))) &&
                 (PsychPrefStateGet_Verbosity() > 1)) {
@@ -1725,6 +1789,13 @@ psych_bool PsychOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Psyc
             (*windowRecord)->IFIRunningSum = ifi_estimate * minSamples;
         }
 
+        // Record results for the refresh calibration cache, before any correction for flip-frame stereo et al.:
+        calib.ifiEstimate = ifi_estimate;
+        calib.numSamples = numSamples;
+        calib.stddev = stddev;
+        if (did_pageflip) calib.flags |= kPsychCalibDidPageflip;
+        if ((*windowRecord)->specialflags & kPsychBusyWaitForVBLBeforeBufferSwapRequest) calib.flags |= kPsychCalibBusyWaitBeforeSwap;
+
         // Compare ifi_estimate from VBL-Sync against beam estimate. If we are in OpenGL native
         // flip-frame stereo mode, a ifi_estimate approx. 2 times the beamestimate would be valid
         // and we would correct it down to half ifi_estimate. If multiSampling is enabled, it is also
@@ -2176,6 +2247,11 @@ psych_bool PsychOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Psyc
         }
     }
 
+    // Successful full calibration of a cacheable setup without any sync trouble? Store it in the refresh calibration
+    // cache for the next session. Calibrations with trouble are never cached, so a bad estimate can't get reused:
+    if ((calibCacheKey != 0) && !useCachedCalibration && !sync_disaster && !sync_trouble && (calib.ifiEstimate > 0))
+        PsychRefreshCalibrationCacheStore(calibCacheKey, &calib);
+
     if (sync_trouble) {
         // Fail-Safe: Mark VBL-Endline as invalid, so a couple of mechanisms get disabled in Screen('Flip') aka PsychFlipWindowBuffers().
         VBL_Endline = -1;
@@ -2233,6 +2309,10 @@ psych_bool PsychOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Psyc
     if (NULL == (*windowRecord)->flipInfo) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory when trying to malloc() flipInfo struct!");
     memset((*windowRecord)->flipInfo, 0, sizeof(PsychFlipInfoStruct));
     (*windowRecord)->flipInfo->flipwhen = -DBL_MAX;
+    PsychInitMutex(&((*windowRecord)->flipInfo->flipLogLock));
+    PsychInitMutex(&((*windowRecord)->flipInfo->queueLock));
+    PsychInitCondition(&((*windowRecord)->flipInfo->queueNotEmpty), NULL);
+    PsychInitCondition(&((*windowRecord)->flipInfo->queueNotFull), NULL);
 
     // Wait for splashMinDurationSecs, so that the "Welcome" splash screen is
     // displayed at least that long:
@@ -2294,6 +2374,9 @@ void PsychCloseWindow(PsychWindowRecordType *windowRecord)
         // Make sure that OpenGL pipeline is done & idle for this window:
         PsychSetGLContext(windowRecord);
 
+        // Stop movie recording from this window:
+        PsychMovieWritingDetachWindow(windowRecord);
+
         // Execute hook chain for OpenGL related shutdown:
         PsychPipelineExecuteHook(windowRecord, kPsychCloseWindowPreGLShutdown, NULL, NULL, FALSE, FALSE, NULL, NULL, NULL, NULL);
 
@@ -2774,6 +2857,17 @@ void PsychReleaseFlipInfoStruct(PsychWindowRecordType *windowRecord)
         }
     }
 
+    // Present queue active? Discard all not yet presented frames and stop the flipper thread from
+    // serving the queue, so it is back in its idle state for the regular shutdown below:
+    if (flipRequest->queueCapacity > 0) {
+        if (flipRequest->queueSubmitted != flipRequest->queuePresented) {
+            printf("PTB-WARNING: %i queued frames of window %p discarded while Screen('Close') or Screen('CloseAll') was called or\n", (int) (flipRequest->queueSubmitted - flipRequest->queuePresented), windowRecord);
+            printf("PTB-WARNING: exiting from a Screen error!\n");
+        }
+
+        PsychStopPresentQueue(windowRecord, FALSE);
+    }
+
     // Any threads attached?
     if (flipRequest->flipperThread) {
         // Yes. Cancel and destroy / release it, also release all mutex locks:
@@ -2837,6 +2931,16 @@ void PsychReleaseFlipInfoStruct(PsychWindowRecordType *windowRecord)
         // At this point, the thread and all other async flip resources have been terminated and released.
     }
 
+    // Release flip log:
+    free(flipRequest->flipLog);
+    PsychDestroyMutex(&(flipRequest->flipLogLock));
+
+    // Release present queue, now that the flipper thread is gone:
+    PsychSetPresentQueueCapacity(windowRecord, 0);
+    PsychDestroyMutex(&(flipRequest->queueLock));
+    PsychDestroyCondition(&(flipRequest->queueNotEmpty));
+    PsychDestroyCondition(&(flipRequest->queueNotFull));
+
     // Release struct:
     free(flipRequest);
     windowRecord->flipInfo = NULL;
@@ -2845,6 +2949,481 @@ void PsychReleaseFlipInfoStruct(PsychWindowRecordType *windowRecord)
     return;
 }
 
+/* PsychSetFlipLogCapacity() -- (Re-)Allocate or release the flip log of an onscreen window.
+ *
+ * A capacity of zero disables flip logging and releases the log, a positive value allocates
+ * a new log ring for 'capacity' flip records. All not yet fetched records get discarded.
+ * Called from the masterthread, but the log may be appended to concurrently by the flipper thread.
+ */
+void PsychSetFlipLogCapacity(PsychWindowRecordType *windowRecord, int capacity)
+{
+    PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+    double* newLog = NULL;
+
+    if (NULL == flipRequest) return;
+
+    if (capacity > 0) {
+        newLog = (double*) malloc((size_t) capacity * kPsychFlipLogRecordSize * sizeof(double));
+        if (NULL == newLog) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory when trying to allocate flip log!");
+    }
+
+    PsychLockMutex(&(flipRequest->flipLogLock));
+    free(flipRequest->flipLog);
+    flipRequest->flipLog = newLog;
+    flipRequest->flipLogCapacity = (newLog) ? capacity : 0;
+    flipRequest->flipLogWritten = 0;
+    flipRequest->flipLogFetched = 0;
+    PsychUnlockMutex(&(flipRequest->flipLogLock));
+}
+
+/* PsychGetFlipLogCapacity() -- Return capacity of flip log in records, zero if disabled. */
+int PsychGetFlipLogCapacity(PsychWindowRecordType *windowRecord)
+{
+    return((windowRecord->flipInfo) ? windowRecord->flipInfo->flipLogCapacity : 0);
+}
+
+/* PsychGetFlipLogCount() -- Return number of flip log records not yet fetched. */
+int PsychGetFlipLogCount(PsychWindowRecordType *windowRecord)
+{
+    PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+    int count;
+
+    if ((NULL == flipRequest) || (NULL == flipRequest->flipLog)) return(0);
+
+    PsychLockMutex(&(flipRequest->flipLogLock));
+    count = (flipRequest->flipLogWritten - flipRequest->flipLogFetched > (psych_uint64) flipRequest->flipLogCapacity) ?
+            flipRequest->flipLogCapacity : (int) (flipRequest->flipLogWritten - flipRequest->flipLogFetched);
+    PsychUnlockMutex(&(flipRequest->flipLogLock));
+
+    return(count);
+}
+
+/* PsychFetchFlipLog() -- Fetch and consume the 'count' oldest not yet fetched flip log records.
+ *
+ * Records are returned in 'out' as a column-major 'count' by kPsychFlipLogRecordSize matrix, ie.,
+ * one row per flip. 'count' must not exceed a preceding PsychGetFlipLogCount(). Returns the number
+ * of records lost due to ring overflow since the last fetch.
+ */
+int PsychFetchFlipLog(PsychWindowRecordType *windowRecord, int count, double* out)
+{
+    PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+    psych_uint64 lost = 0;
+    double* record;
+    int i, j;
+
+    if ((NULL == flipRequest) || (NULL == flipRequest->flipLog)) return(0);
+
+    PsychLockMutex(&(flipRequest->flipLogLock));
+
+    // Skip records which have been overwritten since the last fetch:
+    if (flipRequest->flipLogWritten - flipRequest->flipLogFetched > (psych_uint64) flipRequest->flipLogCapacity) {
+        lost = flipRequest->flipLogWritten - flipRequest->flipLogFetched - flipRequest->flipLogCapacity;
+        flipRequest->flipLogFetched += lost;
+    }
+
+    for (i = 0; i < count; i++) {
+        record = &(flipRequest->flipLog[((flipRequest->flipLogFetched + i) % flipRequest->flipLogCapacity) * kPsychFlipLogRecordSize]);
+        for (j = 0; j < kPsychFlipLogRecordSize; j++) out[j * count + i] = record[j];
+    }
+    flipRequest->flipLogFetched += count;
+
+    PsychUnlockMutex(&(flipRequest->flipLogLock));
+
+    return((int) lost);
+}
+
+/* PsychAppendToFlipLog() -- Append one record of kPsychFlipLogRecordSize values to the flip log, if enabled.
+ * Called from PsychFlipWindowBuffers(), on the masterthread or on the flipper thread.
+ */
+static void PsychAppendToFlipLog(PsychWindowRecordType *windowRecord, const double* record)
+{
+    PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+
+    // Cheap unlocked early-out if flip logging is disabled:
+    if ((NULL == flipRequest) || (NULL == flipRequest->flipLog)) return;
+
+    PsychLockMutex(&(flipRequest->flipLogLock));
+    if (flipRequest->flipLog) {
+        memcpy(&(flipRequest->flipLog[(flipRequest->flipLogWritten % flipRequest->flipLogCapacity) * kPsychFlipLogRecordSize]), record, kPsychFlipLogRecordSize * sizeof(double));
+        flipRequest->flipLogWritten++;
+    }
+    PsychUnlockMutex(&(flipRequest->flipLogLock));
+}
+
+/* PsychRestoreFinalizedFBOs() -- Undo the redirection of the finalizedFBO's of a window to the FBO's of a
+ * present queue slot, as done by PsychFlipWindowBuffersQueued() during preflip operations. Also called at
+ * queue shutdown, in case a Screen error aborted the preflip operations with the redirection in place.
+ */
+static void PsychRestoreFinalizedFBOs(PsychWindowRecordType *windowRecord)
+{
+    PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+    int viewid;
+
+    for (viewid = 1; viewid >= 0; viewid--) {
+        if (flipRequest->queueSavedFBO[viewid]) {
+            windowRecord->fboTable[windowRecord->finalizedFBO[viewid]] = flipRequest->queueSavedFBO[viewid];
+            flipRequest->queueSavedFBO[viewid] = NULL;
+        }
+    }
+}
+
+/* PsychStopPresentQueue() -- Stop the flipper thread from processing the present queue of an onscreen window.
+ *
+ * If 'drain' is TRUE, waits for presentation of all queued frames first, otherwise all not yet presented frames
+ * get discarded. Waits for completion of the presentation of a frame in progress, but a frame which still waits
+ * for its deadline gets dropped by the flipper thread immediately. Afterwards the flipper thread,
+ * if any, is idle as if it never processed any queued frames, and the masterthread holds its performFlipLock.
+ */
+static void PsychStopPresentQueue(PsychWindowRecordType *windowRecord, psych_bool drain)
+{
+    PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+
+    PsychRestoreFinalizedFBOs(windowRecord);
+
+    PsychLockMutex(&(flipRequest->queueLock));
+
+    while (drain && (flipRequest->flipperState != 4) && (flipRequest->flipperState != 5) && (flipRequest->queuePresented != flipRequest->queueSubmitted))
+        PsychWaitCondition(&(flipRequest->queueNotFull), &(flipRequest->queueLock));
+
+    flipRequest->queueStop = TRUE;
+    PsychSignalCondition(&(flipRequest->queueNotEmpty));
+
+    while (flipRequest->queueBusy)
+        PsychWaitCondition(&(flipRequest->queueNotFull), &(flipRequest->queueLock));
+
+    // Discard all not yet presented frames:
+    flipRequest->queueSubmitted = flipRequest->queuePresented;
+
+    PsychUnlockMutex(&(flipRequest->queueLock));
+
+    // Flipper thread serving the queue from its standard dispatch loop? It is on its way back into
+    // its idle state, waiting on flipperGoGoGo. Wait for it to get there and retake the lock:
+    if (flipRequest->queueServing) {
+        PsychLockMutex(&(flipRequest->performFlipLock));
+        flipRequest->queueServing = FALSE;
+        asyncFlipOpsActive--;
+    }
+
+    PsychLockMutex(&(flipRequest->queueLock));
+    flipRequest->queueStop = FALSE;
+    PsychUnlockMutex(&(flipRequest->queueLock));
+}
+
+/* PsychSetPresentQueueCapacity() -- (Re-)Allocate or release the present queue of an onscreen window.
+ *
+ * A capacity of zero disables the present queue and releases it, a positive value allocates a queue for
+ * 'capacity' frames, each with FBO's of the same size and format as the finalizedFBO's of the imaging pipeline.
+ * A previously enabled queue gets drained first, ie., all its queued frames get presented. All not yet fetched
+ * result records get discarded. Called from the masterthread. Returns the previous capacity.
+ */
+int PsychSetPresentQueueCapacity(PsychWindowRecordType *windowRecord, int capacity)
+{
+    PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+    PsychPresentQueueEntry* newQueue = NULL;
+    double* newResults = NULL;
+    PsychFBO* finalFBO;
+    GLenum format;
+    GLint redbits;
+    int oldCapacity, i, viewid, views;
+    psych_bool ownScheduler;
+
+    if (NULL == flipRequest) return(0);
+    oldCapacity = flipRequest->queueCapacity;
+
+    // Check if the present queue can work on this window:
+    if (capacity > 0) {
+        ownScheduler = (windowRecord->stereomode == kPsychFrameSequentialStereo) || (windowRecord->vrrMode == kPsychVRROwnScheduled);
+
+        if (windowRecord->specialflags & kPsychExternalDisplayMethod)
+            PsychErrorExitMsg(PsychError_user, "The present queue is not supported on windows which use the Vulkan display backend or a XR display backend.");
+
+        if (windowRecord->specialflags & kPsychDontUseFlipperThread)
+            PsychErrorExitMsg(PsychError_user, "The present queue requires the background flipper thread, but this is forbidden for this window due to specialFlags setting kPsychDontUseFlipperThread!");
+
+        if (PsychPrefStateGet_ConserveVRAM() & kPsychUseOldStyleAsyncFlips)
+            PsychErrorExitMsg(PsychError_user, "Tried to use the present queue while Screen('Preference', 'ConserveVRAM') setting kPsychUseOldStyleAsyncFlips is set! Forbidden!");
+
+        if (!(windowRecord->imagingMode & kPsychNeedFastBackingStore) || (windowRecord->drawBufferFBO[0] < 0))
+            PsychErrorExitMsg(PsychError_user, "The present queue requires the imaging pipeline to be enabled, e.g., via PsychImaging('AddTask', 'General', 'UseVirtualFramebuffer');");
+
+        if ((windowRecord->imagingMode & (kPsychNeedFinalizedFBOSinks | kPsychNeedDualWindowOutput)) || (windowRecord->stereomode == kPsychOpenGLStereo) ||
+            (windowRecord->stereomode == kPsychDualWindowStereo) || (windowRecord->stereomode == kPsychDualStreamStereo))
+            PsychErrorExitMsg(PsychError_user, "The present queue is not supported with native quad-buffered stereo, dual-window or dual-stream stereo or output, or external image sinks.");
+
+        if (!ownScheduler && (windowRecord->specialflags & kPsychIsEGLWindow))
+            PsychErrorExitMsg(PsychError_user, "The present queue is not supported on EGL backed windows, unless frame-sequential stereo or our own VRR scheduler is used.");
+
+        if (flipRequest->asyncstate != 0)
+            PsychErrorExitMsg(PsychError_user, "Tried to enable the present queue while an asynchronous flip is in progress! Call Screen('AsyncFlipEnd') first.");
+    }
+
+    // Present all frames from a current queue and stop processing of the queue:
+    if (oldCapacity > 0) PsychStopPresentQueue(windowRecord, TRUE);
+
+    // Release the old queue:
+    if (flipRequest->queue) {
+        PsychSetDrawingTarget((PsychWindowRecordType*) 0x1);
+        PsychSetGLContext(windowRecord);
+
+        for (i = 0; i < oldCapacity; i++) {
+            for (viewid = 0; viewid < 2; viewid++) {
+                if (flipRequest->queue[i].fbo[viewid]) PsychDeleteFBO(flipRequest->queue[i].fbo[viewid]);
+            }
+        }
+    }
+
+    PsychLockMutex(&(flipRequest->queueLock));
+    free(flipRequest->queue);
+    free(flipRequest->queueResults);
+    flipRequest->queue = NULL;
+    flipRequest->queueResults = NULL;
+    flipRequest->queueCapacity = 0;
+    flipRequest->queueSubmitted = 0;
+    flipRequest->queuePresented = 0;
+    flipRequest->queueResultsFetched = 0;
+    PsychUnlockMutex(&(flipRequest->queueLock));
+
+    if (capacity <= 0) return(oldCapacity);
+
+    // Allocate the new queue, with its own FBO's for the final image of each view of each queued frame:
+    newQueue = (PsychPresentQueueEntry*) calloc((size_t) capacity, sizeof(PsychPresentQueueEntry));
+    newResults = (double*) malloc(kPsychPresentQueueResultCapacity * kPsychPresentQueueResultSize * sizeof(double));
+    if ((NULL == newQueue) || (NULL == newResults)) {
+        free(newQueue);
+        free(newResults);
+        PsychErrorExitMsg(PsychError_outofMemory, "Out of memory when trying to allocate present queue!");
+    }
+
+    PsychSetDrawingTarget((PsychWindowRecordType*) 0x1);
+    PsychSetGLContext(windowRecord);
+
+    views = (windowRecord->finalizedFBO[1] != windowRecord->finalizedFBO[0]) ? 2 : 1;
+    for (viewid = 0; viewid < views; viewid++) {
+        finalFBO = windowRecord->fboTable[windowRecord->finalizedFBO[viewid]];
+        format = finalFBO->format;
+
+        // Final target is the system backbuffer? Choose a format of sufficient precision, as imaging pipeline setup would:
+        if (finalFBO->fboid == 0) {
+            glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
+            glGetIntegerv(GL_RED_BITS, &redbits);
+            format = (redbits <= 8) ? GL_RGBA8 : ((windowRecord->gfxcaps & kPsychGfxCapFPFBO32) ? GL_RGBA_FLOAT32_APPLE : GL_RGBA16_SNORM);
+        }
+
+        for (i = 0; i < capacity; i++) {
+            if (!PsychCreateFBO(&(newQueue[i].fbo[viewid]), format, FALSE, finalFBO->width, finalFBO->height, 0, 0)) {
+                for (i = 0; i < capacity; i++) {
+                    if (newQueue[i].fbo[0]) PsychDeleteFBO(newQueue[i].fbo[0]);
+                    if (newQueue[i].fbo[1]) PsychDeleteFBO(newQueue[i].fbo[1]);
+                }
+
+                free(newQueue);
+                free(newResults);
+                PsychErrorExitMsg(PsychError_system, "Could not create framebuffers for the present queue. Maybe out of VRAM? Try a smaller queue capacity.");
+            }
+        }
+    }
+
+    PsychLockMutex(&(flipRequest->queueLock));
+    flipRequest->queue = newQueue;
+    flipRequest->queueResults = newResults;
+    flipRequest->queueCapacity = capacity;
+    flipRequest->queueSystemFBO = windowRecord->fboTable[0];
+    PsychUnlockMutex(&(flipRequest->queueLock));
+
+    return(oldCapacity);
+}
+
+/* PsychGetPresentQueueStatus() -- Return capacity of present queue in frames, zero if disabled.
+ * Also returns the total number of frames submitted to and presented from the queue since it was enabled.
+ */
+int PsychGetPresentQueueStatus(PsychWindowRecordType *windowRecord, psych_uint64* submitted, psych_uint64* presented)
+{
+    PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+    int capacity;
+
+    *submitted = *presented = 0;
+    if (NULL == flipRequest) return(0);
+
+    PsychLockMutex(&(flipRequest->queueLock));
+    capacity = flipRequest->queueCapacity;
+    *submitted = flipRequest->queueSubmitted;
+    *presented = flipRequest->queuePresented;
+    PsychUnlockMutex(&(flipRequest->queueLock));
+
+    return(capacity);
+}
+
+/* PsychGetPresentQueueResultCount() -- Return number of present queue result records not yet fetched. */
+int PsychGetPresentQueueResultCount(PsychWindowRecordType *windowRecord)
+{
+    PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+    int count;
+
+    if ((NULL == flipRequest) || (NULL == flipRequest->queueResults)) return(0);
+
+    PsychLockMutex(&(flipRequest->queueLock));
+    count = (flipRequest->queuePresented - flipRequest->queueResultsFetched > (psych_uint64) kPsychPresentQueueResultCapacity) ?
+            kPsychPresentQueueResultCapacity : (int) (flipRequest->queuePresented - flipRequest->queueResultsFetched);
+    PsychUnlockMutex(&(flipRequest->queueLock));
+
+    return(count);
+}
+
+/* PsychFetchPresentQueueResults() -- Fetch and consume the 'count' oldest not yet fetched result records of presented queued frames.
+ *
+ * Records are returned in 'out' as a column-major 'count' by kPsychPresentQueueResultSize matrix, ie., one row per frame.
+ * 'count' must not exceed a preceding PsychGetPresentQueueResultCount(). Returns the number of records lost due to ring
+ * overflow since the last fetch.
+ */
+int PsychFetchPresentQueueResults(PsychWindowRecordType *windowRecord, int count, double* out)
+{
+    PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+    psych_uint64 lost = 0;
+    double* record;
+    int i, j;
+
+    if ((NULL == flipRequest) || (NULL == flipRequest->queueResults)) return(0);
+
+    PsychLockMutex(&(flipRequest->queueLock));
+
+    // Skip records which have been overwritten since the last fetch:
+    if (flipRequest->queuePresented - flipRequest->queueResultsFetched > (psych_uint64) kPsychPresentQueueResultCapacity) {
+        lost = flipRequest->queuePresented - flipRequest->queueResultsFetched - kPsychPresentQueueResultCapacity;
+        flipRequest->queueResultsFetched += lost;
+    }
+
+    for (i = 0; i < count; i++) {
+        record = &(flipRequest->queueResults[((flipRequest->queueResultsFetched + i) % kPsychPresentQueueResultCapacity) * kPsychPresentQueueResultSize]);
+        for (j = 0; j < kPsychPresentQueueResultSize; j++) out[j * count + i] = record[j];
+    }
+    flipRequest->queueResultsFetched += count;
+
+    PsychUnlockMutex(&(flipRequest->queueLock));
+
+    return((int) lost);
+}
+
+/* PsychGetNextQueuedFrame() -- Called by the flipper thread to get the oldest not yet presented frame of the present queue.
+ *
+ * Returns the frame and marks the queue as busy, or returns NULL if the queue is empty or stopped. If 'wait' is TRUE,
+ * waits for a frame to get queued, unless the queue gets stopped.
+ */
+static PsychPresentQueueEntry* PsychGetNextQueuedFrame(PsychFlipInfoStruct* flipRequest, psych_bool wait)
+{
+    PsychPresentQueueEntry* entry = NULL;
+
+    // Cheap unlocked early-out if the present queue is disabled:
+    if (!wait && (NULL == flipRequest->queue)) return(NULL);
+
+    PsychLockMutex(&(flipRequest->queueLock));
+
+    while (wait && !flipRequest->queueStop && (flipRequest->queuePresented == flipRequest->queueSubmitted))
+        PsychWaitCondition(&(flipRequest->queueNotEmpty), &(flipRequest->queueLock));
+
+    if (!flipRequest->queueStop && (flipRequest->queuePresented != flipRequest->queueSubmitted)) {
+        entry = &(flipRequest->queue[flipRequest->queuePresented % flipRequest->queueCapacity]);
+        flipRequest->queueBusy = TRUE;
+    }
+
+    PsychUnlockMutex(&(flipRequest->queueLock));
+
+    return(entry);
+}
+
+/* PsychCompleteQueuedFrame() -- Called by the flipper thread after presentation of the queued frame 'entry'.
+ *
+ * Appends the results of the frame to the result ring and releases its slot for reuse by the masterthread.
+ */
+static void PsychCompleteQueuedFrame(PsychFlipInfoStruct* flipRequest, PsychPresentQueueEntry* entry)
+{
+    double* record;
+
+    PsychLockMutex(&(flipRequest->queueLock));
+
+    record = &(flipRequest->queueResults[(flipRequest->queuePresented % kPsychPresentQueueResultCapacity) * kPsychPresentQueueResultSize]);
+    record[0] = (double) entry->serial;
+    record[1] = entry->flipwhen;
+    record[2] = entry->vbl_timestamp;
+    record[3] = entry->time_at_onset;
+    record[4] = entry->time_at_flipend;
+    record[5] = entry->miss_estimate;
+    record[6] = (double) entry->beamPosAtFlip;
+
+    flipRequest->queuePresented++;
+    flipRequest->queueBusy = FALSE;
+    PsychSignalCondition(&(flipRequest->queueNotFull));
+
+    PsychUnlockMutex(&(flipRequest->queueLock));
+}
+
+/* PsychDropQueuedFrameIfStopped() -- Called by the flipper thread while it holds a not yet presented queued frame.
+ *
+ * If the queue got stopped in the meantime, the frame gets released without presentation, so a stop which discards
+ * all queued frames doesn't need to wait for the deadline of the frame. Returns TRUE if the frame was dropped, in
+ * which case the caller must not present it anymore. Waits until 'deadline' for a stop, if 'deadline' is in the future.
+ */
+static psych_bool PsychDropQueuedFrameIfStopped(PsychFlipInfoStruct* flipRequest, double deadline)
+{
+    psych_bool stopped;
+    double tnow;
+
+    PsychLockMutex(&(flipRequest->queueLock));
+
+    while (!flipRequest->queueStop) {
+        PsychGetAdjustedPrecisionTimerSeconds(&tnow);
+        if (tnow >= deadline) break;
+        PsychTimedWaitCondition(&(flipRequest->queueNotEmpty), &(flipRequest->queueLock), deadline - tnow);
+    }
+
+    stopped = flipRequest->queueStop;
+    if (stopped) {
+        flipRequest->queueBusy = FALSE;
+        PsychSignalCondition(&(flipRequest->queueNotFull));
+    }
+
+    PsychUnlockMutex(&(flipRequest->queueLock));
+
+    return(stopped);
+}
+
+/* PsychFlipperThreadServeQueue() -- Present queue dispatch loop of the flipper thread for windows without
+ * frame-sequential stereo or our own VRR scheduler: Presents all queued frames back-to-back, each by copying
+ * its image into the system backbuffer and flipping at its requested deadline, until the queue gets stopped.
+ * Called from the standard dispatch loop of the flipper thread, with the performFlipLock held.
+ */
+static void PsychFlipperThreadServeQueue(PsychWindowRecordType *windowRecord)
+{
+    PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+    PsychPresentQueueEntry* entry;
+
+    while ((entry = PsychGetNextQueuedFrame(flipRequest, TRUE))) {
+        PsychTrace(kPsychTraceFlipperWake, windowRecord->windowIndex);
+
+        // Sleep until shortly before the deadline of the frame, but drop the frame if the queue gets stopped meanwhile.
+        // The remaining wait for the deadline is up to the flip, so it can schedule the swap precisely:
+        if (PsychDropQueuedFrameIfStopped(flipRequest, entry->flipwhen - 2 * windowRecord->VideoRefreshInterval))
+            continue;
+
+        // Setup view: We set the full backbuffer area of the window.
+        PsychSetupView(windowRecord, TRUE);
+
+        // Copy image of the queued frame into the system backbuffer:
+        PsychPipelineExecuteHook(windowRecord, kPsychIdentityBlit, NULL, NULL, TRUE, FALSE, &(entry->fbo[0]), NULL, &(flipRequest->queueSystemFBO), NULL);
+
+        // Execute synchronous flip to make it the frontbuffer: This resets the framebuffer binding to 0 at exit:
+        entry->vbl_timestamp = PsychFlipWindowBuffers(windowRecord, 0, entry->vbl_synclevel, 2, entry->flipwhen, &(entry->beamPosAtFlip),
+                                                      &(entry->miss_estimate), &(entry->time_at_flipend), &(entry->time_at_onset));
+
+        // The slot must be consumed before it gets released for refill by the masterthread:
+        glFinish();
+
+        PsychCompleteQueuedFrame(flipRequest, entry);
+    }
+
+    // Need to unbind any FBO's in our context before going idle:
+    if (glBindFramebufferEXT) glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
+}
+
 /* PsychFlipperThreadMain() the "main()" routine of the asynchronous flip worker thread:
 *
 * This routine implements an infinite loop (well, infinite until cancellation at Screen('Close')
@@ -2883,6 +3462,8 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
     int viewid = 0;
     psych_uint64 vblcount = 0;
     psych_uint64 vblqcount = 0;
+    double flipwhen = 0;
+    PsychPresentQueueEntry* queueEntry = NULL;
 
     // Select async flip implementation: Old-Style -- One context for both master-thread and flipper-thread:
     psych_bool oldStyle = (PsychPrefStateGet_ConserveVRAM() & kPsychUseOldStyleAsyncFlips) ? TRUE : FALSE;
@@ -2894,6 +3475,7 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
 
     // Assign a name to ourselves, for debugging:
     PsychSetThreadName("ScreenFlipper");
+    PsychTraceSetThreadName("ScreenFlipper");
 
     // Try to lock, block until available if not available:
     if ((rc=PsychLockMutex(&(flipRequest->performFlipLock)))) {
@@ -2986,8 +3568,18 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
                 break;
             }
 
+            // Request to present the frames of the present queue?
+            if (flipRequest->opmode == 4) {
+                // Serve the queue until the masterthread stops it, then go back to "initialized, ready & waiting":
+                flipRequest->flipperState = 2;
+                PsychFlipperThreadServeQueue(windowRecord);
+                flipRequest->flipperState = 1;
+                continue;
+            }
+
             // Got the lock: Set our state to "executing - flip in progress":
             flipRequest->flipperState = 2;
+            PsychTrace(kPsychTraceFlipperWake, windowRecord->windowIndex);
 
             // fprintf(stdout, "WAITING UNTIL T = %f\n", flipRequest->flipwhen); fflush(NULL);
 
@@ -3069,6 +3661,18 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
 
         // Dispatch loop:
         while (TRUE) {
+            // Present queue enabled? Then the oldest queued frame, if any, is our next work item:
+            if (needWork && (queueEntry = PsychGetNextQueuedFrame(flipRequest, FALSE))) {
+                needWork = FALSE;
+                flipwhen = queueEntry->flipwhen;
+            }
+
+            // Queued frame still waiting for its deadline, but the queue got stopped? Drop it immediately:
+            if (queueEntry && flipRequest->queueStop && PsychDropQueuedFrameIfStopped(flipRequest, 0)) {
+                queueEntry = NULL;
+                needWork = TRUE;
+            }
+
             // Do we need a new flip work item? If so, can we get the lock to check it?
             if (needWork && (PsychTryLockMutex(&(flipRequest->performFlipLock)) == 0)) {
                 // Need new work and got lock.
@@ -3089,6 +3693,7 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
 
                     // Set our state to "executing - flip in progress":
                     flipRequest->flipperState = 2;
+                    flipwhen = flipRequest->flipwhen;
                 }
                 else {
                     // No: Release the lock, so master has a chance to give us new work:
@@ -3108,7 +3713,7 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
             // For performing a "virtual bufferswap" we need a swaprequest to be pending, and the flipwhen deadline being
             // reached, and we need to be on the proper field -- so left-eye stims start always at even (or odd) fields,
             // at the users discretion:
-            if (!needWork && (tnow >= flipRequest->flipwhen) &&
+            if (!needWork && (tnow >= flipwhen) &&
                 ((windowRecord->targetFlipFieldType == -1) || (((vblcount + 1) % 2) == (psych_uint64) windowRecord->targetFlipFieldType))) {
                 // Yes: Time to update the backbuffers with our finalizedFBOs and do
                 // properly scheduled/timestamped bufferswaps:
@@ -3120,12 +3725,17 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
 
                 // Copy viewid-view fbo to backbuffer.
                 // This sets up its viewports, texture and fbo bindings and restores them to pre-exec state:
-                PsychPipelineExecuteHook(windowRecord, kPsychIdentityBlit, NULL, NULL, TRUE, FALSE, &(windowRecord->fboTable[windowRecord->finalizedFBO[viewid]]), NULL,
+                PsychPipelineExecuteHook(windowRecord, kPsychIdentityBlit, NULL, NULL, TRUE, FALSE,
+                                         (queueEntry) ? &(queueEntry->fbo[viewid]) : &(windowRecord->fboTable[windowRecord->finalizedFBO[viewid]]), NULL,
                                          &(windowRecord->fboTable[0]), NULL);
 
                 // Execute synchronous flip to make it the frontbuffer: This resets the framebuffer binding to 0 at exit:
-                flipRequest->vbl_timestamp = PsychFlipWindowBuffers(windowRecord, 0, 0, 2, flipRequest->flipwhen, &(flipRequest->beamPosAtFlip),
-                                                                    &(flipRequest->miss_estimate), &(flipRequest->time_at_flipend), &(flipRequest->time_at_onset));
+                if (queueEntry)
+                    queueEntry->vbl_timestamp = PsychFlipWindowBuffers(windowRecord, 0, 0, 2, flipwhen, &(queueEntry->beamPosAtFlip),
+                                                                       &(queueEntry->miss_estimate), &(queueEntry->time_at_flipend), &(queueEntry->time_at_onset));
+                else
+                    flipRequest->vbl_timestamp = PsychFlipWindowBuffers(windowRecord, 0, 0, 2, flipwhen, &(flipRequest->beamPosAtFlip),
+                                                                        &(flipRequest->miss_estimate), &(flipRequest->time_at_flipend), &(flipRequest->time_at_onset));
 
                 // Trigger an update of the shutters of potentially connected stereo goggles:
                 PsychTriggerShutterGoggles(windowRecord, viewid);
@@ -3135,7 +3745,8 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
 
                 // Copy non-viewid-view fbo to backbuffer.
                 // This sets up its viewports, texture and fbo bindings and restores them to pre-exec state:
-                PsychPipelineExecuteHook(windowRecord, kPsychIdentityBlit, NULL, NULL, TRUE, FALSE, &(windowRecord->fboTable[windowRecord->finalizedFBO[1-viewid]]), NULL,
+                PsychPipelineExecuteHook(windowRecord, kPsychIdentityBlit, NULL, NULL, TRUE, FALSE,
+                                         (queueEntry) ? &(queueEntry->fbo[1-viewid]) : &(windowRecord->fboTable[windowRecord->finalizedFBO[1-viewid]]), NULL,
                                          &(windowRecord->fboTable[0]), NULL);
 
                 // We glFinish() here, to make sure all rendering commands submitted
@@ -3147,17 +3758,24 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
                 // The buffers now contain the new left/right view images and can be simply exchanged
                 // periodically to provide a "static" frame-sequential stimulus to the observer.
 
-                // Set our state to 3 aka "flip operation finished, ready for new commands":
-                flipRequest->flipperState = 3;
-
                 // Compute swap deadline for onset of 2nd view (right eye):
-                tnow = flipRequest->flipwhen + windowRecord->VideoRefreshInterval;
+                tnow = flipwhen + windowRecord->VideoRefreshInterval;
+
+                if (queueEntry) {
+                    // Queued frame is used up: Release its slot for refill by the masterthread:
+                    PsychCompleteQueuedFrame(flipRequest, queueEntry);
+                    queueEntry = NULL;
+                }
+                else {
+                    // Set our state to 3 aka "flip operation finished, ready for new commands":
+                    flipRequest->flipperState = 3;
 
-                // We can release the lock already to unblock the client code on the masterthread,
-                // as it already has access to all timestamps and status information and can start
-                // rendering into the client framebuffers (drawBufferFBOs) already. It could even
-                // already perform new preflip operations, as we're done with the finalizedFBOs:
-                PsychUnlockMutex(&(flipRequest->performFlipLock));
+                    // We can release the lock already to unblock the client code on the masterthread,
+                    // as it already has access to all timestamps and status information and can start
+                    // rendering into the client framebuffers (drawBufferFBOs) already. It could even
+                    // already perform new preflip operations, as we're done with the finalizedFBOs:
+                    PsychUnlockMutex(&(flipRequest->performFlipLock));
+                }
 
                 // Execute synchronous flip to make it the frontbuffer: This resets the framebuffer binding to 0 at exit:
                 PsychFlipWindowBuffers(windowRecord, 0, 0, 2, tnow, &dummy1, &dummy2, &dummy3, &dummy4);
@@ -3236,6 +3854,18 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
 
         // Dispatch loop:
         while (TRUE) {
+            // Present queue enabled? Then the oldest queued frame, if any, is our next work item:
+            if (needWork && (queueEntry = PsychGetNextQueuedFrame(flipRequest, FALSE))) {
+                needWork = FALSE;
+                flipwhen = queueEntry->flipwhen;
+            }
+
+            // Queued frame still waiting for its deadline, but the queue got stopped? Drop it immediately:
+            if (queueEntry && flipRequest->queueStop && PsychDropQueuedFrameIfStopped(flipRequest, 0)) {
+                queueEntry = NULL;
+                needWork = TRUE;
+            }
+
             // Do we need a new vrr flip work item? If so, can we get the lock to check it?
             if (needWork && (PsychTryLockMutex(&(flipRequest->performFlipLock)) == 0)) {
                 // Need new work and got lock.
@@ -3256,6 +3886,7 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
 
                     // Set our state to "executing - flip in progress":
                     flipRequest->flipperState = 2;
+                    flipwhen = flipRequest->flipwhen;
                 }
                 else {
                     // No: Release the lock, so master has a chance to give us new work:
@@ -3277,36 +3908,48 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
 
             // For performing a "virtual bufferswap" we need a swaprequest to be pending,
             // and the flipwhen deadline being reached.
-            if (!needWork && (flipRequest->flipwhen - lastvbl < windowRecord->vrrMaxDuration - windowRecord->vrrLatencyCompensation)) {
+            if (!needWork && (flipwhen - lastvbl < windowRecord->vrrMaxDuration - windowRecord->vrrLatencyCompensation)) {
                 // Yes: Time to update the backbuffers with our finalizedFBOs and do
                 // properly scheduled/timestamped bufferswaps:
 
                 // Copy our virtual backbuffer finalizedFBO[0] fbo to true backbuffer:
                 PsychPipelineExecuteHook(windowRecord, kPsychIdentityBlit, NULL, NULL, TRUE, FALSE,
-                                         &(windowRecord->fboTable[windowRecord->finalizedFBO[0]]), NULL,
+                                         (queueEntry) ? &(queueEntry->fbo[0]) : &(windowRecord->fboTable[windowRecord->finalizedFBO[0]]), NULL,
                                          &(windowRecord->fboTable[0]), NULL);
 
                 // Execute synchronous flip to make it the frontbuffer: This resets the framebuffer binding to 0 at exit:
-                flipRequest->vbl_timestamp = PsychFlipWindowBuffers(windowRecord, 0, 0, 2, flipRequest->flipwhen - windowRecord->vrrLatencyCompensation,
-                                                                    &(flipRequest->beamPosAtFlip), &(flipRequest->miss_estimate),
-                                                                    &(flipRequest->time_at_flipend), &(flipRequest->time_at_onset));
+                if (queueEntry)
+                    queueEntry->vbl_timestamp = PsychFlipWindowBuffers(windowRecord, 0, 0, 2, flipwhen - windowRecord->vrrLatencyCompensation,
+                                                                       &(queueEntry->beamPosAtFlip), &(queueEntry->miss_estimate),
+                                                                       &(queueEntry->time_at_flipend), &(queueEntry->time_at_onset));
+                else
+                    flipRequest->vbl_timestamp = PsychFlipWindowBuffers(windowRecord, 0, 0, 2, flipwhen - windowRecord->vrrLatencyCompensation,
+                                                                        &(flipRequest->beamPosAtFlip), &(flipRequest->miss_estimate),
+                                                                        &(flipRequest->time_at_flipend), &(flipRequest->time_at_onset));
 
                 // We glFinish() here, to make sure all rendering commands submitted
                 // by our OpenGL context are finished. This means the finalizedFBOs are
                 // "used up" for this redraw cycle and ready for refill by the masterthread:
                 glFinish();
 
-                // Set our state to 3 aka "flip operation finished, ready for new commands":
-                flipRequest->flipperState = 3;
+                if (queueEntry) {
+                    // Queued frame is used up: Release its slot for refill by the masterthread:
+                    PsychCompleteQueuedFrame(flipRequest, queueEntry);
+                    queueEntry = NULL;
+                }
+                else {
+                    // Set our state to 3 aka "flip operation finished, ready for new commands":
+                    flipRequest->flipperState = 3;
 
-                // Compute swap deadline for onset of 2nd view (right eye):
-                // tnow = flipRequest->flipwhen + windowRecord->VideoRefreshInterval;
+                    // Compute swap deadline for onset of 2nd view (right eye):
+                    // tnow = flipRequest->flipwhen + windowRecord->VideoRefreshInterval;
 
-                // We can release the lock already to unblock the client code on the masterthread,
-                // as it already has access to all timestamps and status information and can start
-                // rendering into the client framebuffers (drawBufferFBOs) already. It could even
-                // already perform new preflip operations, as we're done with the finalizedFBO:
-                PsychUnlockMutex(&(flipRequest->performFlipLock));
+                    // We can release the lock already to unblock the client code on the masterthread,
+                    // as it already has access to all timestamps and status information and can start
+                    // rendering into the client framebuffers (drawBufferFBOs) already. It could even
+                    // already perform new preflip operations, as we're done with the finalizedFBO:
+                    PsychUnlockMutex(&(flipRequest->performFlipLock));
+                }
 
                 // Ready to accept new work:
                 needWork = TRUE;
@@ -3376,6 +4019,9 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
     // Make sure our thread detaches from its private OpenGL context before it dies:
     PsychOSUnsetGLContext(windowRecord);
 
+    // Release our trace ring for reuse by future threads:
+    PsychTraceDetachThread();
+
     // Need to unlock the mutex:
     if (flipRequest->flipperState == 4) {
         if ((rc=PsychUnlockMutex(&(flipRequest->performFlipLock)))) {
@@ -3395,6 +4041,247 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
     return(NULL);
 }
 
+/* PsychStartFlipperThread() -- Create and startup the flipper thread of an onscreen window at first use.
+ *
+ * Returns with the thread initialized, ready and waiting for work, and the performFlipLock held.
+ */
+static void PsychStartFlipperThread(PsychWindowRecordType *windowRecord)
+{
+    int rc;
+    PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+
+    // printf("IN THREADCREATE\n"); fflush(NULL);
+
+    // Create & Init the two mutexes:
+    if ((rc=PsychInitMutex(&(flipRequest->performFlipLock)))) {
+        printf("PTB-ERROR: In PsychFlipWindowBuffersIndirect(): Could not create performFlipLock mutex lock [%s].\n", strerror(rc));
+        PsychErrorExitMsg(PsychError_system, "Insufficient system ressources for mutex creation as part of flip threading setup!");
+    }
+
+    if ((rc=PsychInitCondition(&(flipRequest->flipperGoGoGo), NULL))) {
+        printf("PTB-ERROR: In PsychFlipWindowBuffersIndirect(): Could not create flipperGoGoGo condition variable [%s].\n", strerror(rc));
+        PsychErrorExitMsg(PsychError_system, "Insufficient system ressources for condition variable creation as part of flip threading setup!");
+    }
+
+    // Set initial thread state to "inactive, not initialized at all":
+    flipRequest->flipperState = 0;
+
+    // Setup for our own framesequential stereo implementation:
+    if (windowRecord->stereomode == kPsychFrameSequentialStereo) {
+        // Increment count of onscreen windows with our own threaded framesequential stereo mode active:
+        frameSeqStereoActive++;
+
+        // Perform setup of shutter goggle driver if needed:
+        PsychSetupShutterGoggles(windowRecord, TRUE);
+    }
+
+    // Setup for our own VRR scheduler implementation:
+    if (windowRecord->vrrMode == kPsychVRROwnScheduled) {
+        vrrSchedulersActive++;
+
+        if (PsychPrefStateGet_Verbosity() > 2)
+            printf("PTB-INFO: Switching stimulus onset scheduling to use of our own VRR scheduler.\n");
+    }
+
+    // Create and startup thread:
+    if ((rc=PsychCreateThread(&(flipRequest->flipperThread), NULL, PsychFlipperThreadMain, (void*) windowRecord))) {
+        printf("PTB-ERROR: In PsychFlipWindowBuffersIndirect(): Could not create flipper  [%s].\n", strerror(rc));
+        PsychErrorExitMsg(PsychError_system, "Insufficient system ressources for thread creation as part of flip threading setup!");
+    }
+
+    // Additionally try to schedule flipperThread MMCSS: This will lift it roughly into the
+    // same scheduling range as HIGH_PRIORITY_CLASS, even if we are non-admin users
+    // on Vista and Windows-7 and later, however with a scheduler safety net applied.
+    // For some braindead reasons, apparently only one thread can be scheduled in class 10,
+    // so we need to make sure the masterthread is not MMCSS scheduled, otherwise our new
+    // request will fail:
+    if (PSYCH_SYSTEM == PSYCH_WINDOWS) {
+        // On Windows, we have to set flipperThread to +2 RT priority levels while
+        // throwing ourselves off RT priority scheduling. This is a brain-dead requirement
+        // of Vista et al's MMCSS scheduler which only allows one of our threads being
+        // scheduled like that :( -- Disable RT scheduling for ourselves (masterthread):
+        PsychSetThreadPriority((psych_thread*) 0x1, 0, 0);
+    }
+
+    // Boost priority of flipperThread by 2 levels and switch it to RT scheduling,
+    // unless it is already RT-Scheduled. As the thread inherited our scheduling
+    // priority from PsychCreateThread(), we only need to +2 tweak it from there:
+    // Note: On OS/X this means ultra-low latency non-preemptible operation (as we need), with up to
+    // 3 msecs uninterrupted computation time out of 10 msecs if we really need it. Normally we can
+    // get along with << 1 msec, but some pathetic cases of GPU driver bugs could drive it up to 3 msecs
+    // in the async flipper thread:
+    PsychSetThreadPriority(&(flipRequest->flipperThread), 10, 2);
+
+    // The thread is started with flipperState == 0, ie., not "initialized and ready", the lock is unlocked.
+    // First thing the thread will do is try to lock the lock, then set its flipperState to 1 == initialized and
+    // ready, then init itself, then enter a wait on our flipperGoGoGo condition variable and atomically unlock
+    // the lock.
+    // We now need to try to acquire the lock, then - after we got it - check if we got it because we were faster
+    // than the flipperThread and he didn't have a chance to get it (iff flipperState still == 0) - in which case
+    // we need to release the lock, wait a bit and then retry a lock->check->sleep->unlock->... cycle. If we got it
+    // because flipperState == 1 then this means the thread had the lock, initialized itself, set its state to ready
+    // and went sleeping and releasing the lock (that's why we could lock it). In that case, the thread is ready to
+    // do work for us and is just waiting for us. At that point we: a) Have the lock, b) can trigger the thread via
+    // condition variable to do work for us. That's the condition we want and we can proceed as in the non-firsttimeinit
+    // case...
+    while (TRUE) {
+        // Try to lock, block until available if not available:
+
+        //printf("ENTERING THREADCREATEFINISHED MUTEX: MUTEX_LOCK\n"); fflush(NULL);
+
+        if ((rc=PsychLockMutex(&(flipRequest->performFlipLock)))) {
+            printf("PTB-ERROR: In PsychFlipWindowBuffersIndirect(): First mutex_lock in init failed  [%s].\n", strerror(rc));
+            PsychErrorExitMsg(PsychError_system, "Internal error or deadlock avoided as part of flip threading setup!");
+        }
+
+        //printf("ENTERING THREADCREATEFINISHED MUTEX: MUTEX_LOCKED!\n"); fflush(NULL);
+
+        // Got it! Check condition:
+        if (flipRequest->flipperState == 1 || flipRequest->flipperState == 6) {
+            // Thread ready and we have the lock: Proceed...
+            break;
+        }
+
+        //printf("ENTERING THREADCREATEFINISHED MUTEX: MUTEX_UNLOCK\n"); fflush(NULL);
+
+        if ((rc=PsychUnlockMutex(&(flipRequest->performFlipLock)))) {
+            printf("PTB-ERROR: In PsychFlipWindowBuffersIndirect(): First mutex_unlock in init failed  [%s].\n", strerror(rc));
+            PsychErrorExitMsg(PsychError_system, "Internal error or deadlock avoided as part of flip threading setup!");
+        }
+
+        //printf("ENTERING THREADCREATEFINISHED MUTEX: MUTEX_UNLOCKED\n"); fflush(NULL);
+
+        // Thread not ready. Sleep a millisecond and repeat...
+        PsychYieldIntervalSeconds(0.001);
+
+        //printf("ENTERING THREADCREATEFINISHED MUTEX: RETRY\n"); fflush(NULL);
+    }
+
+    // On our VRR scheduler, give the VRR machinery some time to stabilize:
+    if (windowRecord->vrrMode == kPsychVRROwnScheduled)
+        PsychYieldIntervalSeconds(2);
+
+    // End of first-time init for this windowRecord and its thread.
+
+    // printf("FIRST TIME INIT DONE\n"); fflush(NULL);
+}
+
+/* PsychFlipWindowBuffersQueued() -- Implementation of PsychFlipWindowBuffersIndirect() while the present queue is enabled.
+ *
+ * opmode 0 and 1 finalize the current frame into a free slot of the present queue, only blocking while the queue
+ * is full, and enqueue it for presentation by the flipper thread at its requested deadline. Then the drawBufferFBO's
+ * are immediately ready for drawing the next frame. opmode 0 also waits for presentation of the frame. opmode 2
+ * waits for presentation of all queued frames, opmode 3 polls for it. The flipRequest return arguments receive the
+ * results of the most recently presented queued frame.
+ *
+ * Returns TRUE on success, FALSE if a poll in opmode 3 found queued frames still pending.
+ */
+static psych_bool PsychFlipWindowBuffersQueued(PsychWindowRecordType *windowRecord)
+{
+    PsychFlipInfoStruct* flipRequest = windowRecord->flipInfo;
+    PsychPresentQueueEntry* entry;
+    psych_uint64 serial = 0;
+    psych_bool isDone;
+    double* record;
+    int opmode = flipRequest->opmode;
+    int viewid, views;
+
+    if ((opmode == 0) || (opmode == 1)) {
+        // Current multiflip > 0 implementation is not thread-safe, so we don't support this:
+        if (flipRequest->multiflip != 0) PsychErrorExitMsg(PsychError_user, "Using a non-zero 'multiflip' flag while the present queue is enabled! This is forbidden! Aborted.\n");
+
+        // First use of the flipper thread? Start it up, detached from our context as for a first async flip:
+        if (flipRequest->flipperThread == (psych_thread) NULL) {
+            PsychSetDrawingTarget((PsychWindowRecordType*) 0x1);
+            PsychOSUnsetGLContext(windowRecord);
+            PsychStartFlipperThread(windowRecord);
+        }
+
+        // Without frame-sequential stereo or our own VRR scheduler, the flipper thread is waiting in its standard
+        // dispatch loop for work, and we hold the lock. Hand it over to serving the present queue until stopped:
+        if (!flipRequest->queueServing && (windowRecord->stereomode != kPsychFrameSequentialStereo) && (windowRecord->vrrMode != kPsychVRROwnScheduled)) {
+            flipRequest->queueServing = TRUE;
+            asyncFlipOpsActive++;
+
+            flipRequest->opmode = 4;
+            flipRequest->flipperState = 1;
+            PsychSignalCondition(&(flipRequest->flipperGoGoGo));
+            PsychUnlockMutex(&(flipRequest->performFlipLock));
+        }
+
+        // Wait for a free slot in the queue, if the queue is full:
+        PsychLockMutex(&(flipRequest->queueLock));
+        while (flipRequest->queueSubmitted - flipRequest->queuePresented >= (psych_uint64) flipRequest->queueCapacity)
+            PsychWaitCondition(&(flipRequest->queueNotFull), &(flipRequest->queueLock));
+
+        entry = &(flipRequest->queue[flipRequest->queueSubmitted % flipRequest->queueCapacity]);
+        PsychUnlockMutex(&(flipRequest->queueLock));
+
+        // PsychPreflip operations are not thread-safe due to possible callbacks into runtime interpreter thread
+        // as part of hookchain processing, so we perform them here. The final image gets redirected into the
+        // slot by temporarily substituting its FBO's for the finalizedFBO's of the imaging pipeline:
+        views = (windowRecord->finalizedFBO[1] != windowRecord->finalizedFBO[0]) ? 2 : 1;
+        for (viewid = 0; viewid < views; viewid++) {
+            flipRequest->queueSavedFBO[viewid] = windowRecord->fboTable[windowRecord->finalizedFBO[viewid]];
+            windowRecord->fboTable[windowRecord->finalizedFBO[viewid]] = entry->fbo[viewid];
+        }
+
+        PsychPreFlipOperations(windowRecord, flipRequest->dont_clear);
+        PsychRestoreFinalizedFBOs(windowRecord);
+
+        // The slot must be ready for immediate consumption by the flipper thread without blocking it,
+        // also because the flipper thread reads it from its own OpenGL context:
+        glFinish();
+
+        // Enqueue the frame:
+        entry->flipwhen = flipRequest->flipwhen;
+        entry->vbl_synclevel = flipRequest->vbl_synclevel;
+
+        PsychLockMutex(&(flipRequest->queueLock));
+        serial = entry->serial = ++(flipRequest->queueSubmitted);
+        PsychSignalCondition(&(flipRequest->queueNotEmpty));
+        PsychUnlockMutex(&(flipRequest->queueLock));
+
+        // The frame is out of our hands, so prepare the drawBufferFBO's for drawing of the next frame right away:
+        PsychPostFlipOperations(windowRecord, flipRequest->dont_clear);
+
+        // Reset flags used for avoiding redundant Pipeline flushes and backbuffer-backups:
+        windowRecord->PipelineFlushDone = false;
+        windowRecord->backBufferBackupDone = false;
+
+        // Call hookchain with callbacks to be performed after successfull flip completion:
+        PsychPipelineExecuteHook(windowRecord, kPsychScreenFlipImpliedOperations, NULL, NULL, FALSE, FALSE, NULL, NULL, NULL, NULL);
+    }
+
+    PsychLockMutex(&(flipRequest->queueLock));
+
+    // Synchronous flip waits for presentation of its frame, an async flip end for presentation of all queued frames:
+    if ((opmode == 0) || (opmode == 2)) {
+        serial = (opmode == 0) ? serial : flipRequest->queueSubmitted;
+        while ((flipRequest->queuePresented < serial) && (flipRequest->flipperState != 4) && (flipRequest->flipperState != 5))
+            PsychWaitCondition(&(flipRequest->queueNotFull), &(flipRequest->queueLock));
+    }
+
+    isDone = (opmode != 3) || (flipRequest->queuePresented == flipRequest->queueSubmitted);
+
+    // Return results of the most recently presented queued frame, or a zero vbl_timestamp if there isn't any yet:
+    if (flipRequest->queuePresented > 0) {
+        record = &(flipRequest->queueResults[((flipRequest->queuePresented - 1) % kPsychPresentQueueResultCapacity) * kPsychPresentQueueResultSize]);
+        flipRequest->vbl_timestamp = record[2];
+        flipRequest->time_at_onset = record[3];
+        flipRequest->time_at_flipend = record[4];
+        flipRequest->miss_estimate = record[5];
+        flipRequest->beamPosAtFlip = (int) record[6];
+    }
+    else {
+        flipRequest->vbl_timestamp = 0;
+    }
+
+    PsychUnlockMutex(&(flipRequest->queueLock));
+
+    return(isDone);
+}
+
 /*    PsychFlipWindowBuffersIndirect()
  *
  *    This is a wrapper around PsychFlipWindowBuffers(); which gets all flip request parameters
@@ -3417,6 +4304,8 @@ void* PsychFlipperThreadMain(void* windowRecordToCast)
  *    flipRequest->opmode can be one of:
  *    0 = Execute Synchronous flip, 1 = Start async flip, 2 = Finish async flip, 3 = Poll for finish of async flip.
  *
+ *    If the present queue of the window is enabled, all requests are handled by PsychFlipWindowBuffersQueued() instead.
+ *
  *    *   Synchronous flips are performed without changing the mutex lock flipRequest->performFlipLock. We check if
  *        there are not flip ops scheduled or executing for the window, then simply execute the flip and return its
  *        results, if none are active.
@@ -3467,6 +4356,9 @@ psych_bool PsychFlipWindowBuffersIndirect(PsychWindowRecordType *windowRecord)
     flipRequest = windowRecord->flipInfo;
     if (NULL == flipRequest) PsychErrorExitMsg(PsychError_internal, "NULL-Ptr for 'flipRequest' field of windowRecord passed in PsychFlipWindowsIndirect()!!");
 
+    // Present queue enabled? Then all flips go through the queue:
+    if (flipRequest->queueCapacity > 0) return(PsychFlipWindowBuffersQueued(windowRecord));
+
     // Synchronous flip requested?
     if ((flipRequest->opmode == 0) && (windowRecord->stereomode != kPsychFrameSequentialStereo) && (windowRecord->vrrMode != kPsychVRROwnScheduled)) {
         // Yes. Any pending operation in progress?
@@ -3546,121 +4438,7 @@ psych_bool PsychFlipWindowBuffersIndirect(PsychWindowRecordType *windowRecord)
         // First time async request? Threads already set up?
         if (flipRequest->flipperThread == (psych_thread) NULL) {
             // First time init: Need to startup flipper thread:
-
-            // printf("IN THREADCREATE\n"); fflush(NULL);
-
-            // Create & Init the two mutexes:
-            if ((rc=PsychInitMutex(&(flipRequest->performFlipLock)))) {
-                printf("PTB-ERROR: In PsychFlipWindowBuffersIndirect(): Could not create performFlipLock mutex lock [%s].\n", strerror(rc));
-                PsychErrorExitMsg(PsychError_system, "Insufficient system ressources for mutex creation as part of flip threading setup!");
-            }
-
-            if ((rc=PsychInitCondition(&(flipRequest->flipperGoGoGo), NULL))) {
-                printf("PTB-ERROR: In PsychFlipWindowBuffersIndirect(): Could not create flipperGoGoGo condition variable [%s].\n", strerror(rc));
-                PsychErrorExitMsg(PsychError_system, "Insufficient system ressources for condition variable creation as part of flip threading setup!");
-            }
-
-            // Set initial thread state to "inactive, not initialized at all":
-            flipRequest->flipperState = 0;
-
-            // Setup for our own framesequential stereo implementation:
-            if (windowRecord->stereomode == kPsychFrameSequentialStereo) {
-                // Increment count of onscreen windows with our own threaded framesequential stereo mode active:
-                frameSeqStereoActive++;
-
-                // Perform setup of shutter goggle driver if needed:
-                PsychSetupShutterGoggles(windowRecord, TRUE);
-            }
-
-            // Setup for our own VRR scheduler implementation:
-            if (windowRecord->vrrMode == kPsychVRROwnScheduled) {
-                vrrSchedulersActive++;
-
-                if (PsychPrefStateGet_Verbosity() > 2)
-                    printf("PTB-INFO: Switching stimulus onset scheduling to use of our own VRR scheduler.\n");
-            }
-
-            // Create and startup thread:
-            if ((rc=PsychCreateThread(&(flipRequest->flipperThread), NULL, PsychFlipperThreadMain, (void*) windowRecord))) {
-                printf("PTB-ERROR: In PsychFlipWindowBuffersIndirect(): Could not create flipper  [%s].\n", strerror(rc));
-                PsychErrorExitMsg(PsychError_system, "Insufficient system ressources for thread creation as part of flip threading setup!");
-            }
-
-            // Additionally try to schedule flipperThread MMCSS: This will lift it roughly into the
-            // same scheduling range as HIGH_PRIORITY_CLASS, even if we are non-admin users
-            // on Vista and Windows-7 and later, however with a scheduler safety net applied.
-            // For some braindead reasons, apparently only one thread can be scheduled in class 10,
-            // so we need to make sure the masterthread is not MMCSS scheduled, otherwise our new
-            // request will fail:
-            if (PSYCH_SYSTEM == PSYCH_WINDOWS) {
-                // On Windows, we have to set flipperThread to +2 RT priority levels while
-                // throwing ourselves off RT priority scheduling. This is a brain-dead requirement
-                // of Vista et al's MMCSS scheduler which only allows one of our threads being
-                // scheduled like that :( -- Disable RT scheduling for ourselves (masterthread):
-                PsychSetThreadPriority((psych_thread*) 0x1, 0, 0);
-            }
-
-            // Boost priority of flipperThread by 2 levels and switch it to RT scheduling,
-            // unless it is already RT-Scheduled. As the thread inherited our scheduling
-            // priority from PsychCreateThread(), we only need to +2 tweak it from there:
-            // Note: On OS/X this means ultra-low latency non-preemptible operation (as we need), with up to
-            // 3 msecs uninterrupted computation time out of 10 msecs if we really need it. Normally we can
-            // get along with << 1 msec, but some pathetic cases of GPU driver bugs could drive it up to 3 msecs
-            // in the async flipper thread:
-            PsychSetThreadPriority(&(flipRequest->flipperThread), 10, 2);
-
-            // The thread is started with flipperState == 0, ie., not "initialized and ready", the lock is unlocked.
-            // First thing the thread will do is try to lock the lock, then set its flipperState to 1 == initialized and
-            // ready, then init itself, then enter a wait on our flipperGoGoGo condition variable and atomically unlock
-            // the lock.
-            // We now need to try to acquire the lock, then - after we got it - check if we got it because we were faster
-            // than the flipperThread and he didn't have a chance to get it (iff flipperState still == 0) - in which case
-            // we need to release the lock, wait a bit and then retry a lock->check->sleep->unlock->... cycle. If we got it
-            // because flipperState == 1 then this means the thread had the lock, initialized itself, set its state to ready
-            // and went sleeping and releasing the lock (that's why we could lock it). In that case, the thread is ready to
-            // do work for us and is just waiting for us. At that point we: a) Have the lock, b) can trigger the thread via
-            // condition variable to do work for us. That's the condition we want and we can proceed as in the non-firsttimeinit
-            // case...
-            while (TRUE) {
-                // Try to lock, block until available if not available:
-
-                //printf("ENTERING THREADCREATEFINISHED MUTEX: MUTEX_LOCK\n"); fflush(NULL);
-
-                if ((rc=PsychLockMutex(&(flipRequest->performFlipLock)))) {
-                    printf("PTB-ERROR: In PsychFlipWindowBuffersIndirect(): First mutex_lock in init failed  [%s].\n", strerror(rc));
-                    PsychErrorExitMsg(PsychError_system, "Internal error or deadlock avoided as part of flip threading setup!");
-                }
-
-                //printf("ENTERING THREADCREATEFINISHED MUTEX: MUTEX_LOCKED!\n"); fflush(NULL);
-
-                // Got it! Check condition:
-                if (flipRequest->flipperState == 1 || flipRequest->flipperState == 6) {
-                    // Thread ready and we have the lock: Proceed...
-                    break;
-                }
-
-                //printf("ENTERING THREADCREATEFINISHED MUTEX: MUTEX_UNLOCK\n"); fflush(NULL);
-
-                if ((rc=PsychUnlockMutex(&(flipRequest->performFlipLock)))) {
-                    printf("PTB-ERROR: In PsychFlipWindowBuffersIndirect(): First mutex_unlock in init failed  [%s].\n", strerror(rc));
-                    PsychErrorExitMsg(PsychError_system, "Internal error or deadlock avoided as part of flip threading setup!");
-                }
-
-                //printf("ENTERING THREADCREATEFINISHED MUTEX: MUTEX_UNLOCKED\n"); fflush(NULL);
-
-                // Thread not ready. Sleep a millisecond and repeat...
-                PsychYieldIntervalSeconds(0.001);
-
-                //printf("ENTERING THREADCREATEFINISHED MUTEX: RETRY\n"); fflush(NULL);
-            }
-
-            // On our VRR scheduler, give the VRR machinery some time to stabilize:
-            if (windowRecord->vrrMode == kPsychVRROwnScheduled)
-                PsychYieldIntervalSeconds(2);
-
-            // End of first-time init for this windowRecord and its thread.
-
-            // printf("FIRST TIME INIT DONE\n"); fflush(NULL);
+            PsychStartFlipperThread(windowRecord);
         }
 
         // Our flipperThread is ready to do work for us (waiting on flipperGoGoGo condition variable) and
@@ -3920,7 +4698,8 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
     unsigned int targetSwapFlags;
     double targetWhen;            // Target time for OS-Builtin swap scheduling.
     double tSwapComplete;        // Swap completion timestamp for OS-Builtin timestamping.
-    psych_int64 swap_msc;        // Swap completion vblank count for OS-Builtin timestamping.
+    psych_int64 swap_msc = -1;   // Swap completion vblank count for OS-Builtin timestamping.
+    double flipLogRecord[kPsychFlipLogRecordSize];
 
     int vbltimestampmode = PsychPrefStateGet_VBLTimestampingMode();
     PsychWindowRecordType **windowRecordArray=NULL;
@@ -3940,6 +4719,8 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
     if (windowRecord->windowType!=kPsychDoubleBufferOnscreen)
         PsychErrorExitMsg(PsychError_internal,"Attempt to swap a single window buffer");
 
+    PsychTrace(kPsychTraceFlipBegin, windowRecord->windowIndex);
+
     // Retrieve estimate of interframe flip-interval:
     if (windowRecord->nrIFISamples > 0) {
         currentflipestimate=windowRecord->IFIRunningSum / ((double) windowRecord->nrIFISamples);
@@ -4456,6 +5237,7 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
 
     // Take postswap request timestamp:
     PsychGetAdjustedPrecisionTimerSeconds(&time_post_swaprequest);
+    PsychTrace(kPsychTraceSwapRequest, windowRecord->windowIndex);
 
     // Store timestamp of swaprequest submission:
     windowRecord->time_at_swaprequest = time_at_swaprequest;
@@ -4627,6 +5409,7 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
 
         // Store timestamp "as is" so we have the raw value for benchmarking and testing purpose as well:
         time_at_swapcompletion = time_at_vbl;
+        PsychTrace(kPsychTraceSwapComplete, windowRecord->windowIndex);
 
         // Run kernel-level timestamping always in modes 2 and 3 or on demand in mode 1 if beampos.
         // queries don't work properly or mode 4 if both beampos timestamping and OS-Builtin timestamping
@@ -5204,6 +5987,28 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
     // We take a second timestamp here to mark the end of the Flip-routine and return it to "userspace"
     PsychGetAdjustedPrecisionTimerSeconds(time_at_flipend);
 
+    // Append full timing record of this flip to the flip log, if enabled:
+    if (windowRecord->flipInfo && windowRecord->flipInfo->flipLog) {
+        flipLogRecord[0] = (double) windowRecord->flipCount;
+        flipLogRecord[1] = (windowRecord->vrrMode == kPsychVRROwnScheduled) ? flipwhen + windowRecord->vrrLatencyCompensation : flipwhen;
+        flipLogRecord[2] = (windowRecord->vrrMode == kPsychVRROwnScheduled) ? flipwhen : -1;
+        flipLogRecord[3] = (osspecific_asyncflip_scheduled) ? targetWhen : -1;
+        flipLogRecord[4] = time_at_vbl;
+        flipLogRecord[5] = *time_at_onset;
+        flipLogRecord[6] = *time_at_flipend;
+        flipLogRecord[7] = *miss_estimate;
+        flipLogRecord[8] = (double) *beamPosAtFlip;
+        flipLogRecord[9] = time_at_swaprequest;
+        flipLogRecord[10] = time_post_swaprequest;
+        flipLogRecord[11] = time_at_swapcompletion;
+        flipLogRecord[12] = (double) swap_msc;
+        flipLogRecord[13] = (double) windowRecord->swapcompletiontype;
+        flipLogRecord[14] = (PsychIsMasterThread()) ? 0 : 1;
+        PsychAppendToFlipLog(windowRecord, flipLogRecord);
+    }
+
+    PsychTrace(kPsychTraceFlipEnd, windowRecord->windowIndex);
+
     // Done. Return high resolution system time in seconds when VBL happened.
     return(time_at_vbl);
 }
@@ -5793,6 +6598,8 @@ void PsychPreFlipOperations(PsychWindowRecordType *windowRecord, int clearmode)
     // We also reject any request not coming from the master thread:
     if (!PsychIsMasterThread()) return;
 
+    PsychTrace(kPsychTracePreFlipBegin, windowRecord->windowIndex);
+
     // Peform extensive checking for OpenGL errors, unless instructed not to do so:
     if (!(PsychPrefStateGet_ConserveVRAM() & kPsychAvoidCPUGPUSync)) {
         GLenum glerr;
@@ -5826,7 +6633,10 @@ void PsychPreFlipOperations(PsychWindowRecordType *windowRecord, int clearmode)
     PsychPipelineExecuteHook(windowRecord, kPsychUserspaceBufferDrawingFinished, NULL, NULL, FALSE, FALSE, NULL, NULL, NULL, NULL);
 
     // We stop processing here if window is a texture, aka offscreen window...
-    if (windowRecord->windowType==kPsychTexture) return;
+    if (windowRecord->windowType==kPsychTexture) {
+        PsychTrace(kPsychTracePreFlipEnd, windowRecord->windowIndex);
+        return;
+    }
 
     #if PSYCH_SYSTEM == PSYCH_WINDOWS
         // Enforce a one-shot GUI event queue dispatch via this dummy call to PsychGetMouseButtonState() to
@@ -6325,6 +7135,9 @@ void PsychPreFlipOperations(PsychWindowRecordType *windowRecord, int clearmode)
         }
     }    // End of preflip operations for imaging mode:
 
+    // Final image of this flip is ready: Add it to movies which record the flips of this window:
+    PsychMovieWritingCaptureFlip(windowRecord);
+
     // Tell Flip that backbuffer backup has been done already to avoid redundant backups. This is a bit of a
     // unlucky name. It actually signals that all the preflip processing has been done, the old name is historical.
     windowRecord->backBufferBackupDone = true;
@@ -6360,6 +7173,8 @@ void PsychPreFlipOperations(PsychWindowRecordType *windowRecord, int clearmode)
         PsychTestForGLErrors();
     }
 
+    PsychTrace(kPsychTracePreFlipEnd, windowRecord->windowIndex);
+
     return;
 }
 
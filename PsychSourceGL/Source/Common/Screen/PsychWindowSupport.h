@@ -51,6 +51,14 @@ void    PsychSwitchFixedFunctionStereoDrawbuffer(PsychWindowRecordType *windowRe
 int     PsychRessourceCheckAndReminder(psych_bool displayMessage);
 psych_bool PsychFlipWindowBuffersIndirect(PsychWindowRecordType *windowRecord);
 void    PsychReleaseFlipInfoStruct(PsychWindowRecordType *windowRecord);
+void    PsychSetFlipLogCapacity(PsychWindowRecordType *windowRecord, int capacity);
+int     PsychGetFlipLogCapacity(PsychWindowRecordType *windowRecord);
+int     PsychGetFlipLogCount(PsychWindowRecordType *windowRecord);
+int     PsychFetchFlipLog(PsychWindowRecordType *windowRecord, int count, double* out);
+int     PsychSetPresentQueueCapacity(PsychWindowRecordType *windowRecord, int capacity);
+int     PsychGetPresentQueueStatus(PsychWindowRecordType *windowRecord, psych_uint64* submitted, psych_uint64* presented);
+int     PsychGetPresentQueueResultCount(PsychWindowRecordType *windowRecord);
+int     PsychFetchPresentQueueResults(PsychWindowRecordType *windowRecord, int count, double* out);
 int     PsychSetShader(PsychWindowRecordType *windowRecord, int shader);
 void    PsychDetectAndAssignGfxCapabilities(PsychWindowRecordType *windowRecord);
 void    PsychExecuteBufferSwapPrefix(PsychWindowRecordType *windowRecord);
@@ -106,6 +106,9 @@ PsychError PsychModuleInit(void)
     // variable has been set for low-level debugging purposes.
     PrepareScreenPreferences();
 
+    // Initialize event tracing for Screen('TraceBuffer'):
+    PsychTraceInit();
+
     // This little Screen reloading gem disabled, as it is bad, bad, bad!
     // Wasn't useful for exporting ConsoleInputHelper(), as that approach proved
     // way too fragile. Additionally it now causes trouble with some workaround for
@@ -296,6 +299,14 @@ PsychError PsychModuleInit(void)
     PsychErrorExit(PsychRegister("TextTransform", &SCREENTextTransform));
     PsychErrorExit(PsychRegister("ConstrainCursor", &SCREENConstrainCursor));
     PsychErrorExit(PsychRegister("ReadHDRImage", &SCREENReadHDRImage));
+    PsychErrorExit(PsychRegister("MakeTextureAtlas", &SCREENMakeTextureAtlas));
+    PsychErrorExit(PsychRegister("TraceBuffer", &SCREENTraceBuffer));
+    PsychErrorExit(PsychRegister("GetFlipLog", &SCREENGetFlipLog));
+    PsychErrorExit(PsychRegister("PresentQueue", &SCREENPresentQueue));
+    PsychErrorExit(PsychRegister("GetMovieStatistics", &SCREENGetMovieStatistics));
+    PsychErrorExit(PsychRegister("PrepareText", &SCREENPrepareText));
+    PsychErrorExit(PsychRegister("DrawPreparedText", &SCREENDrawPreparedText));
+    PsychErrorExit(PsychRegister("TextCache", &SCREENTextCache));
 
     PsychSetModuleAuthorByInitials("awi");
     PsychSetModuleAuthorByInitials("dhb");
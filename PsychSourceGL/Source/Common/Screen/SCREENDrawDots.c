@@ -6,6 +6,7 @@
             kas@princeton.edu               kas     Keith Schneider
             fcalabro@bu.edu                 fjc     Finnegan Calabro
             mario.kleiner.de@gmail.com      mk      Mario Kleiner
+            agent@local                     ag      agent
 
         PLATFORMS:
 
@@ -46,6 +47,7 @@
             3/22/05         mk      Added possibility to spec vectors with individual color and size spec per dot.
             4/29/05         mk      Bugfix for color vectors: They should also take values in range 0-255 instead of 0.0-1.0.
             11/14/06        mk      We now also accept color vectors in uint8 format and pass them directly for higher efficiency.
+            10/19/26        ag      Also accept color vectors in single() format and pass them directly if possible.
 */
 
 #include "Screen.h"
@@ -132,7 +134,9 @@ static char synopsisString[] =
 "\"color\" is the the clut index (scalar or [r g b a] vector) "
 "that you want to poke into each dot pixel (default is black).  "
 "Instead of a single \"color\" you can also provide a 3 or 4 row vector,"
-"which specifies an individual RGB or RGBA color for each corresponding point.\n"
+"which specifies an individual RGB or RGBA color for each corresponding point. "
+"Color vectors of uint8() or single() type are passed to the graphics card without any "
+"conversion, for single() if the color range of the window is 0.0 - 1.0.\n"
 "\"dot_type\" is a flag that determines what type of dot is drawn: "
 "0 (default) and 4 draw square dots, whereas 1, 2 and 3 draw round dots (circles) with anti-aliasing: "
 "1 favors performance, 2 tries to use high-quality anti-aliasing, if supported by your hardware. "
@@ -157,7 +161,7 @@ PsychError SCREENDrawDots(void)
     PsychWindowRecordType                   *windowRecord, *parentWindowRecord;
     int                                     m,n,p,mc,nc,idot_type;
     int                                     i, nrpoints, nrsize;
-    psych_bool                              isArgThere, usecolorvector;
+    psych_bool                              isArgThere, usecolorvector, floatcolors;
     double                                  *xy, *size, *center, *dot_type, *colors;
     float                                   *sizef;
     unsigned char                           *bytecolors;
@@ -222,7 +226,7 @@ PsychError SCREENDrawDots(void)
     colors = NULL;
     bytecolors = NULL;
 
-    PsychPrepareRenderBatch(windowRecord, 2, &nrpoints, &xy, 4, &nc, &mc, &colors, &bytecolors, 3, &nrsize, &size, (GL_FLOAT == PsychGLFloatType(windowRecord)));
+    PsychPrepareRenderBatch(windowRecord, 2, &nrpoints, &xy, 4, &nc, &mc, &colors, &bytecolors, 3, &nrsize, &size, (GL_FLOAT == PsychGLFloatType(windowRecord)), &floatcolors);
     usecolorvector = (nc>1) ? TRUE:FALSE;
 
     // Assign sizef as float-type array of sizes, if float mode active, NULL otherwise:
@@ -355,7 +359,7 @@ PsychError SCREENDrawDots(void)
     glEnableClientState(GL_VERTEX_ARRAY);
 
     if (usecolorvector) {
-        PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colors, bytecolors);
+        PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colors, bytecolors, floatcolors);
     }
 
     // Render all n points, starting at point 0, render them as POINTS:
@@ -428,7 +432,7 @@ PsychError SCREENDrawDots(void)
     glDisableClientState(GL_VERTEX_ARRAY);
     glVertexPointer(2, PSYCHGLFLOAT, 0, NULL);
 
-    if (usecolorvector) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, NULL, NULL);
+    if (usecolorvector) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, NULL, NULL, FALSE);
 
     // Restore old matrix from backup copy, undoing the global translation:
     glPopMatrix();
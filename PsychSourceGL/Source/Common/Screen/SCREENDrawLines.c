@@ -7,6 +7,7 @@
         fcalabro@bu.edu                 fjc     Finnegan Calabro
         mario.kleiner.de@gmail.com      mk      Mario Kleiner
         dtaylor@ski.org                 dgt     Douglas Taylor
+        agent@local                     ag      agent
 
     PLATFORMS:
 
@@ -50,6 +51,7 @@
         4/22/05     mk          Small bug fix (size = PsychMallocTemp.....)
         12/4/06     mk          Rewrite to make it functional again and to implement a similar
                                 syntax to Screen('DrawDots').
+        10/19/26    ag          Also accept color vectors in single() format and pass them directly if possible.
  */
 
 #include "Screen.h"
@@ -67,6 +69,8 @@ static char synopsisString[] =
 "color values for each line, where each column corresponds to the color of the corresponding line start or "
 "endpoint in the xy position argument. If you specify different colors for the start- and endpoint of a "
 "line segment, PTB will generate a smooth transition of colors along the line via linear interpolation. "
+"Color arrays of uint8() or single() type are passed to the graphics card without any conversion, "
+"for single() if the color range of the window is 0.0 - 1.0. "
 "The default color is white if colors is omitted. \"smooth\" is a flag that determines whether lines "
 "should be smoothed: 0 (default) no smoothing, 1 smoothing (with anti-aliasing), 2 = high quality smoothing. "
 "If you use smoothing, you'll also need to set a proper blending mode with Screen('BlendFunction').\n"
@@ -84,7 +88,7 @@ PsychError SCREENDrawLines(void)
     PsychWindowRecordType       *windowRecord;
     int                         m,n,p, smooth;
     int                         nrsize, nrvertices, mc, nc, i;
-    psych_bool                  isArgThere, usecolorvector;
+    psych_bool                  isArgThere, usecolorvector, floatcolors;
     double                      *xy, *size, *center, *dot_type, *colors;
     unsigned char               *bytecolors;
     float                       linesizerange[2];
@@ -126,7 +130,7 @@ PsychError SCREENDrawLines(void)
     colors = NULL;
     bytecolors = NULL;
 
-    PsychPrepareRenderBatch(windowRecord, 2, &nrvertices, &xy, 4, &nc, &mc, &colors, &bytecolors, 3, &nrsize, &size, (GL_FLOAT == PsychGLFloatType(windowRecord)));
+    PsychPrepareRenderBatch(windowRecord, 2, &nrvertices, &xy, 4, &nc, &mc, &colors, &bytecolors, 3, &nrsize, &size, (GL_FLOAT == PsychGLFloatType(windowRecord)), &floatcolors);
     usecolorvector = (nc>1) ? TRUE:FALSE;
 
     // Assign sizef as float-type array of sizes, if float mode active, NULL otherwise:
@@ -208,7 +212,7 @@ PsychError SCREENDrawLines(void)
     glVertexPointer(2, PSYCHGLFLOAT, 0, &xy[0]);
 
     if (usecolorvector) {
-        PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colors, bytecolors);
+        PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colors, bytecolors, floatcolors);
     }
 
     // Enable fast rendering of arrays:
@@ -239,7 +243,7 @@ PsychError SCREENDrawLines(void)
     glDisableClientState(GL_VERTEX_ARRAY);
     glVertexPointer(2, PSYCHGLFLOAT, 0, NULL);
 
-    if (usecolorvector) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, NULL, NULL);
+    if (usecolorvector) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, NULL, NULL, FALSE);
 
     // Restore old matrix from backup copy, undoing the global translation:
     glPopMatrix();
@@ -5,6 +5,7 @@
 
         Allen.Ingling@nyu.edu           awi
         mario.kleiner.de@gmail.com      mk
+        agent@local                     ag
 
     PLATFORMS:
 
@@ -30,6 +31,7 @@
                             -> Allows for better handling of unicode and multibyte character encodings.
 
         11/02/13    mk      Rewrite OSX renderer: Switch from deprecated ATSUI to "new" CoreText as supported on OSX 10.5 and later.
+        10/19/26    ag      Split out plugin setup and measurement helpers for the glyph atlas cache of Screen('PrepareText').
 
     DESCRIPTION:
 
@@ -1677,6 +1679,9 @@ psych_bool PsychLoadTextRendererPlugin(PsychWindowRecordType* windowRecord)
 // OS/Engine specific cleanup routines:
 void PsychCleanupTextRenderer(PsychWindowRecordType* windowRecord)
 {
+    // Release glyph atlases and prepared texts of this onscreen window:
+    PsychReleaseGlyphCacheForWindow(windowRecord);
+
     // Do we have allocated display lists for the display list renderers on MS-Windows or Linux
     // for this onscreen window?
     if (windowRecord->textAttributes.DisplayList > 0) {
@@ -2093,6 +2098,81 @@ void PsychDrawCharText(PsychWindowRecordType* winRec, const char* textString, do
     return;
 }
 
+// Load the external text renderer plugin if usercode wants to use it, and assign the current
+// font, style, size and anti-aliasing settings of window 'winRec' to it. Returns the plugin
+// context id for the window, or -1 if the OS specific legacy renderer is to be used instead:
+int PsychSetupTextRendererPlugin(PsychWindowRecordType* winRec)
+{
+    int ctx;
+
+    if (!((PsychPrefStateGet_TextRenderer() > 0) && PsychLoadTextRendererPlugin(winRec))) return(-1);
+
+    // Get ctx context id for this window:
+    ctx = (int) (PsychGetParentWindow(winRec))->windowIndex;
+
+    // Assign current level of verbosity:
+    PsychPluginSetTextVerbosity((unsigned int) PsychPrefStateGet_Verbosity());
+
+    // Assign current anti-aliasing settings:
+    PsychPluginSetTextAntiAliasing(ctx, PsychPrefStateGet_TextAntiAliasing());
+
+    // Assign font family name of requested font:
+    PsychPluginSetTextFont(ctx, (const char*) winRec->textAttributes.textFontName);
+
+    // Assign style settings, e.g., bold, italic etc.:
+    PsychPluginSetTextStyle(ctx, winRec->textAttributes.textStyle);
+
+    // Assign text size in pixels:
+    PsychPluginSetTextSize(ctx, (double) winRec->textAttributes.textSize);
+
+    // Retrieve true text font family name:
+    sprintf((char*) &(winRec->textAttributes.textFontName[0]), "%s", PsychPluginGetTextFont(ctx));
+
+    return(ctx);
+}
+
+// Measure untransformed text via the plugin context 'ctx' as set up by PsychSetupTextRendererPlugin().
+// Returns the bounding box relative to the pen position on the baseline, with y-axis pointing upwards, in
+// bounds[0..3] = xmin, ymin, xmax, ymax, the horizontal cursor advance and, if available, the line
+// height of the font if 'lineHeight' is non-NULL. Returns 0 on success, non-zero on failure:
+int PsychMeasureTextWithPlugin(int ctx, unsigned int stringLengthChars, double* textUniDoubleString, float* bounds, float* xAdvance, double* lineHeight)
+{
+    double identityMatrix[2][3] = { { 1, 0, 0 }, { 0, 1, 0 } };
+    double dummy;
+    int rc;
+
+    if (PsychPluginSetAffineTransformMatrix)
+        PsychPluginSetAffineTransformMatrix(ctx, identityMatrix);
+
+    rc = PsychPluginMeasureText(ctx, stringLengthChars, textUniDoubleString, &bounds[0], &bounds[1], &bounds[2], &bounds[3], xAdvance);
+
+    if (lineHeight) {
+        *lineHeight = 0;
+        if ((0 == rc) && PsychPluginGetTextCursor) PsychPluginGetTextCursor(ctx, &dummy, &dummy, lineHeight);
+    }
+
+    return(rc);
+}
+
+// Draw text via the plugin context 'ctx' as set up by PsychSetupTextRendererPlugin() into a currently
+// bound width x height pixels framebuffer, with baseline pen position (x,y), untransformed, as opaque
+// white glyph ink on transparent background. Used to rasterize glyphs into glyph atlas textures.
+// Returns 0 on success, non-zero on failure:
+int PsychDrawTextWithPluginForAtlas(int ctx, int width, int height, double x, double y, unsigned int stringLengthChars, double* textUniDoubleString)
+{
+    double identityMatrix[2][3] = { { 1, 0, 0 }, { 0, 1, 0 } };
+    double inkColor[4] = { 1, 1, 1, 1 };
+    double noColor[4] = { 0, 0, 0, 0 };
+
+    PsychPluginSetTextViewPort(ctx, 0, 0, width, height);
+    PsychPluginSetTextFGColor(ctx, inkColor);
+    PsychPluginSetTextBGColor(ctx, noColor);
+    if (PsychPluginSetAffineTransformMatrix)
+        PsychPluginSetAffineTransformMatrix(ctx, identityMatrix);
+
+    return(PsychPluginDrawText(ctx, x, y, stringLengthChars, textUniDoubleString));
+}
+
 PsychError PsychDrawUnicodeText(PsychWindowRecordType* winRec, PsychRectType* boundingbox, unsigned int stringLengthChars, double* textUniDoubleString, double* xp, double* yp, double* theight, double* xAdvance, unsigned int yPositionIsBaseline, PsychColorType *textColor, PsychColorType *backgroundColor, int swapTextDirection)
 {
     GLdouble backgroundColorVector[4];
@@ -2117,32 +2197,11 @@ PsychError PsychDrawUnicodeText(PsychWindowRecordType* winRec, PsychRectType* bo
     }
 
     // Does usercode want us to use a text rendering plugin instead of our standard OS specific renderer?
-    // If so, load it if not already loaded:
-    if ((PsychPrefStateGet_TextRenderer() > 0) && PsychLoadTextRendererPlugin(winRec)) {
+    // If so, load it if not already loaded and assign current font settings:
+    if ((ctx = PsychSetupTextRendererPlugin(winRec)) >= 0) {
 
         // Use external dynamically loaded plugin:
 
-        // Get ctx context id for this window:
-        ctx = (int) (PsychGetParentWindow(winRec))->windowIndex;
-
-        // Assign current level of verbosity:
-        PsychPluginSetTextVerbosity((unsigned int) PsychPrefStateGet_Verbosity());
-
-        // Assign current anti-aliasing settings:
-        PsychPluginSetTextAntiAliasing(ctx, PsychPrefStateGet_TextAntiAliasing());
-
-        // Assign font family name of requested font:
-        PsychPluginSetTextFont(ctx, (const char*) winRec->textAttributes.textFontName);
-
-        // Assign style settings, e.g., bold, italic etc.:
-        PsychPluginSetTextStyle(ctx, winRec->textAttributes.textStyle);
-
-        // Assign text size in pixels:
-        PsychPluginSetTextSize(ctx, (double) winRec->textAttributes.textSize);
-
-        // Retrieve true text font family name:
-        sprintf((char*) &(winRec->textAttributes.textFontName[0]), "%s", PsychPluginGetTextFont(ctx));
-
         // Assign viewport settings for rendering:
         PsychPluginSetTextViewPort(ctx, winRec->clientrect[kPsychLeft], winRec->clientrect[kPsychTop], PsychGetWidthFromRect(winRec->clientrect), PsychGetHeightFromRect(winRec->clientrect));
 
@@ -2304,7 +2363,9 @@ PsychError SCREENDrawText(void)
     PsychCopyInIntegerArg(8, kPsychArgOptional, &swapTextDirection);
 
     // Call Unicode text renderer: This will update the current text cursor positions as well.
+    PsychTrace(kPsychTraceDrawTextBegin, stringLengthChars);
     PsychDrawUnicodeText(winRec, NULL, stringLengthChars, textUniDoubleString, &(winRec->textAttributes.textPositionX), &(winRec->textAttributes.textPositionY), &theight, &xAdvance, yPositionIsBaseline, &(winRec->textAttributes.textColor), &(winRec->textAttributes.textBackgroundColor), swapTextDirection);
+    PsychTrace(kPsychTraceDrawTextEnd, stringLengthChars);
 
     // We jump directly to this position in the code if the textstring is empty --> No op.
 drawtext_skipped:
@@ -246,7 +246,7 @@ PsychError SCREENDrawTextures(void)
     "b) n textures drawn to n different locations: Same as a) but provide a n component vector of 'texturePointers' one for "
     "each texture to be drawn to one of n locations at n angles.\n";
 
-    PsychWindowRecordType *source, *target;
+    PsychWindowRecordType *source, *target, *atlasMember;
     PsychRectType sourceRect, targetRect, tempRect;
     PsychColorType color;
     double *dstRects, *srcRects, *colors, *penSizes, *globalAlphas, *filterModes, *rotationAngles;
@@ -302,7 +302,7 @@ PsychError SCREENDrawTextures(void)
 
     // The negative position -4 means: dstRects coords are expected at position 4, but they are optional.
     // NULL means - don't want a size's vector.
-    PsychPrepareRenderBatch(target, -4, &numdstRects, &dstRects, 8, &nc, &mc, &colors, &bytecolors, 5, &nrsize, &penSizes, FALSE);
+    PsychPrepareRenderBatch(target, -4, &numdstRects, &dstRects, 8, &nc, &mc, &colors, &bytecolors, 5, &nrsize, &penSizes, FALSE, NULL);
 
     // At this point, target is set up as target window, i.e. its GL-Context is active, it is set as drawing target,
     // alpha blending is set up according to Screen('BlendFunction'), and the drawing color is set if it is a singular one.
@@ -440,6 +440,26 @@ PsychError SCREENDrawTextures(void)
     if (isclassic && (numTexs == 1) && (numFilterModes <= 1)) {
         batchIt = TRUE;
     }
+    else if (isclassic && (numTexs > 1) && (numFilterModes <= 1)) {
+        // Multiple textures can be batched if they are all packed into the same texture atlas,
+        // as they share one OpenGL texture then:
+        batchIt = TRUE;
+        for (i = 0; batchIt && (i < numTexs); i++) {
+            if (!IsWindowIndex((PsychWindowIndexType) texids[i])) {
+                batchIt = FALSE;
+                break;
+            }
+
+            FindWindowRecord((PsychWindowIndexType) texids[i], &atlasMember);
+            if ((atlasMember->windowType != kPsychTexture) || (atlasMember->textureAtlasIndex == 0) ||
+                ((i > 0) && (atlasMember->textureAtlasIndex != source->textureAtlasIndex))) {
+                batchIt = FALSE;
+            }
+            else if (i == 0) {
+                source = atlasMember;
+            }
+        }
+    }
     else {
         batchIt = FALSE;
     }
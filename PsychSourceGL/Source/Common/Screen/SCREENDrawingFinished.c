@@ -3,11 +3,13 @@
   
   AUTHORS:
     mk          mario.kleiner at tuebingen.mpg.de
+    ag          agent at local
  
   PLATFORMS:	All
     
   HISTORY:
   04/10/05  mk		Created.  
+  10/19/26  ag		No-op if the present queue of the window is enabled.
  
  
   DESCRIPTION:
@@ -121,6 +123,9 @@ PsychError SCREENDrawingFinished(void)
     // textures:
     if (PsychIsOnscreenWindow(windowRecord) && (windowRecord->flipInfo->asyncstate > 0)) runPreFlipOps = FALSE;
 
+    // With the present queue enabled, preflip operations must render into a queue slot at flip time, so skip them here:
+    if (PsychIsOnscreenWindow(windowRecord) && (windowRecord->flipInfo->queueCapacity > 0)) runPreFlipOps = FALSE;
+
     // Perform preflip-operations: Backbuffer backups for the different dontclear-modes
     // and special compositing operations for specific stereo algorithms...
     if (runPreFlipOps) {
@@ -5,6 +5,7 @@
 
 		Allen.Ingling@nyu.edu				awi
 		mario.kleiner@tuebingen.mpg.de		mk
+		agent@local					ag
   
     PLATFORMS:
 	
@@ -19,6 +20,8 @@
 		10/12/04	awi		In useString: changed "SCREEN" to "Screen", and moved commas to inside [].
 		1/15/05		awi		Removed GL_BLEND setting a MK's suggestion.  
 		2/25/05		awi		Added call to PsychUpdateAlphaBlendingFactorLazily().  Drawing now obeys settings by Screen('BlendFunction').
+		10/19/26	ag		Draw multiple ovals as one batch of discs in a single draw call.
+		10/19/26	ag		Draw the batch instanced from a shared unit circle, if supported.
 
 	TO DO:
 
@@ -54,7 +57,8 @@ PsychError SCREENFillOval(void)
 	PsychRectType			rect;
 	double					numSlices, radius, xScale, yScale, xTranslate, yTranslate, rectY, rectX;
 	PsychWindowRecordType	*windowRecord;
-	psych_bool				isArgThere, isclassic;
+	psych_bool				isArgThere, isclassic, isbatch;
+	PsychDiscBatchType		batch;
     double					*xy, *colors;
 	unsigned char			*bytecolors;
 	int						numRects, i, nc, mc, nrsize;
@@ -114,7 +118,7 @@ PsychError SCREENFillOval(void)
 	
 	// The negative position -3 means: xy coords are expected at position 3, but they are optional.
 	// NULL means - don't want a size's vector.
-	PsychPrepareRenderBatch(windowRecord, -3, &numRects, &xy, 2, &nc, &mc, &colors, &bytecolors, 0, &nrsize, NULL, FALSE);
+	PsychPrepareRenderBatch(windowRecord, -3, &numRects, &xy, 2, &nc, &mc, &colors, &bytecolors, 0, &nrsize, NULL, FALSE, NULL);
 
 	// Only up to one rect provided?
 	if (numRects <= 1) {
@@ -129,6 +133,11 @@ PsychError SCREENFillOval(void)
 		PsychCopyRect(rect, &xy[0]);
 	}
 
+	// Draw multiple ovals, or any oval on non-classic OpenGL, as one batch of discs in one draw call, instanced
+	// if supported. A single oval on classic OpenGL is faster drawn from the cached display list with a matrix transform:
+	isbatch = (!isclassic || (numRects > 1)) ? TRUE : FALSE;
+	if (isbatch) PsychDrawDiscBatchBegin(windowRecord, &batch, numRects);
+
 	// Draw all ovals (one or multiple):
 	for (i = 0; i < numRects;) {
 		// Per oval color provided? If so then set it up. If only one common color
@@ -160,7 +169,7 @@ PsychError SCREENFillOval(void)
 				radius=rectY/2;
 			}
 
-            if (isclassic) {
+            if (!isbatch) {
                 // Draw: Set up position, scale and size via matrix transform:
                 glPushMatrix();
                 glTranslatef((float) xTranslate, (float) yTranslate, (float) 0);
@@ -170,7 +179,7 @@ PsychError SCREENFillOval(void)
                 glPopMatrix();
             }
             else {
-                PsychDrawDisc(windowRecord, (float) xTranslate, (float) yTranslate, (float) 0, (float) radius, (int) numSlices, (float) xScale, (float) yScale, 0, 360);
+                PsychDrawDisc(windowRecord, &batch, (float) xTranslate, (float) yTranslate, (float) 0, (float) radius, (int) numSlices, (float) xScale, (float) yScale, 0, 360);
             }
 		}
 		
@@ -180,7 +189,9 @@ PsychError SCREENFillOval(void)
 
 		// Next oval.
 	}
-	
+
+	if (isbatch) PsychDrawDiscBatchEnd(windowRecord, &batch);
+
 	// Mark end of drawing op. This is needed for single buffered drawing:
 	PsychFlushGL(windowRecord);
 
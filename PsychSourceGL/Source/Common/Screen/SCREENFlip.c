@@ -5,6 +5,7 @@
 
         Allen.Ingling@nyu.edu           awi
         mario.kleiner.de@gmail.com      mk
+        agent@local                     ag
 
     PLATFORMS:
 
@@ -17,6 +18,7 @@
         04/03/05    mk      Add optional sync/nosync to VBL, don't clear fb on flip, flip after deadline, and return timestamps.
         05/16/05    mk      Add optional flag "dontsync" and some more timestamps.
         06/09/05    mk      Add optional flag "multiflip" for experimental multiflip support.
+        10/19/26    ag      Route all flips through the present queue of a window, if enabled.
 
     DESCRIPTION:
 
@@ -140,7 +142,12 @@ PsychError SCREENFlip(void)
     "- Stereo stimulus display in stereomode 10 (two separate onscreen windows) will\n"
     "  likely not work with reliable timing or have possible tearing artifacts.\n\n"
     "- Use of the 'UserspaceBufferDrawingPrepare' hook-chain of the imaging\n"
-    "  pipeline is not allowed.\n"
+    "  pipeline is not allowed.\n\n"
+    "If the present queue of the window is enabled via Screen('PresentQueue'), 'AsyncFlipBegin' does not start "
+    "a single pending flip, but appends the frame to the queue and returns immediately, allowing to draw and "
+    "queue further frames right away. It only waits if the queue is full. The returned values are the results "
+    "of the most recently presented queued frame. 'AsyncFlipEnd' waits until all queued frames are presented, "
+    "'AsyncFlipCheckEnd' checks for this. See 'Screen PresentQueue?' for details."
     "\n\n"
     "Our general stance is that most code can be written efficiently without need for async flips, so this feature is "
     "provided for the few demanding special cases where this is not the case and the benefits outweight the costs.";
@@ -324,8 +331,9 @@ PsychError SCREENFlip(void)
         // completion data of previous async flips to usercode.
         // In opmode 0 aka Screen('Flip') returning data here would not make
         // sense as userspace expects the results from the synchronous flip we will
-        // schedule next.
-        if (opmode == 1) {
+        // schedule next. With the present queue enabled, the data of the most recently
+        // presented queued frame gets returned after enqueuing the new frame instead:
+        if ((opmode == 1) && (flipRequest->queueCapacity == 0)) {
             vbl_timestamp    = (flipstate) ? flipRequest->vbl_timestamp : 0.0;
             time_at_onset    = flipRequest->time_at_onset;
             time_at_flipend  = flipRequest->time_at_flipend;
@@ -365,7 +373,7 @@ PsychError SCREENFlip(void)
     else {
         // opmode == 2 or 3 - 'AsyncFlipEnd' or 'AsyncFlipCheckEnd':
         flipRequest = windowRecord->flipInfo;
-        if (flipRequest->asyncstate == 0) {
+        if ((flipRequest->asyncstate == 0) && (flipRequest->queueCapacity == 0)) {
             // No started, executing or finalized async flip in progress! No async flip operation triggered
             // which we could finalize. This is fine. We basically no-op and return the cached last known
             // values from previous async flips or sync flips, or all zeros if no flip was ever executed:
@@ -438,6 +446,14 @@ PsychError SCREENFlip(void)
         // Reset flipwhen to "not assigned":
         flipRequest->flipwhen = -DBL_MAX;
     }
+    else if (flipRequest->queueCapacity > 0) {
+        // Frame enqueued into the present queue: Return results of the most recently presented queued frame:
+        PsychCopyOutDoubleArg(1, FALSE, flipRequest->vbl_timestamp);
+        PsychCopyOutDoubleArg(2, FALSE, flipRequest->time_at_onset);
+        PsychCopyOutDoubleArg(3, FALSE, flipRequest->time_at_flipend);
+        PsychCopyOutDoubleArg(4, FALSE, flipRequest->miss_estimate);
+        PsychCopyOutDoubleArg(5, FALSE, (double) flipRequest->beamPosAtFlip);
+    }
 
     return(PsychError_none);
 }
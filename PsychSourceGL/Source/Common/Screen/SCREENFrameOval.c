@@ -5,6 +5,7 @@
 
         Allen.Ingling@nyu.edu                awi
         mario.kleiner.de@gmail.com            mk
+        agent@local                           ag
 
     PLATFORMS:
 
@@ -20,6 +21,8 @@
         1/25/05     awi         Really removed GL_BLEND.  Correction provide by mk.
         2/25/05     awi         Added call to PsychUpdateAlphaBlendingFactorLazily().  Drawing now obeys settings by Screen('BlendFunction').
         6/14/09     mk          Add batch-drawing support, just as with FillOval et al.
+        10/19/26    ag          Draw all ovals as one batch of discs in a single draw call, instead of one gluDisk() each.
+        10/19/26    ag          Draw the batch instanced from a shared unit circle, if supported.
 
     BUGS:
 
@@ -75,12 +78,12 @@ PsychError SCREENFrameOval(void)
     PsychRectType           rect;
     double                  numSlices, outerRadius, xScale, yScale, xTranslate, yTranslate, rectY, rectX, penWidth, penHeight, penSize, innerRadius;
     PsychWindowRecordType   *windowRecord;
-    psych_bool              isArgThere, isclassic;
+    psych_bool              isArgThere;
+    PsychDiscBatchType      batch;
     double                  *xy, *colors;
     unsigned char           *bytecolors;
     double                  *penSizes;
     int                     numRects, i, nc, mc, nrsize;
-    GLUquadricObj           *diskQuadric = NULL;
 
     //all sub functions should have these two lines
     PsychPushHelp(useString, synopsisString, seeAlsoString);
@@ -102,8 +105,7 @@ PsychError SCREENFrameOval(void)
 
     // The negative position -3 means: xy coords are expected at position 3, but they are optional.
     // NULL means - don't want a size's vector.
-    PsychPrepareRenderBatch(windowRecord, -3, &numRects, &xy, 2, &nc, &mc, &colors, &bytecolors, 4, &nrsize, &penSizes, FALSE);
-    isclassic = PsychIsGLClassic(windowRecord);
+    PsychPrepareRenderBatch(windowRecord, -3, &numRects, &xy, 2, &nc, &mc, &colors, &bytecolors, 4, &nrsize, &penSizes, FALSE, NULL);
 
     // Only up to one rect provided?
     if (numRects <= 1) {
@@ -126,8 +128,8 @@ PsychError SCREENFrameOval(void)
         penSize = penSizes[0];
     }
 
-    // Create quadric object:
-    if (isclassic) diskQuadric = gluNewQuadric();
+    // All ovals are drawn as one batch of discs, submitted in one draw call, instanced if supported:
+    PsychDrawDiscBatchBegin(windowRecord, &batch, numRects);
 
     // Draw all ovals (one or multiple):
     for (i=0; i < numRects;) {
@@ -168,20 +170,7 @@ PsychError SCREENFrameOval(void)
             innerRadius = outerRadius - penSize;
             innerRadius = (innerRadius < 0) ? 0 : innerRadius;
 
-            if (isclassic) {
-                // Draw: Set up position, scale and size via matrix transform:
-                glPushMatrix();
-                glTranslated(xTranslate, yTranslate, 0);
-                glScaled(xScale, yScale, 1);
-
-                // Compute disk quadric for given params: This is awfully slow and would
-                // benefit a lot from shader magic on modern GPUs:
-                gluDisk(diskQuadric, innerRadius, outerRadius, (int) numSlices, 1);
-                glPopMatrix();
-            }
-            else {
-                PsychDrawDisc(windowRecord, (float) xTranslate, (float) yTranslate, (float) innerRadius, (float) outerRadius, (int) numSlices, (float) xScale, (float) yScale, 0, 360);
-            }
+            PsychDrawDisc(windowRecord, &batch, (float) xTranslate, (float) yTranslate, (float) innerRadius, (float) outerRadius, (int) numSlices, (float) xScale, (float) yScale, 0, 360);
         }
 
         // Done with this one. Set up the next one, if any...
@@ -193,8 +182,7 @@ PsychError SCREENFrameOval(void)
         // Next oval.
     }
 
-    // Release quadric object:
-    if (isclassic) gluDeleteQuadric(diskQuadric);
+    PsychDrawDiscBatchEnd(windowRecord, &batch);
 
     // Mark end of drawing op. This is needed for single buffered drawing:
     PsychFlushGL(windowRecord);
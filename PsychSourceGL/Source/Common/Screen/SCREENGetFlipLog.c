@@ -0,0 +1,103 @@
+/*
+ *    SCREENGetFlipLog.c
+ *
+ *    AUTHORS:
+ *
+ *    agent@local                     ag
+ *
+ *    PLATFORMS:
+ *
+ *    All.
+ *
+ *    HISTORY:
+ *
+ *    19.10.2026    ag      Created.
+ *
+ *    DESCRIPTION:
+ *
+ *    Returns the timing records of all flips of an onscreen window since the last call in one
+ *    numeric matrix, from a preallocated per-window flip log ring.
+ */
+
+#include "Screen.h"
+
+// Default capacity of the flip log in flips: Over 4 minutes at 240 Hz.
+#define kPsychDefaultFlipLogCapacity 65536
+
+// If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
+static char useString[] = "[flipLog, lostCount] = Screen('GetFlipLog', windowPtr [, maxN] [, logCapacity]);";
+//                          1        2                                  1            2         3
+static char synopsisString[] =
+"Return the timing of all flips of onscreen window 'windowPtr' since the last call of this function, in one matrix.\n\n"
+"This allows to collect the timestamps of every flip of long sessions at high refresh rates, without the overhead "
+"of collecting and storing the return values of Screen('Flip') after each flip in your script.\n"
+"The first call to this function for a window enables flip logging for that window: Screen('Flip'), "
+"Screen('AsyncFlipBegin') and all other flip methods then append the full timing record of each completed flip "
+"to a preallocated log, which can hold the records of 'logCapacity' flips, by default 65536 flips. If the log "
+"fills up, the oldest records get overwritten. Each call returns and consumes the records of all flips logged "
+"since the previous call, but at most 'maxN' records if 'maxN' is specified.\n"
+"'logCapacity' if specified, (re-)allocates the log with room for 'logCapacity' flips, discarding all records "
+"which were not yet retrieved. A 'logCapacity' of zero disables flip logging for the window.\n\n"
+"'flipLog' is a n-by-15 matrix with one row for each of the n returned flips, in order of flip completion. "
+"The columns are:\n"
+" 1 = Flip count, ie., the serial number of this flip, starting with 1 for the first flip of the window.\n"
+" 2 = Requested 'when' time of the flip.\n"
+" 3 = Target time for the onset of the flip in VRR mode, after latency compensation, or -1 if not in VRR mode.\n"
+" 4 = Target time for the bufferswap if the operating system scheduled the swap, or -1 otherwise.\n"
+" 5 = VBLTimestamp, as returned by Screen('Flip').\n"
+" 6 = StimulusOnsetTime, as returned by Screen('Flip').\n"
+" 7 = FlipTimestamp, as returned by Screen('Flip').\n"
+" 8 = Missed, as returned by Screen('Flip').\n"
+" 9 = Beampos, as returned by Screen('Flip').\n"
+"10 = Time immediately before the bufferswap request was submitted.\n"
+"11 = Time immediately after the bufferswap request was submitted.\n"
+"12 = Raw time of swap completion detection, without any timestamp correction.\n"
+"13 = Video refresh cycle count of swap completion reported by the operating system, or -1 if unavailable.\n"
+"14 = Type of the completed swap: 0 = Unknown, 1 = Pageflip, 2 = Exchange, 3 = Copy.\n"
+"15 = 1 if the flip was executed by the background thread of an asynchronous flip, 0 otherwise.\n"
+"'lostCount' is the number of flip records which got overwritten before they could be retrieved, because "
+"the log was full. Call this function more often or increase 'logCapacity' if this is non-zero.\n";
+static char seeAlsoString[] = "Flip AsyncFlipBegin GetFlipInfo";
+
+PsychError SCREENGetFlipLog(void)
+{
+    PsychWindowRecordType   *windowRecord;
+    double                  *flipLog;
+    int                     maxN, logCapacity, count, lost;
+
+    // Provide help if needed:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    // Cap the numbers of inputs and outputs
+    PsychErrorExit(PsychCapNumInputArgs(3));        // The maximum number of inputs
+    PsychErrorExit(PsychRequireNumInputArgs(1));    // Min. 1 input arg required.
+    PsychErrorExit(PsychCapNumOutputArgs(2));       // The maximum number of outputs
+
+    // Get the onscreen window:
+    PsychAllocInWindowRecordArg(1, kPsychArgRequired, &windowRecord);
+    if (!PsychIsOnscreenWindow(windowRecord)) PsychErrorExitMsg(PsychError_user, "'windowPtr' must be the handle of an onscreen window!");
+
+    maxN = INT_MAX;
+    if (PsychCopyInIntegerArg(2, kPsychArgOptional, &maxN) && (maxN < 0))
+        PsychErrorExitMsg(PsychError_user, "Invalid 'maxN' specified. Must be at least zero.");
+
+    // (Re-)Allocate or disable log on request, enable it with default capacity on first call:
+    if (PsychCopyInIntegerArg(3, kPsychArgOptional, &logCapacity)) {
+        if (logCapacity < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'logCapacity' specified. Must be at least zero.");
+        PsychSetFlipLogCapacity(windowRecord, logCapacity);
+    }
+    else if (PsychGetFlipLogCapacity(windowRecord) == 0) {
+        PsychSetFlipLogCapacity(windowRecord, kPsychDefaultFlipLogCapacity);
+    }
+
+    // Fetch up to maxN oldest records:
+    count = PsychGetFlipLogCount(windowRecord);
+    if (count > maxN) count = maxN;
+
+    PsychAllocOutDoubleMatArg(1, kPsychArgOptional, count, kPsychFlipLogRecordSize, 1, &flipLog);
+    lost = PsychFetchFlipLog(windowRecord, count, flipLog);
+    PsychCopyOutDoubleArg(2, kPsychArgOptional, lost);
+
+    return(PsychError_none);
+}
@@ -86,6 +86,10 @@ static char useString2[] = "Screen('AddFrameToMovie', windowPtr [,rect] [,buffer
 
 static char synopsisString2[] =
 "Get an image from a window or texture and add it as a new video frame to a movie.\n\n"
+"If the movie was created with the 'AsyncReadback' option in Screen('CreateMovie'), the function only "
+"starts an asynchronous readback of the image and returns immediately, while a background thread hands the "
+"frame to the video encoder once the readback completes. In that case, 'rect' must have the size of the movie "
+"frames, and 'windowPtr' must be the window the movie was created for, or share its OpenGL context.\n\n"
 "Calling this function on an onscreen window while an asynchronous flip is pending on "
 "the window due to Screen('AsyncFlipBegin') is not allowed. Finalize such flips first. "
 "Readback of other onscreen or offscreen windows or textures is possible during async "
@@ -163,6 +167,8 @@ PsychError SCREENGetImage(void)
     GLenum          whichBuffer = 0;
     int             frameduration = 1;
     int             moviehandle = 0;
+    int             movieWidth, movieHeight;
+    PsychWindowRecordType *movieWindow;
     unsigned int    twidth, theight, numChannels, bitdepth;
     unsigned char*  framepixels;
     psych_bool      isOES;
@@ -615,8 +621,22 @@ PsychError SCREENGetImage(void)
         PsychCopyInIntegerArg(5, FALSE, &frameduration);
         if (frameduration < 1) PsychErrorExitMsg(PsychError_user, "Number of requested framedurations 'frameduration' is negative. Must be greater than zero!");
 
-        framepixels = PsychGetVideoFrameForMoviePtr(moviehandle, &twidth, &theight, &numChannels, &bitdepth);
-        if (framepixels) {
+        // Movie with asynchronous readback? Then start readback into its ring of pixel buffers and return immediately:
+        if (PsychIsAsyncMovieWriter(moviehandle)) {
+            // The readback goes into pixel buffers of the GL context of the window the movie is bound to, and always
+            // reads a full movie frame, so the window must use that context and the rect must match the frame size:
+            movieWindow = PsychGetMovieWriterWindow(moviehandle, &movieWidth, &movieHeight);
+            if ((NULL == movieWindow) || ((movieWindow != windowRecord) && (movieWindow->targetSpecific.contextObject != windowRecord->targetSpecific.contextObject)))
+                PsychErrorExitMsg(PsychError_user, "AddFrameToMovie failed: Movie with asynchronous readback can only record from the window it was created for, or from windows sharing its OpenGL context!");
+
+            if ((sampleRectWidth != (size_t) movieWidth) || (sampleRectHeight != (size_t) movieHeight))
+                PsychErrorExitMsg(PsychError_user, "AddFrameToMovie failed: Size of 'rect' does not match the frame size of the movie with asynchronous readback!");
+
+            if (PsychAddAsyncVideoFrameToMovie(moviehandle, (int) sampleRect[kPsychLeft], (int) (windowRect[kPsychBottom] - sampleRect[kPsychTop]), frameduration) != 0) {
+                PsychErrorExitMsg(PsychError_user, "AddFrameToMovie failed with error above!");
+            }
+        }
+        else if ((framepixels = PsychGetVideoFrameForMoviePtr(moviehandle, &twidth, &theight, &numChannels, &bitdepth))) {
             glPixelStorei(GL_PACK_ALIGNMENT,1);
             invertedY = (int) (windowRect[kPsychBottom] - (sampleRect[kPsychTop] + theight));
 
@@ -0,0 +1,79 @@
+/*
+ *    SCREENGetMovieStatistics.c
+ *
+ *    AUTHORS:
+ *
+ *    agent@local                     ag
+ *
+ *    PLATFORMS:
+ *
+ *    All.
+ *
+ *    HISTORY:
+ *
+ *    19.10.2026    ag      Created.
+ *
+ *    DESCRIPTION:
+ *
+ *    Returns statistics about decode-ahead queueing, frame fetch latency and texture recycling of a movie.
+ */
+
+#include "Screen.h"
+
+// If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
+static char useString[] = "stats = Screen('GetMovieStatistics', moviePtr [, reset=0]);";
+//                          1                                   1            2
+static char synopsisString[] =
+"Return a struct 'stats' with playback statistics of movie 'moviePtr'.\n\n"
+"This helps to find out if decoding keeps up with playback, and how deep the decode-ahead queue should be, "
+"as selected via the 'PrefetchFrames=n' keyword in the 'movieOptions' parameter of Screen('OpenMovie').\n"
+"If the optional 'reset' flag is set to 1, then all counters are reset to zero after returning them.\n\n"
+"The struct contains the following fields:\n"
+"'PrefetchFrames' Decode-ahead depth requested via 'movieOptions', or 0 for the default.\n"
+"'QueueCapacity' Maximum number of decoded frames which can wait for fetch before the decoder has to wait.\n"
+"'QueueDepth' Number of decoded frames currently waiting to be fetched, including frames already uploaded into textures ahead of fetch.\n"
+"'MaxQueueDepth' Maximum number of decoded frames which were waiting to be fetched at any time.\n"
+"'FramesFetched' Number of frames fetched during playback for which the time of decoding is known.\n"
+"'MeanDecodeLatency' and 'MaxDecodeLatency' Mean and maximum time in seconds between a decoded frame "
+"becoming available and it being fetched into a texture.\n"
+"'LateFrames' Number of fetched frames whose latency was longer than the duration of one movie frame.\n"
+"'SkippedFrames' Number of decoded frames which were skipped over to catch up with the playback clock.\n"
+"'DroppedFrames' Number of frames dropped, as also reported by Screen('GetMovieImage') and Screen('CloseMovie').\n"
+"'TexturePoolSize' Number of textures currently waiting for recycling in the movies texture pool.\n"
+"'TexturePoolCapacity' Maximum number of textures kept in the pool.\n"
+"'RecycledTextures' Number of fetched frames which reused a texture from the pool instead of allocating a new one.\n"
+"'ZeroCopyFrames' Number of fetched frames imported as textures without copy, see 'DmaBufImport' in Screen('OpenMovie').\n"
+"'CopiedFrames' Number of fetched frames uploaded into textures by copy.\n"
+"'PreUploadedFrames' Number of copied frames which were already uploaded into their texture by a background thread "
+"before the fetch. During playback with decode-ahead, 8 bpc luminance or RGBA frames get uploaded ahead of fetch on "
+"desktop OpenGL with sync object support, so Screen('GetMovieImage') only hands over the finished texture.\n"
+"'SeekIndexFrames' Number of frames in the seek index of the movie, see 'SeekIndex' in Screen('OpenMovie'), or 0 if the movie has no index.\n";
+static char seeAlsoString[] = "OpenMovie PlayMovie GetMovieImage CloseMovie";
+
+PsychError SCREENGetMovieStatistics(void)
+{
+    int moviehandle = -1;
+    int reset = 0;
+
+    // Provide help if needed:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    // Cap the numbers of inputs and outputs
+    PsychErrorExit(PsychCapNumInputArgs(2));        // The maximum number of inputs
+    PsychErrorExit(PsychRequireNumInputArgs(1));    // Min. 1 input arg required.
+    PsychErrorExit(PsychCapNumOutputArgs(1));       // The maximum number of outputs
+
+    // Get the movie handle:
+    PsychCopyInIntegerArg(1, kPsychArgRequired, &moviehandle);
+    if (moviehandle == -1) {
+        PsychErrorExitMsg(PsychError_user, "GetMovieStatistics called without valid handle to a movie object.");
+    }
+
+    PsychCopyInIntegerArg(2, kPsychArgOptional, &reset);
+
+    // Return statistics, optionally reset counters:
+    PsychCopyOutMovieStatistics(moviehandle, 1, (reset) ? TRUE : FALSE);
+
+    return(PsychError_none);
+}
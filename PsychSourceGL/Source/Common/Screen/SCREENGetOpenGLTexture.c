@@ -58,6 +58,9 @@ PsychError SCREENGetOpenGLTexture(void)
     if (!PsychIsTexture(textureRecord)) {
         PsychErrorExitMsg(PsychError_user, "You tried to query texture information on something else than a texture!");
     }
+
+    // External OpenGL code expects a texture of its own, not a part of a texture atlas:
+    PsychEvictTextureFromAtlas(textureRecord);
     
     // Query optional x-pos:
     PsychCopyInDoubleArg(3, FALSE, &x);
@@ -119,6 +119,23 @@ static char synopsisString[] =
     "Screen('HookFunction', windowPtr, 'DumpAll'); \n"
     "Print out all chains for the given onscreen window 'windowPtr' to the Matlab console in a human readable format - Useful for debugging."
     "\n\n"
+    "[passCount, gpuPassTimes, specifiedPassCount, eliminatedBlits, fusedSlots] = Screen('HookFunction', windowPtr, 'PassStatistics', hookname [, enableTiming]); \n"
+    "Return statistics about the render passes of hook chain 'hookname'. Whenever a chain is modified, Screen optimizes it: "
+    "Passes which only consist of a plain 'Builtin:IdentityBlit' are skipped if they are redundant, and runs of consecutive "
+    "passes with a single GLSL shader slot each are merged into one pass with a generated shader, if all these shader slots "
+    "declare themselves fusable by the keyword 'Fusable' in their 'blittercfg' string. The first fused shader can be an "
+    "arbitrary fragment shader, but all following ones must only perform per-pixel operations and define a GLSL function "
+    "vec4 PsychFusableStage(vec4 incolor) which returns the output color of a pixel for its input color 'incolor'. "
+    "A shader slot with its own lookup texture 'luttexid1' can only be the first slot of a fused pass. "
+    "Set the environment variable PSYCH_DISABLE_HOOKCHAIN_OPTIMIZER to a non-empty value to disable these optimizations.\n"
+    "'passCount' is the number of passes after optimization, 'specifiedPassCount' the number of passes as specified by the "
+    "chains slots, 'eliminatedBlits' the number of skipped identity blit passes, 'fusedSlots' the number of shader slots "
+    "which are executed as part of a fused shader.\n"
+    "If 'enableTiming' is set to 1, the gpu execution time of each pass gets measured via OpenGL timer queries, if supported "
+    "by the graphics driver, 0 disables measurement. 'gpuPassTimes' returns a vector with the most recently measured gpu "
+    "execution time of each executed pass in seconds, or an empty vector if no measurement is available yet. Results "
+    "become available with a delay of at least one execution of the chain."
+    "\n\n"
     "oldImagingMode = Screen('HookFunction', proxyPtr, 'ImagingMode' [, imagingMode]); \n"
     "Change or query imagingMode flags of provided proxy window 'proxyPtr' to 'imagingMode'. Proxy windows are used to define "
     "image processing operations, mostly for Screen('TransformTexture'). Returns old imaging mode."
@@ -268,8 +285,9 @@ PsychError SCREENHookFunction(void)
     psych_int64                 flag64;
     double                      doubleptr;
     double                      shaderid, luttexid1 = 0;
-    int                         n, m, p;
+    int                         n, m, p, hookidx;
     double                      *dblmat;
+    PsychHookChainStats         *stats;
     int                         verbosity = PsychPrefStateGet_Verbosity();
 
     blitterString = NULL;
@@ -308,6 +326,7 @@ PsychError SCREENHookFunction(void)
     if (strcmp(cmdString, "ImportDisplayBufferInteropMemory")==0) cmd=19;
     if (strcmp(cmdString, "SetHDRScalingFactors")==0) cmd=20;
     if (strcmp(cmdString, "WindowColorGamut")==0) cmd=21;
+    if (strcmp(cmdString, "PassStatistics")==0) cmd=22;
 
     if (cmd == 0) PsychErrorExitMsg(PsychError_user, "Unknown subcommand specified to 'HookFunction'.");
     if (whereloc < 0) PsychErrorExitMsg(PsychError_user, "Unknown/Invalid/Unparseable insert location specified to 'HookFunction' 'InsertAtXXX'.");
@@ -664,6 +683,24 @@ PsychError SCREENHookFunction(void)
                 memcpy(&windowRecord->colorGamut[0], dblmat, sizeof(windowRecord->colorGamut));
             }
         break;
+
+        case 22: // PassStatistics
+            if ((hookidx = PsychGetHookByName(hookString)) == -1) PsychErrorExitMsg(PsychError_user, "In 'PassStatistics': Unknown (non-existent) hook name provided.");
+            stats = &(windowRecord->HookChainStats[hookidx]);
+
+            PsychCopyOutDoubleArg(1, FALSE, stats->optimizedPassCount);
+            PsychAllocOutDoubleMatArg(2, FALSE, 1, stats->measuredPasses, 1, &dblmat);
+            for (n = 0; n < stats->measuredPasses; n++) dblmat[n] = stats->gpuPassTime[n];
+            PsychCopyOutDoubleArg(3, FALSE, stats->passCount);
+            PsychCopyOutDoubleArg(4, FALSE, stats->eliminatedBlits);
+            PsychCopyOutDoubleArg(5, FALSE, stats->fusedSlots);
+
+            // Enable or disable per-pass gpu timing:
+            if (PsychCopyInIntegerArg(4, FALSE, &flag1)) {
+                stats->timingEnabled = (flag1 > 0) ? TRUE : FALSE;
+                if (!stats->timingEnabled) stats->measuredPasses = 0;
+            }
+        break;
     }
 
     // Done.
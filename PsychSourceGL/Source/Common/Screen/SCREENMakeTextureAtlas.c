@@ -0,0 +1,132 @@
+/*
+ *    SCREENMakeTextureAtlas.c
+ *
+ *    AUTHORS:
+ *
+ *    agent@local                     ag
+ *
+ *    PLATFORMS:
+ *
+ *    All.
+ *
+ *    HISTORY:
+ *
+ *    19.10.2026    ag      Created.
+ *
+ *    DESCRIPTION:
+ *
+ *    Packs many small textures into one shared texture atlas, so Screen('DrawTextures')
+ *    can draw all of them in one batched draw call.
+ */
+
+#include "Screen.h"
+
+// If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
+static char useString[] = "[atlasPtr, packedRects] = Screen('MakeTextureAtlas', windowPtr, textureHandles [, atlasPtr=0] [, padding=1] [, maxSize]);";
+//                          1         2                                         1          2                 3               4              5
+static char synopsisString[] =
+"Pack the textures with the handles given in the vector 'textureHandles' into one shared texture atlas.\n\n"
+"A texture atlas is one large OpenGL texture which stores the image content of many small textures, e.g., "
+"letters, symbols, icons or small image stimuli. All packed textures stay valid textures with their original "
+"texture handles, and can be used with all Screen functions as before, but Screen('DrawTextures') can draw "
+"many textures from the same atlas in one single batched draw call, which is much more efficient than drawing "
+"many individual textures if you need to draw hundreds or thousands of them each frame.\n"
+"'windowPtr' is the handle of the onscreen window to which all textures belong.\n"
+"'textureHandles' is a vector of texture handles of textures to pack. All textures must have the same texture "
+"type, orientation, pixel format and texture shaders, ie., they should be created by Screen('MakeTexture') with "
+"identical optional parameters. Textures which are already packed into a different atlas get moved into this atlas.\n"
+"'atlasPtr' is the optional handle of an existing texture atlas to which the textures should be added. If omitted "
+"or zero, a new atlas is created. If an existing 'atlasPtr' is given with an empty 'textureHandles' vector, then "
+"the atlas gets repacked compactly, reclaiming the space of textures which were closed in the meantime.\n"
+"'padding' is the optional number of unused border pixels around each texture inside the atlas. The default of 1 "
+"pixel avoids bleeding of neighbouring textures into each other during bilinear filtering. Mip-mapped drawing of "
+"packed textures only uses mip-map levels up to log2(padding), ie., only the full resolution level at the default "
+"padding of 1, as coarser levels would blend in neighbouring textures. Use a 'padding' of 2^n for n usable levels.\n"
+"'maxSize' is the optional maximum width and height of the atlas in pixels. It defaults to the maximum texture size "
+"supported by your graphics card.\n"
+"'padding' and 'maxSize' are only used when creating a new atlas.\n"
+"Returns the texture handle 'atlasPtr' of the texture atlas and the 4-by-n matrix 'packedRects' with the "
+"[x; y; x + w; y + h] location of each of the n textures in 'textureHandles', in texels of the underlying OpenGL "
+"atlas texture.\n"
+"Closing the atlas via Screen('Close', atlasPtr) unpacks all textures still contained in it into their own "
+"standalone textures. Using a packed texture as drawing target or as input to Screen('TransformTexture') or "
+"Screen('GetOpenGLTexture') also unpacks that texture from its atlas first.\n"
+"This function is only supported on classic desktop OpenGL, not on OpenGL-ES.\n";
+static char seeAlsoString[] = "MakeTexture DrawTextures Close";
+
+PsychError SCREENMakeTextureAtlas(void)
+{
+    PsychWindowRecordType   *windowRecord, *atlasRecord, **textures;
+    double                  *texids, *packedRects;
+    int                     m, n, p, i, count, atlasHandle, padding, maxSize;
+
+    // Provide help if needed:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    // Cap the numbers of inputs and outputs
+    PsychErrorExit(PsychCapNumInputArgs(5));        // The maximum number of inputs
+    PsychErrorExit(PsychRequireNumInputArgs(2));    // Min. 2 input args required.
+    PsychErrorExit(PsychCapNumOutputArgs(2));       // The maximum number of outputs
+
+    // Get the onscreen window:
+    PsychAllocInWindowRecordArg(1, kPsychArgRequired, &windowRecord);
+    if (!PsychIsOnscreenWindow(windowRecord)) PsychErrorExitMsg(PsychError_user, "'windowPtr' must be the handle of an onscreen window!");
+
+    // Get vector of texture handles, possibly empty:
+    m = n = p = 0;
+    texids = NULL;
+    PsychAllocInDoubleMatArg(2, kPsychArgRequired, &m, &n, &p, &texids);
+    if ((p > 1) || (m > 1 && n > 1)) PsychErrorExitMsg(PsychError_user, "'textureHandles' must be a row- or columnvector of texture handles.");
+    count = m * n;
+
+    // Get optional existing atlas:
+    atlasRecord = NULL;
+    atlasHandle = 0;
+    PsychCopyInIntegerArg(3, kPsychArgOptional, &atlasHandle);
+    if (atlasHandle != 0) {
+        if (FindWindowRecord((PsychWindowIndexType) atlasHandle, &atlasRecord) != PsychError_none || !PsychIsTextureAtlas(atlasRecord))
+            PsychErrorExitMsg(PsychError_user, "Invalid 'atlasPtr' provided: Not a texture atlas!");
+    }
+    else if (count < 1) {
+        PsychErrorExitMsg(PsychError_user, "Need at least one texture handle in 'textureHandles' to create a new texture atlas!");
+    }
+
+    padding = 1;
+    PsychCopyInIntegerArg(4, kPsychArgOptional, &padding);
+    if (padding < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'padding' provided: Must be zero or greater.");
+
+    maxSize = 0;
+    PsychCopyInIntegerArg(5, kPsychArgOptional, &maxSize);
+    if (maxSize < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'maxSize' provided: Must be greater than zero.");
+
+    // Resolve all texture handles:
+    textures = (PsychWindowRecordType**) PsychMallocTemp((count + 1) * sizeof(PsychWindowRecordType*));
+    for (i = 0; i < count; i++) {
+        if (!IsWindowIndex((PsychWindowIndexType) texids[i])) {
+            printf("PTB-ERROR: %i th entry in texture handle vector is not a valid handle!\n", i + 1);
+            PsychErrorExitMsg(PsychError_user, "Invalid texture handle provided to Screen('MakeTextureAtlas').");
+        }
+
+        FindWindowRecord((PsychWindowIndexType) texids[i], &textures[i]);
+    }
+
+    // Pack them:
+    atlasRecord = PsychPackTexturesIntoAtlas(windowRecord, atlasRecord, count, textures, padding, maxSize);
+
+    // Return atlas handle:
+    PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) atlasRecord->windowIndex);
+
+    // Return location of each requested texture inside the atlas:
+    PsychAllocOutDoubleMatArg(2, kPsychArgOptional, 4, count, 1, &packedRects);
+    for (i = 0; i < count; i++) {
+        int w, h;
+        PsychGetTextureTexelSize(textures[i], &w, &h);
+        *(packedRects++) = textures[i]->textureAtlasOffset[0];
+        *(packedRects++) = textures[i]->textureAtlasOffset[1];
+        *(packedRects++) = textures[i]->textureAtlasOffset[0] + w;
+        *(packedRects++) = textures[i]->textureAtlasOffset[1] + h;
+    }
+
+    return(PsychError_none);
+}
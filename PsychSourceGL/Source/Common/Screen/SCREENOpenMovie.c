@@ -152,7 +152,28 @@ static char synopsisString[] =
         "Linux pulsesink plugin to send sound data to the output named 'MyCardsOutput1' via the PulseAudio sound server commonly "
         "used on Linux desktop systems.\n"
         "If you set a Screen() verbosity level of 4 or higher, Screen() will print out the actually used audio output at the end "
-        "of movie playback on operating systems which support this. This can help debugging issues with audio routing if you don't hear sound.\n";
+        "of movie playback on operating systems which support this. This can help debugging issues with audio routing if you don't hear sound.\n"
+        "PrefetchFrames=n -- Allow the decoder to decode up to n video frames ahead of their consumption by Screen('GetMovieImage'), "
+        "instead of the default of 1 frame, or up to 1.5 seconds of video if audio playback is disabled. A deeper queue smooths out "
+        "variations in decoding time of high resolution or high framerate movies. This also allows to keep up to n textures, at most 16, "
+        "in a pool for recycling instead of only one, so scripts which hold on to multiple fetched movie frames before closing them "
+        "avoid texture allocations. During playback, decoded 8 bpc luminance or RGBA frames also get uploaded into those "
+        "textures ahead of their fetch by a background thread, if the system supports this, so Screen('GetMovieImage') "
+        "does not need to wait for the upload. Screen('GetMovieStatistics') reports how well decoding keeps up with playback.\n"
+        "SeekIndex=1 -- Build an index of the timestamps and keyframes of all video frames at open time, for frame-accurate "
+        "and deterministic seeking with Screen('SetMovieTimeIndex') and Screen('GetMovieImage'). Building the index requires "
+        "reading through the whole movie file, but no decoding. If the movie was opened with an index, the returned 'count' "
+        "of frames is exact. If another movie gets queued for gapless playback into the same 'moviePtr', its index is built "
+        "at the first Screen('SetMovieTimeIndex') call after playback switched to that movie.\n"
+        "SeekIndex=indexFilename -- Like SeekIndex=1, but load the index from file indexFilename if that file exists and "
+        "matches the movie file, otherwise build the index and store it into file indexFilename for faster opening next time. "
+        "The file is only used for the movie opened with it, not for movies queued later into the same 'moviePtr'.\n"
+        "SeekCacheFrames=n -- Number of recently decoded frames to cache for indexed seeking while the movie is stopped, "
+        "between 1 and 64, by default 8. Seeking to a cached frame, e.g., stepping back by one frame, needs no decoding.\n"
+        "DmaBufImport=1 -- Import decoded RGBA8 video frames as textures without copying them through system memory, if the "
+        "video decoder delivers frames in DMA-BUF memory, e.g., hardware video decoders. This is only supported on Linux with "
+        "EGL based OpenGL contexts. Frames in regular memory are uploaded as usual. Screen('GetMovieStatistics') reports the "
+        "number of frames imported without copy.\n";
 
 static char seeAlsoString[] = "CloseMovie PlayMovie GetMovieImage GetMovieTimeIndex SetMovieTimeIndex";
 
@@ -360,11 +381,17 @@ PsychError SCREENOpenMovie(void)
 
 PsychError SCREENFinalizeMovie(void)
 {
-    static char useString[] = "Screen('FinalizeMovie', moviePtr);";
-    static char synopsisString[] = "Finish creating a new movie file with handle 'moviePtr' and store it to filesystem.\n";
+    static char useString[] = "[framesAdded, droppedFrames, lateFrames] = Screen('FinalizeMovie', moviePtr);";
+    static char synopsisString[] =
+        "Finish creating a new movie file with handle 'moviePtr' and store it to filesystem.\n"
+        "Optionally returns the number of video frames 'framesAdded' to the movie, the number of frames "
+        "'droppedFrames' which were dropped during asynchronous readback, because all readback buffers were "
+        "still in use by the video encoder, and the number of frames 'lateFrames' whose asynchronous readback "
+        "was not yet complete when the next frame was captured. See 'AsyncReadback' in 'Screen CreateMovie?'.\n";
     static char seeAlsoString[] = "CreateMovie AddFrameToMovie CloseMovie PlayMovie GetMovieImage GetMovieTimeIndex SetMovieTimeIndex";
 
     int moviehandle = -1;
+    int framesAdded, droppedFrames, lateFrames;
 
     // All sub functions should have these two lines
     PsychPushHelp(useString, synopsisString, seeAlsoString);
@@ -372,7 +399,7 @@ PsychError SCREENFinalizeMovie(void)
 
     PsychErrorExit(PsychCapNumInputArgs(1));            // Max. 3 input args.
     PsychErrorExit(PsychRequireNumInputArgs(1));        // Min. 2 input args required.
-    PsychErrorExit(PsychCapNumOutputArgs(0));           // Max. 1 output args.
+    PsychErrorExit(PsychCapNumOutputArgs(3));           // Max. 3 output args.
 
     // Get the moviehandle:
     PsychCopyInIntegerArg(1, kPsychArgRequired, &moviehandle);
@@ -382,6 +409,13 @@ PsychError SCREENFinalizeMovie(void)
         PsychErrorExitMsg(PsychError_user, "FinalizeMovie failed for reason mentioned above.");
     }
 
+    // Get frame counts after finalizing, so they include frames dropped while draining the readback buffers:
+    PsychGetMovieWriterFrameCounts(moviehandle, &framesAdded, &droppedFrames, &lateFrames);
+
+    PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) framesAdded);
+    PsychCopyOutDoubleArg(2, kPsychArgOptional, (double) droppedFrames);
+    PsychCopyOutDoubleArg(3, kPsychArgOptional, (double) lateFrames);
+
     return(PsychError_none);
 }
 
@@ -414,6 +448,17 @@ PsychError SCREENCreateMovie(void)
         "Keywords unknown to a certain implementation or codec will be silently ignored:\n"
         "EncodingQuality=x Set encoding quality to value x, in the range 0.0 for lowest movie quality to "
         "1.0 for highest quality. Default is 0.5 = normal quality. 1.0 often provides near-lossless encoding.\n"
+        "AsyncReadback or AsyncReadback=n Read back video frames asynchronously: 'AddFrameToMovie' only starts "
+        "the readback of the image into one of a ring of n pixel buffers, by default 4 buffers, and returns "
+        "immediately. Completed frames are handed to the video encoder on a background thread without copying "
+        "them. If all buffers are still in use by the encoder, new frames get dropped. 'FinalizeMovie' reports "
+        "the number of dropped and late frames. Requires desktop OpenGL with pixel buffer object and sync object "
+        "support, otherwise synchronous readback is used.\n"
+        "RecordFlips Automatically add the final image of each Screen('Flip') or Screen('AsyncFlipBegin') of window "
+        "'windowPtr' as a new video frame, as it will be displayed, after all processing by the imaging pipeline, "
+        "starting at the top-left corner of the window. Best combined with AsyncReadback. Each flip adds one frame "
+        "of one unit of duration, so for recording with accurate timing, set 'frameRate' to the refresh rate of the "
+        "display. Screen('GetFlipLog') provides the true presentation times of the recorded flips.\n"
         "'numChannels' Optional number of image channels to encode: Can be 1, 3 or 4 on OpenGL graphics hardware, "
         "and 3 or 4 on OpenGL-ES hardware. 1 = Red/Grayscale channel only, 3 = RGB, 4 = RGBA. Please note that not "
         "all video codecs can encode pure 1 channel data or RGBA data, ie. an alpha channel. If an unsuitable codec "
@@ -495,6 +540,9 @@ PsychError SCREENCreateMovie(void)
         PsychErrorExitMsg(PsychError_user, "CreateMovie failed for reason mentioned above.");
     }
 
+    // Bind it to the window, which also sets up asynchronous readback if requested:
+    PsychMovieWritingBindWindow(moviehandle, windowRecord);
+
     // Return handle to it:
     PsychCopyOutDoubleArg(1, FALSE, (double) moviehandle);
 
@@ -117,6 +117,10 @@ static char synopsisString[] =
 "By default, if the flag is omitted, some performance loss will be present, but capture will be more robust "
 "with problematic cameras. "
 "A setting of 8192 requests to avoid any use of videorate converters, not even for recording (see above).\n"
+"A setting of 16384 requests zero-copy import of video frames into textures, if the video source delivers "
+"frames in DMA-BUF memory. This is only supported for 8 bpc RGBA textures (pixeldepth 4) on Linux with EGL based "
+"OpenGL contexts, otherwise video frames are uploaded into textures as usual. See 'GetZeroCopyFrameCount' in "
+"Screen('SetVideoCaptureParameter') for how many frames were imported without copy.\n"
 "\n"
 "'captureEngineType' This optional parameter allows selection of the video capture engine to use for this "
 "video source. Allowable values are currently 1 and 3. "
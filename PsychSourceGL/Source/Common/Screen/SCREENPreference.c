@@ -5,6 +5,7 @@
 
     Allen.Ingling@nyu.edu           awi
     mario.kleiner.de@gmail.com      mk
+    agent@local                     ag
 
     PLATFORMS:
 
@@ -19,6 +20,7 @@
         5/30/05     mk      New preference setting screenVisualDebugLevel.
         3/07/05     awi     New preference SuppressAllWarnings.
         11/15/06    mk      New preference vbl & flip timestamping mode.
+        10/19/26    ag      New preference RefreshCalibrationCache.
 
     DESCRIPTION:
 
@@ -114,6 +116,7 @@ static char synopsisString[] =
     "\noldLocaleNameString = Screen('Preference', 'TextEncodingLocale', [newLocalenNameString]);"
     "\noldEnableFlag = Screen('Preference', 'SkipSyncTests', [enableFlag]);"
     "\n[maxStddev, minSamples, maxDeviation, maxDuration] = Screen('Preference', 'SyncTestSettings' [, maxStddev=0.001 secs][, minSamples=50][, maxDeviation=0.1][, maxDuration=5 secs]);"
+    "\noldLevel = Screen('Preference', 'RefreshCalibrationCache', [level=0 (Off), 1 = Use and update cache, 2 = Recalibrate and update cache]);"
     "\noldEnableFlag = Screen('Preference', 'FrameRectCorrection', [enableFlag=1]);"
     "\noldLevel = Screen('Preference', 'VisualDebugLevel', level);"
     "\n\nWorkaround flags to work around all kind of deficient drivers and hardware:\n"
@@ -357,6 +360,14 @@ PsychError SCREENPreference(void)
                             PsychPrefStateSet_SynctestThresholds(maxStddev, minSamples, maxDeviation, maxDuration);
             }
             preferenceNameArgumentValid=TRUE;
+        }else
+            if(PsychMatch(preferenceName, "RefreshCalibrationCache")){
+            PsychCopyOutDoubleArg(1, kPsychArgOptional, PsychPrefStateGet_RefreshCalibrationCache());
+            if(numInputArgs==2){
+                PsychCopyInIntegerArg(2, kPsychArgRequired, &tempInt);
+                PsychPrefStateSet_RefreshCalibrationCache(tempInt);
+            }
+            preferenceNameArgumentValid=TRUE;
         }else
             if(PsychMatch(preferenceName, "VBLEndlineOverride")){
             PsychCopyOutDoubleArg(1, kPsychArgOptional, PsychPrefStateGet_VBLEndlineOverride());
@@ -0,0 +1,240 @@
+/*
+ *    SCREENPrepareText.c
+ *
+ *    AUTHORS:
+ *
+ *    agent@local                     ag
+ *
+ *    PLATFORMS:
+ *
+ *    All.
+ *
+ *    HISTORY:
+ *
+ *    19.10.2026    ag      Created.
+ *
+ *    DESCRIPTION:
+ *
+ *    Prepared text objects for fast repeated drawing of the same text strings, implemented in PsychGlyphCacheSupport.c:
+ *    Screen('PrepareText') creates them, Screen('DrawPreparedText') draws them, Screen('TextCache') manages them.
+ */
+
+#include "Screen.h"
+
+PsychError SCREENPrepareText(void)
+{
+    // If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
+    static char useString[] = "[textId, normBoundsRect, xAdvance, textHeight] = Screen('PrepareText', windowPtr, text [, swapTextDirection=0]);";
+    //                          1       2               3         4                                   1          2       3
+    static char synopsisString[] =
+    "Prepare text string 'text' for fast repeated drawing into window 'windowPtr' via Screen('DrawPreparedText').\n\n"
+    "This is useful if the same strings need to be drawn again and again, e.g., all words of a reading experiment "
+    "display in each video refresh cycle. Preparation converts the text once into Unicode, measures it, computes the "
+    "placement of each glyph and rasterizes all glyphs into a glyph atlas texture. There is one glyph atlas for each "
+    "combination of font, size, style and anti-aliasing setting, shared by all prepared texts. Drawing prepared texts "
+    "then only needs to draw one textured rectangle per glyph, and all glyphs of all texts in one call to "
+    "Screen('DrawPreparedText') which use the same font settings get drawn in one batch.\n"
+    "The text gets prepared with the font, size, style and anti-aliasing settings current at the time of preparation, "
+    "ie., as selected via Screen('TextFont'), Screen('TextSize'), Screen('TextStyle') and the 'TextAntiAliasing' "
+    "Screen('Preference'). Later changes to these settings do not affect prepared texts. Text color and background "
+    "color get selected at drawing time.\n"
+    "'text' and 'swapTextDirection' accept the same values as in Screen('DrawText').\n"
+    "Glyph atlases are only used with the default text renderer plugin on desktop OpenGL. Underlined text, text with a "
+    "non-identity Screen('TextTransform') and glyphs too large for an atlas get drawn via the regular text renderer, "
+    "which is not faster than Screen('DrawText').\n\n"
+    "'textId' is the handle of the prepared text, to be passed to Screen('DrawPreparedText'). Prepared texts stay "
+    "valid until closed via Screen('TextCache', 'Close') or until their onscreen window gets closed.\n"
+    "'normBoundsRect' is the bounding box of the text, as 'normBoundsRect' of Screen('TextBounds').\n"
+    "'xAdvance' is the horizontal advance of the text cursor after drawing the text.\n"
+    "'textHeight' is the line height of the font, or zero if the text renderer does not support this query.\n";
+    static char seeAlsoString[] = "DrawPreparedText TextCache DrawText TextBounds";
+
+    PsychWindowRecordType   *winRec;
+    PsychRectType           normBounds;
+    int                     stringLengthChars, swapTextDirection, textId;
+    double                  *textUniDoubleString;
+    double                  bounds[4], xAdvance, textHeight;
+
+    // All subfunctions should have these two lines.
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    PsychErrorExit(PsychCapNumInputArgs(3));
+    PsychErrorExit(PsychRequireNumInputArgs(2));
+    PsychErrorExit(PsychCapNumOutputArgs(4));
+
+    PsychAllocInWindowRecordArg(1, kPsychArgRequired, &winRec);
+
+    if (!PsychAllocInTextAsUnicode(2, kPsychArgRequired, &stringLengthChars, &textUniDoubleString))
+        PsychErrorExitMsg(PsychError_user, "You asked me to prepare an empty text string?!? Sorry, that's a no no...");
+
+    swapTextDirection = 0;
+    PsychCopyInIntegerArg(3, kPsychArgOptional, &swapTextDirection);
+
+    textId = PsychPrepareText(winRec, stringLengthChars, textUniDoubleString, swapTextDirection);
+    PsychGetPreparedTextMetrics(textId, bounds, &xAdvance, &textHeight);
+
+    PsychMakeRect(normBounds, 0, 0, bounds[2] - bounds[0], bounds[3] - bounds[1]);
+
+    PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) textId);
+    PsychCopyOutRectArg(2, kPsychArgOptional, normBounds);
+    PsychCopyOutDoubleArg(3, kPsychArgOptional, xAdvance);
+    PsychCopyOutDoubleArg(4, kPsychArgOptional, textHeight);
+
+    return(PsychError_none);
+}
+
+PsychError SCREENDrawPreparedText(void)
+{
+    // If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
+    static char useString[] = "[newX, newY] = Screen('DrawPreparedText', windowPtr, textIds [, x] [, y] [, color] [, backgroundColor] [, yPositionIsBaseline]);";
+    //                          1     2                                  1          2          3     4     5          6                    7
+    static char synopsisString[] =
+    "Draw one or more texts prepared via Screen('PrepareText') into window 'windowPtr'.\n\n"
+    "'textIds' is a vector of handles of prepared texts, which must have been prepared for 'windowPtr' or for its "
+    "onscreen window. The glyphs of all texts which share a glyph atlas get drawn in one batch.\n"
+    "'x' and 'y' define the start positions of the texts, like for Screen('DrawText'). They can be scalars, which "
+    "apply to all texts, or vectors with one position per text. If 'x' or 'y' are omitted, the texts get drawn one "
+    "after another, starting at the current text cursor position.\n"
+    "'color', 'backgroundColor' and 'yPositionIsBaseline' have the same meaning and defaults as for Screen('DrawText'). "
+    "If a background color is drawn, the backgrounds of all texts in one batch get drawn before the glyphs of the batch.\n"
+    "Glyphs get drawn at whole pixel positions. If 'x' or 'y' are fractional, placement may therefore differ by a "
+    "fraction of a pixel from Screen('DrawText').\n"
+    "'newX' and 'newY' return the final text cursor position, which is the position of the last text, advanced by "
+    "its 'xAdvance'.\n";
+    static char seeAlsoString[] = "PrepareText TextCache DrawText";
+
+    PsychWindowRecordType   *winRec;
+    PsychColorType          colorArg, backgroundColorArg;
+    int                     m, n, p, count, nx, ny, i, yPositionIsBaseline;
+    int                     *textIds;
+    double                  *ids, *x, *y;
+
+    // All subfunctions should have these two lines.
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    PsychErrorExit(PsychCapNumInputArgs(7));
+    PsychErrorExit(PsychRequireNumInputArgs(2));
+    PsychErrorExit(PsychCapNumOutputArgs(2));
+
+    PsychAllocInWindowRecordArg(1, kPsychArgRequired, &winRec);
+
+    PsychAllocInDoubleMatArg(2, kPsychArgRequired, &m, &n, &p, &ids);
+    if (p != 1) PsychErrorExitMsg(PsychError_user, "'textIds' must be a vector of prepared text handles!");
+    count = m * n;
+
+    textIds = (int*) PsychMallocTemp(count * sizeof(int) + 1);
+    for (i = 0; i < count; i++) textIds[i] = (int) ids[i];
+
+    x = y = NULL;
+    nx = ny = 0;
+    if (PsychAllocInDoubleMatArg(3, kPsychArgOptional, &m, &n, &p, &x)) {
+        nx = m * n * p;
+        if ((nx != 1) && (nx != count)) PsychErrorExitMsg(PsychError_user, "'x' must be a scalar or a vector with one position per text!");
+    }
+
+    if (PsychAllocInDoubleMatArg(4, kPsychArgOptional, &m, &n, &p, &y)) {
+        ny = m * n * p;
+        if ((ny != 1) && (ny != count)) PsychErrorExitMsg(PsychError_user, "'y' must be a scalar or a vector with one position per text!");
+    }
+
+    if (PsychCopyInColorArg(5, kPsychArgOptional, &colorArg)) PsychSetTextColorInWindowRecord(&colorArg, winRec);
+
+    if (PsychCopyInColorArg(6, kPsychArgOptional, &backgroundColorArg)) {
+        PsychSetTextBackgroundColorInWindowRecord(&backgroundColorArg, winRec);
+    } else {
+        // This just to coerce background color into proper format in case it hasn't been done already:
+        PsychSetTextBackgroundColorInWindowRecord(&(winRec->textAttributes.textBackgroundColor), winRec);
+    }
+
+    yPositionIsBaseline = PsychPrefStateGet_TextYPositionIsBaseline();
+    PsychCopyInIntegerArg(7, kPsychArgOptional, &yPositionIsBaseline);
+
+    PsychTrace(kPsychTraceDrawTextBegin, count);
+    PsychDrawPreparedTexts(winRec, count, textIds, x, nx, y, ny, yPositionIsBaseline, &(winRec->textAttributes.textColor),
+                           &(winRec->textAttributes.textBackgroundColor), &(winRec->textAttributes.textPositionX),
+                           &(winRec->textAttributes.textPositionY));
+    PsychTrace(kPsychTraceDrawTextEnd, count);
+
+    PsychCopyOutDoubleArg(1, kPsychArgOptional, winRec->textAttributes.textPositionX);
+    PsychCopyOutDoubleArg(2, kPsychArgOptional, winRec->textAttributes.textPositionY);
+
+    return(PsychError_none);
+}
+
+PsychError SCREENTextCache(void)
+{
+    // If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
+    static char useString[] = "result = Screen('TextCache', subCommand [, arg]);";
+    //                         1                            1             2
+    static char synopsisString[] =
+    "Manage prepared texts and the glyph atlas cache used by Screen('PrepareText') and Screen('DrawPreparedText').\n\n"
+    "'subCommand' selects the operation:\n"
+    "'Close' Close the prepared texts whose handles are given in the vector 'arg', or all prepared texts if 'arg' is omitted.\n"
+    "'Flush' Release all glyph atlases. Prepared texts stay valid and re-rasterize their glyphs on their next draw.\n"
+    "'MaxAtlases' Return the maximum number of glyph atlases in 'result'. If 'arg' is given, set a new maximum of 1 to 64 "
+    "atlases. There is one atlas per combination of onscreen window, font, size, style and anti-aliasing setting. If a new "
+    "atlas is needed while the maximum number exists, the least recently used atlas gets released. Default is 8.\n"
+    "'Statistics' Return a struct 'result' with cache statistics. If 'arg' is 1, reset all counters after returning them. "
+    "The struct contains the following fields:\n"
+    "'Atlases' and 'MaxAtlases' Current and maximum number of glyph atlases.\n"
+    "'Glyphs' Number of glyphs stored in all atlases. 'PreparedTexts' Number of open prepared texts.\n"
+    "'AtlasHits' and 'AtlasMisses' Number of atlas lookups for text preparation which found an existing atlas, or had to "
+    "create a new atlas.\n"
+    "'AtlasEvictions' Number of least recently used atlases released to make room for a new atlas.\n"
+    "'AtlasResets' Number of times an atlas was full and had to be cleared, invalidating the glyphs of all its prepared texts.\n"
+    "'GlyphHits' and 'GlyphMisses' Number of glyph lookups which found the glyph in its atlas, or had to rasterize it.\n"
+    "'DrawHits' and 'DrawMisses' Number of prepared text draws whose glyphs were still in their atlas, or had to be "
+    "rasterized again.\n"
+    "'FallbackDraws' Number of prepared text draws done by the regular text renderer instead of via a glyph atlas.\n"
+    "'BatchDraws' Number of batched draw calls executed.\n";
+    static char seeAlsoString[] = "PrepareText DrawPreparedText";
+
+    char    *cmdString;
+    double  *ids;
+    int     m, n, p, i, arg;
+
+    // All subfunctions should have these two lines.
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    PsychErrorExit(PsychCapNumInputArgs(2));
+    PsychErrorExit(PsychRequireNumInputArgs(1));
+    PsychErrorExit(PsychCapNumOutputArgs(1));
+
+    PsychAllocInCharArg(1, kPsychArgRequired, &cmdString);
+
+    if (PsychMatch(cmdString, "Close")) {
+        if (PsychAllocInDoubleMatArg(2, kPsychArgOptional, &m, &n, &p, &ids)) {
+            for (i = 0; i < m * n * p; i++) PsychClosePreparedText((int) ids[i]);
+        }
+        else {
+            PsychClosePreparedText(0);
+        }
+
+        return(PsychError_none);
+    }
+
+    if (PsychMatch(cmdString, "Flush")) {
+        PsychFlushGlyphAtlases();
+        return(PsychError_none);
+    }
+
+    if (PsychMatch(cmdString, "MaxAtlases")) {
+        arg = 0;
+        if (PsychCopyInIntegerArg(2, kPsychArgOptional, &arg) && ((arg < 1) || (arg > 64)))
+            PsychErrorExitMsg(PsychError_user, "Invalid maximum number of glyph atlases provided. Must be between 1 and 64.");
+
+        PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) PsychSetMaxGlyphAtlases(arg));
+        return(PsychError_none);
+    }
+
+    if (!PsychMatch(cmdString, "Statistics")) PsychErrorExitMsg(PsychError_user, "Unknown subCommand provided. Must be 'Close', 'Flush', 'MaxAtlases' or 'Statistics'.");
+
+    arg = 0;
+    PsychCopyInIntegerArg(2, kPsychArgOptional, &arg);
+    PsychCopyOutGlyphCacheStatistics(1, (arg) ? TRUE : FALSE);
+
+    return(PsychError_none);
+}
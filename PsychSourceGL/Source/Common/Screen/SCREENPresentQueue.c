@@ -0,0 +1,129 @@
+/*
+ *    SCREENPresentQueue.c
+ *
+ *    AUTHORS:
+ *
+ *    agent@local                     ag
+ *
+ *    PLATFORMS:
+ *
+ *    All.
+ *
+ *    HISTORY:
+ *
+ *    19.10.2026    ag      Created.
+ *
+ *    DESCRIPTION:
+ *
+ *    Configures the present queue of an onscreen window, which allows to queue multiple prerendered frames
+ *    via Screen('AsyncFlipBegin') for back-to-back presentation by the background flipper thread, and returns
+ *    the timing results of all presented queued frames in one numeric matrix.
+ */
+
+#include "Screen.h"
+
+// If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
+static char useString[] = "[result, lostCount] = Screen('PresentQueue', windowPtr, subCommand [, arg]);";
+//                          1       2                                  1          2             3
+static char synopsisString[] =
+"Configure the present queue of onscreen window 'windowPtr', or query its state and the results of presented frames.\n\n"
+"By default, Screen('AsyncFlipBegin') schedules one flip at a time, and the next one can only be scheduled after the "
+"pending one has completed. With the present queue enabled, each Screen('AsyncFlipBegin') instead finalizes the current "
+"frame into a free slot of the queue and appends it to the queue, together with its requested onset time 'when', then "
+"returns immediately. You can draw and queue the next frames right away, while the background flipper thread presents "
+"the queued frames back-to-back, each at its requested 'when'. Screen('AsyncFlipBegin') only waits if the queue is full. "
+"This allows to prerender a bounded number of frames ahead of time, to compensate for occasional slow frames in your "
+"drawing code. Screen('Flip') queues the frame as well, but waits for its presentation. Screen('AsyncFlipEnd') waits "
+"until all queued frames are presented, Screen('AsyncFlipCheckEnd') polls for this. All these functions return the "
+"timestamps of the most recently presented queued frame. The present queue works together with frame-sequential "
+"stereo and our own VRR scheduler, in which case queued frames are scheduled by them.\n"
+"The present queue requires the imaging pipeline to be enabled, e.g., via PsychImaging('AddTask', 'General', "
+"'UseVirtualFramebuffer'); It is not supported with native quad-buffered stereo, dual-window stereo or output, "
+"external image sinks, the Vulkan or XR display backends, or on EGL backed windows without frame-sequential stereo "
+"or VRR scheduler. Each slot of the queue needs the video memory of a full window sized framebuffer, or two for "
+"frame-sequential stereo. While the queue is enabled, Screen('DrawingFinished') does not perform any work.\n\n"
+"'subCommand' selects the operation:\n"
+"'Capacity' Return the capacity of the queue in frames in 'result', zero if the queue is disabled. If 'arg' is given, "
+"change the capacity to 'arg' frames, 1 to 64, after all currently queued frames have been presented. A capacity of "
+"zero disables the queue. Changing the capacity discards all not yet retrieved results.\n"
+"'Status' Return a vector 'result' = [capacity, pending, submitted, presented] with the capacity of the queue, the "
+"number of queued frames not yet presented, and the total number of frames queued and presented since the capacity "
+"was last set.\n"
+"'Results' Return the timing of all queued frames presented since the last 'Results' call in one matrix 'result', "
+"but at most 'arg' frames if 'arg' is specified. 'result' is a n-by-7 matrix with one row for each of the n returned "
+"frames, in order of presentation. The columns are:\n"
+" 1 = Frame number, ie., the serial number of the queued frame, starting with 1 for the first frame queued after the "
+"capacity was set.\n"
+" 2 = Requested 'when' time of the frame.\n"
+" 3 = VBLTimestamp, as returned by Screen('Flip').\n"
+" 4 = StimulusOnsetTime, as returned by Screen('Flip').\n"
+" 5 = FlipTimestamp, as returned by Screen('Flip').\n"
+" 6 = Missed, as returned by Screen('Flip').\n"
+" 7 = Beampos, as returned by Screen('Flip').\n"
+"The results of the most recent 4096 presented frames are kept. 'lostCount' is the number of results which got "
+"overwritten before they could be retrieved. Call this function more often if this is non-zero.\n";
+static char seeAlsoString[] = "AsyncFlipBegin AsyncFlipEnd Flip GetFlipLog";
+
+PsychError SCREENPresentQueue(void)
+{
+    PsychWindowRecordType   *windowRecord;
+    psych_uint64            submitted, presented;
+    double                  *result;
+    char                    *cmdString;
+    int                     arg, capacity, count, lost;
+
+    // Provide help if needed:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    // Cap the numbers of inputs and outputs
+    PsychErrorExit(PsychCapNumInputArgs(3));        // The maximum number of inputs
+    PsychErrorExit(PsychRequireNumInputArgs(2));    // Min. 2 input args required.
+    PsychErrorExit(PsychCapNumOutputArgs(2));       // The maximum number of outputs
+
+    // Get the onscreen window:
+    PsychAllocInWindowRecordArg(1, kPsychArgRequired, &windowRecord);
+    if (!PsychIsOnscreenWindow(windowRecord)) PsychErrorExitMsg(PsychError_user, "'windowPtr' must be the handle of an onscreen window!");
+
+    PsychAllocInCharArg(2, kPsychArgRequired, &cmdString);
+
+    if (PsychMatch(cmdString, "Capacity")) {
+        capacity = PsychGetPresentQueueStatus(windowRecord, &submitted, &presented);
+
+        if (PsychCopyInIntegerArg(3, kPsychArgOptional, &arg)) {
+            if ((arg < 0) || (arg > 64)) PsychErrorExitMsg(PsychError_user, "Invalid present queue capacity specified. Must be between 0 and 64 frames.");
+            if (windowRecord->windowType != kPsychDoubleBufferOnscreen) PsychErrorExitMsg(PsychError_user, "The present queue requires a double-buffered onscreen window.");
+            capacity = PsychSetPresentQueueCapacity(windowRecord, arg);
+        }
+
+        PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) capacity);
+        return(PsychError_none);
+    }
+
+    if (PsychMatch(cmdString, "Status")) {
+        capacity = PsychGetPresentQueueStatus(windowRecord, &submitted, &presented);
+
+        PsychAllocOutDoubleMatArg(1, kPsychArgOptional, 1, 4, 1, &result);
+        result[0] = (double) capacity;
+        result[1] = (double) (submitted - presented);
+        result[2] = (double) submitted;
+        result[3] = (double) presented;
+        return(PsychError_none);
+    }
+
+    if (!PsychMatch(cmdString, "Results")) PsychErrorExitMsg(PsychError_user, "Unknown subCommand provided. Must be 'Capacity', 'Status' or 'Results'.");
+
+    arg = INT_MAX;
+    if (PsychCopyInIntegerArg(3, kPsychArgOptional, &arg) && (arg < 0))
+        PsychErrorExitMsg(PsychError_user, "Invalid maximum number of results specified. Must be at least zero.");
+
+    // Fetch up to arg oldest results:
+    count = PsychGetPresentQueueResultCount(windowRecord);
+    if (count > arg) count = arg;
+
+    PsychAllocOutDoubleMatArg(1, kPsychArgOptional, count, kPsychPresentQueueResultSize, 1, &result);
+    lost = PsychFetchPresentQueueResults(windowRecord, count, result);
+    PsychCopyOutDoubleArg(2, kPsychArgOptional, lost);
+
+    return(PsychError_none);
+}
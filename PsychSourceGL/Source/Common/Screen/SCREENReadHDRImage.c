@@ -13,37 +13,85 @@
 #include "Screen.h"
 #include "tinyexr.h"
 
+// Imported from tinyexr.cc with C linkage:
+int PsychLoadEXRImage(const char *filename, int halfFloat, void **out_rgba, int *width, int *height, EXRHeader *exr_header, const char **err);
+
+// Maximum number of image files decoded concurrently in a batch load. Each decode
+// is multi-threaded itself, so this mostly overlaps file i/o with decoding:
+#define kPsychMaxHDRLoaderThreads 4
+
+// Number of fixed fields of the 'auxInfo' struct for OpenEXR images:
+#define fixedFieldCount 10
+
+// State of loading one image file:
+typedef struct PsychHDRImageLoadType {
+    char        *filename;
+    int         halfFloat;
+    void        *rgba;
+    int         width;
+    int         height;
+    EXRHeader   exrHeader;
+    const char  *err;
+    int         rc;
+} PsychHDRImageLoadType;
+
+// Shared state of a batch load:
+typedef struct PsychHDRBatchLoaderType {
+    PsychHDRImageLoadType   *loads;
+    int                     count;
+    int                     next;
+    psych_mutex             mutex;
+} PsychHDRBatchLoaderType;
+
 // If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
-static char useString[] = "[imageArray, format, errorMsg, auxInfo] = Screen('ReadHDRImage', filename [, errorMode=0]);";
-//                          1           2       3         4                                 1           2
+static char useString[] = "[imageArray, format, errorMsg, auxInfo] = Screen('ReadHDRImage', filename [, errorMode=0][, precision=0][, windowPtr]);";
+//                          1           2       3         4                                 1           2              3              4
 static char synopsisString[] =
 "Read a high dynamic range (HDR) image file from the filesystem and return its content.\n\n"
 "This function allows to read some HDR file formats and return the image data as a "
 "double matrix.\n"
-"'filename' is the name of the image file.\n"
+"'filename' is the name of the image file. If 'windowPtr' is provided, then 'filename' "
+"can also be a list of multiple file names, separated by newline characters, e.g., "
+"created via strjoin(fileNames, char(10)). All listed files are then read and decoded "
+"concurrently, which is much faster for loading big sets of images.\n"
 "'errorMode' is the optional flag to define how failures to read the file should be "
 "handled: 0 = Fail silently: Return empty 'imageArray', 1 = Like 0, but print warning "
 "or error message to console, 2 = Like 1, but also abort script with error message.\n"
+"'precision' is the optional precision of the returned image data: 0 = Return a "
+"double matrix (default). 2 = Return a single precision float matrix, which is faster "
+"and needs half the memory, and can also be passed to Screen('MakeTexture'). 1 = Same "
+"as 2, unless 'windowPtr' is provided.\n"
+"'windowPtr' if provided, don't return a matrix, but directly create a floating point "
+"texture for the window 'windowPtr' from the decoded image, avoiding any intermediate "
+"matrices and conversions. 'precision' 1 creates a 16 bpc half-float texture, whereas "
+"0 or 2 create a 32 bpc float texture, like the 'floatprecision' values 1 and 2 of "
+"Screen('MakeTexture').\n"
 "In any case, 'errorMsg' is either empty on success, 'unknown-format' if the file was "
 "not recognized as a supported HDR format, or a loader specific error message if the "
 "file could not be loaded for some reason.\n"
 "'imageArray' is a height-by-width-by-channels double matrix containing the pixel "
 "data in usual Matlab format, e.g., 4 channels RGBA planes. 'imageArray' can be "
 "directly passed into Screen('MakeTexture', win, imageArray); to turn it into a "
-"displayable image texture.\n"
+"displayable image texture. If 'windowPtr' is provided, 'imageArray' is the handle "
+"of the created texture instead, or a row vector of texture handles, one for each "
+"file, if multiple files were listed in 'filename'. The handle of a file which could "
+"not be loaded is zero, and 'errorMsg' is the error message of the first such file.\n"
 "'format' is a name string that identifies the format of the image file read.\n"
 "'auxInfo' is a struct with additional properties and information about an image if "
 "the image file supports such additional meta information. If an image file format "
 "does not support useful additional information then 'auxInfo' will be an empty [] "
 "matrix. The fields of the struct are dependent on the file format and specific "
 "image file, so don't assume a fixed set of fields and fieldNames for a returned "
-"'auxInfo' struct.\n"
+"'auxInfo' struct. For multiple files, 'auxInfo' is a struct array with one element "
+"per file.\n"
 "\n"
 "The following HDR file formats are currently supported:\n"
 "* OpenEXR file format (file suffix \".exr\", 'format' = \"openexr\"), via use of the "
 "included open-source TinyEXR library (https://github.com/syoyo/tinyexr). Only "
 "single-part RGB(A) images are supported at the moment, no multi-part images or "
-"deep images. Only color channels are supported, no integer id channels.\n"
+"deep images. Only color channels are supported, no integer id channels. Files are "
+"memory-mapped, and tiles or scanline blocks are decoded in parallel on all processor "
+"cores.\n"
 "The 'auxInfo' struct for OpenEXR images contains the following struct fields:\n"
 "'ColorGamut' a 2-by-4 matrix defining the CIE 1931 2D chromaticity coordinates "
 "of the red, green and blue primaries and white-point of the gamut / color-space "
@@ -67,244 +115,430 @@ static char synopsisString[] =
 "\n";
 static char seeAlsoString[] = "MakeTexture";
 
-PsychError SCREENReadHDRImage(void)
+static void PsychLoadHDRImageFile(PsychHDRImageLoadType *load)
 {
-    size_t      ix, iy, outWidth, outHeight, rIndex, gIndex, bIndex, aIndex;
-    double      *returnArrayBaseDouble;
-    float       *rgba = NULL;
-    const char  *err = NULL;
-    char        *filename;
-    int         width, height, nrchannels;
-    int         errorMode, rc;
+    // OpenEXR .exr file filename?
+    if (TINYEXR_SUCCESS == IsEXR(load->filename)) {
+        // Yes: Load it as interleaved RGBA float or half float image:
+        load->rc = PsychLoadEXRImage(load->filename, load->halfFloat, &load->rgba, &load->width, &load->height, &load->exrHeader, &load->err);
+    }
+    else {
+        // Unknown format:
+        load->rc = TINYEXR_ERROR_INVALID_MAGIC_NUMBER;
+        load->err = NULL;
+    }
+}
 
-    // Provide help if needed:
-    PsychPushHelp(useString, synopsisString, seeAlsoString);
-    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+static void* PsychHDRBatchLoaderThreadMain(void *arg)
+{
+    PsychHDRBatchLoaderType *loader = (PsychHDRBatchLoaderType*) arg;
+    int i;
 
-    // Cap the numbers of inputs and outputs
-    PsychErrorExit(PsychCapNumInputArgs(2));        // The maximum number of inputs
-    PsychErrorExit(PsychRequireNumInputArgs(1));    // Min. 1 input args required.
-    PsychErrorExit(PsychCapNumOutputArgs(4));       // The maximum number of outputs
+    PsychSetThreadName("PTBHDRLoader");
 
-    // Get image file name:
-    PsychAllocInCharArg(1, kPsychArgRequired, &filename);
+    // Grab and load files from the list until all are taken:
+    while (TRUE) {
+        PsychLockMutex(&loader->mutex);
+        i = loader->next++;
+        PsychUnlockMutex(&loader->mutex);
 
-    // Get optional errorMode:
-    errorMode = 0;
-    PsychCopyInIntegerArg(2, kPsychArgOptional, &errorMode);
-    if (errorMode < 0 || errorMode > 2)
-        PsychErrorExitMsg(PsychError_user, "Invalid errorMode flag provided: Must be 0, 1 or 2.");
+        if (i >= loader->count)
+            break;
 
-    // OpenEXR .exr file filename?
-    if (TINYEXR_SUCCESS == IsEXR(filename)) {
-        PsychGenericScriptType *s;
-        PsychGenericScriptType *outMat;
-        double *v;
-        EXRVersion exrVersion;
-        EXRHeader exrHeader;
-        const char *fixedFieldNames[] = { "dataWindow", "displayWindow", "pixelAspectRatio", "screenWindowWidth", "screenWindowCenter",
-                                          "lineOrder", "compression", "GamutFromFile", "ColorGamut", "sampleToNits" };
-        #define fixedFieldCount 10
-        const char *fieldNames[TINYEXR_MAX_CUSTOM_ATTRIBUTES + fixedFieldCount];
-        int i, fieldCount;
-        int hasChroma = 0;
-        double sampToNits = 0;
-
-        // Yes: Load it via TinyEXR simple loader api:
-        rc = LoadEXR(&rgba, &width, &height, filename, &err);
-        if (rc) {
-            if ((errorMode > 0) && (PsychPrefStateGet_Verbosity() > 0))
-                printf("PTB-ERROR: ReadHDRImage: Reading OpenEXR image file '%s' failed: %s\n", filename, err);
-
-            goto out;
+        PsychLoadHDRImageFile(&loader->loads[i]);
+    }
+
+    return(NULL);
+}
+
+// Load all files, spread over up to kPsychMaxHDRLoaderThreads threads:
+static void PsychLoadHDRImageFiles(PsychHDRImageLoadType *loads, int count)
+{
+    PsychHDRBatchLoaderType loader;
+    psych_thread threads[kPsychMaxHDRLoaderThreads];
+    int i, nthreads;
+
+    loader.loads = loads;
+    loader.count = count;
+    loader.next = 0;
+    PsychInitMutex(&loader.mutex);
+
+    nthreads = (count < kPsychMaxHDRLoaderThreads) ? count : kPsychMaxHDRLoaderThreads;
+    for (i = 1; i < nthreads; i++) {
+        if (PsychCreateThread(&threads[i], NULL, PsychHDRBatchLoaderThreadMain, (void*) &loader)) {
+            if (PsychPrefStateGet_Verbosity() > 1)
+                printf("PTB-WARNING: ReadHDRImage: Failed to create loader thread. Loading with fewer threads.\n");
+
+            break;
         }
+    }
+    nthreads = i;
+
+    // Our own thread participates as well:
+    PsychHDRBatchLoaderThreadMain((void*) &loader);
+
+    for (i = 1; i < nthreads; i++)
+        PsychDeleteThread(&threads[i]);
+
+    PsychDestroyMutex(&loader.mutex);
+}
+
+// Create a floating point RGBA texture for windowRecord directly from the decoded image of load,
+// taking ownership of its image buffer. Returns the texture handle:
+static double PsychHDRImageMakeTexture(PsychWindowRecordType *windowRecord, PsychHDRImageLoadType *load, int usefloatformat)
+{
+    PsychWindowRecordType *textureRecord;
+
+    PsychCreateWindowRecord(&textureRecord);
+    textureRecord->windowType = kPsychTexture;
+    textureRecord->screenNumber = windowRecord->screenNumber;
+    PsychMakeRect(textureRecord->rect, 0, 0, load->width, load->height);
+
+    // Hand our buffer over, so PsychCreateTexture() uploads and then free()s it:
+    textureRecord->textureMemory = load->rgba;
+    textureRecord->textureMemorySizeBytes = (size_t) 4 * ((load->halfFloat) ? 2 : sizeof(float)) * (size_t) load->width * (size_t) load->height;
+    load->rgba = NULL;
+
+    textureRecord->depth = (usefloatformat == 1) ? 64 : 128;
+    textureRecord->nrchannels = 4;
+    textureRecord->textureexternalformat = GL_RGBA;
+    textureRecord->textureexternaltype = (load->halfFloat) ? GL_HALF_FLOAT_ARB : GL_FLOAT;
+    textureRecord->textureinternalformat = (usefloatformat == 1) ? GL_RGBA_FLOAT16_APPLE : GL_RGBA_FLOAT32_APPLE;
+
+    // Override for missing floating point texture support: Try to use 16 bit fixed point signed normalized textures [-1.0 ; 1.0] resolved at 15 bits:
+    if ((usefloatformat == 1) && !(windowRecord->gfxcaps & kPsychGfxCapFPTex16)) textureRecord->textureinternalformat = GL_RGBA16_SNORM;
 
-        // Return format id:
-        PsychCopyOutCharArg(2, kPsychArgOptional, "openexr");
+    // Rows of RGBA half or float pixels are always 8 byte aligned:
+    textureRecord->textureByteAligned = 8;
 
-        outWidth = (size_t) width;
-        outHeight = (size_t) height;
-        nrchannels = 4;
+    PsychAssignParentWindow(textureRecord, windowRecord);
 
-        rc = ParseEXRVersionFromFile(&exrVersion, filename);
-        if (rc) {
-            if ((errorMode > 0) && (PsychPrefStateGet_Verbosity() > 0))
-                printf("PTB-ERROR: ReadHDRImage: Reading version of OpenEXR image file '%s' failed: %s\n", filename, err);
+    // Decoded image has its top row first, like decoded movie frames, so orientation is 3 - like
+    // an upside down Offscreen window texture:
+    textureRecord->textureOrientation = 3;
 
-            goto out;
+    PsychCreateTexture(textureRecord);
+    PsychAssignHighPrecisionTextureShaders(textureRecord, windowRecord, usefloatformat, 0);
+
+    PsychSetWindowRecordValid(textureRecord);
+
+    return((double) textureRecord->windowIndex);
+}
+
+// Append the names of all custom attributes of exrHeader not yet in fieldNames, return new count:
+static int PsychHDRAuxInfoAddFieldNames(EXRHeader *exrHeader, const char **fieldNames, int fieldCount)
+{
+    int i, j;
+
+    for (i = 0; i < exrHeader->num_custom_attributes; i++) {
+        for (j = 0; j < fieldCount; j++) {
+            if (!strcmp(fieldNames[j], exrHeader->custom_attributes[i].name))
+                break;
         }
 
-        // Parse EXR file header for optional attributes:
-        InitEXRHeader(&exrHeader);
-        rc = ParseEXRHeaderFromFile(&exrHeader, &exrVersion, filename, &err);
-        if (rc) {
-            if ((errorMode > 0) && (PsychPrefStateGet_Verbosity() > 0))
-                printf("PTB-ERROR: ReadHDRImage: Reading header of OpenEXR image file '%s' failed: %s\n", filename, err);
+        if (j == fieldCount)
+            fieldNames[fieldCount++] = exrHeader->custom_attributes[i].name;
+    }
+
+    return(fieldCount);
+}
 
-            goto out;
+// Assign the attributes of exrHeader to element index of auxInfo struct array s:
+static void PsychHDRAuxInfoSetElement(EXRHeader *exrHeader, int index, PsychGenericScriptType *s)
+{
+    PsychGenericScriptType *outMat;
+    double *v;
+    int i;
+    int hasChroma = 0;
+    double sampToNits = 0;
+
+    // First fixed attributes which matter:
+
+    // Return dataWindow as typical PTB rect:
+    PsychAllocateNativeDoubleMat(1, 4, 1, &v, &outMat);
+    *(v++) = exrHeader->data_window.min_x;
+    *(v++) = exrHeader->data_window.min_y;
+    *(v++) = exrHeader->data_window.max_x;
+    *(v++) = exrHeader->data_window.max_y;
+    PsychSetStructArrayNativeElement("dataWindow", index, outMat, s);
+
+    // Return displayWindow as typical PTB rect:
+    PsychAllocateNativeDoubleMat(1, 4, 1, &v, &outMat);
+    *(v++) = exrHeader->display_window.min_x;
+    *(v++) = exrHeader->display_window.min_y;
+    *(v++) = exrHeader->display_window.max_x;
+    *(v++) = exrHeader->display_window.max_y;
+    PsychSetStructArrayNativeElement("displayWindow", index, outMat, s);
+
+    // Return screenWindowCenter as 2D vector:
+    PsychAllocateNativeDoubleMat(1, 2, 1, &v, &outMat);
+    *(v++) = exrHeader->screen_window_center[0];
+    *(v++) = exrHeader->screen_window_center[1];
+    PsychSetStructArrayNativeElement("screenWindowCenter", index, outMat, s);
+
+    PsychSetStructArrayDoubleElement("screenWindowWidth", index, exrHeader->screen_window_width, s);
+    PsychSetStructArrayDoubleElement("pixelAspectRatio", index, exrHeader->pixel_aspect_ratio, s);
+    PsychSetStructArrayDoubleElement("lineOrder", index, exrHeader->line_order, s);
+    PsychSetStructArrayDoubleElement("compression", index, exrHeader->compression_type, s);
+
+    for (i = 0; i < exrHeader->num_custom_attributes; i++) {
+        if (!strcmp(exrHeader->custom_attributes[i].type, "float"))
+            PsychSetStructArrayDoubleElement(exrHeader->custom_attributes[i].name, index, (double) *((float*) exrHeader->custom_attributes[i].value), s);
+
+        if (!strcmp(exrHeader->custom_attributes[i].type, "string"))
+            PsychSetStructArrayStringElement(exrHeader->custom_attributes[i].name, index, (char*) exrHeader->custom_attributes[i].value, s);
+
+        // Mark existence of optional sampToNits attribute for translating sample values to absolute nits:
+        if (!strcmp(exrHeader->custom_attributes[i].name, "sampToNits") && !strcmp(exrHeader->custom_attributes[i].type, "float")) {
+            sampToNits = (double) *((float*) exrHeader->custom_attributes[i].value);
         }
 
-        // Got the header. Parse attributes we care about:
-
-        // Build array with attribute names aka struct field names:
-        fieldCount = fixedFieldCount + exrHeader.num_custom_attributes;
-        for (i = 0; i < fieldCount; i++)
-            fieldNames[i] = (i < fixedFieldCount) ? fixedFieldNames[i] : exrHeader.custom_attributes[i - fixedFieldCount].name;
-
-        // Build struct with all fields, assign as 4th return argument:
-        PsychAllocOutStructArray(4, kPsychArgOptional, -1, fieldCount, fieldNames, &s);
-
-        // First fixed attributes which matter:
-
-        // Return dataWindow as typical PTB rect:
-        PsychAllocateNativeDoubleMat(1, 4, 1, &v, &outMat);
-        *(v++) = exrHeader.data_window.min_x;
-        *(v++) = exrHeader.data_window.min_y;
-        *(v++) = exrHeader.data_window.max_x;
-        *(v++) = exrHeader.data_window.max_y;
-        PsychSetStructArrayNativeElement("dataWindow", 0, outMat, s);
-
-        // Return displayWindow as typical PTB rect:
-        PsychAllocateNativeDoubleMat(1, 4, 1, &v, &outMat);
-        *(v++) = exrHeader.display_window.min_x;
-        *(v++) = exrHeader.display_window.min_y;
-        *(v++) = exrHeader.display_window.max_x;
-        *(v++) = exrHeader.display_window.max_y;
-        PsychSetStructArrayNativeElement("displayWindow", 0, outMat, s);
-
-        // Return screenWindowCenter as 2D vector:
-        PsychAllocateNativeDoubleMat(1, 2, 1, &v, &outMat);
-        *(v++) = exrHeader.screen_window_center[0];
-        *(v++) = exrHeader.screen_window_center[1];
-        PsychSetStructArrayNativeElement("screenWindowCenter", 0, outMat, s);
-
-        PsychSetStructArrayDoubleElement("screenWindowWidth", 0, exrHeader.screen_window_width, s);
-        PsychSetStructArrayDoubleElement("pixelAspectRatio", 0, exrHeader.pixel_aspect_ratio, s);
-        PsychSetStructArrayDoubleElement("lineOrder", 0, exrHeader.line_order, s);
-        PsychSetStructArrayDoubleElement("compression", 0, exrHeader.compression_type, s);
-
-        for (i = 0; i < exrHeader.num_custom_attributes; i++) {
-            if (!strcmp(exrHeader.custom_attributes[i].type, "float"))
-                PsychSetStructArrayDoubleElement(exrHeader.custom_attributes[i].name, 0, (double) *((float*) exrHeader.custom_attributes[i].value), s);
-
-            if (!strcmp(exrHeader.custom_attributes[i].type, "string"))
-                PsychSetStructArrayStringElement(exrHeader.custom_attributes[i].name, 0, (char*) exrHeader.custom_attributes[i].value, s);
-
-            // Mark existence of optional sampToNits attribute for translating sample values to absolute nits:
-            if (!strcmp(exrHeader.custom_attributes[i].name, "sampToNits") && !strcmp(exrHeader.custom_attributes[i].type, "float")) {
-                sampToNits = (double) *((float*) exrHeader.custom_attributes[i].value);
-            }
+        if (!strcmp(exrHeader->custom_attributes[i].type, "chromaticities") && (exrHeader->custom_attributes[i].size == 32)) {
+            int j;
+            float *cv = (float*) exrHeader->custom_attributes[i].value;
 
-            if (!strcmp(exrHeader.custom_attributes[i].type, "chromaticities") && (exrHeader.custom_attributes[i].size == 32)) {
-                int j;
-                float *cv = (float*) exrHeader.custom_attributes[i].value;
+            // Create color gamut and white point matrix and assign to OpenEXR standard attribute 'chromaticities':
+            PsychAllocateNativeDoubleMat(2, 4, 1, &v, &outMat);
+            for (j = 0; j < 8; j++)
+                *(v++) = cv[j];
+
+            PsychSetStructArrayNativeElement(exrHeader->custom_attributes[i].name, index, outMat, s);
 
-                // Create color gamut and white point matrix and assign to OpenEXR standard attribute 'chromaticities':
+            // If this is really the standardized 'chromaticities' attribute, then store its gamut
+            // information in our standard struct field for gamut information:
+            if (!strcmp(exrHeader->custom_attributes[i].name, "chromaticities")) {
+                // Again: Create color gamut and white point matrix and assign to our 'ColorGamut' standard struct field:
                 PsychAllocateNativeDoubleMat(2, 4, 1, &v, &outMat);
                 for (j = 0; j < 8; j++)
                     *(v++) = cv[j];
 
-                PsychSetStructArrayNativeElement(exrHeader.custom_attributes[i].name, 0, outMat, s);
-
-                // If this is really the standardized 'chromaticities' attribute, then store its gamut
-                // information in our standard struct field for gamut information:
-                if (!strcmp(exrHeader.custom_attributes[i].name, "chromaticities")) {
-                    // Again: Create color gamut and white point matrix and assign to our 'ColorGamut' standard struct field:
-                    PsychAllocateNativeDoubleMat(2, 4, 1, &v, &outMat);
-                    for (j = 0; j < 8; j++)
-                        *(v++) = cv[j];
-
-                    PsychSetStructArrayNativeElement("ColorGamut", 0, outMat, s);
-                    hasChroma = 1;
-                }
+                PsychSetStructArrayNativeElement("ColorGamut", index, outMat, s);
+                hasChroma = 1;
             }
         }
+    }
 
-        // If the optional sampToNits attribute was not provided by the file then add
-        // a dummy one with the obviously invalid value 0:
-        PsychSetStructArrayDoubleElement("sampleToNits", 0, sampToNits, s);
-
-        // Mark 'ColorGamut' as coming from the file, or not, depending if we found a
-        // chromaticities attribute or not:
-        PsychSetStructArrayDoubleElement("GamutFromFile", 0, hasChroma, s);
-        if (!hasChroma) {
-            // No chromaticities attribute in file, so we don't know the true
-            // color gamut / color space of the image file. OpenEXR spec says
-            // we should assume BT-709 color space and gamut in this case, so
-            // manually assign the color primaries and white point of BT-709:
-            // Create color gamut and white point matrix:
-            PsychAllocateNativeDoubleMat(2, 4, 1, &v, &outMat);
+    // If the optional sampToNits attribute was not provided by the file then add
+    // a dummy one with the obviously invalid value 0:
+    PsychSetStructArrayDoubleElement("sampleToNits", index, sampToNits, s);
 
-            *(v++) = 0.6400; // Red
-            *(v++) = 0.3300;
+    // Mark 'ColorGamut' as coming from the file, or not, depending if we found a
+    // chromaticities attribute or not:
+    PsychSetStructArrayDoubleElement("GamutFromFile", index, hasChroma, s);
+    if (!hasChroma) {
+        // No chromaticities attribute in file, so we don't know the true
+        // color gamut / color space of the image file. OpenEXR spec says
+        // we should assume BT-709 color space and gamut in this case, so
+        // manually assign the color primaries and white point of BT-709:
+        // Create color gamut and white point matrix:
+        PsychAllocateNativeDoubleMat(2, 4, 1, &v, &outMat);
 
-            *(v++) = 0.3000; // Green
-            *(v++) = 0.6000;
+        *(v++) = 0.6400; // Red
+        *(v++) = 0.3300;
 
-            *(v++) = 0.1500; // Blue
-            *(v++) = 0.0600;
+        *(v++) = 0.3000; // Green
+        *(v++) = 0.6000;
 
-            *(v++) = 0.3127; // White point
-            *(v++) = 0.3290;
+        *(v++) = 0.1500; // Blue
+        *(v++) = 0.0600;
 
-            PsychSetStructArrayNativeElement("ColorGamut", 0, outMat, s);
-        }
+        *(v++) = 0.3127; // White point
+        *(v++) = 0.3290;
 
-        // Done with the header:
-        FreeEXRHeader(&exrHeader);
+        PsychSetStructArrayNativeElement("ColorGamut", index, outMat, s);
     }
-    else {
-        if ((errorMode > 0) && (PsychPrefStateGet_Verbosity() > 1))
-            printf("PTB-ERROR: ReadHDRImage: File '%s' does not exist, or has unknown/unsupported image format.\n", filename);
+}
+
+PsychError SCREENReadHDRImage(void)
+{
+    PsychWindowRecordType   *windowRecord = NULL;
+    PsychHDRImageLoadType   *loads;
+    PsychGenericScriptType  *s;
+    size_t      ix, iy, ic, outWidth, outHeight, planeSize;
+    double      *returnArrayBaseDouble, *textures;
+    float       *returnArrayBaseFloat, *rgba;
+    const char  *fixedFieldNames[] = { "dataWindow", "displayWindow", "pixelAspectRatio", "screenWindowWidth", "screenWindowCenter",
+                                       "lineOrder", "compression", "GamutFromFile", "ColorGamut", "sampleToNits" };
+    const char  **fieldNames;
+    char        *filename, *filenames, *nextname;
+    int         errorMode, precision, usefloatformat, halfFloat, count, failed, loaded, i, fieldCount;
+
+    // Provide help if needed:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    // Cap the numbers of inputs and outputs
+    PsychErrorExit(PsychCapNumInputArgs(4));        // The maximum number of inputs
+    PsychErrorExit(PsychRequireNumInputArgs(1));    // Min. 1 input args required.
+    PsychErrorExit(PsychCapNumOutputArgs(4));       // The maximum number of outputs
+
+    // Get image file name:
+    PsychAllocInCharArg(1, kPsychArgRequired, &filenames);
+
+    // Get optional errorMode:
+    errorMode = 0;
+    PsychCopyInIntegerArg(2, kPsychArgOptional, &errorMode);
+    if (errorMode < 0 || errorMode > 2)
+        PsychErrorExitMsg(PsychError_user, "Invalid errorMode flag provided: Must be 0, 1 or 2.");
+
+    // Get optional precision:
+    precision = 0;
+    PsychCopyInIntegerArg(3, kPsychArgOptional, &precision);
+    if (precision < 0 || precision > 2)
+        PsychErrorExitMsg(PsychError_user, "Invalid precision provided: Must be 0, 1 or 2.");
+
+    // Get optional window for direct texture creation:
+    PsychAllocInWindowRecordArg(4, kPsychArgOptional, &windowRecord);
+
+    // Split list of newline separated file names, skipping empty ones:
+    count = 0;
+    for (filename = filenames; filename && *filename; filename = nextname) {
+        nextname = strchr(filename, '\n');
+        if (nextname) *(nextname++) = 0;
+        if (*filename && strcmp(filename, "\r")) count++;
+    }
+
+    if (count == 0)
+        PsychErrorExitMsg(PsychError_user, "Invalid empty 'filename' provided.");
 
-        goto out;
+    if ((count > 1) && !windowRecord)
+        PsychErrorExitMsg(PsychError_user, "Loading multiple files at once requires a 'windowPtr' to create textures for them.");
+
+    halfFloat = 0;
+    usefloatformat = 2;
+    if (windowRecord) {
+        if (!(windowRecord->gfxcaps & kPsychGfxCapFPTex32) && !(windowRecord->gfxcaps & kPsychGfxCapFPTex16))
+            PsychErrorExitMsg(PsychError_user, "Creation of a floating point precision texture requested, but this is not supported by your hardware!");
+
+        // 16 bpc float texture requested? OpenGL-ES can't do it, so upgrade to 32 bpc, like MakeTexture:
+        usefloatformat = ((precision == 1) && !PsychIsGLES(windowRecord)) ? 1 : 2;
+
+        if ((usefloatformat == 1) && !(windowRecord->gfxcaps & kPsychGfxCapFPTex16) && (windowRecord->imagingMode & kPsychNeedHDRWindow))
+            PsychErrorExitMsg(PsychError_user, "Creation of a 16 bpc floating point precision texture requested in HDR display mode, but this is not supported by your hardware!");
+
+        // Decode half float channels as half float and upload them as such, if the texture is 16 bpc float:
+        PsychSetGLContext(windowRecord);
+        halfFloat = ((usefloatformat == 1) && (windowRecord->gfxcaps & kPsychGfxCapFPTex16) && glewIsSupported("GL_ARB_half_float_pixel")) ? 1 : 0;
     }
 
-    // Readback of standard 32bpc float pixels into a double matrix:
-    PsychAllocOutDoubleMatArg(1, kPsychArgOptional, outHeight, outWidth, nrchannels, &returnArrayBaseDouble);
-
-    // Transpose and convert from packed/interleaved float -> planar double what we got, before returning it:
-    for (ix = 0; ix < outWidth; ix++) {
-        for (iy = 0; iy < outHeight; iy++) {
-            // Compute write-indices for returned data:
-            rIndex = PsychIndexElementFrom3DArray(outHeight, outWidth, nrchannels, iy, ix, 0);
-            gIndex = PsychIndexElementFrom3DArray(outHeight, outWidth, nrchannels, iy, ix, 1);
-            bIndex = PsychIndexElementFrom3DArray(outHeight, outWidth, nrchannels, iy, ix, 2);
-            aIndex = PsychIndexElementFrom3DArray(outHeight, outWidth, nrchannels, iy, ix, 3);
-
-            if (nrchannels > 0) returnArrayBaseDouble[rIndex] = rgba[(ix + iy * outWidth) * (size_t) nrchannels + 0];
-            if (nrchannels > 1) returnArrayBaseDouble[gIndex] = rgba[(ix + iy * outWidth) * (size_t) nrchannels + 1];
-            if (nrchannels > 2) returnArrayBaseDouble[bIndex] = rgba[(ix + iy * outWidth) * (size_t) nrchannels + 2];
-            if (nrchannels > 3) returnArrayBaseDouble[aIndex] = rgba[(ix + iy * outWidth) * (size_t) nrchannels + 3];
+    loads = (PsychHDRImageLoadType*) PsychMallocTemp(count * sizeof(PsychHDRImageLoadType));
+    memset(loads, 0, count * sizeof(PsychHDRImageLoadType));
+    for (i = 0, filename = filenames; i < count; filename += strlen(filename) + 1) {
+        if (*filename && strcmp(filename, "\r")) {
+            // Strip carriage return of Windows style line endings:
+            if (filename[strlen(filename) - 1] == '\r') filename[strlen(filename) - 1] = 0;
+            loads[i].filename = filename;
+            loads[i++].halfFloat = halfFloat;
         }
     }
 
-    // Clean up:
-    if (rgba)
-        free(rgba);
+    // Load and decode all files, concurrently if there are multiple:
+    if (count > 1)
+        PsychLoadHDRImageFiles(loads, count);
+    else
+        PsychLoadHDRImageFile(&loads[0]);
+
+    // Report failures:
+    failed = -1;
+    for (i = count - 1; i >= 0; i--) {
+        if (loads[i].rc) {
+            failed = i;
+            if ((errorMode > 0) && (PsychPrefStateGet_Verbosity() > 0)) {
+                if (loads[i].err)
+                    printf("PTB-ERROR: ReadHDRImage: Reading OpenEXR image file '%s' failed: %s\n", loads[i].filename, loads[i].err);
+                else
+                    printf("PTB-ERROR: ReadHDRImage: File '%s' does not exist, or has unknown/unsupported image format.\n", loads[i].filename);
+            }
+        }
+    }
 
-    // No error:
-    FreeEXRErrorMessage(err);
+    if ((failed >= 0) && ((count == 1) || (errorMode > 1))) {
+        // Return errorMsg with reason for the failure:
+        PsychCopyOutCharArg(3, kPsychArgOptional, loads[failed].err ? loads[failed].err : "unknown-format");
 
-    // Return empty errorMsg for "success":
-    PsychCopyOutCharArg(3, kPsychArgOptional, "");
+        for (i = 0; i < count; i++) {
+            if (loads[i].rc == 0) {
+                free(loads[i].rgba);
+                FreeEXRHeader(&loads[i].exrHeader);
+            }
+            FreeEXRErrorMessage(loads[i].err);
+        }
 
-    return(PsychError_none);
+        if (errorMode > 1)
+            PsychErrorExitMsg(PsychError_user, "HDR image file read failed. For reason, see above.");
+
+        // Return empty return arguments:
+        PsychAllocOutDoubleMatArg(1, kPsychArgOptional, 0, 0, 0, &returnArrayBaseDouble);
+        PsychCopyOutCharArg(2, kPsychArgOptional, "");
+        PsychAllocOutDoubleMatArg(4, kPsychArgOptional, 0, 0, 0, &returnArrayBaseDouble);
+
+        return(PsychError_none);
+    }
 
-out: // Error out:
+    // Build array with attribute names aka struct field names of all loaded images:
+    fieldNames = (const char**) PsychMallocTemp((fixedFieldCount + count * TINYEXR_MAX_CUSTOM_ATTRIBUTES) * sizeof(char*));
+    for (fieldCount = 0; fieldCount < fixedFieldCount; fieldCount++)
+        fieldNames[fieldCount] = fixedFieldNames[fieldCount];
 
-    // Return empty return arguments:
-    PsychAllocOutDoubleMatArg(1, kPsychArgOptional, 0, 0, 0, &returnArrayBaseDouble);
-    PsychCopyOutCharArg(2, kPsychArgOptional, "");
+    for (i = 0; i < count; i++) {
+        if (loads[i].rc == 0)
+            fieldCount = PsychHDRAuxInfoAddFieldNames(&loads[i].exrHeader, fieldNames, fieldCount);
+    }
+
+    // Build struct with all fields, assign as 4th return argument:
+    PsychAllocOutStructArray(4, kPsychArgOptional, (count > 1) ? count : -1, fieldCount, fieldNames, &s);
 
-    // Return errorMsg with reason for the failure:
-    PsychCopyOutCharArg(3, kPsychArgOptional, err ? err : "unknown-format");
-    FreeEXRErrorMessage(err);
+    loaded = 0;
+    for (i = 0; i < count; i++) {
+        if (loads[i].rc == 0) {
+            PsychHDRAuxInfoSetElement(&loads[i].exrHeader, i, s);
+            loaded++;
+        }
+    }
+
+    // Return format id:
+    PsychCopyOutCharArg(2, kPsychArgOptional, (loaded > 0) ? "openexr" : "");
+
+    if (windowRecord) {
+        // Turn the images directly into textures. Failed ones get a zero handle:
+        PsychAllocOutDoubleMatArg(1, kPsychArgOptional, 1, count, 1, &textures);
+        for (i = 0; i < count; i++)
+            textures[i] = (loads[i].rc == 0) ? PsychHDRImageMakeTexture(windowRecord, &loads[i], usefloatformat) : 0;
+    }
+    else {
+        outWidth = (size_t) loads[0].width;
+        outHeight = (size_t) loads[0].height;
+        planeSize = outWidth * outHeight;
+        rgba = (float*) loads[0].rgba;
+
+        // Transpose and convert from packed/interleaved RGBA float -> planar double or float matrix:
+        if (precision == 0) {
+            PsychAllocOutDoubleMatArg(1, kPsychArgOptional, outHeight, outWidth, 4, &returnArrayBaseDouble);
+            for (ix = 0; ix < outWidth; ix++)
+                for (iy = 0; iy < outHeight; iy++)
+                    for (ic = 0; ic < 4; ic++)
+                        returnArrayBaseDouble[ic * planeSize + ix * outHeight + iy] = (double) rgba[(ix + iy * outWidth) * 4 + ic];
+        }
+        else {
+            PsychAllocOutFloatMatArg(1, kPsychArgOptional, outHeight, outWidth, 4, &returnArrayBaseFloat);
+            for (ix = 0; ix < outWidth; ix++)
+                for (iy = 0; iy < outHeight; iy++)
+                    for (ic = 0; ic < 4; ic++)
+                        returnArrayBaseFloat[ic * planeSize + ix * outHeight + iy] = rgba[(ix + iy * outWidth) * 4 + ic];
+        }
+    }
 
-    PsychAllocOutDoubleMatArg(4, kPsychArgOptional, 0, 0, 0, &returnArrayBaseDouble);
+    // Return empty errorMsg for "success", or the reason for the first failed file of a batch:
+    PsychCopyOutCharArg(3, kPsychArgOptional, (failed < 0) ? "" : (loads[failed].err ? loads[failed].err : "unknown-format"));
 
-    if (errorMode > 1)
-        PsychErrorExitMsg(PsychError_user, "HDR image file read failed. For reason, see above.");
+    // Clean up:
+    for (i = 0; i < count; i++) {
+        if (loads[i].rc == 0) {
+            free(loads[i].rgba);
+            FreeEXRHeader(&loads[i].exrHeader);
+        }
+        FreeEXRErrorMessage(loads[i].err);
+    }
 
     return(PsychError_none);
 }
@@ -33,6 +33,11 @@ static char synopsisString[] =	"Set current time index for movie object with han
 								"first frame in the movie.\n\n"
 								"Specifying a new timeindex in seconds is usually faster than specifying a "
 								"timeindex in frames.\n\n"
+								"If the movie was opened with the 'SeekIndex' keyword in the 'movieOptions' of "
+								"Screen('OpenMovie'), seeks are frame-accurate and deterministic, also in movie "
+								"formats with long groups of pictures, e.g., H.264. While the movie is stopped, "
+								"recently decoded frames are cached, so seeking back to one of them, e.g., stepping "
+								"back by one frame, is very fast.\n\n"
 								"The function optionally returns the old position in seconds in the return "
 								"argument 'oldtimeindex'.\n";
 
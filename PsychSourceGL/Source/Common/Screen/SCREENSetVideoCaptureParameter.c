@@ -52,6 +52,22 @@ static char synopsisString[] =  "Set video capture parameter 'parameterName' on
                                 "may need to be made while a capture device is not yet opened, so no valid 'capturePtr' exists. "
                                 "This setting is only honored on the GStreamer video capture engine.\n"
                                 "'GetFramerate' Returns the nominal capture rate of the capture device.\n"
+                                "'GetZeroCopyFrameCount' and 'GetCopiedFrameCount' return the number of textures fetched since start "
+                                "of capture, which were imported without copy from video frames in DMA-BUF memory, resp. uploaded by "
+                                "copy, if zero-copy import was requested via recordingflags 16384 in Screen('OpenVideoCapture'). "
+                                "Only supported by the GStreamer video capture engine.\n"
+                                "'FrameStatistics' Select additional image statistics to compute from each fetched video frame, "
+                                "in the same pass over the image data as the average intensity returned by Screen('GetCapturedImage'): "
+                                "The value is the sum of 1 = Mean intensities, 2 = Minimum and maximum intensities, 4 = 256 bin histogram "
+                                "of intensities. 0 = Off, the default.\n"
+                                "'StatisticsChannel' Select the color channel over which statistics and the average intensity are computed: "
+                                "0 = Red or Luminance, 1 = Green, 2 = Blue, 3 = Alpha, -1 = All channels, the default.\n"
+                                "'SetStatisticsROI=left,top,right,bottom' Restrict statistics and the average intensity to the given "
+                                "rectangular region of interest of the video frame. 'SetStatisticsROI=' resets to the full frame.\n"
+                                "'GetFrameStatistics' Returns a struct with the statistics of the most recently fetched frame, "
+                                "including its presentation 'Timestamp', overall and per-channel mean, minimum and maximum intensities, "
+                                "normalized to the 0.0 - 1.0 range, and the 'Histogram' if requested. "
+                                "These statistics settings are only supported by the GStreamer video capture engine.\n"
                                 "'GetBandwidthUsage' Returns firewire bandwidth used by camera at current settings in "
                                 "so called bandwidth units. "
                                 "The 1394 bus has 4915 bandwidth units available per cycle. Each unit corresponds to "
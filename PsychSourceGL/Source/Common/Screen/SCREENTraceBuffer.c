@@ -0,0 +1,119 @@
+/*
+ *    SCREENTraceBuffer.c
+ *
+ *    AUTHORS:
+ *
+ *    agent@local                     ag
+ *
+ *    PLATFORMS:
+ *
+ *    All.
+ *
+ *    HISTORY:
+ *
+ *    19.10.2026    ag      Created.
+ *
+ *    DESCRIPTION:
+ *
+ *    Control and readout of the internal event tracing of Screen, implemented in PsychTraceSupport.c.
+ */
+
+#include "Screen.h"
+
+// If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
+static char useString[] = "[timestamps, eventIds, args, threadIndices, eventNames] = Screen('TraceBuffer', subCommand [, recordsPerThread or jsonFilename]);";
+//                          1           2         3     4              5                                     1             2
+static char synopsisString[] =
+"Control the low-overhead internal event tracing of Screen, e.g., to find out where the time went on a missed "
+"flip deadline.\n\n"
+"While tracing is enabled, Screen records timestamped events at interesting points of its operation, e.g., "
+"begin and end of Screen('Flip'), of the preflip operations of the imaging pipeline and of each executed "
+"processing hook chain, submission and completion of bufferswaps, wakeup of the flipper thread of asynchronous "
+"flips, texture creation, movie frame fetching and text drawing. Each thread records into its own preallocated "
+"ring buffer, so tracing does not allocate memory or take locks while recording. If a ring is full, the oldest "
+"records of that thread get overwritten.\n\n"
+"'subCommand' selects the operation:\n"
+"'Start' Enable tracing. The optional 'recordsPerThread' sets the capacity of the ring buffer of each thread, "
+"defaulting to 65536 records. A new capacity only applies to the calling thread and to threads which start recording later.\n"
+"'Stop' Disable tracing. Recorded events stay available for readout.\n"
+"'Clear' Discard all recorded events.\n"
+"'Get' Return all recorded events of all threads, sorted by time. If the optional 'jsonFilename' is given, then "
+"all events are also written as a JSON file in Chrome trace-event format, which can be viewed with the "
+"chrome://tracing page of the Chrome web browser, or with https://ui.perfetto.dev\n\n"
+"'Get' returns the following column vectors, one row per event: 'timestamps' are the GetSecs() times of the "
+"events. 'eventIds' are the event types, 'args' an event specific argument, e.g., the window handle for "
+"flip related events, the texture handle for texture creation, or the movie handle for movie fetches. "
+"'threadIndices' identifies the recording thread, 0 being the first thread to record, usually the main thread. "
+"'eventNames' is a cell array with the names of all event types, where eventNames{eventId + 1} is the name of "
+"event type eventId.\n"
+"Samples recorded by Screen's internal diagnostics for Screen('GetTimelist') also show up as events while tracing "
+"is enabled, with their sample number as argument. They are kept in their own list though, which 'Clear' does not "
+"affect, just as Screen('ClearTimelist') does not affect the trace buffer.\n";
+static char seeAlsoString[] = "GetTimelist ClearTimelist";
+
+PsychError SCREENTraceBuffer(void)
+{
+    PsychGenericScriptType  *cellVector;
+    char                    *cmdString, *filename;
+    char                    eventName[128];
+    double                  *timestamps, *eventIds, *args, *threadIndices;
+    int                     recordsPerThread, count, i;
+
+    // Provide help if needed:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    // Cap the numbers of inputs and outputs
+    PsychErrorExit(PsychCapNumInputArgs(2));        // The maximum number of inputs
+    PsychErrorExit(PsychRequireNumInputArgs(1));    // Min. 1 input arg required.
+    PsychErrorExit(PsychCapNumOutputArgs(5));       // The maximum number of outputs
+
+    PsychAllocInCharArg(1, kPsychArgRequired, &cmdString);
+
+    if (PsychMatch(cmdString, "Start")) {
+        recordsPerThread = 0;
+        if (PsychCopyInIntegerArg(2, kPsychArgOptional, &recordsPerThread) && (recordsPerThread < 1))
+            PsychErrorExitMsg(PsychError_user, "Invalid 'recordsPerThread' provided. Must be at least 1.");
+
+        PsychTraceStart(recordsPerThread);
+        return(PsychError_none);
+    }
+
+    if (PsychMatch(cmdString, "Stop")) {
+        PsychTraceStop();
+        return(PsychError_none);
+    }
+
+    if (PsychMatch(cmdString, "Clear")) {
+        PsychTraceClear();
+        return(PsychError_none);
+    }
+
+    if (!PsychMatch(cmdString, "Get")) PsychErrorExitMsg(PsychError_user, "Unknown subCommand provided. Must be 'Start', 'Stop', 'Clear' or 'Get'.");
+
+    // Write JSON file if requested:
+    filename = NULL;
+    if (PsychAllocInCharArg(2, kPsychArgOptional, &filename) && !PsychTraceWriteChromeJSON(filename))
+        PsychErrorExitMsg(PsychError_user, "Failed to write trace events to given 'jsonFilename'.");
+
+    // Return events as column vectors:
+    count = PsychTraceGetRecordCount(-1);
+    PsychAllocOutDoubleMatArg(1, kPsychArgOptional, count, 1, 1, &timestamps);
+    PsychAllocOutDoubleMatArg(2, kPsychArgOptional, count, 1, 1, &eventIds);
+    PsychAllocOutDoubleMatArg(3, kPsychArgOptional, count, 1, 1, &args);
+    PsychAllocOutDoubleMatArg(4, kPsychArgOptional, count, 1, 1, &threadIndices);
+
+    // Fill them. Threads may record further events in the meantime, so zero-fill any shortfall:
+    i = PsychTraceExport(-1, count, timestamps, eventIds, args, threadIndices);
+    for (; i < count; i++) timestamps[i] = eventIds[i] = args[i] = threadIndices[i] = 0;
+
+    // Names of all event types:
+    PsychAllocOutCellVector(5, kPsychArgOptional, kPsychTraceMaxEventId, &cellVector);
+    for (i = 0; i < kPsychTraceMaxEventId; i++) {
+        snprintf(eventName, sizeof(eventName), "%s%s", PsychTraceGetEventName(i),
+                 (PsychTraceGetEventPhase(i) == 'B') ? "Begin" : ((PsychTraceGetEventPhase(i) == 'E') ? "End" : ""));
+        PsychSetCellVectorStringElement(i, eventName, cellVector);
+    }
+
+    return(PsychError_none);
+}
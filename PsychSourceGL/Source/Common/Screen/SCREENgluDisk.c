@@ -82,7 +82,7 @@ PsychError SCREENgluDisk(void)
         glPopMatrix();
     }
     else {
-        PsychDrawDisc(windowRecord, (float) *xPosition, (float) *yPosition, 0, (float) dotSize, 30, 1, 1, 0, 360);
+        PsychDrawDisc(windowRecord, NULL, (float) *xPosition, (float) *yPosition, 0, (float) dotSize, 30, 1, 1, 0, 360);
     }
 
 	// Mark end of drawing op. This is needed for single buffered drawing:
@@ -77,10 +77,17 @@
 #include "PsychWindowSupport.h"
 #include "PsychMovieSupport.h"
 #include "PsychTextureSupport.h"
+#include "PsychTextureAtlasSupport.h"
+#include "PsychGlyphCacheSupport.h"
 #include "PsychAlphaBlending.h"
 #include "PsychVideoCaptureSupport.h"
+#include "PsychImageStatisticsSupport.h"
 #include "PsychImagingPipelineSupport.h"
+#include "PsychCacheDirSupport.h"
+#include "PsychShaderCacheSupport.h"
+#include "PsychRefreshCalibrationCache.h"
 #include "PsychMovieWritingSupport.h"
+#include "PsychTraceSupport.h"
 #include "ScreenArguments.h"
 #include "RegisterProject.h"
 #include "WindowHelpers.h"
@@ -103,7 +110,7 @@ void ScreenCloseAllWindows();                   //SCREENCloseAll.c
 //PsychGLGlue.c
 int             PsychConvertColorToDoubleVector(PsychColorType *color, PsychWindowRecordType *windowRecord, GLdouble *valueArray);
 void            PsychSetGLColor(PsychColorType *color, PsychWindowRecordType *windowRecord);
-void            PsychSetupVertexColorArrays(PsychWindowRecordType *windowRecord, psych_bool enable, int mc, double* colors, unsigned char *bytecolors);
+void            PsychSetupVertexColorArrays(PsychWindowRecordType *windowRecord, psych_bool enable, int mc, double* colors, unsigned char *bytecolors, psych_bool floatcolors);
 void            PsychSetArrayColor(PsychWindowRecordType *windowRecord, int i, int mc, double* colors, unsigned char *bytecolors);
 void            PsychGLClear(PsychWindowRecordType *windowRecord);
 void            PsychGLRect(PsychRectType psychRect);
@@ -111,7 +118,7 @@ char            *PsychGetGLErrorNameString(GLenum errorConstant);
 #define         PsychTestForGLErrors()        PsychTestForGLErrorsC(__LINE__, __func__, __FILE__)
 void            PsychTestForGLErrorsC(int lineNum, const char *funcName, const char *fileName);
 GLdouble        *PsychExtractQuadVertexFromRect(double *rect, int vertexNumber, GLdouble *vertex);
-void            PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos, int* coords_count, double** xy, int colors_pos, int* colors_count, int* colorcomponent_count, double** colors, unsigned char** bytecolors, int sizes_pos, int* sizes_count, double** size, psych_bool usefloat);
+void            PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos, int* coords_count, double** xy, int colors_pos, int* colors_count, int* colorcomponent_count, double** colors, unsigned char** bytecolors, int sizes_pos, int* sizes_count, double** size, psych_bool usefloat, psych_bool* floatcolors);
 void            PsychWaitPixelSyncToken(PsychWindowRecordType *windowRecord, psych_bool flushOnly);
 psych_bool      PsychIsGLClassic(PsychWindowRecordType *windowRecord);
 GLenum          PsychGLFloatType(PsychWindowRecordType *windowRecord);
@@ -125,7 +132,21 @@ void PsychGLVertex4f(PsychWindowRecordType *windowRecord, float x, float y, floa
 void PsychGLColor4f(PsychWindowRecordType *windowRecord, float r, float g, float b, float a);
 void PsychGLTexCoord4f(PsychWindowRecordType *windowRecord, float s, float t, float u, float v);
 void PsychGLRectd(PsychWindowRecordType *windowRecord, double x1, double y1, double x2, double y2);
-void PsychDrawDisc(PsychWindowRecordType *windowRecord, float xc, float yc, float innerRadius, float outerRadius, int numSlices, float xScale, float yScale, float startAngle, float arcAngle);
+// State of a batch of discs drawn by PsychDrawDisc() as one triangle strip, or as one instanced
+// draw call. Owned by the caller of PsychDrawDiscBatchBegin():
+typedef struct PsychDiscBatchType {
+    int     vertices;
+    float   lastx;
+    float   lasty;
+    float*  instances;      // Per disc attributes for instanced drawing, or NULL if drawn as triangle strip.
+    int     numInstances;
+    int     maxInstances;
+    int     maxSlices;
+} PsychDiscBatchType;
+
+void PsychDrawDisc(PsychWindowRecordType *windowRecord, PsychDiscBatchType *batch, float xc, float yc, float innerRadius, float outerRadius, int numSlices, float xScale, float yScale, float startAngle, float arcAngle);
+void PsychDrawDiscBatchBegin(PsychWindowRecordType *windowRecord, PsychDiscBatchType *batch, int maxDiscs);
+void PsychDrawDiscBatchEnd(PsychWindowRecordType *windowRecord, PsychDiscBatchType *batch);
 
 #define GLBEGIN(p) PsychGLBegin(windowRecord, (p))
 #define GLEND() PsychGLEnd(windowRecord)
@@ -141,6 +162,9 @@ void PsychComposeCompressedStereoBuffer(PsychWindowRecordType *windowRecord);
 // Helper routines for text renderers:
 void            PsychCleanupTextRenderer(PsychWindowRecordType* windowRecord);
 psych_bool      PsychLoadTextRendererPlugin(PsychWindowRecordType* windowRecord);
+int             PsychSetupTextRendererPlugin(PsychWindowRecordType* winRec);
+int             PsychMeasureTextWithPlugin(int ctx, unsigned int stringLengthChars, double* textUniDoubleString, float* bounds, float* xAdvance, double* lineHeight);
+int             PsychDrawTextWithPluginForAtlas(int ctx, int width, int height, double x, double y, unsigned int stringLengthChars, double* textUniDoubleString);
 void            PsychDrawCharText(PsychWindowRecordType* winRec, const char* textString, double* xp, double* yp, unsigned int yPositionIsBaseline, PsychColorType *textColor, PsychColorType *backgroundColor, PsychRectType* boundingbox);
 PsychError      PsychDrawUnicodeText(PsychWindowRecordType* winRec, PsychRectType* boundingbox, unsigned int stringLengthChars, double* textUniDoubleString, double* xp, double* yp, double* theight, double* xAdvance, unsigned int yPositionIsBaseline, PsychColorType *textColor, PsychColorType *backgroundColor, int swapTextDirection);
 PsychError      PsychOSDrawUnicodeText(PsychWindowRecordType* winRec, PsychRectType* boundingbox, unsigned int stringLengthChars, double* textUniDoubleString, double* xp, double* yp, unsigned int yPositionIsBaseline, PsychColorType *textColor, PsychColorType *backgroundColor);
@@ -258,6 +282,14 @@ PsychError SCREENGetFlipInfo(void);
 PsychError SCREENConfigureDisplay(void);
 PsychError SCREENPanelFitter(void);
 PsychError SCREENReadHDRImage(void);
+PsychError SCREENMakeTextureAtlas(void);
+PsychError SCREENTraceBuffer(void);
+PsychError SCREENGetFlipLog(void);
+PsychError SCREENPresentQueue(void);
+PsychError SCREENGetMovieStatistics(void);
+PsychError SCREENPrepareText(void);
+PsychError SCREENDrawPreparedText(void);
+PsychError SCREENTextCache(void);
 //PsychError SCREENSetGLSynchronous(void);        //SCREENSetGLSynchronous.c
 
 //end include once
@@ -27,8 +27,7 @@ void PsychCleanupSCREENFillPoly(void);
 
 PsychError ScreenExitFunction(void)
 {
-	//The timing array holds time values set by Screen internal diagnostics.  It allocates memory with 
-	//malloc to hold the array of times.  This call frees the memory prior to unloading Screen
+	//The timing array holds time values set by Screen internal diagnostics.  Release it.
 	ClearTimingArray();
   
 	// Close all open onscreen windows and release their resources,
@@ -36,6 +35,9 @@ PsychError ScreenExitFunction(void)
 	ScreenCloseAllWindows();
 	CloseWindowBank();
 
+	// Release the trace rings of all threads. All our threads are gone at this point:
+	PsychTraceShutdown();
+
     // Shutdown low-level display glue (Screens, displays, kernel-drivers et al.):
     PsychCleanupDisplayGlue();
 
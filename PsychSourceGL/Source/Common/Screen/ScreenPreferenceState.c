@@ -5,6 +5,7 @@
 
     Allen.Ingling@nyu.edu           awi
     mario.kleiner.de@gmail.com      mk
+    agent@local                     ag
 
     PLATFORMS:
 
@@ -20,6 +21,8 @@
         9/30/05  mk         new setting VisualDebugLevel: Defines how much visual feedback PTB should give about errors and
                             state: 0=none, 1=only errors, 2=also warnings, 3=also infos, 4=also blue bootup screen, 5=also visual test sheets.
         3/7/06   awi        Added state for new preference flag SuppressAllWarnings.
+        10/19/26 ag         New setting RefreshCalibrationCache: 0 = Off, 1 = Use and update the persistent refresh calibration
+                            cache, 2 = Only update it with the results of a full calibration.
 
     DESCRIPTION:
 
@@ -105,6 +108,7 @@ static double                           sync_maxStddev;                 // Maxim
 static double                           sync_maxDeviation;              // Maximum deviation (in percent) between measured and OS reported reference frame duration.
 static double                           sync_maxDuration;               // Maximum duration of a calibration run in seconds.
 static int                              sync_minSamples;                // Minimum number of valid measurement samples needed.
+static int                              refreshCalibrationCache;        // 0 = Off, 1 = Use and update refresh calibration cache, 2 = Only update it.
 
 static int                              useGStreamer;                   // Use GStreamer for multi-media processing? 1==yes.
 
@@ -151,6 +155,9 @@ void PrepareScreenPreferences(void)
     // worst-case duration per calibration run:
     PsychPrefStateSet_SynctestThresholds(0.000200, 50, 0.1, 5);
 
+    // Persistent refresh calibration cache is opt-in:
+    refreshCalibrationCache = 0;
+
     // Initialize our locale setting for multibyte/singlebyte to unicode character conversion
     // for Screen('DrawText') et al. to be the current default system locale, as defined by
     // system settings and environment variables at startup of Matlab/Octave:
@@ -451,6 +458,18 @@ void PsychPrefStateGet_SynctestThresholds(double* maxStddev, int* minSamples, do
     *minSamples   = sync_minSamples;
 }
 
+// Use of persistent refresh calibration cache in PsychOpenOnscreenWindow():
+void PsychPrefStateSet_RefreshCalibrationCache(int level)
+{
+    if (level < 0 || level > 2) PsychErrorExitMsg(PsychError_user, "Invalid refresh calibration cache level provided! Must be 0, 1 or 2.");
+    refreshCalibrationCache = level;
+}
+
+int PsychPrefStateGet_RefreshCalibrationCache(void)
+{
+    return(refreshCalibrationCache);
+}
+
 //****************************************************************************************************************
 //Debug preferences
 
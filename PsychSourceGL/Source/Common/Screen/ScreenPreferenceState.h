@@ -5,6 +5,7 @@
  *
  *    Allen.Ingling@nyu.edu           awi
  *    mario.kleiner.de@gmail.com      mk
+ *    agent@local                     ag
  *
  *    PLATFORMS:
  *
@@ -20,6 +21,7 @@
  *        9/30/05  mk         new setting VisualDebugLevel: Defines how much visual feedback PTB should give about errors and
  *                            state: 0=none, 1=only errors, 2=also warnings, 3=also infos, 4=also blue bootup screen, 5=also visual test sheets.
  *        3/7/06   awi        Added state for new preference flag SuppressAllWarnings.
+ *        10/19/26 ag         New setting RefreshCalibrationCache.
  *
  *    DESCRIPTION:
  *
@@ -122,6 +124,10 @@ double PsychPrefStateGet_FrameRectCorrection(void);
 void PsychPrefStateSet_SynctestThresholds(double maxStddev, int minSamples, double maxDeviation, double maxDuration);
 void PsychPrefStateGet_SynctestThresholds(double* maxStddev, int* minSamples, double* maxDeviation, double* maxDuration);
 
+// Use of persistent refresh calibration cache:
+void PsychPrefStateSet_RefreshCalibrationCache(int level);
+int PsychPrefStateGet_RefreshCalibrationCache(void);
+
 // Shall GStreamer be used instead of Quicktime on 32-bit Windows or OS/X?
 void PsychPrefStateSet_UseGStreamer(int value);
 int PsychPrefStateGet_UseGStreamer(void);
@@ -77,6 +77,7 @@ const char** InitializeSynopsis(void)
     synopsis[i++] = "[windowPtr,rect]=Screen('OpenWindow',windowPtrOrScreenNumber [,color] [,rect] [,pixelSize] [,numberOfBuffers] [,stereomode] [,multisample][,imagingmode][,specialFlags][,clientRect][,fbOverrideRect][,vrrParams=[]]);";
     synopsis[i++] = "[windowPtr,rect]=Screen('OpenOffscreenWindow',windowPtrOrScreenNumber [,color] [,rect] [,pixelSize] [,specialFlags] [,multiSample]);";
     synopsis[i++] = "textureIndex=Screen('MakeTexture', WindowIndex, imageMatrix [, optimizeForDrawAngle=0] [, specialFlags=0] [, floatprecision] [, textureOrientation=0] [, textureShader=0]);";
+    synopsis[i++] = "[atlasPtr, packedRects] = Screen('MakeTextureAtlas', windowPtr, textureHandles [, atlasPtr=0] [, padding=1] [, maxSize]);";
     synopsis[i++] = "oldParams = Screen('PanelFitter', windowPtr [, newParams]);";
     synopsis[i++] = "Screen('Close', [windowOrTextureIndex or list of textureIndices/offscreenWindowIndices]);";
     synopsis[i++] = "Screen('CloseAll');";
@@ -115,6 +116,9 @@ const char** InitializeSynopsis(void)
     synopsis[i++] = "oldTextColor=Screen('TextColor', windowPtr [,colorVector]);";
     synopsis[i++] = "oldTextBackgroundColor=Screen('TextBackgroundColor', windowPtr [,colorVector]);";
     synopsis[i++] = "oldMatrix = Screen('TextTransform', windowPtr [, newMatrix]);";
+    synopsis[i++] = "[textId, normBoundsRect, xAdvance, textHeight] = Screen('PrepareText', windowPtr, text [, swapTextDirection=0]);";
+    synopsis[i++] = "[newX, newY] = Screen('DrawPreparedText', windowPtr, textIds [, x] [, y] [, color] [, backgroundColor] [, yPositionIsBaseline]);";
+    synopsis[i++] = "result = Screen('TextCache', subCommand [, arg]);";
 
     // Copy an image, very quickly, between textures and onscreen windows
     synopsis[i++] = "\n% Copy an image, very quickly, between textures, offscreen windows and onscreen windows.";
@@ -136,6 +140,8 @@ const char** InitializeSynopsis(void)
     synopsis[i++] = "[VBLTimestamp StimulusOnsetTime FlipTimestamp Missed Beampos] = Screen('AsyncFlipCheckEnd', windowPtr);";
     synopsis[i++] = "[VBLTimestamp StimulusOnsetTime swapCertainTime] = Screen('WaitUntilAsyncFlipCertain', windowPtr);";
     synopsis[i++] = "[info] = Screen('GetFlipInfo', windowPtr [, infoType=0] [, auxArg1]);";
+    synopsis[i++] = "[flipLog, lostCount] = Screen('GetFlipLog', windowPtr [, maxN] [, logCapacity]);";
+    synopsis[i++] = "[result, lostCount] = Screen('PresentQueue', windowPtr, subCommand [, arg]);";
     synopsis[i++] = "[telapsed] = Screen('DrawingFinished', windowPtr [, dontclear] [, sync]);";
     synopsis[i++] = "framesSinceLastWait = Screen('WaitBlanking', windowPtr [, waitFrames]);";
 
@@ -196,6 +202,7 @@ const char** InitializeSynopsis(void)
     synopsis[i++] = "\n% Internal testing of Screen";
     synopsis[i++] =  "timeList= Screen('GetTimelist');";
     synopsis[i++] =  "Screen('ClearTimelist');";
+    synopsis[i++] =  "[timestamps, eventIds, args, threadIndices, eventNames] = Screen('TraceBuffer', subCommand [, recordsPerThread or jsonFilename]);";
     synopsis[i++] =  "Screen('Preference','DebugMakeTexture', enableDebugging);";
 
     // Movie and multimedia handling functions:
@@ -205,12 +212,13 @@ const char** InitializeSynopsis(void)
     synopsis[i++] =  "[ texturePtr [timeindex]]=Screen('GetMovieImage', windowPtr, moviePtr, [waitForImage], [fortimeindex], [specialFlags = 0] [, specialFlags2 = 0]);";
     synopsis[i++] =  "[droppedframes] = Screen('PlayMovie', moviePtr, rate, [loop], [soundvolume]);";
     synopsis[i++] =  "timeindex = Screen('GetMovieTimeIndex', moviePtr);";
+    synopsis[i++] =  "stats = Screen('GetMovieStatistics', moviePtr [, reset=0]);";
     synopsis[i++] =  "[oldtimeindex] = Screen('SetMovieTimeIndex', moviePtr, timeindex [, indexIsFrames=0]);";
     synopsis[i++] =  "moviePtr = Screen('CreateMovie', windowPtr, movieFile [, width][, height][, frameRate=30][, movieOptions][, numChannels=4][, bitdepth=8]);";
-    synopsis[i++] =  "Screen('FinalizeMovie', moviePtr);";
+    synopsis[i++] =  "[framesAdded, droppedFrames, lateFrames] = Screen('FinalizeMovie', moviePtr);";
     synopsis[i++] =  "Screen('AddFrameToMovie', windowPtr [,rect] [,bufferName] [,moviePtr=0] [,frameduration=1]);";
     synopsis[i++] =  "Screen('AddAudioBufferToMovie', moviePtr, audioBuffer);";
-    synopsis[i++] =  "[imageArray, format, errorMsg, auxInfo] = Screen('ReadHDRImage', filename [, errorMode=0]);";
+    synopsis[i++] =  "[imageArray, format, errorMsg, auxInfo] = Screen('ReadHDRImage', filename [, errorMode=0][, precision=0][, windowPtr]);";
 
     // Video capture support:
     synopsis[i++] = "\n% Video capture functions:";
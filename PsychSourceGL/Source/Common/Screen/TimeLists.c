@@ -4,6 +4,7 @@
 	AUTHORS:
 	
 		Allen.Ingling@nyu.edu		awi 
+		agent@local			ag
 
 	PLATFORMS: 
 	
@@ -13,11 +14,14 @@
 	HISTORY:
 	
 		1/18/05		awi		Wrote it. 
+		19.10.2026	ag		Store samples in a geometrically growing array instead of a linked list, and also record
+						them as kPsychTraceTimeListSample events while tracing via Screen('TraceBuffer') is enabled.
 
 	DESCRIPTION:
 
-		For purposes of instrumenting Screen, maintain times samples in an abstract list type.  Internally we use a 
-		linked list.  To external functions reading out values, the list appears to be an array.
+		For purposes of instrumenting Screen, maintain times samples in an abstract list type.  Internally we use an 
+		array which grows geometrically when full.  To external functions reading out values, the list appears to be
+		an array.  While tracing via Screen('TraceBuffer') is enabled, each sample is also recorded as a trace event.
 		
 		It is easy to time  Screen subfuntions from MATLAB by surrounding them with calls to GetSecs().  
 
@@ -35,7 +39,7 @@
 		to be before we start recording into it.      
 		
 		The close routine which you register with ScriptingGlue, that routine which is executed before the mex file 
-		is flushed, must call ClearTimingArray() to free storage allocated by TimeLists.
+		is flushed, must call ClearTimingArray() to reset the TimeLists.
 	
 	TO DO:
 	
@@ -44,98 +48,60 @@
 		
 */
 
-#include "Psych.h"
+#include "Screen.h"
 
+// Initial capacity of the sample array, in samples:
+#define kPsychTimeListInitialCapacity 4096
 
-
-typedef struct _timeArrayElement_{
-	double							timeValue;
-	struct _timeArrayElement_		*next;
-} timeArrayElement;
-
-
-static timeArrayElement		*timeListHead=NULL;
-static timeArrayElement		*timeListTail=NULL;
-static unsigned int			numElements=0;
+static double		*timeList = NULL;
+static unsigned int	timeListCapacity = 0;
+static unsigned int	numTimeValues = 0;
 
 
 void StoreNowTime(void)
 {
-	double				now;
-	timeArrayElement	*newElement;
-	
+	double			now, *newList;
+	unsigned int	newCapacity;
+
+	// Grow the array geometrically if full, so storing a sample usually does not allocate:
+	if (numTimeValues >= timeListCapacity) {
+		newCapacity = (timeListCapacity > 0) ? 2 * timeListCapacity : kPsychTimeListInitialCapacity;
+		newList = (double*) realloc(timeList, newCapacity * sizeof(double));
+		if (newList == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while storing time sample");
+		timeList = newList;
+		timeListCapacity = newCapacity;
+	}
+
 	PsychGetAdjustedPrecisionTimerSeconds(&now);
-	newElement=(timeArrayElement *)malloc(sizeof(timeArrayElement));
-	newElement->timeValue=now;
-	newElement->next=NULL;
-	if(timeListTail != NULL)
-		timeListTail->next=newElement;
-	timeListTail=newElement;
-	if(timeListHead==NULL)
-		timeListHead=newElement;
-	++numElements;
+	timeList[numTimeValues++] = now;
+
+	// Also show up in Screen('TraceBuffer') traces, if tracing is enabled:
+	PsychTrace(kPsychTraceTimeListSample, numTimeValues);
 }
 
 void ClearTimingArray(void)
 {
-	timeArrayElement	*thisElement, *tempElement;
-	
-	
-	thisElement=timeListHead;
-	while(thisElement!=NULL){
-		if(thisElement->next==NULL){
-			//end of list.  free this element.
-			free(thisElement);
-			thisElement=NULL;
-			timeListHead=NULL;
-			timeListTail=NULL;
-			numElements=0;
-		}else{
-			//step ahead and free the element behind
-			tempElement=thisElement;
-			thisElement=thisElement->next;
-			free(tempElement);
-		}
-	}	
+	free(timeList);
+	timeList = NULL;
+	timeListCapacity = 0;
+	numTimeValues = 0;
 }
 
 unsigned int GetNumTimeValues(void)
 {
-	return(numElements);
+	return(numTimeValues);
 }
 
 unsigned int GetTimeArraySizeBytes(void)
 {
-	return(numElements * sizeof(double));
+	return(numTimeValues * sizeof(double));
 }
 
 
 void CopyTimeArray(double *destination, unsigned int numElements)
 {
-	timeArrayElement	*thisElement;
-	unsigned int		i;
-
-	thisElement=timeListHead;
-	for(i=0;i<numElements;i++){
-		if(thisElement==NULL)
-			PsychErrorExitMsg(PsychError_internal, "Attempted to copy out more values than are stored in list");
-		else{
-			destination[i]=thisElement->timeValue;
-			thisElement=thisElement->next;
-		}
-	}
-}
-
-
-
-
-
-
-
-
-
-
-
-
-
+	if (numElements > numTimeValues)
+		PsychErrorExitMsg(PsychError_internal, "Attempted to copy out more values than are stored in list");
 
+	if (numElements > 0) memcpy(destination, timeList, numElements * sizeof(double));
+}
@@ -293,6 +293,17 @@ void PsychCreateWindowRecord(PsychWindowRecordType **winRec)
     // Set cached display list handles for drawing functions to "uninitialized":
     (*winRec)->fillOvalDisplayList = 0;
     (*winRec)->frameOvalDisplayList = 0;
+    for (i = 0; i < kPsychMaxUnitCircleTables; i++) {
+        (*winRec)->unitCircleTable[i] = NULL;
+        (*winRec)->unitCircleSlices[i] = 0;
+    }
+    (*winRec)->unitCircleNextSlot = 0;
+    (*winRec)->discInstanceShader = 0;
+    (*winRec)->discVertexBuffer = 0;
+    (*winRec)->discInstanceBuffer = 0;
+    (*winRec)->discVertexBufferSlices = 0;
+    (*winRec)->renderBatchScratch = NULL;
+    (*winRec)->renderBatchScratchSize = 0;
 
     // No special flags set by default:
     (*winRec)->specialflags = 0;
@@ -376,6 +387,8 @@ void PsychCreateWindowRecord(PsychWindowRecordType **winRec)
  */
 PsychError FreeWindowRecordFromIndex(PsychWindowIndexType windex)
 {
+    int i;
+
     if (windex < PSYCH_FIRST_SCREEN)
         return(PsychError_scumberNotWindex); //I was passed a screen number, not a window index
 
@@ -393,6 +406,13 @@ PsychError FreeWindowRecordFromIndex(PsychWindowIndexType windex)
     // Release override projection matrices if any:
     free(windowRecordArrayWINBANK[windex]->proj);
 
+    // Release cached unit circle tables of PsychDrawDisc(), if any:
+    for (i = 0; i < kPsychMaxUnitCircleTables; i++)
+        free(windowRecordArrayWINBANK[windex]->unitCircleTable[i]);
+
+    // Release color conversion scratch buffer of PsychPrepareRenderBatch(), if any:
+    free(windowRecordArrayWINBANK[windex]->renderBatchScratch);
+
     free(windowRecordArrayWINBANK[windex]);
     windowRecordArrayWINBANK[windex] = NULL;
     --numWindowRecordsWINBANK;
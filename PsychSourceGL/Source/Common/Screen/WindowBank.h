@@ -64,6 +64,9 @@
 // Maximum number of slots in windowRecords fboTable:
 #define MAX_FBOTABLE_SLOTS 2+2+3+4+2
 
+// Maximum number of cached unit circle tables with different slice counts per window, for PsychDrawDisc():
+#define kPsychMaxUnitCircleTables 8
+
 // Type of hook function attached to a specific hook chain slot:
 #define kPsychShaderFunc    0
 #define kPsychCFunc         1
@@ -191,8 +194,31 @@ typedef struct PsychHookFunction {
     void*                   cprocfunc;
     unsigned int            shaderid;
     unsigned int            luttexid1;
+    int                     optSkip;            // Hook chain optimizer: 1 = Slot is a redundant identity blit, 2 = Slot is fused into a preceding slot. 0 = Execute.
+    int                     fusedStages;        // Hook chain optimizer: Number of shader slots, starting with this one, fused into one generated shader. 0 = None.
+    GLuint                  fusedShader;        // Hook chain optimizer: GLSL program implementing all fused stages, 0 if not yet compiled.
+    psych_bool              fusedFailed;        // Hook chain optimizer: Creation of fusedShader failed, so execute the stages separately.
+    int                     fusedUniformCount;  // Hook chain optimizer: Number of entries in fusedUniforms.
+    void*                   fusedUniforms;      // Hook chain optimizer: Mapping of uniforms of the original shaders to uniforms of the fusedShader.
 } PsychHookFunction;
 
+// Maximum number of passes of a hook chain which get timed individually by per-pass gpu timer queries:
+#define kPsychMaxTimedHookPasses 16
+
+// Hook chain optimizer results and per-pass gpu timing statistics of a hook chain:
+typedef struct PsychHookChainStats {
+    int                     passCount;          // Number of render passes as specified by the slots of the chain.
+    int                     optimizedPassCount; // Number of render passes after optimization.
+    int                     eliminatedBlits;    // Number of redundant identity blit passes removed by the optimizer.
+    int                     fusedSlots;         // Number of shader slots which are executed as part of a fused shader.
+    psych_bool              timingEnabled;      // Per-pass gpu timing of this chain requested?
+    psych_bool              timingPending;      // Timestamp queries of a previous execution not yet collected?
+    int                     timedPasses;        // Number of passes covered by the timestamp queries of the last timed execution.
+    int                     measuredPasses;     // Number of valid entries in gpuPassTime[].
+    GLuint                  timerQueries[kPsychMaxTimedHookPasses + 1]; // GL_TIMESTAMP queries at the pass boundaries.
+    double                  gpuPassTime[kPsychMaxTimedHookPasses];      // Most recently measured gpu execution time of each pass in seconds.
+} PsychHookChainStats;
+
 // Definition of an OpenGL Framebuffer object (FBO) for internal use.
 typedef struct PsychFBO {
     GLuint                  fboid;          // Handle to FBO.
@@ -210,6 +236,20 @@ typedef struct PsychFBO {
 
 // Typedefs for WindowRecord in WindowBank.h
 
+// One slot of the present queue of an onscreen window, see PsychSetPresentQueueCapacity():
+typedef struct PsychPresentQueueEntry {
+    PsychFBO*               fbo[2];             // Final image(s) of the queued frame, fbo[1] only for frame-sequential stereo, NULL otherwise.
+    double                  flipwhen;           // Requested 'when' of the queued flip.
+    int                     vbl_synclevel;      // Requested 'dontsync' mode of the queued flip.
+    psych_uint64            serial;             // Serial number of the queued frame, starting with 1.
+    // Results of the flip which presented the frame:
+    int                     beamPosAtFlip;
+    double                  miss_estimate;
+    double                  time_at_flipend;
+    double                  time_at_onset;
+    double                  vbl_timestamp;
+} PsychPresentQueueEntry;
+
 // This support structure for async flips is supported on all non-Windows platforms, aka all Unix platforms:
 // It gets attached to the asyncFlipInfo* of a windowRecord whenever async flips are used.
 typedef struct PsychFlipInfoStruct {
@@ -231,8 +271,38 @@ typedef struct PsychFlipInfoStruct {
     psych_thread            flipperThread;      // Thread handle for background flipping thread.
     psych_mutex             performFlipLock;    // Primary lock.
     psych_condition         flipperGoGoGo;      // Signalling condition variable to trigger execution of a flip request by the flipper thread.
+
+    // Flip log for Screen('GetFlipLog'): A ring of flipLogCapacity records of kPsychFlipLogRecordSize doubles each:
+    double*                 flipLog;            // Preallocated flip log ring, or NULL if flip logging is disabled.
+    int                     flipLogCapacity;    // Capacity of flipLog in records.
+    psych_uint64            flipLogWritten;     // Total count of records appended to flipLog.
+    psych_uint64            flipLogFetched;     // Total count of records fetched by Screen('GetFlipLog') or lost due to ring overflow.
+    psych_mutex             flipLogLock;        // Protects the flip log against concurrent access by flipper thread and masterthread.
+
+    // Present queue for Screen('PresentQueue'): A ring of queueCapacity prerendered frames, presented back-to-back by the flipper thread:
+    PsychPresentQueueEntry* queue;              // Ring of queued frames, or NULL if the present queue is disabled.
+    int                     queueCapacity;      // Capacity of queue in frames, zero if disabled.
+    psych_uint64            queueSubmitted;     // Total count of frames enqueued by masterthread.
+    psych_uint64            queuePresented;     // Total count of queued frames presented by flipper thread.
+    psych_bool              queueBusy;          // Flipper thread currently presents the oldest queued frame.
+    psych_bool              queueStop;          // Request to flipper thread to stop processing the queue.
+    psych_bool              queueServing;       // Flipper thread serves the queue in its standard dispatch loop.
+    PsychFBO*               queueSavedFBO[2];   // finalizedFBO's while a queue slot is temporarily redirected as finalizedFBO.
+    PsychFBO*               queueSystemFBO;     // Pseudo-FBO of the system framebuffer, for use by the flipper thread.
+    double*                 queueResults;       // Ring of kPsychPresentQueueResultCapacity result records of presented frames.
+    psych_uint64            queueResultsFetched;// Total count of result records fetched by Screen('PresentQueue') or lost due to ring overflow.
+    psych_mutex             queueLock;          // Protects the queue against concurrent access by flipper thread and masterthread.
+    psych_condition         queueNotEmpty;      // Signalled by masterthread whenever a frame got enqueued or the queue is stopped.
+    psych_condition         queueNotFull;       // Signalled by flipper thread whenever a queued frame got presented.
 } PsychFlipInfoStruct;
 
+// Number of values in each flip log record. See SCREENGetFlipLog.c for their meaning:
+#define kPsychFlipLogRecordSize 15
+
+// Number of values in each present queue result record, and capacity of the result ring. See SCREENPresentQueue.c for their meaning:
+#define kPsychPresentQueueResultSize 7
+#define kPsychPresentQueueResultCapacity 4096
+
 
 #if PSYCH_SYSTEM == PSYCH_OSX
 // Definition of OS-X core graphics and Core OpenGL handles:
@@ -375,7 +445,11 @@ typedef struct _PsychWindowRecordType_{
     GLuint                      textureNumber;
     int                         textureOrientation;     // Orientation of texture data in internal storage. Defines texcoord assingment.
     int                         texturecache_slot;      // Reference of cache structure for this texture, if any...
+    PsychWindowIndexType        textureAtlasIndex;      // Handle of texture atlas whose OpenGL texture stores this textures texels, or 0 if standalone texture.
+    double                      textureAtlasOffset[2];  // (x,y) offset in texels of this textures texels inside the texture atlas, if textureAtlasIndex > 0.
     GLenum                      texturetarget;          // Explicit target type of texture (GL_TEXTURE_2D, ...)
+    void                        *textureImportHandle;   // Handle of external storage of an imported texture, e.g., a video buffer, or NULL.
+    void                        (*textureImportRelease)(void *handle); // Release function for textureImportHandle, called after texture deletion.
     // The following three are only used for injecting special textures into PTB, e.g., High Dynamic range textures in floating point format.
     // They default to zero, which means: Derive texture representation from depth.
     GLint                       textureinternalformat;  // Explicit definition of glinternalformat for texture creation.
@@ -462,6 +536,7 @@ typedef struct _PsychWindowRecordType_{
     int                         imagingMode;                                // Master mode switch for imaging and callback hook pipeline.
     PtrPsychHookFunction        HookChain[MAX_SCREEN_HOOKS];                // Array of pointers to the hook-chains for different hooks.
     psych_bool                  HookChainEnabled[MAX_SCREEN_HOOKS];         // Array of Booleans to en-/disable single chains temporarily.
+    PsychHookChainStats         HookChainStats[MAX_SCREEN_HOOKS];           // Array of optimizer results and gpu timing statistics for the different hook-chains.
 
     // Indices into our FBO table: The special value -1 means: Don't use.
     int                         drawBufferFBO[2];                   // Storage for drawing FBOs: These are the targets of all drawing operations before
@@ -492,6 +567,21 @@ typedef struct _PsychWindowRecordType_{
     GLuint                      fillOvalDisplayList;
     GLuint                      frameOvalDisplayList;
 
+    // Cached unit circle tables for PsychDrawDisc(), one per recently used slice count:
+    float*                      unitCircleTable[kPsychMaxUnitCircleTables];     // numSlices + 1 (cos, sin) pairs each, or NULL.
+    int                         unitCircleSlices[kPsychMaxUnitCircleTables];    // Slice count of each cached table.
+    int                         unitCircleNextSlot;                             // Slot to recycle for the next not yet cached slice count.
+
+    // Instanced drawing of disc batches by PsychDrawDisc(), set up on the parent window on first use:
+    GLuint                      discInstanceShader;                             // GLSL program which generates the disc vertices, or 0.
+    GLuint                      discVertexBuffer;                               // VBO with the unit circle for 'discVertexBufferSlices' slices.
+    GLuint                      discInstanceBuffer;                             // VBO for the per disc attributes of a batch.
+    int                         discVertexBufferSlices;                         // Slice count of the unit circle in 'discVertexBuffer', 0 if none.
+
+    // Scratch buffer for color vectors converted by PsychPrepareRenderBatch(), and its size in bytes:
+    void*                       renderBatchScratch;
+    size_t                      renderBatchScratchSize;
+
     // Pointer to double-array of auxiliary parameters for bound shaders - or NULL by default.
     double*                     auxShaderParams;
     int                         auxShaderParamsCount;
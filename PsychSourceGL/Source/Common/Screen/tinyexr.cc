@@ -4,7 +4,9 @@
  * C++ code needed to compile tinyexr.h.
  *
  * SCREENReadHDRImage.c uses functions imported from here with C linkage
- * to utilize tinyexr for reading of HDR files.
+ * to utilize tinyexr for reading of HDR files. PsychLoadEXRImage() is our
+ * own variant of LoadEXR(), which memory-maps the file and only parses it
+ * once, and can return half float data.
  *
  */
 
@@ -18,5 +20,275 @@
 // snapshot of upstream https://github.com/syoyo/tinyexr at commit
 // cf8550f1b8b9f5f79f02df810c885ed2a2b578f9 ("Merge branch 'AdrianAtGoogle-master").
 
+// Decode tiles and scanline blocks of an image in parallel on all cores.
+// Note: Only effective if the compiler reports C++11 or later via __cplusplus,
+// which MSVC only does with the /Zc:__cplusplus option.
+#define TINYEXR_USE_THREAD (1)
+
 #define TINYEXR_IMPLEMENTATION
 #include "tinyexr.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Read-only memory mapping of a whole file:
+typedef struct PsychEXRMappedFile {
+    const unsigned char *data;
+    size_t              size;
+#if defined(_WIN32)
+    HANDLE              file;
+    HANDLE              mapping;
+#endif
+} PsychEXRMappedFile;
+
+static int PsychEXRMapFile(const char *filename, PsychEXRMappedFile *map, const char **err)
+{
+    memset(map, 0, sizeof(*map));
+
+#if defined(_WIN32)
+    LARGE_INTEGER filesize;
+
+    map->file = CreateFileW(tinyexr::UTF8ToWchar(filename).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (map->file == INVALID_HANDLE_VALUE) {
+        tinyexr::SetErrorMessage("Cannot read file " + std::string(filename), err);
+        return TINYEXR_ERROR_CANT_OPEN_FILE;
+    }
+
+    if (!GetFileSizeEx(map->file, &filesize) || (filesize.QuadPart < 16)) {
+        CloseHandle(map->file);
+        tinyexr::SetErrorMessage("File size too short " + std::string(filename), err);
+        return TINYEXR_ERROR_INVALID_FILE;
+    }
+
+    map->size = (size_t) filesize.QuadPart;
+    map->mapping = CreateFileMappingW(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    map->data = (map->mapping) ? (const unsigned char*) MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (map->data == NULL) {
+        if (map->mapping) CloseHandle(map->mapping);
+        CloseHandle(map->file);
+        tinyexr::SetErrorMessage("Cannot map file " + std::string(filename), err);
+        return TINYEXR_ERROR_CANT_OPEN_FILE;
+    }
+#else
+    struct stat st;
+    void *addr;
+    int fd;
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        tinyexr::SetErrorMessage("Cannot read file " + std::string(filename), err);
+        return TINYEXR_ERROR_CANT_OPEN_FILE;
+    }
+
+    if ((fstat(fd, &st) != 0) || (st.st_size < 16)) {
+        close(fd);
+        tinyexr::SetErrorMessage("File size too short " + std::string(filename), err);
+        return TINYEXR_ERROR_INVALID_FILE;
+    }
+
+    map->size = (size_t) st.st_size;
+    addr = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping stays valid after close of the file descriptor:
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        tinyexr::SetErrorMessage("Cannot map file " + std::string(filename), err);
+        return TINYEXR_ERROR_CANT_OPEN_FILE;
+    }
+
+    // All of the file will be needed soon, so let the kernel read ahead:
+    madvise(addr, map->size, MADV_WILLNEED);
+    map->data = (const unsigned char*) addr;
+#endif
+
+    return TINYEXR_SUCCESS;
+}
+
+static void PsychEXRUnmapFile(PsychEXRMappedFile *map)
+{
+#if defined(_WIN32)
+    UnmapViewOfFile((LPCVOID) map->data);
+    CloseHandle(map->mapping);
+    CloseHandle(map->file);
+#else
+    munmap((void*) map->data, map->size);
+#endif
+    map->data = NULL;
+}
+
+// Fetch one sample of a decoded channel as float or as raw half float bits:
+static inline float PsychEXRSampleFloat(const unsigned char *plane, int pixeltype, size_t i)
+{
+    tinyexr::FP16 h;
+
+    if (pixeltype == TINYEXR_PIXELTYPE_FLOAT)
+        return(reinterpret_cast<const float*>(plane)[i]);
+
+    h.u = reinterpret_cast<const unsigned short*>(plane)[i];
+    return(tinyexr::half_to_float(h).f);
+}
+
+static inline unsigned short PsychEXRSampleHalf(const unsigned char *plane, int pixeltype, size_t i)
+{
+    tinyexr::FP32 f;
+
+    if (pixeltype == TINYEXR_PIXELTYPE_HALF)
+        return(reinterpret_cast<const unsigned short*>(plane)[i]);
+
+    f.f = reinterpret_cast<const float*>(plane)[i];
+    return(tinyexr::float_to_half_full(f).u);
+}
+
+// Store RGBA pixel dstIdx from sample srcIdx of the channel planes chIdx[0-3], alpha 1.0 if there is no alpha channel:
+static inline void PsychEXRStorePixel(void *out_rgba, int halfFloat, size_t dstIdx, unsigned char **planes,
+                                      size_t srcIdx, const int *chIdx, const int *pixeltypes)
+{
+    int k;
+
+    for (k = 0; k < 4; k++) {
+        if (halfFloat)
+            reinterpret_cast<unsigned short*>(out_rgba)[4 * dstIdx + k] = (chIdx[k] >= 0) ? PsychEXRSampleHalf(planes[chIdx[k]], pixeltypes[chIdx[k]], srcIdx) : 0x3c00;
+        else
+            reinterpret_cast<float*>(out_rgba)[4 * dstIdx + k] = (chIdx[k] >= 0) ? PsychEXRSampleFloat(planes[chIdx[k]], pixeltypes[chIdx[k]], srcIdx) : 1.0f;
+    }
+}
+
+// Load a single-part OpenEXR image file into an interleaved RGBA buffer, reading the file only once via
+// a memory mapping. Equivalent to LoadEXR(), but the output is half float if halfFloat is non-zero, and
+// the parsed header is returned in exr_header as well. On success, caller must free() the *out_rgba buffer
+// and release the header via FreeEXRHeader(). On failure, caller must FreeEXRErrorMessage(*err).
+extern "C" int PsychLoadEXRImage(const char *filename, int halfFloat, void **out_rgba, int *width, int *height,
+                                 EXRHeader *exr_header, const char **err)
+{
+    PsychEXRMappedFile map;
+    EXRVersion exr_version;
+    EXRImage exr_image;
+    std::vector<tinyexr::LayerChannel> channels;
+    int chIdx[4] = { -1, -1, -1, -1 };
+    size_t c, ix, npixels;
+    int ret, it, i, j;
+
+    *out_rgba = NULL;
+    InitEXRHeader(exr_header);
+    InitEXRImage(&exr_image);
+
+    ret = PsychEXRMapFile(filename, &map, err);
+    if (ret != TINYEXR_SUCCESS)
+        return(ret);
+
+    ret = ParseEXRVersionFromMemory(&exr_version, map.data, map.size);
+    if (ret != TINYEXR_SUCCESS) {
+        tinyexr::SetErrorMessage("Failed to read version info from EXR file.", err);
+        goto out;
+    }
+
+    if (exr_version.multipart || exr_version.non_image) {
+        tinyexr::SetErrorMessage("Loading multipart or DeepImage is not supported.", err);
+        ret = TINYEXR_ERROR_INVALID_DATA;
+        goto out;
+    }
+
+    ret = ParseEXRHeaderFromMemory(exr_header, &exr_version, map.data, map.size, err);
+    if (ret != TINYEXR_SUCCESS)
+        goto out;
+
+    // Keep HALF channels as HALF for half float output, decode them to FLOAT otherwise:
+    for (i = 0; i < exr_header->num_channels; i++) {
+        if (exr_header->pixel_types[i] == TINYEXR_PIXELTYPE_HALF)
+            exr_header->requested_pixel_types[i] = (halfFloat) ? TINYEXR_PIXELTYPE_HALF : TINYEXR_PIXELTYPE_FLOAT;
+    }
+
+    ret = LoadEXRImageFromMemory(&exr_image, exr_header, map.data, map.size, err);
+    if (ret != TINYEXR_SUCCESS)
+        goto out;
+
+    // Select the channels of the default layer, like LoadEXR() does:
+    tinyexr::ChannelsInLayer(*exr_header, "", channels);
+    if (channels.size() < 1) {
+        tinyexr::SetErrorMessage("Layer Not Found", err);
+        ret = TINYEXR_ERROR_LAYER_NOT_FOUND;
+        goto out;
+    }
+
+    if (channels.size() == 1) {
+        // Grayscale channel only, replicated into all RGBA components:
+        chIdx[0] = chIdx[1] = chIdx[2] = chIdx[3] = (int) channels.front().index;
+    }
+    else {
+        for (c = 0; c < channels.size() && c < 4; c++) {
+            if (channels[c].name == "R") chIdx[0] = (int) channels[c].index;
+            if (channels[c].name == "G") chIdx[1] = (int) channels[c].index;
+            if (channels[c].name == "B") chIdx[2] = (int) channels[c].index;
+            if (channels[c].name == "A") chIdx[3] = (int) channels[c].index;
+        }
+
+        if ((chIdx[0] == -1) || (chIdx[1] == -1) || (chIdx[2] == -1)) {
+            tinyexr::SetErrorMessage("R, G or B channel not found", err);
+            ret = TINYEXR_ERROR_INVALID_DATA;
+            goto out;
+        }
+    }
+
+    for (i = 0; i < 4; i++) {
+        if ((chIdx[i] >= 0) && (exr_header->requested_pixel_types[chIdx[i]] == TINYEXR_PIXELTYPE_UINT)) {
+            tinyexr::SetErrorMessage("Integer channels are not supported", err);
+            ret = TINYEXR_ERROR_UNSUPPORTED_FORMAT;
+            goto out;
+        }
+    }
+
+    npixels = (size_t) exr_image.width * (size_t) exr_image.height;
+    *out_rgba = malloc(4 * ((halfFloat) ? sizeof(unsigned short) : sizeof(float)) * npixels);
+    if (*out_rgba == NULL) {
+        tinyexr::SetErrorMessage("Out of memory", err);
+        ret = TINYEXR_ERROR_INVALID_DATA;
+        goto out;
+    }
+
+    if (exr_header->tiled) {
+        for (it = 0; it < exr_image.num_tiles; it++) {
+            for (j = 0; j < exr_header->tile_size_y; j++) {
+                for (i = 0; i < exr_header->tile_size_x; i++) {
+                    const int ii = exr_image.tiles[it].offset_x * exr_header->tile_size_x + i;
+                    const int jj = exr_image.tiles[it].offset_y * exr_header->tile_size_y + j;
+
+                    // Out of region check:
+                    if ((ii >= exr_image.width) || (jj >= exr_image.height))
+                        continue;
+
+                    PsychEXRStorePixel(*out_rgba, halfFloat, (size_t) ii + (size_t) jj * (size_t) exr_image.width,
+                                       exr_image.tiles[it].images, (size_t) (i + j * exr_header->tile_size_x),
+                                       chIdx, exr_header->requested_pixel_types);
+                }
+            }
+        }
+    }
+    else {
+        for (ix = 0; ix < npixels; ix++)
+            PsychEXRStorePixel(*out_rgba, halfFloat, ix, exr_image.images, ix, chIdx, exr_header->requested_pixel_types);
+    }
+
+    *width = exr_image.width;
+    *height = exr_image.height;
+    ret = TINYEXR_SUCCESS;
+
+out:
+    FreeEXRImage(&exr_image);
+    PsychEXRUnmapFile(&map);
+
+    if (ret != TINYEXR_SUCCESS) {
+        free(*out_rgba);
+        *out_rgba = NULL;
+        FreeEXRHeader(exr_header);
+    }
+
+    return(ret);
+}
@@ -8,10 +8,16 @@
     AUTHORS:
 
     mario.kleiner.de@gmail.com    mk
+    agent@local                   ag
 
     HISTORY:
 
     27.07.2011     mk     Created.
+    19.10.2026     ag     KbQueue thread: Process all pending X events per wakeup under one lock, cache root window
+                          geometry and map XInput device ids to queues via lookup table, to avoid X-Server round trips.
+    19.10.2026     ag     Add kernel evdev input backend for keyboard queues, with replay of recorded event streams.
+    19.10.2026     ag     KbCheck: Answer from key state maintained by a running keyboard queue, without X-Server round trips.
+    19.10.2026     ag     Add evdev backend for the gamepad sampler.
 
 */
 
@@ -35,11 +41,53 @@ static unsigned int psychHIDKbQueueFlags[PSYCH_HID_MAX_DEVICES];
 static PsychHIDEventRecord psychHIDKbQueueOldEvent[PSYCH_HID_MAX_DEVICES];
 static Window  psychHIDKbQueueXWindow[PSYCH_HID_MAX_DEVICES];
 static psych_bool psychHIDKbQueueActive[PSYCH_HID_MAX_DEVICES];
+static volatile unsigned int psychHIDKbQueueKeyState[PSYCH_HID_MAX_DEVICES][8];
 static psych_mutex KbQueueMutex;
 static psych_condition KbQueueCondition;
 static psych_bool  KbQueueThreadTerminate;
 static psych_thread KbQueueThread;
 static XEvent KbQueue_xevent;
+
+// Maximum number of X events processed by the KbQueue thread in one go, without releasing the KbQueueMutex:
+#define KBQUEUE_MAX_BATCH 64
+
+// Lookup table from XInput device id to PTB deviceIndex, for XInput device ids < KBQUEUE_MAX_DEVICEID:
+#define KBQUEUE_MAX_DEVICEID 256
+static int KbQueueDeviceIndexForId[KBQUEUE_MAX_DEVICEID];
+
+// Cached width x height of the root windows of all X-Screens, kept up to date via ConfigureNotify events:
+#define KBQUEUE_MAX_ROOTS 16
+static int KbQueueNumRoots = 0;
+static Window KbQueueRootWindow[KBQUEUE_MAX_ROOTS];
+static unsigned int KbQueueRootWidth[KBQUEUE_MAX_ROOTS];
+static unsigned int KbQueueRootHeight[KBQUEUE_MAX_ROOTS];
+
+// Timestamp base and X-Server time of first event of current batch of processed events:
+static double KbQueueBatchTime;
+static Time KbQueueBatchServerTime;
+static psych_bool KbQueueBatchServerTimeValid;
+
+// State of keyboard queues which use the kernel evdev input backend:
+typedef struct KbQueueEvdevRecord {
+    int                 fd;             // evdev device node or replay file, -1 if queue uses XInput.
+    psych_bool          replay;         // fd is a recorded event stream for replay.
+    psych_bool          replayPending;  // replayNext holds the next not yet processed recorded event.
+    psych_bool          syncDropped;    // Kernel dropped events, discard all until next SYN_REPORT.
+    psych_bool          motion;         // Valuators changed since last SYN_REPORT.
+    unsigned int        buttons;        // State of the first 32 device buttons.
+    unsigned int        relMask;        // Valuators which got relative axis updates since last SYN_REPORT.
+    double              valuators[PSYCH_HID_MAX_VALUATORS];
+    double              absMin[2];      // Range of absolute x and y axis, if any.
+    double              absMax[2];
+    double              replayBase;     // Offset from recorded event time to GetSecs time.
+    struct input_event  replayNext;
+} KbQueueEvdevRecord;
+
+static KbQueueEvdevRecord KbQueueEvdev[PSYCH_HID_MAX_DEVICES];
+static psych_thread KbQueueEvdevThread;
+static psych_bool KbQueueEvdevThreadTerminate = FALSE;
+static int KbQueueEvdevEpollFd = -1;
+static int KbQueueEvdevWakeupFd = -1;
 static XIM x_inputMethod = NULL;
 static XIC x_inputContext = NULL;
 
@@ -50,6 +98,64 @@ static XDevice* GetXDevice(int deviceIndex)
     return(x_dev[deviceIndex]);
 }
 
+// Query current key or button state of slave device 'deviceIndex' from the X-Server as a 256 bit vector in keys_return.
+// Returns TRUE if these are buttons, e.g., of a mouse or joystick, instead of keys on a keyboard:
+static psych_bool QueryXDeviceKeys(int deviceIndex, unsigned char keys_return[32])
+{
+    psych_bool isButtons = FALSE;
+    int i;
+
+    // Open connection to non-master-keyboard device:
+    XDevice* mydev = GetXDevice(deviceIndex);
+
+    // Query its current state: Can be NULL for some special devices.
+    XDeviceState* state = XQueryDeviceState(dpy, mydev);
+
+    // printf("Dummy = %i , NClasses = %i\n", dummy1, state->num_classes);
+
+    // Find state structure with key status info:
+    for (i = 0; state && (i < state->num_classes); i++) {
+        XInputClass* data = state->data;
+
+        // printf("Class %i: Type %i - %i\n", i, (int) data->class, (int) data->length);
+        if (data->class == KeyClass) {
+            // printf("NumKeys %i\n", ((XKeyState*) data)->num_keys);
+
+            // Copy 32 Byte keystate vector into key_return. Each bit encodes for one key:
+            memcpy(&keys_return[0], &(((XKeyState*) data)->keys[0]), 32);
+            isButtons = FALSE;
+        }
+
+        // Also handle devices with buttons as if they are keyboards, e.g., mouse, joystick...
+        if (data->class == ButtonClass) {
+            // printf("NumButtons %i\n", ((XButtonState*) data)->num_buttons);
+
+            // Copy 32 Byte buttonstate vector into key_return. Each bit encodes for one button:
+            memcpy(&keys_return[0], &(((XButtonState*) data)->buttons[0]), 32);
+            isButtons = TRUE;
+        }
+
+        // Advance to next entry:
+        data = (XInputClass*) (((void*) data) + ((size_t) data->length));
+    }
+
+    XFreeDeviceState(state);
+
+    return(isButtons);
+}
+
+// Update key state of key 'index' of device 'deviceIndex' for KbCheck. Called from the keyboard queue threads:
+static void KbQueueSetKeyState(int deviceIndex, int index, psych_bool down)
+{
+    if ((index < 0) || (index > 255))
+        return;
+
+    if (down)
+        __sync_fetch_and_or(&psychHIDKbQueueKeyState[deviceIndex][index >> 5], (1U << (index & 31)));
+    else
+        __sync_fetch_and_and(&psychHIDKbQueueKeyState[deviceIndex][index >> 5], ~(1U << (index & 31)));
+}
+
 void PsychHIDInitializeHIDStandardInterfaces(void)
 {
     int rc, i;
@@ -68,6 +174,8 @@ void PsychHIDInitializeHIDStandardInterfaces(void)
     memset(&psychHIDKbQueueOldEvent[0], 0, sizeof(psychHIDKbQueueOldEvent));
     memset(&psychHIDKbQueueFlags[0], 0, sizeof(psychHIDKbQueueFlags));
     memset(&psychHIDKbQueueXWindow[0], 0, sizeof(psychHIDKbQueueXWindow));
+    memset(&KbQueueEvdev[0], 0, sizeof(KbQueueEvdev));
+    for (i = 0; i < PSYCH_HID_MAX_DEVICES; i++) KbQueueEvdev[i].fd = -1;
 
     // Call XInitThreads() ourselves before any other X-Lib call if we need to
     // do this to work around lack of proper X-Lib threading init in the host
@@ -136,6 +244,14 @@ void PsychHIDInitializeHIDStandardInterfaces(void)
     }
     if (masterDevice == -1) printf("PsychHID: WARNING! No master keyboard/pointer found! This will end badly...\n");
 
+    // Build lookup table from XInput device id to deviceIndex. Unknown ids map to ndevices, ie. no device.
+    // Iterate backwards, so the first device with a given id wins, just as with a linear search:
+    for (i = 0; i < KBQUEUE_MAX_DEVICEID; i++) KbQueueDeviceIndexForId[i] = ndevices;
+    for (i = ndevices - 1; i >= 0; i--) {
+        if ((info[i].deviceid >= 0) && (info[i].deviceid < KBQUEUE_MAX_DEVICEID))
+            KbQueueDeviceIndexForId[info[i].deviceid] = i;
+    }
+
     // Switch X-Server connection into synchronous mode: We need this to get
     // a higher timing precision.
     XSynchronize(dpy, TRUE);
@@ -174,6 +290,11 @@ void PsychHIDShutdownHIDStandardInterfaces(void)
         }
     }
 
+    // Release evdev event polling:
+    if (KbQueueEvdevEpollFd >= 0) close(KbQueueEvdevEpollFd);
+    if (KbQueueEvdevWakeupFd >= 0) close(KbQueueEvdevWakeupFd);
+    KbQueueEvdevEpollFd = KbQueueEvdevWakeupFd = -1;
+
     // Delete input method and context if any was in use:
     if (x_inputContext) {
         XDestroyIC(x_inputContext);
@@ -364,45 +485,20 @@ PsychError PsychHIDOSKbCheck(int deviceIndex, double* scanList)
 
         // Reset master pointer/keyboard assignment to pre-query state:
         if ((j > 0) && (j != info[deviceIndex].attachment)) XISetClientPointer(dpy, None, j);
+    } else if (psychHIDKbQueueActive[deviceIndex] && (info[deviceIndex].use != XIMasterPointer) &&
+               ((KbQueueEvdev[deviceIndex].fd >= 0) || (psychHIDKbQueueXWindow[deviceIndex] <= (Window) ScreenCount(dpy)))) {
+        // Keyboard queue running for this device: Its thread maintains the current key state,
+        // with button indices already shifted as needed, so use that without asking the X-Server.
+        // Only trust it if the queue sees all key events, ie. uses evdev or listens on root windows.
+        // A queue bound to a specific window misses key releases while that window is unfocused:
+        for (i = 0; i < 32; i++)
+            keys_return[i] = (unsigned char) (psychHIDKbQueueKeyState[deviceIndex][i >> 2] >> (8 * (i & 3)));
     } else {
         // Non-Default deviceIndex: Want to query specific slave keyboard.
         if (info[deviceIndex].use == XIMasterPointer) PsychErrorExitMsg(PsychError_user, "Invalid deviceIndex specified! Cannot query master mouse pointers as keyboards.");
 
-        // Open connection to non-master-keyboard device:
-        XDevice* mydev = GetXDevice(deviceIndex);
-
-        // Query its current state: Can be NULL for some special devices.
-        XDeviceState* state = XQueryDeviceState(dpy, mydev);
-
-        // printf("Dummy = %i , NClasses = %i\n", dummy1, state->num_classes);
-
-        // Find state structure with key status info:
-        for (i = 0; state && (i < state->num_classes); i++) {
-            XInputClass* data = state->data;
-
-            // printf("Class %i: Type %i - %i\n", i, (int) data->class, (int) data->length);
-            if (data->class == KeyClass) {
-                // printf("NumKeys %i\n", ((XKeyState*) data)->num_keys);
-
-                // Copy 32 Byte keystate vector into key_return. Each bit encodes for one key:
-                memcpy(&keys_return[0], &(((XKeyState*) data)->keys[0]), sizeof(keys_return));
-                isButtons = FALSE;
-            }
-
-            // Also handle devices with buttons as if they are keyboards, e.g., mouse, joystick...
-            if (data->class == ButtonClass) {
-                // printf("NumButtons %i\n", ((XButtonState*) data)->num_buttons);
-
-                // Copy 32 Byte buttonstate vector into key_return. Each bit encodes for one button:
-                memcpy(&keys_return[0], &(((XButtonState*) data)->buttons[0]), sizeof(keys_return));
-                isButtons = TRUE;
-            }
-
-            // Advance to next entry:
-            data = (XInputClass*) (((void*) data) + ((size_t) data->length));
-        }
-
-        XFreeDeviceState(state);
+        // Query its current state:
+        isButtons = QueryXDeviceKeys(deviceIndex, keys_return);
     }
 
     // Done with query. We have keyboard state in keys_return[] now.
@@ -525,13 +621,116 @@ PsychError PsychHIDOSGamePadAxisQuery(int deviceIndex, int axisId, double* min,
     return(PsychError_none);
 }
 
-// This is the event dequeue & process function which updates
-// Keyboard queue state. It can be called with 'blockingSinglepass'
-// set to TRUE to process exactly one event, if called from the
-// background keyboard queue processing thread. Alternatively it
-// can be called synchronously from KbQueueCheck with a setting of FALSE
-// to iterate over all available events and process them instantaneously:
-static void KbQueueProcessEvents(void)
+// Map XInput device id to PTB 'deviceIndex' aka the proper keyboard queue.
+// Returns ndevices if there isn't any such device:
+static int KbQueueDeviceIdToIndex(int deviceid)
+{
+    int i;
+
+    if ((deviceid >= 0) && (deviceid < KBQUEUE_MAX_DEVICEID))
+        return(KbQueueDeviceIndexForId[deviceid]);
+
+    for (i = 0; i < ndevices; i++) if (deviceid == info[i].deviceid) break;
+
+    return(i);
+}
+
+// Initialize key state of XInput keyboard queue 'deviceIndex' for KbCheck from the X-Server's current device state:
+static void KbQueueSeedKeyState(int deviceIndex)
+{
+    unsigned char keys_return[32];
+    psych_bool isButtons;
+    int i;
+
+    memset(keys_return, 0, sizeof(keys_return));
+    memset((void*) psychHIDKbQueueKeyState[deviceIndex], 0, sizeof(psychHIDKbQueueKeyState[deviceIndex]));
+
+    // Master pointers can not be queried, and are not handled by KbCheck:
+    if (info[deviceIndex].use == XIMasterPointer)
+        return;
+
+    isButtons = QueryXDeviceKeys(deviceIndex, keys_return);
+
+    // Buttons are shifted by one index, just as for KbQueue button events:
+    for (i = (isButtons) ? 1 : 0; i < 256; i++)
+        if (keys_return[i / 8] & (1 << (i % 8))) KbQueueSetKeyState(deviceIndex, (isButtons) ? i - 1 : i, TRUE);
+}
+
+// Setup cache of root window sizes of all X-Screens, and select for ConfigureNotify
+// events on all root windows, so the KbQueue thread gets notified about size changes,
+// e.g., due to RandR video mode changes. Called with KbQueueMutex held, while the
+// KbQueue thread is not running:
+static void KbQueueInitRootGeometry(void)
+{
+    Window rootRet;
+    unsigned int depth_return, border_width_return;
+    int i, x, y;
+
+    KbQueueNumRoots = ScreenCount(thread_dpy);
+    if (KbQueueNumRoots > KBQUEUE_MAX_ROOTS) KbQueueNumRoots = KBQUEUE_MAX_ROOTS;
+
+    for (i = 0; i < KbQueueNumRoots; i++) {
+        KbQueueRootWindow[i] = RootWindow(thread_dpy, i);
+        XSelectInput(thread_dpy, KbQueueRootWindow[i], StructureNotifyMask);
+        XGetGeometry(thread_dpy, KbQueueRootWindow[i], &rootRet, &x, &y, &KbQueueRootWidth[i], &KbQueueRootHeight[i], &border_width_return, &depth_return);
+    }
+}
+
+// Get width x height of root window 'root', aka screen size for touch coordinate remapping. Uses the
+// cached size, and only queries the X-Server if 'root' is not one of the cached root windows:
+static void KbQueueGetRootGeometry(Window root, unsigned int *screen_width, unsigned int *screen_height)
+{
+    Window rootRet;
+    unsigned int depth_return, border_width_return;
+    int i, x, y;
+
+    for (i = 0; i < KbQueueNumRoots; i++) {
+        if (KbQueueRootWindow[i] == root) {
+            *screen_width = KbQueueRootWidth[i];
+            *screen_height = KbQueueRootHeight[i];
+            return;
+        }
+    }
+
+    XGetGeometry(thread_dpy, root, &rootRet, &x, &y, screen_width, screen_height, &border_width_return, &depth_return);
+}
+
+// Map X-Server timestamp of an event to our clock: The first event of a batch gets the timestamp base
+// of the batch, taken when processing of the batch started. Following events get their X-Server time
+// offset relative to the first event added, but never a time later than now. If that offset is
+// implausible, the event gets the current time, which also becomes the new base for following events.
+// NOTE: X-Server event times only have a resolution of 1 msec, so timestamps of all but the first event
+// of a batch are quantized to 1 msec steps relative to the batch base, and events arriving within the same
+// msec get identical timestamps:
+static double KbQueueEventTime(Time evtime)
+{
+    unsigned int delta;
+    double tnow, t;
+
+    if (!KbQueueBatchServerTimeValid) {
+        KbQueueBatchServerTime = evtime;
+        KbQueueBatchServerTimeValid = TRUE;
+        return(KbQueueBatchTime);
+    }
+
+    PsychGetAdjustedPrecisionTimerSeconds(&tnow);
+
+    // X-Server time is in msecs and wraps around at 32 bits:
+    delta = (unsigned int) (evtime - KbQueueBatchServerTime);
+    if (delta >= 1000) {
+        KbQueueBatchTime = tnow;
+        KbQueueBatchServerTime = evtime;
+        return(tnow);
+    }
+
+    t = KbQueueBatchTime + 0.001 * (double) delta;
+
+    return((t < tnow) ? t : tnow);
+}
+
+// This is the event process function which updates keyboard queue state
+// for the event in KbQueue_xevent. Must be called with the KbQueueMutex held:
+static void KbQueueProcessEvent(void)
 {
     PsychHIDEventRecord evt;
     XKeyPressedEvent key;
@@ -548,11 +747,17 @@ static void KbQueueProcessEvents(void)
     {
         XGenericEventCookie *cookie = &KbQueue_xevent.xcookie;
 
-        // Wait until at least one event available and dequeue it:
-        XNextEvent(thread_dpy, &KbQueue_xevent);
+        // Size change of a root window, e.g., due to a RandR video mode change? Update our cache:
+        if (KbQueue_xevent.type == ConfigureNotify) {
+            for (i = 0; i < KbQueueNumRoots; i++) {
+                if (KbQueueRootWindow[i] == KbQueue_xevent.xconfigure.window) {
+                    KbQueueRootWidth[i] = (unsigned int) KbQueue_xevent.xconfigure.width;
+                    KbQueueRootHeight[i] = (unsigned int) KbQueue_xevent.xconfigure.height;
+                }
+            }
 
-        // Take timestamp:
-        PsychGetAdjustedPrecisionTimerSeconds(&tnow);
+            return;
+        }
 
         // Clear ringbuffer event:
         memset(&evt, 0 , sizeof(evt));
@@ -577,21 +782,19 @@ static void KbQueueProcessEvents(void)
                     valid = TRUE; // Always true for raw devices like mice etc., unless queue flag 1 is set, see below.
                     index = rawevent->detail;
                     deviceid = rawevent->deviceid;
+                    tnow = KbQueueEventTime(rawevent->time);
                 }
                 else {
                     // Regular device event:
-                    Window rootRet;
-                    unsigned int depth_return, border_width_return;
-                    int x, y;
-
                     event = (XIDeviceEvent*) cookie->data;
                     rawevent = NULL;
                     valid = !(event->flags & XIKeyRepeat);
                     index = event->detail;
                     deviceid = event->deviceid;
+                    tnow = KbQueueEventTime(event->time);
 
                     // Get width x height of associated root window, aka screen size for touch coordinate remapping:
-                    XGetGeometry(thread_dpy, event->root, &rootRet, &x, &y, &screen_width, &screen_height, &border_width_return, &depth_return);
+                    KbQueueGetRootGeometry(event->root, &screen_width, &screen_height);
                 }
 
                 if (event && (cookie->evtype != XI_TouchOwnership)) {
@@ -611,7 +814,7 @@ static void KbQueueProcessEvents(void)
                 }
 
                 // Map Xinput device id to PTB 'deviceIndex' aka the proper keyboard queue:
-                for (i = 0; i < ndevices; i++) if (deviceid == info[i].deviceid) break;
+                i = KbQueueDeviceIdToIndex(deviceid);
 
                 // Special handling for synthetic key repeat flags required?
                 if ((i < ndevices) && (psychHIDKbQueueFlags[i] & 0x3)) {
@@ -696,8 +899,8 @@ static void KbQueueProcessEvents(void)
                         }
                     }
 
-                    // Need the lock from here on:
-                    PsychLockMutex(&KbQueueMutex);
+                    // Track current key state for KbCheck:
+                    KbQueueSetKeyState(i, index, (cookie->evtype == XI_KeyPress) || (cookie->evtype == XI_ButtonPress) || (cookie->evtype == XI_RawButtonPress));
 
                     // This keyboard queue created and started? Interested in this
                     // keycode?
@@ -741,13 +944,8 @@ static void KbQueueProcessEvents(void)
                         // Tell waiting userspace (under KbQueueMutex protection for better scheduling) something interesting has changed:
                         PsychSignalCondition(&KbQueueCondition);
                     }
-
-                    // Done with shared data access:
-                    PsychUnlockMutex(&KbQueueMutex);
                 }
                 else {
-                    PsychLockMutex(&KbQueueMutex);
-
                     if ((i < ndevices) && valid && psychHIDKbQueueActive[i] && (psychHIDKbQueueNumValuators[i] > 0)) {
                         // Handling of motion events / valuator change events / touch events. These only go into the event buffer,
                         // not legacy KbQueue arrays, as those don't make sense here:
@@ -833,8 +1031,10 @@ static void KbQueueProcessEvents(void)
                             evt.rawEventCode = (event) ? event->detail : rawevent->detail;
 
                             // Fetch most recent touch record in the series for this touch point:
-                            // oldevt == NULL if none yet exists, or none exists anymore due to some buffer wraparound:
-                            PsychHIDEventRecord *oldevt = PsychHIDLastTouchEventFromEventBuffer(i, evt.rawEventCode);
+                            // oldevt == NULL if none yet exists, or none exists anymore due to some buffer wraparound.
+                            // The record is a copy, as the buffer can be overwritten or released by other threads:
+                            PsychHIDEventRecord oldevtCopy;
+                            PsychHIDEventRecord *oldevt = (PsychHIDLastTouchEventFromEventBuffer(i, evt.rawEventCode, 0, &oldevtCopy)) ? &oldevtCopy : NULL;
 
                             // Everything of interest is in the valuators:
                             if (cookie->evtype != XI_TouchOwnership) {
@@ -974,7 +1174,7 @@ static void KbQueueProcessEvents(void)
                                     if (FALSE) {
                                         // Nope, we lost touch data. Did we already send a fail event for this touch queue?
                                         // If not, then do it now via the magic 0xffffffff touch point with type 5 for sequence abort.
-                                        if (!PsychHIDLastTouchEventFromEventBuffer(i, 0xffffffff)) {
+                                        if (!PsychHIDLastTouchEventFromEventBuffer(i, 0xffffffff, 0, NULL)) {
                                             // Inject touch end event now ...
                                             PsychHIDAddEventToEventBuffer(i, &evt);
 
@@ -990,8 +1190,10 @@ static void KbQueueProcessEvents(void)
                                 case XI_TouchOwnership:
                                     // Ownership marker: We are the sole owner of this sequence, so got all the data
                                     // untampered :) - Set integrity bit for this touch point in last event for it:
-                                    if (oldevt)
+                                    if (oldevt) {
+                                        PsychHIDLastTouchEventFromEventBuffer(i, evt.rawEventCode, (1 << 31), NULL);
                                         oldevt->status |= (1 << 31);
+                                    }
 
                                     // printf("%i: XI_TouchOwnership!! %p\n", evt.rawEventCode, oldevt);
 
@@ -1014,8 +1216,6 @@ static void KbQueueProcessEvents(void)
                             PsychSignalCondition(&KbQueueCondition);
                         }
                     }
-
-                    PsychUnlockMutex(&KbQueueMutex);
                 }
 
                 // Release event data:
@@ -1027,6 +1227,43 @@ static void KbQueueProcessEvents(void)
     return;
 }
 
+// This is the event dequeue & process function which updates keyboard queue state,
+// called from the background keyboard queue processing thread. It blocks until at
+// least one event is available, then processes it and all further already pending
+// events in batches of up to KBQUEUE_MAX_BATCH events, with the KbQueueMutex held
+// for a whole batch. All events of a batch get timestamps relative to one common
+// timestamp base:
+static void KbQueueProcessEvents(void)
+{
+    psych_bool more;
+    int n;
+
+    // Wait until at least one event available and dequeue it:
+    XNextEvent(thread_dpy, &KbQueue_xevent);
+
+    more = TRUE;
+    while (more) {
+        // Take timestamp base for all events processed in this batch. Taking it per batch
+        // keeps timestamps advancing under a continuous stream of events:
+        PsychGetAdjustedPrecisionTimerSeconds(&KbQueueBatchTime);
+        KbQueueBatchServerTimeValid = FALSE;
+
+        PsychLockMutex(&KbQueueMutex);
+
+        for (n = 0; more && (n < KBQUEUE_MAX_BATCH); n++) {
+            KbQueueProcessEvent();
+
+            // Dequeue next event, if any is already pending and we are not asked to terminate:
+            more = (!KbQueueThreadTerminate && (XPending(thread_dpy) > 0)) ? TRUE : FALSE;
+            if (more) XNextEvent(thread_dpy, &KbQueue_xevent);
+        }
+
+        PsychUnlockMutex(&KbQueueMutex);
+    }
+
+    return;
+}
+
 // Async processing thread for keyboard events:
 void* KbQueueWorkerThreadMain(void* dummy)
 {
@@ -1063,6 +1300,662 @@ void* KbQueueWorkerThreadMain(void* dummy)
     return(NULL);
 }
 
+// Kernel evdev input backend, selected by KbQueueCreate flag +8:
+//
+// Reads input_event records directly from the /dev/input/event* device node of the input device, bypassing
+// the X-Server. Events are timestamped with the kernel event timestamps, remapped to GetSecs time. All evdev
+// backed queues are served by one common worker thread, which waits for new events via epoll. If the device
+// node is a regular file instead, it is treated as a recording of an evdev event stream, e.g., created via
+// "cat /dev/input/eventX > recording", and the recorded events are replayed with their original timing,
+// starting at KbQueueStart. This allows to test keyboard queue processing without real input devices.
+
+// Magic epoll data value for the wakeup eventfd of the evdev thread:
+#define KBQUEUE_EVDEV_WAKEUP 0xffffffff
+
+// Older kernel headers lack these accessors for the timestamp of input_event's:
+#ifndef input_event_sec
+#define input_event_sec time.tv_sec
+#define input_event_usec time.tv_usec
+#endif
+
+// Return kernel timestamp of evdev event 'ev' in seconds:
+static double KbQueueEvdevTime(struct input_event *ev)
+{
+    return((double) ev->input_event_sec + 0.000001 * (double) ev->input_event_usec);
+}
+
+// Map evdev key or button code to KbQueue key index. Returns -1 for unsupported codes:
+static int KbQueueEvdevKeyToIndex(unsigned int code)
+{
+    // Keyboard keys: X11 keycodes, as used by KbCheck, KbQueueCheck et al., are evdev keycodes + 8:
+    if (code < BTN_MISC)
+        return((code < 248) ? (int) code + 8 : -1);
+
+    // Mouse buttons: Zero-based X11 button numbers, ie. left = 0, middle = 1, right = 2, side = 7, ...,
+    // as reported by the XInput backend for the same mouse:
+    if (code == BTN_LEFT) return(0);
+    if (code == BTN_MIDDLE) return(1);
+    if (code == BTN_RIGHT) return(2);
+    if ((code >= BTN_SIDE) && (code <= BTN_TASK)) return((int) (code - BTN_SIDE) + 7);
+
+    // Other buttons, e.g., of joysticks or gamepads, are numbered consecutively within their block:
+    if (code < BTN_MOUSE) return((int) (code - BTN_MISC));
+    if ((code >= BTN_JOYSTICK) && (code < BTN_DIGI)) return((int) (code - BTN_JOYSTICK));
+    if ((code >= BTN_TRIGGER_HAPPY) && (code <= BTN_TRIGGER_HAPPY40)) return((int) (code - BTN_TRIGGER_HAPPY) + 32);
+
+    return(-1);
+}
+
+// Find /dev/input/event* device node of XInput device 'deviceIndex', as reported by the X-Server's input driver:
+static psych_bool KbQueueEvdevGetDeviceNode(int deviceIndex, char *devnode, size_t maxlen)
+{
+    Atom prop, type;
+    int format;
+    unsigned long nitems, bytes_after;
+    unsigned char *data = NULL;
+    psych_bool rc = FALSE;
+
+    prop = XInternAtom(dpy, "Device Node", True);
+    if (prop == None)
+        return(FALSE);
+
+    if ((Success == XIGetProperty(dpy, info[deviceIndex].deviceid, prop, 0, (long) maxlen, False, XA_STRING,
+                                  &type, &format, &nitems, &bytes_after, &data)) &&
+        data && (type == XA_STRING) && (format == 8) && (nitems > 0) && (nitems < maxlen)) {
+        memcpy(devnode, data, nitems);
+        devnode[nitems] = 0;
+        rc = TRUE;
+    }
+
+    if (data) XFree(data);
+
+    return(rc);
+}
+
+// Open evdev device node or replay file for keyboard queue 'deviceIndex'. Called from KbQueueCreate:
+static psych_bool KbQueueEvdevOpen(int deviceIndex)
+{
+    KbQueueEvdevRecord *evdev = &KbQueueEvdev[deviceIndex];
+    struct input_absinfo absinfo;
+    struct stat st;
+    char devnode[FILENAME_MAX];
+    char envname[64];
+    int clockid = CLOCK_MONOTONIC;
+
+    memset(evdev, 0, sizeof(KbQueueEvdevRecord));
+    evdev->fd = -1;
+
+    // User provided override for the device node, or replay file, of this queue?
+    sprintf(envname, "PSYCHHID_EVDEV_NODE_%i", deviceIndex);
+    if (getenv(envname)) {
+        snprintf(devnode, sizeof(devnode), "%s", getenv(envname));
+    }
+    else if (!KbQueueEvdevGetDeviceNode(deviceIndex, devnode, sizeof(devnode))) {
+        printf("PsychHID-ERROR: KbQueueCreate: Input device %i has no associated evdev device node, e.g., because it is a virtual or master device.\n", deviceIndex);
+        printf("PsychHID-ERROR: KbQueueCreate: You can assign one via the environment variable %s.\n", envname);
+        return(FALSE);
+    }
+
+    evdev->fd = open(devnode, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (evdev->fd < 0) {
+        printf("PsychHID-ERROR: KbQueueCreate: Could not open evdev device node %s for input device %i: %s\n", devnode, deviceIndex, strerror(errno));
+        if (errno == EACCES)
+            printf("PsychHID-ERROR: KbQueueCreate: You need read access to the device node, e.g., by membership in the 'input' group.\n");
+        return(FALSE);
+    }
+
+    // Regular file instead of a device node? Then this is a recorded event stream for replay:
+    evdev->replay = (!fstat(evdev->fd, &st) && S_ISREG(st.st_mode)) ? TRUE : FALSE;
+    if (evdev->replay)
+        return(TRUE);
+
+    // Ask for kernel timestamps in CLOCK_MONOTONIC time, so PsychOSMonotonicToRefTime() can remap them to GetSecs time:
+    if (ioctl(evdev->fd, EVIOCSCLOCKID, &clockid))
+        printf("PsychHID-WARNING: KbQueueCreate: Could not switch evdev device node %s to monotonic timestamps: %s\n", devnode, strerror(errno));
+
+    // Get value ranges of absolute (x,y) axis, if any, for normalization of positions:
+    if (!ioctl(evdev->fd, EVIOCGABS(ABS_X), &absinfo)) {
+        evdev->absMin[0] = absinfo.minimum;
+        evdev->absMax[0] = absinfo.maximum;
+    }
+
+    if (!ioctl(evdev->fd, EVIOCGABS(ABS_Y), &absinfo)) {
+        evdev->absMin[1] = absinfo.minimum;
+        evdev->absMax[1] = absinfo.maximum;
+    }
+
+    return(TRUE);
+}
+
+// Initialize key state of evdev backed keyboard queue 'deviceIndex' for KbCheck from the kernel's current key state:
+static void KbQueueEvdevSeedKeyState(int deviceIndex)
+{
+    KbQueueEvdevRecord *evdev = &KbQueueEvdev[deviceIndex];
+    unsigned char keybits[KEY_CNT / 8 + 1];
+    unsigned int code;
+    int index;
+
+    memset((void*) psychHIDKbQueueKeyState[deviceIndex], 0, sizeof(psychHIDKbQueueKeyState[deviceIndex]));
+    evdev->buttons = 0;
+
+    // Replay always starts with all keys released:
+    if (evdev->replay)
+        return;
+
+    memset(keybits, 0, sizeof(keybits));
+    if (ioctl(evdev->fd, EVIOCGKEY(sizeof(keybits)), keybits) < 0)
+        return;
+
+    for (code = 0; code < KEY_CNT; code++) {
+        if (!(keybits[code / 8] & (1 << (code % 8))) || ((index = KbQueueEvdevKeyToIndex(code)) < 0))
+            continue;
+
+        KbQueueSetKeyState(deviceIndex, index, TRUE);
+        if ((code >= BTN_MISC) && (index < 32)) evdev->buttons |= (1 << index);
+    }
+}
+
+// Process one evdev event 'ev' with GetSecs timestamp 'tnow' for keyboard queue 'i'. Must
+// be called with the KbQueueMutex held. Returns TRUE if an event was added to the event buffer:
+static psych_bool KbQueueEvdevProcessEvent(int i, struct input_event *ev, double tnow)
+{
+    KbQueueEvdevRecord *evdev = &KbQueueEvdev[i];
+    PsychHIDEventRecord evt;
+    int j, index, numValuators;
+    double range;
+
+    numValuators = psychHIDKbQueueNumValuators[i];
+    if (numValuators > PSYCH_HID_MAX_VALUATORS) numValuators = PSYCH_HID_MAX_VALUATORS;
+
+    switch (ev->type) {
+        case EV_SYN:
+            // Kernel event buffer overflow? Discard all events until the next complete report:
+            if (ev->code == SYN_DROPPED) {
+                evdev->syncDropped = TRUE;
+                return(FALSE);
+            }
+
+            if (ev->code != SYN_REPORT)
+                return(FALSE);
+
+            if (evdev->syncDropped) {
+                evdev->syncDropped = FALSE;
+                evdev->motion = FALSE;
+                evdev->relMask = 0;
+
+                // Key events may have been lost, so resync key state from the kernel:
+                KbQueueEvdevSeedKeyState(i);
+                return(FALSE);
+            }
+
+            // End of a report. Any valuator changes since last report? Then emit a motion event:
+            if (!evdev->motion)
+                return(FALSE);
+
+            memset(&evt, 0, sizeof(evt));
+            evt.type = 1;
+            evt.status = (1 << 1) | ((evdev->buttons) ? (1 << 0) : 0);
+            evt.buttonStates = evdev->buttons;
+            evt.timestamp = tnow;
+            evt.rawEventCode = 0;
+            evt.cookedEventCode = -1;
+            evt.numValuators = numValuators;
+            for (j = 0; j < numValuators; j++)
+                evt.valuators[j] = (float) evdev->valuators[j];
+
+            // Derive X, Y values from first two valuators. Remap absolute axis to X-Screen size, if possible:
+            evt.X = (numValuators > 0) ? evt.valuators[0] : 0;
+            evt.Y = (numValuators > 1) ? evt.valuators[1] : 0;
+
+            range = evdev->absMax[0] - evdev->absMin[0];
+            if ((range > 0) && !(evdev->relMask & (1 << REL_X))) {
+                evt.normX = (float) ((evt.X - evdev->absMin[0]) / range);
+                evt.X = evt.normX * ((KbQueueNumRoots > 0) ? KbQueueRootWidth[0] : DisplayWidth(thread_dpy, DefaultScreen(thread_dpy)));
+            }
+
+            range = evdev->absMax[1] - evdev->absMin[1];
+            if ((range > 0) && !(evdev->relMask & (1 << REL_Y))) {
+                evt.normY = (float) ((evt.Y - evdev->absMin[1]) / range);
+                evt.Y = evt.normY * ((KbQueueNumRoots > 0) ? KbQueueRootHeight[0] : DisplayHeight(thread_dpy, DefaultScreen(thread_dpy)));
+            }
+
+            // Relative valuators report motion deltas per report, so reset them:
+            for (j = 0; j < PSYCH_HID_MAX_VALUATORS; j++)
+                if (evdev->relMask & (1 << j)) evdev->valuators[j] = 0;
+
+            evdev->relMask = 0;
+            evdev->motion = FALSE;
+
+            PsychHIDAddEventToEventBuffer(i, &evt);
+            return(TRUE);
+
+        case EV_KEY:
+            if (evdev->syncDropped || ((index = KbQueueEvdevKeyToIndex(ev->code)) < 0))
+                return(FALSE);
+
+            // Track current key state for KbCheck. Key repeats don't change it:
+            if (ev->value != 2)
+                KbQueueSetKeyState(i, index, (ev->value) ? TRUE : FALSE);
+
+            // Track state of the first 32 device buttons:
+            if ((ev->code >= BTN_MISC) && (index < 32)) {
+                if (ev->value)
+                    evdev->buttons |= (1 << index);
+                else
+                    evdev->buttons &= ~(1 << index);
+            }
+
+            // Key repeat events are only accepted if queue flag 2 says so:
+            if ((ev->value == 2) && !(psychHIDKbQueueFlags[i] & 0x2))
+                return(FALSE);
+
+            // Interested in this keycode?
+            if (psychHIDKbQueueScanKeys[i][index] == 0)
+                return(FALSE);
+
+            memset(&evt, 0, sizeof(evt));
+
+            // There isn't any keyboard layout mapping for evdev, so key presses don't have a cooked character:
+            evt.cookedEventCode = (ev->value) ? -1 : 0;
+
+            if (ev->value) {
+                if (psychHIDKbQueueFirstPress[i][index] == 0) psychHIDKbQueueFirstPress[i][index] = tnow;
+                psychHIDKbQueueLastPress[i][index] = tnow;
+                evt.status |= (1 << 0);
+            } else {
+                if (psychHIDKbQueueFirstRelease[i][index] == 0) psychHIDKbQueueFirstRelease[i][index] = tnow;
+                psychHIDKbQueueLastRelease[i][index] = tnow;
+                evt.status &= ~(1 << 0);
+            }
+
+            evt.buttonStates = evdev->buttons;
+            evt.timestamp = tnow;
+            evt.rawEventCode = index + 1;
+
+            PsychHIDAddEventToEventBuffer(i, &evt);
+            return(TRUE);
+
+        case EV_REL:
+        case EV_ABS:
+            // Valuators are indexed by evdev axis code, e.g., 0 = x-axis, 1 = y-axis:
+            if (evdev->syncDropped || (ev->code >= numValuators))
+                return(FALSE);
+
+            if (ev->type == EV_REL) {
+                evdev->valuators[ev->code] += ev->value;
+                evdev->relMask |= (1 << ev->code);
+            }
+            else {
+                evdev->valuators[ev->code] = ev->value;
+            }
+
+            evdev->motion = TRUE;
+            return(FALSE);
+    }
+
+    return(FALSE);
+}
+
+// Async processing thread for evdev backed keyboard queues:
+static void* KbQueueEvdevWorkerThreadMain(void* dummy)
+{
+    KbQueueEvdevRecord *evdev;
+    struct epoll_event epevents[16];
+    struct input_event ev[64];
+    psych_uint64 wakeups;
+    psych_bool signal;
+    double tnow, tdue, t;
+    int rc, i, j, k, n, count, timeout;
+
+    // Assign a name to ourselves, for debugging:
+    PsychSetThreadName("PsychHIDEvdev");
+
+    // Try to raise our priority, just as the X event processing thread:
+    if ((rc = PsychSetThreadPriority(NULL, 2, 1)) > 0) {
+        printf("PsychHID: KbQueueStart: Failed to switch evdev thread to realtime priority [%s].\n", strerror(rc));
+    }
+
+    PsychLockMutex(&KbQueueMutex);
+
+    while (!KbQueueEvdevThreadTerminate) {
+        // Feed all due events of replay queues, and find out when the next one is due:
+        PsychGetAdjustedPrecisionTimerSeconds(&tnow);
+        tdue = DBL_MAX;
+        signal = FALSE;
+
+        for (i = 0; i < ndevices; i++) {
+            evdev = &KbQueueEvdev[i];
+            if (!psychHIDKbQueueActive[i] || (evdev->fd < 0) || !evdev->replay)
+                continue;
+
+            while (evdev->replayPending) {
+                t = evdev->replayBase + KbQueueEvdevTime(&evdev->replayNext);
+                if (t > tnow) {
+                    if (t < tdue) tdue = t;
+                    break;
+                }
+
+                signal |= KbQueueEvdevProcessEvent(i, &evdev->replayNext, t);
+                evdev->replayPending = (read(evdev->fd, &evdev->replayNext, sizeof(struct input_event)) == sizeof(struct input_event)) ? TRUE : FALSE;
+            }
+        }
+
+        if (signal) PsychSignalCondition(&KbQueueCondition);
+
+        PsychUnlockMutex(&KbQueueMutex);
+
+        // Wait for new events from evdev devices, a wakeup request, or the next due replay event:
+        timeout = (tdue == DBL_MAX) ? -1 : (int) ceil((tdue - tnow) * 1000);
+        n = epoll_wait(KbQueueEvdevEpollFd, epevents, 16, timeout);
+
+        PsychLockMutex(&KbQueueMutex);
+        signal = FALSE;
+
+        for (j = 0; j < n; j++) {
+            i = (int) epevents[j].data.u32;
+
+            if (epevents[j].data.u32 == KBQUEUE_EVDEV_WAKEUP) {
+                // Wakeup request, e.g., termination or a new queue. Just reset the eventfd:
+                if (read(KbQueueEvdevWakeupFd, &wakeups, sizeof(wakeups)) < 0) wakeups = 0;
+                continue;
+            }
+
+            // Queue got stopped while we were waiting?
+            evdev = &KbQueueEvdev[i];
+            if (!psychHIDKbQueueActive[i] || (evdev->fd < 0))
+                continue;
+
+            // Read and process all pending events of the device:
+            while ((count = (int) read(evdev->fd, ev, sizeof(ev))) > 0) {
+                count /= sizeof(struct input_event);
+                for (k = 0; k < count; k++)
+                    signal |= KbQueueEvdevProcessEvent(i, &ev[k], PsychOSMonotonicToRefTime(KbQueueEvdevTime(&ev[k])));
+            }
+
+            // Device failure, e.g., unplugged? Stop listening to it:
+            if ((count < 0) && (errno != EAGAIN) && (errno != EINTR)) {
+                printf("PsychHID-WARNING: KbQueue: Reading from evdev device of queue %i failed [%s]. No further events from it.\n", i, strerror(errno));
+                epoll_ctl(KbQueueEvdevEpollFd, EPOLL_CTL_DEL, evdev->fd, NULL);
+            }
+        }
+
+        // Tell waiting userspace something interesting has changed:
+        if (signal) PsychSignalCondition(&KbQueueCondition);
+    }
+
+    // Done. Unlock the mutex:
+    PsychUnlockMutex(&KbQueueMutex);
+
+    // Return and terminate:
+    return(NULL);
+}
+
+// Return TRUE if any evdev backed queue other than 'deviceIndex' is active. Called with KbQueueMutex held:
+static psych_bool KbQueueEvdevOtherQueuesActive(int deviceIndex)
+{
+    int i;
+
+    for (i = 0; i < PSYCH_HID_MAX_DEVICES; i++)
+        if ((i != deviceIndex) && psychHIDKbQueueActive[i] && (KbQueueEvdev[i].fd >= 0))
+            return(TRUE);
+
+    return(FALSE);
+}
+
+static void KbQueueEvdevStart(int deviceIndex)
+{
+    KbQueueEvdevRecord *evdev = &KbQueueEvdev[deviceIndex];
+    struct input_event ev[64];
+    struct epoll_event epev;
+    psych_uint64 wakeup = 1;
+    double tnow;
+
+    // Create epoll set and wakeup eventfd for the evdev thread on first use:
+    if (KbQueueEvdevEpollFd < 0) {
+        KbQueueEvdevEpollFd = epoll_create1(EPOLL_CLOEXEC);
+        KbQueueEvdevWakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if ((KbQueueEvdevEpollFd < 0) || (KbQueueEvdevWakeupFd < 0)) {
+            printf("PsychHID-ERROR: Start of evdev keyboard queue processing failed [%s]!\n", strerror(errno));
+            if (KbQueueEvdevEpollFd >= 0) close(KbQueueEvdevEpollFd);
+            if (KbQueueEvdevWakeupFd >= 0) close(KbQueueEvdevWakeupFd);
+            KbQueueEvdevEpollFd = KbQueueEvdevWakeupFd = -1;
+            PsychErrorExitMsg(PsychError_system, "Creation of evdev event polling failed!");
+        }
+
+        memset(&epev, 0, sizeof(epev));
+        epev.events = EPOLLIN;
+        epev.data.u32 = KBQUEUE_EVDEV_WAKEUP;
+        epoll_ctl(KbQueueEvdevEpollFd, EPOLL_CTL_ADD, KbQueueEvdevWakeupFd, &epev);
+    }
+
+    PsychLockMutex(&KbQueueMutex);
+
+    // Clear out current state for this queue:
+    memset(psychHIDKbQueueFirstPress[deviceIndex]   , 0, (256 * sizeof(double)));
+    memset(psychHIDKbQueueFirstRelease[deviceIndex] , 0, (256 * sizeof(double)));
+    memset(psychHIDKbQueueLastPress[deviceIndex]    , 0, (256 * sizeof(double)));
+    memset(psychHIDKbQueueLastRelease[deviceIndex]  , 0, (256 * sizeof(double)));
+    memset(evdev->valuators, 0, sizeof(evdev->valuators));
+    evdev->relMask = 0;
+    evdev->motion = FALSE;
+    evdev->syncDropped = FALSE;
+    KbQueueEvdevSeedKeyState(deviceIndex);
+
+    if (evdev->replay) {
+        // Replay from start of recording, with the first recorded event happening now:
+        lseek(evdev->fd, 0, SEEK_SET);
+        evdev->replayPending = (read(evdev->fd, &evdev->replayNext, sizeof(struct input_event)) == sizeof(struct input_event)) ? TRUE : FALSE;
+        PsychGetAdjustedPrecisionTimerSeconds(&tnow);
+        evdev->replayBase = (evdev->replayPending) ? tnow - KbQueueEvdevTime(&evdev->replayNext) : 0;
+    }
+    else {
+        // Drain stale events from before the start, then listen for new ones:
+        while (read(evdev->fd, ev, sizeof(ev)) > 0);
+
+        memset(&epev, 0, sizeof(epev));
+        epev.events = EPOLLIN;
+        epev.data.u32 = (psych_uint32) deviceIndex;
+        epoll_ctl(KbQueueEvdevEpollFd, EPOLL_CTL_ADD, evdev->fd, &epev);
+    }
+
+    // Mark this queue as logically started:
+    psychHIDKbQueueActive[deviceIndex] = TRUE;
+
+    if (KbQueueEvdevOtherQueuesActive(deviceIndex)) {
+        // Evdev thread already running. Wake it up, so it takes this queue into account:
+        if (write(KbQueueEvdevWakeupFd, &wakeup, sizeof(wakeup)) < 0) printf("PsychHID-WARNING: KbQueueStart: Failed to wake evdev thread.\n");
+    }
+    else {
+        // We are the first evdev queue. Start the common evdev processing thread:
+        KbQueueEvdevThreadTerminate = FALSE;
+        if (PsychCreateThread(&KbQueueEvdevThread, NULL, KbQueueEvdevWorkerThreadMain, NULL)) {
+            // Cleanup the mess:
+            psychHIDKbQueueActive[deviceIndex] = FALSE;
+            if (!evdev->replay) epoll_ctl(KbQueueEvdevEpollFd, EPOLL_CTL_DEL, evdev->fd, NULL);
+            PsychUnlockMutex(&KbQueueMutex);
+
+            printf("PsychHID-ERROR: Start of evdev keyboard queue processing failed!\n");
+            PsychErrorExitMsg(PsychError_system, "Creation of evdev keyboard queue background processing thread failed!");
+        }
+    }
+
+    PsychUnlockMutex(&KbQueueMutex);
+
+    return;
+}
+
+static void KbQueueEvdevStop(int deviceIndex)
+{
+    KbQueueEvdevRecord *evdev = &KbQueueEvdev[deviceIndex];
+    psych_uint64 wakeup = 1;
+    psych_bool lastQueue;
+
+    PsychLockMutex(&KbQueueMutex);
+
+    if (!evdev->replay) epoll_ctl(KbQueueEvdevEpollFd, EPOLL_CTL_DEL, evdev->fd, NULL);
+
+    // Mark queue logically stopped:
+    psychHIDKbQueueActive[deviceIndex] = FALSE;
+
+    // Last active evdev queue? Then shutdown the evdev thread:
+    lastQueue = !KbQueueEvdevOtherQueuesActive(deviceIndex);
+    if (lastQueue) {
+        KbQueueEvdevThreadTerminate = TRUE;
+        if (write(KbQueueEvdevWakeupFd, &wakeup, sizeof(wakeup)) < 0) printf("PsychHID-WARNING: KbQueueStop: Failed to wake evdev thread.\n");
+    }
+
+    PsychUnlockMutex(&KbQueueMutex);
+
+    if (lastQueue) {
+        // Wait for thread termination:
+        PsychDeleteThread(&KbQueueEvdevThread);
+        KbQueueEvdevThreadTerminate = FALSE;
+    }
+
+    return;
+}
+
+// Evdev device state of a gamepad sampler:
+typedef struct GamePadSamplerEvdevRecord {
+    int             fd;                                     // Device node file descriptor.
+    unsigned short  codes[PSYCH_HID_MAX_GAMEPAD_ELEMENTS];  // Evdev codes of all axes, hats and buttons, in sample order.
+} GamePadSamplerEvdevRecord;
+
+// Open evdev device node of game controller 'sampler->deviceIndex' and enumerate its axes, hats and buttons:
+psych_bool PsychHIDOSGamePadSamplerOpen(PsychHIDGamePadSamplerRecord* sampler)
+{
+    GamePadSamplerEvdevRecord *evdev;
+    struct input_absinfo absinfo;
+    unsigned char absbits[ABS_CNT / 8 + 1];
+    unsigned char keybits[KEY_CNT / 8 + 1];
+    char devnode[FILENAME_MAX];
+    char envname[64];
+    unsigned int code;
+    int deviceIndex = sampler->deviceIndex;
+    int n = 0;
+
+    if (deviceIndex >= ndevices) {
+        printf("PsychHID-ERROR: GamePadSamplerStart: Invalid deviceIndex %i specified. No such device!\n", deviceIndex);
+        return(FALSE);
+    }
+
+    // User provided override for the device node?
+    sprintf(envname, "PSYCHHID_EVDEV_NODE_%i", deviceIndex);
+    if (getenv(envname)) {
+        snprintf(devnode, sizeof(devnode), "%s", getenv(envname));
+    }
+    else if (!KbQueueEvdevGetDeviceNode(deviceIndex, devnode, sizeof(devnode))) {
+        printf("PsychHID-ERROR: GamePadSamplerStart: Input device %i has no associated evdev device node, e.g., because it is a virtual or master device.\n", deviceIndex);
+        printf("PsychHID-ERROR: GamePadSamplerStart: You can assign one via the environment variable %s.\n", envname);
+        return(FALSE);
+    }
+
+    evdev = (GamePadSamplerEvdevRecord*) calloc(1, sizeof(GamePadSamplerEvdevRecord));
+    if (!evdev) {
+        printf("PsychHID-ERROR: GamePadSamplerStart: Out of memory!\n");
+        return(FALSE);
+    }
+
+    evdev->fd = open(devnode, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (evdev->fd < 0) {
+        printf("PsychHID-ERROR: GamePadSamplerStart: Could not open evdev device node %s for input device %i: %s\n", devnode, deviceIndex, strerror(errno));
+        if (errno == EACCES)
+            printf("PsychHID-ERROR: GamePadSamplerStart: You need read access to the device node, e.g., by membership in the 'input' group.\n");
+        free(evdev);
+        return(FALSE);
+    }
+
+    memset(absbits, 0, sizeof(absbits));
+    memset(keybits, 0, sizeof(keybits));
+    ioctl(evdev->fd, EVIOCGBIT(EV_ABS, sizeof(absbits)), absbits);
+    ioctl(evdev->fd, EVIOCGBIT(EV_KEY, sizeof(keybits)), keybits);
+
+    // Axes, excluding hats and multi-touch axes:
+    for (code = 0; (code < ABS_MT_SLOT) && (n < PSYCH_HID_MAX_GAMEPAD_ELEMENTS); code++) {
+        if ((code >= ABS_HAT0X) && (code <= ABS_HAT3Y))
+            continue;
+
+        if ((absbits[code / 8] & (1 << (code % 8))) && !ioctl(evdev->fd, EVIOCGABS(code), &absinfo)) {
+            sampler->axisMin[n] = absinfo.minimum;
+            sampler->axisMax[n] = absinfo.maximum;
+            evdev->codes[n++] = code;
+            sampler->numAxes++;
+        }
+    }
+
+    // Hats:
+    for (code = ABS_HAT0X; (code <= ABS_HAT3Y) && (n < PSYCH_HID_MAX_GAMEPAD_ELEMENTS); code++) {
+        if ((absbits[code / 8] & (1 << (code % 8))) && !ioctl(evdev->fd, EVIOCGABS(code), &absinfo)) {
+            sampler->axisMin[n] = absinfo.minimum;
+            sampler->axisMax[n] = absinfo.maximum;
+            evdev->codes[n++] = code;
+            sampler->numHats++;
+        }
+    }
+
+    // Buttons, excluding keyboard keys:
+    for (code = BTN_MISC; (code < KEY_CNT) && (n < PSYCH_HID_MAX_GAMEPAD_ELEMENTS); code++) {
+        if (keybits[code / 8] & (1 << (code % 8))) {
+            evdev->codes[n++] = code;
+            sampler->numButtons++;
+        }
+    }
+
+    if (n == 0) {
+        printf("PsychHID-ERROR: GamePadSamplerStart: Input device %i [%s] has neither axes nor buttons.\n", deviceIndex, devnode);
+        close(evdev->fd);
+        free(evdev);
+        return(FALSE);
+    }
+
+    sampler->os = (void*) evdev;
+
+    return(TRUE);
+}
+
+// Sample current state of all axes, hats and buttons of 'sampler' into 'values'. Called from the sampling
+// thread, needs only one ioctl() per axis and one for all buttons, but no X-Server round trips:
+psych_bool PsychHIDOSGamePadSamplerRead(PsychHIDGamePadSamplerRecord* sampler, double* values)
+{
+    GamePadSamplerEvdevRecord *evdev = (GamePadSamplerEvdevRecord*) sampler->os;
+    struct input_absinfo absinfo;
+    unsigned char keybits[KEY_CNT / 8 + 1];
+    unsigned int code;
+    int i, numAbs = sampler->numAxes + sampler->numHats;
+
+    for (i = 0; i < numAbs; i++) {
+        if (ioctl(evdev->fd, EVIOCGABS(evdev->codes[i]), &absinfo) < 0)
+            return(FALSE);
+
+        values[i] = (double) absinfo.value;
+    }
+
+    if (sampler->numButtons > 0) {
+        memset(keybits, 0, sizeof(keybits));
+        if (ioctl(evdev->fd, EVIOCGKEY(sizeof(keybits)), keybits) < 0)
+            return(FALSE);
+
+        for (i = numAbs; i < numAbs + sampler->numButtons; i++) {
+            code = evdev->codes[i];
+            values[i] = (keybits[code / 8] & (1 << (code % 8))) ? 1 : 0;
+        }
+    }
+
+    return(TRUE);
+}
+
+void PsychHIDOSGamePadSamplerClose(PsychHIDGamePadSamplerRecord* sampler)
+{
+    GamePadSamplerEvdevRecord *evdev = (GamePadSamplerEvdevRecord*) sampler->os;
+
+    if (!evdev)
+        return;
+
+    close(evdev->fd);
+    free(evdev);
+    sampler->os = NULL;
+}
+
 psych_bool PsychHIDIsNotSpecialButtonOrXTest(XIDeviceInfo* dev)
 {
     return(!strstr(dev->name, "XTEST") && !strstr(dev->name, "utton") && !strstr(dev->name, "Bus") &&
@@ -1271,6 +2164,12 @@ PsychError PsychHIDOSKbQueueCreate(int deviceIndex, int numScankeys, int* scanKe
         PsychErrorExitMsg(PsychError_system, "Failed to create keyboard queue due to out of memory condition.");
     }
 
+    // Use kernel evdev input backend instead of XInput?
+    if ((flags & 0x8) && !KbQueueEvdevOpen(deviceIndex)) {
+        PsychHIDOSKbQueueRelease(deviceIndex);
+        PsychErrorExitMsg(PsychError_user, "Failed to create keyboard queue with evdev input backend. See error messages above.");
+    }
+
     // Ready to use this keybord queue.
     return(PsychError_none);
 }
@@ -1296,6 +2195,12 @@ void PsychHIDOSKbQueueRelease(int deviceIndex)
     // Ok, we have a keyboard queue. Stop any operation on it first:
     PsychHIDOSKbQueueStop(deviceIndex);
 
+    // Close evdev device node or replay file, if any:
+    if (KbQueueEvdev[deviceIndex].fd >= 0) {
+        close(KbQueueEvdev[deviceIndex].fd);
+        KbQueueEvdev[deviceIndex].fd = -1;
+    }
+
     // Release its data structures:
     free(psychHIDKbQueueFirstPress[deviceIndex]); psychHIDKbQueueFirstPress[deviceIndex] = NULL;
     free(psychHIDKbQueueFirstRelease[deviceIndex]); psychHIDKbQueueFirstRelease[deviceIndex] = NULL;
@@ -1372,6 +2277,12 @@ void PsychHIDOSKbQueueStop(int deviceIndex)
     // Keyboard queue already stopped?
     if (!psychHIDKbQueueActive[deviceIndex]) return;
 
+    // Queue uses the evdev backend? Stop it and its thread if it was the last one:
+    if (KbQueueEvdev[deviceIndex].fd >= 0) {
+        KbQueueEvdevStop(deviceIndex);
+        return;
+    }
+
     // Queue is active. Stop it:
     PsychLockMutex(&KbQueueMutex);
 
@@ -1396,7 +2307,7 @@ void PsychHIDOSKbQueueStop(int deviceIndex)
     // Was this the last active queue?
     queueActive = FALSE;
     for (i = 0; i < PSYCH_HID_MAX_DEVICES; i++) {
-        queueActive |= psychHIDKbQueueActive[i];
+        queueActive |= (psychHIDKbQueueActive[i] && (KbQueueEvdev[i].fd < 0));
     }
 
     // If more queues are active then we're done:
@@ -1472,12 +2383,18 @@ void PsychHIDOSKbQueueStart(int deviceIndex)
     // Keyboard queue already stopped? Then we ain't nothing to do:
     if (psychHIDKbQueueActive[deviceIndex]) return;
 
+    // Queue uses the evdev backend? Start it and its thread if it is the first one:
+    if (KbQueueEvdev[deviceIndex].fd >= 0) {
+        KbQueueEvdevStart(deviceIndex);
+        return;
+    }
+
     // Queue is inactive. Start it:
 
     // Will this be the first active queue, ie., aren't there any queues running so far?
     queueActive = FALSE;
     for (i = 0; i < PSYCH_HID_MAX_DEVICES; i++) {
-        queueActive |= psychHIDKbQueueActive[i];
+        queueActive |= (psychHIDKbQueueActive[i] && (KbQueueEvdev[i].fd < 0));
     }
 
     PsychLockMutex(&KbQueueMutex);
@@ -1497,6 +2414,9 @@ void PsychHIDOSKbQueueStart(int deviceIndex)
         // Drain our X event queue from possible stale events from previous runs of keyboard queues:
         while (XCheckTypedEvent(thread_dpy, GenericEvent, &KbQueue_xevent))
             PsychYieldIntervalSeconds(0.001);
+
+        // Fetch current root window sizes and get notified about changes from now on:
+        KbQueueInitRootGeometry();
     }
 
     // Clear out current state for this queue:
@@ -1560,6 +2480,10 @@ void PsychHIDOSKbQueueStart(int deviceIndex)
     MultiXISelectEvents(&emask, deviceIndex, psychHIDKbQueueXWindow[deviceIndex]);
     XFlush(thread_dpy);
 
+    // Initialize key state for KbCheck from current device state. Events which happen after event selection,
+    // but before this query, are only processed after we release the KbQueueMutex, so they override this state:
+    KbQueueSeedKeyState(deviceIndex);
+
     // Mark this queue as logically started:
     psychHIDKbQueueActive[deviceIndex] = TRUE;
 
@@ -8,10 +8,12 @@
   AUTHORS:
 
     mario.kleiner.de@gmail.com          mk
+    agent@local                         ag
 
   HISTORY:
 
   27.07.2011     mk     Created.
+  19.10.2026     ag     Add includes for evdev input backend.
 
 */
 
@@ -27,5 +29,14 @@
 #include <X11/Xutil.h>
 #include <X11/extensions/XInput.h>
 #include <X11/extensions/XInput2.h>
+#include <X11/Xatom.h>
+
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #endif
@@ -4176,6 +4176,51 @@ void PsychOSSetUserGLContext(PsychWindowRecordType *windowRecord, psych_bool cop
     }
 }
 
+/* PsychOSCreateSharedGLContext() - Create an OpenGL context for use by a background thread.
+ *
+ * The context shares all heavyweight ressources like textures and sync objects with the
+ * main context of 'windowRecord'. Returns the new context, or NULL if such a context can
+ * not be created, e.g., for windows without a GLXFBConfig.
+ */
+void* PsychOSCreateSharedGLContext(PsychWindowRecordType *windowRecord)
+{
+    GLXContext ctx;
+
+    if (windowRecord->targetSpecific.pixelFormatObject == NULL) return(NULL);
+
+    PsychLockDisplay();
+    ctx = glXCreateNewContext(windowRecord->targetSpecific.deviceContext, windowRecord->targetSpecific.pixelFormatObject, GLX_RGBA_TYPE,
+                              windowRecord->targetSpecific.contextObject, True);
+    PsychUnlockDisplay();
+
+    return((void*) ctx);
+}
+
+/* PsychOSSetSharedGLContext() - Bind a context from PsychOSCreateSharedGLContext() to the calling thread,
+ * or unbind the current context of the calling thread if 'sharedContext' is NULL. Returns TRUE on success.
+ */
+psych_bool PsychOSSetSharedGLContext(PsychWindowRecordType *windowRecord, void* sharedContext)
+{
+    Bool rc;
+
+    // Attach to the windows drawable, like our async flip thread does. We never draw into it:
+    PsychLockDisplay();
+    rc = glXMakeCurrent(windowRecord->targetSpecific.deviceContext, (sharedContext) ? windowRecord->targetSpecific.windowHandle : None, (GLXContext) sharedContext);
+    PsychUnlockDisplay();
+
+    return((rc) ? TRUE : FALSE);
+}
+
+/* PsychOSDestroySharedGLContext() - Destroy a context from PsychOSCreateSharedGLContext(). It must not
+ * be bound to any thread anymore.
+ */
+void PsychOSDestroySharedGLContext(PsychWindowRecordType *windowRecord, void* sharedContext)
+{
+    PsychLockDisplay();
+    glXDestroyContext(windowRecord->targetSpecific.deviceContext, (GLXContext) sharedContext);
+    PsychUnlockDisplay();
+}
+
 /* PsychOSSetupFrameLock - Check if framelock / swaplock support is available on
  * the given graphics system implementation and try to enable it for the given
  * pair of onscreen windows.
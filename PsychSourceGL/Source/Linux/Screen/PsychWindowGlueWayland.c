@@ -1943,6 +1943,32 @@ void PsychOSSetUserGLContext(PsychWindowRecordType * windowRecord, psych_bool co
     return;
 }
 
+/* PsychOSCreateSharedGLContext() - Create an OpenGL context for use by a background thread.
+ *
+ * Unsupported on Waffle backends: The waffle config of the window is not kept around after
+ * window creation, and EGL window surfaces can only be bound in one thread at a time, so
+ * there is no way to attach such a context. Returns NULL, so callers use their fallback path.
+ */
+void* PsychOSCreateSharedGLContext(PsychWindowRecordType *windowRecord)
+{
+    (void) windowRecord;
+    return(NULL);
+}
+
+/* PsychOSSetSharedGLContext() - Bind a context from PsychOSCreateSharedGLContext(). Unsupported. */
+psych_bool PsychOSSetSharedGLContext(PsychWindowRecordType *windowRecord, void* sharedContext)
+{
+    (void) windowRecord, (void) sharedContext;
+    return(FALSE);
+}
+
+/* PsychOSDestroySharedGLContext() - Destroy a context from PsychOSCreateSharedGLContext(). Unsupported. */
+void PsychOSDestroySharedGLContext(PsychWindowRecordType *windowRecord, void* sharedContext)
+{
+    (void) windowRecord, (void) sharedContext;
+    return;
+}
+
 /* PsychOSSetupFrameLock - Check if framelock / swaplock support is available on
  * the given graphics system implementation and try to enable it for the given
  * pair of onscreen windows.
@@ -9,12 +9,14 @@
 
     rwoods@ucla.edu                 rpw
     mario.kleiner.de@gmail.com      mk
+    agent@local                     ag
 
     HISTORY:
 
     19.08.2007      rpw     Created the original implementation used before Psychtoolbox 3.0.12.
     2008 - 2014     mk      Various improvements and bug fixes to rpw's original implementation.
     04.10.2014      mk      Refactored and almost completely rewritten for PTB 3.0.12.
+    19.10.2026      ag      Add unimplemented stubs for the gamepad sampler.
 
     TO DO:
 
@@ -349,6 +351,22 @@ PsychError PsychHIDOSKbCheck(int deviceIndex, double* scanList)
     return(PsychError_none);
 }
 
+psych_bool PsychHIDOSGamePadSamplerOpen(PsychHIDGamePadSamplerRecord* sampler)
+{
+    PsychErrorExitMsg(PsychError_unimplemented, "This function is not yet implemented for macOS, sorry!");
+    return(FALSE);
+}
+
+psych_bool PsychHIDOSGamePadSamplerRead(PsychHIDGamePadSamplerRecord* sampler, double* values)
+{
+    return(FALSE);
+}
+
+void PsychHIDOSGamePadSamplerClose(PsychHIDGamePadSamplerRecord* sampler)
+{
+    return;
+}
+
 /*  Table mapping HID usages in the KeyboardOrKeypad page to virtual key codes.
     Names given for keys refer to US layout.
     May be copied freely.
@@ -1104,6 +1104,38 @@ void PsychOSSetUserGLContext(PsychWindowRecordType *windowRecord, psych_bool cop
     }
 }
 
+/* PsychOSCreateSharedGLContext() - Create an OpenGL context for use by a background thread.
+ *
+ * The context shares all heavyweight ressources like textures and sync objects with the
+ * main context of 'windowRecord'. Returns the new context, or NULL on failure.
+ */
+void* PsychOSCreateSharedGLContext(PsychWindowRecordType *windowRecord)
+{
+    CGLContextObj ctx = NULL;
+
+    if (CGLCreateContext(windowRecord->targetSpecific.pixelFormatObject, windowRecord->targetSpecific.contextObject, &ctx)) return(NULL);
+
+    return((void*) ctx);
+}
+
+/* PsychOSSetSharedGLContext() - Bind a context from PsychOSCreateSharedGLContext() to the calling thread,
+ * or unbind the current context of the calling thread if 'sharedContext' is NULL. Returns TRUE on success.
+ */
+psych_bool PsychOSSetSharedGLContext(PsychWindowRecordType *windowRecord, void* sharedContext)
+{
+    (void) windowRecord;
+    return((CGLSetCurrentContext((CGLContextObj) sharedContext)) ? FALSE : TRUE);
+}
+
+/* PsychOSDestroySharedGLContext() - Destroy a context from PsychOSCreateSharedGLContext(). It must not
+ * be bound to any thread anymore.
+ */
+void PsychOSDestroySharedGLContext(PsychWindowRecordType *windowRecord, void* sharedContext)
+{
+    (void) windowRecord;
+    CGLReleaseContext((CGLContextObj) sharedContext);
+}
+
 /*
     PsychOSUnsetGLContext()
 
@@ -51,6 +51,9 @@ void    PsychOSSetGLContext(PsychWindowRecordType *windowRecord);
 void    PsychOSUnsetGLContext(PsychWindowRecordType *windowRecord);
 double  PsychOSGetVBLTimeAndCount(PsychWindowRecordType *windowRecord, psych_uint64* vblCount);
 void    PsychOSSetUserGLContext(PsychWindowRecordType *windowRecord, psych_bool copyfromPTBContext);
+void*   PsychOSCreateSharedGLContext(PsychWindowRecordType *windowRecord);
+psych_bool PsychOSSetSharedGLContext(PsychWindowRecordType *windowRecord, void* sharedContext);
+void    PsychOSDestroySharedGLContext(PsychWindowRecordType *windowRecord, void* sharedContext);
 psych_bool PsychOSSetupFrameLock(PsychWindowRecordType *masterWindow, PsychWindowRecordType *slaveWindow);
 psych_int64 PsychOSScheduleFlipWindowBuffers(PsychWindowRecordType *windowRecord, double tWhen, psych_int64 targetMSC, psych_int64 divisor, psych_int64 remainder, unsigned int specialFlags);
 psych_int64 PsychOSGetSwapCompletionTimestamp(PsychWindowRecordType *windowRecord, psych_int64 targetSBC, double* tSwap);
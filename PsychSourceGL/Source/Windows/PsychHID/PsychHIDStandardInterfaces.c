@@ -8,10 +8,12 @@
     AUTHORS:
 
     mario.kleiner.de@gmail.com  mk
+    agent@local                 ag
 
     HISTORY:
 
         9.08.2011     mk     Created.
+        19.10.2026    ag     Add unimplemented stubs for the gamepad sampler.
 
     TO DO:
 
@@ -717,6 +719,22 @@ PsychError PsychHIDOSGamePadAxisQuery(int deviceIndex, int axisId, double* min,
     return(PsychError_none);
 }
 
+psych_bool PsychHIDOSGamePadSamplerOpen(PsychHIDGamePadSamplerRecord* sampler)
+{
+    PsychErrorExitMsg(PsychError_unimplemented, "This function is not yet implemented for MS-Windows, sorry!");
+    return(FALSE);
+}
+
+psych_bool PsychHIDOSGamePadSamplerRead(PsychHIDGamePadSamplerRecord* sampler, double* values)
+{
+    return(FALSE);
+}
+
+void PsychHIDOSGamePadSamplerClose(PsychHIDGamePadSamplerRecord* sampler)
+{
+    return;
+}
+
 // This is the event dequeue & process function which updates keyboard queue state.
 static void KbQueueProcessEvents(psych_bool longSleep)
 {
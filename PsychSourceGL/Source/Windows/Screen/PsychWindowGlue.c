@@ -2367,6 +2367,44 @@ void PsychOSSetUserGLContext(PsychWindowRecordType *windowRecord, psych_bool cop
     }
 }
 
+/* PsychOSCreateSharedGLContext() - Create an OpenGL context for use by a background thread.
+ *
+ * The context shares all heavyweight ressources like textures and sync objects with the
+ * main context of 'windowRecord'. Returns the new context, or NULL on failure.
+ */
+void* PsychOSCreateSharedGLContext(PsychWindowRecordType *windowRecord)
+{
+    HGLRC ctx;
+
+    ctx = wglCreateContext(windowRecord->targetSpecific.deviceContext);
+    if (ctx == NULL) return(NULL);
+
+    // Without ressource sharing the context is useless to us:
+    if (!wglShareLists(windowRecord->targetSpecific.contextObject, ctx)) {
+        wglDeleteContext(ctx);
+        return(NULL);
+    }
+
+    return((void*) ctx);
+}
+
+/* PsychOSSetSharedGLContext() - Bind a context from PsychOSCreateSharedGLContext() to the calling thread,
+ * or unbind the current context of the calling thread if 'sharedContext' is NULL. Returns TRUE on success.
+ */
+psych_bool PsychOSSetSharedGLContext(PsychWindowRecordType *windowRecord, void* sharedContext)
+{
+    return((wglMakeCurrent(windowRecord->targetSpecific.deviceContext, (HGLRC) sharedContext)) ? TRUE : FALSE);
+}
+
+/* PsychOSDestroySharedGLContext() - Destroy a context from PsychOSCreateSharedGLContext(). It must not
+ * be bound to any thread anymore.
+ */
+void PsychOSDestroySharedGLContext(PsychWindowRecordType *windowRecord, void* sharedContext)
+{
+    (void) windowRecord;
+    wglDeleteContext((HGLRC) sharedContext);
+}
+
 /* PsychOSSetupFrameLock - Check if framelock / swaplock support is available on
  * the given graphics system implementation and try to enable it for the given
  * pair of onscreen windows.
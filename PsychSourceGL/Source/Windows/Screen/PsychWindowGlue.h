@@ -34,6 +34,9 @@ void    PsychOSSetVBLSyncLevel(PsychWindowRecordType *windowRecord, int swapInte
 void    PsychOSSetGLContext(PsychWindowRecordType *windowRecord);
 void    PsychOSUnsetGLContext(PsychWindowRecordType *windowRecord);
 void    PsychOSSetUserGLContext(PsychWindowRecordType *windowRecord, psych_bool copyfromPTBContext);
+void*   PsychOSCreateSharedGLContext(PsychWindowRecordType *windowRecord);
+psych_bool PsychOSSetSharedGLContext(PsychWindowRecordType *windowRecord, void* sharedContext);
+void    PsychOSDestroySharedGLContext(PsychWindowRecordType *windowRecord, void* sharedContext);
 double  PsychOSGetVBLTimeAndCount(PsychWindowRecordType *windowRecord, psych_uint64* vblCount);
 void    PsychGetMouseButtonState(double* buttonArray);
 psych_bool PsychOSGetPresentationTimingInfo(PsychWindowRecordType *windowRecord, psych_bool postSwap, unsigned int flags, psych_uint64* onsetVBLCount, double* onsetVBLTime, psych_uint64* frameId, double* compositionRate, int fullStateStructReturnArgPos);
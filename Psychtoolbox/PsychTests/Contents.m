@@ -20,6 +20,7 @@
 %   ConvolutionKernelTest           - Test routine for correctness, accuracy and speed of PTB imaging convolution shaders.
 %   DatapixxGPUDitherpatternTest    - Low level diagnostic of GPU dithering bugs via Datapixx et al.
 %   DeinterlacerTest                - Simple correctness test for GLSL video image deinterlacer. INCOMPLETE.
+%   DmaBufImportFallbackTest        - Test fallback to regular upload of zero-copy DMA-BUF video texture import.
 %   DrawingIntoTexturesTest         - Tests if using a texture as an offscreen window, i.e., for drawing, works.
 %   DrawTextFontSwitchSpeedTest - Test speed of text drawing when switching between different font type/style/size settings.
 %   DriftTexturePrecisionTest       - Test subpixel accuracy of texture interpolators: What is the smallest
@@ -41,11 +42,15 @@
 %   GetSecsTest                     - Timing test of clock used by Psychtoolbox, e.g., GetSecs, WaitSecs, Screen...
 %   GraphicsDisplaySyncAcrossDualHeadsTest - Test synchronization of refresh cycles of different display heads.
 %   GraphicsDisplaySyncAcrossDualHeadsTestLinux - Linux version of the test.
+%   HDRImageTextureOrientationTest  - Test that Screen('ReadHDRImage') textures match Screen('MakeTexture') of the image matrix.
 %   HDRTest                         - Perform some basic correctness tests and evaluation for HDR display operation, using a Colorimeter.
 %   HIDIntervalTest                 - Sample HID keyboard and mouse, plot distribution of detected event times.
 %   HighColorPrecisionDrawingTest   - Test drawing precision of a variety of Screen() functions, esp. wrt. high precision framebuffers.
 %   HighPrecisionLuminanceOutputDriversImagingPipelineTest - Test precision of a variety of high precision luminance device output drivers.
+%   HookChainFusionTest             - Test that fused imaging pipeline hook chain shader slots give the same output as unfused ones.
 %   JavaClockTest                   - Timing test of clock used by Java functions (e.g. GetChar)
+%   KbQueueEvdevTimestampTest       - Test timestamps of the evdev backend of KbQueues on Linux, with replayed and uinput events.
+%   KbQueueXTestBatchTest           - Test order and timestamps of batched KbQueue events on Linux/X11 via XTest.
 %   KeyboardLatencyTest             - Get a feeling for keyboard and mouse latency via some sound-based measurement procedure.
 %   LabLuvTest                      - Test routines that convert to CIELAB and CIELUV.
 %   LoadGenerator                   - Create cpu load by spinning in an infinite loop. Used in conjunction with FlipTimingWithRTBoxPhotoDiodeTest.
@@ -53,6 +58,7 @@
 %   MakeTextureTimingTest           - Time texture creation -> upload -> destruction for given texture by MakeTexture et al.
 %   MelanopsinFundamentalTest       - Test the PTB routines generate a good melanopsin fundamental.
 %   MonoImageToSRGBTest             - Test/demo for routine PsychColorimetric/MonoImageToSRGB.
+%   MovieSeekIndexReuseTest         - Test the movie seek index with gapless queueing of movies.
 %   MultiWindowLockStepTest         - Exercise asynchronous flip scheduling and timestamping on multiple onscreen windows in parallel.
 %   MultiWindowVulkanTest           - Test multi-window / multi-display exclusive operation under Vulkan.
 %   OSAUCSTest                      - Test OSA UCS <-> XYZ conversion routines.
@@ -68,6 +74,7 @@
 %   QuestTest                       - Some Quest simulations, more elaborate than QuestDemo.
 %   ResolutionTest                  - Use Screen Resolutions to print table of display resolutions.
 %   RodFundamentalTest              - Test the PTB routines generate a good rod fundamental.
+%   ShaderCacheFusionTest           - Test fusion of hook chain shader slots with GLSL programs loaded from the shader cache.
 %   StructsFileTest                 - Test routines for reading and writing struct arrays to text files.
 %   SyncedCLUTUpdateTest            - Visual test of clut write synching to vertical retrace.
 %   TextBoundsTest                  - Test Screen('TestBounds')
@@ -79,6 +86,7 @@
 %   TextureChannelsTest             - Test assignment of matrix layers to RGBA texture channels.
 %   TextureSharingTest              - Test OpenGL context resource sharing.
 %   TrolandTest                     - Test colorimetric conversions.
+%   USBStreamingTest                - Test streaming reception of reports from a generic USB device, or a simulated one, via PsychHID.
 %   VBLSyncTest                     - Tests visual stimulus onset timing and timestamping.
 %   VREyetrackingTest               - Test eye gaze tracking in VR/AR HMDs and other XR devices.
 %   VRRFixedRateSwitchingTest       - Test support for fast refresh rate switching on AMD+Linux via VRR mechanisms.
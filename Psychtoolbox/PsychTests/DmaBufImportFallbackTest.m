@@ -0,0 +1,65 @@
+function DmaBufImportFallbackTest(nrFrames)
+% DmaBufImportFallbackTest - Test fallback path of zero-copy DMA-BUF video texture import.
+%
+% DmaBufImportFallbackTest([nrFrames=60])
+%
+% This test opens a GStreamer video capture device with a videotestsrc as
+% video source and requests zero-copy import of video frames into
+% textures via recordingflags 16384. videotestsrc delivers its frames in
+% regular system memory, so no frame can be imported without copy, and
+% Screen must fall back to regular texture upload for all frames.
+%
+% The test fetches 'nrFrames' frames, by default 60, displays them and
+% then checks via Screen('SetVideoCaptureParameter', ..., 'GetZeroCopyFrameCount')
+% and 'GetCopiedFrameCount' that all fetched frames were uploaded by copy.
+%
+
+% History:
+% 19-Oct-2026  ag  Written.
+
+if nargin < 1 || isempty(nrFrames)
+    nrFrames = 60;
+end
+
+PsychDefaultSetup(1);
+
+try
+    win = Screen('OpenWindow', 0, 0);
+
+    % Use a videotestsrc as video source for deviceIndex -9. It only provides
+    % frames in system memory:
+    Screen('SetVideoCaptureParameter', -1, 'SetNextCaptureBinSpec=videotestsrc is-live=true');
+
+    % Open with RGBA8 textures and zero-copy import requested:
+    grabber = Screen('OpenVideoCapture', win, -9, [0 0 640 480], 4, [], [], [], [], 16384);
+    Screen('StartVideoCapture', grabber, 30, 1);
+
+    fetched = 0;
+    while fetched < nrFrames
+        tex = Screen('GetCapturedImage', win, grabber, 1);
+        if tex > 0
+            fetched = fetched + 1;
+            Screen('DrawTexture', win, tex);
+            Screen('Close', tex);
+            Screen('Flip', win);
+        end
+    end
+
+    zeroCopy = Screen('SetVideoCaptureParameter', grabber, 'GetZeroCopyFrameCount');
+    copied = Screen('SetVideoCaptureParameter', grabber, 'GetCopiedFrameCount');
+
+    Screen('StopVideoCapture', grabber);
+    Screen('CloseVideoCapture', grabber);
+    sca;
+catch
+    sca;
+    psychrethrow(psychlasterror);
+end
+
+fprintf('Fetched %i frames: %i imported without copy, %i uploaded by copy.\n', fetched, zeroCopy, copied);
+
+if (zeroCopy == 0) && (copied == fetched)
+    fprintf('DmaBufImportFallbackTest: PASSED. All system memory frames used regular texture upload.\n');
+else
+    error('DmaBufImportFallbackTest: FAILED. Expected 0 zero-copy and %i copied frames.', fetched);
+end
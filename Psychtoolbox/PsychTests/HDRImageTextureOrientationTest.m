@@ -0,0 +1,63 @@
+function HDRImageTextureOrientationTest(imgfilename)
+% HDRImageTextureOrientationTest - Test textures created directly by Screen('ReadHDRImage').
+%
+% HDRImageTextureOrientationTest([imgfilename])
+%
+% This test loads the OpenEXR image 'imgfilename', by default the
+% GoldenGate.exr image from the OpenEXRImages demo folder, in two ways:
+% As an image matrix which is then converted into a texture via
+% Screen('MakeTexture'), and directly as a texture via the 'windowPtr'
+% argument of Screen('ReadHDRImage'). Both textures are drawn into the
+% same rectangle of a floating point framebuffer and read back, and the
+% test checks that both give identical images, e.g., that both have the
+% same upright orientation.
+%
+
+% History:
+% 19-Oct-2026  ag  Written.
+
+if nargin < 1 || isempty(imgfilename)
+    imgfilename = [PsychtoolboxRoot 'PsychDemos' filesep 'OpenEXRImages' filesep 'GoldenGate.exr'];
+end
+
+PsychDefaultSetup(1);
+
+try
+    PsychImaging('PrepareConfiguration');
+    PsychImaging('AddTask', 'General', 'FloatingPoint32Bit');
+    win = PsychImaging('OpenWindow', 0, 0);
+    winrect = Screen('Rect', win);
+
+    % Matrix path:
+    img = Screen('ReadHDRImage', imgfilename, 2, 2);
+    texMatrix = Screen('MakeTexture', win, img, [], [], 2);
+
+    % Direct texture path:
+    texDirect = Screen('ReadHDRImage', imgfilename, 2, 2, win);
+
+    % Draw both into the same rectangle, without filtering, and read back:
+    dstRect = CenterRect(ScaleRect(Screen('Rect', texMatrix), 0.5, 0.5), winrect);
+
+    Screen('FillRect', win, 0);
+    Screen('DrawTexture', win, texMatrix, [], dstRect, [], 0);
+    imgMatrix = Screen('GetImage', win, dstRect, 'backBuffer', 1, 4);
+
+    Screen('FillRect', win, 0);
+    Screen('DrawTexture', win, texDirect, [], dstRect, [], 0);
+    imgDirect = Screen('GetImage', win, dstRect, 'backBuffer', 1, 4);
+
+    Screen('Close', [texMatrix, texDirect]);
+    sca;
+catch
+    sca;
+    psychrethrow(psychlasterror);
+end
+
+maxdiff = max(abs(imgMatrix(:) - imgDirect(:)));
+fprintf('Maximum difference between matrix and direct texture path: %f\n', maxdiff);
+
+if maxdiff == 0
+    fprintf('HDRImageTextureOrientationTest: PASSED. Both paths give identical images.\n');
+else
+    error('HDRImageTextureOrientationTest: FAILED. Direct texture differs from MakeTexture result.');
+end
@@ -0,0 +1,152 @@
+function HookChainFusionTest
+% HookChainFusionTest - Test fusion of shader slots in imaging pipeline hook chains.
+%
+% HookChainFusionTest
+%
+% Builds a 'FinalOutputFormattingBlit' hook chain of three passes with one
+% fusable GLSL shader slot each:
+%
+% 1. Inversion of the input color.
+% 2. Color lookup in a lookup texture bound via the 'luttexid1' argument.
+% 3. Swizzle of red and green, and scaling of blue by a uniform.
+%
+% The chain is executed once with the hook chain optimizer enabled, and once
+% with it disabled via the environment variable
+% PSYCH_DISABLE_HOOKCHAIN_OPTIMIZER, and the test checks that both give the
+% expected output image. As the lookup texture of a fused pass is bound for
+% the first shader slot of the pass only, the test also checks that the
+% optimizer only fuses slots 2 and 3, but not the slot with the lookup
+% texture into the pass of slot 1.
+%
+
+% History:
+% 19-Oct-2026  ag  Written.
+
+global GL;
+
+PsychDefaultSetup(1);
+InitializeMatlabOpenGL([], [], 1);
+
+oldenv = getenv('PSYCH_DISABLE_HOOKCHAIN_OPTIMIZER');
+
+try
+    win = Screen('OpenWindow', max(Screen('Screens')), 0, [0 0 256 64], [], [], [], [], ...
+                 mor(kPsychNeedFastBackingStore, kPsychNeedOutputConversion));
+
+    % Input image: Gray ramp of all 256 levels:
+    ramp = repmat(uint8(0:255), 64, 1);
+    tex = Screen('MakeTexture', win, ramp);
+
+    % Lookup texture: Level i maps to (255 - i, i, 128):
+    lut = uint8(zeros(1, 256, 3));
+    lut(1, :, 1) = 255:-1:0;
+    lut(1, :, 2) = 0:255;
+    lut(1, :, 3) = 128;
+    luttex = Screen('MakeTexture', win, lut);
+    lutgltex = Screen('GetOpenGLTexture', win, luttex);
+
+    % Shaders:
+    shaders(1) = CreateShader(win, ['#extension GL_ARB_texture_rectangle : enable\n' ...
+        'uniform sampler2DRect Image;\n' ...
+        'void main()\n{\n' ...
+        '    gl_FragColor = vec4(vec3(1.0) - texture2DRect(Image, gl_TexCoord[0].st).rgb, 1.0);\n}\n']);
+    shaders(2) = CreateShader(win, ['#extension GL_ARB_texture_rectangle : enable\n' ...
+        'uniform sampler2DRect Image;\n' ...
+        'uniform sampler2DRect LUT;\n' ...
+        'vec4 PsychFusableStage(vec4 incolor)\n{\n' ...
+        '    return(vec4(texture2DRect(LUT, vec2(floor(incolor.r * 255.0 + 0.5) + 0.5, 0.5)).rgb, 1.0));\n}\n' ...
+        'void main()\n{\n' ...
+        '    gl_FragColor = PsychFusableStage(texture2DRect(Image, gl_TexCoord[0].st));\n}\n']);
+    shaders(3) = CreateShader(win, ['#extension GL_ARB_texture_rectangle : enable\n' ...
+        'uniform sampler2DRect Image;\n' ...
+        'uniform float Gain;\n' ...
+        'vec4 PsychFusableStage(vec4 incolor)\n{\n' ...
+        '    return(vec4(incolor.g, incolor.r, incolor.b * Gain, 1.0));\n}\n' ...
+        'void main()\n{\n' ...
+        '    gl_FragColor = PsychFusableStage(texture2DRect(Image, gl_TexCoord[0].st));\n}\n']);
+
+    Screen('BeginOpenGL', win);
+    glUseProgram(shaders(2));
+    glUniform1i(glGetUniformLocation(shaders(2), 'LUT'), 1);
+    glUseProgram(shaders(3));
+    glUniform1f(glGetUniformLocation(shaders(3), 'Gain'), 0.5);
+    glUseProgram(0);
+    Screen('EndOpenGL', win);
+
+    % Expected result for input level i:
+    i = double(ramp(1, :));
+    expected = zeros(1, 256, 3);
+    expected(1, :, 1) = 255 - i;
+    expected(1, :, 2) = i;
+    expected(1, :, 3) = 64;
+
+    failed = 0;
+    for optimize = [1, 0]
+        if optimize
+            setenv('PSYCH_DISABLE_HOOKCHAIN_OPTIMIZER', '');
+        else
+            setenv('PSYCH_DISABLE_HOOKCHAIN_OPTIMIZER', '1');
+        end
+
+        % (Re-)Build the chain, which (re-)runs the optimizer:
+        Screen('HookFunction', win, 'Reset', 'FinalOutputFormattingBlit');
+        Screen('HookFunction', win, 'AppendShader', 'FinalOutputFormattingBlit', 'Invert', shaders(1), 'Fusable');
+        Screen('HookFunction', win, 'AppendBuiltin', 'FinalOutputFormattingBlit', 'Builtin:FlipFBOs', '');
+        Screen('HookFunction', win, 'AppendShader', 'FinalOutputFormattingBlit', 'Lookup', shaders(2), 'Fusable', lutgltex);
+        Screen('HookFunction', win, 'AppendBuiltin', 'FinalOutputFormattingBlit', 'Builtin:FlipFBOs', '');
+        Screen('HookFunction', win, 'AppendShader', 'FinalOutputFormattingBlit', 'Swizzle', shaders(3), 'Fusable');
+        Screen('HookFunction', win, 'Enable', 'FinalOutputFormattingBlit');
+
+        Screen('DrawTexture', win, tex);
+        Screen('DrawingFinished', win, 0, 1);
+        img = double(Screen('GetImage', win, [0 0 256 1], 'backBuffer'));
+        Screen('Flip', win);
+
+        [passCount, gpuPassTimes, specifiedPassCount, eliminatedBlits, fusedSlots] = ...
+            Screen('HookFunction', win, 'PassStatistics', 'FinalOutputFormattingBlit'); %#ok<ASGLU>
+
+        maxdiff = max(abs(img(:) - expected(:)));
+        fprintf('Optimizer %i: %i of %i passes executed, %i slots fused, max difference to expected image %f.\n', ...
+                optimize, passCount, specifiedPassCount, fusedSlots, maxdiff);
+
+        if maxdiff > 1
+            fprintf('Optimizer %i: FAILED - Wrong output image.\n', optimize);
+            failed = failed + 1;
+        end
+
+        if (optimize && ((passCount ~= 2) || (fusedSlots ~= 2))) || (~optimize && ((passCount ~= 3) || (fusedSlots ~= 0)))
+            fprintf('Optimizer %i: FAILED - Unexpected fusion of shader slots.\n', optimize);
+            failed = failed + 1;
+        end
+    end
+
+    setenv('PSYCH_DISABLE_HOOKCHAIN_OPTIMIZER', oldenv);
+    sca;
+catch
+    setenv('PSYCH_DISABLE_HOOKCHAIN_OPTIMIZER', oldenv);
+    sca;
+    psychrethrow(psychlasterror);
+end
+
+if failed > 0
+    error('HookChainFusionTest: %i checks FAILED!', failed);
+end
+
+fprintf('HookChainFusionTest: PASSED. Fused and unfused hook chains give the expected output.\n');
+
+return;
+
+function glsl = CreateShader(win, fragmentSrc)
+global GL;
+
+Screen('BeginOpenGL', win);
+shader = glCreateShader(GL.FRAGMENT_SHADER);
+glShaderSource(shader, sprintf(fragmentSrc));
+glCompileShader(shader);
+glsl = glCreateProgram();
+glAttachShader(glsl, shader);
+glLinkProgram(glsl);
+glDeleteShader(shader);
+Screen('EndOpenGL', win);
+
+return;
@@ -0,0 +1,267 @@
+function KbQueueEvdevTimestampTest
+% KbQueueEvdevTimestampTest - Test timestamps of the evdev backend of KbQueues on Linux.
+%
+% KbQueueEvdevTimestampTest
+%
+% KbQueueCreate flag +8 selects the kernel evdev input backend on Linux,
+% which reads events from a /dev/input/event* device node. The node can be
+% assigned via the environment variable PSYCHHID_EVDEV_NODE_i, where i is
+% the deviceIndex of the queue. This test uses that to check the event
+% timestamps of the backend in two ways:
+%
+% 1. Replay of a recorded event stream: The test writes a recording of key
+%    strokes 40 msecs apart into a temporary file and assigns it as node.
+%    The replayed events must arrive in recorded order, with the recorded
+%    spacing, starting at KbQueueStart.
+%
+% 2. Live events of a uinput device: A helper script, run via python3,
+%    creates a virtual keyboard via /dev/uinput, types key strokes 50 msecs
+%    apart into it and logs the CLOCK_MONOTONIC time of each key press
+%    before it is sent. The device node of the virtual keyboard gets
+%    assigned to the queue, so the events carry kernel timestamps in
+%    CLOCK_MONOTONIC time, as requested by PsychHID via EVIOCSCLOCKID, and
+%    remapped to GetSecs time. The test maps the logged times to GetSecs
+%    time via GetSecs('AllClocks') and checks that each key press timestamp
+%    is no earlier than its logged send time, and at most 2 msecs later.
+%    This part needs write access to /dev/uinput, e.g., as root, and read
+%    access to the created device node, and gets skipped otherwise.
+%
+% The queues are created for the first keyboard device, eg., the
+% "Virtual core XTEST keyboard" under Xvfb, as the device node override
+% means no events of the real device are read.
+%
+
+% History:
+% 19-Oct-2026  ag  Written.
+
+if ~IsLinux
+    fprintf('KbQueueEvdevTimestampTest: SKIPPED. Only supported on Linux.\n');
+    return;
+end
+
+KbName('UnifyKeyNames');
+
+keyboardIndices = GetKeyboardIndices;
+if isempty(keyboardIndices)
+    error('KbQueueEvdevTimestampTest: No keyboard device found.');
+end
+dev = keyboardIndices(1);
+envname = sprintf('PSYCHHID_EVDEV_NODE_%i', dev);
+oldenv = getenv(envname);
+tmpfiles = {};
+
+failed = 0;
+try
+    % Part 1: Replay of a recording. Linux evdev key codes of keys a, s, d, f:
+    evcodes = [30, 31, 32, 33];
+    keys = {'a', 's', 'd', 'f'};
+    recfile = [tempname '.evdev'];
+    tmpfiles{end+1} = recfile;
+    WriteRecording(recfile, evcodes, 0.040);
+
+    setenv(envname, recfile);
+    KbQueueCreate(dev, [], [], [], 8);
+    tstart = GetSecs;
+    KbQueueStart(dev);
+    WaitSecs(0.5);
+    evts = GetEvents(dev);
+    KbQueueRelease(dev);
+
+    failed = failed + CheckOrder('Replay', evts, keys);
+    if numel(evts) == 2 * numel(keys)
+        spacing = diff([evts(1:2:end).Time]) * 1000;
+        fprintf('Replay: First event %f msecs after KbQueueStart, key press spacing min %f msecs, max %f msecs, expected 40 msecs.\n', ...
+                (evts(1).Time - tstart) * 1000, min(spacing), max(spacing));
+        if any(abs(spacing - 40) > 2) || (evts(1).Time < tstart) || (evts(1).Time - tstart > 0.010)
+            fprintf('Replay: FAILED - Wrong timestamps.\n');
+            failed = failed + 1;
+        end
+    end
+
+    % Part 2: Live events from a uinput device:
+    rc = system('test -w /dev/uinput && python3 -c "import fcntl"');
+    if rc ~= 0
+        fprintf('Uinput: SKIPPED. No write access to /dev/uinput, or no python3 available.\n');
+    else
+        base = tempname;
+        scriptfile = [base '.py'];
+        nodefile = [base '.node'];
+        startfile = [base '.start'];
+        timesfile = [base '.times'];
+        tmpfiles = [tmpfiles, {scriptfile, nodefile, startfile, timesfile}];
+
+        fd = fopen(scriptfile, 'w');
+        fprintf(fd, '%s', UinputScript);
+        fclose(fd);
+        system(sprintf('python3 %s %s %s %s %s &', scriptfile, nodefile, startfile, timesfile, sprintf('%i,', evcodes)));
+
+        % Wait for the helper to create the virtual keyboard and report its device node:
+        tdeadline = GetSecs + 10;
+        while ~exist(nodefile, 'file') && (GetSecs < tdeadline)
+            WaitSecs(0.05);
+        end
+        if ~exist(nodefile, 'file')
+            error('The uinput helper script did not create a virtual keyboard.');
+        end
+        node = strtrim(fileread(nodefile));
+        fprintf('Uinput: Virtual keyboard device node is %s.\n', node);
+
+        setenv(envname, node);
+        KbQueueCreate(dev, [], [], [], 8);
+        KbQueueStart(dev);
+
+        % Let the helper type, and wait until it logged its send times:
+        fclose(fopen(startfile, 'w'));
+        tdeadline = GetSecs + 10;
+        while ~exist(timesfile, 'file') && (GetSecs < tdeadline)
+            WaitSecs(0.05);
+        end
+        WaitSecs(0.1);
+        evts = GetEvents(dev);
+        KbQueueRelease(dev);
+
+        if ~exist(timesfile, 'file')
+            error('The uinput helper script did not log its key press times.');
+        end
+
+        % Map logged CLOCK_MONOTONIC send times to GetSecs time:
+        [getsecsTime, wallTime, syncError, monotonicTime] = GetSecs('AllClocks'); %#ok<ASGLU>
+        tsend = sscanf(fileread(timesfile), '%f')' + (getsecsTime - monotonicTime);
+
+        failed = failed + CheckOrder('Uinput', evts, keys);
+        if numel(evts) == 2 * numel(keys)
+            lag = ([evts(1:2:end).Time] - tsend) * 1000;
+            fprintf('Uinput: Key press timestamp minus send time min %f msecs, max %f msecs, sync error %f msecs.\n', ...
+                    min(lag), max(lag), syncError * 1000);
+            if any(lag < -(syncError * 1000 + 0.1)) || any(lag > 2)
+                fprintf('Uinput: FAILED - Timestamps do not match send times.\n');
+                failed = failed + 1;
+            end
+        end
+    end
+
+    setenv(envname, oldenv);
+catch
+    KbQueueRelease(dev);
+    setenv(envname, oldenv);
+    DeleteFiles(tmpfiles);
+    psychrethrow(psychlasterror);
+end
+
+DeleteFiles(tmpfiles);
+
+if failed > 0
+    error('KbQueueEvdevTimestampTest: %i checks FAILED!', failed);
+end
+
+fprintf('KbQueueEvdevTimestampTest: PASSED.\n');
+
+return;
+
+function WriteRecording(recfile, evcodes, spacing)
+% Key press and release of each key, each followed by a SYN_REPORT, as
+% struct input_event records of 64 bit Linux: tv_sec, tv_usec, type, code, value.
+fd = fopen(recfile, 'w');
+t = 1000;
+for i = 1:numel(evcodes)
+    for pressed = [1, 0]
+        WriteEvent(fd, t, 1, evcodes(i), pressed);
+        WriteEvent(fd, t, 0, 0, 0);
+        t = t + spacing / 2;
+    end
+end
+fclose(fd);
+
+return;
+
+function WriteEvent(fd, t, type, code, value)
+fwrite(fd, [floor(t), round((t - floor(t)) * 1e6)], 'int64');
+fwrite(fd, [type, code], 'uint16');
+fwrite(fd, value, 'int32');
+
+return;
+
+function evts = GetEvents(dev)
+evts = [];
+while KbEventAvail(dev) > 0
+    evt = KbEventGet(dev);
+    evts = [evts, evt]; %#ok<AGROW>
+end
+
+return;
+
+function failed = CheckOrder(name, evts, keys)
+failed = 0;
+
+fprintf('%s: %i events received, %i expected.\n', name, numel(evts), 2 * numel(keys));
+if numel(evts) ~= 2 * numel(keys)
+    fprintf('%s: FAILED - Wrong number of events.\n', name);
+    failed = 1;
+    return;
+end
+
+expectedCodes = reshape(repmat(KbName(keys), 2, 1), 1, []);
+expectedPressed = repmat([1, 0], 1, numel(keys));
+if ~isequal([evts.Keycode], expectedCodes) || ~isequal([evts.Pressed], expectedPressed)
+    fprintf('%s: FAILED - Events not in sent order.\n', name);
+    failed = failed + 1;
+end
+
+if any(diff([evts.Time]) < 0)
+    fprintf('%s: FAILED - Timestamps decrease.\n', name);
+    failed = failed + 1;
+end
+
+return;
+
+function DeleteFiles(files)
+for i = 1:numel(files)
+    if exist(files{i}, 'file')
+        delete(files{i});
+    end
+end
+
+return;
+
+function script = UinputScript
+% Helper: Create a uinput keyboard, write its device node into the node file,
+% wait for the start file, type the given evdev key codes 50 msecs apart,
+% write the CLOCK_MONOTONIC time of each key press into the times file:
+script = sprintf([ ...
+'import fcntl, glob, os, struct, sys, time\n' ...
+'nodefile, startfile, timesfile = sys.argv[1:4]\n' ...
+'codes = [int(c) for c in sys.argv[4].split('','') if c]\n' ...
+'UI_SET_EVBIT, UI_SET_KEYBIT, UI_DEV_CREATE, UI_DEV_DESTROY, UI_GET_SYSNAME = 0x40045564, 0x40045565, 0x5501, 0x5502, 0x8040552c\n' ...
+'fd = os.open(''/dev/uinput'', os.O_WRONLY | os.O_NONBLOCK)\n' ...
+'fcntl.ioctl(fd, UI_SET_EVBIT, 1)\n' ...
+'for c in codes:\n' ...
+'    fcntl.ioctl(fd, UI_SET_KEYBIT, c)\n' ...
+'os.write(fd, struct.pack(''=80sHHHHI'', b''PsychHID evdev test keyboard'', 3, 1, 1, 1, 0) + bytes(4 * 4 * 64))\n' ...
+'fcntl.ioctl(fd, UI_DEV_CREATE)\n' ...
+'sysname = fcntl.ioctl(fd, UI_GET_SYSNAME, bytes(64)).split(b''\\0'')[0].decode()\n' ...
+'node = ''/dev/input/'' + os.path.basename(glob.glob(''/sys/devices/virtual/input/%%s/event*'' %% sysname)[0])\n' ...
+'deadline = time.time() + 5\n' ...
+'while not os.access(node, os.R_OK) and time.time() < deadline:\n' ...
+'    time.sleep(0.01)\n' ...
+'open(nodefile + ''.tmp'', ''w'').write(node)\n' ...
+'os.rename(nodefile + ''.tmp'', nodefile)\n' ...
+'deadline = time.time() + 10\n' ...
+'while not os.path.exists(startfile) and time.time() < deadline:\n' ...
+'    time.sleep(0.01)\n' ...
+'def emit(type, code, value):\n' ...
+'    os.write(fd, struct.pack(''llHHi'', 0, 0, type, code, value))\n' ...
+'times = []\n' ...
+'for c in codes:\n' ...
+'    time.sleep(0.025)\n' ...
+'    times.append(time.clock_gettime(time.CLOCK_MONOTONIC))\n' ...
+'    emit(1, c, 1)\n' ...
+'    emit(0, 0, 0)\n' ...
+'    time.sleep(0.025)\n' ...
+'    emit(1, c, 0)\n' ...
+'    emit(0, 0, 0)\n' ...
+'time.sleep(0.1)\n' ...
+'open(timesfile + ''.tmp'', ''w'').write(''\\n''.join(''%%.6f'' %% t for t in times))\n' ...
+'os.rename(timesfile + ''.tmp'', timesfile)\n' ...
+'fcntl.ioctl(fd, UI_DEV_DESTROY)\n']);
+
+return;
@@ -0,0 +1,138 @@
+function KbQueueXTestBatchTest
+% KbQueueXTestBatchTest - Test order and timestamps of batched KbQueue events on Linux/X11.
+%
+% KbQueueXTestBatchTest
+%
+% The KbQueue thread of PsychHID on Linux processes all pending X events
+% of a wakeup in batches, with one common timestamp base per batch. This
+% test injects key events via the XTest extension and checks that they
+% arrive in the KbQueue in the order they were injected, with
+% non-decreasing timestamps inside the time interval of the injection.
+%
+% Two bursts of key strokes get injected via the 'xdotool' command line
+% utility, which uses XTest:
+%
+% 1. Key strokes spaced 25 msecs apart. The spacing of the timestamps of
+%    successive key presses must match that spacing within a few msecs.
+%
+% 2. 48 key strokes without delay, ie. 96 press and release events, which
+%    are processed in more than one batch. Timestamps of events inside one
+%    batch are derived from the X-Server event times, which only have a
+%    resolution of 1 msec, so many of these events share the same time.
+%
+% The test is meant to run on a Linux X-Server without real keyboards,
+% e.g., Xvfb, by starting Octave or Matlab via "xvfb-run". It uses the
+% "Virtual core XTEST keyboard" device, into which XTest events get
+% injected. The test gets skipped if xdotool is not installed.
+%
+
+% History:
+% 19-Oct-2026  ag  Written.
+
+if ~IsLinux || IsWayland
+    fprintf('KbQueueXTestBatchTest: SKIPPED. Only supported on Linux with X11.\n');
+    return;
+end
+
+if system('xdotool version > /dev/null 2>&1') ~= 0
+    fprintf('KbQueueXTestBatchTest: SKIPPED. The xdotool utility is not installed.\n');
+    return;
+end
+
+KbName('UnifyKeyNames');
+
+[keyboardIndices, productNames] = GetKeyboardIndices;
+dev = keyboardIndices(~cellfun(@isempty, strfind(productNames, 'XTEST')));
+if isempty(dev)
+    error('KbQueueXTestBatchTest: Could not find the XTEST keyboard device.');
+end
+dev = dev(1);
+
+failed = 0;
+try
+    KbQueueCreate(dev);
+    KbQueueStart(dev);
+
+    % Burst 1: Key strokes spaced 25 msecs apart:
+    keys = {'a', 's', 'd', 'f', 'g', 'h', 'j', 'k'};
+    [evts, t0, t1] = InjectKeys(dev, keys, 25);
+    failed = failed + CheckEvents('Spaced key strokes', evts, keys, t0, t1);
+
+    if numel(evts) == 2 * numel(keys)
+        spacing = diff([evts(1:2:end).Time]) * 1000;
+        fprintf('Spaced key strokes: Key press spacing min %f msecs, max %f msecs, expected 25 msecs.\n', min(spacing), max(spacing));
+        if any(abs(spacing - 25) > 5)
+            fprintf('Spaced key strokes: FAILED - Wrong spacing of timestamps.\n');
+            failed = failed + 1;
+        end
+    end
+
+    % Burst 2: Key strokes without delay, processed in multiple batches:
+    keys = repmat({'q', 'w', 'e', 'r', 't', 'y', 'u', 'i'}, 1, 6);
+    [evts, t0, t1] = InjectKeys(dev, keys, 0);
+    failed = failed + CheckEvents('Back to back key strokes', evts, keys, t0, t1);
+
+    KbQueueRelease(dev);
+catch
+    KbQueueRelease(dev);
+    psychrethrow(psychlasterror);
+end
+
+if failed > 0
+    error('KbQueueXTestBatchTest: %i checks FAILED!', failed);
+end
+
+fprintf('KbQueueXTestBatchTest: PASSED.\n');
+
+return;
+
+function [evts, t0, t1] = InjectKeys(dev, keys, delayMsecs)
+KbEventFlush(dev);
+
+t0 = GetSecs;
+system(sprintf('xdotool key --delay %i %s', delayMsecs, sprintf('%s ', keys{:})));
+t1 = GetSecs;
+
+% Give the KbQueue thread time to process all events:
+WaitSecs(0.25);
+
+evts = [];
+while KbEventAvail(dev) > 0
+    evt = KbEventGet(dev);
+    evts = [evts, evt]; %#ok<AGROW>
+end
+
+return;
+
+function failed = CheckEvents(name, evts, keys, t0, t1)
+failed = 0;
+
+fprintf('%s: %i events received, %i expected.\n', name, numel(evts), 2 * numel(keys));
+if numel(evts) ~= 2 * numel(keys)
+    fprintf('%s: FAILED - Wrong number of events.\n', name);
+    failed = 1;
+    return;
+end
+
+% Each key stroke is a press followed by a release of the same key:
+expectedCodes = reshape(repmat(KbName(keys), 2, 1), 1, []);
+expectedPressed = repmat([1, 0], 1, numel(keys));
+if ~isequal([evts.Keycode], expectedCodes) || ~isequal([evts.Pressed], expectedPressed)
+    fprintf('%s: FAILED - Events not in injection order.\n', name);
+    failed = failed + 1;
+end
+
+times = [evts.Time];
+if any(diff(times) < 0)
+    fprintf('%s: FAILED - Timestamps decrease.\n', name);
+    failed = failed + 1;
+end
+
+% The injection interval ends when xdotool has exited, after it sent all events:
+if (min(times) < t0) || (max(times) > t1)
+    fprintf('%s: FAILED - Timestamps outside injection interval [0, %f] msecs: [%f, %f] msecs.\n', ...
+            name, (t1 - t0) * 1000, (min(times) - t0) * 1000, (max(times) - t0) * 1000);
+    failed = failed + 1;
+end
+
+return;
@@ -0,0 +1,127 @@
+function MovieSeekIndexReuseTest
+% MovieSeekIndexReuseTest - Test the movie seek index with gapless queueing of movies.
+%
+% MovieSeekIndexReuseTest
+%
+% Screen('OpenMovie') can build a seek index of all video frames of a movie
+% if the 'movieOptions' keyword 'SeekIndex=1' is given. This test checks
+% that the index is rebuilt for a second movie which gets queued into the
+% same movie handle for gapless playback.
+%
+% The test writes two short movies into temporary files, with 20 and 35
+% frames, where each frame is filled with a distinct gray level. It opens
+% the first movie with a seek index, queues the second movie, and plays
+% until playback has switched to the second movie. Then it stops playback,
+% does frame-accurate seeks to different frames of the second movie, and
+% checks the gray level of the fetched frames and the size of the seek
+% index, as reported by Screen('GetMovieStatistics').
+%
+% Requires GStreamer with a video encoder and decoder for Screen's default
+% movie writing codec.
+%
+
+% History:
+% 19-Oct-2026  ag  Written.
+
+PsychDefaultSetup(1);
+
+nframes = [20, 35];
+basegray = [0, 128];
+moviefiles = {[tempname '.mov'], [tempname '.mov']};
+
+failed = 0;
+try
+    win = Screen('OpenWindow', max(Screen('Screens')), 0, [0 0 256 256]);
+
+    % Write the test movies, frame i of movie m with gray level basegray(m) + 3 * i:
+    for m = 1:2
+        moviewriter = Screen('CreateMovie', win, moviefiles{m}, 64, 64, 30);
+        for i = 0:nframes(m) - 1
+            Screen('FillRect', win, basegray(m) + 3 * i);
+            Screen('AddFrameToMovie', win, [0 0 64 64], 'backBuffer');
+            Screen('Flip', win);
+        end
+        Screen('FinalizeMovie', moviewriter);
+    end
+
+    [movie, duration, fps, width, height, count] = Screen('OpenMovie', win, moviefiles{1}, [], [], [], [], [], 'SeekIndex=1'); %#ok<ASGLU>
+    stats = Screen('GetMovieStatistics', movie);
+    fprintf('First movie: %i frames, seek index of %i frames.\n', count, stats.SeekIndexFrames);
+    if (count ~= nframes(1)) || (stats.SeekIndexFrames ~= nframes(1))
+        fprintf('FAILED - Wrong frame count or seek index size for first movie.\n');
+        failed = failed + 1;
+    end
+
+    % Queue second movie and play until the first frame of it arrives:
+    Screen('OpenMovie', win, moviefiles{2}, 2, movie);
+    Screen('PlayMovie', movie, 1);
+    switched = 0;
+    tdeadline = GetSecs + 10;
+    while ~switched && (GetSecs < tdeadline)
+        tex = Screen('GetMovieImage', win, movie);
+        if tex > 0
+            switched = (FrameGray(tex) >= basegray(2) - 1.5);
+            Screen('Close', tex);
+        end
+    end
+    Screen('PlayMovie', movie, 0);
+
+    if ~switched
+        error('Playback did not switch to the queued movie within 10 seconds.');
+    end
+
+    % Frame-accurate seeks into the second movie, which rebuild its seek index:
+    for frame = [30, 12, 11, 34, 0]
+        Screen('SetMovieTimeIndex', movie, frame, 1);
+        tex = Screen('GetMovieImage', win, movie);
+        gray = FrameGray(tex);
+        Screen('Close', tex);
+
+        stats = Screen('GetMovieStatistics', movie);
+        fprintf('Seek to frame %i of second movie: Gray level %f, expected %i. Seek index of %i frames.\n', ...
+                frame, gray, basegray(2) + 3 * frame, stats.SeekIndexFrames);
+
+        if abs(gray - (basegray(2) + 3 * frame)) > 1.5
+            fprintf('FAILED - Wrong frame after seek.\n');
+            failed = failed + 1;
+        end
+
+        if stats.SeekIndexFrames ~= nframes(2)
+            fprintf('FAILED - Seek index not rebuilt for second movie.\n');
+            failed = failed + 1;
+        end
+    end
+
+    Screen('CloseMovie', movie);
+    sca;
+catch
+    sca;
+    DeleteMovies(moviefiles);
+    psychrethrow(psychlasterror);
+end
+
+DeleteMovies(moviefiles);
+
+if failed > 0
+    error('MovieSeekIndexReuseTest: %i checks FAILED!', failed);
+end
+
+fprintf('MovieSeekIndexReuseTest: PASSED.\n');
+
+return;
+
+function gray = FrameGray(tex)
+% Mean gray level of the center region of a movie frame texture:
+img = double(Screen('GetImage', tex, [16 16 48 48], [], [], 1));
+gray = mean(img(:));
+
+return;
+
+function DeleteMovies(moviefiles)
+for m = 1:numel(moviefiles)
+    if exist(moviefiles{m}, 'file')
+        delete(moviefiles{m});
+    end
+end
+
+return;
@@ -0,0 +1,137 @@
+function ShaderCacheFusionTest
+% ShaderCacheFusionTest - Test hook chain shader fusion with programs from the shader cache.
+%
+% ShaderCacheFusionTest
+%
+% Screen stores the binaries of its builtin GLSL programs in an on-disk
+% shader cache and loads later instances of the same programs from there.
+% This test checks that such programs can still be fused with other
+% shader slots of a hook chain, which requires their shader sources.
+%
+% The test clears Screen and points the shader cache to an empty temporary
+% directory via the environment variable PSYCH_SHADER_CACHE_DIR. It then
+% opens a dualview stereo window twice. The first time, the builtin stereo
+% compositing shader gets compiled from source and stored in the cache,
+% the second time it gets loaded from the cache. Each time, the builtin
+% shader is used as first fusable slot of a 'FinalOutputFormattingBlit'
+% hook chain, followed by a fusable color swizzle slot, and the test checks
+% that both slots get fused and that the output image is correct.
+%
+% The test is meant to run on any OpenGL implementation with support for
+% GL_ARB_get_program_binary, e.g., Mesa's llvmpipe software renderer, by
+% starting Octave or Matlab with the environment variable
+% LIBGL_ALWAYS_SOFTWARE=1. If the OpenGL implementation doesn't store
+% program binaries, the test gets skipped.
+%
+
+% History:
+% 19-Oct-2026  ag  Written.
+
+global GL;
+
+PsychDefaultSetup(1);
+
+% The shader cache directory is determined once when Screen gets loaded:
+sca;
+clear Screen;
+InitializeMatlabOpenGL([], [], 1);
+
+oldenv = getenv('PSYCH_SHADER_CACHE_DIR');
+cachedir = tempname;
+mkdir(cachedir);
+setenv('PSYCH_SHADER_CACHE_DIR', cachedir);
+
+origins = {'compiled from source', 'loaded from cache'};
+failed = 0;
+try
+    for run = 1:2
+        [img, passCount, fusedSlots, renderer] = RunChain;
+
+        if run == 1
+            fprintf('Renderer: %s\n', renderer);
+            if isempty(dir([cachedir filesep '*.glslbin']))
+                fprintf('ShaderCacheFusionTest: SKIPPED. OpenGL implementation does not support the shader cache.\n');
+                break;
+            end
+        end
+
+        maxdiff = max(abs(img(:) - reshape([192, 64, 128], [], 1)));
+        fprintf('Run %i, builtin shader %s: %i passes executed, %i slots fused, max difference to expected color %f.\n', ...
+                run, origins{run}, passCount, fusedSlots, maxdiff);
+
+        if (passCount ~= 1) || (fusedSlots ~= 2)
+            fprintf('Run %i: FAILED - Shader slots not fused.\n', run);
+            failed = failed + 1;
+        end
+
+        if maxdiff > 1
+            fprintf('Run %i: FAILED - Wrong output image.\n', run);
+            failed = failed + 1;
+        end
+    end
+catch
+    sca;
+    setenv('PSYCH_SHADER_CACHE_DIR', oldenv);
+    rmdir(cachedir, 's');
+    psychrethrow(psychlasterror);
+end
+
+setenv('PSYCH_SHADER_CACHE_DIR', oldenv);
+rmdir(cachedir, 's');
+
+if failed > 0
+    error('ShaderCacheFusionTest: %i checks FAILED!', failed);
+end
+
+fprintf('ShaderCacheFusionTest: PASSED.\n');
+
+return;
+
+function [img, passCount, fusedSlots, renderer] = RunChain
+global GL;
+
+% Dualview stereo window, whose stereo compositing uses a builtin shader program:
+win = Screen('OpenWindow', max(Screen('Screens')), 0, [0 0 256 64], [], [], 4, [], ...
+             mor(kPsychNeedFastBackingStore, kPsychNeedOutputConversion));
+winfo = Screen('GetWindowInfo', win);
+renderer = winfo.GLRenderer;
+
+[slot, idString, blitterString, voidptr, builtinShader] = Screen('HookFunction', win, 'Query', 'StereoCompositingBlit', 'StereoCompositingShaderDualViewLeft'); %#ok<ASGLU>
+
+% Per-pixel stage which rotates the color channels:
+Screen('BeginOpenGL', win);
+shader = glCreateShader(GL.FRAGMENT_SHADER);
+glShaderSource(shader, sprintf(['#extension GL_ARB_texture_rectangle : enable\n' ...
+    'uniform sampler2DRect Image;\n' ...
+    'vec4 PsychFusableStage(vec4 incolor)\n{\n' ...
+    '    return(vec4(incolor.b, incolor.r, incolor.g, 1.0));\n}\n' ...
+    'void main()\n{\n' ...
+    '    gl_FragColor = PsychFusableStage(texture2DRect(Image, gl_TexCoord[0].st));\n}\n']));
+glCompileShader(shader);
+swizzleShader = glCreateProgram();
+glAttachShader(swizzleShader, shader);
+glLinkProgram(swizzleShader);
+glDeleteShader(shader);
+Screen('EndOpenGL', win);
+
+Screen('HookFunction', win, 'Reset', 'FinalOutputFormattingBlit');
+Screen('HookFunction', win, 'AppendShader', 'FinalOutputFormattingBlit', 'Builtin', builtinShader, 'Fusable');
+Screen('HookFunction', win, 'AppendBuiltin', 'FinalOutputFormattingBlit', 'Builtin:FlipFBOs', '');
+Screen('HookFunction', win, 'AppendShader', 'FinalOutputFormattingBlit', 'Swizzle', swizzleShader, 'Fusable');
+Screen('HookFunction', win, 'Enable', 'FinalOutputFormattingBlit');
+
+for eye = 0:1
+    Screen('SelectStereoDrawBuffer', win, eye);
+    Screen('FillRect', win, [64, 128, 192]);
+end
+
+Screen('DrawingFinished', win, 0, 1);
+img = double(Screen('GetImage', win, [0 0 1 1], 'backBuffer'));
+Screen('Flip', win);
+
+[passCount, gpuPassTimes, specifiedPassCount, eliminatedBlits, fusedSlots] = ...
+    Screen('HookFunction', win, 'PassStatistics', 'FinalOutputFormattingBlit'); %#ok<ASGLU>
+
+sca;
+
+return;
@@ -0,0 +1,177 @@
+function USBStreamingTest(vendorID, deviceID, endPoint, reportSize, transferType)
+% USBStreamingTest - Test streaming reception of reports from a generic USB device.
+%
+% USBStreamingTest([vendorID, deviceID, endPoint, reportSize [, transferType=0]])
+%
+% Exercises PsychHID('USBStartStreaming'), PsychHID('USBGetStreamedReports')
+% and PsychHID('USBStopStreaming') on the in-endpoint 'endPoint' of the
+% USB device with the given 'vendorID' and 'deviceID'. 'reportSize' is
+% the size of a report in bytes, 'transferType' selects interrupt (0) or
+% bulk (1) transfers. The device must continuously send reports at a
+% rate of more than 10 reports per second on that endpoint, e.g., a
+% gamepad, response box or data acquisition device in streaming mode.
+%
+% If called without arguments, the test uses a simulated device instead,
+% which needs no USB hardware: PsychHID's test-only simulated transport
+% completes transfers at a rate of 1000 reports per second, as selected
+% via the environment variable PSYCHHID_SIMULATED_USB_REPORTRATE, and
+% feeds them into the same report buffer as the real USB transport. As
+% the content of simulated reports is known, the test then also checks
+% that no report gets lost, duplicated or reordered, that short reports
+% are zero-padded, and that an overflowing buffer keeps the oldest
+% reports.
+%
+% The test checks:
+%
+% 1. Continuous reception: Many more reports than transfers in flight
+%    arrive, i.e., completed transfers get resubmitted, and timestamps are
+%    monotonic.
+%
+% 2. Overflow: With a tiny buffer, excess reports get discarded and
+%    counted in 'lostCount', without the buffer returning more reports
+%    than its capacity.
+%
+% 3. Stop: Stopping cancels all transfers promptly, even with transfers
+%    which would never time out, no reports arrive afterwards, and
+%    fetching from a stopped stream doesn't wait.
+%
+% 4. Closing the device while streaming shuts down cleanly.
+%
+
+% History:
+% 19-Oct-2026  ag  Written.
+
+simulated = (nargin == 0);
+if simulated
+    % Simulated device, streaming 16 byte reports from an interrupt in-endpoint:
+    vendorID = 0;
+    deviceID = 0;
+    endPoint = hex2dec('81');
+    reportSize = 16;
+    transferType = 0;
+    oldenv = getenv('PSYCHHID_SIMULATED_USB_REPORTRATE');
+    setenv('PSYCHHID_SIMULATED_USB_REPORTRATE', '1000');
+elseif nargin < 4 || isempty(vendorID) || isempty(deviceID) || isempty(endPoint) || isempty(reportSize)
+    error('Required arguments vendorID, deviceID, endPoint and reportSize missing.');
+end
+
+if nargin < 5 || isempty(transferType)
+    transferType = 0;
+end
+
+numTransfers = 4;
+failed = 0;
+
+usbHandle = PsychHID('OpenUSBDevice', vendorID, deviceID);
+if simulated
+    setenv('PSYCHHID_SIMULATED_USB_REPORTRATE', oldenv);
+end
+
+try
+    % Test 1: Continuous reception for 2 seconds:
+    PsychHID('USBStartStreaming', usbHandle, endPoint, reportSize, transferType, numTransfers);
+    allreports = [];
+    timestamps = [];
+    lengths = [];
+    lost = 0;
+    tend = GetSecs + 2;
+    while GetSecs < tend
+        [reports, ts, len, navail, lostCount] = PsychHID('USBGetStreamedReports', usbHandle, inf, 0.1); %#ok<ASGLU>
+        allreports = [allreports, reports]; %#ok<AGROW>
+        timestamps = [timestamps, ts]; %#ok<AGROW>
+        lengths = [lengths, len]; %#ok<AGROW>
+        lost = lost + lostCount;
+    end
+    PsychHID('USBStopStreaming', usbHandle);
+
+    fprintf('Test 1: Received %i reports in 2 seconds, %i lost.\n', length(timestamps), lost);
+    if length(timestamps) <= 10 * numTransfers
+        fprintf('Test 1: FAILED - Too few reports. Transfers not resubmitted, or device too slow?\n');
+        failed = failed + 1;
+    elseif any(diff(timestamps) < 0) || any(lengths > reportSize) || (lost > 0)
+        fprintf('Test 1: FAILED - Non-monotonic timestamps, oversized reports or lost reports.\n');
+        failed = failed + 1;
+    elseif simulated && ~isequal(allreports, SimulatedReports(0:length(timestamps) - 1, reportSize))
+        fprintf('Test 1: FAILED - Simulated reports lost, duplicated, reordered or not zero-padded.\n');
+        failed = failed + 1;
+    else
+        fprintf('Test 1: PASSED.\n');
+    end
+
+    % Test 2: Overflow of a 4 slot buffer within 1 second:
+    PsychHID('USBStartStreaming', usbHandle, endPoint, reportSize, transferType, numTransfers, 4);
+    WaitSecs(1);
+    [reports, ts, len, navail, lostCount] = PsychHID('USBGetStreamedReports', usbHandle); %#ok<ASGLU>
+    PsychHID('USBStopStreaming', usbHandle);
+
+    fprintf('Test 2: Fetched %i reports, %i remaining, %i lost.\n', length(ts), navail, lostCount);
+    if (length(ts) > 4) || (navail > 4) || (lostCount == 0)
+        fprintf('Test 2: FAILED - Buffer returned more than its capacity, or lost reports not counted.\n');
+        failed = failed + 1;
+    elseif simulated && ~isequal(reports, SimulatedReports(0:3, reportSize))
+        fprintf('Test 2: FAILED - Buffer did not keep the oldest reports.\n');
+        failed = failed + 1;
+    else
+        fprintf('Test 2: PASSED.\n');
+    end
+
+    % Test 3: Stop with transfers that never time out:
+    PsychHID('USBStartStreaming', usbHandle, endPoint, reportSize, transferType, numTransfers, 10000, 0);
+    WaitSecs(0.5);
+    tstart = GetSecs;
+    PsychHID('USBStopStreaming', usbHandle);
+    tstop = GetSecs - tstart;
+    PsychHID('USBGetStreamedReports', usbHandle);
+    WaitSecs(0.2);
+    tstart = GetSecs;
+    [reports, ts] = PsychHID('USBGetStreamedReports', usbHandle, inf, 1); %#ok<ASGLU>
+    twait = GetSecs - tstart;
+
+    fprintf('Test 3: Stop took %f msecs, %i reports after stop, fetch took %f msecs.\n', tstop * 1000, length(ts), twait * 1000);
+    if (tstop > 0.5) || ~isempty(ts) || (twait > 0.5)
+        fprintf('Test 3: FAILED - Stop too slow, reports received after stop, or fetch waited on stopped stream.\n');
+        failed = failed + 1;
+    else
+        fprintf('Test 3: PASSED.\n');
+    end
+
+    % Test 4: Close device while streaming:
+    PsychHID('USBStartStreaming', usbHandle, endPoint, reportSize, transferType, numTransfers);
+    WaitSecs(0.5);
+    tstart = GetSecs;
+    PsychHID('CloseUSBDevice', usbHandle);
+    tclose = GetSecs - tstart;
+
+    fprintf('Test 4: Close while streaming took %f msecs.\n', tclose * 1000);
+    if tclose > 0.5
+        fprintf('Test 4: FAILED - Close too slow.\n');
+        failed = failed + 1;
+    else
+        fprintf('Test 4: PASSED.\n');
+    end
+catch
+    PsychHID('CloseUSBDevice');
+    psychrethrow(psychlasterror);
+end
+
+if failed > 0
+    error('%i of 4 USB streaming tests FAILED!', failed);
+end
+
+fprintf('All USB streaming tests PASSED.\n');
+
+return;
+
+function reports = SimulatedReports(sequence, reportSize)
+% Expected content of simulated reports with the given sequence numbers:
+% Sequence number as little-endian uint32, followed by the byte index,
+% with odd reports only half as long and zero-padded:
+reports = zeros(reportSize, length(sequence), 'uint8');
+for i = 1:length(sequence)
+    reports(:, i) = [typecast(uint32(sequence(i)), 'uint8')'; uint8(4:reportSize - 1)'];
+    if mod(sequence(i), 2)
+        reports(ceil(reportSize / 2) + 1:end, i) = 0;
+    end
+end
+
+return;